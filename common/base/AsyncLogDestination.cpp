@@ -0,0 +1,200 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * AsyncLogDestination.cpp
+ * A LogDestination that writes from a background thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/base/AsyncLogDestination.h"
+
+namespace ola {
+
+using ola::thread::MutexLocker;
+using std::string;
+using std::vector;
+
+const unsigned int AsyncLogDestination::DEFAULT_CAPACITY;
+
+AsyncLogDestination::AsyncLogDestination(LogDestination *destination,
+                                         unsigned int capacity)
+    : m_destination(destination),
+      m_thread(this),
+      m_ring(capacity ? capacity : 1),
+      m_head(0),
+      m_count(0),
+      m_dropped(0),
+      m_total_dropped(0),
+      m_started(false),
+      m_writing(false),
+      m_stop(false) {
+}
+
+
+AsyncLogDestination::~AsyncLogDestination() {
+  bool started;
+  {
+    MutexLocker locker(&m_mutex);
+    m_stop = true;
+    started = m_started;
+    if (!started) {
+      WriteQueuedLines();
+    }
+  }
+  if (started) {
+    m_data_ready.Signal();
+    m_thread.Join();
+  }
+  delete m_destination;
+}
+
+
+bool AsyncLogDestination::Start() {
+  {
+    MutexLocker locker(&m_mutex);
+    if (m_started) {
+      return true;
+    }
+    m_started = true;
+  }
+
+  if (!m_thread.Start()) {
+    MutexLocker locker(&m_mutex);
+    m_started = false;
+    return false;
+  }
+  return true;
+}
+
+
+void AsyncLogDestination::Write(log_level level, const string &log_line) {
+  {
+    MutexLocker locker(&m_mutex);
+    if (m_count == m_ring.size()) {
+      m_dropped++;
+      m_total_dropped++;
+      return;
+    }
+    // The strings in the ring keep their capacity, so once the ring has
+    // warmed up this is a copy, not an allocation.
+    LogEntry &entry = m_ring[(m_head + m_count) % m_ring.size()];
+    entry.level = level;
+    entry.line.assign(log_line);
+    m_count++;
+  }
+  m_data_ready.Signal();
+}
+
+
+void AsyncLogDestination::Flush() {
+  MutexLocker locker(&m_mutex);
+  if (!m_started) {
+    WriteQueuedLines();
+    return;
+  }
+  while ((m_count || m_writing) && !m_stop) {
+    m_drained.Wait(&m_mutex);
+  }
+}
+
+
+unsigned int AsyncLogDestination::DroppedMessages() {
+  MutexLocker locker(&m_mutex);
+  return m_total_dropped;
+}
+
+
+/*
+ * Write the queued lines from the calling thread, this is only used when the
+ * writer thread isn't running. m_mutex must be held.
+ */
+void AsyncLogDestination::WriteQueuedLines() {
+  for (; m_count; m_count--) {
+    const LogEntry &entry = m_ring[m_head];
+    m_destination->Write(entry.level, entry.line);
+    m_head = (m_head + 1) % m_ring.size();
+  }
+
+  if (m_dropped) {
+    std::ostringstream str;
+    str << "Log buffer full, dropped " << m_dropped << " messages\n";
+    m_destination->Write(OLA_LOG_WARN, str.str());
+    m_dropped = 0;
+  }
+}
+
+
+void *AsyncLogDestination::WriterThread::Run() {
+  m_parent->WriteLoop();
+  return NULL;
+}
+
+
+/*
+ * Swap the queued lines out of the ring and write them without holding the
+ * lock.
+ */
+void AsyncLogDestination::WriteLoop() {
+  vector<LogEntry> batch(m_ring.size());
+
+  while (true) {
+    unsigned int count;
+    unsigned int dropped;
+    bool stop;
+    {
+      MutexLocker locker(&m_mutex);
+      while (!m_count && !m_stop) {
+        m_data_ready.Wait(&m_mutex);
+      }
+      count = m_count;
+      for (unsigned int i = 0; i < count; i++) {
+        LogEntry &entry = m_ring[(m_head + i) % m_ring.size()];
+        batch[i].level = entry.level;
+        batch[i].line.swap(entry.line);
+      }
+      m_head = (m_head + count) % m_ring.size();
+      m_count = 0;
+      dropped = m_dropped;
+      m_dropped = 0;
+      stop = m_stop;
+      m_writing = count > 0;
+    }
+
+    for (unsigned int i = 0; i < count; i++) {
+      m_destination->Write(batch[i].level, batch[i].line);
+    }
+
+    if (dropped) {
+      std::ostringstream str;
+      str << "Log buffer full, dropped " << dropped << " messages\n";
+      m_destination->Write(OLA_LOG_WARN, str.str());
+    }
+
+    {
+      MutexLocker locker(&m_mutex);
+      m_writing = false;
+    }
+    m_drained.Broadcast();
+
+    if (stop) {
+      return;
+    }
+  }
+}
+}  // namespace ola
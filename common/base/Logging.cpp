@@ -42,13 +42,18 @@
 
 #include <iostream>
 #include <string>
+#include "ola/Clock.h"
 #include "ola/Logging.h"
+#include "ola/base/AsyncLogDestination.h"
 #include "ola/base/Flags.h"
 
 /**@private*/
 DEFINE_s_int8(log_level, l, ola::OLA_LOG_WARN, "Set the logging level 0 .. 4.");
 /**@private*/
 DEFINE_default_bool(syslog, false, "Send to syslog rather than stderr.");
+/**@private*/
+DEFINE_default_bool(async_log, false,
+                    "Write log messages from a background thread.");
 
 namespace ola {
 
@@ -80,7 +85,7 @@ void IncrementLogLevel() {
 }
 
 
-bool InitLoggingFromFlags() {
+bool InitLoggingFromFlags(bool start_async_writer) {
   log_output output = OLA_LOG_NULL;
   if (FLAGS_syslog) {
     output = OLA_LOG_SYSLOG;
@@ -111,7 +116,25 @@ bool InitLoggingFromFlags() {
       break;
   }
 
-  return InitLogging(log_level, output);
+  if (!InitLogging(log_level, output)) {
+    return false;
+  }
+  if (FLAGS_async_log && log_target) {
+    log_target = new AsyncLogDestination(log_target);
+    if (start_async_writer) {
+      StartAsyncLogging();
+    }
+  }
+  return true;
+}
+
+
+void StartAsyncLogging() {
+  AsyncLogDestination *destination =
+      dynamic_cast<AsyncLogDestination*>(log_target);
+  if (destination) {
+    destination->Start();
+  }
 }
 
 
@@ -146,13 +169,68 @@ void InitLogging(log_level level, LogDestination *destination) {
   log_target = destination;
 }
 
+
+void FlushLogging() {
+  if (log_target) {
+    log_target->Flush();
+  }
+}
+
+
+const unsigned int LogRateLimiter::DEFAULT_INTERVAL_MS;
+
+LogRateLimiter::LogRateLimiter(unsigned int interval_ms,
+                               unsigned int burst,
+                               const Clock *clock)
+    : m_clock(clock),
+      m_interval_ms(interval_ms),
+      m_burst(burst),
+      m_window_start(-1),
+      m_allowed(0),
+      m_suppressed(0) {
+}
+
+
+bool LogRateLimiter::Allow() {
+  TimeStamp now;
+  if (m_clock) {
+    m_clock->CurrentMonotonicTime(&now);
+  } else {
+    Clock clock;
+    clock.CurrentMonotonicTime(&now);
+  }
+  int64_t now_ms = (static_cast<int64_t>(now.Seconds()) * 1000 +
+                    now.MicroSeconds() / 1000);
+
+  if (m_window_start < 0 || now_ms - m_window_start >= m_interval_ms) {
+    m_window_start = now_ms;
+    m_allowed = 0;
+  }
+
+  if (m_allowed < m_burst) {
+    m_allowed++;
+    return true;
+  }
+  m_suppressed++;
+  return false;
+}
+
+
+unsigned int LogRateLimiter::TakeSuppressed() {
+  unsigned int suppressed = m_suppressed;
+  m_suppressed = 0;
+  return suppressed;
+}
+
 /**@}*/
 /**@cond HIDDEN_SYMBOLS*/
 LogLine::LogLine(const char *file,
                  int line,
-                 log_level level):
+                 log_level level,
+                 unsigned int suppressed):
   m_level(level),
-  m_stream(ostringstream::out) {
+  m_stream(ostringstream::out),
+  m_suppressed(suppressed) {
     m_stream << file << ":" << line << ": ";
     m_prefix_length = m_stream.str().length();
 }
@@ -170,11 +248,49 @@ void LogLine::Write() {
 
   string line = m_stream.str();
 
-  if (line.at(line.length() - 1) != '\n')
-    line.append("\n");
+  if (line.at(line.length() - 1) == '\n')
+    line.resize(line.length() - 1);
 
-  if (log_target)
+  if (m_suppressed) {
+    std::ostringstream suppressed;
+    suppressed << " (" << m_suppressed << " similar messages suppressed)";
+    line.append(suppressed.str());
+  }
+  line.append("\n");
+
+  if (log_target) {
     log_target->Write(m_level, line);
+    // Make sure fatal messages are written before the program exits.
+    if (m_level == OLA_LOG_FATAL) {
+      log_target->Flush();
+    }
+  }
+}
+
+
+/*
+ * Quote strings that would otherwise be ambiguous.
+ */
+void FormatLogValue(std::ostream &out, const string &value) {
+  if (!value.empty() && value.find_first_of(" \"=\t\n") == string::npos) {
+    out << value;
+    return;
+  }
+
+  out << '"';
+  for (string::const_iterator iter = value.begin(); iter != value.end();
+       ++iter) {
+    if (*iter == '"' || *iter == '\\') {
+      out << '\\';
+    }
+    out << *iter;
+  }
+  out << '"';
+}
+
+
+void FormatLogValue(std::ostream &out, const char *value) {
+  FormatLogValue(out, string(value ? value : ""));
 }
 /**@endcond*/
 
@@ -19,30 +19,52 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif  // _WIN32
 #include <deque>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "ola/Clock.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
+#include "ola/base/AsyncLogDestination.h"
+#include "ola/strings/Format.h"
 #include "ola/testing/TestUtils.h"
 
 
 using std::deque;
 using std::vector;
 using std::string;
+using ola::AsyncLogDestination;
 using ola::IncrementLogLevel;
+using ola::LogField;
+using ola::LogRateLimiter;
+using ola::MockClock;
 using ola::log_level;
 
 
 class LoggingTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(LoggingTest);
   CPPUNIT_TEST(testLogging);
+  CPPUNIT_TEST(testRateLimiter);
+  CPPUNIT_TEST(testLogField);
+  CPPUNIT_TEST(testAsyncDestination);
+#ifndef _WIN32
+  CPPUNIT_TEST(testAsyncDestinationFork);
+#endif  // _WIN32
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testLogging();
+    void testRateLimiter();
+    void testLogField();
+    void testAsyncDestination();
+    void testAsyncDestinationFork();
 };
 
 
@@ -56,6 +78,20 @@ class MockLogDestination: public ola::LogDestination {
 };
 
 
+/*
+ * Records the lines written.
+ */
+class RecordingLogDestination: public ola::LogDestination {
+ public:
+    void Write(log_level, const string &log_line) {
+      m_lines.push_back(log_line);
+    }
+    const vector<string> &Lines() const { return m_lines; }
+ private:
+    vector<string> m_lines;
+};
+
+
 CPPUNIT_TEST_SUITE_REGISTRATION(LoggingTest);
 
 
@@ -124,3 +160,138 @@ void LoggingTest::testLogging() {
   OLA_FATAL << "fatal";
   OLA_ASSERT_EQ(destination->LinesRemaining(), 0);
 }
+
+
+/*
+ * Check that rate limited messages are suppressed and counted.
+ */
+void LoggingTest::testRateLimiter() {
+  MockClock clock;
+  LogRateLimiter limiter(1000, 2, &clock);
+  OLA_ASSERT_TRUE(limiter.Allow());
+  OLA_ASSERT_TRUE(limiter.Allow());
+  OLA_ASSERT_FALSE(limiter.Allow());
+  OLA_ASSERT_FALSE(limiter.Allow());
+  OLA_ASSERT_EQ(2u, limiter.Suppressed());
+
+  clock.AdvanceTime(0, 999000);
+  OLA_ASSERT_FALSE(limiter.Allow());
+  clock.AdvanceTime(0, 1000);
+  OLA_ASSERT_TRUE(limiter.Allow());
+  OLA_ASSERT_EQ(3u, limiter.TakeSuppressed());
+  OLA_ASSERT_EQ(0u, limiter.Suppressed());
+
+  // Now check the macros
+  RecordingLogDestination *destination = new RecordingLogDestination();
+  InitLogging(ola::OLA_LOG_WARN, destination);
+  LogRateLimiter macro_limiter(1000, 1, &clock);
+  unsigned int evaluated = 0;
+  for (unsigned int i = 0; i < 5; i++) {
+    OLA_WARN_LIMITED(macro_limiter) << "limited " << evaluated++;
+  }
+  // The stream expression is only evaluated if the message is logged.
+  OLA_ASSERT_EQ(1u, evaluated);
+  OLA_ASSERT_EQ((size_t) 1, destination->Lines().size());
+
+  // Below the log level, nothing is counted.
+  OLA_INFO_LIMITED(macro_limiter) << "info";
+  OLA_ASSERT_EQ(4u, macro_limiter.Suppressed());
+
+  clock.AdvanceTime(1, 0);
+  OLA_WARN_LIMITED(macro_limiter) << "limited";
+  OLA_ASSERT_EQ((size_t) 2, destination->Lines().size());
+  vector<string> tokens;
+  ola::StringSplit(destination->Lines()[1], &tokens, ":");
+  OLA_ASSERT_EQ((size_t) 3, tokens.size());
+  OLA_ASSERT_EQ(string(" limited (4 similar messages suppressed)\n"),
+                tokens[2]);
+  InitLogging(ola::OLA_LOG_WARN, ola::OLA_LOG_NULL);
+}
+
+
+/*
+ * Check key / value formatting.
+ */
+void LoggingTest::testLogField() {
+  std::ostringstream str;
+  str << "msg" << LogField("universe", 1) << LogField("name", "Console 1")
+      << LogField("cid", string("abc")) << LogField("empty", "")
+      << LogField("quote", "a\"b");
+  OLA_ASSERT_EQ(
+      string("msg universe=1 name=\"Console 1\" cid=abc empty=\"\" "
+             "quote=\"a\\\"b\""),
+      str.str());
+}
+
+
+/*
+ * Check that the AsyncLogDestination writes every line it doesn't drop, in
+ * order.
+ */
+void LoggingTest::testAsyncDestination() {
+  RecordingLogDestination *recorder = new RecordingLogDestination();
+  AsyncLogDestination destination(recorder, 8);
+  OLA_ASSERT_TRUE(destination.Start());
+
+  const unsigned int LINES = 200;
+  for (unsigned int i = 0; i < LINES; i++) {
+    destination.Write(ola::OLA_LOG_WARN, ola::strings::IntToString(i));
+  }
+  destination.Flush();
+
+  unsigned int written = 0;
+  int last = -1;
+  vector<string>::const_iterator iter = recorder->Lines().begin();
+  for (; iter != recorder->Lines().end(); ++iter) {
+    int value;
+    if (!ola::StringToInt(*iter, &value)) {
+      // the dropped message notice
+      OLA_ASSERT_EQ((size_t) 0, iter->find("Log buffer full"));
+      continue;
+    }
+    OLA_ASSERT_LT(last, value);
+    last = value;
+    written++;
+  }
+  OLA_ASSERT_EQ(LINES, written + destination.DroppedMessages());
+}
+
+
+#ifndef _WIN32
+/*
+ * Check that lines logged before fork() are buffered, and that a writer
+ * started in the child runs there.
+ */
+void LoggingTest::testAsyncDestinationFork() {
+  RecordingLogDestination *recorder = new RecordingLogDestination();
+  AsyncLogDestination destination(recorder);
+  destination.Write(ola::OLA_LOG_WARN, "before fork");
+  OLA_ASSERT_TRUE(recorder->Lines().empty());
+
+  pid_t pid = fork();
+  OLA_ASSERT_NE(static_cast<pid_t>(-1), pid);
+  if (pid == 0) {
+    // Fail rather than hang if the writer isn't running.
+    alarm(5);
+    bool ok = destination.Start();
+    destination.Write(ola::OLA_LOG_WARN, "child");
+    destination.Flush();
+    ok &= (recorder->Lines().size() == 2 &&
+           recorder->Lines()[0] == "before fork" &&
+           recorder->Lines()[1] == "child");
+    _exit(ok ? 0 : 1);
+  }
+
+  int status;
+  OLA_ASSERT_EQ(pid, waitpid(pid, &status, 0));
+  OLA_ASSERT_TRUE(WIFEXITED(status));
+  OLA_ASSERT_EQ(0, WEXITSTATUS(status));
+
+  OLA_ASSERT_TRUE(destination.Start());
+  destination.Write(ola::OLA_LOG_WARN, "parent");
+  destination.Flush();
+  OLA_ASSERT_EQ((size_t) 2, recorder->Lines().size());
+  OLA_ASSERT_EQ(string("before fork"), recorder->Lines()[0]);
+  OLA_ASSERT_EQ(string("parent"), recorder->Lines()[1]);
+}
+#endif  // _WIN32
@@ -0,0 +1,284 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FrameTimer.cpp
+ * Precise timing for threads that generate DMX512 frames.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/dmx/FrameTimer.h"
+#include "ola/thread/Mutex.h"
+#include "ola/thread/Utils.h"
+
+namespace ola {
+namespace dmx {
+
+using ola::thread::MutexLocker;
+using std::string;
+
+const char FrameTimer::DEVICE_LABEL[] = "device";
+const char FrameTimer::FRAME_RATE_VAR[] = "dmx-output-fps";
+const char FrameTimer::JITTER_VAR[] = "dmx-output-jitter-us";
+const char FrameTimer::MAX_JITTER_VAR[] = "dmx-output-max-jitter-us";
+
+FrameTimer::FrameTimer(const Options &options,
+                       ExportMap *export_map,
+                       const string &device,
+                       ola::thread::SchedulerInterface *scheduler)
+    : m_options(options),
+      m_device(device),
+      m_window_frames(0),
+      m_window_jitter(0),
+      m_window_max_jitter(0),
+      m_frame_rate(0),
+      m_jitter(0),
+      m_max_jitter(0),
+      m_scheduler(scheduler),
+      m_publish_timeout(ola::thread::INVALID_TIMEOUT),
+      m_frame_rate_var(NULL),
+      m_jitter_var(NULL),
+      m_max_jitter_var(NULL) {
+  if (m_options.frame_rate) {
+    m_frame_interval = TimeInterval(
+        static_cast<int64_t>(USEC_IN_SECONDS / m_options.frame_rate));
+  }
+
+  if (export_map) {
+    m_frame_rate_var = export_map->GetUIntMapVar(FRAME_RATE_VAR,
+                                                 DEVICE_LABEL);
+    (*m_frame_rate_var)[m_device] = 0;
+    m_jitter_var = export_map->GetUIntMapVar(JITTER_VAR, DEVICE_LABEL);
+    (*m_jitter_var)[m_device] = 0;
+    m_max_jitter_var = export_map->GetUIntMapVar(MAX_JITTER_VAR,
+                                                 DEVICE_LABEL);
+    (*m_max_jitter_var)[m_device] = 0;
+
+    if (m_scheduler) {
+      m_publish_timeout = m_scheduler->RegisterRepeatingTimeout(
+          PUBLISH_INTERVAL_MS,
+          NewCallback(this, &FrameTimer::PublishTimeout));
+    }
+  }
+}
+
+
+FrameTimer::~FrameTimer() {
+  if (m_scheduler && m_publish_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_publish_timeout);
+  }
+
+  if (m_frame_rate_var) {
+    m_frame_rate_var->Remove(m_device);
+    m_jitter_var->Remove(m_device);
+    m_max_jitter_var->Remove(m_device);
+  }
+}
+
+
+bool FrameTimer::ConfigureThread() {
+  bool ok = true;
+  if (m_options.realtime_priority) {
+    struct sched_param param;
+    param.sched_priority = m_options.realtime_priority;
+    if (ola::thread::SetSchedParam(pthread_self(), SCHED_FIFO, param)) {
+      OLA_INFO << "DMX output for " << m_device << " running as SCHED_FIFO, "
+               << "priority " << m_options.realtime_priority;
+    } else {
+      ok = false;
+    }
+  }
+
+  if (m_options.cpu >= 0) {
+    if (ola::thread::SetCPUAffinity(pthread_self(), m_options.cpu)) {
+      OLA_INFO << "DMX output for " << m_device << " pinned to CPU "
+               << m_options.cpu;
+    } else {
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+
+void FrameTimer::StartFrame() {
+  TimeStamp now;
+  if (m_options.frame_rate == 0) {
+    m_clock.CurrentMonotonicTime(&now);
+    TimeInterval jitter;
+    if (m_last_frame.IsSet()) {
+      TimeInterval period = now - m_last_frame;
+      if (!m_last_period.IsZero()) {
+        jitter = TimeInterval(period.AsInt() - m_last_period.AsInt());
+      }
+      m_last_period = period;
+    }
+    RecordFrame(now, jitter);
+    return;
+  }
+
+  if (m_next_frame.IsSet()) {
+    WaitUntil(m_next_frame);
+  }
+  m_clock.CurrentMonotonicTime(&now);
+
+  TimeInterval jitter;
+  if (m_next_frame.IsSet() && now < m_next_frame + m_frame_interval) {
+    jitter = now - m_next_frame;
+    m_next_frame += m_frame_interval;
+  } else {
+    // Either this is the first frame, or we've fallen more than a frame
+    // behind. Rather than sending a burst of frames to catch up, restart the
+    // schedule from now.
+    m_next_frame = now + m_frame_interval;
+  }
+  RecordFrame(now, jitter);
+}
+
+
+void FrameTimer::Delay(unsigned int microseconds) {
+  TimeStamp deadline;
+  m_clock.CurrentMonotonicTime(&deadline);
+  deadline += TimeInterval(static_cast<int64_t>(microseconds));
+  WaitUntil(deadline);
+}
+
+
+void FrameTimer::WaitUntil(const TimeStamp &deadline) {
+  TimeStamp now;
+  m_clock.CurrentMonotonicTime(&now);
+  if (now >= deadline) {
+    return;
+  }
+
+  const TimeInterval spin_time(static_cast<int64_t>(m_options.spin_time));
+  if (deadline - now > spin_time) {
+    SleepUntil(deadline - spin_time);
+  }
+
+  // The scheduler may wake us late, so the last part of the wait is spent
+  // polling the clock.
+  do {
+    m_clock.CurrentMonotonicTime(&now);
+  } while (now < deadline);
+}
+
+
+void FrameTimer::SleepUntil(const TimeStamp &wake_up) {
+#if defined(HAVE_CLOCK_NANOSLEEP) && defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+  ts.tv_sec = wake_up.Seconds();
+  ts.tv_nsec = wake_up.MicroSeconds() * ONE_THOUSAND;
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+  }
+#else
+  TimeStamp now;
+  m_clock.CurrentMonotonicTime(&now);
+  if (wake_up > now) {
+    usleep((wake_up - now).AsInt());
+  }
+#endif  // HAVE_CLOCK_NANOSLEEP
+}
+
+
+void FrameTimer::RecordFrame(const TimeStamp &now,
+                             const TimeInterval &jitter) {
+  m_last_frame = now;
+  if (!m_window_start.IsSet()) {
+    m_window_start = now;
+    return;
+  }
+
+  int64_t jitter_us = jitter.AsInt();
+  if (jitter_us < 0) {
+    jitter_us = -jitter_us;
+  }
+  m_window_frames++;
+  m_window_jitter += jitter_us;
+  if (jitter_us > m_window_max_jitter) {
+    m_window_max_jitter = jitter_us;
+  }
+
+  const int64_t window = (now - m_window_start).AsInt();
+  if (window < USEC_IN_SECONDS) {
+    return;
+  }
+
+  {
+    MutexLocker locker(&m_stats_mutex);
+    m_frame_rate = static_cast<unsigned int>(
+        (m_window_frames * static_cast<int64_t>(USEC_IN_SECONDS) +
+         window / 2) / window);
+    m_jitter = m_window_jitter / m_window_frames;
+    m_max_jitter = m_window_max_jitter;
+  }
+
+  m_window_start = now;
+  m_window_frames = 0;
+  m_window_jitter = 0;
+  m_window_max_jitter = 0;
+}
+
+
+void FrameTimer::PublishStats() {
+  if (!m_frame_rate_var) {
+    return;
+  }
+
+  MutexLocker locker(&m_stats_mutex);
+  (*m_frame_rate_var)[m_device] = m_frame_rate;
+  (*m_jitter_var)[m_device] = m_jitter;
+  (*m_max_jitter_var)[m_device] = m_max_jitter;
+}
+
+
+unsigned int FrameTimer::FrameRate() const {
+  MutexLocker locker(&m_stats_mutex);
+  return m_frame_rate;
+}
+
+
+unsigned int FrameTimer::Jitter() const {
+  MutexLocker locker(&m_stats_mutex);
+  return m_jitter;
+}
+
+
+unsigned int FrameTimer::MaxJitter() const {
+  MutexLocker locker(&m_stats_mutex);
+  return m_max_jitter;
+}
+
+
+bool FrameTimer::PublishTimeout() {
+  PublishStats();
+  return true;
+}
+}  // namespace dmx
+}  // namespace ola
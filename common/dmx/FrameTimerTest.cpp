@@ -0,0 +1,205 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FrameTimerTest.cpp
+ * Test fixture for the FrameTimer class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/dmx/FrameTimer.h"
+#include "ola/io/SelectServer.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::Clock;
+using ola::ExportMap;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::dmx::FrameTimer;
+using std::string;
+
+class FrameTimerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(FrameTimerTest);
+  CPPUNIT_TEST(testDelay);
+  CPPUNIT_TEST(testWaitUntil);
+  CPPUNIT_TEST(testFrameRate);
+  CPPUNIT_TEST(testStats);
+  CPPUNIT_TEST(testScheduledPublish);
+  CPPUNIT_TEST(testRemoveStats);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testDelay();
+    void testWaitUntil();
+    void testFrameRate();
+    void testStats();
+    void testScheduledPublish();
+    void testRemoveStats();
+
+ private:
+    Clock m_clock;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FrameTimerTest);
+
+
+/*
+ * Check that Delay() waits for at least the requested time, both for short
+ * intervals that are all busy wait and longer ones that sleep.
+ */
+void FrameTimerTest::testDelay() {
+  FrameTimer timer((FrameTimer::Options()));
+  TimeStamp start, end;
+
+  m_clock.CurrentMonotonicTime(&start);
+  timer.Delay(50);
+  m_clock.CurrentMonotonicTime(&end);
+  OLA_ASSERT_TRUE(end - start >= TimeInterval(0, 50));
+
+  m_clock.CurrentMonotonicTime(&start);
+  timer.Delay(5000);
+  m_clock.CurrentMonotonicTime(&end);
+  OLA_ASSERT_TRUE(end - start >= TimeInterval(0, 5000));
+
+  // with busy waiting disabled
+  FrameTimer::Options options;
+  options.spin_time = 0;
+  FrameTimer sleep_timer(options);
+  m_clock.CurrentMonotonicTime(&start);
+  sleep_timer.Delay(2000);
+  m_clock.CurrentMonotonicTime(&end);
+  OLA_ASSERT_TRUE(end - start >= TimeInterval(0, 2000));
+}
+
+
+/*
+ * Check WaitUntil()
+ */
+void FrameTimerTest::testWaitUntil() {
+  FrameTimer timer((FrameTimer::Options()));
+  TimeStamp deadline, now;
+
+  m_clock.CurrentMonotonicTime(&deadline);
+  deadline += TimeInterval(0, 3000);
+  timer.WaitUntil(deadline);
+  m_clock.CurrentMonotonicTime(&now);
+  OLA_ASSERT_TRUE(now >= deadline);
+
+  // a deadline in the past returns immediately
+  timer.WaitUntil(deadline - TimeInterval(1, 0));
+}
+
+
+/*
+ * Check that StartFrame() holds the frame rate.
+ */
+void FrameTimerTest::testFrameRate() {
+  FrameTimer::Options options;
+  options.frame_rate = 200;
+  FrameTimer timer(options);
+
+  TimeStamp start, end;
+  timer.StartFrame();
+  m_clock.CurrentMonotonicTime(&start);
+  for (unsigned int i = 0; i < 20; i++) {
+    timer.StartFrame();
+  }
+  m_clock.CurrentMonotonicTime(&end);
+  // 20 frames at 5ms each, allow for the first frame starting a little late.
+  OLA_ASSERT_TRUE(end - start >= TimeInterval(0, 95000));
+}
+
+
+/*
+ * Check the statistics are calculated and exported.
+ */
+void FrameTimerTest::testStats() {
+  ExportMap export_map;
+  FrameTimer::Options options;
+  options.frame_rate = 400;
+  FrameTimer timer(options, &export_map, "/dev/ttyS0");
+
+  ola::UIntMap *fps = export_map.GetUIntMapVar("dmx-output-fps");
+  OLA_ASSERT_EQ(0u, (*fps)["/dev/ttyS0"]);
+  OLA_ASSERT_EQ(0u, timer.FrameRate());
+
+  TimeStamp start, now;
+  m_clock.CurrentMonotonicTime(&start);
+  do {
+    timer.StartFrame();
+    m_clock.CurrentMonotonicTime(&now);
+  } while (timer.FrameRate() == 0 && now - start < TimeInterval(5, 0));
+
+  // The rate can never be higher than requested. Allow plenty of room below
+  // it for heavily loaded test machines.
+  OLA_ASSERT_TRUE(timer.FrameRate() <= 401);
+  OLA_ASSERT_TRUE(timer.FrameRate() >= 200);
+  OLA_ASSERT_TRUE(timer.MaxJitter() >= timer.Jitter());
+
+  // The output thread doesn't touch the ExportMap, the owner publishes.
+  OLA_ASSERT_EQ(0u, (*fps)["/dev/ttyS0"]);
+  timer.PublishStats();
+  OLA_ASSERT_EQ(timer.FrameRate(), (*fps)["/dev/ttyS0"]);
+  OLA_ASSERT_EQ(
+      timer.MaxJitter(),
+      (*export_map.GetUIntMapVar("dmx-output-max-jitter-us"))["/dev/ttyS0"]);
+}
+
+
+/*
+ * Check the statistics are published from the scheduler's thread.
+ */
+void FrameTimerTest::testScheduledPublish() {
+  ola::io::SelectServer ss;
+  ExportMap export_map;
+  FrameTimer::Options options;
+  options.frame_rate = 400;
+  FrameTimer timer(options, &export_map, "/dev/ttyS0", &ss);
+
+  TimeStamp start, now;
+  m_clock.CurrentMonotonicTime(&start);
+  do {
+    timer.StartFrame();
+    m_clock.CurrentMonotonicTime(&now);
+  } while (timer.FrameRate() == 0 && now - start < TimeInterval(5, 0));
+  OLA_ASSERT_NE(0u, timer.FrameRate());
+
+  // The publish timeout is due by now.
+  ss.RunOnce(TimeInterval(0, 100000));
+  OLA_ASSERT_EQ(timer.FrameRate(),
+                (*export_map.GetUIntMapVar("dmx-output-fps"))["/dev/ttyS0"]);
+}
+
+
+/*
+ * Check the statistics are removed from the ExportMap with the timer.
+ */
+void FrameTimerTest::testRemoveStats() {
+  ExportMap export_map;
+  ola::UIntMap *fps = export_map.GetUIntMapVar("dmx-output-fps");
+  {
+    FrameTimer timer(FrameTimer::Options(), &export_map, "/dev/ttyS0");
+    OLA_ASSERT_NE(string::npos, fps->Value().find("/dev/ttyS0"));
+  }
+  OLA_ASSERT_EQ(string::npos, fps->Value().find("/dev/ttyS0"));
+  OLA_ASSERT_EQ(
+      string::npos,
+      export_map.GetUIntMapVar("dmx-output-jitter-us")->Value().find(
+          "/dev/ttyS0"));
+}
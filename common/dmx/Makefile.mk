@@ -1,10 +1,18 @@
 # LIBRARIES
 ##################################################
-common_libolacommon_la_SOURCES += common/dmx/RunLengthEncoder.cpp
+common_libolacommon_la_SOURCES += \
+    common/dmx/FrameTimer.cpp \
+    common/dmx/RunLengthEncoder.cpp
 
 # TESTS
 ##################################################
-test_programs += common/dmx/RunLengthEncoderTester
+test_programs += \
+    common/dmx/FrameTimerTester \
+    common/dmx/RunLengthEncoderTester
+
+common_dmx_FrameTimerTester_SOURCES = common/dmx/FrameTimerTest.cpp
+common_dmx_FrameTimerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_dmx_FrameTimerTester_LDADD = $(COMMON_TESTING_LIBS)
 
 common_dmx_RunLengthEncoderTester_SOURCES = common/dmx/RunLengthEncoderTest.cpp
 common_dmx_RunLengthEncoderTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
@@ -20,6 +20,7 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/types.h>
@@ -53,6 +54,14 @@ namespace io {
 STATIC_ASSERT(sizeof(struct iovec) == sizeof(struct IOVec));
 #endif  // _WIN32
 
+namespace {
+#ifdef IOV_MAX
+const unsigned int MAX_IOVECS_PER_SEND = IOV_MAX;
+#else
+const unsigned int MAX_IOVECS_PER_SEND = 1024;
+#endif  // IOV_MAX
+}  // namespace
+
 
 #ifdef _WIN32
 // DescriptorHandle
@@ -370,6 +379,9 @@ ssize_t ConnectedDescriptor::Send(IOQueue *ioqueue) {
 
   int iocnt;
   const struct IOVec *iov = ioqueue->AsIOVec(&iocnt);
+  // writev() & sendmsg() fail with EMSGSIZE / EINVAL if passed more than
+  // IOV_MAX blocks. The rest of the data stays in the queue for the next call.
+  iocnt = std::min(iocnt, static_cast<int>(MAX_IOVECS_PER_SEND));
 
   ssize_t bytes_sent = 0;
 
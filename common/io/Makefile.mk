@@ -12,6 +12,7 @@ common_libolacommon_la_SOURCES += \
     common/io/PollerInterface.h \
     common/io/SelectServer.cpp \
     common/io/Serial.cpp \
+    common/io/SerialBuffer.cpp \
     common/io/StdinHandler.cpp \
     common/io/TimeoutManager.cpp \
     common/io/TimeoutManager.h
@@ -46,6 +47,7 @@ test_programs += \
     common/io/IOStackTester \
     common/io/MemoryBlockTester \
     common/io/SelectServerTester \
+    common/io/SerialBufferTester \
     common/io/StreamTester \
     common/io/TimeoutManagerTester
 
@@ -70,6 +72,10 @@ common_io_SelectServerTester_SOURCES = common/io/SelectServerTest.cpp \
 common_io_SelectServerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_io_SelectServerTester_LDADD = $(COMMON_TESTING_LIBS)
 
+common_io_SerialBufferTester_SOURCES = common/io/SerialBufferTest.cpp
+common_io_SerialBufferTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_io_SerialBufferTester_LDADD = $(COMMON_TESTING_LIBS)
+
 common_io_TimeoutManagerTester_SOURCES = common/io/TimeoutManagerTest.cpp
 common_io_TimeoutManagerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_io_TimeoutManagerTester_LDADD = $(COMMON_TESTING_LIBS)
@@ -18,6 +18,7 @@
  * Copyright (C) 2012 Simon Newton
  */
 
+#include <string.h>
 #include <cppunit/extensions/HelperMacros.h>
 #include <memory>
 #include <iostream>
@@ -34,11 +35,13 @@ class MemoryBlockTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(MemoryBlockTest);
   CPPUNIT_TEST(testAppend);
   CPPUNIT_TEST(testPrepend);
+  CPPUNIT_TEST(testExtend);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   void testAppend();
   void testPrepend();
+  void testExtend();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(MemoryBlockTest);
@@ -120,3 +123,35 @@ void MemoryBlockTest::testPrepend() {
   // now that all data is removed, the block should reset
   OLA_ASSERT_EQ(100u, block.Remaining());
 }
+
+
+/*
+ * Test writing directly to the block.
+ */
+void MemoryBlockTest::testExtend() {
+  unsigned int size = 8;
+  uint8_t *data = new uint8_t[size];
+  MemoryBlock block(data, size);
+
+  const uint8_t data1[] = {1, 2, 3, 4, 5};
+  memcpy(block.Data() + block.Size(), data1, arraysize(data1));
+  OLA_ASSERT_EQ(5u, block.Extend(arraysize(data1)));
+  OLA_ASSERT_EQ(5u, block.Size());
+  OLA_ASSERT_EQ(3u, block.Remaining());
+  OLA_ASSERT_DATA_EQUALS(data1, arraysize(data1), block.Data(), block.Size());
+
+  // try to extend past the end of the block
+  OLA_ASSERT_EQ(3u, block.Extend(10));
+  OLA_ASSERT_EQ(size, block.Size());
+  OLA_ASSERT_EQ(0u, block.Remaining());
+
+  // remove the unused bytes from the end
+  OLA_ASSERT_EQ(3u, block.PopBack(3));
+  OLA_ASSERT_EQ(5u, block.Size());
+  OLA_ASSERT_EQ(3u, block.Remaining());
+  OLA_ASSERT_DATA_EQUALS(data1, arraysize(data1), block.Data(), block.Size());
+
+  // try to pop more data than exists
+  OLA_ASSERT_EQ(5u, block.PopBack(6));
+  OLA_ASSERT_TRUE(block.Empty());
+}
@@ -0,0 +1,166 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SerialBuffer.cpp
+ * Buffered reads and writes for framed serial protocols.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <algorithm>
+
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/io/SerialBuffer.h"
+
+namespace ola {
+namespace io {
+
+const unsigned int SerialBuffer::DEFAULT_READ_SIZE;
+const unsigned int SerialBuffer::DEFAULT_MAX_PENDING;
+
+SerialBuffer::SerialBuffer(ConnectedDescriptor *descriptor,
+                           SelectServerInterface *ss,
+                           unsigned int read_size,
+                           unsigned int max_pending)
+    : m_descriptor(descriptor),
+      m_ss(ss),
+      m_read_buffer(new uint8_t[read_size]),
+      m_read_size(read_size),
+      m_read_offset(0),
+      m_read_end(0),
+      m_max_pending(max_pending),
+      m_associated(false) {
+  if (m_ss) {
+    m_descriptor->SetOnWritable(
+        ola::NewCallback(this, &SerialBuffer::PerformWrite));
+  }
+}
+
+
+SerialBuffer::~SerialBuffer() {
+  if (m_associated) {
+    m_ss->RemoveWriteDescriptor(m_descriptor);
+  }
+  if (m_ss) {
+    m_descriptor->SetOnWritable(NULL);
+  }
+  delete[] m_read_buffer;
+}
+
+
+unsigned int SerialBuffer::Read() {
+  // Move any partial frame to the start of the buffer so frames are always
+  // contiguous.
+  if (m_read_offset) {
+    memmove(m_read_buffer, m_read_buffer + m_read_offset, Size());
+    m_read_end -= m_read_offset;
+    m_read_offset = 0;
+  }
+
+  if (m_read_end == m_read_size) {
+    return 0;
+  }
+
+  unsigned int data_read = 0;
+  if (m_descriptor->Receive(m_read_buffer + m_read_end,
+                            m_read_size - m_read_end, data_read) < 0) {
+    return 0;
+  }
+  m_read_end += data_read;
+  return data_read;
+}
+
+
+void SerialBuffer::Consume(unsigned int length) {
+  m_read_offset += std::min(length, Size());
+  if (m_read_offset == m_read_end) {
+    Clear();
+  }
+}
+
+
+bool SerialBuffer::SkipTo(uint8_t value) {
+  const uint8_t *start = Data();
+  const uint8_t *match = reinterpret_cast<const uint8_t*>(
+      memchr(start, value, Size()));
+  if (!match) {
+    Clear();
+    return false;
+  }
+  Consume(static_cast<unsigned int>(match - start));
+  return true;
+}
+
+
+bool SerialBuffer::Send(const uint8_t *data, unsigned int length) {
+  if (!m_descriptor->ValidWriteDescriptor()) {
+    return false;
+  }
+
+  if (!Flush()) {
+    // Still waiting on an earlier frame, queue this one behind it.
+    if (m_pending.Size() + length > m_max_pending) {
+      OLA_INFO << "Serial write queue full, dropping " << length << " bytes";
+      return false;
+    }
+    m_pending.Write(data, length);
+    return true;
+  }
+
+  ssize_t bytes_sent = m_descriptor->Send(data, length);
+  if (bytes_sent < 0) {
+    if (errno != EAGAIN) {
+      return false;
+    }
+    bytes_sent = 0;
+  }
+
+  unsigned int sent = static_cast<unsigned int>(bytes_sent);
+  if (sent < length) {
+    m_pending.Write(data + sent, length - sent);
+    if (m_ss && !m_associated) {
+      m_ss->AddWriteDescriptor(m_descriptor);
+      m_associated = true;
+    }
+  }
+  return true;
+}
+
+
+/*
+ * Try to write any queued data.
+ * @returns true if the queue is empty.
+ */
+bool SerialBuffer::Flush() {
+  if (m_pending.Size()) {
+    m_descriptor->Send(&m_pending);
+  }
+  return m_pending.Size() == 0;
+}
+
+
+/*
+ * Called when the descriptor is writable.
+ */
+void SerialBuffer::PerformWrite() {
+  if (Flush() && m_associated) {
+    m_ss->RemoveWriteDescriptor(m_descriptor);
+    m_associated = false;
+  }
+}
+}  // namespace io
+}  // namespace ola
@@ -0,0 +1,182 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SerialBufferTest.cpp
+ * Test fixture for the SerialBuffer class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <algorithm>
+#include <string>
+
+#include "ola/io/Descriptor.h"
+#include "ola/io/IOQueue.h"
+#include "ola/io/SerialBuffer.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::io::IOQueue;
+using ola::io::LoopbackDescriptor;
+using ola::io::SerialBuffer;
+using std::string;
+
+namespace {
+/*
+ * A descriptor that only accepts a limited number of bytes per write.
+ */
+class ShortWriteDescriptor: public LoopbackDescriptor {
+ public:
+  ShortWriteDescriptor() : m_limit(0) {}
+
+  void SetLimit(unsigned int limit) { m_limit = limit; }
+  const string &Written() const { return m_written; }
+
+  ssize_t Send(const uint8_t *buffer, unsigned int size) {
+    unsigned int length = std::min(size, m_limit);
+    m_written.append(reinterpret_cast<const char*>(buffer), length);
+    m_limit -= length;
+    return length;
+  }
+
+  ssize_t Send(IOQueue *data) {
+    unsigned int length = std::min(data->Size(), m_limit);
+    string output;
+    data->Read(&output, length);
+    data->Pop(length);
+    m_written.append(output);
+    m_limit -= length;
+    return length;
+  }
+
+ private:
+  unsigned int m_limit;
+  string m_written;
+};
+}  // namespace
+
+class SerialBufferTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(SerialBufferTest);
+  CPPUNIT_TEST(testRead);
+  CPPUNIT_TEST(testFullBuffer);
+  CPPUNIT_TEST(testPartialWrites);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testRead();
+  void testFullBuffer();
+  void testPartialWrites();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SerialBufferTest);
+
+
+/*
+ * Check that reading, skipping and consuming work.
+ */
+void SerialBufferTest::testRead() {
+  LoopbackDescriptor descriptor;
+  OLA_ASSERT_TRUE(descriptor.Init());
+  SerialBuffer buffer(&descriptor);
+  OLA_ASSERT_EQ(0u, buffer.Size());
+  OLA_ASSERT_EQ(0u, buffer.Read());
+
+  const uint8_t data[] = {1, 2, 0x7e, 3, 4, 0x7e, 5};
+  OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(data)),
+                descriptor.Send(data, sizeof(data)));
+  OLA_ASSERT_EQ(static_cast<unsigned int>(sizeof(data)), buffer.Read());
+  OLA_ASSERT_DATA_EQUALS(data, sizeof(data), buffer.Data(), buffer.Size());
+
+  OLA_ASSERT_TRUE(buffer.SkipTo(0x7e));
+  OLA_ASSERT_EQ(5u, buffer.Size());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0x7e), buffer.Data()[0]);
+  // already at the front
+  OLA_ASSERT_TRUE(buffer.SkipTo(0x7e));
+  OLA_ASSERT_EQ(5u, buffer.Size());
+
+  buffer.Consume(1);
+  OLA_ASSERT_TRUE(buffer.SkipTo(0x7e));
+  OLA_ASSERT_EQ(2u, buffer.Size());
+
+  // more data arrives, the partial frame is kept
+  const uint8_t more_data[] = {6, 7};
+  descriptor.Send(more_data, sizeof(more_data));
+  OLA_ASSERT_EQ(2u, buffer.Read());
+  const uint8_t expected[] = {0x7e, 5, 6, 7};
+  OLA_ASSERT_DATA_EQUALS(expected, sizeof(expected), buffer.Data(),
+                         buffer.Size());
+
+  buffer.Consume(1);
+  OLA_ASSERT_FALSE(buffer.SkipTo(0x7e));
+  OLA_ASSERT_EQ(0u, buffer.Size());
+
+  // consuming more than we have is safe
+  descriptor.Send(more_data, sizeof(more_data));
+  buffer.Read();
+  buffer.Consume(10);
+  OLA_ASSERT_EQ(0u, buffer.Size());
+}
+
+
+/*
+ * Check that a full buffer stops reading until data is consumed.
+ */
+void SerialBufferTest::testFullBuffer() {
+  LoopbackDescriptor descriptor;
+  OLA_ASSERT_TRUE(descriptor.Init());
+  SerialBuffer buffer(&descriptor, NULL, 4);
+
+  const uint8_t data[] = {1, 2, 3, 4, 5, 6};
+  descriptor.Send(data, sizeof(data));
+  OLA_ASSERT_EQ(4u, buffer.Read());
+  OLA_ASSERT_EQ(0u, buffer.Read());
+  OLA_ASSERT_DATA_EQUALS(data, 4, buffer.Data(), buffer.Size());
+
+  buffer.Consume(3);
+  OLA_ASSERT_EQ(2u, buffer.Read());
+  OLA_ASSERT_DATA_EQUALS(data + 3, 3, buffer.Data(), buffer.Size());
+}
+
+
+/*
+ * Check that partial writes are queued and completed before later frames.
+ */
+void SerialBufferTest::testPartialWrites() {
+  ShortWriteDescriptor descriptor;
+  OLA_ASSERT_TRUE(descriptor.Init());
+  SerialBuffer buffer(&descriptor, NULL, SerialBuffer::DEFAULT_READ_SIZE, 6);
+
+  descriptor.SetLimit(2);
+  const uint8_t frame1[] = {'a', 'b', 'c', 'd'};
+  OLA_ASSERT_TRUE(buffer.Send(frame1, sizeof(frame1)));
+  OLA_ASSERT_EQ(string("ab"), descriptor.Written());
+  OLA_ASSERT_EQ(2u, buffer.PendingWrite());
+
+  // The descriptor is still blocked, so this is queued behind the first frame
+  const uint8_t frame2[] = {'e', 'f', 'g'};
+  OLA_ASSERT_TRUE(buffer.Send(frame2, sizeof(frame2)));
+  OLA_ASSERT_EQ(5u, buffer.PendingWrite());
+
+  // This would exceed the limit, so it's dropped
+  OLA_ASSERT_FALSE(buffer.Send(frame2, sizeof(frame2)));
+  OLA_ASSERT_EQ(5u, buffer.PendingWrite());
+
+  // Once the descriptor accepts data, the queue is flushed first
+  descriptor.SetLimit(100);
+  const uint8_t frame3[] = {'h'};
+  OLA_ASSERT_TRUE(buffer.Send(frame3, sizeof(frame3)));
+  OLA_ASSERT_EQ(string("abcdefgh"), descriptor.Written());
+  OLA_ASSERT_EQ(0u, buffer.PendingWrite());
+}
@@ -0,0 +1,143 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * BatchedHealthChecker.cpp
+ * Health checks a large number of connections from a single timer.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/network/BatchedHealthChecker.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/thread/SchedulerInterface.h"
+
+namespace ola {
+namespace network {
+
+using ola::TimeInterval;
+using ola::TimeStamp;
+using std::vector;
+
+const unsigned int BatchedHealthChecker::DEFAULT_SLOTS;
+
+BatchedHealthChecker::BatchedHealthChecker(
+  ola::thread::SchedulerInterface *scheduler,
+  const ola::Clock *clock,
+  const TimeInterval &heartbeat_interval,
+  unsigned int slots)
+    : m_scheduler(scheduler),
+      m_clock(clock),
+      m_tick_interval(heartbeat_interval.AsInt() / (slots ? slots : 1)),
+      m_send_after(heartbeat_interval.AsInt() - m_tick_interval.AsInt()),
+      m_receive_timeout(heartbeat_interval.AsInt() * 5 / 2),
+      m_slots(slots ? slots : 1),
+      m_next_slot(0),
+      m_current_slot(0),
+      m_timeout_id(ola::thread::INVALID_TIMEOUT) {
+}
+
+
+BatchedHealthChecker::~BatchedHealthChecker() {
+  if (m_timeout_id != ola::thread::INVALID_TIMEOUT)
+    m_scheduler->RemoveTimeout(m_timeout_id);
+}
+
+
+void BatchedHealthChecker::AddConnection(Connection *connection) {
+  if (STLContains(m_connections, connection))
+    return;
+
+  TimeStamp now;
+  m_clock->CurrentMonotonicTime(&now);
+
+  ConnectionState &state = m_connections[connection];
+  state.slot = m_next_slot;
+  state.last_received = now;
+  state.last_sent = now;
+  m_slots[state.slot].insert(connection);
+  m_next_slot = (m_next_slot + 1) % m_slots.size();
+
+  if (m_timeout_id == ola::thread::INVALID_TIMEOUT) {
+    m_timeout_id = m_scheduler->RegisterRepeatingTimeout(
+        m_tick_interval, NewCallback(this, &BatchedHealthChecker::Tick));
+  }
+
+  connection->SendHeartbeat();
+}
+
+
+void BatchedHealthChecker::RemoveConnection(Connection *connection) {
+  ConnectionMap::iterator iter = m_connections.find(connection);
+  if (iter == m_connections.end())
+    return;
+
+  m_slots[iter->second.slot].erase(connection);
+  m_connections.erase(iter);
+  // The timer stops itself on the next tick if this was the last connection.
+}
+
+
+void BatchedHealthChecker::HeartbeatReceived(Connection *connection) {
+  ConnectionState *state = STLFind(&m_connections, connection);
+  if (state)
+    m_clock->CurrentMonotonicTime(&state->last_received);
+}
+
+
+void BatchedHealthChecker::HeartbeatSent(Connection *connection) {
+  ConnectionState *state = STLFind(&m_connections, connection);
+  if (state)
+    m_clock->CurrentMonotonicTime(&state->last_sent);
+}
+
+
+/*
+ * Visit the connections in the current slot. The callbacks may add or remove
+ * connections, so we work from a copy and re-check membership before each
+ * one.
+ */
+bool BatchedHealthChecker::Tick() {
+  TimeStamp now;
+  m_clock->CurrentMonotonicTime(&now);
+
+  const Slot &slot = m_slots[m_current_slot];
+  vector<Connection*> connections(slot.begin(), slot.end());
+  m_current_slot = (m_current_slot + 1) % m_slots.size();
+
+  vector<Connection*>::iterator iter = connections.begin();
+  for (; iter != connections.end(); ++iter) {
+    ConnectionState *state = STLFind(&m_connections, *iter);
+    if (!state)
+      continue;
+
+    if (now - state->last_received >= m_receive_timeout) {
+      RemoveConnection(*iter);
+      (*iter)->HeartbeatTimeout();
+    } else if (now - state->last_sent >= m_send_after) {
+      state->last_sent = now;
+      (*iter)->SendHeartbeat();
+    }
+  }
+
+  if (m_connections.empty()) {
+    m_timeout_id = ola::thread::INVALID_TIMEOUT;
+    return false;
+  }
+  return true;
+}
+}  // namespace network
+}  // namespace ola
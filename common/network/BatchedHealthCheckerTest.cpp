@@ -0,0 +1,184 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * BatchedHealthCheckerTest.cpp
+ * Test fixture for the BatchedHealthChecker class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "ola/Clock.h"
+#include "ola/Logging.h"
+#include "ola/io/SelectServer.h"
+#include "ola/network/BatchedHealthChecker.h"
+#include "ola/testing/TestUtils.h"
+
+
+using ola::MockClock;
+using ola::TimeInterval;
+using ola::io::SelectServer;
+using ola::network::BatchedHealthChecker;
+
+
+class MockConnection: public BatchedHealthChecker::Connection {
+ public:
+    MockConnection()
+        : heartbeats_sent(0),
+          timeouts(0),
+          checker(NULL),
+          remove_on_timeout(NULL) {
+    }
+
+    void SendHeartbeat() { heartbeats_sent++; }
+
+    void HeartbeatTimeout() {
+      timeouts++;
+      if (remove_on_timeout)
+        checker->RemoveConnection(remove_on_timeout);
+    }
+
+    unsigned int heartbeats_sent;
+    unsigned int timeouts;
+    BatchedHealthChecker *checker;
+    MockConnection *remove_on_timeout;
+};
+
+
+class BatchedHealthCheckerTest: public CppUnit::TestFixture {
+ public:
+    BatchedHealthCheckerTest()
+        : CppUnit::TestFixture(),
+          m_ss(NULL, &m_clock) {
+    }
+
+  CPPUNIT_TEST_SUITE(BatchedHealthCheckerTest);
+  CPPUNIT_TEST(testHeartbeats);
+  CPPUNIT_TEST(testPiggybackedHeartbeats);
+  CPPUNIT_TEST(testRemoveDuringTimeout);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testHeartbeats();
+    void testPiggybackedHeartbeats();
+    void testRemoveDuringTimeout();
+
+ private:
+    MockClock m_clock;
+    SelectServer m_ss;
+
+    void Advance() {
+      m_clock.AdvanceTime(0, 250000);
+      m_ss.RunOnce(TimeInterval(0, 0));
+    }
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BatchedHealthCheckerTest);
+
+
+/*
+ * Check heartbeats are sent once per interval and that a silent connection is
+ * timed out.
+ */
+void BatchedHealthCheckerTest::testHeartbeats() {
+  // A 1s interval and 4 slots, so one slot is visited every 250ms.
+  BatchedHealthChecker checker(&m_ss, &m_clock, TimeInterval(1, 0), 4);
+  MockConnection connection1, connection2, silent_connection;
+
+  checker.AddConnection(&connection1);
+  checker.AddConnection(&connection2);
+  checker.AddConnection(&silent_connection);
+  OLA_ASSERT_EQ(3u, checker.ConnectionCount());
+  OLA_ASSERT_EQ(1u, connection1.heartbeats_sent);
+  OLA_ASSERT_EQ(1u, connection2.heartbeats_sent);
+  OLA_ASSERT_EQ(1u, silent_connection.heartbeats_sent);
+
+  for (unsigned int i = 0; i < 16; i++) {
+    Advance();
+    checker.HeartbeatReceived(&connection1);
+    checker.HeartbeatReceived(&connection2);
+  }
+
+  // The initial heartbeat plus one per second.
+  OLA_ASSERT_EQ(4u, connection1.heartbeats_sent);
+  OLA_ASSERT_EQ(4u, connection2.heartbeats_sent);
+  OLA_ASSERT_EQ(0u, connection1.timeouts);
+  OLA_ASSERT_EQ(0u, connection2.timeouts);
+
+  // The silent connection was visited at 0.75s and 1.75s, and timed out at
+  // 2.75s.
+  OLA_ASSERT_EQ(3u, silent_connection.heartbeats_sent);
+  OLA_ASSERT_EQ(1u, silent_connection.timeouts);
+  OLA_ASSERT_EQ(2u, checker.ConnectionCount());
+
+  checker.RemoveConnection(&connection1);
+  checker.RemoveConnection(&connection2);
+  OLA_ASSERT_EQ(0u, checker.ConnectionCount());
+  for (unsigned int i = 0; i < 8; i++) {
+    Advance();
+  }
+  OLA_ASSERT_EQ(4u, connection1.heartbeats_sent);
+
+  // Adding a connection restarts the timer.
+  checker.AddConnection(&connection1);
+  for (unsigned int i = 0; i < 4; i++) {
+    Advance();
+    checker.HeartbeatReceived(&connection1);
+  }
+  OLA_ASSERT_EQ(6u, connection1.heartbeats_sent);
+}
+
+
+/*
+ * Check that piggybacked heartbeats suppress the regular ones.
+ */
+void BatchedHealthCheckerTest::testPiggybackedHeartbeats() {
+  BatchedHealthChecker checker(&m_ss, &m_clock, TimeInterval(1, 0), 4);
+  MockConnection connection;
+  checker.AddConnection(&connection);
+
+  for (unsigned int i = 0; i < 16; i++) {
+    Advance();
+    checker.HeartbeatSent(&connection);
+    checker.HeartbeatReceived(&connection);
+  }
+  OLA_ASSERT_EQ(1u, connection.heartbeats_sent);
+  OLA_ASSERT_EQ(0u, connection.timeouts);
+  checker.RemoveConnection(&connection);
+}
+
+
+/*
+ * Check that a timeout handler can remove other connections that have also
+ * timed out.
+ */
+void BatchedHealthCheckerTest::testRemoveDuringTimeout() {
+  BatchedHealthChecker checker(&m_ss, &m_clock, TimeInterval(1, 0), 1);
+  MockConnection connection1, connection2;
+  connection1.checker = &checker;
+  connection1.remove_on_timeout = &connection2;
+  connection2.checker = &checker;
+  connection2.remove_on_timeout = &connection1;
+
+  checker.AddConnection(&connection1);
+  checker.AddConnection(&connection2);
+
+  for (unsigned int i = 0; i < 16; i++) {
+    Advance();
+  }
+  OLA_ASSERT_EQ(1u, connection1.timeouts + connection2.timeouts);
+  OLA_ASSERT_EQ(0u, checker.ConnectionCount());
+}
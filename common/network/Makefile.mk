@@ -2,6 +2,7 @@
 ##################################################
 common_libolacommon_la_SOURCES += \
     common/network/AdvancedTCPConnector.cpp \
+    common/network/BatchedHealthChecker.cpp \
     common/network/FakeInterfacePicker.h \
     common/network/HealthCheckedConnection.cpp \
     common/network/IPV4Address.cpp \
@@ -38,6 +39,7 @@ test_programs += \
     common/network/TCPConnectorTester
 
 common_network_HealthCheckedConnectionTester_SOURCES = \
+    common/network/BatchedHealthCheckerTest.cpp \
     common/network/HealthCheckedConnectionTest.cpp
 common_network_HealthCheckedConnectionTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_network_HealthCheckedConnectionTester_LDADD = $(COMMON_TESTING_LIBS)
@@ -49,6 +49,7 @@
 #endif  // HAVE_NETINET_IN_H
 
 #include <string>
+#include <vector>
 
 #include "common/network/SocketHelper.h"
 #include "ola/Logging.h"
@@ -78,6 +79,22 @@ bool ReceiveFrom(int fd, uint8_t *buffer, ssize_t *data_read,
 
 }  // namespace
 
+// UDPSocketInterface
+// ------------------------------------------------
+
+unsigned int UDPSocketInterface::SendToMany(
+    const uint8_t *buffer,
+    unsigned int size,
+    const std::vector<IPV4SocketAddress> &destinations) const {
+  unsigned int delivered = 0;
+  std::vector<IPV4SocketAddress>::const_iterator iter = destinations.begin();
+  for (; iter != destinations.end(); ++iter) {
+    if (SendTo(buffer, size, *iter) == static_cast<ssize_t>(size))
+      delivered++;
+  }
+  return delivered;
+}
+
 // UDPSocket
 // ------------------------------------------------
 
@@ -279,6 +296,57 @@ ssize_t UDPSocket::SendTo(ola::io::IOVecInterface *data,
   return bytes_sent;
 }
 
+unsigned int UDPSocket::SendToMany(
+    const uint8_t *buffer,
+    unsigned int size,
+    const std::vector<IPV4SocketAddress> &destinations) const {
+  if (!ValidWriteDescriptor() || destinations.empty())
+    return 0;
+
+#ifdef HAVE_SENDMMSG
+  std::vector<struct sockaddr_in> addresses(destinations.size());
+  std::vector<struct mmsghdr> messages(destinations.size());
+  struct iovec iov;
+  iov.iov_base = const_cast<uint8_t*>(buffer);
+  iov.iov_len = size;
+
+  for (unsigned int i = 0; i < destinations.size(); i++) {
+    destinations[i].ToSockAddr(reinterpret_cast<sockaddr*>(&addresses[i]),
+                               sizeof(addresses[i]));
+    struct msghdr *header = &messages[i].msg_hdr;
+    memset(header, 0, sizeof(*header));
+    header->msg_name = &addresses[i];
+    header->msg_namelen = sizeof(addresses[i]);
+    header->msg_iov = &iov;
+    header->msg_iovlen = 1;
+    messages[i].msg_len = 0;
+  }
+
+  unsigned int sent = 0;
+  while (sent < messages.size()) {
+    int result = sendmmsg(m_handle, &messages[sent], messages.size() - sent,
+                          0);
+    if (result < 0) {
+      OLA_INFO << "sendmmsg failed: " << destinations[sent] << " : "
+               << strerror(errno);
+      // skip the destination that failed, and carry on with the rest
+      sent++;
+      continue;
+    }
+    sent += result;
+  }
+
+  unsigned int delivered = 0;
+  for (unsigned int i = 0; i < messages.size(); i++) {
+    if (messages[i].msg_len == size)
+      delivered++;
+  }
+  return delivered;
+#else
+  return UDPSocketInterface::SendToMany(buffer, size, destinations);
+#endif  // HAVE_SENDMMSG
+}
+
 bool UDPSocket::RecvFrom(uint8_t *buffer, ssize_t *data_read) const {
   socklen_t length = 0;
 #ifdef _WIN32
@@ -464,5 +532,25 @@ bool UDPSocket::SetTos(uint8_t tos) {
   }
   return true;
 }
+
+bool UDPSocket::SetMulticastAll(OLA_UNUSED bool enable) {
+#ifdef IP_MULTICAST_ALL
+  int value = enable ? 1 : 0;
+  int ok = setsockopt(m_handle,
+                      IPPROTO_IP,
+                      IP_MULTICAST_ALL,
+                      reinterpret_cast<char*>(&value),
+                      sizeof(value));
+  if (ok < 0) {
+    OLA_WARN << "Failed to set IP_MULTICAST_ALL for " << m_handle << ", "
+             << strerror(errno);
+    return false;
+  }
+  return true;
+#else
+  OLA_WARN << "IP_MULTICAST_ALL isn't supported on this platform";
+  return false;
+#endif  // IP_MULTICAST_ALL
+}
 }  // namespace network
 }  // namespace ola
@@ -21,14 +21,19 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <stdint.h>
 #include <string.h>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "ola/Callback.h"
+#include "ola/Clock.h"
 #include "ola/Logging.h"
 #include "ola/io/Descriptor.h"
 #include "ola/io/IOQueue.h"
 #include "ola/io/SelectServer.h"
 #include "ola/network/IPV4Address.h"
+#include "ola/network/Interface.h"
+#include "ola/network/InterfacePicker.h"
 #include "ola/network/NetworkUtils.h"
 #include "ola/network/Socket.h"
 #include "ola/network/TCPSocketFactory.h"
@@ -37,14 +42,18 @@
 
 using ola::io::ConnectedDescriptor;
 using ola::io::IOQueue;
+using ola::TimeInterval;
 using ola::io::SelectServer;
 using ola::network::IPV4Address;
 using ola::network::GenericSocketAddress;
 using ola::network::IPV4SocketAddress;
+using ola::network::Interface;
+using ola::network::InterfacePicker;
 using ola::network::TCPAcceptingSocket;
 using ola::network::TCPSocket;
 using ola::network::UDPSocket;
 using std::string;
+using std::vector;
 
 static const unsigned char test_cstring[] = "Foo";
 // used to set a timeout which aborts the tests
@@ -56,6 +65,8 @@ class SocketTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testTCPSocketServerClose);
   CPPUNIT_TEST(testUDPSocket);
   CPPUNIT_TEST(testIOQueueUDPSend);
+  CPPUNIT_TEST(testUDPSendToMany);
+  CPPUNIT_TEST(testMulticastAll);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -65,6 +76,8 @@ class SocketTest: public CppUnit::TestFixture {
     void testTCPSocketServerClose();
     void testUDPSocket();
     void testIOQueueUDPSend();
+    void testUDPSendToMany();
+    void testMulticastAll();
 
     // timing out indicates something went wrong
     void Timeout() {
@@ -82,6 +95,8 @@ class SocketTest: public CppUnit::TestFixture {
     void NewConnectionSendAndClose(TCPSocket *socket);
     void UDPReceiveAndTerminate(UDPSocket *socket);
     void UDPReceiveAndSend(UDPSocket *socket);
+    void UDPReceiveAndCount(UDPSocket *socket);
+    void UDPReceive(UDPSocket *socket, unsigned int *count);
 
     // Socket close actions
     void TerminateOnClose() {
@@ -91,6 +106,7 @@ class SocketTest: public CppUnit::TestFixture {
  private:
     SelectServer *m_ss;
     ola::SingleUseCallback0<void> *m_timeout_closure;
+    unsigned int m_udp_received;
 
     void SocketClientClose(ConnectedDescriptor *socket,
                            ConnectedDescriptor *socket2);
@@ -279,6 +295,126 @@ void SocketTest::testIOQueueUDPSend() {
 }
 
 
+/*
+ * Test sending the same datagram to multiple destinations.
+ */
+void SocketTest::testUDPSendToMany() {
+  m_udp_received = 0;
+  UDPSocket sockets[2];
+  vector<IPV4SocketAddress> destinations;
+  for (unsigned int i = 0; i < 2; i++) {
+    OLA_ASSERT_TRUE(sockets[i].Init());
+    OLA_ASSERT_TRUE(sockets[i].Bind(
+        IPV4SocketAddress(IPV4Address::Loopback(), 0)));
+    IPV4SocketAddress local_address;
+    OLA_ASSERT_TRUE(sockets[i].GetSocketAddress(&local_address));
+    destinations.push_back(local_address);
+    sockets[i].SetOnData(
+        ola::NewCallback(this, &SocketTest::UDPReceiveAndCount, &sockets[i]));
+    OLA_ASSERT_TRUE(m_ss->AddReadDescriptor(&sockets[i]));
+  }
+
+  UDPSocket client_socket;
+  OLA_ASSERT_TRUE(client_socket.Init());
+
+  OLA_ASSERT_EQ(0u, client_socket.SendToMany(
+      static_cast<const uint8_t*>(test_cstring), sizeof(test_cstring),
+      vector<IPV4SocketAddress>()));
+  OLA_ASSERT_EQ(2u, client_socket.SendToMany(
+      static_cast<const uint8_t*>(test_cstring), sizeof(test_cstring),
+      destinations));
+  m_ss->Run();
+  OLA_ASSERT_EQ(2u, m_udp_received);
+  for (unsigned int i = 0; i < 2; i++) {
+    m_ss->RemoveReadDescriptor(&sockets[i]);
+  }
+}
+
+
+/*
+ * Check a socket with IP_MULTICAST_ALL disabled only receives multicast
+ * traffic for the groups it joined itself, so a datagram for a group held by
+ * another socket is delivered once rather than to every socket on the port.
+ */
+void SocketTest::testMulticastAll() {
+  Interface iface;
+  std::auto_ptr<InterfacePicker> picker(InterfacePicker::NewPicker());
+  if (!picker->ChooseInterface(&iface, "")) {
+    OLA_INFO << "No interface available, skipping multicast test";
+    return;
+  }
+
+  IPV4Address group;
+  OLA_ASSERT_TRUE(IPV4Address::FromString("239.255.250.1", &group));
+
+  UDPSocket receiver;
+  OLA_ASSERT_TRUE(receiver.Init());
+  OLA_ASSERT_TRUE(receiver.Bind(IPV4SocketAddress(IPV4Address::WildCard(), 0)));
+  if (!receiver.SetMulticastAll(false)) {
+    OLA_INFO << "IP_MULTICAST_ALL not supported, skipping multicast test";
+    return;
+  }
+  IPV4SocketAddress local_address;
+  OLA_ASSERT_TRUE(receiver.GetSocketAddress(&local_address));
+
+  // A socket on the same port with the default behaviour.
+  UDPSocket other;
+  OLA_ASSERT_TRUE(other.Init());
+  OLA_ASSERT_TRUE(other.Bind(
+      IPV4SocketAddress(IPV4Address::WildCard(), local_address.Port())));
+
+  // The membership is held by a third socket, on a different port.
+  UDPSocket member;
+  OLA_ASSERT_TRUE(member.Init());
+  OLA_ASSERT_TRUE(member.Bind(IPV4SocketAddress(IPV4Address::WildCard(), 0)));
+  if (!member.JoinMulticast(iface.ip_address, group)) {
+    OLA_INFO << "Failed to join " << group << ", skipping multicast test";
+    return;
+  }
+
+  unsigned int receiver_count = 0;
+  unsigned int other_count = 0;
+  receiver.SetOnData(ola::NewCallback(this, &SocketTest::UDPReceive,
+                                      &receiver, &receiver_count));
+  other.SetOnData(ola::NewCallback(this, &SocketTest::UDPReceive,
+                                   &other, &other_count));
+  OLA_ASSERT_TRUE(m_ss->AddReadDescriptor(&receiver));
+  OLA_ASSERT_TRUE(m_ss->AddReadDescriptor(&other));
+
+  UDPSocket sender;
+  OLA_ASSERT_TRUE(sender.Init());
+  OLA_ASSERT_TRUE(sender.SetMulticastInterface(iface.ip_address));
+  OLA_ASSERT_EQ(
+      static_cast<ssize_t>(sizeof(test_cstring)),
+      sender.SendTo(static_cast<const uint8_t*>(test_cstring),
+                    sizeof(test_cstring),
+                    IPV4SocketAddress(group, local_address.Port())));
+  for (unsigned int i = 0; i < 10 && !other_count; i++) {
+    m_ss->RunOnce(TimeInterval(0, 50000));
+  }
+
+  if (other_count) {
+    OLA_ASSERT_EQ(1u, other_count);
+    OLA_ASSERT_EQ(0u, receiver_count);
+
+    // Once the receiver joins the group itself, it gets the data.
+    OLA_ASSERT_TRUE(receiver.JoinMulticast(iface.ip_address, group));
+    sender.SendTo(static_cast<const uint8_t*>(test_cstring),
+                  sizeof(test_cstring),
+                  IPV4SocketAddress(group, local_address.Port()));
+    for (unsigned int i = 0; i < 10 && !receiver_count; i++) {
+      m_ss->RunOnce(TimeInterval(0, 50000));
+    }
+    OLA_ASSERT_EQ(1u, receiver_count);
+  } else {
+    OLA_INFO << "Multicast isn't looped back on " << iface.name
+             << ", skipping multicast test";
+  }
+  m_ss->RemoveReadDescriptor(&receiver);
+  m_ss->RemoveReadDescriptor(&other);
+}
+
+
 /*
  * Receive some data and close the socket
  */
@@ -390,6 +526,35 @@ void SocketTest::UDPReceiveAndTerminate(UDPSocket *socket) {
 }
 
 
+/*
+ * Receive some data, check it and terminate once both sockets have data.
+ */
+void SocketTest::UDPReceiveAndCount(UDPSocket *socket) {
+  IPV4SocketAddress source;
+  uint8_t buffer[sizeof(test_cstring) + 10];
+  ssize_t data_read = sizeof(buffer);
+  socket->RecvFrom(buffer, &data_read, &source);
+  OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(test_cstring)), data_read);
+  OLA_ASSERT_DATA_EQUALS(test_cstring, sizeof(test_cstring), buffer,
+                         static_cast<unsigned int>(data_read));
+  if (++m_udp_received == 2) {
+    m_ss->Terminate();
+  }
+}
+
+
+/*
+ * Receive some data and count it.
+ */
+void SocketTest::UDPReceive(UDPSocket *socket, unsigned int *count) {
+  uint8_t buffer[sizeof(test_cstring) + 10];
+  ssize_t data_read = sizeof(buffer);
+  socket->RecvFrom(buffer, &data_read);
+  OLA_ASSERT_EQ(static_cast<ssize_t>(sizeof(test_cstring)), data_read);
+  (*count)++;
+}
+
+
 /*
  * Receive some data and echo it back.
  */
@@ -77,6 +77,14 @@ void DiscoveryAgent::StartIncrementalDiscovery(
   InitDiscovery(on_complete, true);
 }
 
+void DiscoveryAgent::SetKnownUIDs(const UIDSet &uids) {
+  if (m_on_complete) {
+    OLA_WARN << "Discovery procedure running, ignoring known UIDs";
+    return;
+  }
+  m_uids = uids;
+}
+
 /*
  * Start the discovery process
  * @param on_complete the callback to run when discovery completes
@@ -387,9 +395,10 @@ void DiscoveryAgent::HandleCollision() {
            << " , " << mid_plus_one_uid << " - " << upper_uid;
 
   range->uids_discovered = 0;
-  // add both ranges to the stack
-  m_uid_ranges.push(new UIDRange(lower_uid, mid_uid, range));
+  // add both ranges to the stack, the lower one last so the tree is walked
+  // in UID order and the UIDs can be appended to m_uids.
   m_uid_ranges.push(new UIDRange(mid_plus_one_uid, upper_uid, range));
+  m_uid_ranges.push(new UIDRange(lower_uid, mid_uid, range));
   SendDiscovery();
 }
 
@@ -419,16 +428,16 @@ void DiscoveryAgent::SplitAroundBadUID(UID bad_uid) {
   UID mid_plus_one_uid(bad_uid.ToUInt64() + 1);
 
   range->uids_discovered = 0;
-  if (mid_minus_one_uid >= lower_uid) {
-    OLA_INFO << "Splitting either side of " << bad_uid << ", adding "
-             << lower_uid << " - " << mid_minus_one_uid;
-    m_uid_ranges.push(new UIDRange(lower_uid, mid_minus_one_uid, range));
-  }
   if (mid_plus_one_uid <= upper_uid) {
     OLA_INFO << "Splitting either side of " << bad_uid << ", adding "
              << mid_plus_one_uid << " - " << upper_uid;
     m_uid_ranges.push(new UIDRange(mid_plus_one_uid, upper_uid, range));
   }
+  if (mid_minus_one_uid >= lower_uid) {
+    OLA_INFO << "Splitting either side of " << bad_uid << ", adding "
+             << lower_uid << " - " << mid_minus_one_uid;
+    m_uid_ranges.push(new UIDRange(lower_uid, mid_minus_one_uid, range));
+  }
   SendDiscovery();
 }
 
@@ -51,6 +51,7 @@ class DiscoveryAgentTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testNonMutingResponder);
   CPPUNIT_TEST(testFlakeyResponder);
   CPPUNIT_TEST(testProxy);
+  CPPUNIT_TEST(testKnownUIDs);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -69,6 +70,7 @@ class DiscoveryAgentTest: public CppUnit::TestFixture {
     void testNonMutingResponder();
     void testFlakeyResponder();
     void testProxy();
+    void testKnownUIDs();
 
  private:
     bool m_callback_run;
@@ -479,3 +481,47 @@ void DiscoveryAgentTest::testProxy() {
   OLA_ASSERT_TRUE(m_callback_run);
   m_callback_run = false;
 }
+
+
+/*
+ * Test that seeding the agent with known UIDs avoids the branch search.
+ */
+void DiscoveryAgentTest::testKnownUIDs() {
+  UIDSet uids;
+  ResponderList responders;
+  uids.AddUID(UID(1, 10));
+  uids.AddUID(UID(3, 10));
+  uids.AddUID(UID(3, 20));
+  uids.AddUID(UID(0x7a70, 0x00002001));
+  PopulateResponderListFromUIDs(uids, &responders);
+  MockDiscoveryTarget target(responders);
+  DiscoveryAgent agent(&target);
+
+  // seed with the known UIDs, plus one that has since been removed
+  UIDSet known_uids = uids;
+  known_uids.AddUID(UID(5, 10));
+  agent.SetKnownUIDs(known_uids);
+
+  agent.StartIncrementalDiscovery(
+      ola::NewSingleCallback(this,
+                             &DiscoveryAgentTest::DiscoverySuccessful,
+                             static_cast<const UIDSet*>(&uids)));
+  OLA_ASSERT_TRUE(m_callback_run);
+  m_callback_run = false;
+  // every responder was muted, so a single DUB is all that was needed.
+  OLA_ASSERT_EQ(1u, target.BranchCallCount());
+
+  // now add a responder which isn't in the known set
+  target.ResetCounters();
+  UID new_uid(0x7a70, 0x00002002);
+  uids.AddUID(new_uid);
+  target.AddResponder(new MockResponder(new_uid));
+  agent.SetKnownUIDs(known_uids);
+  agent.StartIncrementalDiscovery(
+      ola::NewSingleCallback(this,
+                             &DiscoveryAgentTest::DiscoverySuccessful,
+                             static_cast<const UIDSet*>(&uids)));
+  OLA_ASSERT_TRUE(m_callback_run);
+  m_callback_run = false;
+  OLA_ASSERT_TRUE(target.BranchCallCount() > 1);
+}
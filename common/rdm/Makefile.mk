@@ -31,6 +31,7 @@ common_libolacommon_la_SOURCES += \
     common/rdm/PidStoreHelper.cpp \
     common/rdm/PidStoreLoader.cpp \
     common/rdm/PidStoreLoader.h \
+    common/rdm/PipeliningRDMController.cpp \
     common/rdm/QueueingRDMController.cpp \
     common/rdm/RDMAPI.cpp \
     common/rdm/RDMCommand.cpp \
@@ -58,6 +59,19 @@ EXTRA_DIST += common/rdm/Pids.proto
 common/rdm/Pids.pb.cc common/rdm/Pids.pb.h: common/rdm/Makefile.mk common/rdm/Pids.proto
 	$(PROTOC) --cpp_out $(top_builddir)/common/rdm --proto_path $(srcdir)/common/rdm $(srcdir)/common/rdm/Pids.proto
 
+# PROGRAMS
+##################################################
+noinst_PROGRAMS += \
+    common/rdm/responder_ops_benchmark \
+    common/rdm/uid_map_benchmark
+
+common_rdm_responder_ops_benchmark_SOURCES = \
+    common/rdm/responder_ops_benchmark.cpp
+common_rdm_responder_ops_benchmark_LDADD = common/libolacommon.la
+
+common_rdm_uid_map_benchmark_SOURCES = common/rdm/uid_map_benchmark.cpp
+common_rdm_uid_map_benchmark_LDADD = common/libolacommon.la
+
 # TESTS_DATA
 ##################################################
 
@@ -78,6 +92,7 @@ EXTRA_DIST += \
 test_programs += \
     common/rdm/DiscoveryAgentTester \
     common/rdm/PidStoreTester \
+    common/rdm/PipeliningRDMControllerTester \
     common/rdm/QueueingRDMControllerTester \
     common/rdm/RDMAPITester \
     common/rdm/RDMCommandSerializerTester \
@@ -86,6 +101,7 @@ test_programs += \
     common/rdm/RDMHelperTester \
     common/rdm/RDMMessageTester \
     common/rdm/RDMReplyTester \
+    common/rdm/ResponderOpsTester \
     common/rdm/UIDAllocatorTester \
     common/rdm/UIDTester
 
@@ -136,6 +152,11 @@ common_rdm_RDMReplyTester_SOURCES = \
 common_rdm_RDMReplyTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_rdm_RDMReplyTester_LDADD = $(COMMON_TESTING_LIBS)
 
+common_rdm_ResponderOpsTester_SOURCES = \
+    common/rdm/ResponderOpsTest.cpp
+common_rdm_ResponderOpsTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_rdm_ResponderOpsTester_LDADD = $(COMMON_TESTING_LIBS)
+
 common_rdm_RDMCommandSerializerTester_SOURCES = \
     common/rdm/RDMCommandSerializerTest.cpp \
     common/rdm/TestHelper.h
@@ -148,12 +169,18 @@ common_rdm_QueueingRDMControllerTester_SOURCES = \
 common_rdm_QueueingRDMControllerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_rdm_QueueingRDMControllerTester_LDADD = $(COMMON_TESTING_LIBS)
 
+common_rdm_PipeliningRDMControllerTester_SOURCES = \
+    common/rdm/PipeliningRDMControllerTest.cpp
+common_rdm_PipeliningRDMControllerTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+common_rdm_PipeliningRDMControllerTester_LDADD = $(COMMON_TESTING_LIBS)
+
 common_rdm_UIDAllocatorTester_SOURCES = \
     common/rdm/UIDAllocatorTest.cpp
 common_rdm_UIDAllocatorTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_rdm_UIDAllocatorTester_LDADD = $(COMMON_TESTING_LIBS)
 
 common_rdm_UIDTester_SOURCES = \
+    common/rdm/UIDMapTest.cpp \
     common/rdm/UIDTest.cpp
 common_rdm_UIDTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
 common_rdm_UIDTester_LDADD = $(COMMON_TESTING_LIBS)
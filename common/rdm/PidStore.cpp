@@ -18,6 +18,11 @@
  * Copyright (C) 2011 Simon Newton
  */
 
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -26,23 +31,69 @@
 #include "ola/rdm/PidStore.h"
 #include "ola/rdm/RDMEnums.h"
 #include "ola/stl/STLUtils.h"
+#include "ola/thread/Mutex.h"
+
+#include HASH_MAP_H
+
+#ifndef HAVE_UNORDERED_MAP
+// This adds support for hashing strings if it's not present
+namespace HASH_NAMESPACE {
+
+template<> struct hash<std::string> {
+  size_t operator()(const std::string& x) const {
+    return hash<const char*>()(x.c_str());
+  }
+};
+}  // namespace HASH_NAMESPACE
+#endif  // HAVE_UNORDERED_MAP
 
 namespace ola {
 namespace rdm {
 
+using ola::thread::MutexLocker;
 using std::string;
 using std::vector;
 
+namespace {
+bool OrderByValue(const PidDescriptor *a, const PidDescriptor *b) {
+  return a->Value() < b->Value();
+}
+}  // namespace
+
+/**
+ * @brief The hashed PID & name indices for a PidStore.
+ */
+class PidStore::PidIndex {
+ public:
+  typedef HASH_NAMESPACE::HASH_MAP_CLASS<uint16_t, const PidDescriptor*>
+      PidMap;
+  typedef HASH_NAMESPACE::HASH_MAP_CLASS<string, const PidDescriptor*>
+      PidNameMap;
+
+  PidMap pid_by_value;
+  PidNameMap pid_by_name;
+};
+
 RootPidStore::~RootPidStore() {
   m_esta_store.reset();
   STLDeleteValues(&m_manufacturer_store);
 }
 
 const PidStore *RootPidStore::ManufacturerStore(uint16_t esta_id) const {
+  MutexLocker lock(&m_manufacturer_mutex);
   ManufacturerMap::const_iterator iter = m_manufacturer_store.find(esta_id);
-  if (iter == m_manufacturer_store.end())
+  if (iter != m_manufacturer_store.end()) {
+    return iter->second;
+  }
+
+  if (!m_manufacturer_builder.get()) {
     return NULL;
-  return iter->second;
+  }
+
+  // Remember misses as well, so we only try to build each store once.
+  const PidStore *store = m_manufacturer_builder->BuildStore(esta_id);
+  m_manufacturer_store[esta_id] = store;
+  return store;
 }
 
 const PidDescriptor *RootPidStore::GetDescriptor(
@@ -128,26 +179,29 @@ const string RootPidStore::DataLocation() {
   return PID_DATA_DIR;
 }
 
-PidStore::PidStore(const vector<const PidDescriptor*> &pids) {
-  vector<const PidDescriptor*>::const_iterator iter = pids.begin();
-  for (; iter != pids.end(); ++iter) {
-    m_pid_by_value[(*iter)->Value()] = *iter;
-    m_pid_by_name[(*iter)->Name()] = *iter;
+bool RootPidStore::PrecompileDirectory(const string &directory,
+                                       const string &output_file) {
+  PidStoreLoader loader;
+  return loader.PrecompileDirectory(directory, output_file);
+}
+
+PidStore::PidStore(const vector<const PidDescriptor*> &pids)
+    : m_pids(pids),
+      m_index(new PidIndex()) {
+  std::sort(m_pids.begin(), m_pids.end(), OrderByValue);
+  vector<const PidDescriptor*>::const_iterator iter = m_pids.begin();
+  for (; iter != m_pids.end(); ++iter) {
+    m_index->pid_by_value[(*iter)->Value()] = *iter;
+    m_index->pid_by_name[(*iter)->Name()] = *iter;
   }
 }
 
 PidStore::~PidStore() {
-  STLDeleteValues(&m_pid_by_value);
-  m_pid_by_name.clear();
+  STLDeleteElements(&m_pids);
 }
 
 void PidStore::AllPids(vector<const PidDescriptor*> *pids) const {
-  pids->reserve(pids->size() + m_pid_by_value.size());
-
-  PidMap::const_iterator iter = m_pid_by_value.begin();
-  for (; iter != m_pid_by_value.end(); ++iter) {
-    pids->push_back(iter->second);
-  }
+  pids->insert(pids->end(), m_pids.begin(), m_pids.end());
 }
 
 
@@ -167,11 +221,7 @@ PidDescriptor::~PidDescriptor() {
  * @param pid_value the 16 bit pid value.
  */
 const PidDescriptor *PidStore::LookupPID(uint16_t pid_value) const {
-  PidMap::const_iterator iter = m_pid_by_value.find(pid_value);
-  if (iter == m_pid_by_value.end())
-    return NULL;
-  else
-    return iter->second;
+  return STLFindOrNull(m_index->pid_by_value, pid_value);
 }
 
 
@@ -180,11 +230,7 @@ const PidDescriptor *PidStore::LookupPID(uint16_t pid_value) const {
  * @param pid_name the name of the pid.
  */
 const PidDescriptor *PidStore::LookupPID(const string &pid_name) const {
-  PidNameMap::const_iterator iter = m_pid_by_name.find(pid_name);
-  if (iter == m_pid_by_name.end())
-    return NULL;
-  else
-    return iter->second;
+  return STLFindOrNull(m_index->pid_by_name, pid_name);
 }
 
 
@@ -19,8 +19,10 @@
  */
 
 #include <errno.h>
+#include <stdint.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/text_format.h>
+#include <algorithm>
 #include <fstream>
 #include <set>
 #include <sstream>
@@ -52,10 +54,28 @@ using std::vector;
 const char PidStoreLoader::OVERRIDE_FILE_NAME[] = "overrides.proto";
 const char PidStoreLoader::MANUFACTURER_NAMES_FILE_NAME[] =
     "manufacturer_names.proto";
+const char PidStoreLoader::PRECOMPILED_FILE_NAME[] = "pids.pb";
 const uint16_t PidStoreLoader::ESTA_MANUFACTURER_ID = 0;
 const uint16_t PidStoreLoader::MANUFACTURER_PID_MIN = 0x8000;
 const uint16_t PidStoreLoader::MANUFACTURER_PID_MAX = 0xffe0;
 
+namespace {
+// 64 bit FNV-1a, which is stable across platforms and builds.
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+void HashBytes(const char *data, size_t length, uint64_t *hash) {
+  for (size_t i = 0; i < length; i++) {
+    *hash ^= static_cast<uint8_t>(data[i]);
+    *hash *= FNV_PRIME;
+  }
+}
+
+bool FilenameLessThan(const string &a, const string &b) {
+  return ola::file::FilenameFromPath(a) < ola::file::FilenameFromPath(b);
+}
+}  // namespace
+
 const RootPidStore *PidStoreLoader::LoadFromFile(const string &file,
                                                  bool validate) {
   std::ifstream proto_file(file.data());
@@ -74,57 +94,41 @@ const RootPidStore *PidStoreLoader::LoadFromDirectory(
     const string &directory,
     bool validate) {
   vector<string> files;
-
   string override_file;
   string manufacturer_names_file;
-  vector<string> all_files;
-  if (!ola::file::ListDirectory(directory, &all_files)) {
-    OLA_WARN << "Failed to list files in " << directory;
-    return NULL;
-  }
-  if (all_files.empty()) {
-    OLA_WARN << "Didn't find any files in " << directory;
-    return NULL;
-  }
-  vector<string>::const_iterator file_iter = all_files.begin();
-  for (; file_iter != all_files.end(); ++file_iter) {
-    if (ola::file::FilenameFromPath(*file_iter) == OVERRIDE_FILE_NAME) {
-      override_file = *file_iter;
-    } else if (ola::file::FilenameFromPath(*file_iter) ==
-               MANUFACTURER_NAMES_FILE_NAME) {
-      manufacturer_names_file = *file_iter;
-    } else if (StringEndsWith(*file_iter, ".proto")) {
-      files.push_back(*file_iter);
-    }
-  }
-  if (files.empty() && override_file.empty()) {
-    OLA_WARN << "Didn't find any files to load in " << directory;
+  string precompiled_file;
+  if (!ListDataFiles(directory, &files, &override_file,
+                     &manufacturer_names_file, &precompiled_file)) {
     return NULL;
   }
 
-  ola::rdm::pid::PidStore pid_store_pb;
-  vector<string>::const_iterator iter = files.begin();
-  for (; iter != files.end(); ++iter) {
-    std::ifstream proto_file(iter->data());
-    if (!proto_file.is_open()) {
-      OLA_WARN << "Failed to open " << *iter << ": " << strerror(errno);
+  auto_ptr<ola::rdm::pid::PidStore> pid_store_pb(
+      new ola::rdm::pid::PidStore());
+  bool loaded_precompiled_file = false;
+  if (!precompiled_file.empty()) {
+    if (!ReadPrecompiledFile(precompiled_file, pid_store_pb.get())) {
       return NULL;
     }
+    loaded_precompiled_file = PrecompiledFileIsCurrent(
+        *pid_store_pb, precompiled_file, files);
+    if (!loaded_precompiled_file) {
+      pid_store_pb->Clear();
+    }
+  }
 
-    google::protobuf::io::IstreamInputStream input_stream(&proto_file);
-    bool ok = google::protobuf::TextFormat::Merge(&input_stream,
-                                                  &pid_store_pb);
-    proto_file.close();
-
-    if (!ok) {
-      OLA_WARN << "Failed to load " << *iter;
-      return NULL;
+  if (!loaded_precompiled_file) {
+    vector<string>::const_iterator iter = files.begin();
+    for (; iter != files.end(); ++iter) {
+      if (!ReadFile(*iter, pid_store_pb.get())) {
+        return NULL;
+      }
     }
   }
 
-  ola::rdm::pid::PidStore override_pb;
+  auto_ptr<ola::rdm::pid::PidStore> override_pb(
+      new ola::rdm::pid::PidStore());
   if (!override_file.empty()) {
-    if (!ReadFile(override_file, &override_pb)) {
+    if (!ReadFile(override_file, override_pb.get())) {
       return NULL;
     }
   }
@@ -136,7 +140,8 @@ const RootPidStore *PidStoreLoader::LoadFromDirectory(
     }
   }
 
-  return BuildStore(pid_store_pb, override_pb, manufacturer_names_pb, validate);
+  return BuildLazyStore(pid_store_pb.release(), override_pb.release(),
+                        manufacturer_names_pb, validate);
 }
 
 const RootPidStore *PidStoreLoader::LoadFromStream(std::istream *data,
@@ -152,6 +157,191 @@ const RootPidStore *PidStoreLoader::LoadFromStream(std::istream *data,
   return BuildStore(pid_store_pb, override_pb, validate);
 }
 
+bool PidStoreLoader::PrecompileDirectory(const string &directory,
+                                         const string &output_file) {
+  vector<string> files;
+  string override_file;
+  string manufacturer_names_file;
+  string precompiled_file;
+  if (!ListDataFiles(directory, &files, &override_file,
+                     &manufacturer_names_file, &precompiled_file)) {
+    return false;
+  }
+
+  ola::rdm::pid::PidStore pid_store_pb;
+  vector<string>::const_iterator iter = files.begin();
+  for (; iter != files.end(); ++iter) {
+    if (!ReadFile(*iter, &pid_store_pb)) {
+      return false;
+    }
+  }
+
+  // Check the data is valid before writing it out, since we'll skip
+  // validation of the manufacturer PIDs until they're used.
+  ola::rdm::pid::PidStore override_pb;
+  auto_ptr<const RootPidStore> store(
+      BuildStore(pid_store_pb, override_pb, true));
+  if (!store.get()) {
+    return false;
+  }
+
+  uint64_t source_hash;
+  if (!HashDataFiles(files, &source_hash)) {
+    return false;
+  }
+  pid_store_pb.set_source_hash(source_hash);
+
+  std::ofstream output(output_file.c_str(),
+                       std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!output.is_open()) {
+    OLA_WARN << "Failed to open " << output_file << ": " << strerror(errno);
+    return false;
+  }
+
+  bool ok = pid_store_pb.SerializeToOstream(&output);
+  output.close();
+  if (!ok) {
+    OLA_WARN << "Failed to write " << output_file;
+  }
+  return ok;
+}
+
+const PidStore *PidStoreLoader::BuildManufacturerStore(
+    const ola::rdm::pid::Manufacturer *override_pb,
+    const ola::rdm::pid::Manufacturer *manufacturer_pb,
+    bool validate) {
+  // Load the overrides first so they get first dibs on each PID.
+  PidMap pid_map;
+  if ((override_pb && !GetPidList(&pid_map, *override_pb, validate, false)) ||
+      (manufacturer_pb &&
+       !GetPidList(&pid_map, *manufacturer_pb, validate, false))) {
+    STLDeleteValues(&pid_map);
+    return NULL;
+  }
+
+  // Ownership of the Descriptors is transferred to the vector
+  vector<const PidDescriptor*> pids;
+  STLValues(pid_map, &pids);
+  return new PidStore(pids);
+}
+
+/*
+ * Find the PID data files in a directory.
+ */
+bool PidStoreLoader::ListDataFiles(const string &directory,
+                                   vector<string> *files,
+                                   string *override_file,
+                                   string *manufacturer_names_file,
+                                   string *precompiled_file) {
+  vector<string> all_files;
+  if (!ola::file::ListDirectory(directory, &all_files)) {
+    OLA_WARN << "Failed to list files in " << directory;
+    return false;
+  }
+  if (all_files.empty()) {
+    OLA_WARN << "Didn't find any files in " << directory;
+    return false;
+  }
+  vector<string>::const_iterator file_iter = all_files.begin();
+  for (; file_iter != all_files.end(); ++file_iter) {
+    const string file_name = ola::file::FilenameFromPath(*file_iter);
+    if (file_name == OVERRIDE_FILE_NAME) {
+      *override_file = *file_iter;
+    } else if (file_name == MANUFACTURER_NAMES_FILE_NAME) {
+      *manufacturer_names_file = *file_iter;
+    } else if (file_name == PRECOMPILED_FILE_NAME) {
+      *precompiled_file = *file_iter;
+    } else if (StringEndsWith(*file_iter, ".proto")) {
+      files->push_back(*file_iter);
+    }
+  }
+  if (files->empty() && override_file->empty() &&
+      precompiled_file->empty()) {
+    OLA_WARN << "Didn't find any files to load in " << directory;
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Check that the precompiled data was built from the text format files in the
+ * directory. Changing, adding or removing any of them invalidates it. If there
+ * are no text format files, only the precompiled data was installed, so we use
+ * it as is.
+ */
+bool PidStoreLoader::PrecompiledFileIsCurrent(
+    const ola::rdm::pid::PidStore &precompiled_pb,
+    const string &precompiled_file,
+    const vector<string> &files) {
+  if (files.empty()) {
+    return true;
+  }
+
+  uint64_t source_hash;
+  if (!precompiled_pb.has_source_hash() ||
+      !HashDataFiles(files, &source_hash) ||
+      source_hash != precompiled_pb.source_hash()) {
+    OLA_INFO << precompiled_file << " doesn't match the text format files, "
+             << "loading them instead";
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Hash the names and contents of the text format files. The files are hashed
+ * in name order, so the result doesn't depend on the directory order.
+ */
+bool PidStoreLoader::HashDataFiles(const vector<string> &files,
+                                   uint64_t *hash) {
+  vector<string> sorted_files(files);
+  std::sort(sorted_files.begin(), sorted_files.end(), FilenameLessThan);
+
+  *hash = FNV_OFFSET_BASIS;
+  char buffer[4096];
+  vector<string>::const_iterator iter = sorted_files.begin();
+  for (; iter != sorted_files.end(); ++iter) {
+    std::ifstream data_file(iter->c_str(), std::ios::in | std::ios::binary);
+    if (!data_file.is_open()) {
+      OLA_WARN << "Failed to open " << *iter << ": " << strerror(errno);
+      return false;
+    }
+
+    // Include the name, so renaming or removing a file changes the hash.
+    const string file_name = ola::file::FilenameFromPath(*iter);
+    HashBytes(file_name.c_str(), file_name.size() + 1, hash);
+    uint64_t size = 0;
+    while (data_file.read(buffer, sizeof(buffer)) || data_file.gcount()) {
+      HashBytes(buffer, data_file.gcount(), hash);
+      size += data_file.gcount();
+    }
+    data_file.close();
+    for (unsigned int i = 0; i < sizeof(size); i++) {
+      const char size_byte = static_cast<char>(size >> (8 * i));
+      HashBytes(&size_byte, 1, hash);
+    }
+  }
+  return true;
+}
+
+bool PidStoreLoader::ReadPrecompiledFile(const string &file_path,
+                                         ola::rdm::pid::PidStore *proto) {
+  std::ifstream proto_file(file_path.c_str(),
+                           std::ios::in | std::ios::binary);
+  if (!proto_file.is_open()) {
+    OLA_WARN << "Failed to open " << file_path << ": " << strerror(errno);
+    return false;
+  }
+
+  bool ok = proto->ParseFromIstream(&proto_file);
+  proto_file.close();
+
+  if (!ok) {
+    OLA_WARN << "Failed to load " << file_path;
+  }
+  return ok;
+}
+
 bool PidStoreLoader::ReadFile(const std::string &file_path,
                               ola::rdm::pid::PidStore *proto) {
   std::ifstream proto_file(file_path.c_str());
@@ -224,6 +414,64 @@ const RootPidStore *PidStoreLoader::BuildStore(
                           store_pb.version());
 }
 
+/*
+ * Build a RootPidStore where the manufacturer PidStores are built on first
+ * use. Takes ownership of store_pb & override_pb.
+ */
+const RootPidStore *PidStoreLoader::BuildLazyStore(
+    ola::rdm::pid::PidStore *store_pb,
+    ola::rdm::pid::PidStore *override_pb,
+    const ola::rdm::pid::PidStore &manufacturer_names_pb,
+    bool validate) {
+  auto_ptr<ola::rdm::pid::PidStore> store(store_pb);
+  auto_ptr<ola::rdm::pid::PidStore> overrides(override_pb);
+
+  if (!CheckManufacturerIds(*overrides) || !CheckManufacturerIds(*store) ||
+      !CheckManufacturerIds(manufacturer_names_pb)) {
+    return NULL;
+  }
+
+  // Load the overrides first so they get first dibs on each PID.
+  PidMap esta_pids;
+  if (!GetPidList(&esta_pids, *overrides, validate, true) ||
+      !GetPidList(&esta_pids, *store, validate, true)) {
+    STLDeleteValues(&esta_pids);
+    return NULL;
+  }
+
+  // Ownership of the Descriptors is transferred to the vector
+  vector<const PidDescriptor*> pids;
+  STLValues(esta_pids, &pids);
+  const PidStore *esta_store = new PidStore(pids);
+
+  uint64_t version = store->version();
+  OLA_DEBUG << "Load Complete, manufacturer PIDs will be loaded on demand";
+  return new RootPidStore(
+      esta_store,
+      new ProtoManufacturerStoreBuilder(store.release(), overrides.release(),
+                                        validate),
+      version);
+}
+
+/*
+ * @brief Check that each manufacturer is only listed once.
+ */
+bool PidStoreLoader::CheckManufacturerIds(
+    const ola::rdm::pid::PidStore &proto) {
+  set<uint16_t> seen_manufacturer_ids;
+  for (int i = 0; i < proto.manufacturer_size(); ++i) {
+    const ola::rdm::pid::Manufacturer &manufacturer = proto.manufacturer(i);
+    if (!seen_manufacturer_ids.insert(
+          manufacturer.manufacturer_id()).second) {
+      OLA_WARN << "Manufacturer id " << manufacturer.manufacturer_id() <<
+          "(" << manufacturer.manufacturer_name() <<
+          ") listed more than once in the PIDs file";
+      return false;
+    }
+  }
+  return true;
+}
+
 /*
  * @brief Load the data from the PidStore proto into the ManufacturerMap.
  * @param[out] pid_data the ManufacturerMap to populate.
@@ -616,5 +864,44 @@ void PidStoreLoader::FreeManufacturerMap(ManufacturerMap *data) {
   }
   data->clear();
 }
+
+ProtoManufacturerStoreBuilder::ProtoManufacturerStoreBuilder(
+    ola::rdm::pid::PidStore *store_pb,
+    ola::rdm::pid::PidStore *override_pb,
+    bool validate)
+    : m_store_pb(store_pb),
+      m_override_pb(override_pb),
+      m_validate(validate) {
+  IndexManufacturers(*m_store_pb, &m_manufacturers);
+  IndexManufacturers(*m_override_pb, &m_override_manufacturers);
+}
+
+const PidStore *ProtoManufacturerStoreBuilder::BuildStore(uint16_t esta_id) {
+  const ola::rdm::pid::Manufacturer *override_pb = STLFindOrNull(
+      m_override_manufacturers, esta_id);
+  const ola::rdm::pid::Manufacturer *manufacturer_pb = STLFindOrNull(
+      m_manufacturers, esta_id);
+  if (!override_pb && !manufacturer_pb) {
+    return NULL;
+  }
+
+  OLA_DEBUG << "Loading PIDs for manufacturer " << strings::ToHex(esta_id);
+  const PidStore *store = m_loader.BuildManufacturerStore(
+      override_pb, manufacturer_pb, m_validate);
+  if (!store) {
+    OLA_WARN << "Failed to load the PIDs for manufacturer "
+             << strings::ToHex(esta_id);
+  }
+  return store;
+}
+
+void ProtoManufacturerStoreBuilder::IndexManufacturers(
+    const ola::rdm::pid::PidStore &store_pb,
+    ManufacturerIndex *index) {
+  for (int i = 0; i < store_pb.manufacturer_size(); ++i) {
+    const ola::rdm::pid::Manufacturer &manufacturer = store_pb.manufacturer(i);
+    (*index)[manufacturer.manufacturer_id()] = &manufacturer;
+  }
+}
 }  // namespace rdm
 }  // namespace ola
@@ -27,6 +27,7 @@
 #include <ola/rdm/PidStore.h>
 #include <map>
 #include <istream>
+#include <memory>
 #include <string>
 #include <vector>
 #include "common/rdm/DescriptorConsistencyChecker.h"
@@ -74,15 +75,59 @@ class PidStoreLoader {
   const RootPidStore *LoadFromStream(std::istream *data,
                                      bool validate = true);
 
+  /**
+   * @brief Write the PID data in a directory out in the precompiled format.
+   * @param directory the directory to load files from.
+   * @param output_file the file to write the binary data to.
+   * @returns true if the data was valid and written, false otherwise.
+   */
+  bool PrecompileDirectory(const std::string &directory,
+                           const std::string &output_file);
+
+  /**
+   * @brief Build the PidStore for a single manufacturer.
+   * @param override_pb the manufacturer's entry from the overrides, may be
+   *   NULL.
+   * @param manufacturer_pb the manufacturer's entry from the PID data, may
+   *   be NULL.
+   * @param validate set to true if we should perform validation of the
+   *   contents.
+   * @returns A new PidStore or NULL if the data was invalid.
+   */
+  const PidStore *BuildManufacturerStore(
+      const ola::rdm::pid::Manufacturer *override_pb,
+      const ola::rdm::pid::Manufacturer *manufacturer_pb,
+      bool validate);
+
+  static const char PRECOMPILED_FILE_NAME[];
+
  private:
   typedef std::map<uint16_t, const PidDescriptor*> PidMap;
   typedef std::map<uint16_t, PidMap*> ManufacturerMap;
 
   DescriptorConsistencyChecker m_checker;
 
+  bool ListDataFiles(const std::string &directory,
+                     std::vector<std::string> *files,
+                     std::string *override_file,
+                     std::string *manufacturer_names_file,
+                     std::string *precompiled_file);
+  bool PrecompiledFileIsCurrent(const ola::rdm::pid::PidStore &precompiled_pb,
+                                const std::string &precompiled_file,
+                                const std::vector<std::string> &files);
+  bool HashDataFiles(const std::vector<std::string> &files, uint64_t *hash);
+  bool ReadPrecompiledFile(const std::string &file_path,
+                           ola::rdm::pid::PidStore *proto);
   bool ReadFile(const std::string &file_path,
                 ola::rdm::pid::PidStore *proto);
 
+  const RootPidStore *BuildLazyStore(
+      ola::rdm::pid::PidStore *store_pb,
+      ola::rdm::pid::PidStore *override_pb,
+      const ola::rdm::pid::PidStore &manufacturer_names_pb,
+      bool validate);
+  bool CheckManufacturerIds(const ola::rdm::pid::PidStore &proto);
+
   const RootPidStore *BuildStore(
       const ola::rdm::pid::PidStore &store_pb,
       const ola::rdm::pid::PidStore &override_pb,
@@ -136,6 +181,43 @@ class PidStoreLoader {
 
   DISALLOW_COPY_AND_ASSIGN(PidStoreLoader);
 };
+
+
+/**
+ * @brief Builds the manufacturer PidStores from the protobuf data on first
+ * use.
+ */
+class ProtoManufacturerStoreBuilder: public ManufacturerStoreBuilder {
+ public:
+  /**
+   * @brief Create a new ProtoManufacturerStoreBuilder.
+   * @param store_pb the PID data, ownership is transferred.
+   * @param override_pb the overrides, ownership is transferred.
+   * @param validate set to true if we should perform validation of the
+   *   contents.
+   */
+  ProtoManufacturerStoreBuilder(ola::rdm::pid::PidStore *store_pb,
+                                ola::rdm::pid::PidStore *override_pb,
+                                bool validate);
+
+  const PidStore *BuildStore(uint16_t esta_id);
+
+ private:
+  typedef std::map<uint16_t, const ola::rdm::pid::Manufacturer*>
+      ManufacturerIndex;
+
+  std::auto_ptr<ola::rdm::pid::PidStore> m_store_pb;
+  std::auto_ptr<ola::rdm::pid::PidStore> m_override_pb;
+  ManufacturerIndex m_manufacturers;
+  ManufacturerIndex m_override_manufacturers;
+  const bool m_validate;
+  PidStoreLoader m_loader;
+
+  static void IndexManufacturers(const ola::rdm::pid::PidStore &store_pb,
+                                 ManufacturerIndex *index);
+
+  DISALLOW_COPY_AND_ASSIGN(ProtoManufacturerStoreBuilder);
+};
 }  // namespace rdm
 }  // namespace ola
 #endif  // COMMON_RDM_PIDSTORELOADER_H_
@@ -19,7 +19,12 @@
  */
 
 #include <cppunit/extensions/HelperMacros.h>
+#include <errno.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <fstream>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -56,6 +61,8 @@ class PidStoreTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testPidStoreLoad);
   CPPUNIT_TEST(testPidStoreFileLoad);
   CPPUNIT_TEST(testPidStoreDirectoryLoad);
+  CPPUNIT_TEST(testPidStorePrecompiledLoad);
+  CPPUNIT_TEST(testPidStorePrecompiledStale);
   CPPUNIT_TEST(testPidStoreLoadMissingFile);
   CPPUNIT_TEST(testPidStoreLoadDuplicateManufacturer);
   CPPUNIT_TEST(testPidStoreLoadDuplicateValue);
@@ -70,6 +77,8 @@ class PidStoreTest: public CppUnit::TestFixture {
   void testPidStoreLoad();
   void testPidStoreFileLoad();
   void testPidStoreDirectoryLoad();
+  void testPidStorePrecompiledLoad();
+  void testPidStorePrecompiledStale();
   void testPidStoreLoadMissingFile();
   void testPidStoreLoadDuplicateManufacturer();
   void testPidStoreLoadDuplicateValue();
@@ -84,6 +93,15 @@ class PidStoreTest: public CppUnit::TestFixture {
     path.append(filename);
     return path;
   }
+
+  void CopyFile(const string &source, const string &destination) {
+    std::ifstream input(source.c_str(), std::ios::in | std::ios::binary);
+    std::ofstream output(destination.c_str(),
+                         std::ios::out | std::ios::binary | std::ios::trunc);
+    OLA_ASSERT_TRUE(input.is_open());
+    OLA_ASSERT_TRUE(output.is_open());
+    output << input.rdbuf();
+  }
 };
 
 
@@ -443,6 +461,88 @@ void PidStoreTest::testPidStoreDirectoryLoad() {
 }
 
 
+/**
+ * Check that the precompiled format works, and that the manufacturer stores
+ * are built on demand.
+ */
+void PidStoreTest::testPidStorePrecompiledLoad() {
+  const string directory = TEST_BUILD_DIR "/common/rdm/precompiled_pids";
+  OLA_ASSERT_TRUE(mkdir(directory.c_str(), 0755) == 0 || errno == EEXIST);
+  const string output_file = directory + "/" +
+      PidStoreLoader::PRECOMPILED_FILE_NAME;
+
+  PidStoreLoader loader;
+  OLA_ASSERT_TRUE(loader.PrecompileDirectory(GetTestDataFile("pids"),
+                                             output_file));
+
+  auto_ptr<const RootPidStore> root_store(loader.LoadFromDirectory(
+      directory));
+  OLA_ASSERT_NOT_NULL(root_store.get());
+  OLA_ASSERT_EQ(static_cast<uint64_t>(1302986774), root_store->Version());
+
+  const PidStore *esta_store = root_store->EstaStore();
+  OLA_ASSERT_NOT_NULL(esta_store);
+  OLA_ASSERT_EQ(6u, esta_store->PidCount());
+  OLA_ASSERT_NOT_NULL(root_store->GetDescriptor("device_info"));
+
+  // The overrides aren't part of the precompiled data, so SERIAL_NUMBER is
+  // present.
+  const PidStore *open_lighting_store =
+    root_store->ManufacturerStore(ola::OPEN_LIGHTING_ESTA_CODE);
+  OLA_ASSERT_NOT_NULL(open_lighting_store);
+  OLA_ASSERT_EQ(1u, open_lighting_store->PidCount());
+  OLA_ASSERT_NOT_NULL(open_lighting_store->LookupPID("SERIAL_NUMBER"));
+  OLA_ASSERT_EQ(open_lighting_store,
+                root_store->ManufacturerStore(ola::OPEN_LIGHTING_ESTA_CODE));
+  OLA_ASSERT_NOT_NULL(root_store->GetDescriptor(
+      "SERIAL_NUMBER", ola::OPEN_LIGHTING_ESTA_CODE));
+
+  // Unknown manufacturers
+  OLA_ASSERT_NULL(root_store->ManufacturerStore(0x1234));
+  OLA_ASSERT_NULL(root_store->ManufacturerStore(0x1234));
+
+  unlink(output_file.c_str());
+  rmdir(directory.c_str());
+}
+
+
+/**
+ * Check that the precompiled data isn't used once the text files it was built
+ * from change.
+ */
+void PidStoreTest::testPidStorePrecompiledStale() {
+  const string directory = TEST_BUILD_DIR "/common/rdm/stale_pids";
+  OLA_ASSERT_TRUE(mkdir(directory.c_str(), 0755) == 0 || errno == EEXIST);
+  const string pids1_file = directory + "/pids1.proto";
+  const string pids2_file = directory + "/pids2.proto";
+  const string output_file = directory + "/" +
+      PidStoreLoader::PRECOMPILED_FILE_NAME;
+  CopyFile(GetTestDataFile("pids/pids1.proto"), pids1_file);
+  CopyFile(GetTestDataFile("pids/pids2.proto"), pids2_file);
+
+  PidStoreLoader loader;
+  OLA_ASSERT_TRUE(loader.PrecompileDirectory(directory, output_file));
+
+  auto_ptr<const RootPidStore> root_store(loader.LoadFromDirectory(
+      directory));
+  OLA_ASSERT_NOT_NULL(root_store.get());
+  OLA_ASSERT_EQ(6u, root_store->EstaStore()->PidCount());
+
+  // Removing a text file invalidates the precompiled data, even though it's
+  // still newer than the remaining file.
+  unlink(pids2_file.c_str());
+  root_store.reset(loader.LoadFromDirectory(directory));
+  OLA_ASSERT_NOT_NULL(root_store.get());
+  OLA_ASSERT_EQ(3u, root_store->EstaStore()->PidCount());
+  OLA_ASSERT_NOT_NULL(root_store->GetDescriptor("device_info"));
+  OLA_ASSERT_NULL(root_store->GetDescriptor("comms_status"));
+
+  unlink(pids1_file.c_str());
+  unlink(output_file.c_str());
+  rmdir(directory.c_str());
+}
+
+
 /**
  * Check that loading a missing file fails.
  */
@@ -0,0 +1,421 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * PipeliningRDMController.cpp
+ * A RDM Controller that allows multiple requests to be in flight at once.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <memory>
+#include <utility>
+#include "ola/Callback.h"
+#include "ola/Logging.h"
+#include "ola/rdm/PipeliningRDMController.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/stl/STLUtils.h"
+
+namespace ola {
+namespace rdm {
+
+using std::auto_ptr;
+
+/*
+ * The state for a single queued or in-flight request.
+ */
+class PipeliningRDMController::OutstandingRequest {
+ public:
+  OutstandingRequest(const RDMRequest *request, RDMCallback *on_complete)
+      : request(request),
+        on_complete(on_complete) {
+  }
+
+  ~OutstandingRequest() {
+    delete request;
+  }
+
+  const RDMRequest *request;
+  RDMCallback *on_complete;
+  // The partial response if we're in an ACK_OVERFLOW sequence.
+  auto_ptr<RDMResponse> response;
+  RDMFrames frames;
+};
+
+
+/*
+ * A new PipeliningRDMController. This takes another controller as a argument,
+ * and ensures we have at most max_in_flight requests outstanding.
+ */
+PipeliningRDMController::PipeliningRDMController(
+    RDMControllerInterface *controller,
+    unsigned int max_queue_size,
+    unsigned int max_in_flight)
+  : m_controller(controller),
+    m_max_queue_size(max_queue_size),
+    m_max_in_flight(max_in_flight ? max_in_flight : 1),
+    m_active(true),
+    m_sending(false),
+    m_broadcast_in_flight(false) {
+}
+
+
+/*
+ * Shutdown
+ */
+PipeliningRDMController::~PipeliningRDMController() {
+  // Fail all requests we haven't sent yet.
+  while (!m_pending_requests.empty()) {
+    OutstandingRequest *outstanding_request = m_pending_requests.front();
+    m_pending_requests.pop_front();
+    if (outstanding_request->on_complete) {
+      RunRDMCallback(outstanding_request->on_complete, RDM_FAILED_TO_SEND);
+    }
+    delete outstanding_request;
+  }
+
+  // And the in-flight ones, like the QueueingRDMController does.
+  InFlightMap::iterator iter = m_in_flight.begin();
+  for (; iter != m_in_flight.end(); ++iter) {
+    if (iter->second->on_complete) {
+      RunRDMCallback(iter->second->on_complete, RDM_FAILED_TO_SEND);
+    }
+    delete iter->second;
+  }
+  m_in_flight.clear();
+}
+
+
+/**
+ * Pause the sending of RDM messages. This won't cancel any messages in-flight.
+ */
+void PipeliningRDMController::Pause() {
+  m_active = false;
+}
+
+
+/**
+ * Resume the sending of RDM requests.
+ */
+void PipeliningRDMController::Resume() {
+  m_active = true;
+  TakeNextAction();
+}
+
+
+/**
+ * Queue an RDM request for sending.
+ */
+void PipeliningRDMController::SendRDMRequest(RDMRequest *request,
+                                             RDMCallback *on_complete) {
+  if (m_pending_requests.size() + m_in_flight.size() >= m_max_queue_size) {
+    OLA_WARN << "RDM Queue is full, dropping request";
+    if (on_complete) {
+      RunRDMCallback(on_complete, RDM_FAILED_TO_SEND);
+    }
+    delete request;
+    return;
+  }
+
+  m_pending_requests.push_back(new OutstandingRequest(request, on_complete));
+  TakeNextAction();
+}
+
+
+/**
+ * Do the next action.
+ */
+void PipeliningRDMController::TakeNextAction() {
+  if (CheckForBlockingCondition())
+    return;
+
+  MaybeSendRDMRequests();
+}
+
+
+/**
+ * This method runs before we decide to send more requests and allows sub
+ * classes (like the DiscoverablePipeliningRDMController) to insert other
+ * actions into the queue.
+ * @returns true if some other action is running, false otherwise.
+ */
+bool PipeliningRDMController::CheckForBlockingCondition() {
+  return !m_active;
+}
+
+
+/*
+ * Send as many requests as the window allows.
+ *
+ * The underlying controller may run the callback before SendRDMRequest
+ * returns, which in turn calls back into here. In that case we let the outer
+ * loop pick up the next request.
+ */
+void PipeliningRDMController::MaybeSendRDMRequests() {
+  if (m_sending)
+    return;
+
+  m_sending = true;
+  while (!CheckForBlockingCondition() && DispatchNextRequest()) {}
+  m_sending = false;
+}
+
+
+/*
+ * Find the first request that can be sent and send it.
+ * @returns true if a request was sent, false otherwise.
+ */
+bool PipeliningRDMController::DispatchNextRequest() {
+  if (m_broadcast_in_flight || m_in_flight.size() >= m_max_in_flight)
+    return false;
+
+  RequestQueue::iterator iter = m_pending_requests.begin();
+  for (; iter != m_pending_requests.end(); ++iter) {
+    const UID &destination = (*iter)->request->DestinationUID();
+    if (destination.IsBroadcast()) {
+      // Broadcasts act as a barrier, nothing queued behind them is sent until
+      // they complete.
+      if (!m_in_flight.empty())
+        return false;
+      m_broadcast_in_flight = true;
+      break;
+    }
+
+    // Preserve the ordering of requests to each responder.
+    if (!STLContains(m_in_flight, destination))
+      break;
+  }
+
+  if (iter == m_pending_requests.end())
+    return false;
+
+  OutstandingRequest *outstanding_request = *iter;
+  m_pending_requests.erase(iter);
+  m_in_flight[outstanding_request->request->DestinationUID()] =
+      outstanding_request;
+  DispatchRequest(outstanding_request);
+  return true;
+}
+
+
+/*
+ * Send a request to the underlying controller.
+ */
+void PipeliningRDMController::DispatchRequest(
+    OutstandingRequest *outstanding_request) {
+  // We have to make a copy here because we pass ownership of the request to
+  // the underlying controller.
+  // We need to have the original request because we use it if we receive an
+  // ACK_OVERFLOW.
+  m_controller->SendRDMRequest(
+      outstanding_request->request->Duplicate(),
+      NewSingleCallback(this, &PipeliningRDMController::HandleRDMResponse,
+                        outstanding_request));
+}
+
+
+/*
+ * Handle the response to a request.
+ */
+void PipeliningRDMController::HandleRDMResponse(
+    OutstandingRequest *outstanding_request,
+    RDMReply *reply) {
+  bool was_ack_overflow = reply->StatusCode() == RDM_COMPLETED_OK &&
+                          reply->Response() &&
+                          reply->Response()->ResponseType() == ACK_OVERFLOW;
+  RDMFrames *frames = &outstanding_request->frames;
+
+  // Check for ACK_OVERFLOW
+  if (outstanding_request->response.get()) {
+    frames->insert(frames->end(), reply->Frames().begin(),
+                   reply->Frames().end());
+
+    if (reply->StatusCode() != RDM_COMPLETED_OK || reply->Response() == NULL) {
+      // We failed part way through an ACK_OVERFLOW
+      RDMReply new_reply(reply->StatusCode(), NULL, *frames);
+      RunCallback(outstanding_request, &new_reply);
+      return;
+    }
+
+    // Combine the data.
+    outstanding_request->response.reset(RDMResponse::CombineResponses(
+        outstanding_request->response.get(), reply->Response()));
+
+    if (!outstanding_request->response.get()) {
+      // The response was invalid
+      RDMReply new_reply(RDM_INVALID_RESPONSE, NULL, *frames);
+      RunCallback(outstanding_request, &new_reply);
+    } else if (reply->Response()->ResponseType() != ACK_OVERFLOW) {
+      RDMReply new_reply(RDM_COMPLETED_OK,
+                         outstanding_request->response.release(),
+                         *frames);
+      RunCallback(outstanding_request, &new_reply);
+    } else {
+      DispatchRequest(outstanding_request);
+    }
+  } else if (was_ack_overflow) {
+    // We're in an ACK_OVERFLOW sequence.
+    outstanding_request->response.reset(reply->Response()->Duplicate());
+    frames->assign(reply->Frames().begin(), reply->Frames().end());
+    DispatchRequest(outstanding_request);
+  } else {
+    // Just pass the RDMReply on.
+    RunCallback(outstanding_request, reply);
+  }
+}
+
+
+/*
+ * Complete a request, and send the next ones.
+ */
+void PipeliningRDMController::RunCallback(
+    OutstandingRequest *outstanding_request,
+    RDMReply *reply) {
+  const UID &destination = outstanding_request->request->DestinationUID();
+  if (destination.IsBroadcast())
+    m_broadcast_in_flight = false;
+
+  InFlightMap::iterator iter = m_in_flight.find(destination);
+  if (iter == m_in_flight.end() || iter->second != outstanding_request) {
+    OLA_FATAL << "Received a response for " << destination
+              << " but it wasn't in flight!";
+    return;
+  }
+  m_in_flight.erase(iter);
+
+  if (outstanding_request->on_complete) {
+    outstanding_request->on_complete->Run(reply);
+  }
+  delete outstanding_request;
+  TakeNextAction();
+}
+
+
+/**
+ * Constructor for the DiscoverablePipeliningRDMController
+ */
+DiscoverablePipeliningRDMController::DiscoverablePipeliningRDMController(
+    DiscoverableRDMControllerInterface *controller,
+    unsigned int max_queue_size,
+    unsigned int max_in_flight)
+    : PipeliningRDMController(controller, max_queue_size, max_in_flight),
+      m_discoverable_controller(controller) {
+}
+
+
+/**
+ * Run the full RDM discovery routine. This will either run immediately or
+ * after the in-flight requests complete.
+ */
+void DiscoverablePipeliningRDMController::RunFullDiscovery(
+    RDMDiscoveryCallback *callback) {
+  GenericDiscovery(callback, true);
+}
+
+
+/**
+ * Run the incremental RDM discovery routine. This will either run immediately
+ * or after the in-flight requests complete.
+ */
+void DiscoverablePipeliningRDMController::RunIncrementalDiscovery(
+    RDMDiscoveryCallback *callback) {
+  GenericDiscovery(callback, false);
+}
+
+
+/**
+ * Override this so we can prioritize the discovery requests.
+ */
+void DiscoverablePipeliningRDMController::TakeNextAction() {
+  if (PipeliningRDMController::CheckForBlockingCondition() ||
+      !m_discovery_callbacks.empty())
+    return;
+
+  // prioritize discovery above RDM requests, but wait for the in-flight
+  // requests to drain first.
+  if (!m_pending_discovery_callbacks.empty()) {
+    if (!InFlightCount())
+      StartRDMDiscovery();
+  } else {
+    MaybeSendRDMRequests();
+  }
+}
+
+
+/**
+ * Block if another discovery process is running or is waiting to run.
+ */
+bool DiscoverablePipeliningRDMController::CheckForBlockingCondition() {
+  return (PipeliningRDMController::CheckForBlockingCondition() ||
+          !m_discovery_callbacks.empty() ||
+          !m_pending_discovery_callbacks.empty());
+}
+
+
+/**
+ * The generic discovery routine
+ */
+void DiscoverablePipeliningRDMController::GenericDiscovery(
+    RDMDiscoveryCallback *callback,
+    bool full) {
+  m_pending_discovery_callbacks.push_back(std::make_pair(full, callback));
+  TakeNextAction();
+}
+
+
+/**
+ * Run the rdm discovery routine for the underlying controller.
+ * @pre m_pending_discovery_callbacks is not empty()
+ */
+void DiscoverablePipeliningRDMController::StartRDMDiscovery() {
+  bool full = false;
+  m_discovery_callbacks.reserve(m_pending_discovery_callbacks.size());
+
+  PendingDiscoveryCallbacks::iterator iter =
+    m_pending_discovery_callbacks.begin();
+  for (; iter != m_pending_discovery_callbacks.end(); iter++) {
+    full |= iter->first;
+    m_discovery_callbacks.push_back(iter->second);
+  }
+  m_pending_discovery_callbacks.clear();
+
+  RDMDiscoveryCallback *callback = NewSingleCallback(
+      this,
+      &DiscoverablePipeliningRDMController::DiscoveryComplete);
+
+  if (full)
+    m_discoverable_controller->RunFullDiscovery(callback);
+  else
+    m_discoverable_controller->RunIncrementalDiscovery(callback);
+}
+
+
+/**
+ * Called when discovery completes
+ */
+void DiscoverablePipeliningRDMController::DiscoveryComplete(
+    const ola::rdm::UIDSet &uids) {
+  DiscoveryCallbacks::iterator iter = m_discovery_callbacks.begin();
+  for (; iter != m_discovery_callbacks.end(); ++iter) {
+    if (*iter)
+      (*iter)->Run(uids);
+  }
+  m_discovery_callbacks.clear();
+  TakeNextAction();
+}
+}  // namespace rdm
+}  // namespace ola
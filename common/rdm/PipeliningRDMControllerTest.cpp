@@ -0,0 +1,498 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * PipeliningRDMControllerTest.cpp
+ * Test fixture for the PipeliningRDMController
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <map>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "ola/Logging.h"
+#include "ola/base/Array.h"
+#include "ola/Callback.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/rdm/RDMControllerInterface.h"
+#include "ola/rdm/PipeliningRDMController.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::NewSingleCallback;
+using ola::rdm::ACK_OVERFLOW;
+using ola::rdm::DiscoverablePipeliningRDMController;
+using ola::rdm::PipeliningRDMController;
+using ola::rdm::RDMCallback;
+using ola::rdm::RDMDiscoveryCallback;
+using ola::rdm::RDMFrame;
+using ola::rdm::RDMFrames;
+using ola::rdm::RDMGetResponse;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::RDMResponse;
+using ola::rdm::RDM_ACK;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+using std::auto_ptr;
+using std::map;
+using std::queue;
+using std::vector;
+
+namespace {
+
+RDMRequest *NewGetRequest(const UID &source, const UID &destination) {
+  return new ola::rdm::RDMGetRequest(source,
+                                     destination,
+                                     0,  // transaction #
+                                     1,  // port id
+                                     10,  // sub device
+                                     296,  // param id
+                                     NULL,  // data
+                                     0);  // data length
+}
+
+RDMResponse *NewGetResponse(const UID &source, const UID &destination) {
+  return new RDMGetResponse(source,
+                            destination,
+                            0,  // transaction #
+                            RDM_ACK,
+                            0,  // message count
+                            10,  // sub device
+                            296,  // param id
+                            NULL,  // data
+                            0);  // data length
+}
+
+/**
+ * A mock controller which allows multiple requests to be in flight.
+ */
+class MockPipelinedController
+    : public ola::rdm::DiscoverableRDMControllerInterface {
+ public:
+  MockPipelinedController()
+      : m_discovery_callback(NULL) {
+  }
+
+  ~MockPipelinedController() {
+    CallbackMap::iterator iter = m_callbacks.begin();
+    for (; iter != m_callbacks.end(); ++iter) {
+      while (!iter->second.empty()) {
+        delete iter->second.front();
+        iter->second.pop();
+      }
+    }
+  }
+
+  void SendRDMRequest(RDMRequest *request, RDMCallback *on_complete) {
+    OLA_ASSERT_TRUE(m_expected_calls.size());
+    expected_call call = m_expected_calls.front();
+    m_expected_calls.pop();
+    OLA_ASSERT_TRUE(*call.request == *request);
+    UID destination = request->DestinationUID();
+    delete request;
+
+    if (call.reply) {
+      on_complete->Run(call.reply);
+      delete call.reply;
+    } else {
+      m_callbacks[destination].push(on_complete);
+    }
+  }
+
+  void ExpectCallAndCapture(RDMRequest *request) {
+    expected_call call = { request, NULL };
+    m_expected_calls.push(call);
+  }
+
+  // Takes ownership of the reply.
+  void ExpectCallAndReplyWith(RDMRequest *request, RDMReply *reply) {
+    expected_call call = { request, reply };
+    m_expected_calls.push(call);
+  }
+
+  void RunFullDiscovery(RDMDiscoveryCallback *callback) {
+    OLA_ASSERT_FALSE(m_discovery_callback);
+    m_discovery_callback = callback;
+  }
+
+  void RunIncrementalDiscovery(RDMDiscoveryCallback *callback) {
+    OLA_ASSERT_FALSE(m_discovery_callback);
+    m_discovery_callback = callback;
+  }
+
+  bool DiscoveryRunning() const { return m_discovery_callback != NULL; }
+
+  void RunDiscoveryCallback(const UIDSet &uids) {
+    OLA_ASSERT_TRUE(m_discovery_callback);
+    RDMDiscoveryCallback *callback = m_discovery_callback;
+    m_discovery_callback = NULL;
+    callback->Run(uids);
+  }
+
+  // Run the oldest captured callback for the destination UID.
+  void RunRDMCallback(const UID &destination, RDMReply *reply) {
+    queue<RDMCallback*> &callbacks = m_callbacks[destination];
+    OLA_ASSERT_FALSE(callbacks.empty());
+    RDMCallback *callback = callbacks.front();
+    callbacks.pop();
+    callback->Run(reply);
+  }
+
+  unsigned int InFlight(const UID &destination) {
+    return m_callbacks[destination].size();
+  }
+
+  void Verify() {
+    OLA_ASSERT_EQ(static_cast<size_t>(0), m_expected_calls.size());
+  }
+
+ private:
+  typedef struct {
+    RDMRequest *request;
+    RDMReply *reply;
+  } expected_call;
+
+  typedef map<UID, queue<RDMCallback*> > CallbackMap;
+
+  queue<expected_call> m_expected_calls;
+  CallbackMap m_callbacks;
+  RDMDiscoveryCallback *m_discovery_callback;
+};
+}  // namespace
+
+
+class PipeliningRDMControllerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(PipeliningRDMControllerTest);
+  CPPUNIT_TEST(testSendAndReceive);
+  CPPUNIT_TEST(testWindow);
+  CPPUNIT_TEST(testPerUIDOrdering);
+  CPPUNIT_TEST(testBroadcastBarrier);
+  CPPUNIT_TEST(testAckOverflow);
+  CPPUNIT_TEST(testQueueOverflow);
+  CPPUNIT_TEST(testDiscoveryWaitsForInFlight);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  PipeliningRDMControllerTest()
+      : m_source(1, 2),
+        m_uid1(3, 4),
+        m_uid2(3, 5),
+        m_uid3(3, 6),
+        m_completed(0),
+        m_discovery_complete_count(0) {
+  }
+
+  void testSendAndReceive();
+  void testWindow();
+  void testPerUIDOrdering();
+  void testBroadcastBarrier();
+  void testAckOverflow();
+  void testQueueOverflow();
+  void testDiscoveryWaitsForInFlight();
+
+  void VerifyResponse(RDMReply *expected_reply, RDMReply *reply) {
+    OLA_ASSERT_EQ(*expected_reply, *reply);
+    m_completed++;
+  }
+
+  void VerifyDiscoveryComplete(const UIDSet &) {
+    m_discovery_complete_count++;
+  }
+
+ private:
+  UID m_source;
+  UID m_uid1;
+  UID m_uid2;
+  UID m_uid3;
+  unsigned int m_completed;
+  unsigned int m_discovery_complete_count;
+
+  RDMCallback *NewVerifier(RDMReply *expected_reply) {
+    return NewSingleCallback(
+        this, &PipeliningRDMControllerTest::VerifyResponse, expected_reply);
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PipeliningRDMControllerTest);
+
+
+/*
+ * Check requests that complete immediately.
+ */
+void PipeliningRDMControllerTest::testSendAndReceive() {
+  MockPipelinedController mock_controller;
+  PipeliningRDMController controller(&mock_controller, 10, 4);
+
+  RDMRequest *get_request = NewGetRequest(m_source, m_uid1);
+  RDMReply *expected_reply = new RDMReply(
+      ola::rdm::RDM_COMPLETED_OK, NewGetResponse(m_uid1, m_source));
+  mock_controller.ExpectCallAndReplyWith(get_request, expected_reply);
+  controller.SendRDMRequest(get_request, NewVerifier(expected_reply));
+
+  get_request = NewGetRequest(m_source, m_uid1);
+  expected_reply = new RDMReply(ola::rdm::RDM_TIMEOUT);
+  mock_controller.ExpectCallAndReplyWith(get_request, expected_reply);
+  controller.SendRDMRequest(get_request, NewVerifier(expected_reply));
+
+  OLA_ASSERT_EQ(2u, m_completed);
+  OLA_ASSERT_EQ(0u, controller.InFlightCount());
+  mock_controller.Verify();
+}
+
+
+/*
+ * Check that no more than max_in_flight requests are outstanding.
+ */
+void PipeliningRDMControllerTest::testWindow() {
+  MockPipelinedController mock_controller;
+  PipeliningRDMController controller(&mock_controller, 10, 2);
+
+  RDMRequest *request1 = NewGetRequest(m_source, m_uid1);
+  RDMRequest *request2 = NewGetRequest(m_source, m_uid2);
+  RDMRequest *request3 = NewGetRequest(m_source, m_uid3);
+  RDMReply reply1(ola::rdm::RDM_COMPLETED_OK,
+                  NewGetResponse(m_uid1, m_source));
+  RDMReply reply2(ola::rdm::RDM_COMPLETED_OK,
+                  NewGetResponse(m_uid2, m_source));
+  RDMReply reply3(ola::rdm::RDM_COMPLETED_OK,
+                  NewGetResponse(m_uid3, m_source));
+
+  mock_controller.ExpectCallAndCapture(request1);
+  mock_controller.ExpectCallAndCapture(request2);
+  controller.SendRDMRequest(request1, NewVerifier(&reply1));
+  controller.SendRDMRequest(request2, NewVerifier(&reply2));
+  controller.SendRDMRequest(request3, NewVerifier(&reply3));
+  mock_controller.Verify();
+  OLA_ASSERT_EQ(2u, controller.InFlightCount());
+  OLA_ASSERT_EQ(1u, controller.QueuedCount());
+
+  // Completing the second request opens the window for the third.
+  mock_controller.ExpectCallAndCapture(request3);
+  mock_controller.RunRDMCallback(m_uid2, &reply2);
+  mock_controller.Verify();
+  OLA_ASSERT_EQ(2u, controller.InFlightCount());
+  OLA_ASSERT_EQ(0u, controller.QueuedCount());
+
+  mock_controller.RunRDMCallback(m_uid3, &reply3);
+  mock_controller.RunRDMCallback(m_uid1, &reply1);
+  OLA_ASSERT_EQ(3u, m_completed);
+  OLA_ASSERT_EQ(0u, controller.InFlightCount());
+}
+
+
+/*
+ * Check that only one request per UID is in flight, and requests to the same
+ * UID are sent in order.
+ */
+void PipeliningRDMControllerTest::testPerUIDOrdering() {
+  MockPipelinedController mock_controller;
+  PipeliningRDMController controller(&mock_controller, 10, 4);
+
+  RDMRequest *request1 = NewGetRequest(m_source, m_uid1);
+  RDMRequest *request2 = NewGetRequest(m_source, m_uid1);
+  RDMRequest *request3 = NewGetRequest(m_source, m_uid2);
+  RDMReply reply1(ola::rdm::RDM_COMPLETED_OK,
+                  NewGetResponse(m_uid1, m_source));
+  RDMReply reply2(ola::rdm::RDM_TIMEOUT);
+  RDMReply reply3(ola::rdm::RDM_COMPLETED_OK,
+                  NewGetResponse(m_uid2, m_source));
+
+  // The second request to uid1 is held back, the request to uid2 overtakes
+  // it.
+  mock_controller.ExpectCallAndCapture(request1);
+  mock_controller.ExpectCallAndCapture(request3);
+  controller.SendRDMRequest(request1, NewVerifier(&reply1));
+  controller.SendRDMRequest(request2, NewVerifier(&reply2));
+  controller.SendRDMRequest(request3, NewVerifier(&reply3));
+  mock_controller.Verify();
+  OLA_ASSERT_EQ(1u, mock_controller.InFlight(m_uid1));
+  OLA_ASSERT_EQ(1u, mock_controller.InFlight(m_uid2));
+
+  mock_controller.RunRDMCallback(m_uid2, &reply3);
+  OLA_ASSERT_EQ(1u, controller.QueuedCount());
+
+  mock_controller.ExpectCallAndCapture(request2);
+  mock_controller.RunRDMCallback(m_uid1, &reply1);
+  mock_controller.Verify();
+  OLA_ASSERT_EQ(1u, mock_controller.InFlight(m_uid1));
+
+  mock_controller.RunRDMCallback(m_uid1, &reply2);
+  OLA_ASSERT_EQ(3u, m_completed);
+}
+
+
+/*
+ * Check that broadcast requests are sent on their own.
+ */
+void PipeliningRDMControllerTest::testBroadcastBarrier() {
+  MockPipelinedController mock_controller;
+  PipeliningRDMController controller(&mock_controller, 10, 4);
+
+  UID broadcast = UID::AllDevices();
+  RDMRequest *request1 = NewGetRequest(m_source, m_uid1);
+  RDMRequest *broadcast_request = NewGetRequest(m_source, broadcast);
+  RDMRequest *request2 = NewGetRequest(m_source, m_uid2);
+  RDMReply reply1(ola::rdm::RDM_COMPLETED_OK,
+                  NewGetResponse(m_uid1, m_source));
+  RDMReply *broadcast_reply = new RDMReply(ola::rdm::RDM_WAS_BROADCAST);
+  RDMReply reply2(ola::rdm::RDM_COMPLETED_OK,
+                  NewGetResponse(m_uid2, m_source));
+
+  mock_controller.ExpectCallAndCapture(request1);
+  controller.SendRDMRequest(request1, NewVerifier(&reply1));
+  controller.SendRDMRequest(broadcast_request, NewVerifier(broadcast_reply));
+  controller.SendRDMRequest(request2, NewVerifier(&reply2));
+  mock_controller.Verify();
+  OLA_ASSERT_EQ(1u, controller.InFlightCount());
+  OLA_ASSERT_EQ(2u, controller.QueuedCount());
+
+  // Once the first completes, the broadcast is sent, and then the request to
+  // uid2.
+  mock_controller.ExpectCallAndReplyWith(broadcast_request, broadcast_reply);
+  mock_controller.ExpectCallAndCapture(request2);
+  mock_controller.RunRDMCallback(m_uid1, &reply1);
+  mock_controller.Verify();
+  OLA_ASSERT_EQ(2u, m_completed);
+
+  mock_controller.RunRDMCallback(m_uid2, &reply2);
+  OLA_ASSERT_EQ(3u, m_completed);
+}
+
+
+/*
+ * Check that ACK_OVERFLOW sequences are tracked per request.
+ */
+void PipeliningRDMControllerTest::testAckOverflow() {
+  MockPipelinedController mock_controller;
+  PipeliningRDMController controller(&mock_controller, 10, 4);
+
+  uint8_t data[] = {0xaa, 0xbb};
+  RDMRequest *request1 = NewGetRequest(m_source, m_uid1);
+  RDMRequest *request2 = NewGetRequest(m_source, m_uid2);
+
+  RDMGetResponse *overflow_response = new RDMGetResponse(
+      m_uid1, m_source, 0, ACK_OVERFLOW, 0, 10, 296, data, 1);
+  RDMGetResponse *final_response = new RDMGetResponse(
+      m_uid1, m_source, 0, RDM_ACK, 0, 10, 296, data + 1, 1);
+  RDMGetResponse *expected_response = new RDMGetResponse(
+      m_uid1, m_source, 0, RDM_ACK, 0, 10, 296, data, 2);
+
+  RDMReply expected_reply1(ola::rdm::RDM_COMPLETED_OK, expected_response);
+  RDMReply reply2(ola::rdm::RDM_COMPLETED_OK,
+                  NewGetResponse(m_uid2, m_source));
+
+  mock_controller.ExpectCallAndCapture(request1);
+  mock_controller.ExpectCallAndCapture(request2);
+  controller.SendRDMRequest(request1, NewVerifier(&expected_reply1));
+  controller.SendRDMRequest(request2, NewVerifier(&reply2));
+  mock_controller.Verify();
+
+  // The overflow causes the request to uid1 to be re-sent, interleaved with
+  // the completion of the request to uid2.
+  RDMReply overflow_reply(ola::rdm::RDM_COMPLETED_OK, overflow_response);
+  mock_controller.ExpectCallAndCapture(request1);
+  mock_controller.RunRDMCallback(m_uid1, &overflow_reply);
+  mock_controller.Verify();
+  OLA_ASSERT_EQ(2u, controller.InFlightCount());
+
+  mock_controller.RunRDMCallback(m_uid2, &reply2);
+  OLA_ASSERT_EQ(1u, m_completed);
+
+  RDMReply final_reply(ola::rdm::RDM_COMPLETED_OK, final_response);
+  mock_controller.RunRDMCallback(m_uid1, &final_reply);
+  OLA_ASSERT_EQ(2u, m_completed);
+  OLA_ASSERT_EQ(0u, controller.InFlightCount());
+}
+
+
+/*
+ * Check the queue limit includes the in-flight requests.
+ */
+void PipeliningRDMControllerTest::testQueueOverflow() {
+  MockPipelinedController mock_controller;
+  auto_ptr<PipeliningRDMController> controller(
+      new PipeliningRDMController(&mock_controller, 2, 4));
+
+  RDMRequest *request1 = NewGetRequest(m_source, m_uid1);
+  RDMRequest *request2 = NewGetRequest(m_source, m_uid2);
+  RDMReply failed_to_send_reply(ola::rdm::RDM_FAILED_TO_SEND);
+
+  mock_controller.ExpectCallAndCapture(request1);
+  controller->Pause();
+  controller->SendRDMRequest(request1, NewVerifier(&failed_to_send_reply));
+  controller->Resume();
+  controller->Pause();
+  controller->SendRDMRequest(request2, NewVerifier(&failed_to_send_reply));
+  mock_controller.Verify();
+
+  // this one overflows the queue
+  controller->SendRDMRequest(NewGetRequest(m_source, m_uid3),
+                             NewVerifier(&failed_to_send_reply));
+  OLA_ASSERT_EQ(1u, m_completed);
+
+  // The remaining two fail when the controller is destroyed.
+  controller.reset();
+  OLA_ASSERT_EQ(3u, m_completed);
+}
+
+
+/*
+ * Check that discovery waits for the in-flight requests, and blocks new ones.
+ */
+void PipeliningRDMControllerTest::testDiscoveryWaitsForInFlight() {
+  MockPipelinedController mock_controller;
+  DiscoverablePipeliningRDMController controller(&mock_controller, 10, 4);
+
+  RDMRequest *request1 = NewGetRequest(m_source, m_uid1);
+  RDMRequest *request2 = NewGetRequest(m_source, m_uid2);
+  RDMRequest *request3 = NewGetRequest(m_source, m_uid3);
+  RDMReply reply1(ola::rdm::RDM_COMPLETED_OK,
+                  NewGetResponse(m_uid1, m_source));
+  RDMReply reply2(ola::rdm::RDM_COMPLETED_OK,
+                  NewGetResponse(m_uid2, m_source));
+  RDMReply reply3(ola::rdm::RDM_COMPLETED_OK,
+                  NewGetResponse(m_uid3, m_source));
+
+  mock_controller.ExpectCallAndCapture(request1);
+  mock_controller.ExpectCallAndCapture(request2);
+  controller.SendRDMRequest(request1, NewVerifier(&reply1));
+  controller.SendRDMRequest(request2, NewVerifier(&reply2));
+
+  controller.RunFullDiscovery(NewSingleCallback(
+      this, &PipeliningRDMControllerTest::VerifyDiscoveryComplete));
+  // This is held until discovery completes.
+  controller.SendRDMRequest(request3, NewVerifier(&reply3));
+  mock_controller.Verify();
+  OLA_ASSERT_FALSE(mock_controller.DiscoveryRunning());
+
+  mock_controller.RunRDMCallback(m_uid1, &reply1);
+  OLA_ASSERT_FALSE(mock_controller.DiscoveryRunning());
+  mock_controller.RunRDMCallback(m_uid2, &reply2);
+  OLA_ASSERT_TRUE(mock_controller.DiscoveryRunning());
+  OLA_ASSERT_EQ(1u, controller.QueuedCount());
+
+  UIDSet uids;
+  mock_controller.ExpectCallAndCapture(request3);
+  mock_controller.RunDiscoveryCallback(uids);
+  OLA_ASSERT_EQ(1u, m_discovery_complete_count);
+  mock_controller.Verify();
+
+  mock_controller.RunRDMCallback(m_uid3, &reply3);
+  OLA_ASSERT_EQ(3u, m_completed);
+}
@@ -104,7 +104,7 @@ RDMCommand::RDMCommand(const UID &source,
 
 
 RDMCommand::~RDMCommand() {
-  if (m_data) {
+  if (m_data != m_inline_data) {
     delete[] m_data;
   }
 }
@@ -171,11 +171,15 @@ uint8_t RDMCommand::MessageLength() const {
 void RDMCommand::SetParamData(const uint8_t *data, unsigned int length) {
   m_data_length = length;
   if (m_data_length > 0 && data != NULL) {
-    if (m_data) {
+    if (m_data != m_inline_data) {
       delete[] m_data;
     }
 
-    m_data = new uint8_t[m_data_length];
+    if (m_data_length <= sizeof(m_inline_data)) {
+      m_data = m_inline_data;
+    } else {
+      m_data = new uint8_t[m_data_length];
+    }
     memcpy(m_data, data, m_data_length);
   }
 }
@@ -84,6 +84,7 @@ class RDMCommandTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testGetRequestCreation);
   CPPUNIT_TEST(testGetWithExtraData);
   CPPUNIT_TEST(testSetWithParamData);
+  CPPUNIT_TEST(testLargeParamData);
   CPPUNIT_TEST(testRequestOverrides);
   CPPUNIT_TEST(testRequestMutation);
   CPPUNIT_TEST(testRequestInflation);
@@ -110,6 +111,7 @@ class RDMCommandTest: public CppUnit::TestFixture {
   void testGetRequestCreation();
   void testGetWithExtraData();
   void testSetWithParamData();
+  void testLargeParamData();
   void testRequestOverrides();
   void testRequestMutation();
   void testRequestInflation();
@@ -321,6 +323,35 @@ void RDMCommandTest::testSetWithParamData() {
   OLA_ASSERT_FALSE(command.IsDUB());
 }
 
+/*
+ * Small param data is stored inline, check param data that doesn't fit.
+ */
+void RDMCommandTest::testLargeParamData() {
+  uint8_t data[200];
+  for (unsigned int i = 0; i < sizeof(data); i++) {
+    data[i] = i;
+  }
+
+  RDMSetRequest command(m_source,
+                        m_destination,
+                        3,  // transaction #
+                        1,  // port id
+                        13,  // sub device
+                        296,  // param id
+                        data,
+                        sizeof(data));
+  OLA_ASSERT_DATA_EQUALS(data, sizeof(data), command.ParamData(),
+                         command.ParamDataSize());
+
+  std::auto_ptr<RDMSetRequest> duplicate(command.Duplicate());
+  OLA_ASSERT_TRUE(command == *duplicate);
+
+  std::auto_ptr<RDMResponse> response(
+      ola::rdm::GetResponseFromData(&command, data, sizeof(data)));
+  OLA_ASSERT_DATA_EQUALS(data, sizeof(data), response->ParamData(),
+                         response->ParamDataSize());
+}
+
 void RDMCommandTest::testRequestOverrides() {
   RDMRequest::OverrideOptions options;
   options.SetMessageLength(10);
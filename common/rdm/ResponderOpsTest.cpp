@@ -0,0 +1,330 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * ResponderOpsTest.cpp
+ * Test fixture for the ResponderOps class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+#include <memory>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/base/Array.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/RDMResponseCodes.h"
+#include "ola/rdm/ResponderOps.h"
+#include "ola/rdm/UID.h"
+#include "ola/stl/STLUtils.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::network::HostToNetwork;
+using ola::network::NetworkToHost;
+using ola::rdm::RDMGetRequest;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::RDMResponse;
+using ola::rdm::RDMSetRequest;
+using ola::rdm::ResponderOps;
+using ola::rdm::UID;
+using std::auto_ptr;
+using std::vector;
+
+/*
+ * A responder with a handful of PIDs.
+ */
+class TestResponder {
+ public:
+  TestResponder() : m_start_address(1), m_get_count(0) {}
+
+  RDMResponse *GetStartAddress(const RDMRequest *request) {
+    m_get_count++;
+    uint16_t address = HostToNetwork(m_start_address);
+    return ola::rdm::GetResponseFromData(
+        request, reinterpret_cast<const uint8_t*>(&address),
+        sizeof(address));
+  }
+
+  RDMResponse *SetStartAddress(const RDMRequest *request) {
+    uint16_t address;
+    if (request->ParamDataSize() != sizeof(address)) {
+      return ola::rdm::NackWithReason(request, ola::rdm::NR_FORMAT_ERROR);
+    }
+    memcpy(&address, request->ParamData(), sizeof(address));
+    m_start_address = NetworkToHost(address);
+    return ola::rdm::GetResponseFromData(request, NULL, 0);
+  }
+
+  RDMResponse *GetFirstLabel(const RDMRequest *request) {
+    return ola::rdm::GetResponseFromData(
+        request, reinterpret_cast<const uint8_t*>("first"), 5);
+  }
+
+  RDMResponse *GetSecondLabel(const RDMRequest *request) {
+    return ola::rdm::GetResponseFromData(
+        request, reinterpret_cast<const uint8_t*>("second"), 6);
+  }
+
+  RDMResponse *ResetDevice(const RDMRequest *request) {
+    return ola::rdm::GetResponseFromData(request, NULL, 0);
+  }
+
+  uint16_t StartAddress() const { return m_start_address; }
+  unsigned int GetCount() const { return m_get_count; }
+
+  static const ResponderOps<TestResponder>::ParamHandler PARAM_HANDLERS[];
+
+ private:
+  uint16_t m_start_address;
+  unsigned int m_get_count;
+};
+
+// Deliberately unsorted, with a duplicate entry for DEVICE_LABEL.
+const ResponderOps<TestResponder>::ParamHandler
+    TestResponder::PARAM_HANDLERS[] = {
+  { ola::rdm::PID_RESET_DEVICE,
+    NULL,
+    &TestResponder::ResetDevice},
+  { ola::rdm::PID_DEVICE_LABEL,
+    &TestResponder::GetFirstLabel,
+    NULL},
+  { ola::rdm::PID_DMX_START_ADDRESS,
+    &TestResponder::GetStartAddress,
+    &TestResponder::SetStartAddress},
+  { ola::rdm::PID_DEVICE_LABEL,
+    &TestResponder::GetSecondLabel,
+    NULL},
+  { 0, NULL, NULL},
+};
+
+
+class ResponderOpsTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(ResponderOpsTest);
+  CPPUNIT_TEST(testDispatch);
+  CPPUNIT_TEST(testSupportedParams);
+  CPPUNIT_TEST(testErrors);
+  CPPUNIT_TEST(testBatch);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  ResponderOpsTest()
+    : m_controller(1, 2),
+      m_uid(3, 4),
+      m_ops(TestResponder::PARAM_HANDLERS) {
+  }
+
+  void testDispatch();
+  void testSupportedParams();
+  void testErrors();
+  void testBatch();
+
+ private:
+  UID m_controller;
+  UID m_uid;
+  ResponderOps<TestResponder> m_ops;
+  TestResponder m_responder;
+  auto_ptr<RDMReply> m_reply;
+
+  RDMRequest *NewGet(uint16_t pid,
+                     const UID *destination = NULL,
+                     uint16_t sub_device = ola::rdm::ROOT_RDM_DEVICE) {
+    return new RDMGetRequest(m_controller, destination ? *destination : m_uid,
+                             0, 1, sub_device, pid, NULL, 0);
+  }
+
+  void Send(const RDMRequest *request) {
+    m_reply.reset();
+    m_ops.HandleRDMRequest(
+        &m_responder, m_uid, ola::rdm::ROOT_RDM_DEVICE, request,
+        ola::NewSingleCallback(this, &ResponderOpsTest::HandleReply));
+  }
+
+  void HandleReply(RDMReply *reply) {
+    m_reply.reset(new RDMReply(reply->StatusCode(),
+                               reply->Response() ?
+                               reply->Response()->Duplicate() : NULL));
+  }
+
+  void CheckNack(const RDMReply *reply, uint16_t reason);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ResponderOpsTest);
+
+
+void ResponderOpsTest::CheckNack(const RDMReply *reply, uint16_t reason) {
+  OLA_ASSERT_NOT_NULL(reply);
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, reply->StatusCode());
+  OLA_ASSERT_NOT_NULL(reply->Response());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(ola::rdm::RDM_NACK_REASON),
+                reply->Response()->ResponseType());
+  uint16_t nack_reason;
+  OLA_ASSERT_EQ(static_cast<unsigned int>(sizeof(nack_reason)),
+                reply->Response()->ParamDataSize());
+  memcpy(&nack_reason, reply->Response()->ParamData(), sizeof(nack_reason));
+  OLA_ASSERT_EQ(reason, NetworkToHost(nack_reason));
+}
+
+
+/*
+ * Check requests reach the right handlers.
+ */
+void ResponderOpsTest::testDispatch() {
+  Send(NewGet(ola::rdm::PID_DMX_START_ADDRESS));
+  OLA_ASSERT_NOT_NULL(m_reply.get());
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, m_reply->StatusCode());
+  const uint8_t expected_address[] = {0, 1};
+  OLA_ASSERT_DATA_EQUALS(expected_address, arraysize(expected_address),
+                         m_reply->Response()->ParamData(),
+                         m_reply->Response()->ParamDataSize());
+
+  uint16_t new_address = HostToNetwork(static_cast<uint16_t>(100));
+  Send(new RDMSetRequest(m_controller, m_uid, 0, 1, ola::rdm::ROOT_RDM_DEVICE,
+                         ola::rdm::PID_DMX_START_ADDRESS,
+                         reinterpret_cast<const uint8_t*>(&new_address),
+                         sizeof(new_address)));
+  OLA_ASSERT_NOT_NULL(m_reply.get());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(ola::rdm::RDM_ACK),
+                m_reply->Response()->ResponseType());
+  OLA_ASSERT_EQ(static_cast<uint16_t>(100), m_responder.StartAddress());
+
+  // The later handler for a PID wins.
+  Send(NewGet(ola::rdm::PID_DEVICE_LABEL));
+  OLA_ASSERT_NOT_NULL(m_reply.get());
+  OLA_ASSERT_DATA_EQUALS(reinterpret_cast<const uint8_t*>("second"), 6,
+                         m_reply->Response()->ParamData(),
+                         m_reply->Response()->ParamDataSize());
+
+  // Broadcast SETs are run but there is no response.
+  UID broadcast = UID::AllDevices();
+  new_address = HostToNetwork(static_cast<uint16_t>(200));
+  Send(new RDMSetRequest(m_controller, broadcast, 0, 1,
+                         ola::rdm::ROOT_RDM_DEVICE,
+                         ola::rdm::PID_DMX_START_ADDRESS,
+                         reinterpret_cast<const uint8_t*>(&new_address),
+                         sizeof(new_address)));
+  OLA_ASSERT_NOT_NULL(m_reply.get());
+  OLA_ASSERT_EQ(ola::rdm::RDM_WAS_BROADCAST, m_reply->StatusCode());
+  OLA_ASSERT_NULL(m_reply->Response());
+  OLA_ASSERT_EQ(static_cast<uint16_t>(200), m_responder.StartAddress());
+}
+
+
+/*
+ * Check the SUPPORTED_PARAMETERS response is sorted and excludes the required
+ * PIDs.
+ */
+void ResponderOpsTest::testSupportedParams() {
+  Send(NewGet(ola::rdm::PID_SUPPORTED_PARAMETERS));
+  OLA_ASSERT_NOT_NULL(m_reply.get());
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, m_reply->StatusCode());
+  const uint8_t expected[] = {0x00, 0x82, 0x10, 0x01};  // label, reset
+  OLA_ASSERT_DATA_EQUALS(expected, arraysize(expected),
+                         m_reply->Response()->ParamData(),
+                         m_reply->Response()->ParamDataSize());
+
+  // Sub-devices include the required PIDs.
+  ResponderOps<TestResponder> sub_device_ops(TestResponder::PARAM_HANDLERS,
+                                             true);
+  vector<const RDMRequest*> requests;
+  requests.push_back(NewGet(ola::rdm::PID_SUPPORTED_PARAMETERS));
+  vector<RDMReply*> replies;
+  sub_device_ops.HandleRDMRequests(&m_responder, m_uid,
+                                   ola::rdm::ROOT_RDM_DEVICE, requests,
+                                   &replies);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), replies.size());
+  const uint8_t expected_with_required[] = {
+    0x00, 0x50, 0x00, 0x82, 0x00, 0xf0, 0x10, 0x01
+  };
+  OLA_ASSERT_DATA_EQUALS(expected_with_required,
+                         arraysize(expected_with_required),
+                         replies[0]->Response()->ParamData(),
+                         replies[0]->Response()->ParamDataSize());
+  ola::STLDeleteElements(&replies);
+}
+
+
+/*
+ * Check the error cases.
+ */
+void ResponderOpsTest::testErrors() {
+  Send(NewGet(ola::rdm::PID_LAMP_HOURS));
+  CheckNack(m_reply.get(), ola::rdm::NR_UNKNOWN_PID);
+
+  Send(NewGet(ola::rdm::PID_RESET_DEVICE));
+  CheckNack(m_reply.get(), ola::rdm::NR_UNSUPPORTED_COMMAND_CLASS);
+
+  Send(new RDMSetRequest(m_controller, m_uid, 0, 1, ola::rdm::ROOT_RDM_DEVICE,
+                         ola::rdm::PID_DEVICE_LABEL, NULL, 0));
+  CheckNack(m_reply.get(), ola::rdm::NR_UNSUPPORTED_COMMAND_CLASS);
+
+  Send(NewGet(ola::rdm::PID_DMX_START_ADDRESS, NULL, 1));
+  CheckNack(m_reply.get(), ola::rdm::NR_SUB_DEVICE_OUT_OF_RANGE);
+
+  UID other_uid(3, 5);
+  Send(NewGet(ola::rdm::PID_DMX_START_ADDRESS, &other_uid));
+  OLA_ASSERT_NOT_NULL(m_reply.get());
+  OLA_ASSERT_EQ(ola::rdm::RDM_TIMEOUT, m_reply->StatusCode());
+
+  UID broadcast = UID::AllDevices();
+  Send(NewGet(ola::rdm::PID_DMX_START_ADDRESS, &broadcast));
+  OLA_ASSERT_NOT_NULL(m_reply.get());
+  OLA_ASSERT_EQ(ola::rdm::RDM_WAS_BROADCAST, m_reply->StatusCode());
+  OLA_ASSERT_EQ(0u, m_responder.GetCount());
+}
+
+
+/*
+ * Run a large batch of GETs, this exercises the same path a busy software
+ * responder sees.
+ */
+void ResponderOpsTest::testBatch() {
+  const unsigned int REQUEST_COUNT = 10000;
+  const uint16_t pids[] = {
+    ola::rdm::PID_DMX_START_ADDRESS,
+    ola::rdm::PID_DEVICE_LABEL,
+    ola::rdm::PID_SUPPORTED_PARAMETERS,
+    ola::rdm::PID_LAMP_HOURS,
+  };
+
+  vector<const RDMRequest*> requests;
+  for (unsigned int i = 0; i < REQUEST_COUNT; i++) {
+    requests.push_back(NewGet(pids[i % arraysize(pids)]));
+  }
+
+  vector<RDMReply*> replies;
+  m_ops.HandleRDMRequests(&m_responder, m_uid, ola::rdm::ROOT_RDM_DEVICE,
+                          requests, &replies);
+  OLA_ASSERT_EQ(static_cast<size_t>(REQUEST_COUNT), replies.size());
+  OLA_ASSERT_EQ(REQUEST_COUNT / 4, m_responder.GetCount());
+
+  for (unsigned int i = 0; i < REQUEST_COUNT; i++) {
+    const RDMReply *reply = replies[i];
+    OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, reply->StatusCode());
+    OLA_ASSERT_NOT_NULL(reply->Response());
+    OLA_ASSERT_EQ(pids[i % arraysize(pids)], reply->Response()->ParamId());
+    if (reply->Response()->ParamId() == ola::rdm::PID_LAMP_HOURS) {
+      CheckNack(reply, ola::rdm::NR_UNKNOWN_PID);
+    } else {
+      OLA_ASSERT_EQ(static_cast<uint8_t>(ola::rdm::RDM_ACK),
+                    reply->Response()->ResponseType());
+    }
+  }
+  ola::STLDeleteElements(&replies);
+}
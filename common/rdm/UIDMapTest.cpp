@@ -0,0 +1,220 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UIDMapTest.cpp
+ * Test fixture for the UIDMap class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDMap.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/testing/TestUtils.h"
+
+
+using std::string;
+using ola::rdm::UID;
+using ola::rdm::UIDMap;
+using ola::rdm::UIDSet;
+
+class UIDMapTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(UIDMapTest);
+  CPPUNIT_TEST(testSetAndFind);
+  CPPUNIT_TEST(testOrdering);
+  CPPUNIT_TEST(testRemove);
+  CPPUNIT_TEST(testAddUIDs);
+  CPPUNIT_TEST(testLargeMap);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testSetAndFind();
+    void testOrdering();
+    void testRemove();
+    void testAddUIDs();
+    void testLargeMap();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(UIDMapTest);
+
+namespace {
+class IsOdd {
+ public:
+  bool operator()(const UIDMap<int>::Entry &entry) const {
+    return entry.value % 2;
+  }
+};
+}  // namespace
+
+
+/*
+ * Test setting and finding UIDs.
+ */
+void UIDMapTest::testSetAndFind() {
+  UIDMap<int> map;
+  UID uid1(1, 2);
+  UID uid2(0x7a70, 0xffffffff);
+
+  OLA_ASSERT_TRUE(map.Empty());
+  OLA_ASSERT_EQ(0u, map.Size());
+  OLA_ASSERT_NULL(map.Find(uid1));
+  OLA_ASSERT_FALSE(map.Contains(uid1));
+
+  OLA_ASSERT_TRUE(map.Set(uid1, 10));
+  OLA_ASSERT_TRUE(map.Set(uid2, 20));
+  OLA_ASSERT_FALSE(map.Empty());
+  OLA_ASSERT_EQ(2u, map.Size());
+  OLA_ASSERT_TRUE(map.Contains(uid1));
+  OLA_ASSERT_EQ(10, *map.Find(uid1));
+  OLA_ASSERT_EQ(20, *map.Find(uid2));
+  OLA_ASSERT_NULL(map.Find(UID(1, 3)));
+
+  // replace a value
+  OLA_ASSERT_FALSE(map.Set(uid1, 11));
+  OLA_ASSERT_EQ(2u, map.Size());
+  OLA_ASSERT_EQ(11, *map.Find(uid1));
+
+  // modify in place
+  *map.Find(uid2) = 21;
+  const UIDMap<int> &const_map = map;
+  OLA_ASSERT_EQ(21, *const_map.Find(uid2));
+
+  map.Clear();
+  OLA_ASSERT_TRUE(map.Empty());
+  OLA_ASSERT_FALSE(map.Contains(uid1));
+}
+
+
+/*
+ * Check that UIDs added out of order are iterated in order.
+ */
+void UIDMapTest::testOrdering() {
+  UIDMap<int> map;
+  map.Set(UID(2, 1), 3);
+  map.Set(UID(1, 2), 1);
+  map.Set(UID(0x7a70, 0), 4);
+  map.Set(UID(1, 10), 2);
+
+  OLA_ASSERT_EQ(4u, map.Size());
+  UIDMap<int>::ConstIterator iter = map.Begin();
+  OLA_ASSERT_EQ(UID(1, 2), iter->Uid());
+  OLA_ASSERT_EQ(1, iter->value);
+  ++iter;
+  OLA_ASSERT_EQ(UID(1, 10), iter->Uid());
+  ++iter;
+  OLA_ASSERT_EQ(UID(2, 1), iter->Uid());
+  ++iter;
+  OLA_ASSERT_EQ(UID(0x7a70, 0), iter->Uid());
+  OLA_ASSERT_EQ(4, iter->value);
+  ++iter;
+  OLA_ASSERT_TRUE(iter == map.End());
+
+  UIDSet uids;
+  map.GetUIDs(&uids);
+  OLA_ASSERT_EQ(
+      string("0001:00000002,0001:0000000a,0002:00000001,7a70:00000000"),
+      uids.ToString());
+}
+
+
+/*
+ * Test removing UIDs.
+ */
+void UIDMapTest::testRemove() {
+  UIDMap<int> map;
+  for (unsigned int i = 0; i < 6; i++) {
+    map.Set(UID(1, i), i);
+  }
+
+  OLA_ASSERT_FALSE(map.Remove(UID(2, 0)));
+  OLA_ASSERT_TRUE(map.Remove(UID(1, 2)));
+  OLA_ASSERT_FALSE(map.Remove(UID(1, 2)));
+  OLA_ASSERT_EQ(5u, map.Size());
+  OLA_ASSERT_FALSE(map.Contains(UID(1, 2)));
+
+  OLA_ASSERT_EQ(3u, map.RemoveIf(IsOdd()));
+  OLA_ASSERT_EQ(2u, map.Size());
+  OLA_ASSERT_TRUE(map.Contains(UID(1, 0)));
+  OLA_ASSERT_TRUE(map.Contains(UID(1, 4)));
+  OLA_ASSERT_FALSE(map.Contains(UID(1, 3)));
+  OLA_ASSERT_EQ(0u, map.RemoveIf(IsOdd()));
+}
+
+
+/*
+ * Test adding a UIDSet.
+ */
+void UIDMapTest::testAddUIDs() {
+  UIDMap<int> map;
+  map.Set(UID(1, 2), 1);
+  map.Set(UID(1, 5), 1);
+  map.Set(UID(3, 0), 1);
+
+  UIDSet uids;
+  uids.AddUID(UID(1, 1));
+  uids.AddUID(UID(1, 5));
+  uids.AddUID(UID(2, 0));
+  uids.AddUID(UID(4, 0));
+  map.AddUIDs(uids, 2);
+
+  OLA_ASSERT_EQ(6u, map.Size());
+  OLA_ASSERT_EQ(2, *map.Find(UID(1, 1)));
+  OLA_ASSERT_EQ(1, *map.Find(UID(1, 2)));
+  // existing UIDs keep their value
+  OLA_ASSERT_EQ(1, *map.Find(UID(1, 5)));
+  OLA_ASSERT_EQ(2, *map.Find(UID(2, 0)));
+  OLA_ASSERT_EQ(1, *map.Find(UID(3, 0)));
+  OLA_ASSERT_EQ(2, *map.Find(UID(4, 0)));
+
+  UID previous(0, 0);
+  UIDMap<int>::ConstIterator iter = map.Begin();
+  for (; iter != map.End(); ++iter) {
+    OLA_ASSERT_TRUE(previous < iter->Uid());
+    previous = iter->Uid();
+  }
+
+  UIDMap<int> empty_map;
+  empty_map.AddUIDs(uids, 3);
+  OLA_ASSERT_EQ(4u, empty_map.Size());
+  map.AddUIDs(UIDSet(), 3);
+  OLA_ASSERT_EQ(6u, map.Size());
+}
+
+
+/*
+ * Test a map with as many UIDs as a large discovery run.
+ */
+void UIDMapTest::testLargeMap() {
+  const unsigned int count = 10000;
+  UIDMap<unsigned int> map;
+  // add in reverse order to exercise the non-append path
+  for (unsigned int i = count; i > 0; i--) {
+    map.Set(UID(0x7a70, i - 1), i - 1);
+  }
+  OLA_ASSERT_EQ(count, map.Size());
+
+  UIDMap<unsigned int>::ConstIterator iter = map.Begin();
+  for (unsigned int i = 0; iter != map.End(); ++iter, i++) {
+    OLA_ASSERT_EQ(i, iter->Uid().DeviceId());
+    OLA_ASSERT_EQ(i, iter->value);
+  }
+
+  for (unsigned int i = 0; i < count; i += 7) {
+    OLA_ASSERT_EQ(i, *map.Find(UID(0x7a70, i)));
+  }
+  OLA_ASSERT_NULL(map.Find(UID(0x7a70, count)));
+}
@@ -37,6 +37,8 @@ class UIDTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testUIDInequalities);
   CPPUNIT_TEST(testUIDSet);
   CPPUNIT_TEST(testUIDSetUnion);
+  CPPUNIT_TEST(testUIDSetOrdering);
+  CPPUNIT_TEST(testLargeUIDSet);
   CPPUNIT_TEST(testUIDParse);
   CPPUNIT_TEST(testDirectedToUID);
   CPPUNIT_TEST_SUITE_END();
@@ -46,6 +48,8 @@ class UIDTest: public CppUnit::TestFixture {
     void testUIDInequalities();
     void testUIDSet();
     void testUIDSetUnion();
+    void testUIDSetOrdering();
+    void testLargeUIDSet();
     void testUIDParse();
     void testDirectedToUID();
 };
@@ -259,6 +263,76 @@ void UIDTest::testUIDSetUnion() {
 }
 
 
+/*
+ * Test that UIDs added out of order are still kept sorted.
+ */
+void UIDTest::testUIDSetOrdering() {
+  UIDSet set1;
+  UID uid1(1, 2);
+  UID uid2(1, 10);
+  UID uid3(2, 1);
+  UID uid4(0x7a70, 0);
+
+  set1.AddUID(uid3);
+  set1.AddUID(uid1);
+  set1.AddUID(uid4);
+  set1.AddUID(uid2);
+  set1.AddUID(uid1);
+  OLA_ASSERT_EQ(4u, set1.Size());
+  OLA_ASSERT_EQ(
+      string("0001:00000002,0001:0000000a,0002:00000001,7a70:00000000"),
+      set1.ToString());
+
+  // removing a UID that isn't present is a no-op
+  set1.RemoveUID(UID(3, 3));
+  OLA_ASSERT_EQ(4u, set1.Size());
+  set1.RemoveUID(uid2);
+  OLA_ASSERT_EQ(3u, set1.Size());
+  OLA_ASSERT_FALSE(set1.Contains(uid2));
+  OLA_ASSERT_TRUE(set1.Contains(uid3));
+
+  UIDSet set2;
+  set2.AddUID(uid4);
+  set2.AddUID(uid3);
+  set1.RemoveUID(uid1);
+  OLA_ASSERT_EQ(set2, set1);
+}
+
+
+/*
+ * Test the set operations on a large UIDSet.
+ */
+void UIDTest::testLargeUIDSet() {
+  const unsigned int count = 10000;
+  UIDSet evens, odds, all;
+  // add in reverse order to exercise the non-append path
+  for (unsigned int i = count; i > 0; i--) {
+    UID uid(0x7a70, i - 1);
+    all.AddUID(uid);
+    if (i % 2) {
+      evens.AddUID(uid);
+    } else {
+      odds.AddUID(uid);
+    }
+  }
+  OLA_ASSERT_EQ(count, all.Size());
+  OLA_ASSERT_EQ(count / 2, evens.Size());
+  OLA_ASSERT_EQ(count / 2, odds.Size());
+
+  OLA_ASSERT_EQ(all, evens.Union(odds));
+  OLA_ASSERT_EQ(evens, all.SetDifference(odds));
+  OLA_ASSERT_EQ(0u, evens.SetDifference(all).Size());
+
+  UID previous(0, 0);
+  UIDSet::Iterator iter = all.Begin();
+  for (unsigned int i = 0; iter != all.End(); ++iter, i++) {
+    OLA_ASSERT_EQ(i, iter->DeviceId());
+    OLA_ASSERT_TRUE(i == 0 || previous < *iter);
+    previous = *iter;
+  }
+}
+
+
 /*
  * Test UID parsing
  */
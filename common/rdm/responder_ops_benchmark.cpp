@@ -0,0 +1,276 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * responder_ops_benchmark.cpp
+ * Times thousands of GETs through ResponderOps, both one at a time and as a
+ * batch, and through a MovingLightResponder.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/rdm/MovingLightResponder.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMReply.h"
+#include "ola/rdm/ResponderOps.h"
+#include "ola/rdm/UID.h"
+#include "ola/stl/STLUtils.h"
+
+using ola::Clock;
+using ola::NewSingleCallback;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::rdm::MovingLightResponder;
+using ola::rdm::RDMGetRequest;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::RDMResponse;
+using ola::rdm::ResponderOps;
+using ola::rdm::UID;
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+DEFINE_s_uint32(gets, g, 10000, "The number of GETs to send in each run");
+DEFINE_s_uint32(iterations, i, 10, "The number of times to run each test");
+
+namespace {
+/*
+ * Times a test and prints the average run time.
+ */
+class Timer {
+ public:
+  explicit Timer(const string &name)
+      : m_name(name),
+        m_runs(0) {
+  }
+
+  void Start() { m_clock.CurrentMonotonicTime(&m_start); }
+
+  void Stop() {
+    TimeStamp end;
+    m_clock.CurrentMonotonicTime(&end);
+    m_total += end - m_start;
+    m_runs++;
+  }
+
+  void Print() const {
+    cout << std::left << std::setw(40) << m_name << std::right
+         << std::setw(10) << (m_runs ? m_total.AsInt() / m_runs : 0) << " us"
+         << endl;
+  }
+
+ private:
+  const string m_name;
+  Clock m_clock;
+  TimeStamp m_start;
+  TimeInterval m_total;
+  unsigned int m_runs;
+};
+
+/*
+ * A responder with a PID table about the size of a real fixture's, where
+ * every GET returns a few bytes of data.
+ */
+class BenchmarkResponder {
+ public:
+  BenchmarkResponder() : m_ops(PARAM_HANDLERS) {}
+
+  void HandleRDMRequest(const UID &uid, const RDMRequest *request,
+                        ola::rdm::RDMCallback *on_complete) {
+    m_ops.HandleRDMRequest(this, uid, ola::rdm::ROOT_RDM_DEVICE, request,
+                           on_complete);
+  }
+
+  void HandleRDMRequests(const UID &uid,
+                         const vector<const RDMRequest*> &requests,
+                         vector<RDMReply*> *replies) {
+    m_ops.HandleRDMRequests(this, uid, ola::rdm::ROOT_RDM_DEVICE, requests,
+                            replies);
+  }
+
+ private:
+  ResponderOps<BenchmarkResponder> m_ops;
+
+  RDMResponse *GetLabel(const RDMRequest *request) {
+    static const char label[] = "Benchmark Responder";
+    return ola::rdm::GetResponseFromData(
+        request, reinterpret_cast<const uint8_t*>(label), sizeof(label) - 1);
+  }
+
+  RDMResponse *GetValue(const RDMRequest *request) {
+    static const uint8_t value[] = {0, 0, 0, 1};
+    return ola::rdm::GetResponseFromData(request, value, sizeof(value));
+  }
+
+  static const ResponderOps<BenchmarkResponder>::ParamHandler
+      PARAM_HANDLERS[];
+};
+
+const ResponderOps<BenchmarkResponder>::ParamHandler
+    BenchmarkResponder::PARAM_HANDLERS[] = {
+  { ola::rdm::PID_DEVICE_MODEL_DESCRIPTION, &BenchmarkResponder::GetLabel,
+    NULL},
+  { ola::rdm::PID_MANUFACTURER_LABEL, &BenchmarkResponder::GetLabel, NULL},
+  { ola::rdm::PID_DEVICE_LABEL, &BenchmarkResponder::GetLabel, NULL},
+  { ola::rdm::PID_SOFTWARE_VERSION_LABEL, &BenchmarkResponder::GetLabel,
+    NULL},
+  { ola::rdm::PID_DMX_PERSONALITY, &BenchmarkResponder::GetValue, NULL},
+  { ola::rdm::PID_DMX_START_ADDRESS, &BenchmarkResponder::GetValue, NULL},
+  { ola::rdm::PID_SLOT_INFO, &BenchmarkResponder::GetValue, NULL},
+  { ola::rdm::PID_SENSOR_VALUE, &BenchmarkResponder::GetValue, NULL},
+  { ola::rdm::PID_DEVICE_HOURS, &BenchmarkResponder::GetValue, NULL},
+  { ola::rdm::PID_LAMP_HOURS, &BenchmarkResponder::GetValue, NULL},
+  { ola::rdm::PID_LAMP_STRIKES, &BenchmarkResponder::GetValue, NULL},
+  { ola::rdm::PID_LAMP_STATE, &BenchmarkResponder::GetValue, NULL},
+  { ola::rdm::PID_DEVICE_POWER_CYCLES, &BenchmarkResponder::GetValue, NULL},
+  { ola::rdm::PID_DISPLAY_INVERT, &BenchmarkResponder::GetValue, NULL},
+  { ola::rdm::PID_DISPLAY_LEVEL, &BenchmarkResponder::GetValue, NULL},
+  { ola::rdm::PID_PAN_INVERT, &BenchmarkResponder::GetValue, NULL},
+  { ola::rdm::PID_TILT_INVERT, &BenchmarkResponder::GetValue, NULL},
+  { ola::rdm::PID_PAN_TILT_SWAP, &BenchmarkResponder::GetValue, NULL},
+  { ola::rdm::PID_IDENTIFY_DEVICE, &BenchmarkResponder::GetValue, NULL},
+  { ola::rdm::PID_POWER_STATE, &BenchmarkResponder::GetValue, NULL},
+  { 0, NULL, NULL},
+};
+
+/*
+ * The PIDs a controller polls most often.
+ */
+const uint16_t POLLED_PIDS[] = {
+  ola::rdm::PID_DEVICE_LABEL,
+  ola::rdm::PID_DMX_START_ADDRESS,
+  ola::rdm::PID_DMX_PERSONALITY,
+  ola::rdm::PID_SOFTWARE_VERSION_LABEL,
+  ola::rdm::PID_IDENTIFY_DEVICE,
+  ola::rdm::PID_MANUFACTURER_LABEL,
+  ola::rdm::PID_DEVICE_MODEL_DESCRIPTION,
+  ola::rdm::PID_DEVICE_HOURS,
+};
+
+void CountReply(unsigned int *acks, RDMReply *reply) {
+  if (reply->StatusCode() == ola::rdm::RDM_COMPLETED_OK && reply->Response() &&
+      reply->Response()->ResponseType() == ola::rdm::RDM_ACK) {
+    (*acks)++;
+  }
+}
+
+/*
+ * Build a run's worth of GETs, outside of the timed section.
+ */
+void BuildRequests(const UID &source, const UID &destination,
+                   vector<RDMRequest*> *requests) {
+  const unsigned int pid_count = sizeof(POLLED_PIDS) / sizeof(POLLED_PIDS[0]);
+  requests->reserve(FLAGS_gets);
+  for (unsigned int i = 0; i < FLAGS_gets; i++) {
+    requests->push_back(new RDMGetRequest(
+        source, destination, i & 0xff, 1, ola::rdm::ROOT_RDM_DEVICE,
+        POLLED_PIDS[i % pid_count], NULL, 0));
+  }
+}
+
+void Report(const string &name, unsigned int acks) {
+  if (acks != FLAGS_gets * FLAGS_iterations) {
+    cout << name << ": " << acks << " of " << FLAGS_gets * FLAGS_iterations
+         << " GETs were ACKed" << endl;
+  }
+}
+}  // namespace
+
+
+void BenchmarkResponderOps(const UID &source, const UID &destination) {
+  Timer single("ResponderOps HandleRDMRequest");
+  Timer batch("ResponderOps HandleRDMRequests");
+  BenchmarkResponder responder;
+  unsigned int single_acks = 0;
+  unsigned int batch_acks = 0;
+
+  for (unsigned int run = 0; run < FLAGS_iterations; run++) {
+    vector<RDMRequest*> requests;
+    BuildRequests(source, destination, &requests);
+    single.Start();
+    vector<RDMRequest*>::const_iterator iter = requests.begin();
+    for (; iter != requests.end(); ++iter) {
+      responder.HandleRDMRequest(destination, *iter,
+                                 NewSingleCallback(&CountReply, &single_acks));
+    }
+    single.Stop();
+
+    requests.clear();
+    BuildRequests(source, destination, &requests);
+    vector<const RDMRequest*> batch_requests(requests.begin(), requests.end());
+    vector<RDMReply*> replies;
+    batch.Start();
+    responder.HandleRDMRequests(destination, batch_requests, &replies);
+    batch.Stop();
+
+    vector<RDMReply*>::iterator reply_iter = replies.begin();
+    for (; reply_iter != replies.end(); ++reply_iter) {
+      CountReply(&batch_acks, *reply_iter);
+    }
+    ola::STLDeleteElements(&replies);
+  }
+
+  single.Print();
+  batch.Print();
+  Report("HandleRDMRequest", single_acks);
+  Report("HandleRDMRequests", batch_acks);
+}
+
+
+void BenchmarkMovingLight(const UID &source, const UID &destination) {
+  Timer timer("MovingLightResponder SendRDMRequest");
+  MovingLightResponder responder(destination);
+  unsigned int acks = 0;
+
+  for (unsigned int run = 0; run < FLAGS_iterations; run++) {
+    vector<RDMRequest*> requests;
+    BuildRequests(source, destination, &requests);
+    timer.Start();
+    vector<RDMRequest*>::const_iterator iter = requests.begin();
+    for (; iter != requests.end(); ++iter) {
+      responder.SendRDMRequest(*iter,
+                               NewSingleCallback(&CountReply, &acks));
+    }
+    timer.Stop();
+  }
+
+  timer.Print();
+  Report("MovingLightResponder", acks);
+}
+
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "",
+               "Time GETs dispatched through ResponderOps.");
+
+  UID source(0x7a70, 1);
+  UID destination(0x7a70, 2);
+  cout << FLAGS_gets << " GETs, averaged over " << FLAGS_iterations
+       << " runs" << endl;
+  BenchmarkResponderOps(source, destination);
+  BenchmarkMovingLight(source, destination);
+  return 0;
+}
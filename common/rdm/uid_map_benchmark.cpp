@@ -0,0 +1,389 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * uid_map_benchmark.cpp
+ * Compares a UIDMap and UIDSet with a std::map and std::set for the operations
+ * olad does on the UIDs from discovery.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ola/Clock.h"
+#include "ola/base/Flags.h"
+#include "ola/base/Init.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDMap.h"
+#include "ola/rdm/UIDSet.h"
+
+using ola::Clock;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::rdm::UID;
+using ola::rdm::UIDMap;
+using ola::rdm::UIDSet;
+using std::cout;
+using std::endl;
+using std::map;
+using std::set;
+using std::string;
+using std::vector;
+
+DEFINE_s_uint32(uids, u, 10000, "The number of UIDs to use");
+DEFINE_s_uint32(iterations, i, 10, "The number of times to run each test");
+
+typedef map<UID, unsigned int> StdUIDMap;
+typedef set<UID> StdUIDSet;
+
+namespace {
+class IsOdd {
+ public:
+  bool operator()(const UIDMap<unsigned int>::Entry &entry) const {
+    return entry.value % 2;
+  }
+};
+
+/*
+ * Times a test and prints the average run time.
+ */
+class Timer {
+ public:
+  explicit Timer(const string &name)
+      : m_name(name),
+        m_runs(0) {
+  }
+
+  void Start() { m_clock.CurrentMonotonicTime(&m_start); }
+
+  void Stop() {
+    TimeStamp end;
+    m_clock.CurrentMonotonicTime(&end);
+    m_total += end - m_start;
+    m_runs++;
+  }
+
+  void Print() const {
+    cout << std::left << std::setw(40) << m_name << std::right
+         << std::setw(10) << (m_runs ? m_total.AsInt() / m_runs : 0) << " us"
+         << endl;
+  }
+
+ private:
+  const string m_name;
+  Clock m_clock;
+  TimeStamp m_start;
+  TimeInterval m_total;
+  unsigned int m_runs;
+};
+
+/*
+ * Shuffle the UIDs, with a fixed seed so each run does the same work.
+ */
+void Shuffle(vector<UID> *uids) {
+  uint32_t seed = 1;
+  for (unsigned int i = uids->size(); i > 1; i--) {
+    seed = seed * 1103515245 + 12345;
+    std::swap((*uids)[i - 1], (*uids)[(seed >> 16) % i]);
+  }
+}
+}  // namespace
+
+
+void BenchmarkStdMap(const vector<UID> &ordered, const vector<UID> &shuffled,
+                     const UIDSet &uid_set) {
+  Timer in_order("std::map insert in order");
+  Timer random_order("std::map insert in random order");
+  Timer merge("std::map add a UIDSet");
+  Timer lookup("std::map lookup");
+  Timer iterate("std::map iterate");
+  Timer remove("std::map remove half");
+  unsigned int found = 0;
+
+  for (unsigned int run = 0; run < FLAGS_iterations; run++) {
+    StdUIDMap uid_map;
+    in_order.Start();
+    for (unsigned int i = 0; i < ordered.size(); i++) {
+      uid_map[ordered[i]] = i;
+    }
+    in_order.Stop();
+
+    StdUIDMap random_map;
+    random_order.Start();
+    for (unsigned int i = 0; i < shuffled.size(); i++) {
+      random_map[shuffled[i]] = i;
+    }
+    random_order.Stop();
+
+    StdUIDMap merged_map;
+    merge.Start();
+    UIDSet::Iterator set_iter = uid_set.Begin();
+    for (; set_iter != uid_set.End(); ++set_iter) {
+      if (merged_map.find(*set_iter) == merged_map.end()) {
+        merged_map[*set_iter] = 0;
+      }
+    }
+    merge.Stop();
+
+    lookup.Start();
+    for (unsigned int i = 0; i < shuffled.size(); i++) {
+      found += uid_map.find(shuffled[i]) != uid_map.end();
+    }
+    lookup.Stop();
+
+    iterate.Start();
+    UIDSet uids;
+    StdUIDMap::const_iterator iter = uid_map.begin();
+    for (; iter != uid_map.end(); ++iter) {
+      uids.AddUID(iter->first);
+    }
+    iterate.Stop();
+
+    remove.Start();
+    StdUIDMap::iterator remove_iter = uid_map.begin();
+    while (remove_iter != uid_map.end()) {
+      if (remove_iter->second % 2) {
+        uid_map.erase(remove_iter++);
+      } else {
+        ++remove_iter;
+      }
+    }
+    remove.Stop();
+  }
+
+  in_order.Print();
+  random_order.Print();
+  merge.Print();
+  lookup.Print();
+  iterate.Print();
+  remove.Print();
+  if (found != ordered.size() * FLAGS_iterations) {
+    cout << "std::map lookups failed" << endl;
+  }
+}
+
+
+void BenchmarkUIDMap(const vector<UID> &ordered, const vector<UID> &shuffled,
+                     const UIDSet &uid_set) {
+  Timer in_order("UIDMap insert in order");
+  Timer random_order("UIDMap insert in random order");
+  Timer merge("UIDMap add a UIDSet");
+  Timer lookup("UIDMap lookup");
+  Timer iterate("UIDMap iterate");
+  Timer remove("UIDMap remove half");
+  unsigned int found = 0;
+
+  for (unsigned int run = 0; run < FLAGS_iterations; run++) {
+    UIDMap<unsigned int> uid_map;
+    in_order.Start();
+    for (unsigned int i = 0; i < ordered.size(); i++) {
+      uid_map.Set(ordered[i], i);
+    }
+    in_order.Stop();
+
+    UIDMap<unsigned int> random_map;
+    random_order.Start();
+    for (unsigned int i = 0; i < shuffled.size(); i++) {
+      random_map.Set(shuffled[i], i);
+    }
+    random_order.Stop();
+
+    UIDMap<unsigned int> merged_map;
+    merge.Start();
+    merged_map.AddUIDs(uid_set, 0);
+    merge.Stop();
+
+    lookup.Start();
+    for (unsigned int i = 0; i < shuffled.size(); i++) {
+      found += uid_map.Contains(shuffled[i]);
+    }
+    lookup.Stop();
+
+    iterate.Start();
+    UIDSet uids;
+    uid_map.GetUIDs(&uids);
+    iterate.Stop();
+
+    remove.Start();
+    uid_map.RemoveIf(IsOdd());
+    remove.Stop();
+  }
+
+  in_order.Print();
+  random_order.Print();
+  merge.Print();
+  lookup.Print();
+  iterate.Print();
+  remove.Print();
+  if (found != ordered.size() * FLAGS_iterations) {
+    cout << "UIDMap lookups failed" << endl;
+  }
+}
+
+
+void BenchmarkStdSet(const vector<UID> &ordered,
+                     const vector<UID> &shuffled) {
+  Timer in_order("std::set insert in order");
+  Timer random_order("std::set insert in random order");
+  Timer lookup("std::set lookup");
+  Timer set_union("std::set union");
+  Timer difference("std::set difference");
+  unsigned int found = 0;
+
+  // every other UID, so the union and difference have work to do
+  StdUIDSet odd_uids;
+  for (unsigned int i = 1; i < ordered.size(); i += 2) {
+    odd_uids.insert(ordered[i]);
+  }
+
+  for (unsigned int run = 0; run < FLAGS_iterations; run++) {
+    StdUIDSet uids;
+    in_order.Start();
+    for (unsigned int i = 0; i < ordered.size(); i++) {
+      uids.insert(ordered[i]);
+    }
+    in_order.Stop();
+
+    StdUIDSet random_uids;
+    random_order.Start();
+    for (unsigned int i = 0; i < shuffled.size(); i++) {
+      random_uids.insert(shuffled[i]);
+    }
+    random_order.Stop();
+
+    lookup.Start();
+    for (unsigned int i = 0; i < shuffled.size(); i++) {
+      found += uids.find(shuffled[i]) != uids.end();
+    }
+    lookup.Stop();
+
+    set_union.Start();
+    StdUIDSet result;
+    std::set_union(uids.begin(), uids.end(), odd_uids.begin(), odd_uids.end(),
+                   std::inserter(result, result.begin()));
+    set_union.Stop();
+
+    difference.Start();
+    StdUIDSet remaining;
+    std::set_difference(uids.begin(), uids.end(),
+                        odd_uids.begin(), odd_uids.end(),
+                        std::inserter(remaining, remaining.begin()));
+    difference.Stop();
+  }
+
+  in_order.Print();
+  random_order.Print();
+  lookup.Print();
+  set_union.Print();
+  difference.Print();
+  if (found != ordered.size() * FLAGS_iterations) {
+    cout << "std::set lookups failed" << endl;
+  }
+}
+
+
+void BenchmarkUIDSet(const vector<UID> &ordered,
+                     const vector<UID> &shuffled) {
+  Timer in_order("UIDSet insert in order");
+  Timer random_order("UIDSet insert in random order");
+  Timer lookup("UIDSet lookup");
+  Timer set_union("UIDSet union");
+  Timer difference("UIDSet difference");
+  unsigned int found = 0;
+
+  UIDSet odd_uids;
+  for (unsigned int i = 1; i < ordered.size(); i += 2) {
+    odd_uids.AddUID(ordered[i]);
+  }
+
+  for (unsigned int run = 0; run < FLAGS_iterations; run++) {
+    UIDSet uids;
+    in_order.Start();
+    for (unsigned int i = 0; i < ordered.size(); i++) {
+      uids.AddUID(ordered[i]);
+    }
+    in_order.Stop();
+
+    UIDSet random_uids;
+    random_order.Start();
+    for (unsigned int i = 0; i < shuffled.size(); i++) {
+      random_uids.AddUID(shuffled[i]);
+    }
+    random_order.Stop();
+
+    lookup.Start();
+    for (unsigned int i = 0; i < shuffled.size(); i++) {
+      found += uids.Contains(shuffled[i]);
+    }
+    lookup.Stop();
+
+    set_union.Start();
+    UIDSet result = uids.Union(odd_uids);
+    set_union.Stop();
+
+    difference.Start();
+    UIDSet remaining = uids.SetDifference(odd_uids);
+    difference.Stop();
+  }
+
+  in_order.Print();
+  random_order.Print();
+  lookup.Print();
+  set_union.Print();
+  difference.Print();
+  if (found != ordered.size() * FLAGS_iterations) {
+    cout << "UIDSet lookups failed" << endl;
+  }
+}
+
+
+/*
+ * Run the benchmarks.
+ */
+int main(int argc, char* argv[]) {
+  ola::AppInit(&argc, argv, "",
+               "Compare the performance of UIDMap and UIDSet with std::map and "
+               "std::set.");
+
+  vector<UID> ordered;
+  UIDSet uid_set;
+  ordered.reserve(FLAGS_uids);
+  for (unsigned int i = 0; i < FLAGS_uids; i++) {
+    // spread the UIDs across a few manufacturers, like a real rig
+    UID uid(0x7a70 + (i % 4), i);
+    ordered.push_back(uid);
+  }
+  std::sort(ordered.begin(), ordered.end());
+  for (unsigned int i = 0; i < ordered.size(); i++) {
+    uid_set.AddUID(ordered[i]);
+  }
+  vector<UID> shuffled(ordered);
+  Shuffle(&shuffled);
+
+  cout << FLAGS_uids << " UIDs, average of " << FLAGS_iterations << " runs"
+       << endl;
+  BenchmarkStdMap(ordered, shuffled, uid_set);
+  BenchmarkUIDMap(ordered, shuffled, uid_set);
+  BenchmarkStdSet(ordered, shuffled);
+  BenchmarkUIDSet(ordered, shuffled);
+  return 0;
+}
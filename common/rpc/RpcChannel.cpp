@@ -25,6 +25,10 @@
 #include <google/protobuf/message.h>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/dynamic_message.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <algorithm>
 #include <string>
 
 #include "common/rpc/Rpc.pb.h"
@@ -35,7 +39,9 @@
 #include "ola/Callback.h"
 #include "ola/Logging.h"
 #include "ola/base/Array.h"
+#include "ola/io/MemoryBlock.h"
 #include "ola/stl/STLUtils.h"
+#include "ola/strings/Format.h"
 
 namespace ola {
 namespace rpc {
@@ -43,9 +49,19 @@ namespace rpc {
 using google::protobuf::Message;
 using google::protobuf::MethodDescriptor;
 using google::protobuf::ServiceDescriptor;
+using google::protobuf::internal::WireFormatLite;
+using google::protobuf::io::CodedOutputStream;
+using ola::io::IOQueue;
+using ola::io::MemoryBlock;
+using ola::io::MemoryBlockPool;
 using std::auto_ptr;
 using std::string;
 
+const char RpcChannel::K_RPC_CHANNEL_COALESCED_VAR[] =
+    "rpc-channel-coalesced";
+const char RpcChannel::K_RPC_CHANNEL_QUEUE_DEPTH_VAR[] =
+    "rpc-channel-queue-depth";
+const char RpcChannel::K_RPC_COALESCED_VAR[] = "rpc-coalesced";
 const char RpcChannel::K_RPC_RECEIVED_TYPE_VAR[] = "rpc-received-type";
 const char RpcChannel::K_RPC_RECEIVED_VAR[] = "rpc-received";
 const char RpcChannel::K_RPC_SENT_ERROR_VAR[] = "rpc-send-errors";
@@ -53,11 +69,87 @@ const char RpcChannel::K_RPC_SENT_VAR[] = "rpc-sent";
 const char RpcChannel::STREAMING_NO_RESPONSE[] = "STREAMING_NO_RESPONSE";
 
 const char *RpcChannel::K_RPC_VARIABLES[] = {
+  K_RPC_COALESCED_VAR,
   K_RPC_RECEIVED_VAR,
   K_RPC_SENT_ERROR_VAR,
   K_RPC_SENT_VAR,
 };
 
+namespace {
+
+/*
+ * Return the serialized size of a message. ByteSize() is deprecated from
+ * protobuf 3.1 onwards, since the int it returns can overflow.
+ */
+size_t MessageSize(const Message &message) {
+#if GOOGLE_PROTOBUF_VERSION < 3001000
+  return message.ByteSize();
+#else
+  return message.ByteSizeLong();
+#endif  // GOOGLE_PROTOBUF_VERSION < 3001000
+}
+
+/*
+ * A ZeroCopyOutputStream that writes into MemoryBlocks and appends them to an
+ * IOQueue. This lets protobuf serialize straight into the memory we pass to
+ * writev().
+ */
+class IOQueueOutputStream
+    : public google::protobuf::io::ZeroCopyOutputStream {
+ public:
+  IOQueueOutputStream(IOQueue *output, MemoryBlockPool *pool)
+      : m_output(output),
+        m_pool(pool),
+        m_block(NULL),
+        m_byte_count(0) {
+  }
+
+  ~IOQueueOutputStream() {
+    AppendCurrentBlock();
+  }
+
+  bool Next(void **data, int *size) {
+    AppendCurrentBlock();
+    m_block = m_pool->Allocate();
+    if (!m_block) {
+      return false;
+    }
+    // Blocks may be returned to the pool with stale data, this resets them.
+    m_block->PopFront(m_block->Size());
+    *data = m_block->Data();
+    *size = m_block->Extend(m_block->Remaining());
+    m_byte_count += *size;
+    return true;
+  }
+
+  void BackUp(int count) {
+    if (m_block) {
+      m_byte_count -= m_block->PopBack(count);
+    }
+  }
+
+  google::protobuf::int64 ByteCount() const { return m_byte_count; }
+
+ private:
+  IOQueue *m_output;
+  MemoryBlockPool *m_pool;
+  MemoryBlock *m_block;
+  google::protobuf::int64 m_byte_count;
+
+  void AppendCurrentBlock() {
+    if (!m_block) {
+      return;
+    }
+    if (m_block->Empty()) {
+      m_pool->Release(m_block);
+    } else {
+      m_output->AppendBlock(m_block);
+    }
+    m_block = NULL;
+  }
+};
+}  // namespace
+
 class OutstandingRequest {
   /*
    * These are requests on the server end that haven't completed yet.
@@ -118,7 +210,15 @@ RpcChannel::RpcChannel(
       m_expected_size(0),
       m_current_size(0),
       m_export_map(export_map),
-      m_recv_type_map(NULL) {
+      m_recv_type_map(NULL),
+      m_queue_depth_map(NULL),
+      m_coalesced_map(NULL),
+      m_recv_message(new RpcMessage()),
+      m_ss(NULL),
+      m_max_queued_messages(0),
+      m_write_registered(false),
+      m_output(&m_block_pool),
+      m_coalesced_count(0) {
   if (descriptor) {
     descriptor->SetOnData(
         ola::NewCallback(this, &RpcChannel::DescriptorReady));
@@ -136,6 +236,16 @@ RpcChannel::RpcChannel(
 }
 
 RpcChannel::~RpcChannel() {
+  StopWriting();
+  if (m_ss && m_descriptor) {
+    m_descriptor->SetOnWritable(NULL);
+  }
+  if (m_queue_depth_map) {
+    m_queue_depth_map->Remove(m_channel_key);
+    m_coalesced_map->Remove(m_channel_key);
+  }
+  STLDeleteElements(&m_send_queue);
+  STLDeleteValues(&m_stream_requests);
   free(m_buffer);
 }
 
@@ -202,22 +312,42 @@ void RpcChannel::SetChannelCloseHandler(CloseCallback *callback) {
   m_on_close.reset(callback);
 }
 
+void RpcChannel::EnableSendQueue(ola::io::SelectServerInterface *ss,
+                                 unsigned int max_queued_messages) {
+  if (!m_descriptor) {
+    return;
+  }
+  m_ss = ss;
+  m_max_queued_messages = max_queued_messages;
+  m_descriptor->SetOnWritable(
+      ola::NewCallback(this, &RpcChannel::PerformWrite));
+
+  if (m_export_map) {
+    m_channel_key = ola::strings::IntToString(
+        ola::io::ToFD(m_descriptor->WriteDescriptor()));
+    m_queue_depth_map = m_export_map->GetUIntMapVar(
+        K_RPC_CHANNEL_QUEUE_DEPTH_VAR, "channel");
+    m_coalesced_map = m_export_map->GetUIntMapVar(
+        K_RPC_CHANNEL_COALESCED_VAR, "channel");
+    UpdateQueueVariables();
+  }
+}
+
 void RpcChannel::CallMethod(const MethodDescriptor *method,
                             RpcController *controller,
                             const Message *request,
                             Message *reply,
                             SingleUseCallback0<void> *done) {
-  // TODO(simonn): reduce the number of copies here
-  string output;
   RpcMessage message;
   bool is_streaming = false;
 
   // Streaming methods are those with a reply set to STREAMING_NO_RESPONSE and
-  // no controller, request or closure provided
+  // no reply or closure provided. The controller is optional, it's only used
+  // to coalesce queued messages.
   if (method->output_type()->name() == STREAMING_NO_RESPONSE) {
-    if (controller || reply || done) {
+    if (reply || done) {
       OLA_FATAL << "Calling streaming method " << method->name() <<
-        " but a controller, reply or closure in non-NULL";
+        " but a reply or closure in non-NULL";
       return;
     }
     is_streaming = true;
@@ -227,9 +357,7 @@ void RpcChannel::CallMethod(const MethodDescriptor *method,
   message.set_id(m_sequence.Next());
   message.set_name(method->name());
 
-  request->SerializeToString(&output);
-  message.set_buffer(output);
-  bool r = SendMsg(&message);
+  bool r = SendMsg(message, request, controller);
 
   if (is_streaming)
     return;
@@ -257,7 +385,6 @@ void RpcChannel::CallMethod(const MethodDescriptor *method,
 }
 
 void RpcChannel::RequestComplete(OutstandingRequest *request) {
-  string output;
   RpcMessage message;
 
   if (request->controller->Failed()) {
@@ -267,9 +394,7 @@ void RpcChannel::RequestComplete(OutstandingRequest *request) {
 
   message.set_type(RESPONSE);
   message.set_id(request->id);
-  request->response->SerializeToString(&output);
-  message.set_buffer(output);
-  SendMsg(&message);
+  SendMsg(message, request->response);
   DeleteOutstandingRequest(request);
 }
 
@@ -281,50 +406,250 @@ RpcSession *RpcChannel::Session() {
 //-----------------------------------------------------------------------------
 
 /*
- * Write an RpcMessage to the write descriptor.
+ * Write an RpcMessage to the write descriptor. If payload is not NULL, it's
+ * serialized as the buffer field of the message.
  */
-bool RpcChannel::SendMsg(RpcMessage *msg) {
+bool RpcChannel::SendMsg(const RpcMessage &msg, const Message *payload,
+                         const RpcController *controller) {
   if (!(m_descriptor && m_descriptor->ValidReadDescriptor())) {
     OLA_WARN << "RPC descriptor closed, not sending messages";
     return false;
   }
 
-  uint32_t header;
-  // reserve the first 4 bytes for the header
-  string output(sizeof(header), 0);
-  msg->AppendToString(&output);
-  int length = output.size();
+  if (m_ss && (m_write_registered || !m_send_queue.empty())) {
+    // Other messages are waiting, keep them in order.
+    return QueueMsg(msg, payload, controller);
+  }
 
-  RpcHeader::EncodeHeader(&header, PROTOCOL_VERSION,
-                                length - sizeof(header));
-  output.replace(
-      0, sizeof(header),
-      reinterpret_cast<const char*>(&header), sizeof(header));
+  if (!FrameMsg(msg, payload, &m_output)) {
+    OLA_WARN << "Failed to serialize RPC message";
+    m_output.Clear();
+    return false;
+  }
 
-  ssize_t ret = m_descriptor->Send(
-      reinterpret_cast<const uint8_t*>(output.data()), length);
+  ssize_t ret = SendOutput();
 
-  if (ret != length) {
-    OLA_WARN << "Failed to send full RPC message, closing channel";
+  if (!m_output.Empty()) {
+    if (m_ss && (ret >= 0 || errno == EAGAIN || errno == EWOULDBLOCK)) {
+      // The peer is behind, hold on to the remainder until the descriptor
+      // is writable.
+      m_ss->AddWriteDescriptor(m_descriptor);
+      m_write_registered = true;
+    } else {
+      OLA_WARN << "Failed to send full RPC message, closing channel";
+      SendFailed();
+      return false;
+    }
+  }
 
-    if (m_export_map) {
-      (*m_export_map->GetCounterVar(K_RPC_SENT_ERROR_VAR))++;
+  if (m_export_map) {
+    (*m_export_map->GetCounterVar(K_RPC_SENT_VAR))++;
+  }
+  return true;
+}
+
+/*
+ * Serialize a message, including the RPC header, to the end of an IOQueue.
+ *
+ * The payload is written directly as the buffer field, rather than being
+ * serialized to a string first.
+ */
+bool RpcChannel::FrameMsg(const RpcMessage &msg, const Message *payload,
+                          IOQueue *output) {
+  // This also caches the sizes used by SerializeWithCachedSizes().
+  size_t size = MessageSize(msg);
+  uint32_t payload_tag = WireFormatLite::MakeTag(
+      RpcMessage::kBufferFieldNumber,
+      WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  size_t payload_size = 0;
+  if (payload) {
+    payload_size = MessageSize(*payload);
+    size += (CodedOutputStream::VarintSize32(payload_tag) +
+             CodedOutputStream::VarintSize64(payload_size) +
+             payload_size);
+  }
+
+  // The other end drops anything larger than this, and the size has to fit
+  // in the header.
+  if (size > MAX_BUFFER_SIZE) {
+    OLA_WARN << "RPC message of " << size
+             << " bytes is larger than MAX_BUFFER_SIZE: " << MAX_BUFFER_SIZE;
+    return false;
+  }
+
+  uint32_t header;
+  RpcHeader::EncodeHeader(&header, PROTOCOL_VERSION,
+                          static_cast<unsigned int>(size));
+
+  IOQueueOutputStream stream(output, &m_block_pool);
+  CodedOutputStream coded_output(&stream);
+  coded_output.WriteRaw(&header, sizeof(header));
+  msg.SerializeWithCachedSizes(&coded_output);
+  if (payload) {
+    coded_output.WriteTag(payload_tag);
+    coded_output.WriteVarint32(static_cast<uint32_t>(payload_size));
+    payload->SerializeWithCachedSizes(&coded_output);
+  }
+  return !coded_output.HadError();
+}
+
+/*
+ * Frame a message onto the send queue, replacing a queued request if this
+ * one can be coalesced.
+ */
+bool RpcChannel::QueueMsg(const RpcMessage &msg, const Message *payload,
+                          const RpcController *controller) {
+  bool coalesce = ((msg.type() == REQUEST || msg.type() == STREAM_REQUEST) &&
+                   controller && controller->HasCoalesceKey());
+
+  if (coalesce) {
+    SendQueue::iterator iter = m_send_queue.begin();
+    for (; iter != m_send_queue.end(); ++iter) {
+      QueuedMessage *queued = *iter;
+      if (queued->coalesce_key == controller->CoalesceKey() &&
+          queued->method == msg.name()) {
+        int superseded_id = queued->id;
+        queued->data.Clear();
+        if (!FrameMsg(msg, payload, &queued->data)) {
+          OLA_WARN << "Failed to serialize RPC message";
+          m_send_queue.erase(iter);
+          delete queued;
+          SupersedeRequest(superseded_id);
+          return false;
+        }
+        queued->id = msg.id();
+        m_coalesced_count++;
+        if (m_export_map) {
+          (*m_export_map->GetCounterVar(K_RPC_COALESCED_VAR))++;
+        }
+        UpdateQueueVariables();
+        SupersedeRequest(superseded_id);
+        return true;
+      }
     }
+  }
 
-    // At this point there is no point using the descriptor since framing has
-    // probably been messed up.
-    // TODO(simon): consider if it's worth leaving the descriptor open for
-    // reading.
-    m_descriptor = NULL;
+  if (m_send_queue.size() >= m_max_queued_messages) {
+    OLA_WARN << "RPC send queue is full (" << m_send_queue.size()
+             << " messages), closing channel";
+    SendFailed();
+    return false;
+  }
 
-    HandleChannelClose();
+  auto_ptr<QueuedMessage> queued(new QueuedMessage(&m_block_pool));
+  if (!FrameMsg(msg, payload, &queued->data)) {
+    OLA_WARN << "Failed to serialize RPC message";
     return false;
   }
+  queued->id = msg.id();
+  if (coalesce) {
+    queued->method = msg.name();
+    queued->coalesce_key = controller->CoalesceKey();
+  }
+  m_send_queue.push_back(queued.release());
+  UpdateQueueVariables();
+  return true;
+}
+
+/*
+ * Fail a request that was replaced in the send queue.
+ */
+void RpcChannel::SupersedeRequest(int id) {
+  OutstandingResponse *response = STLLookupAndRemovePtr(&m_responses, id);
+  if (response) {
+    response->controller->SetFailed("Superseded");
+    response->callback->Run();
+    delete response;
+  }
+}
 
+/*
+ * Called when the descriptor is writable.
+ */
+void RpcChannel::PerformWrite() {
+  if (!m_descriptor) {
+    return;
+  }
+
+  if (m_output.Empty()) {
+    // Frame everything that's queued so it goes out in as few writes as
+    // possible.
+    SendQueue::iterator iter = m_send_queue.begin();
+    for (; iter != m_send_queue.end(); ++iter) {
+      m_output.AppendMove(&(*iter)->data);
+      if (m_export_map) {
+        (*m_export_map->GetCounterVar(K_RPC_SENT_VAR))++;
+      }
+    }
+    STLDeleteElements(&m_send_queue);
+    UpdateQueueVariables();
+  }
+
+  if (!m_output.Empty()) {
+    ssize_t ret = SendOutput();
+    if (ret < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+      OLA_WARN << "Failed to send queued RPC messages, closing channel";
+      SendFailed();
+      return;
+    }
+  }
+
+  if (m_output.Empty() && m_send_queue.empty()) {
+    StopWriting();
+  }
+}
+
+/*
+ * Write as much of m_output as the descriptor will take. Each Send() call
+ * writes at most IOV_MAX blocks, so keep going while we're making progress.
+ */
+ssize_t RpcChannel::SendOutput() {
+  ssize_t ret;
+  do {
+    ret = m_descriptor->Send(&m_output);
+  } while (ret > 0 && !m_output.Empty());
+  return ret;
+}
+
+/*
+ * Update the per-channel queue variables.
+ */
+void RpcChannel::UpdateQueueVariables() {
+  if (m_queue_depth_map) {
+    (*m_queue_depth_map)[m_channel_key] = m_send_queue.size();
+    (*m_coalesced_map)[m_channel_key] = m_coalesced_count;
+  }
+}
+
+void RpcChannel::StopWriting() {
+  if (m_write_registered) {
+    m_ss->RemoveWriteDescriptor(m_descriptor);
+    m_write_registered = false;
+  }
+}
+
+/*
+ * Called if we fail to write to the descriptor.
+ */
+void RpcChannel::SendFailed() {
   if (m_export_map) {
-    (*m_export_map->GetCounterVar(K_RPC_SENT_VAR))++;
+    (*m_export_map->GetCounterVar(K_RPC_SENT_ERROR_VAR))++;
   }
-  return true;
+
+  // At this point there is no point using the descriptor since framing has
+  // probably been messed up.
+  // TODO(simon): consider if it's worth leaving the descriptor open for
+  // reading.
+  StopWriting();
+  if (m_ss) {
+    m_descriptor->SetOnWritable(NULL);
+  }
+  m_descriptor = NULL;
+  m_output.Clear();
+  STLDeleteElements(&m_send_queue);
+  UpdateQueueVariables();
+
+  HandleChannelClose();
 }
 
 
@@ -387,7 +712,7 @@ int RpcChannel::ReadHeader(unsigned int *version,
  * Parse a new message and handle it.
  */
 bool RpcChannel::HandleNewMsg(uint8_t *data, unsigned int size) {
-  RpcMessage msg;
+  RpcMessage &msg = *m_recv_message;
   if (!msg.ParseFromArray(data, size)) {
     OLA_WARN << "Failed to parse RPC";
     return false;
@@ -513,11 +838,16 @@ void RpcChannel::HandleStreamRequest(RpcMessage *msg) {
     return;
   }
 
-  Message* request_pb = m_service->GetRequestPrototype(method).New();
-
+  // Streaming requests are usually sent at a high rate, so the request
+  // message is reused.
+  Message *request_pb = STLFindOrNull(m_stream_requests, method);
   if (!request_pb) {
-    OLA_WARN << "failed to get request or response objects";
-    return;
+    request_pb = m_service->GetRequestPrototype(method).New();
+    if (!request_pb) {
+      OLA_WARN << "failed to get request or response objects";
+      return;
+    }
+    m_stream_requests[method] = request_pb;
   }
 
   if (!request_pb->ParseFromString(msg->buffer())) {
@@ -527,7 +857,6 @@ void RpcChannel::HandleStreamRequest(RpcMessage *msg) {
 
   RpcController controller(m_session.get());
   m_service->CallMethod(method, &controller, request_pb, NULL, NULL);
-  delete request_pb;
 }
 
 
@@ -540,7 +869,7 @@ void RpcChannel::SendRequestFailed(OutstandingRequest *request) {
   message.set_type(RESPONSE_FAILED);
   message.set_id(request->id);
   message.set_buffer(request->controller->ErrorText());
-  SendMsg(&message);
+  SendMsg(message);
   DeleteOutstandingRequest(request);
 }
 
@@ -552,7 +881,7 @@ void RpcChannel::SendNotImplemented(int msg_id) {
   RpcMessage message;
   message.set_type(RESPONSE_NOT_IMPLEMENTED);
   message.set_id(msg_id);
-  SendMsg(&message);
+  SendMsg(message);
 }
 
 
@@ -625,6 +954,7 @@ void RpcChannel::HandleNotImplemented(RpcMessage *msg) {
  * Invoke the Channel close handler/
  */
 void RpcChannel::HandleChannelClose() {
+  StopWriting();
   if (m_on_close.get()) {
     m_on_close.release()->Run(m_session.get());
   }
@@ -29,8 +29,14 @@
 #include <google/protobuf/service.h>
 #include <ola/Callback.h>
 #include <ola/io/Descriptor.h>
+#include <ola/io/IOQueue.h>
+#include <ola/io/MemoryBlockPool.h>
+#include <ola/io/SelectServerInterface.h>
 #include <ola/util/SequenceNumber.h>
+#include <deque>
+#include <map>
 #include <memory>
+#include <string>
 
 #include "ola/ExportMap.h"
 
@@ -39,6 +45,7 @@
 namespace ola {
 namespace rpc {
 
+class RpcController;
 class RpcMessage;
 class RpcService;
 
@@ -108,6 +115,37 @@ class RpcChannel {
      */
     void SetChannelCloseHandler(CloseCallback *callback);
 
+    /**
+     * @brief Queue outgoing messages when the descriptor can't accept them,
+     * rather than closing the channel.
+     * @param ss the SelectServer to use to register for on-write events.
+     *   Ownership is not transferred.
+     * @param max_queued_messages the maximum number of messages to queue.
+     *   Once this is reached the peer is too far behind and the channel is
+     *   closed.
+     *
+     * While messages are queued, a request with a coalesce key set on its
+     * RpcController replaces any queued request for the same method and key.
+     * The replaced request fails with "Superseded".
+     *
+     * If the channel has an ExportMap, the queue depth and coalesced count are
+     * exported per channel, keyed by the descriptor's file descriptor.
+     */
+    void EnableSendQueue(
+        ola::io::SelectServerInterface *ss,
+        unsigned int max_queued_messages = DEFAULT_MAX_QUEUED_MESSAGES);
+
+    /**
+     * @brief The number of messages waiting to be sent.
+     */
+    unsigned int QueueDepth() const { return m_send_queue.size(); }
+
+    /**
+     * @brief The number of requests that were replaced by a later request
+     * before they were sent.
+     */
+    unsigned int CoalescedCount() const { return m_coalesced_count; }
+
     /**
      * @brief Invoke an RPC method on this channel.
      */
@@ -135,10 +173,32 @@ class RpcChannel {
      */
     static const unsigned int PROTOCOL_VERSION = 1;
 
+    /**
+     * @brief The default limit for EnableSendQueue().
+     */
+    static const unsigned int DEFAULT_MAX_QUEUED_MESSAGES = 1000;
+
  private:
     typedef HASH_NAMESPACE::HASH_MAP_CLASS<int, class OutstandingResponse*>
       ResponseMap;
 
+    // A framed message that's waiting to be sent.
+    struct QueuedMessage {
+      explicit QueuedMessage(ola::io::MemoryBlockPool *pool)
+          : data(pool),
+            id(0),
+            coalesce_key(0) {
+      }
+
+      ola::io::IOQueue data;
+      int id;
+      std::string method;  // set if this message can be coalesced
+      int coalesce_key;
+    };
+    typedef std::deque<QueuedMessage*> SendQueue;
+    typedef std::map<const google::protobuf::MethodDescriptor*,
+                     google::protobuf::Message*> StreamRequestMap;
+
     std::auto_ptr<RpcSession> m_session;
     RpcService *m_service;  // service to dispatch requests to
     std::auto_ptr<CloseCallback> m_on_close;
@@ -153,8 +213,41 @@ class RpcChannel {
     ResponseMap m_responses;
     ExportMap *m_export_map;
     UIntMap *m_recv_type_map;
+    // Per-channel send queue variables, keyed by m_channel_key.
+    UIntMap *m_queue_depth_map;
+    UIntMap *m_coalesced_map;
+    std::string m_channel_key;
+    // Reused for each incoming message & streaming request to avoid
+    // allocations.
+    std::auto_ptr<RpcMessage> m_recv_message;
+    StreamRequestMap m_stream_requests;
+
+    // Outgoing messages are serialized directly into blocks from this pool.
+    ola::io::MemoryBlockPool m_block_pool;
+
+    // The send queue, only used if EnableSendQueue() was called.
+    ola::io::SelectServerInterface *m_ss;
+    unsigned int m_max_queued_messages;
+    bool m_write_registered;
+    ola::io::IOQueue m_output;  // data that's been framed but not written
+    SendQueue m_send_queue;
+    unsigned int m_coalesced_count;
 
-    bool SendMsg(RpcMessage *msg);
+    bool SendMsg(const RpcMessage &msg,
+                 const google::protobuf::Message *payload = NULL,
+                 const RpcController *controller = NULL);
+    bool FrameMsg(const RpcMessage &msg,
+                  const google::protobuf::Message *payload,
+                  ola::io::IOQueue *output);
+    bool QueueMsg(const RpcMessage &msg,
+                  const google::protobuf::Message *payload,
+                  const RpcController *controller);
+    void SupersedeRequest(int id);
+    void PerformWrite();
+    ssize_t SendOutput();
+    void UpdateQueueVariables();
+    void StopWriting();
+    void SendFailed();
     int AllocateMsgBuffer(unsigned int size);
     int ReadHeader(unsigned int *version, unsigned int *size) const;
     bool HandleNewMsg(uint8_t *buffer, unsigned int size);
@@ -174,6 +267,9 @@ class RpcChannel {
 
     void HandleChannelClose();
 
+    static const char K_RPC_CHANNEL_COALESCED_VAR[];
+    static const char K_RPC_CHANNEL_QUEUE_DEPTH_VAR[];
+    static const char K_RPC_COALESCED_VAR[];
     static const char K_RPC_RECEIVED_TYPE_VAR[];
     static const char K_RPC_RECEIVED_VAR[];
     static const char K_RPC_SENT_ERROR_VAR[];
@@ -29,13 +29,20 @@
 #include "common/rpc/TestService.pb.h"
 #include "common/rpc/TestServiceService.pb.h"
 #include "ola/Callback.h"
+#include "ola/ExportMap.h"
+#include "ola/io/Descriptor.h"
 #include "ola/io/SelectServer.h"
 #include "ola/network/Socket.h"
+#include "ola/strings/Format.h"
 #include "ola/testing/TestUtils.h"
 
 
+using ola::ExportMap;
 using ola::NewSingleCallback;
+using ola::UIntMap;
+using ola::io::ConnectedDescriptor;
 using ola::io::LoopbackDescriptor;
+using ola::io::PipeDescriptor;
 using ola::io::SelectServer;
 using ola::rpc::EchoReply;
 using ola::rpc::EchoRequest;
@@ -51,20 +58,33 @@ using std::string;
 class RpcChannelTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(RpcChannelTest);
   CPPUNIT_TEST(testEcho);
+  CPPUNIT_TEST(testLargeEcho);
+  CPPUNIT_TEST(testOversizedEcho);
   CPPUNIT_TEST(testFailedEcho);
   CPPUNIT_TEST(testStreamRequest);
+  CPPUNIT_TEST(testSendQueue);
+  CPPUNIT_TEST(testManyQueuedBlocks);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   void setUp();
   void tearDown();
   void testEcho();
+  void testLargeEcho();
+  void testOversizedEcho();
   void testFailedEcho();
   void testStreamRequest();
+  void testSendQueue();
+  void testManyQueuedBlocks();
   void EchoComplete();
   void FailedEchoComplete();
+  void QueuedEchoComplete(RpcController *controller);
 
  private:
+  unsigned int m_requests_sent;
+  unsigned int m_requests_completed;
+  unsigned int m_requests_superseded;
+
   RpcController m_controller;
   EchoRequest m_request;
   EchoReply m_reply;
@@ -80,6 +100,10 @@ class RpcChannelTest: public CppUnit::TestFixture {
 CPPUNIT_TEST_SUITE_REGISTRATION(RpcChannelTest);
 
 void RpcChannelTest::setUp() {
+  m_requests_sent = 0;
+  m_requests_completed = 0;
+  m_requests_superseded = 0;
+
   m_socket.reset(new LoopbackDescriptor());
   m_socket->Init();
 
@@ -104,6 +128,18 @@ void RpcChannelTest::FailedEchoComplete() {
   OLA_ASSERT_TRUE(m_controller.Failed());
 }
 
+void RpcChannelTest::QueuedEchoComplete(RpcController *controller) {
+  if (controller->Failed()) {
+    OLA_ASSERT_EQ(string("Superseded"), controller->ErrorText());
+    m_requests_superseded++;
+  } else {
+    m_requests_completed++;
+  }
+  if (m_requests_completed + m_requests_superseded == m_requests_sent) {
+    m_ss.Terminate();
+  }
+}
+
 /*
  * Check that we can call the echo method in the TestServiceImpl.
  */
@@ -118,6 +154,44 @@ void RpcChannelTest::testEcho() {
   m_ss.Run();
 }
 
+/*
+ * Check that messages that span several memory blocks are framed correctly.
+ */
+void RpcChannelTest::testLargeEcho() {
+  string data;
+  for (unsigned int i = 0; i < 10000; i++) {
+    data.push_back(static_cast<char>('a' + i % 26));
+  }
+  m_request.set_data(data);
+  m_request.set_session_ptr(0);
+  m_stub->Echo(&m_controller,
+               &m_request,
+               &m_reply,
+               NewSingleCallback(this, &RpcChannelTest::EchoComplete));
+
+  m_ss.Run();
+  OLA_ASSERT_EQ(data, m_reply.data());
+}
+
+/*
+ * Check that a request larger than the other end accepts fails without being
+ * sent.
+ */
+void RpcChannelTest::testOversizedEcho() {
+  m_request.set_data(string(2 << 20, 'x'));
+  m_request.set_session_ptr(0);
+  m_stub->Echo(
+      &m_controller,
+      &m_request,
+      &m_reply,
+      NewSingleCallback(this, &RpcChannelTest::FailedEchoComplete));
+  OLA_ASSERT_TRUE(m_controller.Failed());
+
+  // The channel is still usable.
+  m_controller.Reset();
+  testEcho();
+}
+
 /*
  * Check that method that fail return correctly
  */
@@ -139,3 +213,142 @@ void RpcChannelTest::testStreamRequest() {
   m_stub->Stream(NULL, &m_request, NULL, NULL);
   m_ss.Run();
 }
+
+/*
+ * Check that a channel with a send queue holds on to messages the descriptor
+ * can't accept, and coalesces queued requests with the same key.
+ */
+void RpcChannelTest::testSendQueue() {
+  PipeDescriptor pipe;
+  OLA_ASSERT_TRUE(pipe.Init());
+  PipeDescriptor *other_end = pipe.OppositeEnd();
+  OLA_ASSERT_NOT_NULL(other_end);
+  // Writes to a pipe block by default.
+  OLA_ASSERT_TRUE(ConnectedDescriptor::SetNonBlocking(pipe.WriteDescriptor()));
+  OLA_ASSERT_TRUE(
+      ConnectedDescriptor::SetNonBlocking(other_end->WriteDescriptor()));
+
+  RpcChannel client_channel(NULL, &pipe);
+  client_channel.EnableSendQueue(&m_ss);
+  RpcChannel server_channel(m_service.get(), other_end);
+  server_channel.EnableSendQueue(&m_ss);
+  TestService_Stub stub(&client_channel);
+
+  const unsigned int MAX_REQUESTS = 200;
+  RpcController controllers[MAX_REQUESTS];
+  EchoReply replies[MAX_REQUESTS];
+  EchoRequest request;
+  request.set_data(string(2048, 'x'));
+  request.set_session_ptr(0);
+
+  // Send requests until the pipe is full and they start to queue.
+  while (client_channel.QueueDepth() == 0 && m_requests_sent < MAX_REQUESTS) {
+    RpcController *controller = &controllers[m_requests_sent];
+    controller->SetCoalesceKey(1);
+    stub.Echo(controller, &request, &replies[m_requests_sent++],
+              NewSingleCallback(this, &RpcChannelTest::QueuedEchoComplete,
+                                controller));
+  }
+  OLA_ASSERT_EQ(1u, client_channel.QueueDepth());
+  OLA_ASSERT_LT(m_requests_sent, MAX_REQUESTS - 5);
+
+  // Later requests with the same key replace the queued one.
+  for (unsigned int i = 0; i < 5; i++) {
+    RpcController *controller = &controllers[m_requests_sent];
+    controller->SetCoalesceKey(1);
+    stub.Echo(controller, &request, &replies[m_requests_sent++],
+              NewSingleCallback(this, &RpcChannelTest::QueuedEchoComplete,
+                                controller));
+  }
+  OLA_ASSERT_EQ(1u, client_channel.QueueDepth());
+  OLA_ASSERT_EQ(5u, client_channel.CoalescedCount());
+  OLA_ASSERT_EQ(5u, m_requests_superseded);
+
+  // Requests without a key are queued behind it.
+  RpcController *controller = &controllers[m_requests_sent];
+  stub.Echo(controller, &request, &replies[m_requests_sent++],
+            NewSingleCallback(this, &RpcChannelTest::QueuedEchoComplete,
+                              controller));
+  OLA_ASSERT_EQ(2u, client_channel.QueueDepth());
+
+  // Now let everything drain.
+  m_ss.AddReadDescriptor(&pipe);
+  m_ss.AddReadDescriptor(other_end);
+  m_ss.Run();
+  m_ss.RemoveReadDescriptor(&pipe);
+  m_ss.RemoveReadDescriptor(other_end);
+
+  OLA_ASSERT_EQ(0u, client_channel.QueueDepth());
+  OLA_ASSERT_EQ(5u, m_requests_superseded);
+  OLA_ASSERT_EQ(m_requests_sent - 5, m_requests_completed);
+}
+
+/*
+ * Check that a send queue which holds more blocks than can be passed to a
+ * single writev() is written out, and that the queue is exported per channel.
+ */
+void RpcChannelTest::testManyQueuedBlocks() {
+  PipeDescriptor pipe;
+  OLA_ASSERT_TRUE(pipe.Init());
+  PipeDescriptor *other_end = pipe.OppositeEnd();
+  OLA_ASSERT_NOT_NULL(other_end);
+  OLA_ASSERT_TRUE(ConnectedDescriptor::SetNonBlocking(pipe.WriteDescriptor()));
+  OLA_ASSERT_TRUE(
+      ConnectedDescriptor::SetNonBlocking(other_end->WriteDescriptor()));
+
+  // Each queued message uses at least one memory block, so this is more than
+  // IOV_MAX (1024 on Linux) blocks.
+  const unsigned int QUEUED_REQUESTS = 1100;
+  const unsigned int MAX_REQUESTS = QUEUED_REQUESTS + 200;
+
+  ExportMap export_map;
+  RpcChannel client_channel(NULL, &pipe, &export_map);
+  client_channel.EnableSendQueue(&m_ss, MAX_REQUESTS);
+  RpcChannel server_channel(m_service.get(), other_end);
+  server_channel.EnableSendQueue(&m_ss, MAX_REQUESTS);
+  TestService_Stub stub(&client_channel);
+
+  RpcController controllers[MAX_REQUESTS];
+  EchoReply replies[MAX_REQUESTS];
+  EchoRequest large_request;
+  large_request.set_data(string(2048, 'x'));
+  large_request.set_session_ptr(0);
+  EchoRequest request;
+  request.set_data("x");
+  request.set_session_ptr(0);
+
+  // Fill the pipe.
+  while (client_channel.QueueDepth() == 0 && m_requests_sent < MAX_REQUESTS) {
+    RpcController *controller = &controllers[m_requests_sent];
+    stub.Echo(controller, &large_request, &replies[m_requests_sent++],
+              NewSingleCallback(this, &RpcChannelTest::QueuedEchoComplete,
+                                controller));
+  }
+  OLA_ASSERT_LT(m_requests_sent, MAX_REQUESTS - QUEUED_REQUESTS);
+
+  for (unsigned int i = 1; i < QUEUED_REQUESTS; i++) {
+    RpcController *controller = &controllers[m_requests_sent];
+    stub.Echo(controller, &request, &replies[m_requests_sent++],
+              NewSingleCallback(this, &RpcChannelTest::QueuedEchoComplete,
+                                controller));
+  }
+  OLA_ASSERT_EQ(QUEUED_REQUESTS, client_channel.QueueDepth());
+
+  const string channel_key = ola::strings::IntToString(
+      ola::io::ToFD(pipe.WriteDescriptor()));
+  UIntMap *queue_depth = export_map.GetUIntMapVar("rpc-channel-queue-depth");
+  OLA_ASSERT_EQ(QUEUED_REQUESTS, (*queue_depth)[channel_key]);
+  UIntMap *coalesced = export_map.GetUIntMapVar("rpc-channel-coalesced");
+  OLA_ASSERT_EQ(0u, (*coalesced)[channel_key]);
+
+  m_ss.AddReadDescriptor(&pipe);
+  m_ss.AddReadDescriptor(other_end);
+  m_ss.Run();
+  m_ss.RemoveReadDescriptor(&pipe);
+  m_ss.RemoveReadDescriptor(other_end);
+
+  OLA_ASSERT_EQ(0u, client_channel.QueueDepth());
+  OLA_ASSERT_EQ(0u, (*queue_depth)[channel_key]);
+  OLA_ASSERT_EQ(0u, m_requests_superseded);
+  OLA_ASSERT_EQ(m_requests_sent, m_requests_completed);
+}
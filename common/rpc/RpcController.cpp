@@ -29,12 +29,16 @@ namespace rpc {
 RpcController::RpcController(RpcSession *session)
     : m_session(session),
       m_failed(false),
-      m_error_text("") {
+      m_error_text(""),
+      m_has_coalesce_key(false),
+      m_coalesce_key(0) {
 }
 
 void RpcController::Reset() {
   m_failed = false;
   m_error_text = "";
+  m_has_coalesce_key = false;
+  m_coalesce_key = 0;
 }
 
 void RpcController::SetFailed(const std::string &reason) {
@@ -79,10 +79,37 @@ class RpcController {
    */
   RpcSession *Session();
 
+  /**
+   * @brief Allow this request to be replaced by a later one while it's
+   * waiting to be sent.
+   * @param key the key to coalesce on, e.g. the universe number for DMX
+   *   data.
+   *
+   * If the RpcChannel has a send queue, and a later request for the same
+   * method and key is made while this request is still queued, this request
+   * is replaced and fails with "Superseded".
+   */
+  void SetCoalesceKey(int key) {
+    m_has_coalesce_key = true;
+    m_coalesce_key = key;
+  }
+
+  /**
+   * @brief Check if a coalesce key was set for this request.
+   */
+  bool HasCoalesceKey() const { return m_has_coalesce_key; }
+
+  /**
+   * @brief Return the coalesce key for this request.
+   */
+  int CoalesceKey() const { return m_coalesce_key; }
+
  private:
   RpcSession *m_session;
   bool m_failed;
   std::string m_error_text;
+  bool m_has_coalesce_key;
+  int m_coalesce_key;
 };
 }  // namespace rpc
 }  // namespace ola
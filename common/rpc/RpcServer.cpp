@@ -130,6 +130,8 @@ bool RpcServer::AddClient(ConnectedDescriptor *descriptor) {
   // ownership of the socket here.
   RpcChannel *channel = new RpcChannel(m_service, descriptor,
                                        m_options.export_map);
+  // Don't disconnect clients that briefly fall behind.
+  channel->EnableSendQueue(m_ss);
 
   if (m_session_handler) {
     m_session_handler->NewClient(channel->Session());
@@ -27,6 +27,7 @@
 #include <iostream>
 #include <queue>
 #include <string>
+#include <vector>
 
 #include "ola/Logging.h"
 #include "ola/network/IPV4Address.h"
@@ -66,5 +66,28 @@ bool SetSchedParam(pthread_t thread, int policy,
   }
   return true;
 }
+
+bool SetCPUAffinity(pthread_t thread, unsigned int cpu) {
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+  if (cpu >= CPU_SETSIZE) {
+    OLA_WARN << "CPU " << cpu << " is out of range";
+    return false;
+  }
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(cpu, &cpus);
+  int r = pthread_setaffinity_np(thread, sizeof(cpus), &cpus);
+  if (r != 0) {
+    OLA_WARN << "Unable to pin thread to CPU " << cpu << ": " << strerror(r);
+    return false;
+  }
+  return true;
+#else
+  (void) thread;
+  OLA_WARN << "Thread affinity isn't supported on this platform, unable to "
+           << "pin to CPU " << cpu;
+  return false;
+#endif  // HAVE_PTHREAD_SETAFFINITY_NP
+}
 }  // namespace thread
 }  // namespace ola
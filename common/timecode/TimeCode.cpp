@@ -33,6 +33,15 @@ using std::setw;
 using std::setfill;
 using std::string;
 
+namespace {
+// Drop frame timecode skips frames 0 and 1 at the start of each minute,
+// except every tenth minute.
+const uint32_t DF_DROPPED_FRAMES = 2;
+const uint32_t DF_FRAMES_PER_MINUTE = 60 * 30 - DF_DROPPED_FRAMES;
+const uint32_t DF_FRAMES_PER_TEN_MINUTES = 10 * DF_FRAMES_PER_MINUTE +
+                                           DF_DROPPED_FRAMES;
+}  // namespace
+
 
 TimeCode::TimeCode(const TimeCode &other)
     : m_type(other.m_type),
@@ -73,6 +82,16 @@ bool TimeCode::IsValid() const {
   return false;
 }
 
+uint32_t TimeCode::FrameCount() const {
+  const uint32_t fps = FramesPerSecond(m_type);
+  const uint32_t minutes = m_hours * 60u + m_minutes;
+  uint32_t frame_count = (minutes * 60u + m_seconds) * fps + m_frames;
+  if (m_type == TIMECODE_DF) {
+    frame_count -= DF_DROPPED_FRAMES * (minutes - minutes / 10);
+  }
+  return frame_count;
+}
+
 string TimeCode::AsString() const {
   std::ostringstream str;
   str << setw(2) << setfill('0') << static_cast<int>(m_hours) << ":"
@@ -98,5 +117,47 @@ bool TimeCode::operator==(const TimeCode &other) const {
 bool TimeCode::operator!=(const TimeCode &other) const {
   return !(*this == other);
 }
+
+TimeCode TimeCode::FromFrameCount(TimeCodeType type, uint32_t frame_count) {
+  const uint32_t fps = FramesPerSecond(type);
+  uint32_t frames = frame_count % FramesPerDay(type);
+
+  if (type == TIMECODE_DF) {
+    // Add back the frame numbers that were dropped.
+    const uint32_t tens = frames / DF_FRAMES_PER_TEN_MINUTES;
+    const uint32_t remainder = frames % DF_FRAMES_PER_TEN_MINUTES;
+    frames += 9 * DF_DROPPED_FRAMES * tens;
+    if (remainder > DF_DROPPED_FRAMES) {
+      frames += DF_DROPPED_FRAMES *
+                ((remainder - DF_DROPPED_FRAMES) / DF_FRAMES_PER_MINUTE);
+    }
+  }
+
+  return TimeCode(type,
+                  frames / (fps * 3600),
+                  (frames / (fps * 60)) % 60,
+                  (frames / fps) % 60,
+                  frames % fps);
+}
+
+uint32_t TimeCode::FramesPerDay(TimeCodeType type) {
+  if (type == TIMECODE_DF) {
+    return 24 * 6 * DF_FRAMES_PER_TEN_MINUTES;
+  }
+  return 24 * 3600 * static_cast<uint32_t>(FramesPerSecond(type));
+}
+
+uint8_t TimeCode::FramesPerSecond(TimeCodeType type) {
+  switch (type) {
+    case TIMECODE_FILM:
+      return 24;
+    case TIMECODE_EBU:
+      return 25;
+    case TIMECODE_DF:
+    case TIMECODE_SMPTE:
+      return 30;
+  }
+  return 30;
+}
 }  // namespace timecode
 }  // namespace ola
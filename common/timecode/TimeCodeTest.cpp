@@ -39,11 +39,13 @@ class TimeCodeTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(TimeCodeTest);
   CPPUNIT_TEST(testTimeCode);
   CPPUNIT_TEST(testIsValid);
+  CPPUNIT_TEST(testFrameCount);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void testTimeCode();
     void testIsValid();
+    void testFrameCount();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TimeCodeTest);
@@ -97,3 +99,42 @@ void TimeCodeTest::testIsValid() {
   TimeCode t4(TIMECODE_SMPTE, 0, 0, 0, 30);
   OLA_ASSERT_FALSE(t4.IsValid());
 }
+
+/**
+ * Test converting to and from frame counts.
+ */
+void TimeCodeTest::testFrameCount() {
+  OLA_ASSERT_EQ(0u, TimeCode(TIMECODE_FILM, 0, 0, 0, 0).FrameCount());
+  OLA_ASSERT_EQ(24u * 61 + 3,
+                TimeCode(TIMECODE_FILM, 0, 1, 1, 3).FrameCount());
+  OLA_ASSERT_EQ(108000u, TimeCode(TIMECODE_SMPTE, 1, 0, 0, 0).FrameCount());
+  OLA_ASSERT_EQ(25u * 86400, TimeCode::FramesPerDay(TIMECODE_EBU));
+
+  // drop frame skips frames 0 & 1 each minute, except every tenth minute
+  OLA_ASSERT_EQ(1799u, TimeCode(TIMECODE_DF, 0, 0, 59, 29).FrameCount());
+  OLA_ASSERT_EQ(1800u, TimeCode(TIMECODE_DF, 0, 1, 0, 2).FrameCount());
+  OLA_ASSERT_EQ(17982u, TimeCode(TIMECODE_DF, 0, 10, 0, 0).FrameCount());
+  OLA_ASSERT_EQ(2589408u, TimeCode::FramesPerDay(TIMECODE_DF));
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_DF, 0, 1, 0, 2),
+                TimeCode::FromFrameCount(TIMECODE_DF, 1800));
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_DF, 0, 10, 0, 0),
+                TimeCode::FromFrameCount(TIMECODE_DF, 17982));
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_DF, 23, 59, 59, 29),
+                TimeCode::FromFrameCount(TIMECODE_DF, 2589407));
+
+  // round trip every frame in the first 20 minutes
+  for (uint32_t i = 0; i < 20 * 60 * 30; i++) {
+    TimeCode smpte = TimeCode::FromFrameCount(TIMECODE_SMPTE, i);
+    OLA_ASSERT_TRUE(smpte.IsValid());
+    OLA_ASSERT_EQ(i, smpte.FrameCount());
+
+    TimeCode df = TimeCode::FromFrameCount(TIMECODE_DF, i);
+    OLA_ASSERT_TRUE(df.IsValid());
+    OLA_ASSERT_EQ(i, df.FrameCount());
+  }
+
+  // the frame count wraps at midnight
+  OLA_ASSERT_EQ(TimeCode(TIMECODE_EBU, 0, 0, 0, 1),
+                TimeCode::FromFrameCount(
+                    TIMECODE_EBU, TimeCode::FramesPerDay(TIMECODE_EBU) + 1));
+}
@@ -0,0 +1,160 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxFrame.cpp
+ * An immutable, reference counted frame of DMX data.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <string.h>
+#include <algorithm>
+
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/DmxFrame.h"
+#include "ola/thread/Mutex.h"
+
+namespace ola {
+
+namespace {
+
+#ifdef HAVE_ATOMIC_BUILTINS
+
+int AtomicIncrement(int *value) {
+  return __atomic_add_fetch(value, 1, __ATOMIC_ACQ_REL);
+}
+
+int AtomicDecrement(int *value) {
+  return __atomic_sub_fetch(value, 1, __ATOMIC_ACQ_REL);
+}
+
+const DmxFrame *AtomicExchange(const DmxFrame **pointer,
+                               const DmxFrame *value) {
+  return __atomic_exchange_n(pointer, value, __ATOMIC_ACQ_REL);
+}
+
+#else
+
+// Without the builtins we fall back to a single process wide lock. It's only
+// held for a couple of instructions, so contention is low.
+ola::thread::Mutex *AtomicLock() {
+  static ola::thread::Mutex mutex;
+  return &mutex;
+}
+
+int AtomicIncrement(int *value) {
+  ola::thread::MutexLocker locker(AtomicLock());
+  return ++(*value);
+}
+
+int AtomicDecrement(int *value) {
+  ola::thread::MutexLocker locker(AtomicLock());
+  return --(*value);
+}
+
+const DmxFrame *AtomicExchange(const DmxFrame **pointer,
+                               const DmxFrame *value) {
+  ola::thread::MutexLocker locker(AtomicLock());
+  const DmxFrame *old_value = *pointer;
+  *pointer = value;
+  return old_value;
+}
+
+#endif  // HAVE_ATOMIC_BUILTINS
+}  // namespace
+
+
+const DmxFrame *DmxFrame::Create(const DmxBuffer &buffer,
+                                 uint8_t start_code) {
+  return new DmxFrame(start_code, buffer.GetRaw(), buffer.Size());
+}
+
+
+const DmxFrame *DmxFrame::Create(const uint8_t *data, unsigned int length,
+                                 uint8_t start_code) {
+  return new DmxFrame(start_code, data, length);
+}
+
+
+void DmxFrame::Ref() const {
+  AtomicIncrement(&m_ref_count);
+}
+
+
+void DmxFrame::Unref() const {
+  if (AtomicDecrement(&m_ref_count) == 0) {
+    delete this;
+  }
+}
+
+
+DmxFrame::DmxFrame(uint8_t start_code, const uint8_t *data,
+                   unsigned int length)
+    : m_ref_count(1),
+      m_size(std::min(length, static_cast<unsigned int>(DMX_UNIVERSE_SIZE))) {
+  m_packet[0] = start_code;
+  if (m_size) {
+    memcpy(m_packet + 1, data, m_size);
+  }
+}
+
+
+DmxFrameMailbox::DmxFrameMailbox()
+    : m_pending(NULL) {
+}
+
+
+DmxFrameMailbox::~DmxFrameMailbox() {
+  const DmxFrame *frame = Take();
+  if (frame) {
+    frame->Unref();
+  }
+}
+
+
+void DmxFrameMailbox::Publish(const DmxFrame *frame) {
+  const DmxFrame *old_frame = AtomicExchange(&m_pending, frame);
+  if (old_frame) {
+    old_frame->Unref();
+  }
+}
+
+
+void DmxFrameMailbox::Publish(const DmxBuffer &buffer) {
+  Publish(DmxFrame::Create(buffer));
+}
+
+
+const DmxFrame *DmxFrameMailbox::Take() {
+  return AtomicExchange(&m_pending, NULL);
+}
+
+
+bool DmxFrameMailbox::Update(const DmxFrame **frame) {
+  const DmxFrame *new_frame = Take();
+  if (!new_frame) {
+    return false;
+  }
+  if (*frame) {
+    (*frame)->Unref();
+  }
+  *frame = new_frame;
+  return true;
+}
+}  // namespace ola
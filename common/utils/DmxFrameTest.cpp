@@ -0,0 +1,202 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxFrameTest.cpp
+ * Test fixture for the DmxFrame and DmxFrameMailbox classes.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/DmxFrame.h"
+#include "ola/thread/Thread.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::DmxBuffer;
+using ola::DmxFrame;
+using ola::DmxFrameMailbox;
+
+class DmxFrameTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(DmxFrameTest);
+  CPPUNIT_TEST(testCreate);
+  CPPUNIT_TEST(testRefCounting);
+  CPPUNIT_TEST(testMailbox);
+  CPPUNIT_TEST(testMultithreadedMailbox);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void testCreate();
+    void testRefCounting();
+    void testMailbox();
+    void testMultithreadedMailbox();
+
+ private:
+    static const uint8_t TEST_DATA[];
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DmxFrameTest);
+
+const uint8_t DmxFrameTest::TEST_DATA[] = {1, 2, 3, 4, 5};
+
+/**
+ * Publishes a sequence of frames, each one holding a 16 bit counter.
+ */
+class PublisherThread: public ola::thread::Thread {
+ public:
+    PublisherThread(DmxFrameMailbox *mailbox, unsigned int count)
+        : Thread(),
+          m_mailbox(mailbox),
+          m_count(count) {
+    }
+
+    void *Run() {
+      for (unsigned int i = 1; i <= m_count; i++) {
+        uint8_t data[] = {static_cast<uint8_t>(i >> 8),
+                          static_cast<uint8_t>(i & 0xff)};
+        m_mailbox->Publish(DmxFrame::Create(data, sizeof(data)));
+      }
+      return NULL;
+    }
+
+ private:
+    DmxFrameMailbox *m_mailbox;
+    const unsigned int m_count;
+};
+
+
+/*
+ * Check creating frames.
+ */
+void DmxFrameTest::testCreate() {
+  const DmxFrame *frame = DmxFrame::Create(TEST_DATA, sizeof(TEST_DATA));
+  OLA_ASSERT_EQ(static_cast<unsigned int>(sizeof(TEST_DATA)), frame->Size());
+  OLA_ASSERT_EQ(ola::DMX512_START_CODE, frame->StartCode());
+  OLA_ASSERT_DATA_EQUALS(TEST_DATA, sizeof(TEST_DATA), frame->GetRaw(),
+                         frame->Size());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(3), frame->Get(2));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), frame->Get(5));
+
+  const uint8_t expected_packet[] = {0, 1, 2, 3, 4, 5};
+  OLA_ASSERT_DATA_EQUALS(expected_packet, sizeof(expected_packet),
+                         frame->Packet(), frame->PacketSize());
+  frame->Unref();
+
+  // from a DmxBuffer, with an alternate start code
+  DmxBuffer buffer(TEST_DATA, sizeof(TEST_DATA));
+  frame = DmxFrame::Create(buffer, 0xcc);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0xcc), frame->StartCode());
+  OLA_ASSERT_DATA_EQUALS(buffer.GetRaw(), buffer.Size(), frame->GetRaw(),
+                         frame->Size());
+  frame->Unref();
+
+  // an empty frame
+  frame = DmxFrame::Create(DmxBuffer());
+  OLA_ASSERT_EQ(0u, frame->Size());
+  OLA_ASSERT_EQ(1u, frame->PacketSize());
+  frame->Unref();
+
+  // oversized data is truncated
+  uint8_t large_data[ola::DMX_UNIVERSE_SIZE + 10];
+  memset(large_data, 0x55, sizeof(large_data));
+  frame = DmxFrame::Create(large_data, sizeof(large_data));
+  OLA_ASSERT_EQ(static_cast<unsigned int>(ola::DMX_UNIVERSE_SIZE),
+                frame->Size());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0x55),
+                frame->Get(ola::DMX_UNIVERSE_SIZE - 1));
+  frame->Unref();
+}
+
+
+/*
+ * Check that a frame outlives all but its last reference.
+ */
+void DmxFrameTest::testRefCounting() {
+  const DmxFrame *frame = DmxFrame::Create(TEST_DATA, sizeof(TEST_DATA));
+  frame->Ref();
+  frame->Ref();
+  frame->Unref();
+  frame->Unref();
+  // still valid
+  OLA_ASSERT_EQ(static_cast<uint8_t>(1), frame->Get(0));
+  frame->Unref();
+}
+
+
+/*
+ * Check the single threaded mailbox behaviour.
+ */
+void DmxFrameTest::testMailbox() {
+  DmxFrameMailbox mailbox;
+  OLA_ASSERT_NULL(mailbox.Take());
+
+  const DmxFrame *current = NULL;
+  OLA_ASSERT_FALSE(mailbox.Update(&current));
+  OLA_ASSERT_NULL(current);
+
+  // only the latest frame is delivered
+  uint8_t data[] = {1};
+  mailbox.Publish(DmxFrame::Create(data, sizeof(data)));
+  data[0] = 2;
+  mailbox.Publish(DmxFrame::Create(data, sizeof(data)));
+
+  OLA_ASSERT_TRUE(mailbox.Update(&current));
+  OLA_ASSERT_NOT_NULL(current);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(2), current->Get(0));
+
+  // no new frame, so the current one is kept
+  OLA_ASSERT_FALSE(mailbox.Update(&current));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(2), current->Get(0));
+
+  DmxBuffer buffer(TEST_DATA, sizeof(TEST_DATA));
+  mailbox.Publish(buffer);
+  const DmxFrame *frame = mailbox.Take();
+  OLA_ASSERT_NOT_NULL(frame);
+  OLA_ASSERT_DATA_EQUALS(TEST_DATA, sizeof(TEST_DATA), frame->GetRaw(),
+                         frame->Size());
+  OLA_ASSERT_NULL(mailbox.Take());
+  frame->Unref();
+  current->Unref();
+
+  // leave a frame in the mailbox, the destructor releases it.
+  mailbox.Publish(buffer);
+}
+
+
+/*
+ * Check that frames published from another thread arrive in order.
+ */
+void DmxFrameTest::testMultithreadedMailbox() {
+  const unsigned int FRAME_COUNT = 20000;
+  DmxFrameMailbox mailbox;
+  PublisherThread thread(&mailbox, FRAME_COUNT);
+  OLA_ASSERT_TRUE(thread.Start());
+
+  const DmxFrame *current = NULL;
+  unsigned int last_value = 0;
+  while (last_value != FRAME_COUNT) {
+    if (mailbox.Update(&current)) {
+      OLA_ASSERT_EQ(2u, current->Size());
+      unsigned int value = (current->Get(0) << 8) + current->Get(1);
+      OLA_ASSERT_TRUE(value > last_value);
+      last_value = value;
+    }
+  }
+  OLA_ASSERT_TRUE(thread.Join());
+  OLA_ASSERT_NULL(mailbox.Take());
+  current->Unref();
+}
@@ -4,6 +4,7 @@ common_libolacommon_la_SOURCES += \
     common/utils/ActionQueue.cpp \
     common/utils/Clock.cpp \
     common/utils/DmxBuffer.cpp \
+    common/utils/DmxFrame.cpp \
     common/utils/StringUtils.cpp \
     common/utils/TokenBucket.cpp \
     common/utils/Watchdog.cpp
@@ -18,6 +19,7 @@ common_utils_UtilsTester_SOURCES = \
     common/utils/CallbackTest.cpp \
     common/utils/ClockTest.cpp \
     common/utils/DmxBufferTest.cpp \
+    common/utils/DmxFrameTest.cpp \
     common/utils/MultiCallbackTest.cpp \
     common/utils/StringUtilsTest.cpp \
     common/utils/TokenBucketTest.cpp \
@@ -6,6 +6,19 @@ dist_piddata_DATA = \
     data/rdm/manufacturer_names.proto \
     data/rdm/manufacturer_pids.proto
 
+# The precompiled PID data. It records a hash of the text files, and is used in
+# their place while they're unchanged.
+if BUILD_EXAMPLES
+nodist_piddata_DATA = data/rdm/precompiled/pids.pb
+
+data/rdm/precompiled/pids.pb: data/rdm/Makefile.mk $(dist_piddata_DATA) \
+    examples/ola_rdm_compile_pids$(EXEEXT)
+	mkdir -p $(builddir)/data/rdm/precompiled
+	$(builddir)/examples/ola_rdm_compile_pids \
+	  --pid-location $(srcdir)/data/rdm \
+	  --output $(builddir)/data/rdm/precompiled/pids.pb
+endif
+
 # SCRIPTS
 ################################################
 dist_noinst_SCRIPTS += \
@@ -30,8 +43,13 @@ data/rdm/PidDataTest.sh: data/rdm/Makefile.mk
 data_rdm_PidDataTester_SOURCES = data/rdm/PidDataTest.cpp
 data_rdm_PidDataTester_CXXFLAGS = $(COMMON_TESTING_FLAGS) -DDATADIR=\"$(srcdir)/data/rdm\"
 data_rdm_PidDataTester_LDADD = $(COMMON_TESTING_LIBS)
+if BUILD_EXAMPLES
+data_rdm_PidDataTester_CXXFLAGS += \
+    -DPRECOMPILED_DATADIR=\"$(builddir)/data/rdm/precompiled\"
+endif
 
 CLEANFILES += \
     data/rdm/*.pyc \
     data/rdm/PidDataTest.sh \
+    data/rdm/precompiled/pids.pb \
     data/rdm/__pycache__/*
@@ -31,11 +31,13 @@ using ola::rdm::RootPidStore;
 class PidDataTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(PidDataTest);
   CPPUNIT_TEST(testDataLoad);
+  CPPUNIT_TEST(testPrecompiledDataLoad);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     void setUp();
     void testDataLoad();
+    void testPrecompiledDataLoad();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(PidDataTest);
@@ -60,3 +62,29 @@ void PidDataTest::testDataLoad() {
   OLA_ASSERT_NOT_NULL(manufacturer_store);
   OLA_ASSERT_NE(0, manufacturer_store->PidCount());
 }
+
+/*
+ * Check the precompiled data matches the text files.
+ */
+void PidDataTest::testPrecompiledDataLoad() {
+#ifdef PRECOMPILED_DATADIR
+  std::auto_ptr<const RootPidStore> store(
+      RootPidStore::LoadFromDirectory(DATADIR));
+  OLA_ASSERT_NOT_NULL(store.get());
+  std::auto_ptr<const RootPidStore> precompiled_store(
+      RootPidStore::LoadFromDirectory(PRECOMPILED_DATADIR));
+  OLA_ASSERT_NOT_NULL(precompiled_store.get());
+
+  OLA_ASSERT_EQ(store->Version(), precompiled_store->Version());
+  const PidStore *esta_store = precompiled_store->EstaStore();
+  OLA_ASSERT_NOT_NULL(esta_store);
+  OLA_ASSERT_EQ(store->EstaStore()->PidCount(), esta_store->PidCount());
+  OLA_ASSERT_NOT_NULL(precompiled_store->GetDescriptor("DEVICE_INFO"));
+
+  const PidStore *manufacturer_store =
+      precompiled_store->ManufacturerStore(0x00a1);
+  OLA_ASSERT_NOT_NULL(manufacturer_store);
+  OLA_ASSERT_EQ(store->ManufacturerStore(0x00a1)->PidCount(),
+                manufacturer_store->PidCount());
+#endif  // PRECOMPILED_DATADIR
+}
@@ -21,6 +21,7 @@ examples_libolaconfig_la_CXXFLAGS = $(COMMON_PROTOBUF_CXXFLAGS)
 ##################################################
 bin_PROGRAMS += \
     examples/ola_dev_info \
+    examples/ola_rdm_compile_pids \
     examples/ola_rdm_discover \
     examples/ola_rdm_get \
     examples/ola_recorder \
@@ -67,6 +68,9 @@ examples_ola_streaming_client_LDADD = $(EXAMPLE_COMMON_LIBS)
 examples_ola_rdm_get_SOURCES = examples/ola-rdm.cpp
 examples_ola_rdm_get_LDADD = $(EXAMPLE_COMMON_LIBS)
 
+examples_ola_rdm_compile_pids_SOURCES = examples/ola-rdm-compile-pids.cpp
+examples_ola_rdm_compile_pids_LDADD = $(EXAMPLE_COMMON_LIBS)
+
 examples_ola_rdm_discover_SOURCES = examples/ola-rdm-discover.cpp
 examples_ola_rdm_discover_LDADD = $(EXAMPLE_COMMON_LIBS)
 
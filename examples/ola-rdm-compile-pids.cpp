@@ -0,0 +1,69 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * ola-rdm-compile-pids.cpp
+ * Convert the RDM PID data to the precompiled format.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdlib.h>
+#include <ola/Logging.h>
+#include <ola/base/Flags.h>
+#include <ola/base/Init.h>
+#include <ola/base/SysExits.h>
+#include <ola/file/Util.h>
+#include <ola/rdm/PidStore.h>
+
+#include <iostream>
+#include <string>
+
+using ola::rdm::RootPidStore;
+using std::cout;
+using std::endl;
+using std::string;
+
+DEFINE_s_string(pid_location, p, "",
+                "The directory containing the PID definitions.");
+DEFINE_s_string(output, o, "",
+                "The file to write to, defaults to pids.pb in the PID "
+                "directory.");
+
+int main(int argc, char *argv[]) {
+  ola::AppInit(
+      &argc,
+      argv,
+      "[--pid-location <dir>] [--output <file>]",
+      "Convert the RDM PID definitions to the precompiled format, which is "
+      "faster to load. The precompiled file is used by olad and the RDM "
+      "tools when it's in the PID directory and was built from the text "
+      "files there.");
+
+  string pid_location = FLAGS_pid_location.str();
+  if (pid_location.empty()) {
+    pid_location = RootPidStore::DataLocation();
+  }
+
+  string output = FLAGS_output.str();
+  if (output.empty()) {
+    output = ola::file::JoinPaths(pid_location, "pids.pb");
+  }
+
+  if (!RootPidStore::PrecompileDirectory(pid_location, output)) {
+    OLA_FATAL << "Failed to precompile the PIDs in " << pid_location;
+    exit(ola::EXIT_DATAERR);
+  }
+  cout << "Wrote " << output << endl;
+  return ola::EXIT_OK;
+}
@@ -0,0 +1,202 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * DmxFrame.h
+ * An immutable, reference counted frame of DMX data.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file DmxFrame.h
+ * @brief An immutable frame of DMX data that can be shared between threads.
+ */
+
+#ifndef INCLUDE_OLA_DMXFRAME_H_
+#define INCLUDE_OLA_DMXFRAME_H_
+
+#include <stdint.h>
+#include <ola/Constants.h>
+#include <ola/DmxBuffer.h>
+#include <ola/base/Macro.h>
+
+namespace ola {
+
+/**
+ * @class DmxFrame ola/DmxFrame.h
+ * @brief An immutable, reference counted frame of DMX data.
+ *
+ * Unlike DmxBuffer, a DmxFrame may be shared between threads. The data can't
+ * be changed once the frame has been created and the reference count is
+ * updated atomically, so a frame can be created once and then read by any
+ * number of threads without locking.
+ *
+ * The start code is stored in front of the slot data, so Packet() can be
+ * handed straight to a widget without copying.
+ *
+ * Frames are created with Create(), which returns a frame holding one
+ * reference. Call Unref() once you're finished with it.
+ */
+class DmxFrame {
+ public:
+    /**
+     * @brief Create a new frame from a DmxBuffer.
+     * @param buffer the DMX data.
+     * @param start_code the start code of the frame.
+     * @returns a new frame, the caller owns the initial reference.
+     */
+    static const DmxFrame *Create(const DmxBuffer &buffer,
+                                  uint8_t start_code = DMX512_START_CODE);
+
+    /**
+     * @brief Create a new frame from raw data.
+     * @param data the slot data.
+     * @param length the length of the data, anything beyond
+     *   DMX_UNIVERSE_SIZE is ignored.
+     * @param start_code the start code of the frame.
+     * @returns a new frame, the caller owns the initial reference.
+     */
+    static const DmxFrame *Create(const uint8_t *data, unsigned int length,
+                                  uint8_t start_code = DMX512_START_CODE);
+
+    /**
+     * @brief Add a reference to this frame.
+     */
+    void Ref() const;
+
+    /**
+     * @brief Remove a reference to this frame, the frame is deleted once the
+     * last reference is removed.
+     */
+    void Unref() const;
+
+    /**
+     * @brief The number of slots in the frame, not including the start code.
+     */
+    unsigned int Size() const { return m_size; }
+
+    /**
+     * @brief The start code of the frame.
+     */
+    uint8_t StartCode() const { return m_packet[0]; }
+
+    /**
+     * @brief Get the value of a slot.
+     * @param slot the slot number, starting from 0.
+     * @returns the value of the slot, or 0 if the slot is out of range.
+     */
+    uint8_t Get(unsigned int slot) const {
+      return slot < m_size ? m_packet[slot + 1] : 0;
+    }
+
+    /**
+     * @brief A pointer to the slot data, Size() bytes long.
+     */
+    const uint8_t *GetRaw() const { return m_packet + 1; }
+
+    /**
+     * @brief A pointer to the start code followed by the slot data,
+     * PacketSize() bytes long.
+     */
+    const uint8_t *Packet() const { return m_packet; }
+
+    /**
+     * @brief The size of the start code and slot data.
+     */
+    unsigned int PacketSize() const { return m_size + 1; }
+
+ private:
+    mutable int m_ref_count;
+    unsigned int m_size;
+    uint8_t m_packet[DMX_UNIVERSE_SIZE + 1];
+
+    DmxFrame(uint8_t start_code, const uint8_t *data, unsigned int length);
+    ~DmxFrame() {}
+
+    DISALLOW_COPY_AND_ASSIGN(DmxFrame);
+};
+
+
+/**
+ * @class DmxFrameMailbox ola/DmxFrame.h
+ * @brief Hands the most recent DmxFrame from one thread to another.
+ *
+ * Any thread may call Publish(), only a single thread may call Take() or
+ * Update(). Neither side blocks; if several frames are published before the
+ * consumer checks the mailbox, only the most recent one is delivered and the
+ * others are released.
+ *
+ * @examplepara
+ *   @code
+ *   // In the producer
+ *   mailbox.Publish(buffer);
+ *
+ *   // In the output thread
+ *   const DmxFrame *frame = NULL;
+ *   while (running) {
+ *     mailbox.Update(&frame);
+ *     if (frame) {
+ *       write(fd, frame->Packet(), frame->PacketSize());
+ *     }
+ *   }
+ *   if (frame) {
+ *     frame->Unref();
+ *   }
+ *   @endcode
+ */
+class DmxFrameMailbox {
+ public:
+    DmxFrameMailbox();
+
+    /**
+     * @brief Destructor, this releases any frame that hasn't been taken.
+     */
+    ~DmxFrameMailbox();
+
+    /**
+     * @brief Publish a frame.
+     * @param frame the frame to publish, the caller's reference is
+     *   transferred to the mailbox.
+     */
+    void Publish(const DmxFrame *frame);
+
+    /**
+     * @brief Create a frame from a DmxBuffer and publish it.
+     * @param buffer the DMX data.
+     */
+    void Publish(const DmxBuffer &buffer);
+
+    /**
+     * @brief Take the most recently published frame.
+     * @returns the frame, or NULL if nothing has been published since the
+     *   last call. The caller owns the reference to the returned frame.
+     */
+    const DmxFrame *Take();
+
+    /**
+     * @brief Replace a frame with the most recently published one.
+     * @param frame a pointer to the consumer's current frame, which may be
+     *   NULL. If a new frame is available, the old one is released and
+     *   replaced.
+     * @returns true if the frame was replaced, false otherwise.
+     */
+    bool Update(const DmxFrame **frame);
+
+ private:
+    const DmxFrame *m_pending;
+
+    DISALLOW_COPY_AND_ASSIGN(DmxFrameMailbox);
+};
+}  // namespace ola
+#endif  // INCLUDE_OLA_DMXFRAME_H_
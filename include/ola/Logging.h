@@ -32,6 +32,15 @@
  * OLA_WARN << "Could not connect to server: " << ip_address;
  * OLA_INFO << "Reading configs from " << config_dir;
  * OLA_DEBUG << "Counter was " << counter;
+ *
+ * // Key / value pairs, this logs "Source added universe=1 name="Console 1""
+ * OLA_INFO << "Source added" << ola::LogField("universe", universe_id)
+ *          << ola::LogField("name", source_name);
+ *
+ * // Messages that may be triggered by every packet should be rate limited.
+ * // The limiter is usually a class member so there's one per call site.
+ * ola::LogRateLimiter m_merge_limiter;
+ * OLA_WARN_LIMITED(m_merge_limiter) << "Max merge sources reached";
  * @endcode
  *
  * @addtogroup logging
@@ -44,6 +53,7 @@
 #ifndef INCLUDE_OLA_LOGGING_H_
 #define INCLUDE_OLA_LOGGING_H_
 
+#include <stdint.h>
 #include <ostream>
 #include <string>
 #include <sstream>
@@ -90,8 +100,40 @@
  */
 #define OLA_DEBUG OLA_LOG(ola::OLA_LOG_DEBUG)
 
+/**
+ * @brief Provide a stream interface to log a rate limited message.
+ *
+ * If the ola::LogRateLimiter doesn't allow the message, the stream
+ * expressions aren't evaluated. The next message that is allowed is tagged
+ * with the number of messages that were suppressed.
+ * @param level the log_level to log at.
+ * @param limiter the ola::LogRateLimiter for this call site.
+ */
+#define OLA_LOG_LIMITED(level, limiter) \
+    (level <= ola::LogLevel()) && (limiter).Allow() && \
+    ola::LogLine(__FILE__, __LINE__, level, \
+                 (limiter).TakeSuppressed()).stream()
+
+/**
+ * Provide a stream to log a rate limited warning message.
+ * @code
+ *     OLA_WARN_LIMITED(m_limiter) << "Max merge sources reached";
+ * @endcode
+ */
+#define OLA_WARN_LIMITED(limiter) OLA_LOG_LIMITED(ola::OLA_LOG_WARN, limiter)
+
+/**
+ * Provide a stream to log a rate limited informational message.
+ * @code
+ *     OLA_INFO_LIMITED(m_limiter) << "Old packet received, ignoring";
+ * @endcode
+ */
+#define OLA_INFO_LIMITED(limiter) OLA_LOG_LIMITED(ola::OLA_LOG_INFO, limiter)
+
 namespace ola {
 
+class Clock;
+
 /**
  * @brief The OLA log levels.
  * This controls the verbosity of logging. Each level also includes those below
@@ -138,6 +180,13 @@ class LogDestination {
    * destination
    */
   virtual void Write(log_level level, const std::string &log_line) = 0;
+
+  /**
+   * @brief Block until all lines passed to Write() have been written.
+   *
+   * Destinations that buffer lines should override this.
+   */
+  virtual void Flush() {}
 };
 
 /**
@@ -219,7 +268,8 @@ class UnixSyslogDestination : public SyslogDestination {
  */
 class LogLine {
  public:
-  LogLine(const char *file, int line, log_level level);
+  LogLine(const char *file, int line, log_level level,
+          unsigned int suppressed = 0);
   ~LogLine();
   void Write();
 
@@ -228,9 +278,103 @@ class LogLine {
   log_level m_level;
   std::ostringstream m_stream;
   unsigned int m_prefix_length;
+  unsigned int m_suppressed;
 };
+
+template <typename T>
+struct LogFieldValue {
+  LogFieldValue(const char *key, const T &value)
+      : key(key),
+        value(value) {
+  }
+
+  const char *key;
+  const T &value;
+};
+
+void FormatLogValue(std::ostream &out, const std::string &value);
+void FormatLogValue(std::ostream &out, const char *value);
+
+template <typename T>
+void FormatLogValue(std::ostream &out, const T &value) {
+  out << value;
+}
+
+template <typename T>
+std::ostream& operator<<(std::ostream &out, const LogFieldValue<T> &field) {
+  out << " " << field.key << "=";
+  FormatLogValue(out, field.value);
+  return out;
+}
 /**@endcond*/
 
+/**
+ * @addtogroup logging
+ * @{
+ */
+
+/**
+ * @brief Log a key / value pair.
+ *
+ * This writes " key=value" to the log line, strings that contain spaces,
+ * quotes or '=' are quoted so the line can be parsed by log processors.
+ * @param key the key, this should be a string literal.
+ * @param value the value, anything that can be written to a std::ostream.
+ */
+template <typename T>
+LogFieldValue<T> LogField(const char *key, const T &value) {
+  return LogFieldValue<T>(key, value);
+}
+
+/**
+ * @brief Limits the rate of messages from a single call site.
+ *
+ * Up to burst messages are allowed in each interval, further messages are
+ * suppressed and counted. Use with the OLA_LOG_LIMITED, OLA_WARN_LIMITED and
+ * OLA_INFO_LIMITED macros.
+ */
+class LogRateLimiter {
+ public:
+  /**
+   * @brief Create a new LogRateLimiter.
+   * @param interval_ms the length of each interval in milliseconds.
+   * @param burst the number of messages to allow in each interval.
+   * @param clock the clock to use, or NULL to use the system clock. Ownership
+   *   is not transferred.
+   */
+  explicit LogRateLimiter(unsigned int interval_ms = DEFAULT_INTERVAL_MS,
+                          unsigned int burst = 1,
+                          const Clock *clock = NULL);
+
+  /**
+   * @brief Check if a message should be logged.
+   * @returns true if the message should be logged, false if it was
+   *   suppressed.
+   */
+  bool Allow();
+
+  /**
+   * @brief Return and reset the number of suppressed messages.
+   */
+  unsigned int TakeSuppressed();
+
+  /**
+   * @brief The number of messages suppressed since the last one logged.
+   */
+  unsigned int Suppressed() const { return m_suppressed; }
+
+  static const unsigned int DEFAULT_INTERVAL_MS = 1000;
+
+ private:
+  const Clock *m_clock;
+  const int64_t m_interval_ms;
+  const unsigned int m_burst;
+  int64_t m_window_start;
+  unsigned int m_allowed;
+  unsigned int m_suppressed;
+};
+/**@}*/
+
 /**
  * @addtogroup logging
  * @{
@@ -255,10 +399,20 @@ void IncrementLogLevel();
 
 /**
  * @brief Initialize the OLA logging system from flags.
+ * @param start_async_writer if --async-log is set, start the writer thread
+ *   now. Programs that fork or block signals later should pass false and
+ *   call StartAsyncLogging() once they have done so.
  * @pre ParseFlags() must have been called before calling this.
  * @returns true if logging was initialized successfully, false otherwise.
  */
-bool InitLoggingFromFlags();
+bool InitLoggingFromFlags(bool start_async_writer = true);
+
+/**
+ * @brief Start the writer thread if --async-log is in use.
+ *
+ * Messages logged before this are buffered.
+ */
+void StartAsyncLogging();
 
 /**
  * @brief Initialize the OLA logging system
@@ -274,6 +428,14 @@ bool InitLogging(log_level level, log_output output);
  * @param destination the LogDestination to use.
  */
 void InitLogging(log_level level, LogDestination *destination);
+
+/**
+ * @brief Wait until any buffered log messages have been written.
+ *
+ * This only has an effect if the log destination buffers messages, e.g. the
+ * AsyncLogDestination.
+ */
+void FlushLogging();
 /***/
 }  // namespace ola
 /**@}*/
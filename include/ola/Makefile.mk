@@ -33,6 +33,7 @@ pkginclude_HEADERS += \
     include/ola/Clock.h \
     include/ola/Constants.h \
     include/ola/DmxBuffer.h \
+    include/ola/DmxFrame.h \
     include/ola/ExportMap.h \
     include/ola/Logging.h \
     include/ola/MultiCallback.h \
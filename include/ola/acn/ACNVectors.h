@@ -47,6 +47,7 @@ enum RootVector {
   VECTOR_ROOT_E131 = 4,  /**< E1.31 (sACN) */
   VECTOR_ROOT_E133 = 5,  /**< E1.33 (RDNNet) */
   VECTOR_ROOT_NULL = 6,  /**< NULL (empty) root */
+  VECTOR_ROOT_E131_EXTENDED = 8,  /**< E1.31 (sACN) sync & discovery */
 };
 
 /**
@@ -66,6 +67,14 @@ enum E131Vector {
   VECTOR_E131_DISCOVERY = 4,  /**< Discovery data (DISCOVERY_PACKET_VECTOR) */
 };
 
+/**
+ * @brief Vectors used at the E1.31 extended framing layer.
+ */
+enum E131ExtendedVector {
+  VECTOR_E131_EXTENDED_SYNCHRONIZATION = 1,  /**< Synchronization packet */
+  VECTOR_E131_EXTENDED_DISCOVERY = 2,  /**< Universe discovery packet */
+};
+
 /**
  * @brief Vectors used at the E1.33 layer.
  */
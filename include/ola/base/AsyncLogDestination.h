@@ -0,0 +1,153 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * AsyncLogDestination.h
+ * A LogDestination that writes from a background thread.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup logging
+ * @{
+ * @file AsyncLogDestination.h
+ * @brief A LogDestination that writes from a background thread.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_BASE_ASYNCLOGDESTINATION_H_
+#define INCLUDE_OLA_BASE_ASYNCLOGDESTINATION_H_
+
+#include <ola/Logging.h>
+#include <ola/base/Macro.h>
+#include <ola/thread/Mutex.h>
+#include <ola/thread/Thread.h>
+
+#include <string>
+#include <vector>
+
+namespace ola {
+
+/**
+ * @addtogroup logging
+ * @{
+ */
+
+/**
+ * @brief A LogDestination that hands messages to a background thread.
+ *
+ * Write() copies the line into a fixed size ring and returns, so the calling
+ * thread never blocks on a slow console or syslog. If the ring is full the
+ * message is dropped and counted, the writer thread reports the number of
+ * dropped messages once it catches up.
+ *
+ * The ring is guarded by a mutex which is only held while a line is copied
+ * in, or while the writer swaps a batch out. The writer does the I/O without
+ * the lock, so producers never wait on it.
+ *
+ * The writer thread isn't started until Start() is called, and lines are
+ * buffered until then. Programs that fork or change their signal mask should
+ * do so before calling Start(), a thread doesn't survive fork() and it
+ * inherits the signal mask of the thread that created it.
+ */
+class AsyncLogDestination: public LogDestination {
+ public:
+  /**
+   * @brief Create a new AsyncLogDestination.
+   * @param destination the LogDestination to write to, ownership is
+   *   transferred.
+   * @param capacity the number of messages to buffer.
+   */
+  explicit AsyncLogDestination(LogDestination *destination,
+                               unsigned int capacity = DEFAULT_CAPACITY);
+
+  /**
+   * @brief Destructor.
+   *
+   * This writes any buffered messages and stops the writer thread.
+   */
+  ~AsyncLogDestination();
+
+  /**
+   * @brief Start the writer thread.
+   * @returns true if the writer is running, false if it couldn't be started.
+   */
+  bool Start();
+
+  /**
+   * @brief Queue a line to be written.
+   */
+  void Write(log_level level, const std::string &log_line);
+
+  /**
+   * @brief Block until all queued lines have been written.
+   *
+   * If the writer hasn't been started, the lines are written by the calling
+   * thread.
+   */
+  void Flush();
+
+  /**
+   * @brief The number of messages dropped because the ring was full.
+   */
+  unsigned int DroppedMessages();
+
+  static const unsigned int DEFAULT_CAPACITY = 1024;
+
+ private:
+  struct LogEntry {
+    LogEntry() : level(OLA_LOG_NONE) {}
+
+    log_level level;
+    std::string line;
+  };
+
+  class WriterThread: public ola::thread::Thread {
+   public:
+    explicit WriterThread(AsyncLogDestination *parent)
+        : ola::thread::Thread(Options("ola-log")),
+          m_parent(parent) {
+    }
+
+   protected:
+    void *Run();
+
+   private:
+    AsyncLogDestination *m_parent;
+  };
+
+  LogDestination *m_destination;
+  WriterThread m_thread;
+
+  // All of these are protected by m_mutex
+  ola::thread::Mutex m_mutex;
+  ola::thread::ConditionVariable m_data_ready;
+  ola::thread::ConditionVariable m_drained;
+  std::vector<LogEntry> m_ring;
+  unsigned int m_head;
+  unsigned int m_count;
+  unsigned int m_dropped;
+  unsigned int m_total_dropped;
+  bool m_started;
+  bool m_writing;
+  bool m_stop;
+
+  void WriteLoop();
+  void WriteQueuedLines();
+
+  DISALLOW_COPY_AND_ASSIGN(AsyncLogDestination);
+};
+/**@}*/
+}  // namespace ola
+#endif  // INCLUDE_OLA_BASE_ASYNCLOGDESTINATION_H_
@@ -153,6 +153,24 @@ typedef SingleUseCallback3<void, const Result&,
                            const RDMMetadata&,
                            const ola::rdm::RDMResponse*> RDMCallback;
 
+/**
+ * @brief Called when OlaClient::RDMBulkGet() completes.
+ * @param result the Result of the API call.
+ * @param results a RDMBulkGetResult for each UID & PID, in UID then PID
+ * order. The RDMResponse objects are deleted once the callback returns.
+ */
+typedef SingleUseCallback2<void, const Result&,
+                           const std::vector<RDMBulkGetResult>&>
+    RDMBulkGetCallback;
+
+/**
+ * @brief Called for each result of OlaClient::StreamRDMBulkGet() as it
+ * arrives.
+ * @param result the RDMBulkGetResult. The RDMResponse object is deleted once
+ * the callback returns.
+ */
+typedef Callback1<void, const RDMBulkGetResult&> RDMBulkGetResultCallback;
+
 
 }  // namespace client
 }  // namespace ola
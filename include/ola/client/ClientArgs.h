@@ -96,6 +96,41 @@ struct SendDMXArgs {
   }
 };
 
+/**
+ * @brief Arguments used with OlaClient::RegisterUniverse() to limit the DMX
+ * updates that are sent to the client.
+ */
+struct RegisterArgs {
+  /**
+   * @brief The first slot to receive, defaults to 0.
+   */
+  unsigned int start_slot;
+  /**
+   * @brief The number of slots to receive. Defaults to 0, which means all
+   * slots from start_slot to the end of the universe.
+   */
+  unsigned int slot_count;
+  /**
+   * @brief The maximum number of updates per second. Defaults to 0, which
+   * means every update is sent.
+   */
+  unsigned int max_rate;
+  /**
+   * @brief Only send an update if the slots have changed. Defaults to false.
+   */
+  bool changes_only;
+
+  /**
+   * @brief Create a new RegisterArgs object
+   */
+  RegisterArgs()
+      : start_slot(0),
+        slot_count(0),
+        max_rate(0),
+        changes_only(false) {
+  }
+};
+
 /**
  * @brief Arguments used with OlaClient::RDMGet() and OlaClient::RDMSet()
  * methods.
@@ -22,8 +22,11 @@
 #define INCLUDE_OLA_CLIENT_CLIENTTYPES_H_
 
 #include <ola/dmx/SourcePriorities.h>
+#include <ola/rdm/RDMCommand.h>
 #include <ola/rdm/RDMFrame.h>
 #include <ola/rdm/RDMResponseCodes.h>
+#include <ola/rdm/UID.h>
+#include <ola/thread/Future.h>
 
 #include <olad/PortConstants.h>
 
@@ -317,11 +320,18 @@ struct DMXMetadata {
    * @brief The priority of the DMX frame.
    */
   uint8_t priority;
+  /**
+   * @brief The slot the DMX data starts at. This is only non-0 if the
+   * universe was registered with a start slot.
+   */
+  unsigned int start_slot;
 
   explicit DMXMetadata(unsigned int _universe,
-                       uint8_t _priority = ola::dmx::SOURCE_PRIORITY_DEFAULT)
+                       uint8_t _priority = ola::dmx::SOURCE_PRIORITY_DEFAULT,
+                       unsigned int _start_slot = 0)
       : universe(_universe),
-        priority(_priority) {
+        priority(_priority),
+        start_slot(_start_slot) {
   }
 };
 
@@ -350,6 +360,121 @@ struct RDMMetadata {
       : response_code(_response_code) {
   }
 };
+
+/**
+ * @brief The result of a single GET made by OlaClient::RDMBulkGet().
+ */
+struct RDMBulkGetResult {
+  /**
+   * @brief The UID the GET was sent to.
+   */
+  ola::rdm::UID uid;
+
+  /**
+   * @brief The PID that was requested.
+   */
+  uint16_t param_id;
+
+  /**
+   * @brief The metadata for the response, including the rdm_response_code.
+   */
+  RDMMetadata metadata;
+
+  /**
+   * @brief The RDM Response, or NULL if no response was received.
+   */
+  const ola::rdm::RDMResponse *response;
+
+  /**
+   * @brief True if the server answered from its cache of static PIDs.
+   */
+  bool cached;
+
+  RDMBulkGetResult(const ola::rdm::UID &_uid, uint16_t _param_id)
+      : uid(_uid),
+        param_id(_param_id),
+        response(NULL),
+        cached(false) {
+  }
+};
+
+/**
+ * @brief The outcome of a RDM command sent with OlaClient::Batch.
+ *
+ * Unlike the arguments passed to a RDMCallback, this can be copied, so it can
+ * be delivered through a RDMFuture. Each copy holds its own copy of the
+ * response.
+ */
+class RDMCommandResult {
+ public:
+  RDMCommandResult()
+      : m_response(NULL) {
+  }
+
+  /**
+   * @param error the error from the RPC layer, empty if the RPC succeeded.
+   * @param metadata the RDMMetadata for the response.
+   * @param response the response, may be NULL. Ownership is not transferred.
+   */
+  RDMCommandResult(const std::string &error,
+                   const RDMMetadata &metadata,
+                   const ola::rdm::RDMResponse *response)
+      : m_error(error),
+        m_metadata(metadata),
+        m_response(response ? response->Duplicate() : NULL) {
+  }
+
+  RDMCommandResult(const RDMCommandResult &other)
+      : m_error(other.m_error),
+        m_metadata(other.m_metadata),
+        m_response(other.m_response ? other.m_response->Duplicate() : NULL) {
+  }
+
+  ~RDMCommandResult() {
+    delete m_response;
+  }
+
+  RDMCommandResult& operator=(const RDMCommandResult &other) {
+    if (this != &other) {
+      delete m_response;
+      m_error = other.m_error;
+      m_metadata = other.m_metadata;
+      m_response = other.m_response ? other.m_response->Duplicate() : NULL;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Indicates if the command was delivered to the server.
+   * The RDM status is available from Metadata().
+   */
+  bool Success() const { return m_error.empty(); }
+
+  /**
+   * @brief The error message if Success() is false.
+   */
+  const std::string& Error() const { return m_error; }
+
+  /**
+   * @brief The metadata for the response, including the rdm_response_code.
+   */
+  const RDMMetadata& Metadata() const { return m_metadata; }
+
+  /**
+   * @brief The RDM Response, or NULL if no response was received.
+   */
+  const ola::rdm::RDMResponse *Response() const { return m_response; }
+
+ private:
+  std::string m_error;
+  RDMMetadata m_metadata;
+  ola::rdm::RDMResponse *m_response;
+};
+
+/**
+ * @brief Completes when a RDM command sent with OlaClient::Batch finishes.
+ */
+typedef ola::thread::Future<RDMCommandResult> RDMFuture;
 }  // namespace client
 }  // namespace ola
 #endif  // INCLUDE_OLA_CLIENT_CLIENTTYPES_H_
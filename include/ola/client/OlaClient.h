@@ -34,6 +34,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace ola {
 namespace client {
@@ -175,6 +176,21 @@ class OlaClient {
                                uint8_t value,
                                SetCallback *callback);
 
+  /**
+   * @brief Set the frame rate limits for an output port.
+   * @param device_alias the device containing the port to change
+   * @param port the port id of the output port to change.
+   * @param max_frame_rate the maximum frames per second, 0 means no limit.
+   * @param refresh_interval resend the last frame if none has been written
+   *   for this many ms, 0 disables this.
+   * @param callback the SetCallback to invoke upon completion.
+   */
+  void SetPortFrameRate(unsigned int device_alias,
+                        unsigned int port,
+                        unsigned int max_frame_rate,
+                        unsigned int refresh_interval,
+                        SetCallback *callback);
+
   /**
    * @brief Request a list of universes.
    * @param callback the UniverseListCallback to invoke upon completion.
@@ -238,6 +254,21 @@ class OlaClient {
                         RegisterAction register_action,
                         SetCallback *callback);
 
+  /**
+   * @brief Register our interest in part of a universe.
+   *
+   * This is the same as RegisterUniverse() with REGISTER, but only the
+   * updates selected by args are sent. If a slot range is used, the
+   * DMXMetadata passed to the DMX callback contains the start slot of the
+   * data.
+   * @param universe the id of the universe to register for.
+   * @param args the RegisterArgs that select the updates to receive.
+   * @param callback the SetCallback to invoke upon completion.
+   */
+  void RegisterUniverse(unsigned int universe,
+                        const RegisterArgs &args,
+                        SetCallback *callback);
+
   /**
    * @brief Send DMX data.
    * @param universe the universe to send to.
@@ -308,6 +339,47 @@ class OlaClient {
               unsigned int data_length,
               const SendRDMArgs& args);
 
+  /**
+   * @brief Send RDM Get Commands for a list of PIDs to a set of responders.
+   * @param universe the universe to send the commands on
+   * @param uids the UIDs to send the commands to, if empty all UIDs in the
+   *   universe are used.
+   * @param sub_device the sub device index
+   * @param pids the PIDs to fetch from each responder
+   * @param callback the RDMBulkGetCallback to invoke upon completion.
+   *
+   * The GETs are sent by the server, so this only needs a single round trip
+   * no matter how many responders and PIDs are requested.
+   */
+  void RDMBulkGet(unsigned int universe,
+                  const ola::rdm::UIDSet &uids,
+                  uint16_t sub_device,
+                  const std::vector<uint16_t> &pids,
+                  RDMBulkGetCallback *callback);
+
+  /**
+   * @brief Send RDM Get Commands for a list of PIDs to a set of responders,
+   * and receive each result as soon as it arrives.
+   * @param universe the universe to send the commands on
+   * @param uids the UIDs to send the commands to, if empty all UIDs in the
+   *   universe are used.
+   * @param sub_device the sub device index
+   * @param pids the PIDs to fetch from each responder
+   * @param on_result the RDMBulkGetResultCallback to run for each result, in
+   *   the order the responses arrive. Ownership is transferred.
+   * @param on_complete the SetCallback to run once all the results have been
+   *   received.
+   *
+   * Unlike RDMBulkGet(), the results aren't held until the last GET
+   * completes.
+   */
+  void StreamRDMBulkGet(unsigned int universe,
+                        const ola::rdm::UIDSet &uids,
+                        uint16_t sub_device,
+                        const std::vector<uint16_t> &pids,
+                        RDMBulkGetResultCallback *on_result,
+                        SetCallback *on_complete);
+
   /**
    * @brief Send TimeCode data.
    * @param timecode The timecode data.
@@ -316,6 +388,147 @@ class OlaClient {
   void SendTimeCode(const ola::timecode::TimeCode &timecode,
                     SetCallback *callback);
 
+  /**
+   * @brief Collects RDM commands and sends them to the server in a single
+   * RPC.
+   *
+   * Sending commands one at a time costs a RPC round trip, and an allocation
+   * of the RPC state, per command. A Batch queues the commands until Send() is
+   * called. The server then sends them to the responders in order, and
+   * returns all the responses in one reply.
+   *
+   * Each command can either run a RDMCallback, like OlaClient::RDMGet(), or
+   * return a RDMFuture. Callbacks and futures complete on the thread running
+   * the client's SelectServer, so RDMFuture::Get() must only be called from
+   * another thread.
+   *
+   * @examplepara
+   *   @code
+   *   OlaClient::Batch batch(client);
+   *   vector<RDMFuture> futures;
+   *   for (...) {
+   *     futures.push_back(batch.RDMSet(universe, uid, ROOT_RDM_DEVICE,
+   *                                    PID_DMX_START_ADDRESS, data, 2));
+   *   }
+   *   batch.Send();
+   *   @endcode
+   */
+  class Batch {
+   public:
+    /**
+     * @brief Create a new Batch.
+     * @param client the OlaClient to send the commands with.
+     */
+    explicit Batch(OlaClient *client);
+
+    /**
+     * @brief Destructor.
+     *
+     * Commands that haven't been sent are completed with an error.
+     */
+    ~Batch();
+
+    /**
+     * @brief Queue a RDM Get Command.
+     * @param universe the universe to send the command on
+     * @param uid the UID to send the command to
+     * @param sub_device the sub device index
+     * @param pid the PID to address
+     * @param data the optional data to send
+     * @param data_length the length of the data
+     * @param args the RDM arguments which includes the callback to run.
+     */
+    void RDMGet(unsigned int universe,
+                const ola::rdm::UID &uid,
+                uint16_t sub_device,
+                uint16_t pid,
+                const uint8_t *data,
+                unsigned int data_length,
+                const SendRDMArgs& args);
+
+    /**
+     * @brief Queue a RDM Get Command.
+     * @param universe the universe to send the command on
+     * @param uid the UID to send the command to
+     * @param sub_device the sub device index
+     * @param pid the PID to address
+     * @param data the optional data to send
+     * @param data_length the length of the data
+     * @returns a RDMFuture that completes when the response arrives.
+     */
+    RDMFuture RDMGet(unsigned int universe,
+                     const ola::rdm::UID &uid,
+                     uint16_t sub_device,
+                     uint16_t pid,
+                     const uint8_t *data = NULL,
+                     unsigned int data_length = 0);
+
+    /**
+     * @brief Queue a RDM Set Command.
+     * @param universe the universe to send the command on
+     * @param uid the UID to send the command to
+     * @param sub_device the sub device index
+     * @param pid the PID to address
+     * @param data the optional data to send
+     * @param data_length the length of the data
+     * @param args the RDM arguments which includes the callback to run.
+     */
+    void RDMSet(unsigned int universe,
+                const ola::rdm::UID &uid,
+                uint16_t sub_device,
+                uint16_t pid,
+                const uint8_t *data,
+                unsigned int data_length,
+                const SendRDMArgs& args);
+
+    /**
+     * @brief Queue a RDM Set Command.
+     * @param universe the universe to send the command on
+     * @param uid the UID to send the command to
+     * @param sub_device the sub device index
+     * @param pid the PID to address
+     * @param data the optional data to send
+     * @param data_length the length of the data
+     * @returns a RDMFuture that completes when the response arrives.
+     */
+    RDMFuture RDMSet(unsigned int universe,
+                     const ola::rdm::UID &uid,
+                     uint16_t sub_device,
+                     uint16_t pid,
+                     const uint8_t *data = NULL,
+                     unsigned int data_length = 0);
+
+    /**
+     * @brief The number of commands waiting to be sent.
+     */
+    unsigned int Size() const { return m_commands.size(); }
+
+    /**
+     * @brief Send the queued commands.
+     *
+     * Large batches are split across several RPCs. The Batch is empty
+     * afterwards and can be reused.
+     */
+    void Send();
+
+   private:
+    class OlaClientCore *m_core;
+    std::vector<struct BatchedRDMCommand*> m_commands;
+
+    void Add(bool is_set,
+             unsigned int universe,
+             const ola::rdm::UID &uid,
+             uint16_t sub_device,
+             uint16_t pid,
+             const uint8_t *data,
+             unsigned int data_length,
+             RDMCallback *callback,
+             bool include_raw_frames,
+             RDMFuture *future);
+
+    DISALLOW_COPY_AND_ASSIGN(Batch);
+  };
+
  private:
   std::auto_ptr<class OlaClientCore> m_core;
 
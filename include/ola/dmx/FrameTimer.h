@@ -0,0 +1,220 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * FrameTimer.h
+ * Precise timing for threads that generate DMX512 frames.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file FrameTimer.h
+ * @brief Precise timing for threads that generate DMX512 frames.
+ */
+
+#ifndef INCLUDE_OLA_DMX_FRAMETIMER_H_
+#define INCLUDE_OLA_DMX_FRAMETIMER_H_
+
+#include <ola/Clock.h>
+#include <ola/ExportMap.h>
+#include <ola/base/Macro.h>
+#include <ola/thread/Mutex.h>
+#include <ola/thread/SchedulerInterface.h>
+#include <string>
+
+namespace ola {
+namespace dmx {
+
+/**
+ * @brief Generates the timing for a DMX512 output thread.
+ *
+ * Widgets that rely on the host to generate the break, mark after break and
+ * the inter-frame gap need more precision than usleep() provides. The
+ * FrameTimer sleeps until absolute deadlines on the monotonic clock, so
+ * errors don't accumulate, and finishes each wait with a short busy wait.
+ *
+ * If a frame rate is set, StartFrame() holds the output to that rate. The
+ * achieved frame rate and the jitter of the frame start are measured each
+ * second and, if an ExportMap was provided, published under the
+ * dmx-output-* variables.
+ *
+ * The ExportMap isn't thread safe, so the output thread never touches it.
+ * PublishStats() copies the latest statistics into it, and must be called
+ * from the thread that owns the ExportMap. If a scheduler is provided the
+ * timer does this once a second.
+ *
+ * Apart from the constructor, the destructor, PublishStats() and the
+ * statistics accessors, all methods should be called from the output thread.
+ *
+ * @examplepara
+ *   @code
+ *   FrameTimer timer(options, export_map, device_path);
+ *   timer.ConfigureThread();
+ *   while (running) {
+ *     timer.StartFrame();
+ *     widget->SetBreak(true);
+ *     timer.Delay(break_time);
+ *     widget->SetBreak(false);
+ *     timer.Delay(mab_time);
+ *     widget->Write(frame);
+ *   }
+ *   @endcode
+ */
+class FrameTimer {
+ public:
+  struct Options {
+    /**
+     * @brief The target frames per second, or 0 to start each frame as soon
+     * as the previous one is complete.
+     */
+    unsigned int frame_rate;
+
+    /**
+     * @brief Waits are finished with a busy wait for this many microseconds,
+     * 0 disables busy waiting.
+     */
+    unsigned int spin_time;
+
+    /**
+     * @brief If non-0, ConfigureThread() switches the thread to SCHED_FIFO
+     * with this priority.
+     */
+    unsigned int realtime_priority;
+
+    /**
+     * @brief If non-negative, ConfigureThread() pins the thread to this CPU.
+     */
+    int cpu;
+
+    Options()
+        : frame_rate(0),
+          spin_time(DEFAULT_SPIN_TIME),
+          realtime_priority(0),
+          cpu(-1) {
+    }
+  };
+
+  /**
+   * @brief Create a new FrameTimer.
+   * @param options the timer options.
+   * @param export_map the ExportMap to publish the timing statistics to, may
+   *   be NULL.
+   * @param device the key to use in the ExportMap.
+   * @param scheduler the scheduler for the thread that owns the ExportMap,
+   *   used to publish the statistics. May be NULL, in which case the owner
+   *   calls PublishStats().
+   */
+  explicit FrameTimer(const Options &options,
+                      ExportMap *export_map = NULL,
+                      const std::string &device = "",
+                      ola::thread::SchedulerInterface *scheduler = NULL);
+
+  ~FrameTimer();
+
+  /**
+   * @brief Apply the scheduling options to the calling thread.
+   * @returns true if all options were applied, false if any failed. The
+   *   timer works either way, with less precision.
+   */
+  bool ConfigureThread();
+
+  /**
+   * @brief Mark the start of a new frame.
+   *
+   * If a frame rate is set, this waits until the frame is due.
+   */
+  void StartFrame();
+
+  /**
+   * @brief Wait for an interval.
+   * @param microseconds the time to wait for.
+   */
+  void Delay(unsigned int microseconds);
+
+  /**
+   * @brief Wait until a point in time.
+   * @param deadline the time to wait until, from the monotonic clock.
+   */
+  void WaitUntil(const TimeStamp &deadline);
+
+  /**
+   * @brief Copy the latest statistics to the ExportMap.
+   *
+   * This must be called from the thread that owns the ExportMap.
+   */
+  void PublishStats();
+
+  /**
+   * @brief The number of frames started in the last complete second.
+   */
+  unsigned int FrameRate() const;
+
+  /**
+   * @brief The mean jitter in microseconds over the last complete second.
+   *
+   * If a frame rate is set, this is how late each frame started. Otherwise
+   * it's the change in the frame period from one frame to the next.
+   */
+  unsigned int Jitter() const;
+
+  /**
+   * @brief The largest jitter in microseconds in the last complete second.
+   */
+  unsigned int MaxJitter() const;
+
+  static const unsigned int DEFAULT_SPIN_TIME = 100;
+
+ private:
+  const Options m_options;
+  const std::string m_device;
+  Clock m_clock;
+  TimeInterval m_frame_interval;
+  TimeStamp m_next_frame;
+  TimeStamp m_last_frame;
+  TimeInterval m_last_period;
+
+  // The statistics for the current second.
+  TimeStamp m_window_start;
+  unsigned int m_window_frames;
+  uint64_t m_window_jitter;
+  unsigned int m_window_max_jitter;
+
+  // The statistics for the last complete second, protected by m_stats_mutex.
+  mutable ola::thread::Mutex m_stats_mutex;
+  unsigned int m_frame_rate;
+  unsigned int m_jitter;
+  unsigned int m_max_jitter;
+
+  // Only used by the thread that owns the ExportMap.
+  ola::thread::SchedulerInterface *m_scheduler;
+  ola::thread::timeout_id m_publish_timeout;
+  UIntMap *m_frame_rate_var;
+  UIntMap *m_jitter_var;
+  UIntMap *m_max_jitter_var;
+
+  void SleepUntil(const TimeStamp &wake_up);
+  void RecordFrame(const TimeStamp &now, const TimeInterval &jitter);
+  bool PublishTimeout();
+
+  static const char DEVICE_LABEL[];
+  static const char FRAME_RATE_VAR[];
+  static const char JITTER_VAR[];
+  static const char MAX_JITTER_VAR[];
+  static const unsigned int PUBLISH_INTERVAL_MS = 1000;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameTimer);
+};
+}  // namespace dmx
+}  // namespace ola
+#endif  // INCLUDE_OLA_DMX_FRAMETIMER_H_
@@ -24,6 +24,7 @@
 #include <ola/Callback.h>
 #include <ola/base/Macro.h>
 #include <ola/e133/MessageBuilder.h>
+#include <ola/io/SelectServer.h>
 #include <ola/io/SelectServerInterface.h>
 #include <ola/network/IPV4Address.h>
 #include <ola/network/SocketAddress.h>
@@ -63,6 +64,18 @@ class DeviceManager {
 
     DeviceManager(ola::io::SelectServerInterface *ss,
                   ola::e133::MessageBuilder *message_builder);
+
+    /**
+     * @brief Create a DeviceManager that handles the connections on a number
+     *   of I/O threads.
+     * @param ss the SelectServer to run the callbacks on.
+     * @param message_builder the MessageBuilder to use.
+     * @param io_threads the number of I/O threads, 0 means the connections
+     *   are handled on ss.
+     */
+    DeviceManager(ola::io::SelectServer *ss,
+                  ola::e133::MessageBuilder *message_builder,
+                  unsigned int io_threads);
     ~DeviceManager();
 
     // Ownership of the callbacks is transferred.
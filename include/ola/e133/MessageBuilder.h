@@ -64,6 +64,9 @@ class MessageBuilder {
 
     ola::io::MemoryBlockPool *pool() { return &m_memory_pool; }
 
+    const CID &cid() const { return m_cid; }
+    const string &source_name() const { return m_source_name; }
+
  private:
     const CID m_cid;
     const string m_source_name;
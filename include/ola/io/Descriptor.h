@@ -305,7 +305,9 @@ class ConnectedDescriptor: public BidirectionalFileDescriptor {
    * @return the number of bytes written.
    *
    * This attempts to send as much of the IOQueue data as possible. The IOQueue
-   * may be non-empty when this completes if the descriptor buffer is full.
+   * may be non-empty when this completes if the descriptor buffer is full, or
+   * if the queue holds more than IOV_MAX blocks, since at most IOV_MAX blocks
+   * are written per call.
    * @returns the number of bytes sent.
    */
   virtual ssize_t Send(IOQueue *data);
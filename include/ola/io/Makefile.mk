@@ -19,4 +19,5 @@ olaioinclude_HEADERS = \
     include/ola/io/SelectServer.h \
     include/ola/io/SelectServerInterface.h \
     include/ola/io/Serial.h \
+    include/ola/io/SerialBuffer.h \
     include/ola/io/StdinHandler.h
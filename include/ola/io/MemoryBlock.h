@@ -121,6 +121,22 @@ class MemoryBlock {
       return bytes_to_write;
     }
 
+    /**
+     * @brief Mark free space at the end of the block as valid data.
+     *
+     * This is used when the data has been written directly to the memory
+     * starting at Data() + Size(), rather than copied in with Append().
+     * @param length the number of bytes to add to the block.
+     * @returns the number of bytes added, which will be less than length if
+     * the block is now full.
+     */
+    unsigned int Extend(unsigned int length) {
+      unsigned int bytes_to_add = std::min(
+          length, static_cast<unsigned int>(m_data_end - m_last));
+      m_last += bytes_to_add;
+      return bytes_to_add;
+    }
+
     /**
      * @brief Prepend data to this block.
      * @param data the data to prepend.
@@ -167,6 +183,18 @@ class MemoryBlock {
       return bytes_to_pop;
     }
 
+    /**
+     * @brief Remove data from the end of the block
+     * @param length the amount of data to remove
+     * @returns the amount of data removed.
+     */
+    unsigned int PopBack(unsigned int length) {
+      unsigned int bytes_to_pop = std::min(
+          length, static_cast<unsigned int>(m_last - m_first));
+      m_last -= bytes_to_pop;
+      return bytes_to_pop;
+    }
+
  private:
     uint8_t* const m_data;
     uint8_t* const m_data_end;
@@ -0,0 +1,139 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * SerialBuffer.h
+ * Buffered reads and writes for framed serial protocols.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @file SerialBuffer.h
+ * @brief Buffered reads and writes for framed serial protocols.
+ *
+ * Widgets that speak a framed protocol over a serial port used to read the
+ * frame a byte at a time, which costs a system call per byte. A SerialBuffer
+ * reads everything that's available in one call, and lets the widget parse
+ * complete frames from the buffered data.
+ *
+ * On the write side, if the descriptor only accepts part of a frame the
+ * remainder is queued and written before any later frames, so the framing on
+ * the wire stays intact.
+ */
+
+#ifndef INCLUDE_OLA_IO_SERIALBUFFER_H_
+#define INCLUDE_OLA_IO_SERIALBUFFER_H_
+
+#include <ola/base/Macro.h>
+#include <ola/io/Descriptor.h>
+#include <ola/io/IOQueue.h>
+#include <ola/io/SelectServerInterface.h>
+#include <stdint.h>
+
+namespace ola {
+namespace io {
+
+/**
+ * @brief Buffered reads and writes for a ConnectedDescriptor.
+ */
+class SerialBuffer {
+ public:
+  /**
+   * @brief Create a new SerialBuffer.
+   * @param descriptor the descriptor to read from and write to, ownership is
+   *   not transferred.
+   * @param ss the SelectServer used to resume partial writes once the
+   *   descriptor is writable. If NULL, queued data is written on the next call
+   *   to Send().
+   * @param read_size the size of the receive buffer, this should be larger
+   *   than the largest frame.
+   * @param max_pending the maximum number of bytes to queue for writing.
+   */
+  explicit SerialBuffer(ConnectedDescriptor *descriptor,
+                        SelectServerInterface *ss = NULL,
+                        unsigned int read_size = DEFAULT_READ_SIZE,
+                        unsigned int max_pending = DEFAULT_MAX_PENDING);
+  ~SerialBuffer();
+
+  /**
+   * @brief Read all available data from the descriptor into the buffer.
+   * @returns the number of bytes read.
+   */
+  unsigned int Read();
+
+  /**
+   * @brief The buffered data.
+   */
+  const uint8_t *Data() const { return m_read_buffer + m_read_offset; }
+
+  /**
+   * @brief The number of bytes buffered.
+   */
+  unsigned int Size() const { return m_read_end - m_read_offset; }
+
+  /**
+   * @brief Remove data from the front of the buffer.
+   * @param length the number of bytes to remove.
+   */
+  void Consume(unsigned int length);
+
+  /**
+   * @brief Discard all buffered data.
+   */
+  void Clear() { m_read_offset = m_read_end = 0; }
+
+  /**
+   * @brief Discard data up to the first occurrence of a byte.
+   * @param value the byte to look for.
+   * @returns true if the byte is now at the front of the buffer, false if it
+   *   wasn't found, in which case the buffer is empty.
+   */
+  bool SkipTo(uint8_t value);
+
+  /**
+   * @brief Send a frame.
+   * @param data the frame to send.
+   * @param length the length of the frame.
+   * @returns true if the frame was sent or queued, false if there was too
+   *   much data already queued, or the descriptor is closed or failed.
+   */
+  bool Send(const uint8_t *data, unsigned int length);
+
+  /**
+   * @brief The number of bytes waiting to be written.
+   */
+  unsigned int PendingWrite() const { return m_pending.Size(); }
+
+  static const unsigned int DEFAULT_READ_SIZE = 2048;
+  static const unsigned int DEFAULT_MAX_PENDING = 4096;
+
+ private:
+  ConnectedDescriptor *m_descriptor;
+  SelectServerInterface *m_ss;
+  uint8_t *m_read_buffer;
+  const unsigned int m_read_size;
+  unsigned int m_read_offset;
+  unsigned int m_read_end;
+  IOQueue m_pending;
+  const unsigned int m_max_pending;
+  bool m_associated;
+
+  bool Flush();
+  void PerformWrite();
+
+  DISALLOW_COPY_AND_ASSIGN(SerialBuffer);
+};
+}  // namespace io
+}  // namespace ola
+#endif  // INCLUDE_OLA_IO_SERIALBUFFER_H_
@@ -0,0 +1,150 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * BatchedHealthChecker.h
+ * Health checks a large number of connections from a single timer.
+ * Copyright (C) 2026 Simon Newton
+ *
+ * HealthCheckedConnection uses two timers per connection, and re-registers
+ * the receive timer for every heartbeat. That's fine for a handful of
+ * connections but with thousands the timer queue dominates.
+ *
+ * The BatchedHealthChecker implements the same protocol (send a heartbeat
+ * every interval I, declare the connection dead if nothing arrives within
+ * 2.5 * I) using a timing wheel. The connections are spread across a number
+ * of slots and a single repeating timer visits one slot every I / slots. This
+ * spreads the heartbeats evenly over the interval rather than sending them in
+ * bursts, and recording a received heartbeat is just a timestamp update.
+ *
+ * The cost is resolution: a dead connection is detected between 2.5 * I and
+ * 2.5 * I + I after the last heartbeat.
+ */
+
+#ifndef INCLUDE_OLA_NETWORK_BATCHEDHEALTHCHECKER_H_
+#define INCLUDE_OLA_NETWORK_BATCHEDHEALTHCHECKER_H_
+
+#include <ola/Callback.h>
+#include <ola/Clock.h>
+#include <ola/base/Macro.h>
+#include <ola/thread/SchedulerInterface.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ola {
+namespace network {
+
+/**
+ * Health checks many connections using a single repeating timer.
+ */
+class BatchedHealthChecker {
+ public:
+    /**
+     * The interface for connections managed by the BatchedHealthChecker.
+     */
+    class Connection {
+     public:
+        virtual ~Connection() {}
+
+        /**
+         * Send a heartbeat on this connection.
+         */
+        virtual void SendHeartbeat() = 0;
+
+        /**
+         * Called when no heartbeat has been received within the timeout. The
+         * connection has already been removed from the health checker when
+         * this runs.
+         */
+        virtual void HeartbeatTimeout() = 0;
+    };
+
+    /**
+     * @brief Create a new BatchedHealthChecker.
+     * @param scheduler the scheduler to register the timer with.
+     * @param clock the clock to use, this should be the same as the one used
+     *   by the scheduler.
+     * @param heartbeat_interval the interval between heartbeats.
+     * @param slots the number of slots in the wheel.
+     */
+    BatchedHealthChecker(ola::thread::SchedulerInterface *scheduler,
+                         const ola::Clock *clock,
+                         const ola::TimeInterval &heartbeat_interval,
+                         unsigned int slots = DEFAULT_SLOTS);
+    ~BatchedHealthChecker();
+
+    /**
+     * @brief Start health checking a connection.
+     *
+     * This sends the first heartbeat immediately. Ownership is not
+     * transferred.
+     */
+    void AddConnection(Connection *connection);
+
+    /**
+     * @brief Stop health checking a connection.
+     */
+    void RemoveConnection(Connection *connection);
+
+    /**
+     * @brief Call this every time a heartbeat, or any other message that
+     * counts as one, is received.
+     */
+    void HeartbeatReceived(Connection *connection);
+
+    /**
+     * @brief Call this when a heartbeat is piggybacked on another message.
+     * This suppresses the next heartbeat for the connection.
+     */
+    void HeartbeatSent(Connection *connection);
+
+    /**
+     * @brief The number of connections being health checked.
+     */
+    unsigned int ConnectionCount() const { return m_connections.size(); }
+
+    static const unsigned int DEFAULT_SLOTS = 10;
+
+ private:
+    struct ConnectionState {
+      unsigned int slot;
+      ola::TimeStamp last_received;
+      ola::TimeStamp last_sent;
+    };
+
+    typedef std::map<Connection*, ConnectionState> ConnectionMap;
+    typedef std::set<Connection*> Slot;
+
+    ola::thread::SchedulerInterface *m_scheduler;
+    const ola::Clock *m_clock;
+    const ola::TimeInterval m_tick_interval;
+    // Each connection is visited once per interval, a heartbeat is sent
+    // unless one was piggybacked less than this long ago.
+    const ola::TimeInterval m_send_after;
+    const ola::TimeInterval m_receive_timeout;
+    ConnectionMap m_connections;
+    std::vector<Slot> m_slots;
+    unsigned int m_next_slot;
+    unsigned int m_current_slot;
+    ola::thread::timeout_id m_timeout_id;
+
+    bool Tick();
+
+    DISALLOW_COPY_AND_ASSIGN(BatchedHealthChecker);
+};
+}  // namespace network
+}  // namespace ola
+#endif  // INCLUDE_OLA_NETWORK_BATCHEDHEALTHCHECKER_H_
@@ -35,6 +35,7 @@
 #include <ola/io/IOQueue.h>
 #include <ola/network/IPV4Address.h>
 #include <string>
+#include <vector>
 
 namespace ola {
 namespace network {
@@ -135,6 +136,22 @@ class UDPSocketInterface: public ola::io::BidirectionalFileDescriptor {
   virtual ssize_t SendTo(ola::io::IOVecInterface *data,
                          const IPV4SocketAddress &dest) const = 0;
 
+  /**
+   * @brief Send the same datagram to many destinations.
+   * @param buffer the data to send
+   * @param size the length of the data
+   * @param destinations the IP:Ports to send the datagram to.
+   * @return the number of destinations the datagram was sent to.
+   *
+   * The default implementation calls SendTo() for each destination.
+   * UDPSocket overrides this to use a single system call where the platform
+   * supports it.
+   */
+  virtual unsigned int SendToMany(
+      const uint8_t *buffer,
+      unsigned int size,
+      const std::vector<IPV4SocketAddress> &destinations) const;
+
   /**
    * @brief Receive data
    * @param buffer the buffer to store the data
@@ -262,6 +279,10 @@ class UDPSocket: public UDPSocketInterface {
                  unsigned short port) const;
   ssize_t SendTo(ola::io::IOVecInterface *data,
                  const IPV4SocketAddress &dest) const;
+  unsigned int SendToMany(
+      const uint8_t *buffer,
+      unsigned int size,
+      const std::vector<IPV4SocketAddress> &destinations) const;
 
   bool RecvFrom(uint8_t *buffer, ssize_t *data_read) const;
   bool RecvFrom(uint8_t *buffer,
@@ -286,6 +307,18 @@ class UDPSocket: public UDPSocketInterface {
 
   bool SetTos(uint8_t tos);
 
+  /**
+   * @brief Control if the socket receives multicast traffic for groups that
+   *   were joined by other sockets.
+   *
+   * Linux delivers a multicast datagram to every socket bound to the
+   * destination port, even if the socket never joined the group. This isn't
+   * supported on other platforms.
+   * @param enable false to only receive traffic for groups this socket joined.
+   * @return true if it worked, false otherwise
+   */
+  bool SetMulticastAll(bool enable);
+
  private:
   ola::io::DescriptorHandle m_handle;
   bool m_bound_to_port;
@@ -117,7 +117,8 @@ class DiscoveryTargetInterface {
  * the DiscoveryAgent.
  *
  * The discovery process goes something like this:
- *   - if incremental, copy all previously discovered UIDs to the mute list
+ *   - if incremental, copy all previously discovered (or seeded) UIDs to the
+ *     mute list
  *   - push (0, 0xffffffffffff) onto the resolution stack
  *   - unmute all
  *   - mute all previously discovered UIDs, for any that fail to mute remove
@@ -167,6 +168,18 @@ class DiscoveryAgent {
    */
   void StartIncrementalDiscovery(DiscoveryCompleteCallback *on_complete);
 
+  /**
+   * @brief Seed the agent with a set of previously known UIDs.
+   * @param uids the UIDs to treat as already discovered.
+   *
+   * This is used to warm-start discovery, for example with UIDs cached from a
+   * previous run. The next incremental discovery will mute each of these
+   * UIDs directly, dropping any that fail to ack, and then only has to branch
+   * for responders that weren't already known. This is ignored if a discovery
+   * operation is running.
+   */
+  void SetKnownUIDs(const UIDSet &uids);
+
  private:
   /**
    * @brief Represents a range of UIDs (a branch of the UID tree)
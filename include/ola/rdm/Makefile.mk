@@ -19,6 +19,7 @@ olardminclude_HEADERS = \
     include/ola/rdm/OpenLightingEnums.h \
     include/ola/rdm/PidStore.h \
     include/ola/rdm/PidStoreHelper.h \
+    include/ola/rdm/PipeliningRDMController.h \
     include/ola/rdm/QueueingRDMController.h \
     include/ola/rdm/RDMAPI.h \
     include/ola/rdm/RDMAPIImplInterface.h \
@@ -45,6 +46,7 @@ olardminclude_HEADERS = \
     include/ola/rdm/SubDeviceDispatcher.h \
     include/ola/rdm/UID.h \
     include/ola/rdm/UIDAllocator.h \
+    include/ola/rdm/UIDMap.h \
     include/ola/rdm/UIDSet.h
 nodist_olardminclude_HEADERS = include/ola/rdm/RDMResponseCodes.h
 
@@ -32,6 +32,7 @@
 #include <stdint.h>
 #include <ola/messaging/Descriptor.h>
 #include <ola/base/Macro.h>
+#include <ola/thread/Mutex.h>
 #include <istream>
 #include <map>
 #include <memory>
@@ -44,6 +45,26 @@ namespace rdm {
 class PidStore;
 class PidDescriptor;
 
+/**
+ * @brief Builds the PidStore for a manufacturer on demand.
+ *
+ * This allows a RootPidStore to defer the construction of the manufacturer
+ * PidStores until they're used. Most programs only ever talk to devices from
+ * a handful of manufacturers.
+ */
+class ManufacturerStoreBuilder {
+ public:
+  virtual ~ManufacturerStoreBuilder() {}
+
+  /**
+   * @brief Build the PidStore for a manufacturer.
+   * @param esta_id the manufacturer id.
+   * @returns A new PidStore, ownership is transferred to the caller, or NULL
+   *   if there are no parameters for this manufacturer.
+   */
+  virtual const PidStore *BuildStore(uint16_t esta_id) = 0;
+};
+
 // The following % before Device is to stop Doxygen interpreting it as a class
 /**
  * @brief The root of the RDM parameter descriptor store.
@@ -64,6 +85,11 @@ class PidDescriptor;
  * An overrides.proto file can be used as a local system override of any PID
  * data. This allows manufacturers to specify their own manufacturer specific
  * commands and for testing of draft PIDs.
+ *
+ * When loading from a directory the manufacturer PidStores are built the
+ * first time they're requested. If the directory contains a precompiled
+ * pids.pb file (see RootPidStore::PrecompileDirectory), it's used in place
+ * of the text format files, as long as they're the files it was built from.
  */
 class RootPidStore {
  public:
@@ -83,6 +109,22 @@ class RootPidStore {
         m_version(version) {
   }
 
+  /**
+   * @brief Create a new RootPidStore where the manufacturer PidStores are
+   * built on first use.
+   * @param esta_store the PidStore for the ESTA parameters.
+   * @param manufacturer_builder the ManufacturerStoreBuilder to use,
+   *   ownership is transferred.
+   * @param version the version of the parameter data.
+   */
+  RootPidStore(const PidStore *esta_store,
+               ManufacturerStoreBuilder *manufacturer_builder,
+               uint64_t version = 0)
+      : m_esta_store(esta_store),
+        m_manufacturer_builder(manufacturer_builder),
+        m_version(version) {
+  }
+
   ~RootPidStore();
 
   /**
@@ -168,9 +210,25 @@ class RootPidStore {
    */
   static const std::string DataLocation();
 
+  /**
+   * @brief Convert the PID data in a directory to the precompiled format.
+   * @param directory the directory containing the PID data.
+   * @param output_file the file to write the precompiled data to.
+   * @returns true if the data was valid and written, false otherwise.
+   *
+   * The overrides and manufacturer names files are not included, they are
+   * always loaded from the text format files.
+   */
+  static bool PrecompileDirectory(const std::string &directory,
+                                  const std::string &output_file);
+
  private:
   std::auto_ptr<const PidStore> m_esta_store;
-  ManufacturerMap m_manufacturer_store;
+  std::auto_ptr<ManufacturerStoreBuilder> m_manufacturer_builder;
+  // The RootPidStore is shared between threads in olad, so the manufacturer
+  // stores that are built on demand are protected by a mutex.
+  mutable ola::thread::Mutex m_manufacturer_mutex;
+  mutable ManufacturerMap m_manufacturer_store;
   uint64_t m_version;
 
   const PidDescriptor *InternalESTANameLookup(
@@ -204,12 +262,12 @@ class PidStore {
    * @brief The number of PidDescriptors in this store.
    * @returns the number of PidDescriptors in this store.
    */
-  unsigned int PidCount() const { return m_pid_by_value.size(); }
+  unsigned int PidCount() const { return m_pids.size(); }
 
   /**
    * @brief Return a list of all PidDescriptors.
    * @param[out] pids a vector which is populated with a list of
-   * PidDescriptors.
+   * PidDescriptors, ordered by PID.
    *
    * The pointers returned are valid for the life of the PidStore object.
    */
@@ -230,10 +288,11 @@ class PidStore {
   const PidDescriptor *LookupPID(const std::string &pid_name) const;
 
  private:
-  typedef std::map<uint16_t, const PidDescriptor*> PidMap;
-  typedef std::map<std::string, const PidDescriptor*> PidNameMap;
-  PidMap m_pid_by_value;
-  PidNameMap m_pid_by_name;
+  // The hashed indices, defined in PidStore.cpp
+  class PidIndex;
+
+  std::vector<const PidDescriptor*> m_pids;  // ordered by PID
+  std::auto_ptr<PidIndex> m_index;
 
   DISALLOW_COPY_AND_ASSIGN(PidStore);
 };
@@ -0,0 +1,151 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * PipeliningRDMController.h
+ * A RDM Controller that allows multiple requests to be in flight at once.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup rdm_controller
+ * @{
+ * @file PipeliningRDMController.h
+ * @brief An RDM Controller that queues messages and allows a window of
+ * requests to be outstanding at once.
+ * @}
+ */
+#ifndef INCLUDE_OLA_RDM_PIPELININGRDMCONTROLLER_H_
+#define INCLUDE_OLA_RDM_PIPELININGRDMCONTROLLER_H_
+
+#include <ola/rdm/RDMControllerInterface.h>
+#include <ola/rdm/UID.h>
+#include <deque>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace ola {
+namespace rdm {
+
+/**
+ * @brief A RDM controller that allows up to max_in_flight requests to be
+ * outstanding at once.
+ *
+ * This is for transports that aren't limited by a single RDM line, like
+ * Art-Net, E1.33 or Ja Rule. The underlying controller must be able to match
+ * responses to requests when more than one request is in flight.
+ *
+ * Requests to the same destination UID are never in flight at the same time,
+ * so responses (including ACK_OVERFLOW sequences, ACK_TIMERs and
+ * QUEUED_MESSAGE GETs) for a single responder arrive in the order the
+ * requests were queued. Broadcast & vendorcast requests wait for all
+ * outstanding requests to complete and are sent on their own.
+ *
+ * With a max_in_flight of 1 this behaves like the QueueingRDMController.
+ */
+class PipeliningRDMController: public RDMControllerInterface {
+ public:
+  /**
+   * @brief Create a new PipeliningRDMController.
+   * @param controller the underlying controller to send requests with.
+   * @param max_queue_size the maximum number of queued and in-flight requests.
+   * @param max_in_flight the maximum number of requests to have in flight.
+   */
+  PipeliningRDMController(RDMControllerInterface *controller,
+                          unsigned int max_queue_size,
+                          unsigned int max_in_flight);
+  ~PipeliningRDMController();
+
+  void Pause();
+  void Resume();
+
+  // This can be called multiple times and the requests will be queued.
+  void SendRDMRequest(RDMRequest *request, RDMCallback *on_complete);
+
+  /**
+   * @brief The number of requests currently in flight.
+   */
+  unsigned int InFlightCount() const { return m_in_flight.size(); }
+
+  /**
+   * @brief The number of requests waiting to be sent.
+   */
+  unsigned int QueuedCount() const { return m_pending_requests.size(); }
+
+ protected:
+  virtual void TakeNextAction();
+  virtual bool CheckForBlockingCondition();
+  void MaybeSendRDMRequests();
+
+ private:
+  class OutstandingRequest;
+  typedef std::deque<OutstandingRequest*> RequestQueue;
+  typedef std::map<UID, OutstandingRequest*> InFlightMap;
+
+  RDMControllerInterface *m_controller;
+  const unsigned int m_max_queue_size;
+  const unsigned int m_max_in_flight;
+  RequestQueue m_pending_requests;
+  InFlightMap m_in_flight;
+  bool m_active;  // true if the controller is active
+  bool m_sending;  // true if we're in MaybeSendRDMRequests
+  bool m_broadcast_in_flight;
+
+  bool DispatchNextRequest();
+  void DispatchRequest(OutstandingRequest *outstanding_request);
+  void HandleRDMResponse(OutstandingRequest *outstanding_request,
+                         RDMReply *reply);
+  void RunCallback(OutstandingRequest *outstanding_request, RDMReply *reply);
+};
+
+
+/**
+ * @brief The DiscoverablePipeliningRDMController also handles discovery.
+ *
+ * Discovery has a higher precedence than RDM messages. Once discovery has
+ * been requested no new RDM requests are sent, and discovery starts as soon
+ * as the in-flight requests have completed.
+ */
+class DiscoverablePipeliningRDMController: public PipeliningRDMController {
+ public:
+  DiscoverablePipeliningRDMController(
+      DiscoverableRDMControllerInterface *controller,
+      unsigned int max_queue_size,
+      unsigned int max_in_flight);
+
+  ~DiscoverablePipeliningRDMController() {}
+
+  // These can be called multiple times and the requests will be queued
+  void RunFullDiscovery(RDMDiscoveryCallback *callback);
+  void RunIncrementalDiscovery(RDMDiscoveryCallback *callback);
+
+ private:
+  typedef std::vector<RDMDiscoveryCallback*> DiscoveryCallbacks;
+  typedef std::vector<std::pair<bool, RDMDiscoveryCallback*> >
+      PendingDiscoveryCallbacks;
+
+  DiscoverableRDMControllerInterface *m_discoverable_controller;
+  DiscoveryCallbacks m_discovery_callbacks;
+  PendingDiscoveryCallbacks m_pending_discovery_callbacks;
+
+  void TakeNextAction();
+  bool CheckForBlockingCondition();
+  void GenericDiscovery(RDMDiscoveryCallback *callback, bool full);
+  void StartRDMDiscovery();
+  void DiscoveryComplete(const ola::rdm::UIDSet &uids);
+};
+}  // namespace rdm
+}  // namespace ola
+#endif  // INCLUDE_OLA_RDM_PIPELININGRDMCONTROLLER_H_
@@ -220,6 +220,9 @@ class RDMCommand {
   uint16_t m_param_id;
   uint8_t *m_data;
   unsigned int m_data_length;
+  // Small parameter data, which covers most responses, is stored inline to
+  // save an allocation.
+  uint8_t m_inline_data[32];
 
   static uint16_t CalculateChecksum(const uint8_t *data,
                                     unsigned int packet_length);
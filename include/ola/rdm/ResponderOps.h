@@ -31,9 +31,10 @@
 
 #include <ola/rdm/RDMCommand.h>
 #include <ola/rdm/RDMControllerInterface.h>
+#include <ola/rdm/RDMReply.h>
 #include <ola/rdm/RDMResponseCodes.h>
 
-#include <map>
+#include <vector>
 
 namespace ola {
 namespace rdm {
@@ -54,6 +55,10 @@ namespace rdm {
  * ResponderOps handles SUPPORTED_PARAMETERS internally, however this can be
  * overridden by registering a handler for SUPPORTED_PARAMETERS.
  *
+ * The handlers are copied into a table sorted by PID when the ResponderOps is
+ * constructed, so each request costs a binary search over contiguous memory.
+ * The SUPPORTED_PARAMETERS response data is also built once, up front.
+ *
  * @tparam Target the object to invoke the PID handlers on.
  */
 template <class Target>
@@ -104,16 +109,49 @@ class ResponderOps {
                           const RDMRequest *request,
                           RDMCallback *on_complete);
 
+    /**
+     * @brief Handle a batch of RDMRequests.
+     *
+     * This is equivalent to calling HandleRDMRequest for each request, but
+     * avoids creating a callback per request.
+     * @param target the target object to invoke the registered handlers on
+     * @param target_uid the UID of the target
+     * @param sub_device the sub_device of the target
+     * @param requests the RDM requests, ownership is transferred.
+     * @param[out] replies a RDMReply is appended for each request, in the same
+     *   order as the requests. Ownership of the replies is transferred to the
+     *   caller.
+     */
+    void HandleRDMRequests(Target *target,
+                           const UID &target_uid,
+                           uint16_t sub_device,
+                           const std::vector<const RDMRequest*> &requests,
+                           std::vector<RDMReply*> *replies);
+
  private:
     struct InternalParamHandler {
+      uint16_t pid;
       RDMHandler get_handler;
       RDMHandler set_handler;
+
+      bool operator<(const InternalParamHandler &other) const {
+        return pid < other.pid;
+      }
     };
-    typedef std::map<uint16_t, InternalParamHandler> RDMHandlers;
+    // Sorted by PID.
+    typedef std::vector<InternalParamHandler> RDMHandlers;
 
-    bool m_include_required_pids;
     RDMHandlers m_handlers;
+    // The SUPPORTED_PARAMETERS param data, in network byte order.
+    std::vector<uint16_t> m_supported_params;
 
+    void AddHandler(const InternalParamHandler &handler);
+    const InternalParamHandler *FindHandler(uint16_t pid) const;
+    RDMStatusCode DispatchRequest(Target *target,
+                                  const UID &target_uid,
+                                  uint16_t sub_device,
+                                  const RDMRequest *request,
+                                  RDMResponse **response);
     RDMResponse *HandleSupportedParams(const RDMRequest *request);
 };
 
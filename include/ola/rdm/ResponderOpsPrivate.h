@@ -33,11 +33,11 @@
 #include <ola/network/NetworkUtils.h>
 #include <ola/rdm/RDMCommand.h>
 #include <ola/rdm/RDMControllerInterface.h>
+#include <ola/rdm/RDMReply.h>
 #include <ola/rdm/RDMResponseCodes.h>
 #include <ola/stl/STLUtils.h>
 
 #include <algorithm>
-#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -47,21 +47,39 @@ namespace rdm {
 
 template <class Target>
 ResponderOps<Target>::ResponderOps(const ParamHandler param_handlers[],
-                                   bool include_required_pids)
-    : m_include_required_pids(include_required_pids) {
+                                   bool include_required_pids) {
   // We install placeholders for any pids which are handled internally.
-  struct InternalParamHandler placeholder = {NULL, NULL};
-  STLReplace(&m_handlers, PID_SUPPORTED_PARAMETERS, placeholder);
+  struct InternalParamHandler placeholder = {
+    PID_SUPPORTED_PARAMETERS, NULL, NULL
+  };
+  AddHandler(placeholder);
 
   const ParamHandler *handler = param_handlers;
   while (handler->pid && (handler->get_handler || handler->set_handler)) {
     struct InternalParamHandler pid_handler = {
+      handler->pid,
       handler->get_handler,
       handler->set_handler
     };
-    STLReplace(&m_handlers, handler->pid, pid_handler);
+    AddHandler(pid_handler);
     handler++;
   }
+
+  // m_handlers is sorted so the params will be as well.
+  typename RDMHandlers::const_iterator iter = m_handlers.begin();
+  for (; iter != m_handlers.end(); ++iter) {
+    uint16_t pid = iter->pid;
+    // some pids never appear in supported_parameters.
+    if (include_required_pids || (
+        pid != PID_SUPPORTED_PARAMETERS &&
+        pid != PID_PARAMETER_DESCRIPTION &&
+        pid != PID_DEVICE_INFO &&
+        pid != PID_SOFTWARE_VERSION_LABEL &&
+        pid != PID_DMX_START_ADDRESS &&
+        pid != PID_IDENTIFY_DEVICE)) {
+      m_supported_params.push_back(ola::network::HostToNetwork(pid));
+    }
+  }
 }
 
 template <class Target>
@@ -78,6 +96,72 @@ void ResponderOps<Target>::HandleRDMRequest(Target *target,
     return;
   }
 
+  RDMResponse *response = NULL;
+  RDMStatusCode status_code = DispatchRequest(target, target_uid, sub_device,
+                                              request.get(), &response);
+  RDMReply reply(status_code, response);
+  on_complete->Run(&reply);
+}
+
+template <class Target>
+void ResponderOps<Target>::HandleRDMRequests(
+    Target *target,
+    const UID &target_uid,
+    uint16_t sub_device,
+    const std::vector<const RDMRequest*> &requests,
+    std::vector<RDMReply*> *replies) {
+  replies->reserve(replies->size() + requests.size());
+
+  std::vector<const RDMRequest*>::const_iterator iter = requests.begin();
+  for (; iter != requests.end(); ++iter) {
+    std::auto_ptr<const RDMRequest> request(*iter);
+    RDMResponse *response = NULL;
+    RDMStatusCode status_code = DispatchRequest(target, target_uid,
+                                                sub_device, request.get(),
+                                                &response);
+    replies->push_back(new RDMReply(status_code, response));
+  }
+}
+
+/*
+ * Add a handler to the sorted table, replacing any existing handler for the
+ * PID.
+ */
+template <class Target>
+void ResponderOps<Target>::AddHandler(const InternalParamHandler &handler) {
+  typename RDMHandlers::iterator iter = std::lower_bound(
+      m_handlers.begin(), m_handlers.end(), handler);
+  if (iter != m_handlers.end() && iter->pid == handler.pid) {
+    *iter = handler;
+  } else {
+    m_handlers.insert(iter, handler);
+  }
+}
+
+template <class Target>
+const typename ResponderOps<Target>::InternalParamHandler*
+    ResponderOps<Target>::FindHandler(uint16_t pid) const {
+  struct InternalParamHandler key = {pid, NULL, NULL};
+  typename RDMHandlers::const_iterator iter = std::lower_bound(
+      m_handlers.begin(), m_handlers.end(), key);
+  if (iter == m_handlers.end() || iter->pid != pid) {
+    return NULL;
+  }
+  return &(*iter);
+}
+
+/*
+ * Run the common checks and invoke the handler for a request.
+ * @returns the status code for the RDMReply. *response is set if there is a
+ *   response to return.
+ */
+template <class Target>
+RDMStatusCode ResponderOps<Target>::DispatchRequest(
+    Target *target,
+    const UID &target_uid,
+    uint16_t sub_device,
+    const RDMRequest *request,
+    RDMResponse **response) {
   // If this isn't directed to our UID (unicast, vendorcast or broadcast), we
   // return early.
   if (!request->DestinationUID().DirectedToUID(target_uid)) {
@@ -87,102 +171,87 @@ void ResponderOps<Target>::HandleRDMRequest(Target *target,
                << request->DestinationUID();
     }
 
-    RunRDMCallback(
-        on_complete,
-        request->DestinationUID().IsBroadcast() ?  RDM_WAS_BROADCAST :
+    return (request->DestinationUID().IsBroadcast() ?  RDM_WAS_BROADCAST :
             RDM_TIMEOUT);
-    return;
   }
 
   // Right now we don't support discovery.
   if (request->CommandClass() == RDMCommand::DISCOVER_COMMAND) {
-    RunRDMCallback(on_complete, RDM_PLUGIN_DISCOVERY_NOT_SUPPORTED);
-    return;
+    return RDM_PLUGIN_DISCOVERY_NOT_SUPPORTED;
   }
 
   // broadcast GETs are noops.
   if (request->CommandClass() == RDMCommand::GET_COMMAND &&
       request->DestinationUID().IsBroadcast()) {
     OLA_WARN << "Received broadcast GET command";
-    RunRDMCallback(on_complete, RDM_WAS_BROADCAST);
-    return;
+    return RDM_WAS_BROADCAST;
   }
 
-  RDMResponse *response = NULL;
-  RDMStatusCode status_code = RDM_COMPLETED_OK;
-
   // Right now we don't support sub devices
   bool for_our_subdevice = request->SubDevice() == sub_device ||
                            request->SubDevice() == ALL_RDM_SUBDEVICES;
 
   if (!for_our_subdevice) {
     if (request->DestinationUID().IsBroadcast()) {
-      RunRDMCallback(on_complete, RDM_WAS_BROADCAST);
-    } else {
-      RDMReply reply(RDM_COMPLETED_OK,
-                     NackWithReason(request.get(), NR_SUB_DEVICE_OUT_OF_RANGE));
-      on_complete->Run(&reply);
+      return RDM_WAS_BROADCAST;
     }
-    return;
+    *response = NackWithReason(request, NR_SUB_DEVICE_OUT_OF_RANGE);
+    return RDM_COMPLETED_OK;
   }
 
   // gets to ALL_RDM_SUBDEVICES are a special case
   if (request->SubDevice() == ALL_RDM_SUBDEVICES &&
       request->CommandClass() == RDMCommand::GET_COMMAND) {
     // The broadcast get case was handled above.
-    RDMReply reply(RDM_COMPLETED_OK,
-                   NackWithReason(request.get(), NR_SUB_DEVICE_OUT_OF_RANGE));
-    on_complete->Run(&reply);
-    return;
+    *response = NackWithReason(request, NR_SUB_DEVICE_OUT_OF_RANGE);
+    return RDM_COMPLETED_OK;
   }
 
-  InternalParamHandler *handler = STLFind(&m_handlers, request->ParamId());
+  const InternalParamHandler *handler = FindHandler(request->ParamId());
   if (!handler) {
     if (request->DestinationUID().IsBroadcast()) {
-      RunRDMCallback(on_complete, RDM_WAS_BROADCAST);
-    } else {
-      RDMReply reply(RDM_COMPLETED_OK,
-                     NackWithReason(request.get(), NR_UNKNOWN_PID));
-      on_complete->Run(&reply);
+      return RDM_WAS_BROADCAST;
     }
-    return;
+    *response = NackWithReason(request, NR_UNKNOWN_PID);
+    return RDM_COMPLETED_OK;
   }
 
+  RDMStatusCode status_code = RDM_COMPLETED_OK;
+  RDMResponse *handler_response = NULL;
   if (request->CommandClass() == RDMCommand::GET_COMMAND) {
     if (request->DestinationUID().IsBroadcast()) {
       // this should have been handled above, but be safe.
       status_code = RDM_WAS_BROADCAST;
     } else {
       if (handler->get_handler) {
-        response = (target->*(handler->get_handler))(request.get());
+        handler_response = (target->*(handler->get_handler))(request);
       } else {
         switch (request->ParamId()) {
           case PID_SUPPORTED_PARAMETERS:
-            response = HandleSupportedParams(request.get());
+            handler_response = HandleSupportedParams(request);
             break;
           default:
-            response = NackWithReason(request.get(),
-                                      NR_UNSUPPORTED_COMMAND_CLASS);
+            handler_response = NackWithReason(request,
+                                              NR_UNSUPPORTED_COMMAND_CLASS);
         }
       }
     }
   } else if (request->CommandClass() == RDMCommand::SET_COMMAND) {
     if (handler->set_handler) {
-      response = (target->*(handler->set_handler))(request.get());
+      handler_response = (target->*(handler->set_handler))(request);
     } else {
-      response = NackWithReason(request.get(), NR_UNSUPPORTED_COMMAND_CLASS);
+      handler_response = NackWithReason(request, NR_UNSUPPORTED_COMMAND_CLASS);
     }
   }
 
   if (request->DestinationUID().IsBroadcast()) {
-    if (response) {
-      delete response;
+    if (handler_response) {
+      delete handler_response;
     }
-    RunRDMCallback(on_complete, RDM_WAS_BROADCAST);
-  } else {
-    RDMReply reply(status_code, response);
-    on_complete->Run(&reply);
+    return RDM_WAS_BROADCAST;
   }
+  *response = handler_response;
+  return status_code;
 }
 
 template <class Target>
@@ -191,33 +260,11 @@ RDMResponse *ResponderOps<Target>::HandleSupportedParams(
   if (request->ParamDataSize())
     return NackWithReason(request, NR_FORMAT_ERROR);
 
-  std::vector<uint16_t> params;
-  params.reserve(m_handlers.size());
-  typename RDMHandlers::const_iterator iter = m_handlers.begin();
-  for (; iter != m_handlers.end(); ++iter) {
-    uint16_t pid = iter->first;
-    // some pids never appear in supported_parameters.
-    if (m_include_required_pids || (
-        pid != PID_SUPPORTED_PARAMETERS &&
-        pid != PID_PARAMETER_DESCRIPTION &&
-        pid != PID_DEVICE_INFO &&
-        pid != PID_SOFTWARE_VERSION_LABEL &&
-        pid != PID_DMX_START_ADDRESS &&
-        pid != PID_IDENTIFY_DEVICE)) {
-      params.push_back(iter->first);
-    }
-  }
-  sort(params.begin(), params.end());
-
-  std::vector<uint16_t>::iterator param_iter = params.begin();
-  for (; param_iter != params.end(); ++param_iter) {
-    *param_iter = ola::network::HostToNetwork(*param_iter);
-  }
-
   return GetResponseFromData(
       request,
-      reinterpret_cast<uint8_t*>(&params[0]),
-      params.size() * sizeof(uint16_t));
+      reinterpret_cast<const uint8_t*>(
+          m_supported_params.empty() ? NULL : &m_supported_params[0]),
+      m_supported_params.size() * sizeof(uint16_t));
 }
 }  // namespace rdm
 }  // namespace ola
@@ -0,0 +1,246 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * UIDMap.h
+ * A map from UIDs to values, held in a sorted vector.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+/**
+ * @addtogroup rdm_uid
+ * @{
+ * @file UIDMap.h
+ * @brief A map from UIDs to values.
+ * @}
+ */
+
+#ifndef INCLUDE_OLA_RDM_UIDMAP_H_
+#define INCLUDE_OLA_RDM_UIDMAP_H_
+
+#include <stdint.h>
+#include <ola/rdm/UID.h>
+#include <ola/rdm/UIDSet.h>
+#include <algorithm>
+#include <vector>
+
+namespace ola {
+namespace rdm {
+
+/**
+ * @addtogroup rdm_uid
+ * @{
+ * @class UIDMap
+ * @brief Maps RDM UIDs to values.
+ *
+ * The entries are held in a vector sorted by UID, with each UID packed into
+ * a uint64_t. Lookups are a binary search over contiguous memory, and there's
+ * no allocation per entry. Adding UIDs in order, as they come from discovery
+ * or a TOD, appends to the vector. Adding UIDs out of order is O(n), so
+ * building a large map in random order is O(n^2).
+ *
+ * Iterators and pointers to values are invalidated when entries are added or
+ * removed.
+ * @}
+ */
+template <typename T>
+class UIDMap {
+ public:
+  /**
+   * @brief An entry in the map.
+   */
+  struct Entry {
+    uint64_t key;  ///< The UID, as returned by UID::ToUInt64()
+    T value;  ///< The value for the UID
+
+    Entry(uint64_t _key, const T &_value) : key(_key), value(_value) {}
+
+    /**
+     * @brief The UID for this entry.
+     */
+    UID Uid() const { return UID(key); }
+  };
+
+  typedef typename std::vector<Entry>::iterator Iterator;
+  typedef typename std::vector<Entry>::const_iterator ConstIterator;
+
+  UIDMap() {}
+
+  Iterator Begin() { return m_entries.begin(); }
+  Iterator End() { return m_entries.end(); }
+  ConstIterator Begin() const { return m_entries.begin(); }
+  ConstIterator End() const { return m_entries.end(); }
+
+  /**
+   * @brief The number of UIDs in the map.
+   */
+  unsigned int Size() const { return m_entries.size(); }
+
+  /**
+   * @brief Check if the map is empty.
+   */
+  bool Empty() const { return m_entries.empty(); }
+
+  /**
+   * @brief Remove all the entries.
+   */
+  void Clear() { m_entries.clear(); }
+
+  /**
+   * @brief Reserve space for a number of entries.
+   */
+  void Reserve(unsigned int size) { m_entries.reserve(size); }
+
+  /**
+   * @brief Look up a UID.
+   * @returns a pointer to the value, or NULL if the UID isn't in the map.
+   */
+  T *Find(const UID &uid) {
+    const uint64_t key = uid.ToUInt64();
+    Iterator iter = LowerBound(key);
+    return (iter != m_entries.end() && iter->key == key) ? &iter->value : NULL;
+  }
+
+  /**
+   * @brief Look up a UID.
+   * @returns a pointer to the value, or NULL if the UID isn't in the map.
+   */
+  const T *Find(const UID &uid) const {
+    const uint64_t key = uid.ToUInt64();
+    ConstIterator iter = std::lower_bound(m_entries.begin(), m_entries.end(),
+                                          key, KeyLess());
+    return (iter != m_entries.end() && iter->key == key) ? &iter->value : NULL;
+  }
+
+  /**
+   * @brief Check if a UID is in the map.
+   */
+  bool Contains(const UID &uid) const {
+    return Find(uid) != NULL;
+  }
+
+  /**
+   * @brief Set the value for a UID.
+   * @returns true if the UID was added, false if it was already in the map
+   *   and the value was replaced.
+   */
+  bool Set(const UID &uid, const T &value) {
+    const uint64_t key = uid.ToUInt64();
+    if (m_entries.empty() || m_entries.back().key < key) {
+      m_entries.push_back(Entry(key, value));
+      return true;
+    }
+
+    Iterator iter = LowerBound(key);
+    if (iter->key == key) {
+      iter->value = value;
+      return false;
+    }
+    m_entries.insert(iter, Entry(key, value));
+    return true;
+  }
+
+  /**
+   * @brief Add a set of UIDs, all with the same value.
+   * @param uids the UIDs to add.
+   * @param value the value for the UIDs that aren't already in the map.
+   *
+   * UIDs that are already in the map keep their existing value. This is a
+   * single merge of the map and the set, so it's O(n + m) no matter what
+   * order the UIDs are in.
+   */
+  void AddUIDs(const UIDSet &uids, const T &value) {
+    if (uids.Size() == 0) {
+      return;
+    }
+
+    std::vector<Entry> merged;
+    merged.reserve(m_entries.size() + uids.Size());
+    ConstIterator iter = m_entries.begin();
+    UIDSet::Iterator uid_iter = uids.Begin();
+    while (uid_iter != uids.End()) {
+      const uint64_t key = uid_iter->ToUInt64();
+      if (iter != m_entries.end() && iter->key <= key) {
+        if (iter->key == key) {
+          ++uid_iter;
+        }
+        merged.push_back(*iter++);
+      } else {
+        merged.push_back(Entry(key, value));
+        ++uid_iter;
+      }
+    }
+    merged.insert(merged.end(), iter, ConstIterator(m_entries.end()));
+    m_entries.swap(merged);
+  }
+
+  /**
+   * @brief Remove a UID from the map.
+   * @returns true if the UID was removed, false if it wasn't in the map.
+   */
+  bool Remove(const UID &uid) {
+    const uint64_t key = uid.ToUInt64();
+    Iterator iter = LowerBound(key);
+    if (iter == m_entries.end() || iter->key != key) {
+      return false;
+    }
+    m_entries.erase(iter);
+    return true;
+  }
+
+  /**
+   * @brief Remove all the entries that match a predicate.
+   * @param predicate a functor that takes a const Entry&, and returns true if
+   *   the entry should be removed.
+   * @returns the number of entries removed.
+   *
+   * This is a single pass over the map, no matter how many entries are
+   * removed.
+   */
+  template <typename Predicate>
+  unsigned int RemoveIf(Predicate predicate) {
+    Iterator new_end = std::remove_if(m_entries.begin(), m_entries.end(),
+                                      predicate);
+    const unsigned int removed = m_entries.end() - new_end;
+    m_entries.erase(new_end, m_entries.end());
+    return removed;
+  }
+
+  /**
+   * @brief Add the UIDs in the map to a UIDSet.
+   */
+  void GetUIDs(UIDSet *uids) const {
+    ConstIterator iter = m_entries.begin();
+    for (; iter != m_entries.end(); ++iter) {
+      uids->AddUID(iter->Uid());
+    }
+  }
+
+ private:
+  struct KeyLess {
+    bool operator()(const Entry &entry, uint64_t key) const {
+      return entry.key < key;
+    }
+  };
+
+  std::vector<Entry> m_entries;  // sorted by key
+
+  Iterator LowerBound(uint64_t key) {
+    return std::lower_bound(m_entries.begin(), m_entries.end(), key,
+                            KeyLess());
+  }
+};
+}  // namespace rdm
+}  // namespace ola
+#endif  // INCLUDE_OLA_RDM_UIDMAP_H_
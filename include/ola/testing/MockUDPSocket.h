@@ -30,6 +30,7 @@
 
 #include <string>
 #include <queue>
+#include <vector>
 
 namespace ola {
 namespace testing {
@@ -50,6 +50,15 @@ std::string PolicyToString(int policy);
 bool SetSchedParam(pthread_t thread, int policy,
                    const struct sched_param &param);
 
+/**
+ * @brief Restrict a thread to a single CPU.
+ * @param thread The thread id.
+ * @param cpu the index of the CPU to run on.
+ * @returns True if the call succeeded, false otherwise, including on
+ *   platforms that don't support thread affinity.
+ */
+bool SetCPUAffinity(pthread_t thread, unsigned int cpu);
+
 }  // namespace thread
 }  // namespace ola
 #endif  // INCLUDE_OLA_THREAD_UTILS_H_
@@ -46,6 +46,13 @@ class TimeCode {
 
     bool IsValid() const;
 
+    /**
+     * @brief The number of frames since midnight.
+     *
+     * For drop frame timecode, the dropped frame numbers aren't counted.
+     */
+    uint32_t FrameCount() const;
+
     TimeCodeType Type() const { return m_type; }
     uint8_t Hours() const { return m_hours; }
     uint8_t Minutes() const { return m_minutes; }
@@ -58,6 +65,23 @@ class TimeCode {
     std::string AsString() const;
     friend std::ostream& operator<<(std::ostream &out, const TimeCode&);
 
+    /**
+     * @brief Build a TimeCode from the number of frames since midnight.
+     * @param type the type of timecode.
+     * @param frame_count the frame count, this wraps at midnight.
+     */
+    static TimeCode FromFrameCount(TimeCodeType type, uint32_t frame_count);
+
+    /**
+     * @brief The number of frames in a day.
+     */
+    static uint32_t FramesPerDay(TimeCodeType type);
+
+    /**
+     * @brief The nominal frame rate, i.e. 30 for TIMECODE_DF.
+     */
+    static uint8_t FramesPerSecond(TimeCodeType type);
+
  private:
     TimeCodeType m_type;
     uint8_t m_hours;
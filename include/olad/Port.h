@@ -25,6 +25,7 @@
 #include <ola/base/Macro.h>
 #include <ola/rdm/RDMCommand.h>
 #include <ola/rdm/RDMControllerInterface.h>
+#include <ola/rdm/UIDSet.h>
 #include <ola/timecode/TimeCode.h>
 #include <olad/DmxSource.h>
 #include <olad/PluginAdaptor.h>
@@ -186,9 +187,42 @@ class OutputPort: public Port, ola::rdm::DiscoverableRDMControllerInterface {
   virtual void RunIncrementalDiscovery(
       ola::rdm::RDMDiscoveryCallback *on_complete) = 0;
 
+  /**
+   * @brief Seed RDM discovery with the UIDs found on this port last time.
+   * @param uids the previously discovered UIDs.
+   *
+   * Ports that support it will verify these UIDs during the next incremental
+   * discovery, rather than having to find them with a branch search.
+   */
+  virtual void SetKnownUIDs(const ola::rdm::UIDSet &uids) = 0;
+
+  /**
+   * @brief Limit the rate DMX data is written to this port.
+   * @param max_frame_rate the maximum number of frames per second, 0 means
+   *   no limit. If frames arrive faster than this, only the latest is
+   *   written.
+   * @param refresh_interval if no frame has been written for this many ms,
+   *   the last frame is written again. 0 disables this.
+   *
+   * The limits are applied by the Universe the port is patched to.
+   */
+  virtual void SetFrameRateLimits(unsigned int max_frame_rate,
+                                  unsigned int refresh_interval) = 0;
+  virtual unsigned int MaxFrameRate() const = 0;
+  virtual unsigned int RefreshInterval() const = 0;
+
   // timecode support
   virtual bool SupportsTimeCode() const = 0;
   virtual bool SendTimeCode(const ola::timecode::TimeCode &timecode) = 0;
+
+  /**
+   * @brief Signal that the frames for a sync group have been written.
+   * @param sync_group the sync group of the universes that were written.
+   *
+   * This is called on one output port per device, after the data for all
+   * the universes in the sync group has been written.
+   */
+  virtual bool SendSync(unsigned int sync_group) = 0;
 };
 
 
@@ -324,6 +358,18 @@ class BasicOutputPort: public OutputPort {
   virtual void RunIncrementalDiscovery(
       ola::rdm::RDMDiscoveryCallback *on_complete);
 
+  /**
+   * @brief This is a noop for ports that don't support warm-start discovery
+   */
+  virtual void SetKnownUIDs(const ola::rdm::UIDSet &uids) {
+    (void) uids;
+  }
+
+  virtual void SetFrameRateLimits(unsigned int max_frame_rate,
+                                  unsigned int refresh_interval);
+  virtual unsigned int MaxFrameRate() const { return m_max_frame_rate; }
+  virtual unsigned int RefreshInterval() const { return m_refresh_interval; }
+
   // TimeCode
   virtual bool SupportsTimeCode() const { return false; }
 
@@ -334,6 +380,13 @@ class BasicOutputPort: public OutputPort {
     return true;
   }
 
+  /**
+   * @brief This is a noop for ports that don't support synchronization
+   */
+  virtual bool SendSync(unsigned int) {
+    return true;
+  }
+
   // Subclasses can override this to cancel the SetUniverse operation.
   virtual bool PreSetUniverse(Universe *, Universe *) { return true; }
   virtual void PostSetUniverse(Universe *, Universe *) { }
@@ -358,6 +411,8 @@ class BasicOutputPort: public OutputPort {
   Universe *m_universe;  // the universe this port belongs to
   AbstractDevice *m_device;
   bool m_supports_rdm;
+  unsigned int m_max_frame_rate;
+  unsigned int m_refresh_interval;
 
   DISALLOW_COPY_AND_ASSIGN(BasicOutputPort);
 };
@@ -28,7 +28,9 @@
 #include <ola/rdm/RDMCommand.h>
 #include <ola/rdm/RDMControllerInterface.h>
 #include <ola/rdm/UID.h>
+#include <ola/rdm/UIDMap.h>
 #include <ola/rdm/UIDSet.h>
+#include <ola/thread/SchedulerInterface.h>
 #include <ola/util/SequenceNumber.h>
 #include <olad/DmxSource.h>
 
@@ -50,9 +52,37 @@ class Universe: public ola::rdm::RDMControllerInterface {
       MERGE_LTP
     };
 
+    /**
+     * @brief Options that limit the DMX updates sent to a sink client.
+     */
+    struct SinkClientOptions {
+      unsigned int start_slot;  // the first slot to send
+      unsigned int slot_count;  // the number of slots, 0 means the rest
+      unsigned int max_rate;  // updates per second, 0 means no limit
+      bool changes_only;  // only send if the slots have changed
+
+      SinkClientOptions()
+          : start_slot(0),
+            slot_count(0),
+            max_rate(0),
+            changes_only(false) {
+      }
+    };
+
+    /**
+     * @brief Create a new Universe.
+     * @param uid the universe id.
+     * @param store the UniverseStore this universe belongs to.
+     * @param export_map the ExportMap to use for stats, may be NULL.
+     * @param clock the Clock to use.
+     * @param scheduler used to send rate limited updates to sink clients once
+     *   the interval has passed. If NULL, the update is sent with the next
+     *   frame after the interval.
+     */
     Universe(unsigned int uid, class UniverseStore *store,
              ExportMap *export_map,
-             Clock *clock);
+             Clock *clock,
+             ola::thread::SchedulerInterface *scheduler = NULL);
     ~Universe();
 
     // Properties for this universe
@@ -78,10 +108,38 @@ class Universe: public ola::rdm::RDMControllerInterface {
       return m_last_discovery_time;
     }
 
+    /**
+     * @brief Return the sync group for this universe.
+     * @return the sync group, 0 means the universe isn't synchronized.
+     */
+    unsigned int SyncGroup() const { return m_sync_group; }
+
     // Used to adjust the properties
     void SetName(const std::string &name);
     void SetMergeMode(merge_mode merge_mode);
 
+    /**
+     * @brief Set the sync group for this universe.
+     * @param sync_group the sync group, 0 removes the universe from its group.
+     *
+     * The frames for all universes in a sync group are written to the output
+     * ports together, followed by a sync message. For E1.31 the sync group is
+     * the sync address.
+     */
+    void SetSyncGroup(unsigned int sync_group);
+
+    /**
+     * @brief Check if a frame is waiting for the rest of the sync group.
+     */
+    bool SyncFramePending() const { return m_sync_frame_pending; }
+
+    /**
+     * @brief Write the pending frame to the output ports.
+     *
+     * This is called by the UniverseStore when the sync group is released.
+     */
+    void WriteSyncedFrame();
+
     /**
      * Set the time between periodic RDM discovery operations.
      */
@@ -100,6 +158,12 @@ class Universe: public ola::rdm::RDMControllerInterface {
     bool RemovePort(OutputPort *port);
     bool ContainsPort(InputPort *port) const;
     bool ContainsPort(OutputPort *port) const;
+
+    /**
+     * @brief Called when the frame rate limits of an output port change.
+     * @param port the OutputPort, which must be patched to this universe.
+     */
+    void OutputPortFrameRateChanged(OutputPort *port);
     unsigned int InputPortCount() const { return m_input_ports.size(); }
     unsigned int OutputPortCount() const { return m_output_ports.size(); }
     void InputPorts(std::vector<InputPort*> *ports) const;
@@ -113,6 +177,15 @@ class Universe: public ola::rdm::RDMControllerInterface {
 
     // Sink clients are those that we need to send data
     bool AddSinkClient(Client *client);
+
+    /**
+     * @brief Add a sink client that only receives some of the updates.
+     * @param client the client to add.
+     * @param options the SinkClientOptions for the client.
+     * @returns true if the client was added, false if it was already a sink
+     *   client, in which case the options are updated.
+     */
+    bool AddSinkClient(Client *client, const SinkClientOptions &options);
     bool RemoveSinkClient(Client *client);
     bool ContainsSinkClient(Client *client) const;
     unsigned int SinkClientCount() const { return m_sink_clients.size(); }
@@ -132,9 +205,19 @@ class Universe: public ola::rdm::RDMControllerInterface {
                          bool full = true);
     void NewUIDList(OutputPort *port, const ola::rdm::UIDSet &uids);
     void GetUIDs(ola::rdm::UIDSet *uids) const;
+    void GetPortUIDs(const OutputPort *port, ola::rdm::UIDSet *uids) const;
     unsigned int UIDCount() const;
     uint8_t GetRDMTransactionNumber();
 
+    /**
+     * @brief A number that changes each time RDM discovery completes on the
+     * universe, or an output port is removed.
+     *
+     * Anything cached about the responders on the universe is stale once this
+     * changes.
+     */
+    unsigned int DiscoveryGeneration() const { return m_discovery_generation; }
+
     bool operator==(const Universe &other) {
       return m_universe_id == other.UniverseId();
     }
@@ -161,15 +244,23 @@ class Universe: public ola::rdm::RDMControllerInterface {
     } broadcast_request_tracker;
 
     typedef std::map<Client*, bool> SourceClientMap;
+    class SinkClientState;
+    typedef std::map<Client*, SinkClientState*> SinkClientMap;
+    class OutputPortState;
+    typedef std::map<OutputPort*, OutputPortState*> OutputPortStateMap;
 
     std::string m_universe_name;
     unsigned int m_universe_id;
     std::string m_universe_id_str;
     uint8_t m_active_priority;
     enum merge_mode m_merge_mode;  // merge mode
+    unsigned int m_sync_group;
+    bool m_sync_frame_pending;
     std::vector<InputPort*> m_input_ports;
     std::vector<OutputPort*> m_output_ports;
-    std::set<Client*> m_sink_clients;  // clients that require updates
+    // state for output ports with frame rate limits
+    OutputPortStateMap m_output_port_state;
+    SinkClientMap m_sink_clients;  // clients that require updates
     /**
      * Tracks current source clients and whether or not they are stale.
      * true == stale and can be removed, false == active is to be kept
@@ -178,10 +269,12 @@ class Universe: public ola::rdm::RDMControllerInterface {
     class UniverseStore *m_universe_store;
     DmxBuffer m_buffer;
     ExportMap *m_export_map;
-    std::map<ola::rdm::UID, OutputPort*> m_output_uids;
+    ola::rdm::UIDMap<OutputPort*> m_output_uids;
     Clock *m_clock;
+    ola::thread::SchedulerInterface *m_scheduler;
     TimeInterval m_rdm_discovery_interval;
     TimeStamp m_last_discovery_time;
+    unsigned int m_discovery_generation;
     ola::SequenceNumber<uint8_t> m_transaction_number_sequence;
 
     void HandleBroadcastAck(broadcast_request_tracker *tracker,
@@ -189,6 +282,16 @@ class Universe: public ola::rdm::RDMControllerInterface {
     void HandleBroadcastDiscovery(broadcast_request_tracker *tracker,
                                   ola::rdm::RDMReply *reply);
     bool UpdateDependants();
+    void WriteOutputPorts();
+    void UpdateSinkClient(Client *client, SinkClientState *state);
+    void SendSinkClientUpdate(Client *client, SinkClientState *state);
+    void SendPendingSinkClientUpdate(Client *client);
+    void RemoveSinkClientState(SinkClientState *state);
+    void WriteRateLimitedPort(OutputPort *port);
+    void WriteOutputPort(OutputPort *port, OutputPortState *state);
+    void WritePendingFrame(OutputPort *port);
+    bool RefreshOutputPort(OutputPort *port);
+    void RemoveOutputPortState(OutputPort *port);
     void UpdateName();
     void UpdateMode();
     void HTPMergeSources(const std::vector<DmxSource> &sources);
@@ -208,7 +311,7 @@ class Universe: public ola::rdm::RDMControllerInterface {
     template<class PortClass>
     bool GenericRemovePort(PortClass *port,
                           std::vector<PortClass*> *ports,
-                          std::map<ola::rdm::UID, PortClass*> *uid_map = NULL);
+                          ola::rdm::UIDMap<PortClass*> *uid_map = NULL);
 
     template<class PortClass>
     bool GenericContainsPort(PortClass *port,
@@ -24,6 +24,7 @@
 #include <memory>
 #include <vector>
 #include "ola/Logging.h"
+#include "ola/stl/STLUtils.h"
 #include "libs/acn/DMPE131Inflator.h"
 #include "libs/acn/DMPHeader.h"
 #include "libs/acn/DMPPDU.h"
@@ -38,13 +39,11 @@ using std::map;
 using std::pair;
 using std::vector;
 
-const TimeInterval DMPE131Inflator::EXPIRY_INTERVAL(2500000);
-
-
 DMPE131Inflator::~DMPE131Inflator() {
   UniverseHandlers::iterator iter;
   for (iter = m_handlers.begin(); iter != m_handlers.end(); ++iter) {
     delete iter->second.closure;
+    delete iter->second.merger;
   }
   m_handlers.clear();
 }
@@ -63,15 +62,12 @@ bool DMPE131Inflator::HandlePDUData(uint32_t vector,
   }
 
   E131Header e131_header = headers.GetE131Header();
-  UniverseHandlers::iterator universe_iter =
-      m_handlers.find(e131_header.Universe());
-
   if (e131_header.PreviewData() && m_ignore_preview) {
     OLA_DEBUG << "Ignoring preview data";
     return true;
   }
 
-  if (universe_iter == m_handlers.end())
+  if (m_handlers.find(e131_header.Universe()) == m_handlers.end())
     return true;
 
   DMPHeader dmp_header = headers.GetDMPHeader();
@@ -83,13 +79,6 @@ bool DMPE131Inflator::HandlePDUData(uint32_t vector,
     return true;
   }
 
-  if (e131_header.Priority() > MAX_E131_PRIORITY) {
-    OLA_INFO << "Priority " << static_cast<int>(e131_header.Priority())
-             << " is greater than the max priority ("
-             << static_cast<int>(MAX_E131_PRIORITY) << "), ignoring data";
-    return true;
-  }
-
   unsigned int available_length = pdu_len;
   std::auto_ptr<const BaseDMPAddress> address(
       DecodeAddress(dmp_header.Size(),
@@ -115,52 +104,125 @@ bool DMPE131Inflator::HandlePDUData(uint32_t vector,
   else if (length_remaining && address->Number())
     start_code = *(data + available_length);
 
-  // The only time we want to continue processing a non-0 start code is if it
-  // contains a Terminate message.
-  if (start_code && !e131_header.StreamTerminated()) {
-    OLA_INFO << "Skipping packet with non-0 start code: " << start_code;
-    return true;
+  // The slot data, without the start code.
+  const uint8_t *slots = data + available_length;
+  unsigned int slot_count = std::min(length_remaining, address->Number());
+  if (!e131_header.UsingRev2() && slot_count) {
+    slots++;
+    slot_count--;
   }
 
-  DmxBuffer *target_buffer;
-  if (!TrackSourceIfRequired(&universe_iter->second, headers,
-                             &target_buffer)) {
-    // no need to continue processing
-    return true;
+  uint8_t cid[CID::CID_LENGTH];
+  headers.GetRootHeader().GetCid().Pack(cid);
+
+  E131DataPacket packet;
+  packet.cid = cid;
+  packet.universe = e131_header.Universe();
+  packet.priority = e131_header.Priority();
+  packet.sequence = e131_header.Sequence();
+  packet.sync_address = e131_header.SyncAddress();
+  packet.preview = e131_header.PreviewData();
+  packet.stream_terminated = e131_header.StreamTerminated();
+  packet.start_code = start_code;
+  packet.slots = slots;
+  packet.slot_count = slot_count;
+  HandleDataPacket(packet);
+  return true;
+}
+
+
+void DMPE131Inflator::HandleDataPacket(const E131DataPacket &packet) {
+  if (packet.preview && m_ignore_preview) {
+    OLA_DEBUG << "Ignoring preview data";
+    return;
+  }
+
+  UniverseHandlers::iterator universe_iter = m_handlers.find(packet.universe);
+  if (universe_iter == m_handlers.end()) {
+    return;
   }
 
-  // Reaching here means that we actually have new data and we should merge.
-  if (target_buffer && start_code == 0) {
-    unsigned int channels = std::min(length_remaining, address->Number());
-    if (e131_header.UsingRev2())
-      target_buffer->Set(data + available_length, channels);
-    else
-     target_buffer->Set(data + available_length + 1, channels - 1);
+  if (packet.priority > MAX_E131_PRIORITY) {
+    OLA_INFO << "Priority " << static_cast<int>(packet.priority)
+             << " is greater than the max priority ("
+             << static_cast<int>(MAX_E131_PRIORITY) << "), ignoring data";
+    return;
   }
 
-  if (universe_iter->second.priority)
-    *universe_iter->second.priority = universe_iter->second.active_priority;
-
-  // merge the sources
-  switch (universe_iter->second.sources.size()) {
-    case 0:
-      universe_iter->second.buffer->Reset();
-      break;
-    case 1:
-      universe_iter->second.buffer->Set(
-          universe_iter->second.sources[0].buffer);
-      universe_iter->second.closure->Run();
-      break;
-    default:
-      // HTP Merge
-      universe_iter->second.buffer->Reset();
-      std::vector<dmx_source>::const_iterator source_iter =
-        universe_iter->second.sources.begin();
-      for (; source_iter != universe_iter->second.sources.end(); ++source_iter)
-        universe_iter->second.buffer->HTPMerge(source_iter->buffer);
-      universe_iter->second.closure->Run();
+  universe_handler *handler = &universe_iter->second;
+  TimeStamp now;
+  m_clock.CurrentMonotonicTime(&now);
+
+  bool merged;
+  if (packet.stream_terminated) {
+    merged = handler->merger->TerminateSource(packet.cid);
+  } else if (packet.start_code == DMX512_START_CODE) {
+    merged = handler->merger->UpdateData(packet.cid, packet.sequence,
+                                         packet.priority, packet.slots,
+                                         packet.slot_count, now);
+  } else if (packet.start_code == E131Merger::PRIORITY_START_CODE) {
+    merged = handler->merger->UpdatePriorities(packet.cid, packet.sequence,
+                                               packet.slots,
+                                               packet.slot_count, now);
+  } else {
+    OLA_INFO << "Skipping packet with start code: " << packet.start_code;
+    return;
+  }
+
+  if (!merged) {
+    return;
+  }
+
+  if (handler->priority) {
+    *handler->priority = handler->merger->Priority();
+  }
+
+  if (handler->merger->SourceCount() == 0) {
+    handler->buffer->Reset();
+    return;
+  }
+
+  handler->buffer->Set(handler->merger->Data());
+  RunHandler(handler, packet.sync_address);
+}
+
+
+/*
+ * Release the data for all universes waiting on this sync address.
+ */
+void DMPE131Inflator::Synchronize(uint16_t sync_address) {
+  m_clock.CurrentMonotonicTime(&m_sync_addresses[sync_address]);
+
+  UniverseHandlers::iterator iter = m_handlers.begin();
+  for (; iter != m_handlers.end(); ++iter) {
+    if (iter->second.sync_pending &&
+        iter->second.sync_address == sync_address) {
+      iter->second.sync_pending = false;
+      iter->second.closure->Run();
+    }
+  }
+}
+
+
+/*
+ * Release the data for universes whose sync address has gone quiet.
+ */
+void DMPE131Inflator::ReleaseExpiredSyncData() {
+  TimeStamp now;
+  m_clock.CurrentMonotonicTime(&now);
+
+  UniverseHandlers::iterator iter = m_handlers.begin();
+  for (; iter != m_handlers.end(); ++iter) {
+    if (!iter->second.sync_pending) {
+      continue;
+    }
+    const TimeStamp *last_sync = STLFind(&m_sync_addresses,
+                                         iter->second.sync_address);
+    if (!last_sync || now - *last_sync >= E131Merger::EXPIRY_INTERVAL) {
+      iter->second.sync_pending = false;
+      iter->second.closure->Run();
+    }
   }
-  return true;
 }
 
 
@@ -184,8 +246,10 @@ bool DMPE131Inflator::SetHandler(uint16_t universe,
     universe_handler handler;
     handler.buffer = buffer;
     handler.closure = closure;
-    handler.active_priority = 0;
     handler.priority = priority;
+    handler.merger = new E131Merger();
+    handler.sync_address = 0;
+    handler.sync_pending = false;
     m_handlers[universe] = handler;
   } else {
     Callback0<void> *old_closure = iter->second.closure;
@@ -208,6 +272,7 @@ bool DMPE131Inflator::RemoveHandler(uint16_t universe) {
 
   if (iter != m_handlers.end()) {
     Callback0<void> *old_closure = iter->second.closure;
+    delete iter->second.merger;
     m_handlers.erase(iter);
     delete old_closure;
     return true;
@@ -231,125 +296,35 @@ void DMPE131Inflator::RegisteredUniverses(vector<uint16_t> *universes) {
 
 
 /*
- * Check if this source is operating at the highest priority for this universe.
- * This takes care of tracking all sources for a universe at the active
- * priority.
- * @param universe_data the universe_handler struct for this universe,
- * @param HeaderSet the set of headers in this packet
- * @param buffer, if set to a non-NULL pointer, the caller should copy the data
- * in the buffer.
- * @returns true if we should remerge the data, false otherwise.
+ * Run the handler for a universe, unless the data is synchronized and we've
+ * heard a sync message for the address recently, in which case the handler
+ * runs when the next sync message arrives.
  */
-bool DMPE131Inflator::TrackSourceIfRequired(
-    universe_handler *universe_data,
-    const HeaderSet &headers,
-    DmxBuffer **buffer) {
-
-  *buffer = NULL;  // default the buffer to NULL
-  ola::TimeStamp now;
-  m_clock.CurrentMonotonicTime(&now);
-  const E131Header &e131_header = headers.GetE131Header();
-  uint8_t priority = e131_header.Priority();
-  vector<dmx_source> &sources = universe_data->sources;
-  vector<dmx_source>::iterator iter = sources.begin();
-
-  while (iter != sources.end()) {
-    if (iter->cid != headers.GetRootHeader().GetCid()) {
-      TimeStamp expiry_time = iter->last_heard_from + EXPIRY_INTERVAL;
-      if (now > expiry_time) {
-        OLA_INFO << "source " << iter->cid.ToString() << " has expired";
-        iter = sources.erase(iter);
-        continue;
+void DMPE131Inflator::RunHandler(universe_handler *handler,
+                                 uint16_t sync_address) {
+  if (sync_address) {
+    if (handler->sync_address != sync_address) {
+      handler->sync_address = sync_address;
+      if (m_sync_addresses.insert(
+              SyncAddressMap::value_type(sync_address, TimeStamp())).second &&
+          m_sync_address_callback.get()) {
+        m_sync_address_callback->Run(sync_address);
       }
     }
-    iter++;
-  }
-
-  if (sources.empty())
-    universe_data->active_priority = 0;
-
-  for (iter = sources.begin(); iter != sources.end(); ++iter) {
-    if (iter->cid == headers.GetRootHeader().GetCid())
-      break;
-  }
-
-  if (iter == sources.end()) {
-    // This is an untracked source
-    if (e131_header.StreamTerminated() ||
-        priority < universe_data->active_priority)
-      return false;
-
-    if (priority > universe_data->active_priority) {
-      OLA_INFO << "Raising priority for universe " <<
-        e131_header.Universe() << " from " <<
-        static_cast<int>(universe_data->active_priority) << " to " <<
-        static_cast<int>(priority);
-      sources.clear();
-      universe_data->active_priority = priority;
-    }
-
-    if (sources.size() == MAX_MERGE_SOURCES) {
-      // TODO(simon): flag this in the export map
-      OLA_WARN << "Max merge sources reached for universe " <<
-        e131_header.Universe() << ", " <<
-        headers.GetRootHeader().GetCid().ToString() << " won't be tracked";
-        return false;
-    } else {
-      OLA_INFO << "Added new E1.31 source: " <<
-        headers.GetRootHeader().GetCid().ToString();
-      dmx_source new_source;
-      new_source.cid = headers.GetRootHeader().GetCid();
-      new_source.sequence = e131_header.Sequence();
-      new_source.last_heard_from = now;
-      iter = sources.insert(sources.end(), new_source);
-      *buffer = &iter->buffer;
-      return true;
-    }
-
-  } else {
-    // We already know about this one, check the seq #
-    int8_t seq_diff = static_cast<int8_t>(e131_header.Sequence() -
-                                          iter->sequence);
-    if (seq_diff <= 0 && seq_diff > SEQUENCE_DIFF_THRESHOLD) {
-      OLA_INFO << "Old packet received, ignoring, this # " <<
-        static_cast<int>(e131_header.Sequence()) << ", last " <<
-        static_cast<int>(iter->sequence);
-      return false;
-    }
-    iter->sequence = e131_header.Sequence();
-
-    if (e131_header.StreamTerminated()) {
-      OLA_INFO << "CID " << headers.GetRootHeader().GetCid().ToString() <<
-        " sent a termination for universe " << e131_header.Universe();
-      sources.erase(iter);
-      if (sources.empty())
-        universe_data->active_priority = 0;
-      // We need to trigger a merge here else the buffer will be stale, we keep
-      // the buffer as NULL though so we don't use the data.
-      return true;
-    }
 
-    iter->last_heard_from = now;
-    if (priority < universe_data->active_priority) {
-      if (sources.size() == 1) {
-        universe_data->active_priority = priority;
-      } else {
-        sources.erase(iter);
-        return true;
-      }
-    } else if (priority > universe_data->active_priority) {
-      // new active priority
-      universe_data->active_priority = priority;
-      if (sources.size() != 1) {
-        // clear all sources other than this one
-        dmx_source this_source = *iter;
-        sources.clear();
-        iter = sources.insert(sources.end(), this_source);
+    const TimeStamp &last_sync = m_sync_addresses[sync_address];
+    if (last_sync.IsSet()) {
+      TimeStamp now;
+      m_clock.CurrentMonotonicTime(&now);
+      if (now - last_sync < E131Merger::EXPIRY_INTERVAL) {
+        handler->sync_pending = true;
+        return;
       }
     }
-    *buffer = &iter->buffer;
-    return true;
   }
+  handler->sync_pending = false;
+  handler->closure->Run();
 }
+
 }  // namespace acn
 }  // namespace ola
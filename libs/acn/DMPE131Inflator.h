@@ -23,11 +23,14 @@
 #define LIBS_ACN_DMPE131INFLATOR_H_
 
 #include <map>
+#include <memory>
 #include <vector>
 #include "ola/Clock.h"
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
 #include "libs/acn/DMPInflator.h"
+#include "libs/acn/E131DataDecoder.h"
+#include "libs/acn/E131Merger.h"
 
 namespace ola {
 namespace acn {
@@ -42,12 +45,50 @@ class DMPE131Inflator: public DMPInflator {
     }
     ~DMPE131Inflator();
 
+    typedef ola::Callback1<void, uint16_t> SyncAddressCallback;
+
     bool SetHandler(uint16_t universe, ola::DmxBuffer *buffer,
                     uint8_t *priority, ola::Callback0<void> *handler);
     bool RemoveHandler(uint16_t universe);
+    bool HasHandler(uint16_t universe) const {
+      return m_handlers.find(universe) != m_handlers.end();
+    }
+
+    /**
+     * @brief Set the callback run when data with a new sync address arrives.
+     * @param callback the callback to run, ownership is transferred.
+     *
+     * This is used to join the multicast group for the sync address.
+     */
+    void SetSyncAddressHandler(SyncAddressCallback *callback) {
+      m_sync_address_callback.reset(callback);
+    }
+
+    /**
+     * @brief Release the held data for universes using this sync address.
+     * @param sync_address the sync address from the synchronization message.
+     */
+    void Synchronize(uint16_t sync_address);
+
+    /**
+     * @brief Release the held data for sync addresses that haven't had a
+     * synchronization message within the network data loss timeout.
+     *
+     * This should be called periodically, otherwise data held when the sync
+     * messages stop is never delivered.
+     */
+    void ReleaseExpiredSyncData();
 
     void RegisteredUniverses(std::vector<uint16_t> *universes);
 
+    /**
+     * @brief Handle a data packet.
+     *
+     * This is used by the E131FastPathInflator to skip the generic inflator
+     * chain, and by HandlePDUData once the DMP layer has been decoded.
+     */
+    void HandleDataPacket(const E131DataPacket &packet);
+
  protected:
     virtual bool HandlePDUData(uint32_t vector,
                                const HeaderSet &headers,
@@ -55,39 +96,29 @@ class DMPE131Inflator: public DMPInflator {
                                unsigned int pdu_len);
 
  private:
-    typedef struct {
-      ola::acn::CID cid;
-      uint8_t sequence;
-      TimeStamp last_heard_from;
-      DmxBuffer buffer;
-    } dmx_source;
-
     typedef struct {
       DmxBuffer *buffer;
       Callback0<void> *closure;
-      uint8_t active_priority;
       uint8_t *priority;
-      std::vector<dmx_source> sources;
+      E131Merger *merger;
+      uint16_t sync_address;
+      bool sync_pending;  // true if the data is waiting for a sync message
     } universe_handler;
 
     typedef std::map<uint16_t, universe_handler> UniverseHandlers;
+    // sync address to the time we last got a sync message
+    typedef std::map<uint16_t, TimeStamp> SyncAddressMap;
 
     UniverseHandlers m_handlers;
+    SyncAddressMap m_sync_addresses;
+    std::auto_ptr<SyncAddressCallback> m_sync_address_callback;
     bool m_ignore_preview;
     ola::Clock m_clock;
 
-    bool TrackSourceIfRequired(universe_handler *universe_data,
-                               const HeaderSet &headers,
-                               DmxBuffer **buffer);
+    void RunHandler(universe_handler *handler, uint16_t sync_address);
 
-    // The max number of sources we'll track per universe.
-    static const uint8_t MAX_MERGE_SOURCES = 6;
     // The max merge priority.
     static const uint8_t MAX_E131_PRIORITY = 200;
-    // ignore packets that differ by less than this amount from the last one
-    static const int8_t SEQUENCE_DIFF_THRESHOLD = -20;
-    // expire sources after 2.5s
-    static const TimeInterval EXPIRY_INTERVAL;
 };
 }  // namespace acn
 }  // namespace ola
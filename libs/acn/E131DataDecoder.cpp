@@ -0,0 +1,115 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131DataDecoder.cpp
+ * Decodes E1.31 data packets with the fixed layout used by almost every
+ * source.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "ola/Constants.h"
+#include "ola/acn/ACNVectors.h"
+#include "ola/util/Utils.h"
+#include "libs/acn/E131DataDecoder.h"
+#include "libs/acn/E131Header.h"
+
+namespace ola {
+namespace acn {
+
+using ola::utils::JoinUInt8;
+
+namespace {
+
+// Offsets from the start of the root PDU, see Table 4-1 of E1.31.
+enum {
+  ROOT_FLAGS = 0,
+  ROOT_VECTOR = 2,
+  ROOT_CID = 6,
+  FRAMING_FLAGS = 22,
+  FRAMING_VECTOR = 24,
+  FRAMING_PRIORITY = 92,
+  FRAMING_SYNC_ADDRESS = 93,
+  FRAMING_SEQUENCE = 95,
+  FRAMING_OPTIONS = 96,
+  FRAMING_UNIVERSE = 97,
+  DMP_FLAGS = 99,
+  DMP_VECTOR = 101,
+  DMP_ADDRESS_TYPE = 102,
+  DMP_FIRST_ADDRESS = 103,
+  DMP_INCREMENT = 105,
+  DMP_COUNT = 107,
+  DMP_START_CODE = 109,
+};
+
+// The vector, header and data flags, with a 12 bit length.
+const uint8_t PDU_FLAGS = 0x70;
+const uint8_t PDU_FLAGS_MASK = 0xf0;
+// Virtual, absolute, range with equal size data, two byte addresses.
+const uint8_t DMP_ADDRESS_TYPE_VALUE = 0xa1;
+
+/*
+ * Check the flags, and that the PDU extends to the end of the data.
+ */
+inline bool CheckPDU(const uint8_t *pdu, unsigned int expected_length) {
+  return ((pdu[0] & PDU_FLAGS_MASK) == PDU_FLAGS &&
+          JoinUInt8(pdu[0] & 0x0f, pdu[1]) == expected_length);
+}
+
+inline uint32_t ReadUInt32(const uint8_t *data) {
+  return JoinUInt8(data[0], data[1], data[2], data[3]);
+}
+}  // namespace
+
+const unsigned int E131DataDecoder::HEADER_SIZE;
+
+bool E131DataDecoder::Decode(const uint8_t *data, unsigned int length,
+                             E131DataPacket *packet) {
+  if (length < HEADER_SIZE ||
+      length > HEADER_SIZE + DMX_UNIVERSE_SIZE) {
+    return false;
+  }
+
+  if (!CheckPDU(data + ROOT_FLAGS, length) ||
+      ReadUInt32(data + ROOT_VECTOR) != VECTOR_ROOT_E131 ||
+      !CheckPDU(data + FRAMING_FLAGS, length - FRAMING_FLAGS) ||
+      ReadUInt32(data + FRAMING_VECTOR) != VECTOR_E131_DATA ||
+      !CheckPDU(data + DMP_FLAGS, length - DMP_FLAGS) ||
+      data[DMP_VECTOR] != DMP_SET_PROPERTY_VECTOR ||
+      data[DMP_ADDRESS_TYPE] != DMP_ADDRESS_TYPE_VALUE ||
+      JoinUInt8(data[DMP_FIRST_ADDRESS], data[DMP_FIRST_ADDRESS + 1]) != 0 ||
+      JoinUInt8(data[DMP_INCREMENT], data[DMP_INCREMENT + 1]) != 1 ||
+      JoinUInt8(data[DMP_COUNT], data[DMP_COUNT + 1]) !=
+          length - DMP_START_CODE ||
+      data[DMP_START_CODE] != DMX512_START_CODE) {
+    return false;
+  }
+
+  const uint8_t options = data[FRAMING_OPTIONS];
+  packet->cid = data + ROOT_CID;
+  packet->universe = JoinUInt8(data[FRAMING_UNIVERSE],
+                               data[FRAMING_UNIVERSE + 1]);
+  packet->priority = data[FRAMING_PRIORITY];
+  packet->sequence = data[FRAMING_SEQUENCE];
+  packet->sync_address = JoinUInt8(data[FRAMING_SYNC_ADDRESS],
+                                   data[FRAMING_SYNC_ADDRESS + 1]);
+  packet->preview = options & E131Header::PREVIEW_DATA_MASK;
+  packet->stream_terminated = options & E131Header::STREAM_TERMINATED_MASK;
+  packet->start_code = data[DMP_START_CODE];
+  packet->slots = data + HEADER_SIZE;
+  packet->slot_count = length - HEADER_SIZE;
+  return true;
+}
+}  // namespace acn
+}  // namespace ola
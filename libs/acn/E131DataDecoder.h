@@ -0,0 +1,77 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131DataDecoder.h
+ * Decodes E1.31 data packets with the fixed layout used by almost every
+ * source.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef LIBS_ACN_E131DATADECODER_H_
+#define LIBS_ACN_E131DATADECODER_H_
+
+#include <stdint.h>
+
+namespace ola {
+namespace acn {
+
+/**
+ * @brief The fields of an E1.31 data packet.
+ *
+ * The pointers refer to the datagram, so this is only valid while the
+ * datagram is.
+ */
+struct E131DataPacket {
+  const uint8_t *cid;  // CID::CID_LENGTH bytes, network byte order
+  uint16_t universe;
+  uint8_t priority;
+  uint8_t sequence;
+  uint16_t sync_address;
+  bool preview;
+  bool stream_terminated;
+  int start_code;  // -1 if the packet didn't contain a start code
+  const uint8_t *slots;  // the slot data, without the start code
+  unsigned int slot_count;
+};
+
+
+/**
+ * @brief Decode an E1.31 data packet without the inflator chain.
+ *
+ * This only handles the layout in Appendix B of E1.31: a single root PDU
+ * containing a single E1.31 data PDU containing a single DMP set property
+ * PDU with every flag set, two byte virtual addresses starting at 0 with an
+ * increment of 1, and a null start code. Everything else, including packets
+ * the generic inflators would consider valid, is rejected so that the caller
+ * can fall back to the inflators.
+ */
+class E131DataDecoder {
+ public:
+  /**
+   * @brief Decode a packet.
+   * @param data the packet, after the ACN preamble.
+   * @param length the length of the data.
+   * @param[out] packet the decoded fields.
+   * @returns true if the packet matched the layout, false otherwise.
+   */
+  static bool Decode(const uint8_t *data, unsigned int length,
+                     E131DataPacket *packet);
+
+  // The size of all the headers, up to and including the start code.
+  static const unsigned int HEADER_SIZE = 110;
+};
+}  // namespace acn
+}  // namespace ola
+#endif  // LIBS_ACN_E131DATADECODER_H_
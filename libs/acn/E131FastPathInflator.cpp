@@ -0,0 +1,40 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131FastPathInflator.cpp
+ * A root inflator that hands common E1.31 data packets straight to the
+ * DMPE131Inflator.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include "libs/acn/E131DataDecoder.h"
+#include "libs/acn/E131FastPathInflator.h"
+
+namespace ola {
+namespace acn {
+
+unsigned int E131FastPathInflator::InflatePDUBlock(HeaderSet *headers,
+                                                   const uint8_t *data,
+                                                   unsigned int len) {
+  E131DataPacket packet;
+  if (m_dmp_inflator && E131DataDecoder::Decode(data, len, &packet)) {
+    m_fast_path_packets++;
+    m_dmp_inflator->HandleDataPacket(packet);
+    return len;
+  }
+  return RootInflator::InflatePDUBlock(headers, data, len);
+}
+}  // namespace acn
+}  // namespace ola
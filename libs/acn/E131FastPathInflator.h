@@ -0,0 +1,68 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131FastPathInflator.h
+ * A root inflator that hands common E1.31 data packets straight to the
+ * DMPE131Inflator.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef LIBS_ACN_E131FASTPATHINFLATOR_H_
+#define LIBS_ACN_E131FASTPATHINFLATOR_H_
+
+#include <stdint.h>
+#include "libs/acn/DMPE131Inflator.h"
+#include "libs/acn/RootInflator.h"
+
+namespace ola {
+namespace acn {
+
+/**
+ * @brief A RootInflator with a fast path for E1.31 data packets.
+ *
+ * Null start code data packets that match the layout in E1.31 are decoded
+ * by the E131DataDecoder in a single pass and passed to the DMPE131Inflator,
+ * skipping the E131Inflator and DMPInflator. All other packets go through
+ * the generic inflators.
+ */
+class E131FastPathInflator: public RootInflator {
+ public:
+  /**
+   * @brief Create a new E131FastPathInflator.
+   * @param dmp_inflator the inflator to pass data packets to, ownership is
+   *   not transferred.
+   */
+  explicit E131FastPathInflator(DMPE131Inflator *dmp_inflator)
+      : RootInflator(),
+        m_dmp_inflator(dmp_inflator),
+        m_fast_path_packets(0) {
+  }
+
+  unsigned int InflatePDUBlock(HeaderSet *headers,
+                               const uint8_t *data,
+                               unsigned int len);
+
+  /**
+   * @brief The number of packets handled by the fast path.
+   */
+  unsigned int FastPathPackets() const { return m_fast_path_packets; }
+
+ private:
+  DMPE131Inflator *m_dmp_inflator;
+  unsigned int m_fast_path_packets;
+};
+}  // namespace acn
+}  // namespace ola
+#endif  // LIBS_ACN_E131FASTPATHINFLATOR_H_
@@ -0,0 +1,331 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131FastPathInflatorTest.cpp
+ * Test fixture for the E131DataDecoder and E131FastPathInflator.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+
+#include "ola/Callback.h"
+#include "ola/DmxBuffer.h"
+#include "ola/acn/CID.h"
+#include "ola/testing/TestUtils.h"
+#include "libs/acn/DMPE131Inflator.h"
+#include "libs/acn/E131DataDecoder.h"
+#include "libs/acn/E131FastPathInflator.h"
+#include "libs/acn/E131Inflator.h"
+#include "libs/acn/HeaderSet.h"
+#include "libs/acn/RootInflator.h"
+
+namespace ola {
+namespace acn {
+
+using ola::DmxBuffer;
+
+class E131FastPathInflatorTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(E131FastPathInflatorTest);
+  CPPUNIT_TEST(testDecode);
+  CPPUNIT_TEST(testRejected);
+  CPPUNIT_TEST(testDifferential);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  void testDecode();
+  void testRejected();
+  void testDifferential();
+
+ private:
+  // The largest packet we build, the headers + 512 slots.
+  enum { MAX_PACKET_SIZE = E131DataDecoder::HEADER_SIZE + 512 };
+
+  static const uint8_t TEST_CID[];
+
+  unsigned int BuildPacket(uint8_t *packet, const uint8_t *cid,
+                           uint16_t universe, uint8_t priority,
+                           uint8_t sequence, uint8_t options,
+                           uint8_t start_code, unsigned int slot_count);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(E131FastPathInflatorTest);
+
+const uint8_t E131FastPathInflatorTest::TEST_CID[] = {
+  0x5a, 0x1c, 0xf3, 0x11, 0x8e, 0x74, 0x40, 0x02,
+  0xa8, 0x3b, 0x0c, 0x6d, 0xe5, 0x97, 0x21, 0x40};
+
+
+namespace {
+/*
+ * A generic or fast path receiver, with a universe registered.
+ */
+class Receiver {
+ public:
+  Receiver(bool fast_path, uint16_t universe)
+      : m_dmp_inflator(false),
+        m_fast_root(&m_dmp_inflator),
+        m_root(fast_path ? &m_fast_root : &m_generic_root),
+        m_priority(0),
+        m_handler_count(0) {
+    m_root->AddInflator(&m_e131_inflator);
+    m_e131_inflator.AddInflator(&m_dmp_inflator);
+    m_dmp_inflator.SetHandler(
+        universe, &m_buffer, &m_priority,
+        NewCallback(this, &Receiver::DataReceived));
+  }
+
+  void Receive(const uint8_t *data, unsigned int length) {
+    HeaderSet headers;
+    m_root->InflatePDUBlock(&headers, data, length);
+  }
+
+  const DmxBuffer &Buffer() const { return m_buffer; }
+  uint8_t Priority() const { return m_priority; }
+  unsigned int HandlerCount() const { return m_handler_count; }
+  unsigned int FastPathPackets() const {
+    return m_fast_root.FastPathPackets();
+  }
+
+ private:
+  DMPE131Inflator m_dmp_inflator;
+  E131Inflator m_e131_inflator;
+  RootInflator m_generic_root;
+  E131FastPathInflator m_fast_root;
+  BaseInflator *m_root;
+  DmxBuffer m_buffer;
+  uint8_t m_priority;
+  unsigned int m_handler_count;
+
+  void DataReceived() { m_handler_count++; }
+};
+
+
+/*
+ * A deterministic PRNG so failures can be reproduced.
+ */
+class TestRandom {
+ public:
+  TestRandom() : m_state(0x12345678) {}
+
+  unsigned int Next(unsigned int limit) {
+    // xorshift32
+    m_state ^= m_state << 13;
+    m_state ^= m_state >> 17;
+    m_state ^= m_state << 5;
+    return m_state % limit;
+  }
+
+ private:
+  uint32_t m_state;
+};
+}  // namespace
+
+
+/*
+ * Build a data packet, without the ACN preamble.
+ */
+unsigned int E131FastPathInflatorTest::BuildPacket(uint8_t *packet,
+                                                   const uint8_t *cid,
+                                                   uint16_t universe,
+                                                   uint8_t priority,
+                                                   uint8_t sequence,
+                                                   uint8_t options,
+                                                   uint8_t start_code,
+                                                   unsigned int slot_count) {
+  const unsigned int length = E131DataDecoder::HEADER_SIZE + slot_count;
+  memset(packet, 0, length);
+
+  // root layer
+  packet[0] = 0x70 | (length >> 8);
+  packet[1] = length & 0xff;
+  packet[5] = 0x04;
+  memcpy(packet + 6, cid, CID::CID_LENGTH);
+
+  // framing layer
+  const unsigned int framing_length = length - 22;
+  packet[22] = 0x70 | (framing_length >> 8);
+  packet[23] = framing_length & 0xff;
+  packet[27] = 0x02;
+  memcpy(packet + 28, "fast path test", 14);
+  packet[92] = priority;
+  packet[95] = sequence;
+  packet[96] = options;
+  packet[97] = universe >> 8;
+  packet[98] = universe & 0xff;
+
+  // DMP layer
+  const unsigned int dmp_length = length - 99;
+  packet[99] = 0x70 | (dmp_length >> 8);
+  packet[100] = dmp_length & 0xff;
+  packet[101] = 0x02;
+  packet[102] = 0xa1;
+  packet[106] = 0x01;
+  packet[107] = (slot_count + 1) >> 8;
+  packet[108] = (slot_count + 1) & 0xff;
+  packet[109] = start_code;
+  for (unsigned int i = 0; i < slot_count; i++) {
+    packet[E131DataDecoder::HEADER_SIZE + i] = (i + sequence) & 0xff;
+  }
+  return length;
+}
+
+
+/*
+ * Check a packet is decoded correctly.
+ */
+void E131FastPathInflatorTest::testDecode() {
+  uint8_t packet[MAX_PACKET_SIZE];
+  unsigned int length = BuildPacket(packet, TEST_CID, 0x1234, 150, 42,
+                                    E131Header::PREVIEW_DATA_MASK, 0, 512);
+  packet[93] = 0x03;
+  packet[94] = 0xe8;
+
+  E131DataPacket decoded;
+  OLA_ASSERT_TRUE(E131DataDecoder::Decode(packet, length, &decoded));
+  OLA_ASSERT_DATA_EQUALS(TEST_CID, sizeof(TEST_CID), decoded.cid,
+                         CID::CID_LENGTH);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(0x1234), decoded.universe);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(150), decoded.priority);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(42), decoded.sequence);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(1000), decoded.sync_address);
+  OLA_ASSERT_TRUE(decoded.preview);
+  OLA_ASSERT_FALSE(decoded.stream_terminated);
+  OLA_ASSERT_EQ(0, decoded.start_code);
+  OLA_ASSERT_EQ(512u, decoded.slot_count);
+  OLA_ASSERT_EQ(
+      static_cast<const uint8_t*>(packet + E131DataDecoder::HEADER_SIZE),
+      decoded.slots);
+
+  // no slots is fine
+  length = BuildPacket(packet, TEST_CID, 1, 100, 0,
+                       E131Header::STREAM_TERMINATED_MASK, 0, 0);
+  OLA_ASSERT_TRUE(E131DataDecoder::Decode(packet, length, &decoded));
+  OLA_ASSERT_TRUE(decoded.stream_terminated);
+  OLA_ASSERT_EQ(0u, decoded.slot_count);
+}
+
+
+/*
+ * Check that anything that isn't the common layout is left to the
+ * inflators.
+ */
+void E131FastPathInflatorTest::testRejected() {
+  uint8_t packet[MAX_PACKET_SIZE + 1];
+  E131DataPacket decoded;
+  const unsigned int length = BuildPacket(packet, TEST_CID, 1, 100, 0, 0, 0,
+                                          24);
+  OLA_ASSERT_TRUE(E131DataDecoder::Decode(packet, length, &decoded));
+
+  // truncated or padded
+  OLA_ASSERT_FALSE(E131DataDecoder::Decode(packet, length - 1, &decoded));
+  OLA_ASSERT_FALSE(E131DataDecoder::Decode(packet, length + 1, &decoded));
+  OLA_ASSERT_FALSE(E131DataDecoder::Decode(packet, 100, &decoded));
+
+  // Each of these bytes must have a particular value.
+  const unsigned int offsets[] = {0, 1, 5, 22, 23, 27, 99, 100, 101, 102, 104,
+                                  106, 108, 109};
+  for (unsigned int i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+    uint8_t copy[MAX_PACKET_SIZE];
+    memcpy(copy, packet, length);
+    copy[offsets[i]] ^= 0x01;
+    OLA_ASSERT_FALSE(E131DataDecoder::Decode(copy, length, &decoded));
+  }
+
+  // priority start code
+  uint8_t priorities[MAX_PACKET_SIZE];
+  BuildPacket(priorities, TEST_CID, 1, 100, 0, 0,
+              E131Merger::PRIORITY_START_CODE, 24);
+  OLA_ASSERT_FALSE(E131DataDecoder::Decode(priorities, length, &decoded));
+
+  // more than 512 slots
+  uint8_t large[MAX_PACKET_SIZE + 1];
+  unsigned int large_length = BuildPacket(large, TEST_CID, 1, 100, 0, 0, 0,
+                                          513);
+  OLA_ASSERT_FALSE(E131DataDecoder::Decode(large, large_length, &decoded));
+}
+
+
+/*
+ * Feed the same packets, valid and mutated, to a generic and a fast path
+ * receiver and check they end up with the same data.
+ */
+void E131FastPathInflatorTest::testDifferential() {
+  const uint16_t UNIVERSE = 1;
+  Receiver generic(false, UNIVERSE);
+  Receiver fast(true, UNIVERSE);
+  TestRandom random;
+
+  uint8_t other_cid[CID::CID_LENGTH];
+  memcpy(other_cid, TEST_CID, sizeof(other_cid));
+  other_cid[15] ^= 0xff;
+
+  // Fields the fuzzer is likely to hit, so we get mutated packets that the
+  // fast path still accepts.
+  const unsigned int interesting_offsets[] = {
+    92, 93, 94, 95, 96, 97, 98, 109, 110, 111};
+  const unsigned int interesting_count =
+      sizeof(interesting_offsets) / sizeof(interesting_offsets[0]);
+
+  const unsigned int ITERATIONS = 5000;
+  for (unsigned int i = 0; i < ITERATIONS; i++) {
+    uint8_t packet[MAX_PACKET_SIZE + 8];
+    const uint8_t start_code = random.Next(8) ?
+        0 : E131Merger::PRIORITY_START_CODE;
+    const uint8_t options = random.Next(64) ?
+        0 : E131Header::STREAM_TERMINATED_MASK;
+    unsigned int length = BuildPacket(
+        packet, random.Next(2) ? TEST_CID : other_cid,
+        random.Next(4) ? UNIVERSE : UNIVERSE + 1,
+        random.Next(220), static_cast<uint8_t>(i), options, start_code,
+        random.Next(513));
+
+    unsigned int mutations = random.Next(4);
+    for (unsigned int j = 0; j < mutations; j++) {
+      switch (random.Next(4)) {
+        case 0:
+          if (length) {
+            packet[random.Next(length)] = random.Next(256);
+          }
+          break;
+        case 1:
+          packet[interesting_offsets[random.Next(interesting_count)]] =
+              random.Next(256);
+          break;
+        case 2:
+          length = random.Next(length + 1);
+          break;
+        default:
+          packet[length] = random.Next(256);
+          length++;
+      }
+    }
+
+    generic.Receive(packet, length);
+    fast.Receive(packet, length);
+
+    OLA_ASSERT_EQ(generic.HandlerCount(), fast.HandlerCount());
+    OLA_ASSERT_EQ(generic.Priority(), fast.Priority());
+    OLA_ASSERT_DMX_EQUALS(generic.Buffer(), fast.Buffer());
+  }
+
+  // Make sure both paths were exercised
+  OLA_ASSERT_GT(fast.FastPathPackets(), ITERATIONS / 4);
+  OLA_ASSERT_LT(fast.FastPathPackets(), ITERATIONS);
+  OLA_ASSERT_GT(fast.HandlerCount(), ITERATIONS / 4);
+  OLA_ASSERT_EQ(0u, generic.FastPathPackets());
+}
+}  // namespace acn
+}  // namespace ola
@@ -181,7 +181,7 @@ void E131InflatorTest::testInflateRev2PDU() {
  */
 void E131InflatorTest::testInflatePDU() {
   const string source = "foobar source";
-  E131Header header(source, 1, 2, 6000);
+  E131Header header(source, 1, 2, 6000, false, false, false, 6001);
   // TODO(simon): pass a DMP msg here as well
   E131PDU pdu(3, header, NULL);
   OLA_ASSERT_EQ((unsigned int) 77, pdu.Size());
@@ -0,0 +1,278 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131Merger.cpp
+ * Merges the E1.31 sources for a universe.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include <algorithm>
+#include "ola/Logging.h"
+#include "libs/acn/E131Merger.h"
+
+namespace ola {
+namespace acn {
+
+const TimeInterval E131Merger::EXPIRY_INTERVAL(2500000);
+
+E131Merger::E131Merger(unsigned int max_sources, MergeMode merge_mode)
+    : m_sources(std::min(std::max(max_sources, 1u),
+                         static_cast<unsigned int>(NO_SOURCE))),
+      m_source_count(0),
+      m_update_count(0),
+      m_merge_mode(merge_mode),
+      m_output_priority(0) {
+  std::vector<Source>::iterator iter = m_sources.begin();
+  for (; iter != m_sources.end(); ++iter) {
+    iter->active = false;
+  }
+  memset(m_slot_priorities, 0, sizeof(m_slot_priorities));
+  memset(m_slot_sources, NO_SOURCE, sizeof(m_slot_sources));
+}
+
+void E131Merger::SetMergeMode(MergeMode merge_mode) {
+  if (merge_mode != m_merge_mode) {
+    m_merge_mode = merge_mode;
+    Merge();
+  }
+}
+
+bool E131Merger::UpdateData(const CID &cid, uint8_t sequence,
+                            uint8_t priority, const uint8_t *data,
+                            unsigned int length, const TimeStamp &now) {
+  uint8_t cid_data[CID::CID_LENGTH];
+  cid.Pack(cid_data);
+  return UpdateData(cid_data, sequence, priority, data, length, now);
+}
+
+bool E131Merger::UpdateData(const uint8_t *cid, uint8_t sequence,
+                            uint8_t priority, const uint8_t *data,
+                            unsigned int length, const TimeStamp &now) {
+  ExpireSources(now);
+  Source *source = LookupOrAddSource(cid, sequence, now);
+  if (!source) {
+    return false;
+  }
+
+  source->priority = priority;
+  source->length = std::min(length, static_cast<unsigned int>(
+      DMX_UNIVERSE_SIZE));
+  memcpy(source->data, data, source->length);
+  source->update_count = ++m_update_count;
+  Merge();
+  return true;
+}
+
+bool E131Merger::UpdatePriorities(const CID &cid, uint8_t sequence,
+                                  const uint8_t *priorities,
+                                  unsigned int length, const TimeStamp &now) {
+  uint8_t cid_data[CID::CID_LENGTH];
+  cid.Pack(cid_data);
+  return UpdatePriorities(cid_data, sequence, priorities, length, now);
+}
+
+bool E131Merger::UpdatePriorities(const uint8_t *cid, uint8_t sequence,
+                                  const uint8_t *priorities,
+                                  unsigned int length, const TimeStamp &now) {
+  ExpireSources(now);
+  Source *source = LookupOrAddSource(cid, sequence, now);
+  if (!source) {
+    return false;
+  }
+
+  source->has_slot_priorities = true;
+  source->last_priorities = now;
+  source->priority_length = std::min(length, static_cast<unsigned int>(
+      DMX_UNIVERSE_SIZE));
+  memcpy(source->slot_priorities, priorities, source->priority_length);
+  Merge();
+  return true;
+}
+
+bool E131Merger::TerminateSource(const CID &cid) {
+  uint8_t cid_data[CID::CID_LENGTH];
+  cid.Pack(cid_data);
+  return TerminateSource(cid_data);
+}
+
+bool E131Merger::TerminateSource(const uint8_t *cid) {
+  std::vector<Source>::iterator iter = m_sources.begin();
+  for (; iter != m_sources.end(); ++iter) {
+    if (iter->active && !memcmp(iter->cid_data, cid, CID::CID_LENGTH)) {
+      OLA_INFO << "E1.31 source " << iter->cid.ToString() << " terminated";
+      RemoveSource(&(*iter));
+      Merge();
+      return true;
+    }
+  }
+  return false;
+}
+
+bool E131Merger::ExpireSources(const TimeStamp &now) {
+  bool changed = false;
+  std::vector<Source>::iterator iter = m_sources.begin();
+  for (; iter != m_sources.end(); ++iter) {
+    if (!iter->active) {
+      continue;
+    }
+    if (now - iter->last_heard > EXPIRY_INTERVAL) {
+      OLA_INFO << "E1.31 source " << iter->cid.ToString() << " has expired";
+      RemoveSource(&(*iter));
+      changed = true;
+    } else if (iter->has_slot_priorities &&
+               now - iter->last_priorities > EXPIRY_INTERVAL) {
+      // fall back to the priority in the E1.31 header
+      iter->has_slot_priorities = false;
+      changed = true;
+    }
+  }
+
+  if (changed) {
+    Merge();
+  }
+  return changed;
+}
+
+uint8_t E131Merger::SlotPriority(unsigned int slot) const {
+  return slot < DMX_UNIVERSE_SIZE ? m_slot_priorities[slot] : 0;
+}
+
+bool E131Merger::SlotSource(unsigned int slot, CID *cid) const {
+  if (slot >= DMX_UNIVERSE_SIZE || m_slot_sources[slot] == NO_SOURCE) {
+    return false;
+  }
+  *cid = m_sources[m_slot_sources[slot]].cid;
+  return true;
+}
+
+
+/*
+ * Find the source for a CID, adding it if there is room. Returns NULL if the
+ * packet should be dropped.
+ */
+E131Merger::Source *E131Merger::LookupOrAddSource(const uint8_t *cid,
+                                                  uint8_t sequence,
+                                                  const TimeStamp &now) {
+  Source *free_source = NULL;
+  std::vector<Source>::iterator iter = m_sources.begin();
+  for (; iter != m_sources.end(); ++iter) {
+    if (!iter->active) {
+      if (!free_source) {
+        free_source = &(*iter);
+      }
+      continue;
+    }
+
+    if (!memcmp(iter->cid_data, cid, CID::CID_LENGTH)) {
+      int8_t seq_diff = static_cast<int8_t>(sequence - iter->sequence);
+      if (seq_diff <= 0 && seq_diff > SEQUENCE_DIFF_THRESHOLD) {
+        OLA_INFO_LIMITED(m_sequence_limiter)
+            << "Old packet received, ignoring"
+            << LogField("cid", iter->cid.ToString())
+            << LogField("sequence", static_cast<int>(sequence))
+            << LogField("last", static_cast<int>(iter->sequence));
+        return NULL;
+      }
+      iter->sequence = sequence;
+      iter->last_heard = now;
+      return &(*iter);
+    }
+  }
+
+  if (!free_source) {
+    OLA_WARN_LIMITED(m_full_limiter)
+        << "Max merge sources reached, source won't be tracked"
+        << LogField("cid", CID::FromData(cid).ToString());
+    return NULL;
+  }
+
+  free_source->cid = CID::FromData(cid);
+  memcpy(free_source->cid_data, cid, CID::CID_LENGTH);
+  OLA_INFO << "Added new E1.31 source: " << free_source->cid.ToString();
+  free_source->active = true;
+  free_source->sequence = sequence;
+  free_source->priority = 0;
+  free_source->has_slot_priorities = false;
+  free_source->length = 0;
+  free_source->priority_length = 0;
+  free_source->update_count = 0;
+  free_source->last_heard = now;
+  m_source_count++;
+  return free_source;
+}
+
+void E131Merger::RemoveSource(Source *source) {
+  source->active = false;
+  m_source_count--;
+}
+
+
+/*
+ * Work out the winning source for each slot.
+ */
+void E131Merger::Merge() {
+  uint8_t output[DMX_UNIVERSE_SIZE];
+  unsigned int output_length = 0;
+  m_output_priority = 0;
+
+  for (unsigned int slot = 0; slot < DMX_UNIVERSE_SIZE; slot++) {
+    int best_priority = -1;
+    uint8_t winner = NO_SOURCE;
+
+    for (unsigned int i = 0; i < m_sources.size(); i++) {
+      const Source &source = m_sources[i];
+      if (!source.active || slot >= source.length) {
+        continue;
+      }
+
+      int priority = source.priority;
+      if (source.has_slot_priorities) {
+        priority = slot < source.priority_length ?
+            source.slot_priorities[slot] : 0;
+        if (priority == 0) {
+          continue;  // the source doesn't control this slot
+        }
+      }
+
+      if (priority > best_priority) {
+        best_priority = priority;
+        winner = static_cast<uint8_t>(i);
+      } else if (priority == best_priority) {
+        const Source &current = m_sources[winner];
+        if (m_merge_mode == MERGE_HTP ?
+            source.data[slot] > current.data[slot] :
+            source.update_count > current.update_count) {
+          winner = static_cast<uint8_t>(i);
+        }
+      }
+    }
+
+    m_slot_sources[slot] = winner;
+    if (winner == NO_SOURCE) {
+      m_slot_priorities[slot] = 0;
+      output[slot] = 0;
+    } else {
+      m_slot_priorities[slot] = static_cast<uint8_t>(best_priority);
+      m_output_priority = std::max(m_output_priority,
+                                   m_slot_priorities[slot]);
+      output[slot] = m_sources[winner].data[slot];
+      output_length = slot + 1;
+    }
+  }
+  m_output.Set(output, output_length);
+}
+}  // namespace acn
+}  // namespace ola
@@ -0,0 +1,201 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131Merger.h
+ * Merges the E1.31 sources for a universe.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef LIBS_ACN_E131MERGER_H_
+#define LIBS_ACN_E131MERGER_H_
+
+#include <stdint.h>
+#include <vector>
+#include "ola/Clock.h"
+#include "ola/Constants.h"
+#include "ola/DmxBuffer.h"
+#include "ola/Logging.h"
+#include "ola/acn/CID.h"
+#include "ola/base/Macro.h"
+
+namespace ola {
+namespace acn {
+
+/**
+ * @brief Merges the E1.31 sources for a single universe.
+ *
+ * Each source has either a priority for the whole universe, or a priority
+ * per slot if it sends 0xdd start code packets. For every slot, the source
+ * with the highest priority wins. Sources with the same priority are merged
+ * HTP or LTP. A per-slot priority of 0 means the source doesn't control the
+ * slot.
+ *
+ * The sources are held in a fixed size array, once it's full new sources are
+ * ignored until an existing source terminates or times out.
+ */
+class E131Merger {
+ public:
+  enum MergeMode {
+    MERGE_HTP,
+    MERGE_LTP,
+  };
+
+  /**
+   * @brief Create a new E131Merger.
+   * @param max_sources the maximum number of sources to track.
+   * @param merge_mode how to merge sources with the same priority.
+   */
+  explicit E131Merger(unsigned int max_sources = DEFAULT_MAX_SOURCES,
+                      MergeMode merge_mode = MERGE_HTP);
+
+  void SetMergeMode(MergeMode merge_mode);
+  MergeMode GetMergeMode() const { return m_merge_mode; }
+
+  /**
+   * @brief Handle a null start code packet from a source.
+   * @param cid the CID of the source.
+   * @param sequence the sequence number of the packet.
+   * @param priority the priority from the E1.31 header.
+   * @param data the slot data, without the start code.
+   * @param length the number of slots.
+   * @param now the current time.
+   * @returns true if the packet was used and the output was re-merged, false
+   *   if it was dropped.
+   */
+  bool UpdateData(const CID &cid, uint8_t sequence, uint8_t priority,
+                  const uint8_t *data, unsigned int length,
+                  const TimeStamp &now);
+
+  /**
+   * @brief Handle a null start code packet from a source.
+   * @param cid the CID of the source in network byte order, CID::CID_LENGTH
+   *   bytes long.
+   *
+   * This avoids creating a CID object for packets from known sources.
+   */
+  bool UpdateData(const uint8_t *cid, uint8_t sequence, uint8_t priority,
+                  const uint8_t *data, unsigned int length,
+                  const TimeStamp &now);
+
+  /**
+   * @brief Handle a per-slot priority (0xdd start code) packet.
+   * @param cid the CID of the source.
+   * @param sequence the sequence number of the packet.
+   * @param priorities the per-slot priorities, without the start code.
+   * @param length the number of slots.
+   * @param now the current time.
+   * @returns true if the packet was used and the output was re-merged, false
+   *   if it was dropped.
+   */
+  bool UpdatePriorities(const CID &cid, uint8_t sequence,
+                        const uint8_t *priorities, unsigned int length,
+                        const TimeStamp &now);
+  bool UpdatePriorities(const uint8_t *cid, uint8_t sequence,
+                        const uint8_t *priorities, unsigned int length,
+                        const TimeStamp &now);
+
+  /**
+   * @brief Remove a source that has terminated its stream.
+   * @returns true if the source was being tracked.
+   */
+  bool TerminateSource(const CID &cid);
+  bool TerminateSource(const uint8_t *cid);
+
+  /**
+   * @brief Remove sources, and per-slot priorities, that have timed out.
+   * @returns true if anything timed out, in which case the output was
+   *   re-merged.
+   */
+  bool ExpireSources(const TimeStamp &now);
+
+  /**
+   * @brief The merged data.
+   */
+  const DmxBuffer &Data() const { return m_output; }
+
+  /**
+   * @brief The highest priority of any slot in the merged data.
+   */
+  uint8_t Priority() const { return m_output_priority; }
+
+  /**
+   * @brief The priority of the winning source for a slot, 0 if there isn't
+   * one.
+   */
+  uint8_t SlotPriority(unsigned int slot) const;
+
+  /**
+   * @brief Find the source that won a slot.
+   * @param slot the slot number, starting from 0.
+   * @param[out] cid the CID of the source.
+   * @returns false if no source controls the slot.
+   */
+  bool SlotSource(unsigned int slot, CID *cid) const;
+
+  /**
+   * @brief The number of sources being tracked.
+   */
+  unsigned int SourceCount() const { return m_source_count; }
+
+  static const unsigned int DEFAULT_MAX_SOURCES = 16;
+  static const uint8_t PRIORITY_START_CODE = 0xdd;
+  // sources and per-slot priorities expire after 2.5s
+  static const TimeInterval EXPIRY_INTERVAL;
+
+ private:
+  struct Source {
+    CID cid;
+    uint8_t cid_data[CID::CID_LENGTH];  // the packed cid, for fast lookups
+    bool active;
+    uint8_t sequence;
+    uint8_t priority;
+    bool has_slot_priorities;
+    unsigned int length;
+    unsigned int priority_length;
+    unsigned int update_count;  // used for LTP
+    TimeStamp last_heard;
+    TimeStamp last_priorities;
+    uint8_t data[DMX_UNIVERSE_SIZE];
+    uint8_t slot_priorities[DMX_UNIVERSE_SIZE];
+  };
+
+  std::vector<Source> m_sources;
+  unsigned int m_source_count;
+  unsigned int m_update_count;
+  MergeMode m_merge_mode;
+  DmxBuffer m_output;
+  uint8_t m_output_priority;
+  uint8_t m_slot_priorities[DMX_UNIVERSE_SIZE];
+  // the index of the winning source for each slot, NO_SOURCE if there isn't
+  // one.
+  uint8_t m_slot_sources[DMX_UNIVERSE_SIZE];
+  // These can be triggered by every packet from a misbehaving source.
+  LogRateLimiter m_full_limiter;
+  LogRateLimiter m_sequence_limiter;
+
+  Source *LookupOrAddSource(const uint8_t *cid, uint8_t sequence,
+                            const TimeStamp &now);
+  void RemoveSource(Source *source);
+  void Merge();
+
+  // ignore packets that differ by less than this amount from the last one
+  static const int8_t SEQUENCE_DIFF_THRESHOLD = -20;
+  static const uint8_t NO_SOURCE = 0xff;
+
+  DISALLOW_COPY_AND_ASSIGN(E131Merger);
+};
+}  // namespace acn
+}  // namespace ola
+#endif  // LIBS_ACN_E131MERGER_H_
@@ -0,0 +1,322 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131MergerTest.cpp
+ * Test fixture for the E131Merger class
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+#include "ola/Clock.h"
+#include "ola/DmxBuffer.h"
+#include "ola/acn/CID.h"
+#include "ola/testing/TestUtils.h"
+#include "libs/acn/E131Merger.h"
+
+using ola::DmxBuffer;
+using ola::TimeInterval;
+using ola::TimeStamp;
+using ola::acn::CID;
+using ola::acn::E131Merger;
+
+class E131MergerTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(E131MergerTest);
+  CPPUNIT_TEST(testSingleSource);
+  CPPUNIT_TEST(testHTPMerge);
+  CPPUNIT_TEST(testLTPMerge);
+  CPPUNIT_TEST(testPriority);
+  CPPUNIT_TEST(testSlotPriorities);
+  CPPUNIT_TEST(testSequenceNumbers);
+  CPPUNIT_TEST(testExpiry);
+  CPPUNIT_TEST(testTerminate);
+  CPPUNIT_TEST(testMaxSources);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp();
+    void testSingleSource();
+    void testHTPMerge();
+    void testLTPMerge();
+    void testPriority();
+    void testSlotPriorities();
+    void testSequenceNumbers();
+    void testExpiry();
+    void testTerminate();
+    void testMaxSources();
+
+ private:
+    CID m_cid1, m_cid2, m_cid3;
+    TimeStamp m_now;
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(E131MergerTest);
+
+void E131MergerTest::setUp() {
+  m_cid1 = CID::Generate();
+  m_cid2 = CID::Generate();
+  m_cid3 = CID::Generate();
+  m_now = TimeStamp() + TimeInterval(1000, 0);
+}
+
+
+/*
+ * Check a single source passes straight through.
+ */
+void E131MergerTest::testSingleSource() {
+  E131Merger merger;
+  const uint8_t data[] = {1, 2, 3, 4};
+
+  OLA_ASSERT_EQ(0u, merger.SourceCount());
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid1, 1, 100, data, sizeof(data),
+                                    m_now));
+  OLA_ASSERT_EQ(1u, merger.SourceCount());
+  OLA_ASSERT_EQ(DmxBuffer(data, sizeof(data)), merger.Data());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), merger.Priority());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), merger.SlotPriority(0));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), merger.SlotPriority(4));
+
+  CID cid;
+  OLA_ASSERT_TRUE(merger.SlotSource(3, &cid));
+  OLA_ASSERT_TRUE(m_cid1 == cid);
+  OLA_ASSERT_FALSE(merger.SlotSource(4, &cid));
+}
+
+
+/*
+ * Check sources at the same priority are HTP merged.
+ */
+void E131MergerTest::testHTPMerge() {
+  E131Merger merger;
+  const uint8_t data1[] = {10, 200, 30};
+  const uint8_t data2[] = {100, 20, 30, 40};
+  const uint8_t expected[] = {100, 200, 30, 40};
+
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid1, 1, 100, data1, sizeof(data1),
+                                    m_now));
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid2, 1, 100, data2, sizeof(data2),
+                                    m_now));
+  OLA_ASSERT_EQ(2u, merger.SourceCount());
+  OLA_ASSERT_EQ(DmxBuffer(expected, sizeof(expected)), merger.Data());
+
+  CID cid;
+  OLA_ASSERT_TRUE(merger.SlotSource(0, &cid));
+  OLA_ASSERT_TRUE(m_cid2 == cid);
+  OLA_ASSERT_TRUE(merger.SlotSource(1, &cid));
+  OLA_ASSERT_TRUE(m_cid1 == cid);
+  OLA_ASSERT_TRUE(merger.SlotSource(3, &cid));
+  OLA_ASSERT_TRUE(m_cid2 == cid);
+}
+
+
+/*
+ * Check sources at the same priority can be LTP merged.
+ */
+void E131MergerTest::testLTPMerge() {
+  E131Merger merger(E131Merger::DEFAULT_MAX_SOURCES, E131Merger::MERGE_LTP);
+  const uint8_t data1[] = {10, 200, 30};
+  const uint8_t data2[] = {100, 20, 30};
+
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid1, 1, 100, data1, sizeof(data1),
+                                    m_now));
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid2, 1, 100, data2, sizeof(data2),
+                                    m_now));
+  OLA_ASSERT_EQ(DmxBuffer(data2, sizeof(data2)), merger.Data());
+
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid1, 2, 100, data1, sizeof(data1),
+                                    m_now));
+  OLA_ASSERT_EQ(DmxBuffer(data1, sizeof(data1)), merger.Data());
+
+  // switching back to HTP re-merges
+  const uint8_t expected[] = {100, 200, 30};
+  merger.SetMergeMode(E131Merger::MERGE_HTP);
+  OLA_ASSERT_EQ(DmxBuffer(expected, sizeof(expected)), merger.Data());
+}
+
+
+/*
+ * Check the highest priority source wins, and a lower priority source takes
+ * over immediately once it's gone.
+ */
+void E131MergerTest::testPriority() {
+  E131Merger merger;
+  const uint8_t data1[] = {10, 20, 30};
+  const uint8_t data2[] = {100, 200, 255};
+
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid1, 1, 150, data1, sizeof(data1),
+                                    m_now));
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid2, 1, 100, data2, sizeof(data2),
+                                    m_now));
+  OLA_ASSERT_EQ(2u, merger.SourceCount());
+  OLA_ASSERT_EQ(DmxBuffer(data1, sizeof(data1)), merger.Data());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(150), merger.Priority());
+
+  OLA_ASSERT_TRUE(merger.TerminateSource(m_cid1));
+  OLA_ASSERT_EQ(1u, merger.SourceCount());
+  OLA_ASSERT_EQ(DmxBuffer(data2, sizeof(data2)), merger.Data());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), merger.Priority());
+}
+
+
+/*
+ * Check per-slot priorities.
+ */
+void E131MergerTest::testSlotPriorities() {
+  E131Merger merger;
+  const uint8_t main_data[] = {10, 20, 30, 40};
+  const uint8_t backup_data[] = {1, 2, 3, 4};
+  // the main source doesn't control slot 2 and has a low priority on slot 3
+  const uint8_t priorities[] = {150, 150, 0, 50};
+  const uint8_t expected[] = {10, 20, 3, 4};
+
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid1, 1, 100, main_data,
+                                    sizeof(main_data), m_now));
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid2, 1, 100, backup_data,
+                                    sizeof(backup_data), m_now));
+  OLA_ASSERT_TRUE(merger.UpdatePriorities(m_cid1, 2, priorities,
+                                          sizeof(priorities), m_now));
+  OLA_ASSERT_EQ(DmxBuffer(expected, sizeof(expected)), merger.Data());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(150), merger.Priority());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(150), merger.SlotPriority(0));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), merger.SlotPriority(2));
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), merger.SlotPriority(3));
+
+  CID cid;
+  OLA_ASSERT_TRUE(merger.SlotSource(1, &cid));
+  OLA_ASSERT_TRUE(m_cid1 == cid);
+  OLA_ASSERT_TRUE(merger.SlotSource(2, &cid));
+  OLA_ASSERT_TRUE(m_cid2 == cid);
+
+  // once the per-slot priorities time out, the header priority is used again
+  TimeStamp later = m_now + TimeInterval(2, 0);
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid1, 3, 100, main_data,
+                                    sizeof(main_data), later));
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid2, 2, 100, backup_data,
+                                    sizeof(backup_data), later));
+  OLA_ASSERT_EQ(DmxBuffer(expected, sizeof(expected)), merger.Data());
+
+  later += TimeInterval(1, 0);
+  OLA_ASSERT_TRUE(merger.ExpireSources(later));
+  OLA_ASSERT_EQ(2u, merger.SourceCount());
+  OLA_ASSERT_EQ(DmxBuffer(main_data, sizeof(main_data)), merger.Data());
+}
+
+
+/*
+ * Check out of order packets are dropped.
+ */
+void E131MergerTest::testSequenceNumbers() {
+  E131Merger merger;
+  const uint8_t data1[] = {1, 2, 3};
+  const uint8_t data2[] = {4, 5, 6};
+
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid1, 10, 100, data1, sizeof(data1),
+                                    m_now));
+  OLA_ASSERT_FALSE(merger.UpdateData(m_cid1, 10, 100, data2, sizeof(data2),
+                                     m_now));
+  OLA_ASSERT_FALSE(merger.UpdateData(m_cid1, 5, 100, data2, sizeof(data2),
+                                     m_now));
+  OLA_ASSERT_EQ(DmxBuffer(data1, sizeof(data1)), merger.Data());
+
+  // a large jump backwards is treated as a restarted source
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid1, 200, 100, data2, sizeof(data2),
+                                    m_now));
+  OLA_ASSERT_EQ(DmxBuffer(data2, sizeof(data2)), merger.Data());
+
+  // wrap around
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid1, 255, 100, data1, sizeof(data1),
+                                    m_now));
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid1, 0, 100, data2, sizeof(data2),
+                                    m_now));
+  OLA_ASSERT_EQ(DmxBuffer(data2, sizeof(data2)), merger.Data());
+}
+
+
+/*
+ * Check sources time out.
+ */
+void E131MergerTest::testExpiry() {
+  E131Merger merger;
+  const uint8_t data1[] = {1, 2, 3};
+  const uint8_t data2[] = {4, 5, 6};
+
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid1, 1, 150, data1, sizeof(data1),
+                                    m_now));
+  TimeStamp later = m_now + TimeInterval(2, 0);
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid2, 1, 100, data2, sizeof(data2),
+                                    later));
+  OLA_ASSERT_EQ(DmxBuffer(data1, sizeof(data1)), merger.Data());
+  OLA_ASSERT_FALSE(merger.ExpireSources(later));
+
+  later += TimeInterval(1, 0);
+  OLA_ASSERT_TRUE(merger.ExpireSources(later));
+  OLA_ASSERT_EQ(1u, merger.SourceCount());
+  OLA_ASSERT_EQ(DmxBuffer(data2, sizeof(data2)), merger.Data());
+
+  later += TimeInterval(3, 0);
+  OLA_ASSERT_TRUE(merger.ExpireSources(later));
+  OLA_ASSERT_EQ(0u, merger.SourceCount());
+  OLA_ASSERT_EQ(0u, merger.Data().Size());
+  OLA_ASSERT_EQ(static_cast<uint8_t>(0), merger.Priority());
+}
+
+
+/*
+ * Check terminating sources.
+ */
+void E131MergerTest::testTerminate() {
+  E131Merger merger;
+  const uint8_t data[] = {1, 2, 3};
+
+  OLA_ASSERT_FALSE(merger.TerminateSource(m_cid1));
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid1, 1, 100, data, sizeof(data),
+                                    m_now));
+  OLA_ASSERT_TRUE(merger.TerminateSource(m_cid1));
+  OLA_ASSERT_EQ(0u, merger.SourceCount());
+  OLA_ASSERT_EQ(0u, merger.Data().Size());
+  OLA_ASSERT_FALSE(merger.TerminateSource(m_cid1));
+
+  // the source can come back with any sequence number
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid1, 1, 100, data, sizeof(data),
+                                    m_now));
+  OLA_ASSERT_EQ(1u, merger.SourceCount());
+}
+
+
+/*
+ * Check new sources are ignored once the array is full.
+ */
+void E131MergerTest::testMaxSources() {
+  E131Merger merger(2);
+  const uint8_t data1[] = {1};
+  const uint8_t data2[] = {2};
+  const uint8_t data3[] = {3};
+
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid1, 1, 100, data1, sizeof(data1),
+                                    m_now));
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid2, 1, 100, data2, sizeof(data2),
+                                    m_now));
+  OLA_ASSERT_FALSE(merger.UpdateData(m_cid3, 1, 200, data3, sizeof(data3),
+                                     m_now));
+  OLA_ASSERT_EQ(2u, merger.SourceCount());
+  OLA_ASSERT_EQ(DmxBuffer(data2, sizeof(data2)), merger.Data());
+
+  OLA_ASSERT_TRUE(merger.TerminateSource(m_cid2));
+  OLA_ASSERT_TRUE(merger.UpdateData(m_cid3, 2, 200, data3, sizeof(data3),
+                                    m_now));
+  OLA_ASSERT_EQ(DmxBuffer(data3, sizeof(data3)), merger.Data());
+}
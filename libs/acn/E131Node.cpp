@@ -117,11 +117,15 @@ E131Node::E131Node(ola::thread::SchedulerInterface *ss,
       m_cid(cid),
       m_root_sender(m_cid),
       m_e131_sender(&m_socket, &m_root_sender),
+      m_root_inflator(&m_dmp_inflator),
       m_dmp_inflator(options.ignore_preview),
       m_discovery_inflator(NewCallback(this, &E131Node::NewDiscoveryPage)),
+      m_sync_inflator(NewCallback(this, &E131Node::HandleSync)),
       m_incoming_udp_transport(&m_socket, &m_root_inflator),
+      m_incoming_raw_transport(&m_root_inflator, options.port),
       m_send_buffer(NULL),
-      m_discovery_timeout(ola::thread::INVALID_TIMEOUT) {
+      m_discovery_timeout(ola::thread::INVALID_TIMEOUT),
+      m_sync_timeout(ola::thread::INVALID_TIMEOUT) {
 
 
   if (!m_options.use_rev2) {
@@ -135,6 +139,9 @@ E131Node::E131Node(ola::thread::SchedulerInterface *ss,
   m_root_inflator.AddInflator(&m_e131_rev2_inflator);
   m_e131_inflator.AddInflator(&m_dmp_inflator);
   m_e131_inflator.AddInflator(&m_discovery_inflator);
+  m_root_inflator.AddInflator(&m_sync_inflator);
+  m_dmp_inflator.SetSyncAddressHandler(
+      NewCallback(this, &E131Node::JoinSyncAddress));
   m_e131_rev2_inflator.AddInflator(&m_dmp_inflator);
 }
 
@@ -186,13 +193,23 @@ bool E131Node::Start() {
   m_socket.SetOnData(NewCallback(&m_incoming_udp_transport,
                                  &IncomingUDPTransport::Receive));
 
-  if (m_options.enable_draft_discovery) {
-    IPV4Address addr;
-    m_e131_sender.UniverseIP(DISCOVERY_UNIVERSE_ID, &addr);
-
-    if (!m_socket.JoinMulticast(m_interface.ip_address, addr)) {
-      OLA_WARN << "Failed to join multicast group " << addr;
+  if (m_options.raw_capture) {
+    // The ring's memberships would otherwise also deliver every multicast
+    // datagram to m_socket, so each packet would be inflated twice.
+    if (m_packet_ring.Open(m_interface.name, m_options.port) &&
+        m_socket.SetMulticastAll(false)) {
+      m_packet_ring.SetOnFrame(
+          NewCallback(&m_incoming_raw_transport,
+                      &IncomingRawTransport::HandleEthernetFrame));
+    } else {
+      m_packet_ring.Close();
+      OLA_WARN << "Failed to open a capture ring on " << m_interface.name
+               << ", falling back to multicast group memberships";
     }
+  }
+
+  if (m_options.enable_draft_discovery) {
+    JoinUniverseGroup(DISCOVERY_UNIVERSE_ID);
 
     m_discovery_timeout = m_ss->RegisterRepeatingTimeout(
         UNIVERSE_DISCOVERY_INTERVAL,
@@ -204,6 +221,9 @@ bool E131Node::Start() {
 bool E131Node::Stop() {
   m_ss->RemoveTimeout(m_discovery_timeout);
   m_discovery_timeout = ola::thread::INVALID_TIMEOUT;
+  m_ss->RemoveTimeout(m_sync_timeout);
+  m_sync_timeout = ola::thread::INVALID_TIMEOUT;
+  m_packet_ring.Close();
   return true;
 }
 
@@ -244,8 +264,25 @@ bool E131Node::TerminateStream(uint16_t universe, uint8_t priority) {
 bool E131Node::SendDMX(uint16_t universe,
                        const ola::DmxBuffer &buffer,
                        uint8_t priority,
-                       bool preview) {
-  return SendDMXWithSequenceOffset(universe, buffer, 0, priority, preview);
+                       bool preview,
+                       uint16_t sync_address) {
+  return SendDMXWithSequenceOffset(universe, buffer, 0, priority, preview,
+                                   sync_address);
+}
+
+
+bool E131Node::SendSynchronization(uint16_t sync_address) {
+  if (m_options.use_rev2) {
+    OLA_WARN << "Synchronization isn't supported by Revision 0.2";
+    return false;
+  }
+
+  uint8_t &sequence = m_sync_sequence_numbers[sync_address];
+  bool result = m_e131_sender.SendSync(sequence, sync_address);
+  if (result) {
+    sequence++;
+  }
+  return result;
 }
 
 
@@ -253,7 +290,8 @@ bool E131Node::SendDMXWithSequenceOffset(uint16_t universe,
                                          const ola::DmxBuffer &buffer,
                                          int8_t sequence_offset,
                                          uint8_t priority,
-                                         bool preview) {
+                                         bool preview,
+                                         uint16_t sync_address) {
   ActiveTxUniverses::iterator iter = m_tx_universes.find(universe);
   tx_universe *settings;
 
@@ -292,7 +330,8 @@ bool E131Node::SendDMXWithSequenceOffset(uint16_t universe,
                     universe,
                     preview,  // preview
                     false,  // terminated
-                    m_options.use_rev2);
+                    m_options.use_rev2,
+                    m_options.use_rev2 ? 0 : sync_address);
 
   bool result = m_e131_sender.SendDMP(header, pdu);
   if (result && !sequence_offset)
@@ -349,22 +388,51 @@ bool E131Node::SetHandler(uint16_t universe,
                           DmxBuffer *buffer,
                           uint8_t *priority,
                           Callback0<void> *closure) {
-  IPV4Address addr;
-  if (!m_e131_sender.UniverseIP(universe, &addr)) {
-    OLA_WARN << "Unable to determine multicast group for universe " <<
-      universe;
+  if (!m_dmp_inflator.HasHandler(universe) && !JoinUniverseGroup(universe)) {
     return false;
   }
+  return m_dmp_inflator.SetHandler(universe, buffer, priority, closure);
+}
 
-  if (!m_socket.JoinMulticast(m_interface.ip_address, addr)) {
-    OLA_WARN << "Failed to join multicast group " << addr;
+bool E131Node::RemoveHandler(uint16_t universe) {
+  if (!m_dmp_inflator.RemoveHandler(universe)) {
     return false;
   }
+  return LeaveUniverseGroup(universe);
+}
 
-  return m_dmp_inflator.SetHandler(universe, buffer, priority, closure);
+
+void E131Node::HandleSync(const HeaderSet &, uint16_t sync_address) {
+  m_dmp_inflator.Synchronize(sync_address);
 }
 
-bool E131Node::RemoveHandler(uint16_t universe) {
+
+bool E131Node::ReleaseExpiredSyncData() {
+  m_dmp_inflator.ReleaseExpiredSyncData();
+  return true;
+}
+
+
+/*
+ * Join the multicast group for a sync address so we see the sync messages.
+ */
+void E131Node::JoinSyncAddress(uint16_t sync_address) {
+  if (m_sync_timeout == ola::thread::INVALID_TIMEOUT) {
+    // Held data is released if the sync messages stop.
+    m_sync_timeout = m_ss->RegisterRepeatingTimeout(
+        SYNC_EXPIRY_CHECK_INTERVAL,
+        NewCallback(this, &E131Node::ReleaseExpiredSyncData));
+  }
+
+  JoinUniverseGroup(sync_address);
+}
+
+
+/*
+ * Join the multicast group for a universe. A sync address can share a group
+ * with a universe we're receiving, so the memberships are reference counted.
+ */
+bool E131Node::JoinUniverseGroup(uint16_t universe) {
   IPV4Address addr;
   if (!m_e131_sender.UniverseIP(universe, &addr)) {
     OLA_WARN << "Unable to determine multicast group for universe " <<
@@ -372,12 +440,60 @@ bool E131Node::RemoveHandler(uint16_t universe) {
     return false;
   }
 
-  if (!m_socket.LeaveMulticast(m_interface.ip_address, addr)) {
-    OLA_WARN << "Failed to leave multicast group " << addr;
+  unsigned int &members = m_group_memberships[universe];
+  if (members) {
+    members++;
+    return true;
+  }
+
+  bool ok;
+  if (m_packet_ring.ValidReadDescriptor()) {
+    ok = m_packet_ring.JoinMulticast(m_interface.ip_address, addr);
+    if (ok) {
+      m_incoming_raw_transport.AddUniverse(universe);
+    }
+  } else {
+    ok = m_socket.JoinMulticast(m_interface.ip_address, addr);
+  }
+
+  if (!ok) {
+    OLA_WARN << "Failed to join multicast group " << addr;
+    m_group_memberships.erase(universe);
     return false;
   }
+  members++;
+  return true;
+}
+
+
+/*
+ * Leave the multicast group for a universe, once nothing else is using it.
+ */
+bool E131Node::LeaveUniverseGroup(uint16_t universe) {
+  GroupMemberships::iterator iter = m_group_memberships.find(universe);
+  if (iter == m_group_memberships.end()) {
+    return true;
+  }
 
-  return m_dmp_inflator.RemoveHandler(universe);
+  if (--iter->second) {
+    return true;
+  }
+  m_group_memberships.erase(iter);
+
+  IPV4Address addr;
+  m_e131_sender.UniverseIP(universe, &addr);
+  bool ok;
+  if (m_packet_ring.ValidReadDescriptor()) {
+    m_incoming_raw_transport.RemoveUniverse(universe);
+    ok = m_packet_ring.LeaveMulticast(m_interface.ip_address, addr);
+  } else {
+    ok = m_socket.LeaveMulticast(m_interface.ip_address, addr);
+  }
+
+  if (!ok) {
+    OLA_WARN << "Failed to leave multicast group " << addr;
+  }
+  return ok;
 }
 
 
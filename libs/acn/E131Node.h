@@ -38,8 +38,11 @@
 #include "ola/network/Socket.h"
 #include "libs/acn/DMPE131Inflator.h"
 #include "libs/acn/E131DiscoveryInflator.h"
+#include "libs/acn/E131FastPathInflator.h"
 #include "libs/acn/E131Inflator.h"
 #include "libs/acn/E131Sender.h"
+#include "libs/acn/E131SyncInflator.h"
+#include "libs/acn/RawTransport.h"
 #include "libs/acn/RootInflator.h"
 #include "libs/acn/RootSender.h"
 #include "libs/acn/UDPTransport.h"
@@ -58,6 +61,7 @@ class E131Node {
        : use_rev2(false),
          ignore_preview(true),
          enable_draft_discovery(false),
+         raw_capture(false),
          dscp(0),
          port(ola::acn::ACN_PORT),
          source_name(ola::OLA_DEFAULT_INSTANCE_NAME) {
@@ -66,6 +70,11 @@ class E131Node {
     bool use_rev2;  /**< Use Revision 0.2 of the 2009 draft */
     bool ignore_preview;  /**< Ignore preview data */
     bool enable_draft_discovery;  /**< Enable 2014 draft discovery */
+    /**
+     * Receive multicast data from a packet capture ring rather than joining
+     * a multicast group per universe. Linux only, requires CAP_NET_RAW.
+     */
+    bool raw_capture;
     uint8_t dscp;  /**< The DSCP value to tag packets with */
     uint16_t port; /**< The UDP port to use, defaults to ACN_PORT */
     std::string source_name; /**< The source name to use */
@@ -129,12 +138,25 @@ class E131Node {
    * @param buffer the DMX data.
    * @param priority the priority to use
    * @param preview set to true to turn on the preview bit
+   * @param sync_address the universe the synchronization messages for this
+   *   data are sent on, or 0 if the data isn't synchronized.
    * @return true if it was sent successfully, false otherwise
    */
   bool SendDMX(uint16_t universe,
                const ola::DmxBuffer &buffer,
                uint8_t priority = DEFAULT_PRIORITY,
-               bool preview = false);
+               bool preview = false,
+               uint16_t sync_address = 0);
+
+  /**
+   * @brief Send a synchronization message.
+   * @param sync_address the universe to send the message on.
+   * @return true if it was sent successfully, false otherwise
+   *
+   * Receivers that have seen a synchronization message recently hold the
+   * data sent with this sync address until the next synchronization message.
+   */
+  bool SendSynchronization(uint16_t sync_address);
 
   /**
    * @brief Send some DMX data, allowing finer grained control of parameters.
@@ -148,13 +170,16 @@ class E131Node {
    * increment the sequence counter.
    * @param priority the priority to use
    * @param preview set to true to turn on the preview bit
+   * @param sync_address the sync address, or 0 if the data isn't
+   *   synchronized.
    * @return true if it was sent successfully, false otherwise
    */
   bool SendDMXWithSequenceOffset(uint16_t universe,
                                  const ola::DmxBuffer &buffer,
                                  int8_t sequence_offset,
                                  uint8_t priority = DEFAULT_PRIORITY,
-                                 bool preview = false);
+                                 bool preview = false,
+                                 uint16_t sync_address = 0);
 
 
   /**
@@ -199,6 +224,13 @@ class E131Node {
    */
   ola::network::UDPSocket* GetSocket() { return &m_socket; }
 
+  /**
+   * @brief Return the capture descriptor, or NULL if raw_capture isn't in use.
+   */
+  ola::io::ReadFileDescriptor* GetCaptureDescriptor() {
+    return m_packet_ring.ValidReadDescriptor() ? &m_packet_ring : NULL;
+  }
+
   /**
    * @brief Return a list of known controllers.
    *
@@ -214,6 +246,10 @@ class E131Node {
   };
 
   typedef std::map<uint16_t, tx_universe> ActiveTxUniverses;
+  // sync address to sequence number
+  typedef std::map<uint16_t, uint8_t> SyncSequenceNumbers;
+  // universe or sync address to the number of users of its multicast group
+  typedef std::map<uint16_t, unsigned int> GroupMemberships;
   typedef std::map<acn::CID, class TrackedSource*> TrackedSources;
 
   ola::thread::SchedulerInterface *m_ss;
@@ -227,22 +263,37 @@ class E131Node {
   RootSender m_root_sender;
   E131Sender m_e131_sender;
   // inflators
-  RootInflator m_root_inflator;
+  // Data packets skip the other inflators and go straight to m_dmp_inflator.
+  E131FastPathInflator m_root_inflator;
   E131Inflator m_e131_inflator;
   E131InflatorRev2 m_e131_rev2_inflator;
   DMPE131Inflator m_dmp_inflator;
   E131DiscoveryInflator m_discovery_inflator;
+  E131SyncInflator m_sync_inflator;
 
   IncomingUDPTransport m_incoming_udp_transport;
+  IncomingRawTransport m_incoming_raw_transport;
+  PacketRingSocket m_packet_ring;
   ActiveTxUniverses m_tx_universes;
+  SyncSequenceNumbers m_sync_sequence_numbers;
+  GroupMemberships m_group_memberships;
   uint8_t *m_send_buffer;
 
   // Discovery members
   ola::thread::timeout_id m_discovery_timeout;
   TrackedSources m_discovered_sources;
 
+  // Releases held data once the sync messages stop
+  ola::thread::timeout_id m_sync_timeout;
+
   tx_universe *SetupOutgoingSettings(uint16_t universe);
 
+  void HandleSync(const HeaderSet &headers, uint16_t sync_address);
+  bool ReleaseExpiredSyncData();
+  void JoinSyncAddress(uint16_t sync_address);
+  bool JoinUniverseGroup(uint16_t universe);
+  bool LeaveUniverseGroup(uint16_t universe);
+
   bool PerformDiscoveryHousekeeping();
   void NewDiscoveryPage(const HeaderSet &headers,
                         const E131DiscoveryInflator::DiscoveryPage &page);
@@ -253,6 +304,7 @@ class E131Node {
   static const uint16_t UNIVERSE_DISCOVERY_INTERVAL = 10000;  // milliseconds
   static const uint16_t DISCOVERY_UNIVERSE_ID = 64214;
   static const uint16_t DISCOVERY_PAGE_SIZE = 512;
+  static const uint16_t SYNC_EXPIRY_CHECK_INTERVAL = 250;  // milliseconds
 
   DISALLOW_COPY_AND_ASSIGN(E131Node);
 };
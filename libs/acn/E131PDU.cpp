@@ -82,7 +82,7 @@ bool E131PDU::PackHeader(uint8_t *data, unsigned int *length) const {
     strings::CopyToFixedLengthBuffer(m_header.Source(), header.source,
                                      arraysize(header.source));
     header.priority = m_header.Priority();
-    header.reserved = 0;
+    header.sync_address = HostToNetwork(m_header.SyncAddress());
     header.sequence = m_header.Sequence();
     header.options = static_cast<uint8_t>(
         (m_header.PreviewData() ? E131Header::PREVIEW_DATA_MASK : 0) |
@@ -129,7 +129,7 @@ void E131PDU::PackHeader(OutputStream *stream) const {
     strings::CopyToFixedLengthBuffer(m_header.Source(), header.source,
                                      arraysize(header.source));
     header.priority = m_header.Priority();
-    header.reserved = 0;
+    header.sync_address = HostToNetwork(m_header.SyncAddress());
     header.sequence = m_header.Sequence();
     header.options = static_cast<uint8_t>(
         (m_header.PreviewData() ? E131Header::PREVIEW_DATA_MASK : 0) |
@@ -109,7 +109,7 @@ void E131PDUTest::testSimpleRev2E131PDU() {
  */
 void E131PDUTest::testSimpleE131PDU() {
   const string source = "foo source";
-  E131Header header(source, 1, 2, 6000, true, true);
+  E131Header header(source, 1, 2, 6000, true, true, false, 7000);
   E131PDU pdu(TEST_VECTOR, header, NULL);
 
   OLA_ASSERT_EQ((unsigned int) 71, pdu.HeaderSize());
@@ -132,6 +132,10 @@ void E131PDUTest::testSimpleE131PDU() {
 
   OLA_ASSERT_FALSE(memcmp(&data[6], source.data(), source.length()));
   OLA_ASSERT_EQ((uint8_t) 1, data[6 + E131Header::SOURCE_NAME_LEN]);
+  uint16_t actual_sync_address;
+  memcpy(&actual_sync_address, data + 7 + E131Header::SOURCE_NAME_LEN,
+         sizeof(actual_sync_address));
+  OLA_ASSERT_EQ(HostToNetwork((uint16_t) 7000), actual_sync_address);
   OLA_ASSERT_EQ((uint8_t) 2, data[9 + E131Header::SOURCE_NAME_LEN]);
   uint16_t actual_universe;
   memcpy(&actual_universe, data + 11 + E131Header::SOURCE_NAME_LEN,
@@ -27,6 +27,7 @@
 #include "libs/acn/E131Inflator.h"
 #include "libs/acn/E131Sender.h"
 #include "libs/acn/E131PDU.h"
+#include "libs/acn/E131SyncPDU.h"
 #include "libs/acn/RootSender.h"
 #include "libs/acn/UDPTransport.h"
 
@@ -100,6 +101,31 @@ bool E131Sender::SendDiscoveryData(const E131Header &header,
 }
 
 
+/*
+ * Send a synchronization message.
+ * @param sequence the sequence number for the sync address
+ * @param sync_address the universe to send the message on
+ */
+bool E131Sender::SendSync(uint8_t sequence, uint16_t sync_address) {
+  if (!m_root_sender) {
+    return false;
+  }
+
+  IPV4Address addr;
+  if (!UniverseIP(sync_address, &addr)) {
+    OLA_INFO << "Could not convert sync address " << sync_address
+             << " to IP.";
+    return false;
+  }
+
+  OutgoingUDPTransport transport(&m_transport_impl, addr);
+
+  E131SyncPDU pdu(sequence, sync_address);
+  return m_root_sender->SendPDU(ola::acn::VECTOR_ROOT_E131_EXTENDED, pdu,
+                                &transport);
+}
+
+
 /*
  * Calculate the IP that corresponds to a universe.
  * @param universe the universe id
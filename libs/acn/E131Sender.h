@@ -43,6 +43,7 @@ class E131Sender {
   bool SendDMP(const E131Header &header, const DMPPDU *pdu);
   bool SendDiscoveryData(const E131Header &header, const uint8_t *data,
                          unsigned int data_size);
+  bool SendSync(uint8_t sequence, uint16_t sync_address);
 
   static bool UniverseIP(uint16_t universe,
                          class ola::network::IPV4Address *addr);
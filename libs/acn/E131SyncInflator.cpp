@@ -0,0 +1,85 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131SyncInflator.cpp
+ * An inflator for E1.31 synchronization messages.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <string.h>
+#include "ola/Logging.h"
+#include "ola/network/NetworkUtils.h"
+#include "libs/acn/E131SyncInflator.h"
+#include "libs/acn/E131SyncPDU.h"
+
+namespace ola {
+namespace acn {
+
+using ola::network::NetworkToHost;
+
+/*
+ * Decode the synchronization framing layer header. If data is null we use
+ * the last header we got.
+ */
+bool E131SyncInflator::DecodeHeader(HeaderSet *,
+                                    const uint8_t *data,
+                                    unsigned int length,
+                                    unsigned int *bytes_used) {
+  *bytes_used = 0;
+  if (m_last_vector != VECTOR_E131_EXTENDED_SYNCHRONIZATION) {
+    // The discovery header is a different shape, HandlePDUData skips these.
+    return true;
+  }
+
+  if (data) {
+    E131SyncPDU::e131_sync_pdu_header raw_header;
+    if (length < sizeof(raw_header)) {
+      OLA_WARN << "E1.31 sync header too small: " << length;
+      return false;
+    }
+    memcpy(&raw_header, data, sizeof(raw_header));
+    m_last_sync_address = NetworkToHost(raw_header.sync_address);
+    m_last_header_valid = true;
+    *bytes_used = sizeof(raw_header);
+    return true;
+  }
+
+  if (!m_last_header_valid) {
+    OLA_WARN << "Missing E1.31 sync header data";
+    return false;
+  }
+  return true;
+}
+
+
+/*
+ * Run the callback for sync packets.
+ */
+bool E131SyncInflator::HandlePDUData(uint32_t vector,
+                                     const HeaderSet &headers,
+                                     const uint8_t *,
+                                     unsigned int) {
+  if (vector != VECTOR_E131_EXTENDED_SYNCHRONIZATION) {
+    OLA_DEBUG << "Ignoring E1.31 extended packet with vector " << vector;
+    return true;
+  }
+
+  if (m_sync_callback.get()) {
+    m_sync_callback->Run(headers, m_last_sync_address);
+  }
+  return true;
+}
+}  // namespace acn
+}  // namespace ola
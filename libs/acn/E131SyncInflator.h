@@ -0,0 +1,74 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131SyncInflator.h
+ * An inflator for E1.31 synchronization messages.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef LIBS_ACN_E131SYNCINFLATOR_H_
+#define LIBS_ACN_E131SYNCINFLATOR_H_
+
+#include <stdint.h>
+#include <memory>
+#include "ola/Callback.h"
+#include "ola/acn/ACNVectors.h"
+#include "libs/acn/BaseInflator.h"
+
+namespace ola {
+namespace acn {
+
+/*
+ * Inflates the E1.31 extended framing layer and runs a callback for each
+ * synchronization packet. The sync address is in the framing layer header,
+ * there's no data section. Extended discovery packets are ignored.
+ */
+class E131SyncInflator: public BaseInflator {
+ public:
+  typedef ola::Callback2<void, const HeaderSet&, uint16_t> SyncCallback;
+
+  explicit E131SyncInflator(SyncCallback *callback)
+      : BaseInflator(),
+        m_sync_callback(callback),
+        m_last_sync_address(0),
+        m_last_header_valid(false) {
+  }
+  ~E131SyncInflator() {}
+
+  uint32_t Id() const { return acn::VECTOR_ROOT_E131_EXTENDED; }
+
+ protected:
+  bool DecodeHeader(HeaderSet *headers,
+                    const uint8_t *data,
+                    unsigned int len,
+                    unsigned int *bytes_used);
+
+  void ResetHeaderField() {
+    m_last_header_valid = false;
+  }
+
+  bool HandlePDUData(uint32_t vector,
+                     const HeaderSet &headers,
+                     const uint8_t *data,
+                     unsigned int pdu_len);
+
+ private:
+  std::auto_ptr<SyncCallback> m_sync_callback;
+  uint16_t m_last_sync_address;
+  bool m_last_header_valid;
+};
+}  // namespace acn
+}  // namespace ola
+#endif  // LIBS_ACN_E131SYNCINFLATOR_H_
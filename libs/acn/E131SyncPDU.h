@@ -0,0 +1,68 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131SyncPDU.h
+ * The E1.31 synchronization framing layer.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef LIBS_ACN_E131SYNCPDU_H_
+#define LIBS_ACN_E131SYNCPDU_H_
+
+#include <stdint.h>
+#include "ola/acn/ACNVectors.h"
+#include "ola/base/Macro.h"
+#include "libs/acn/PDU.h"
+
+namespace ola {
+namespace acn {
+
+/*
+ * A synchronization packet is sent under the VECTOR_ROOT_E131_EXTENDED root
+ * vector. Unlike a data packet the framing layer only carries a sequence
+ * number and the sync address, and there is no DMP layer.
+ */
+class E131SyncPDU: public PDU {
+ public:
+  E131SyncPDU(uint8_t sequence, uint16_t sync_address)
+      : PDU(VECTOR_E131_EXTENDED_SYNCHRONIZATION),
+        m_sequence(sequence),
+        m_sync_address(sync_address) {
+  }
+  ~E131SyncPDU() {}
+
+  unsigned int HeaderSize() const { return sizeof(e131_sync_pdu_header); }
+  unsigned int DataSize() const { return 0; }
+  bool PackHeader(uint8_t *data, unsigned int *length) const;
+  bool PackData(uint8_t *data, unsigned int *length) const;
+
+  void PackHeader(ola::io::OutputStream *stream) const;
+  void PackData(ola::io::OutputStream *) const {}
+
+  PACK(
+  struct e131_sync_pdu_header_s {
+    uint8_t sequence;
+    uint16_t sync_address;
+    uint16_t reserved;
+  });
+  typedef struct e131_sync_pdu_header_s e131_sync_pdu_header;
+
+ private:
+  uint8_t m_sequence;
+  uint16_t m_sync_address;
+};
+}  // namespace acn
+}  // namespace ola
+#endif  // LIBS_ACN_E131SYNCPDU_H_
@@ -0,0 +1,154 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * E131SyncPDUTest.cpp
+ * Test fixture for the E131SyncPDU and E131SyncInflator classes
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string.h>
+
+#include "ola/Callback.h"
+#include "ola/acn/ACNVectors.h"
+#include "ola/acn/CID.h"
+#include "libs/acn/E131SyncInflator.h"
+#include "libs/acn/E131SyncPDU.h"
+#include "libs/acn/HeaderSet.h"
+#include "libs/acn/PreamblePacker.h"
+#include "libs/acn/RootInflator.h"
+#include "libs/acn/RootPDU.h"
+#include "ola/testing/TestUtils.h"
+
+namespace ola {
+namespace acn {
+
+class E131SyncPDUTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(E131SyncPDUTest);
+  CPPUNIT_TEST(testSyncPacket);
+  CPPUNIT_TEST(testInflateSyncPacket);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp() {
+      m_sync_count = 0;
+      m_sync_address = 0;
+    }
+
+    void testSyncPacket();
+    void testInflateSyncPacket();
+
+ private:
+    unsigned int m_sync_count;
+    uint16_t m_sync_address;
+    CID m_cid;
+
+    void SyncReceived(const HeaderSet &headers, uint16_t sync_address) {
+      m_sync_count++;
+      m_sync_address = sync_address;
+      m_cid = headers.GetRootHeader().GetCid();
+    }
+
+    static const uint8_t CID_DATA[];
+    static const uint8_t EXPECTED_PACKET[];
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(E131SyncPDUTest);
+
+const uint8_t E131SyncPDUTest::CID_DATA[] = {
+  0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+  0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10
+};
+
+// A synchronization packet, from E1.31-2016 Table 4-2.
+const uint8_t E131SyncPDUTest::EXPECTED_PACKET[] = {
+  // preamble
+  0x00, 0x10, 0x00, 0x00,
+  'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0x00, 0x00, 0x00,
+  // root layer
+  0x70, 0x21,  // flags & length
+  0x00, 0x00, 0x00, 0x08,  // VECTOR_ROOT_E131_EXTENDED
+  0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,  // CID
+  0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10,
+  // synchronization framing layer
+  0x70, 0x0b,  // flags & length
+  0x00, 0x00, 0x00, 0x01,  // VECTOR_E131_EXTENDED_SYNCHRONIZATION
+  0x2a,  // sequence number
+  0x1b, 0x39,  // sync address 6969
+  0x00, 0x00  // reserved
+};
+
+
+/*
+ * Check the layout of a complete synchronization packet.
+ */
+void E131SyncPDUTest::testSyncPacket() {
+  E131SyncPDU sync_pdu(0x2a, 6969);
+  OLA_ASSERT_EQ(5u, sync_pdu.HeaderSize());
+  OLA_ASSERT_EQ(0u, sync_pdu.DataSize());
+  OLA_ASSERT_EQ(11u, sync_pdu.Size());
+
+  PDUBlock<PDU> block;
+  block.AddPDU(&sync_pdu);
+  RootPDU root_pdu(VECTOR_ROOT_E131_EXTENDED, CID::FromData(CID_DATA),
+                   &block);
+  PDUBlock<PDU> root_block;
+  root_block.AddPDU(&root_pdu);
+
+  PreamblePacker packer;
+  unsigned int length;
+  const uint8_t *data = packer.Pack(root_block, &length);
+  OLA_ASSERT_NOT_NULL(data);
+  OLA_ASSERT_DATA_EQUALS(EXPECTED_PACKET, sizeof(EXPECTED_PACKET),
+                         data, length);
+
+  // undersized buffer
+  uint8_t buffer[11];
+  unsigned int bytes_used = sizeof(buffer) - 1;
+  OLA_ASSERT_FALSE(sync_pdu.Pack(buffer, &bytes_used));
+  OLA_ASSERT_EQ(0u, bytes_used);
+}
+
+
+/*
+ * Check that the inflator extracts the sync address.
+ */
+void E131SyncPDUTest::testInflateSyncPacket() {
+  E131SyncInflator sync_inflator(
+      NewCallback(this, &E131SyncPDUTest::SyncReceived));
+  RootInflator root_inflator;
+  root_inflator.AddInflator(&sync_inflator);
+
+  const unsigned int preamble_size = PreamblePacker::ACN_HEADER_SIZE;
+  HeaderSet headers;
+  OLA_ASSERT_EQ(
+      sizeof(EXPECTED_PACKET) - preamble_size,
+      static_cast<size_t>(root_inflator.InflatePDUBlock(
+          &headers, EXPECTED_PACKET + preamble_size,
+          sizeof(EXPECTED_PACKET) - preamble_size)));
+  OLA_ASSERT_EQ(1u, m_sync_count);
+  OLA_ASSERT_EQ(static_cast<uint16_t>(6969), m_sync_address);
+  OLA_ASSERT_TRUE(CID::FromData(CID_DATA) == m_cid);
+
+  // A universe discovery packet uses the same root vector, but isn't a sync.
+  uint8_t discovery_packet[sizeof(EXPECTED_PACKET)];
+  memcpy(discovery_packet, EXPECTED_PACKET, sizeof(discovery_packet));
+  discovery_packet[preamble_size + 27] = VECTOR_E131_EXTENDED_DISCOVERY;
+  root_inflator.InflatePDUBlock(&headers, discovery_packet + preamble_size,
+                                sizeof(discovery_packet) - preamble_size);
+  OLA_ASSERT_EQ(1u, m_sync_count);
+}
+}  // namespace acn
+}  // namespace ola
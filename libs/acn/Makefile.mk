@@ -40,17 +40,27 @@ libs_acn_libolae131core_la_SOURCES = \
     libs/acn/DMPInflator.h \
     libs/acn/DMPPDU.cpp \
     libs/acn/DMPPDU.h \
+    libs/acn/E131DataDecoder.cpp \
+    libs/acn/E131DataDecoder.h \
     libs/acn/E131DiscoveryInflator.cpp \
     libs/acn/E131DiscoveryInflator.h \
+    libs/acn/E131FastPathInflator.cpp \
+    libs/acn/E131FastPathInflator.h \
     libs/acn/E131Header.h \
     libs/acn/E131Inflator.cpp \
     libs/acn/E131Inflator.h \
+    libs/acn/E131Merger.cpp \
+    libs/acn/E131Merger.h \
     libs/acn/E131Node.cpp \
     libs/acn/E131Node.h \
     libs/acn/E131PDU.cpp \
     libs/acn/E131PDU.h \
     libs/acn/E131Sender.cpp \
     libs/acn/E131Sender.h \
+    libs/acn/E131SyncInflator.cpp \
+    libs/acn/E131SyncInflator.h \
+    libs/acn/E131SyncPDU.cpp \
+    libs/acn/E131SyncPDU.h \
     libs/acn/E133Header.h \
     libs/acn/E133Inflator.cpp \
     libs/acn/E133Inflator.h \
@@ -66,6 +76,8 @@ libs_acn_libolae131core_la_SOURCES = \
     libs/acn/PDUTestCommon.h \
     libs/acn/PreamblePacker.cpp \
     libs/acn/PreamblePacker.h \
+    libs/acn/RawTransport.cpp \
+    libs/acn/RawTransport.h \
     libs/acn/RDMInflator.cpp \
     libs/acn/RDMInflator.h \
     libs/acn/RDMPDU.cpp \
@@ -116,8 +128,11 @@ libs_acn_E131Tester_SOURCES = \
     libs/acn/DMPAddressTest.cpp \
     libs/acn/DMPInflatorTest.cpp \
     libs/acn/DMPPDUTest.cpp \
+    libs/acn/E131FastPathInflatorTest.cpp \
     libs/acn/E131InflatorTest.cpp \
+    libs/acn/E131MergerTest.cpp \
     libs/acn/E131PDUTest.cpp \
+    libs/acn/E131SyncPDUTest.cpp \
     libs/acn/HeaderSetTest.cpp \
     libs/acn/PDUTest.cpp \
     libs/acn/RootInflatorTest.cpp \
@@ -141,6 +156,7 @@ libs_acn_E133Tester_LDADD = \
     $(COMMON_TESTING_LIBS)
 
 libs_acn_TransportTester_SOURCES = \
+    libs/acn/RawTransportTest.cpp \
     libs/acn/TCPTransportTest.cpp \
     libs/acn/UDPTransportTest.cpp
 libs_acn_TransportTester_CPPFLAGS = $(COMMON_TESTING_FLAGS)
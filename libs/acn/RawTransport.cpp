@@ -0,0 +1,516 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RawTransport.cpp
+ * Receive E1.31 multicast traffic from a raw packet capture.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <string.h>
+
+#ifdef HAVE_LINUX_IF_PACKET_H
+#include <arpa/inet.h>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif  // HAVE_LINUX_IF_PACKET_H
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+#include "ola/Logging.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/NetworkUtils.h"
+#include "ola/network/SocketAddress.h"
+#include "libs/acn/BaseInflator.h"
+#include "libs/acn/HeaderSet.h"
+#include "libs/acn/PreamblePacker.h"
+#include "libs/acn/RawTransport.h"
+#include "libs/acn/TransportHeader.h"
+
+namespace ola {
+namespace acn {
+
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using std::string;
+
+const uint8_t IncomingRawTransport::E131_GROUP_PREFIX[] = {239, 255};
+const uint32_t PcapReader::LINKTYPE_ETHERNET;
+const uint32_t PcapReader::LINKTYPE_RAW;
+
+namespace {
+uint16_t ReadUInt16(const uint8_t *data) {
+  return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+#ifdef HAVE_LINUX_IF_PACKET_H
+// The kernel fills in a frame before setting tp_status, and reuses it once we
+// set it back to TP_STATUS_KERNEL, so the status word orders the accesses.
+#ifdef HAVE_ATOMIC_BUILTINS
+uint32_t LoadFrameStatus(const struct tpacket2_hdr *header) {
+  return __atomic_load_n(&header->tp_status, __ATOMIC_ACQUIRE);
+}
+
+void ReturnFrameToKernel(struct tpacket2_hdr *header) {
+  __atomic_store_n(&header->tp_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+}
+#else
+uint32_t LoadFrameStatus(const struct tpacket2_hdr *header) {
+  uint32_t status = *reinterpret_cast<const volatile uint32_t*>(
+      &header->tp_status);
+  __sync_synchronize();
+  return status;
+}
+
+void ReturnFrameToKernel(struct tpacket2_hdr *header) {
+  __sync_synchronize();
+  *reinterpret_cast<volatile uint32_t*>(&header->tp_status) =
+      TP_STATUS_KERNEL;
+}
+#endif  // HAVE_ATOMIC_BUILTINS
+#endif  // HAVE_LINUX_IF_PACKET_H
+}  // namespace
+
+IncomingRawTransport::IncomingRawTransport(BaseInflator *inflator,
+                                           uint16_t port)
+    : m_inflator(inflator),
+      m_port(port),
+      m_universes(1 << 16, false),
+      m_inflated(0) {
+}
+
+
+void IncomingRawTransport::AddUniverse(uint16_t universe) {
+  m_universes[universe] = true;
+}
+
+
+void IncomingRawTransport::RemoveUniverse(uint16_t universe) {
+  m_universes[universe] = false;
+}
+
+
+void IncomingRawTransport::HandleEthernetFrame(const uint8_t *frame,
+                                               unsigned int length) {
+  if (length < ETHERNET_HEADER_SIZE) {
+    return;
+  }
+
+  unsigned int offset = ETHERNET_HEADER_SIZE - sizeof(uint16_t);
+  uint16_t ethertype = ReadUInt16(frame + offset);
+  if (ethertype == ETHERTYPE_VLAN) {
+    if (length < ETHERNET_HEADER_SIZE + VLAN_TAG_SIZE) {
+      return;
+    }
+    offset += VLAN_TAG_SIZE;
+    ethertype = ReadUInt16(frame + offset);
+  }
+
+  if (ethertype != ETHERTYPE_IPV4) {
+    return;
+  }
+  offset += sizeof(uint16_t);
+  HandleIPV4Packet(frame + offset, length - offset);
+}
+
+
+void IncomingRawTransport::HandleIPV4Packet(const uint8_t *packet,
+                                            unsigned int length) {
+  if (length < IPV4_MIN_HEADER_SIZE || (packet[0] >> 4) != 4) {
+    return;
+  }
+
+  unsigned int header_size = (packet[0] & 0x0f) * 4;
+  unsigned int total_length = std::min(
+      static_cast<unsigned int>(ReadUInt16(packet + 2)), length);
+  if (header_size < IPV4_MIN_HEADER_SIZE ||
+      total_length < header_size + UDP_HEADER_SIZE) {
+    return;
+  }
+
+  // Fragments can't be matched to a port, E1.31 packets always fit in one
+  // datagram.
+  if (packet[9] != IPPROTO_UDP_NUMBER || (ReadUInt16(packet + 6) & 0x3fff)) {
+    return;
+  }
+
+  const uint8_t *destination = packet + 16;
+  if (memcmp(destination, E131_GROUP_PREFIX, sizeof(E131_GROUP_PREFIX)) ||
+      !m_universes[ReadUInt16(destination + 2)]) {
+    return;
+  }
+
+  const uint8_t *udp = packet + header_size;
+  if (ReadUInt16(udp + 2) != m_port) {
+    return;
+  }
+
+  unsigned int udp_length = std::min(
+      static_cast<unsigned int>(ReadUInt16(udp + 4)),
+      total_length - header_size);
+  if (udp_length < UDP_HEADER_SIZE + PreamblePacker::ACN_HEADER_SIZE) {
+    return;
+  }
+
+  const uint8_t *data = udp + UDP_HEADER_SIZE;
+  unsigned int data_length = udp_length - UDP_HEADER_SIZE;
+  if (memcmp(data, PreamblePacker::ACN_HEADER,
+             PreamblePacker::ACN_HEADER_SIZE)) {
+    OLA_WARN << "ACN header is bad, discarding";
+    return;
+  }
+
+  uint32_t source_ip;
+  memcpy(&source_ip, packet + 12, sizeof(source_ip));
+  IPV4SocketAddress source(IPV4Address(source_ip), ReadUInt16(udp));
+
+  HeaderSet header_set;
+  TransportHeader transport_header(source, TransportHeader::UDP);
+  header_set.SetTransportHeader(transport_header);
+
+  m_inflated++;
+  m_inflator->InflatePDUBlock(
+      &header_set,
+      data + PreamblePacker::ACN_HEADER_SIZE,
+      data_length - PreamblePacker::ACN_HEADER_SIZE);
+}
+
+
+PacketRingSocket::PacketRingSocket()
+    : m_handle(ola::io::INVALID_DESCRIPTOR),
+      m_ring(NULL),
+      m_ring_size(0),
+      m_frame_count(0),
+      m_frame_index(0) {
+}
+
+
+PacketRingSocket::~PacketRingSocket() {
+  Close();
+}
+
+
+#ifdef HAVE_LINUX_IF_PACKET_H
+bool PacketRingSocket::Open(const string &interface_name, uint16_t port) {
+  if (m_handle != ola::io::INVALID_DESCRIPTOR) {
+    return false;
+  }
+
+  unsigned int if_index = if_nametoindex(interface_name.c_str());
+  if (!if_index) {
+    OLA_WARN << "Unknown interface " << interface_name;
+    return false;
+  }
+
+  int fd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_IP));
+  if (fd < 0) {
+    OLA_WARN << "Failed to open packet socket: " << strerror(errno);
+    return false;
+  }
+
+  // Equivalent to 'udp dst port <port>' with fragments rejected, so the
+  // kernel only copies E1.31 traffic into the ring.
+  struct sock_filter filter_code[] = {
+    BPF_STMT(BPF_LD + BPF_H + BPF_ABS, 12),
+    BPF_JUMP(BPF_JMP + BPF_JEQ + BPF_K, ETH_P_IP, 0, 8),
+    BPF_STMT(BPF_LD + BPF_B + BPF_ABS, 23),
+    BPF_JUMP(BPF_JMP + BPF_JEQ + BPF_K, IPPROTO_UDP, 0, 6),
+    BPF_STMT(BPF_LD + BPF_H + BPF_ABS, 20),
+    BPF_JUMP(BPF_JMP + BPF_JSET + BPF_K, 0x1fff, 4, 0),
+    BPF_STMT(BPF_LDX + BPF_B + BPF_MSH, 14),
+    BPF_STMT(BPF_LD + BPF_H + BPF_IND, 16),
+    BPF_JUMP(BPF_JMP + BPF_JEQ + BPF_K, port, 0, 1),
+    BPF_STMT(BPF_RET + BPF_K, FRAME_SIZE),
+    BPF_STMT(BPF_RET + BPF_K, 0),
+  };
+  struct sock_fprog filter;
+  filter.len = sizeof(filter_code) / sizeof(filter_code[0]);
+  filter.filter = filter_code;
+  if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &filter,
+                 sizeof(filter)) < 0) {
+    OLA_WARN << "Failed to attach packet filter: " << strerror(errno);
+    close(fd);
+    return false;
+  }
+
+  int version = TPACKET_V2;
+  if (setsockopt(fd, SOL_PACKET, PACKET_VERSION, &version,
+                 sizeof(version)) < 0) {
+    OLA_WARN << "Failed to select TPACKET_V2: " << strerror(errno);
+    close(fd);
+    return false;
+  }
+
+  struct tpacket_req request;
+  request.tp_block_size = BLOCK_SIZE;
+  request.tp_block_nr = BLOCK_COUNT;
+  request.tp_frame_size = FRAME_SIZE;
+  request.tp_frame_nr = (BLOCK_SIZE / FRAME_SIZE) * BLOCK_COUNT;
+  if (setsockopt(fd, SOL_PACKET, PACKET_RX_RING, &request,
+                 sizeof(request)) < 0) {
+    OLA_WARN << "Failed to setup the packet ring: " << strerror(errno);
+    close(fd);
+    return false;
+  }
+
+  unsigned int ring_size = BLOCK_SIZE * BLOCK_COUNT;
+  void *ring = mmap(NULL, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                    0);
+  if (ring == MAP_FAILED) {
+    OLA_WARN << "Failed to map the packet ring: " << strerror(errno);
+    close(fd);
+    return false;
+  }
+
+  struct sockaddr_ll address;
+  memset(&address, 0, sizeof(address));
+  address.sll_family = AF_PACKET;
+  address.sll_protocol = htons(ETH_P_IP);
+  address.sll_ifindex = static_cast<int>(if_index);
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&address),
+           sizeof(address)) < 0) {
+    OLA_WARN << "Failed to bind to " << interface_name << ": "
+             << strerror(errno);
+    munmap(ring, ring_size);
+    close(fd);
+    return false;
+  }
+
+  // The membership socket is bound to an ephemeral port, so the E1.31
+  // datagrams aren't also queued on it.
+  if (!m_membership_socket.Init() ||
+      !m_membership_socket.Bind(
+          IPV4SocketAddress(IPV4Address::WildCard(), 0))) {
+    OLA_WARN << "Failed to setup the multicast membership socket";
+    m_membership_socket.Close();
+    munmap(ring, ring_size);
+    close(fd);
+    return false;
+  }
+
+  m_handle = fd;
+  m_ring = reinterpret_cast<uint8_t*>(ring);
+  m_ring_size = ring_size;
+  m_frame_count = request.tp_frame_nr;
+  m_frame_index = 0;
+  return true;
+}
+
+
+void PacketRingSocket::Close() {
+  m_membership_socket.Close();
+  if (m_ring) {
+    munmap(m_ring, m_ring_size);
+    m_ring = NULL;
+  }
+  if (m_handle != ola::io::INVALID_DESCRIPTOR) {
+    close(m_handle);
+    m_handle = ola::io::INVALID_DESCRIPTOR;
+  }
+}
+
+
+void PacketRingSocket::PerformRead() {
+  if (!m_ring) {
+    return;
+  }
+
+  while (true) {
+    struct tpacket2_hdr *header = reinterpret_cast<struct tpacket2_hdr*>(
+        m_ring + m_frame_index * FRAME_SIZE);
+    if (!(LoadFrameStatus(header) & TP_STATUS_USER)) {
+      break;
+    }
+
+    if (m_on_frame.get()) {
+      m_on_frame->Run(reinterpret_cast<uint8_t*>(header) + header->tp_mac,
+                      header->tp_snaplen);
+    }
+
+    ReturnFrameToKernel(header);
+    m_frame_index = (m_frame_index + 1) % m_frame_count;
+  }
+}
+
+
+bool PacketRingSocket::JoinMulticast(const IPV4Address &iface,
+                                     const IPV4Address &group) {
+  if (!m_ring) {
+    return false;
+  }
+  return m_membership_socket.JoinMulticast(iface, group);
+}
+
+
+bool PacketRingSocket::LeaveMulticast(const IPV4Address &iface,
+                                      const IPV4Address &group) {
+  if (!m_ring) {
+    return false;
+  }
+  return m_membership_socket.LeaveMulticast(iface, group);
+}
+#else
+bool PacketRingSocket::Open(const string&, uint16_t) {
+  OLA_WARN << "Packet rings aren't supported on this platform";
+  return false;
+}
+
+
+void PacketRingSocket::Close() {}
+
+
+void PacketRingSocket::PerformRead() {}
+
+
+bool PacketRingSocket::JoinMulticast(const IPV4Address&, const IPV4Address&) {
+  return false;
+}
+
+
+bool PacketRingSocket::LeaveMulticast(const IPV4Address&,
+                                      const IPV4Address&) {
+  return false;
+}
+#endif  // HAVE_LINUX_IF_PACKET_H
+
+
+PcapReader::PcapReader(std::istream *input)
+    : m_input(input),
+      m_big_endian(false),
+      m_link_type(0) {
+}
+
+
+bool PcapReader::ReadHeader() {
+  uint8_t header[FILE_HEADER_SIZE];
+  if (!m_input->read(reinterpret_cast<char*>(header), sizeof(header))) {
+    OLA_WARN << "Capture file is too short";
+    return false;
+  }
+
+  // Both the microsecond and nanosecond formats have the same layout.
+  static const uint8_t MAGIC[][4] = {
+    {0xa1, 0xb2, 0xc3, 0xd4},
+    {0xa1, 0xb2, 0x3c, 0x4d},
+  };
+  bool matched = false;
+  for (unsigned int i = 0; i < sizeof(MAGIC) / sizeof(MAGIC[0]); i++) {
+    uint8_t reversed[4] = {MAGIC[i][3], MAGIC[i][2], MAGIC[i][1],
+                           MAGIC[i][0]};
+    if (!memcmp(header, MAGIC[i], sizeof(MAGIC[i]))) {
+      m_big_endian = true;
+      matched = true;
+    } else if (!memcmp(header, reversed, sizeof(reversed))) {
+      m_big_endian = false;
+      matched = true;
+    }
+  }
+
+  if (!matched) {
+    OLA_WARN << "Not a pcap capture file";
+    return false;
+  }
+
+  m_link_type = ReadUInt32(header + 20);
+  if (m_link_type != LINKTYPE_ETHERNET && m_link_type != LINKTYPE_RAW) {
+    OLA_WARN << "Unsupported capture link type " << m_link_type;
+    return false;
+  }
+  return true;
+}
+
+
+bool PcapReader::NextPacket(const uint8_t **data, unsigned int *length) {
+  uint8_t header[RECORD_HEADER_SIZE];
+  if (!m_input->read(reinterpret_cast<char*>(header), sizeof(header))) {
+    return false;
+  }
+
+  uint32_t captured_length = ReadUInt32(header + 8);
+  if (captured_length > MAX_PACKET_SIZE) {
+    OLA_WARN << "Capture record of " << captured_length << " bytes is too "
+             << "large";
+    return false;
+  }
+
+  m_packet.resize(std::max(captured_length, 1u));
+  if (!m_input->read(reinterpret_cast<char*>(&m_packet[0]),
+                     captured_length)) {
+    OLA_WARN << "Truncated capture record";
+    return false;
+  }
+  *data = &m_packet[0];
+  *length = captured_length;
+  return true;
+}
+
+
+unsigned int PcapReader::Replay(IncomingRawTransport *transport) {
+  unsigned int count = 0;
+  const uint8_t *data;
+  unsigned int length;
+  while (NextPacket(&data, &length)) {
+    if (m_link_type == LINKTYPE_RAW) {
+      transport->HandleIPV4Packet(data, length);
+    } else {
+      transport->HandleEthernetFrame(data, length);
+    }
+    count++;
+  }
+  return count;
+}
+
+
+bool PcapReader::ReplayFile(const string &filename,
+                            IncomingRawTransport *transport) {
+  std::ifstream input(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!input.is_open()) {
+    OLA_WARN << "Failed to open " << filename;
+    return false;
+  }
+
+  PcapReader reader(&input);
+  if (!reader.ReadHeader()) {
+    return false;
+  }
+  unsigned int count = reader.Replay(transport);
+  OLA_INFO << "Replayed " << count << " packets from " << filename;
+  return true;
+}
+
+
+uint32_t PcapReader::ReadUInt32(const uint8_t *data) const {
+  if (m_big_endian) {
+    return (static_cast<uint32_t>(data[0]) << 24) |
+           (static_cast<uint32_t>(data[1]) << 16) |
+           (static_cast<uint32_t>(data[2]) << 8) | data[3];
+  }
+  return (static_cast<uint32_t>(data[3]) << 24) |
+         (static_cast<uint32_t>(data[2]) << 16) |
+         (static_cast<uint32_t>(data[1]) << 8) | data[0];
+}
+}  // namespace acn
+}  // namespace ola
@@ -0,0 +1,246 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RawTransport.h
+ * Receive E1.31 multicast traffic from a raw packet capture.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef LIBS_ACN_RAWTRANSPORT_H_
+#define LIBS_ACN_RAWTRANSPORT_H_
+
+#include <stdint.h>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ola/Callback.h"
+#include "ola/acn/ACNPort.h"
+#include "ola/base/Macro.h"
+#include "ola/io/Descriptor.h"
+#include "ola/network/IPV4Address.h"
+#include "ola/network/Socket.h"
+
+namespace ola {
+namespace acn {
+
+/**
+ * IncomingRawTransport takes captured frames, picks out the E1.31 multicast
+ * datagrams for the universes we're interested in and passes them to the
+ * inflator.
+ *
+ * The universe is taken from the destination multicast group
+ * (239.255.hi.lo), so data, synchronization and discovery packets are all
+ * filtered the same way without decoding the PDUs. Unicast traffic isn't
+ * handled here, it continues to arrive on the node's UDP socket.
+ */
+class IncomingRawTransport {
+ public:
+  IncomingRawTransport(class BaseInflator *inflator,
+                       uint16_t port = ola::acn::ACN_PORT);
+  ~IncomingRawTransport() {}
+
+  /**
+   * @brief Start accepting packets sent to the group for this universe.
+   */
+  void AddUniverse(uint16_t universe);
+
+  /**
+   * @brief Stop accepting packets sent to the group for this universe.
+   */
+  void RemoveUniverse(uint16_t universe);
+
+  /**
+   * @brief Handle an Ethernet II frame, with an optional 802.1Q tag.
+   */
+  void HandleEthernetFrame(const uint8_t *frame, unsigned int length);
+
+  /**
+   * @brief Handle an IPv4 packet, starting from the IP header.
+   */
+  void HandleIPV4Packet(const uint8_t *packet, unsigned int length);
+
+  /**
+   * @brief The number of datagrams passed to the inflator.
+   */
+  unsigned int DatagramsInflated() const { return m_inflated; }
+
+ private:
+  class BaseInflator *m_inflator;
+  const uint16_t m_port;
+  std::vector<bool> m_universes;
+  unsigned int m_inflated;
+
+  static const uint16_t ETHERTYPE_IPV4 = 0x0800;
+  static const uint16_t ETHERTYPE_VLAN = 0x8100;
+  static const unsigned int ETHERNET_HEADER_SIZE = 14;
+  static const unsigned int VLAN_TAG_SIZE = 4;
+  static const unsigned int IPV4_MIN_HEADER_SIZE = 20;
+  static const unsigned int UDP_HEADER_SIZE = 8;
+  static const uint8_t IPPROTO_UDP_NUMBER = 17;
+  // The E1.31 multicast groups are 239.255.0.0/16
+  static const uint8_t E131_GROUP_PREFIX[];
+
+  DISALLOW_COPY_AND_ASSIGN(IncomingRawTransport);
+};
+
+
+/**
+ * PacketRingSocket receives frames from an interface using a memory mapped
+ * AF_PACKET receive ring.
+ *
+ * The socket installs a BPF filter so only UDP datagrams to the E1.31 port
+ * are copied into the ring, and the frames are read without a system call
+ * each. It requires Linux and CAP_NET_RAW.
+ *
+ * A packet socket doesn't join multicast groups, so switches doing IGMP
+ * snooping wouldn't forward the traffic. The group memberships are held by an
+ * auxiliary UDP socket instead, see JoinMulticast().
+ */
+class PacketRingSocket: public ola::io::ReadFileDescriptor {
+ public:
+  typedef ola::Callback2<void, const uint8_t*, unsigned int> FrameCallback;
+
+  PacketRingSocket();
+  ~PacketRingSocket();
+
+  /**
+   * @brief Open the ring on an interface.
+   * @param interface_name the name of the interface to capture from.
+   * @param port the UDP destination port to capture.
+   * @returns true if the ring was setup, false otherwise.
+   */
+  bool Open(const std::string &interface_name,
+            uint16_t port = ola::acn::ACN_PORT);
+
+  /**
+   * @brief Close the ring.
+   */
+  void Close();
+
+  /**
+   * @brief Join a multicast group so the traffic for it reaches the ring.
+   * @param iface the address of the interface to join on.
+   * @param group the multicast group to join.
+   * @returns true if the group was joined, false otherwise.
+   */
+  bool JoinMulticast(const ola::network::IPV4Address &iface,
+                     const ola::network::IPV4Address &group);
+
+  /**
+   * @brief Leave a multicast group.
+   * @param iface the address of the interface to leave on.
+   * @param group the multicast group to leave.
+   * @returns true if the group was left, false otherwise.
+   */
+  bool LeaveMulticast(const ola::network::IPV4Address &iface,
+                      const ola::network::IPV4Address &group);
+
+  /**
+   * @brief Set the callback to run for each Ethernet frame.
+   * @param callback the callback to run, ownership is transferred.
+   */
+  void SetOnFrame(FrameCallback *callback) { m_on_frame.reset(callback); }
+
+  ola::io::DescriptorHandle ReadDescriptor() const { return m_handle; }
+
+  /**
+   * @brief Process all frames waiting in the ring.
+   */
+  void PerformRead();
+
+ private:
+  ola::io::DescriptorHandle m_handle;
+  uint8_t *m_ring;
+  unsigned int m_ring_size;
+  unsigned int m_frame_count;
+  unsigned int m_frame_index;
+  std::auto_ptr<FrameCallback> m_on_frame;
+  // Holds the multicast memberships, it never receives the data itself.
+  ola::network::UDPSocket m_membership_socket;
+
+  static const unsigned int BLOCK_SIZE = 1 << 16;
+  static const unsigned int BLOCK_COUNT = 64;
+  static const unsigned int FRAME_SIZE = 2048;
+
+  DISALLOW_COPY_AND_ASSIGN(PacketRingSocket);
+};
+
+
+/**
+ * PcapReader reads packets from a libpcap capture file. It's used to replay
+ * captured traffic through the IncomingRawTransport.
+ */
+class PcapReader {
+ public:
+  /**
+   * @brief Create a new PcapReader.
+   * @param input the stream to read from, ownership is not transferred.
+   */
+  explicit PcapReader(std::istream *input);
+  ~PcapReader() {}
+
+  /**
+   * @brief Read the file header.
+   * @returns true if this is a capture file we understand.
+   */
+  bool ReadHeader();
+
+  /**
+   * @brief Read the next packet.
+   * @param[out] data set to the start of the packet, valid until the next
+   *   call.
+   * @param[out] length the captured length of the packet.
+   * @returns false at the end of the file or on error.
+   */
+  bool NextPacket(const uint8_t **data, unsigned int *length);
+
+  /**
+   * @brief Pass each packet in the file to the transport.
+   * @returns the number of packets read.
+   */
+  unsigned int Replay(IncomingRawTransport *transport);
+
+  /**
+   * @brief Replay a capture file.
+   * @param filename the capture file to read.
+   * @param transport the transport to pass the packets to.
+   * @returns true if the file was read, false otherwise.
+   */
+  static bool ReplayFile(const std::string &filename,
+                         IncomingRawTransport *transport);
+
+  uint32_t LinkType() const { return m_link_type; }
+
+  static const uint32_t LINKTYPE_ETHERNET = 1;
+  static const uint32_t LINKTYPE_RAW = 101;
+
+ private:
+  std::istream *m_input;
+  bool m_big_endian;
+  uint32_t m_link_type;
+  std::vector<uint8_t> m_packet;
+
+  uint32_t ReadUInt32(const uint8_t *data) const;
+
+  static const unsigned int FILE_HEADER_SIZE = 24;
+  static const unsigned int RECORD_HEADER_SIZE = 16;
+  static const uint32_t MAX_PACKET_SIZE = 65535;
+
+  DISALLOW_COPY_AND_ASSIGN(PcapReader);
+};
+}  // namespace acn
+}  // namespace ola
+#endif  // LIBS_ACN_RAWTRANSPORT_H_
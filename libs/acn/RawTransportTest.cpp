@@ -0,0 +1,307 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * RawTransportTest.cpp
+ * Test fixture for the IncomingRawTransport and PcapReader.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/testing/TestUtils.h"
+#include "libs/acn/PDUTestCommon.h"
+#include "libs/acn/PreamblePacker.h"
+#include "libs/acn/RawTransport.h"
+
+namespace ola {
+namespace acn {
+
+using ola::acn::CID;
+using std::string;
+using std::vector;
+
+class RawTransportTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(RawTransportTest);
+  CPPUNIT_TEST(testEthernetFrames);
+  CPPUNIT_TEST(testFiltering);
+  CPPUNIT_TEST(testPcapReplay);
+  CPPUNIT_TEST(testBadPcap);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+  RawTransportTest(): TestFixture(), m_received(0) {}
+  void testEthernetFrames();
+  void testFiltering();
+  void testPcapReplay();
+  void testBadPcap();
+
+  void Received() { m_received++; }
+
+ private:
+  unsigned int m_received;
+
+  void BuildIPV4Packet(uint8_t universe_high, uint8_t universe_low,
+                       uint16_t port, vector<uint8_t> *packet);
+  void BuildEthernetFrame(bool vlan, const vector<uint8_t> &packet,
+                          vector<uint8_t> *frame);
+  void AppendUInt32(uint32_t value, string *output);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RawTransportTest);
+
+
+/*
+ * Build an IPv4 / UDP packet containing a MockPDU, sent to the E1.31
+ * multicast group for a universe.
+ */
+void RawTransportTest::BuildIPV4Packet(uint8_t universe_high,
+                                       uint8_t universe_low,
+                                       uint16_t port,
+                                       vector<uint8_t> *packet) {
+  PDUBlock<PDU> pdu_block;
+  MockPDU mock_pdu(4, 8);
+  pdu_block.AddPDU(&mock_pdu);
+  PreamblePacker packer;
+  unsigned int data_size;
+  const uint8_t *data = packer.Pack(pdu_block, &data_size);
+  OLA_ASSERT_NOT_NULL(data);
+
+  unsigned int udp_length = data_size + 8;
+  unsigned int total_length = udp_length + 20;
+  const uint8_t header[] = {
+    0x45, 0, static_cast<uint8_t>(total_length >> 8),
+    static_cast<uint8_t>(total_length & 0xff),
+    0, 0, 0x40, 0,  // id, don't fragment
+    1, 17, 0, 0,  // ttl, UDP, checksum
+    10, 0, 0, 1,  // source
+    239, 255, universe_high, universe_low,  // destination
+    0xd0, 0x00,  // source port
+    static_cast<uint8_t>(port >> 8), static_cast<uint8_t>(port & 0xff),
+    static_cast<uint8_t>(udp_length >> 8),
+    static_cast<uint8_t>(udp_length & 0xff),
+    0, 0,  // checksum
+  };
+  packet->assign(header, header + sizeof(header));
+  packet->insert(packet->end(), data, data + data_size);
+}
+
+
+void RawTransportTest::BuildEthernetFrame(bool vlan,
+                                          const vector<uint8_t> &packet,
+                                          vector<uint8_t> *frame) {
+  const uint8_t addresses[] = {
+    0x01, 0x00, 0x5e, 0x7f, 0x00, 0x01,
+    0x52, 0x12, 0x34, 0x56, 0x78, 0x9a,
+  };
+  frame->assign(addresses, addresses + sizeof(addresses));
+  if (vlan) {
+    const uint8_t tag[] = {0x81, 0x00, 0x00, 0x0a};
+    frame->insert(frame->end(), tag, tag + sizeof(tag));
+  }
+  frame->push_back(0x08);
+  frame->push_back(0x00);
+  frame->insert(frame->end(), packet.begin(), packet.end());
+}
+
+
+void RawTransportTest::AppendUInt32(uint32_t value, string *output) {
+  for (unsigned int i = 0; i < 4; i++) {
+    output->push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+
+/*
+ * Check that frames are passed to the inflator.
+ */
+void RawTransportTest::testEthernetFrames() {
+  std::auto_ptr<Callback0<void> > on_recv(
+      NewCallback(this, &RawTransportTest::Received));
+  MockInflator inflator(CID(), on_recv.get());
+  IncomingRawTransport transport(&inflator);
+  transport.AddUniverse(1);
+
+  vector<uint8_t> packet, frame;
+  BuildIPV4Packet(0, 1, ola::acn::ACN_PORT, &packet);
+  BuildEthernetFrame(false, packet, &frame);
+  transport.HandleEthernetFrame(&frame[0], frame.size());
+  OLA_ASSERT_EQ(1u, m_received);
+
+  BuildEthernetFrame(true, packet, &frame);
+  transport.HandleEthernetFrame(&frame[0], frame.size());
+  OLA_ASSERT_EQ(2u, m_received);
+
+  transport.HandleIPV4Packet(&packet[0], packet.size());
+  OLA_ASSERT_EQ(3u, m_received);
+  OLA_ASSERT_EQ(3u, transport.DatagramsInflated());
+
+  // truncated frames are ignored
+  for (unsigned int i = 0; i < frame.size(); i += 7) {
+    transport.HandleEthernetFrame(&frame[0], i);
+  }
+  OLA_ASSERT_EQ(3u, m_received);
+}
+
+
+/*
+ * Check we only pass on packets for the universes & port we're listening to.
+ */
+void RawTransportTest::testFiltering() {
+  std::auto_ptr<Callback0<void> > on_recv(
+      NewCallback(this, &RawTransportTest::Received));
+  MockInflator inflator(CID(), on_recv.get());
+  IncomingRawTransport transport(&inflator);
+  transport.AddUniverse(1);
+  transport.AddUniverse(0x1234);
+
+  vector<uint8_t> packet;
+  BuildIPV4Packet(0, 2, ola::acn::ACN_PORT, &packet);
+  transport.HandleIPV4Packet(&packet[0], packet.size());
+  OLA_ASSERT_EQ(0u, m_received);
+
+  BuildIPV4Packet(0x12, 0x34, ola::acn::ACN_PORT, &packet);
+  transport.HandleIPV4Packet(&packet[0], packet.size());
+  OLA_ASSERT_EQ(1u, m_received);
+
+  // wrong port
+  BuildIPV4Packet(0, 1, 6454, &packet);
+  transport.HandleIPV4Packet(&packet[0], packet.size());
+  OLA_ASSERT_EQ(1u, m_received);
+
+  // not an E1.31 group
+  BuildIPV4Packet(0, 1, ola::acn::ACN_PORT, &packet);
+  packet[17] = 254;
+  transport.HandleIPV4Packet(&packet[0], packet.size());
+  OLA_ASSERT_EQ(1u, m_received);
+  packet[17] = 255;
+
+  // a fragment
+  packet[6] = 0x20;
+  transport.HandleIPV4Packet(&packet[0], packet.size());
+  OLA_ASSERT_EQ(1u, m_received);
+  packet[6] = 0x40;
+
+  // bad ACN preamble
+  packet[28 + 4] = 'X';
+  transport.HandleIPV4Packet(&packet[0], packet.size());
+  OLA_ASSERT_EQ(1u, m_received);
+  packet[28 + 4] = 'A';
+
+  transport.HandleIPV4Packet(&packet[0], packet.size());
+  OLA_ASSERT_EQ(2u, m_received);
+
+  transport.RemoveUniverse(1);
+  transport.HandleIPV4Packet(&packet[0], packet.size());
+  OLA_ASSERT_EQ(2u, m_received);
+}
+
+
+/*
+ * Check that we can replay a capture file.
+ */
+void RawTransportTest::testPcapReplay() {
+  std::auto_ptr<Callback0<void> > on_recv(
+      NewCallback(this, &RawTransportTest::Received));
+  MockInflator inflator(CID(), on_recv.get());
+  IncomingRawTransport transport(&inflator);
+  transport.AddUniverse(1);
+
+  vector<uint8_t> packet, frame;
+  BuildIPV4Packet(0, 1, ola::acn::ACN_PORT, &packet);
+  BuildEthernetFrame(false, packet, &frame);
+  vector<uint8_t> other_packet, other_frame;
+  BuildIPV4Packet(0, 2, ola::acn::ACN_PORT, &other_packet);
+  BuildEthernetFrame(false, other_packet, &other_frame);
+
+  // little endian, microsecond resolution
+  string capture;
+  AppendUInt32(0xa1b2c3d4, &capture);
+  AppendUInt32(0x00040002, &capture);  // version 2.4
+  AppendUInt32(0, &capture);
+  AppendUInt32(0, &capture);
+  AppendUInt32(65535, &capture);
+  AppendUInt32(PcapReader::LINKTYPE_ETHERNET, &capture);
+
+  const vector<uint8_t> *frames[] = {&frame, &other_frame, &frame};
+  for (unsigned int i = 0; i < 3; i++) {
+    AppendUInt32(i, &capture);
+    AppendUInt32(0, &capture);
+    AppendUInt32(frames[i]->size(), &capture);
+    AppendUInt32(frames[i]->size(), &capture);
+    capture.append(frames[i]->begin(), frames[i]->end());
+  }
+
+  std::istringstream input(capture);
+  PcapReader reader(&input);
+  OLA_ASSERT_TRUE(reader.ReadHeader());
+  OLA_ASSERT_EQ(PcapReader::LINKTYPE_ETHERNET, reader.LinkType());
+  OLA_ASSERT_EQ(3u, reader.Replay(&transport));
+  OLA_ASSERT_EQ(2u, m_received);
+}
+
+
+/*
+ * Check that we reject files we don't understand.
+ */
+void RawTransportTest::testBadPcap() {
+  std::istringstream empty("");
+  PcapReader empty_reader(&empty);
+  OLA_ASSERT_FALSE(empty_reader.ReadHeader());
+
+  string capture;
+  AppendUInt32(0x12345678, &capture);
+  capture.append(20, '\0');
+  std::istringstream bad_magic(capture);
+  PcapReader bad_magic_reader(&bad_magic);
+  OLA_ASSERT_FALSE(bad_magic_reader.ReadHeader());
+
+  // big endian, nanosecond resolution, but an unsupported link type
+  const uint8_t header[] = {
+    0xa1, 0xb2, 0x3c, 0x4d, 0, 2, 0, 4,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0xff, 0xff, 0, 0, 0, 105,
+  };
+  std::istringstream bad_link(
+      string(reinterpret_cast<const char*>(header), sizeof(header)));
+  PcapReader bad_link_reader(&bad_link);
+  OLA_ASSERT_FALSE(bad_link_reader.ReadHeader());
+
+  // a truncated record
+  capture.clear();
+  AppendUInt32(0xa1b2c3d4, &capture);
+  AppendUInt32(0x00040002, &capture);
+  AppendUInt32(0, &capture);
+  AppendUInt32(0, &capture);
+  AppendUInt32(65535, &capture);
+  AppendUInt32(PcapReader::LINKTYPE_RAW, &capture);
+  AppendUInt32(0, &capture);
+  AppendUInt32(0, &capture);
+  AppendUInt32(100, &capture);
+  AppendUInt32(100, &capture);
+  capture.append(10, '\0');
+  std::istringstream truncated(capture);
+  PcapReader truncated_reader(&truncated);
+  OLA_ASSERT_TRUE(truncated_reader.ReadHeader());
+  const uint8_t *data;
+  unsigned int length;
+  OLA_ASSERT_FALSE(truncated_reader.NextPacket(&data, &length));
+}
+}  // namespace acn
+}  // namespace ola
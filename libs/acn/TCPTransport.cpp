@@ -21,6 +21,7 @@
 #include <ola/Logging.h>
 #include <ola/StringUtils.h>
 #include <ola/network/SocketAddress.h>
+#include <string.h>
 #include <algorithm>
 #include <iostream>
 #include "libs/acn/BaseInflator.h"
@@ -50,14 +51,23 @@ const unsigned int IncomingStreamTransport::INITIAL_SIZE = 500;
  * @param inflator the inflator to call for each PDU
  * @param descriptor the descriptor to read from
  * @param source the IP and port to use in the transport header
+ * @param receive_buffer an optional buffer to read into, this may be shared
+ *   with other transports.
+ * @param receive_buffer_size the size of receive_buffer.
  */
 IncomingStreamTransport::IncomingStreamTransport(
     BaseInflator *inflator,
     ola::io::ConnectedDescriptor *descriptor,
-    const ola::network::IPV4SocketAddress &source)
+    const ola::network::IPV4SocketAddress &source,
+    uint8_t *receive_buffer,
+    unsigned int receive_buffer_size)
     : m_transport_header(source, TransportHeader::TCP),
       m_inflator(inflator),
       m_descriptor(descriptor),
+      m_receive_buffer(receive_buffer_size ? receive_buffer : NULL),
+      m_receive_buffer_size(receive_buffer_size),
+      m_pending_data(NULL),
+      m_pending_size(0),
       m_buffer_start(NULL),
       m_buffer_end(NULL),
       m_data_end(NULL),
@@ -85,6 +95,17 @@ IncomingStreamTransport::~IncomingStreamTransport() {
  * caller should close the descriptor since the data is no longer valid.
  */
 bool IncomingStreamTransport::Receive() {
+  if (m_receive_buffer) {
+    // One read per call, ReadRequiredData() then copies from the buffer.
+    unsigned int data_read = 0;
+    if (m_descriptor->Receive(m_receive_buffer, m_receive_buffer_size,
+                              data_read) != 0) {
+      OLA_WARN << "tcp rx failed";
+    }
+    m_pending_data = m_receive_buffer;
+    m_pending_size = data_read;
+  }
+
   while (true) {
     OLA_DEBUG << "start read, outstanding bytes is " << m_outstanding_data;
     // Read as much as we need
@@ -278,6 +299,16 @@ void IncomingStreamTransport::ReadRequiredData() {
   if (m_outstanding_data > FreeSpace())
     IncreaseBufferSize(DataLength() + m_outstanding_data);
 
+  if (m_receive_buffer) {
+    unsigned int length = std::min(m_outstanding_data, m_pending_size);
+    memcpy(m_data_end, m_pending_data, length);
+    m_pending_data += length;
+    m_pending_size -= length;
+    m_data_end += length;
+    m_outstanding_data -= length;
+    return;
+  }
+
   unsigned int data_read;
   int ok = m_descriptor->Receive(m_data_end,
                                  m_outstanding_data,
@@ -316,13 +347,16 @@ void IncomingStreamTransport::EnterWaitingForPDU() {
  * Create a new IncomingTCPTransport
  */
 IncomingTCPTransport::IncomingTCPTransport(BaseInflator *inflator,
-                                           ola::network::TCPSocket *socket)
+                                           ola::network::TCPSocket *socket,
+                                           uint8_t *receive_buffer,
+                                           unsigned int receive_buffer_size)
     : m_transport(NULL) {
   ola::network::GenericSocketAddress address = socket->GetPeerAddress();
   if (address.Family() == AF_INET) {
     ola::network::IPV4SocketAddress v4_addr = address.V4Addr();
     m_transport.reset(
-        new IncomingStreamTransport(inflator, socket, v4_addr));
+        new IncomingStreamTransport(inflator, socket, v4_addr,
+                                    receive_buffer, receive_buffer_size));
   } else {
     OLA_WARN << "Invalid address for fd " << socket->ReadDescriptor();
   }
@@ -26,6 +26,13 @@
  * It's unlikely you want to use IncomingTCPTransport directly, since all
  * real world connections are TCP (rather than pipes etc.). The
  * IncomingStreamTransport is separate because it assists in testing.
+ *
+ * By default each transport reads exactly the number of bytes the next stage
+ * of the state machine needs, which costs several reads per PDU. A receive
+ * buffer can be supplied instead; each call to Receive() then reads as much as
+ * fits into the buffer and feeds the state machine from memory. The buffer is
+ * only used for the duration of Receive(), so one buffer can be shared between
+ * all the transports serviced by the same thread.
  */
 
 #ifndef LIBS_ACN_TCPTRANSPORT_H_
@@ -52,7 +59,9 @@ class IncomingStreamTransport {
  public:
     IncomingStreamTransport(class BaseInflator *inflator,
                             ola::io::ConnectedDescriptor *descriptor,
-                            const ola::network::IPV4SocketAddress &source);
+                            const ola::network::IPV4SocketAddress &source,
+                            uint8_t *receive_buffer = NULL,
+                            unsigned int receive_buffer_size = 0);
     ~IncomingStreamTransport();
 
     bool Receive();
@@ -75,6 +84,13 @@ class IncomingStreamTransport {
     class BaseInflator *m_inflator;
     ola::io::ConnectedDescriptor *m_descriptor;
 
+    // The optional receive buffer, and the data in it that hasn't been
+    // consumed yet.
+    uint8_t *m_receive_buffer;
+    const unsigned int m_receive_buffer_size;
+    const uint8_t *m_pending_data;
+    unsigned int m_pending_size;
+
     // end points to the byte after the data
     uint8_t *m_buffer_start, *m_buffer_end, *m_data_end;
     // the amount of data we need before we can move to the next stage
@@ -131,7 +147,9 @@ class IncomingStreamTransport {
 class IncomingTCPTransport {
  public:
     IncomingTCPTransport(class BaseInflator *inflator,
-                         ola::network::TCPSocket *socket);
+                         ola::network::TCPSocket *socket,
+                         uint8_t *receive_buffer = NULL,
+                         unsigned int receive_buffer_size = 0);
     ~IncomingTCPTransport() {}
 
     bool Receive() { return m_transport->Receive(); }
@@ -52,6 +52,7 @@ class TCPTransportTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testZeroLengthPDUBlock);
   CPPUNIT_TEST(testMultiplePDUs);
   CPPUNIT_TEST(testSinglePDUBlock);
+  CPPUNIT_TEST(testReceiveBuffer);
   CPPUNIT_TEST_SUITE_END();
 
  public:
@@ -63,6 +64,7 @@ class TCPTransportTest: public CppUnit::TestFixture {
     void testMultiplePDUs();
     void testMultiplePDUsWithExtraData();
     void testSinglePDUBlock();
+    void testReceiveBuffer();
     void setUp();
     void tearDown();
 
@@ -245,6 +247,29 @@ void TCPTransportTest::testSinglePDUBlock() {
 }
 
 
+/**
+ * Check a transport using a receive buffer that is smaller than the preamble,
+ * so every stage of the state machine spans several reads.
+ */
+void TCPTransportTest::testReceiveBuffer() {
+  uint8_t receive_buffer[7];
+  m_transport.reset(
+      new IncomingStreamTransport(m_inflator.get(), &m_loopback, m_localhost,
+                                  receive_buffer, sizeof(receive_buffer)));
+
+  SendPDU(OLA_SOURCELINE());
+  SendEmptyPDUBLock(OLA_SOURCELINE());
+  SendPDUBlock(OLA_SOURCELINE());
+  SendPDU(OLA_SOURCELINE());
+
+  for (unsigned int i = 0; i < 50 && m_pdus_received < 5; i++) {
+    m_ss->RunOnce(TimeInterval(0, 10000));
+  }
+  OLA_ASSERT(m_stream_ok);
+  OLA_ASSERT_EQ(5u, m_pdus_received);
+}
+
+
 /**
  * Send empty PDU block.
  */
@@ -64,6 +64,10 @@ void JaRulePortHandle::RunIncrementalDiscovery(
   m_queueing_controller.RunIncrementalDiscovery(callback);
 }
 
+void JaRulePortHandle::SetKnownUIDs(const ola::rdm::UIDSet &uids) {
+  m_impl->SetKnownUIDs(uids);
+}
+
 bool JaRulePortHandle::SendDMX(const DmxBuffer &buffer) {
   return m_impl->SendDMX(buffer);
 }
@@ -27,6 +27,7 @@
 #include <ola/rdm/RDMCommand.h>
 #include <ola/rdm/RDMControllerInterface.h>
 #include <ola/rdm/QueueingRDMController.h>
+#include <ola/rdm/UIDSet.h>
 
 #include <memory>
 
@@ -53,6 +54,12 @@ class JaRulePortHandle : public ola::rdm::DiscoverableRDMControllerInterface {
   void RunFullDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
   void RunIncrementalDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
 
+  /**
+   * @brief Seed the next incremental discovery with the UIDs found last time.
+   * @param uids the previously discovered UIDs.
+   */
+  void SetKnownUIDs(const ola::rdm::UIDSet &uids);
+
   /**
    * @brief Send DMX data from this widget
    * @param buffer The DmxBuffer containing the data to send.
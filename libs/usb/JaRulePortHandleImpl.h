@@ -29,6 +29,7 @@
 #include <ola/rdm/RDMCommand.h>
 #include <ola/rdm/RDMControllerInterface.h>
 #include <ola/rdm/UID.h>
+#include <ola/rdm/UIDSet.h>
 #include <ola/util/SequenceNumber.h>
 
 #include "libs/usb/JaRuleConstants.h"
@@ -61,6 +62,10 @@ class JaRulePortHandleImpl
   void SendRDMRequest(ola::rdm::RDMRequest *request,
                       ola::rdm::RDMCallback *on_complete);
 
+  void SetKnownUIDs(const ola::rdm::UIDSet &uids) {
+    m_discovery_agent.SetKnownUIDs(uids);
+  }
+
   // From DiscoveryTargetInterface
   void MuteDevice(const ola::rdm::UID &target,
                   MuteDeviceCallback *mute_complete);
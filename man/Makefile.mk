@@ -8,6 +8,7 @@ dist_man_MANS += \
     man/ola_patch.1 \
     man/ola_plugin_info.1 \
     man/ola_plugin_state.1 \
+    man/ola_rdm_compile_pids.1 \
     man/ola_rdm_discover.1 \
     man/ola_rdm_get.1 \
     man/ola_rdm_set.1 \
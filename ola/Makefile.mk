@@ -26,6 +26,7 @@ ola_libola_la_SOURCES = \
     ola/OlaClientCore.h \
     ola/OlaClientCore.cpp \
     ola/OlaClientWrapper.cpp \
+    ola/RpcObjectPool.h \
     ola/StreamingClient.cpp
 ola_libola_la_CXXFLAGS = $(COMMON_PROTOBUF_CXXFLAGS)
 ola_libola_la_LDFLAGS = -version-info 1:1:0
@@ -35,11 +36,13 @@ ola_libola_la_LIBADD = common/libolacommon.la
 ##################################################
 test_programs += ola/OlaClientTester
 
-ola_OlaClientTester_SOURCES = ola/OlaClientWrapperTest.cpp \
+ola_OlaClientTester_SOURCES = ola/OlaClientBatchTest.cpp \
+                              ola/OlaClientWrapperTest.cpp \
                               ola/StreamingClientTest.cpp
-ola_OlaClientTester_CXXFLAGS = $(COMMON_TESTING_FLAGS)
+ola_OlaClientTester_CXXFLAGS = $(COMMON_TESTING_PROTOBUF_FLAGS)
 ola_OlaClientTester_LDADD = $(COMMON_TESTING_LIBS) \
                             $(PLUGIN_LIBS) \
                             common/libolacommon.la \
                             olad/libolaserver.la \
-                            ola/libola.la
+                            ola/libola.la \
+                            $(libprotobuf_LIBS)
@@ -122,6 +122,15 @@ void OlaClient::SetPortPriorityOverride(unsigned int device_alias,
                                   callback);
 }
 
+void OlaClient::SetPortFrameRate(unsigned int device_alias,
+                                 unsigned int port,
+                                 unsigned int max_frame_rate,
+                                 unsigned int refresh_interval,
+                                 SetCallback *callback) {
+  m_core->SetPortFrameRate(device_alias, port, max_frame_rate,
+                           refresh_interval, callback);
+}
+
 void OlaClient::FetchUniverseList(UniverseListCallback *callback) {
   m_core->FetchUniverseList(callback);
 }
@@ -158,6 +167,12 @@ void OlaClient::RegisterUniverse(unsigned int universe,
   m_core->RegisterUniverse(universe, register_action, callback);
 }
 
+void OlaClient::RegisterUniverse(unsigned int universe,
+                                 const RegisterArgs &args,
+                                 SetCallback *callback) {
+  m_core->RegisterUniverse(universe, args, callback);
+}
+
 void OlaClient::SendDMX(unsigned int universe,
                         const DmxBuffer &data,
                         const SendDMXArgs &args) {
@@ -203,5 +218,112 @@ void OlaClient::RDMSet(unsigned int universe,
                        const SendRDMArgs& args) {
   m_core->RDMSet(universe, uid, sub_device, pid, data, data_length, args);
 }
+
+void OlaClient::RDMBulkGet(unsigned int universe,
+                           const ola::rdm::UIDSet &uids,
+                           uint16_t sub_device,
+                           const std::vector<uint16_t> &pids,
+                           RDMBulkGetCallback *callback) {
+  m_core->RDMBulkGet(universe, uids, sub_device, pids, callback);
+}
+
+void OlaClient::StreamRDMBulkGet(unsigned int universe,
+                                 const ola::rdm::UIDSet &uids,
+                                 uint16_t sub_device,
+                                 const std::vector<uint16_t> &pids,
+                                 RDMBulkGetResultCallback *on_result,
+                                 SetCallback *on_complete) {
+  m_core->StreamRDMBulkGet(universe, uids, sub_device, pids, on_result,
+                           on_complete);
+}
+
+OlaClient::Batch::Batch(OlaClient *client)
+    : m_core(client->m_core.get()) {
+}
+
+OlaClient::Batch::~Batch() {
+  if (!m_commands.empty()) {
+    m_core->FailRDMBatch(m_commands, "Batch was not sent");
+  }
+}
+
+void OlaClient::Batch::RDMGet(unsigned int universe,
+                              const ola::rdm::UID &uid,
+                              uint16_t sub_device,
+                              uint16_t pid,
+                              const uint8_t *data,
+                              unsigned int data_length,
+                              const SendRDMArgs& args) {
+  Add(false, universe, uid, sub_device, pid, data, data_length, args.callback,
+      args.include_raw_frames, NULL);
+}
+
+RDMFuture OlaClient::Batch::RDMGet(unsigned int universe,
+                                   const ola::rdm::UID &uid,
+                                   uint16_t sub_device,
+                                   uint16_t pid,
+                                   const uint8_t *data,
+                                   unsigned int data_length) {
+  RDMFuture future;
+  Add(false, universe, uid, sub_device, pid, data, data_length, NULL, false,
+      &future);
+  return future;
+}
+
+void OlaClient::Batch::RDMSet(unsigned int universe,
+                              const ola::rdm::UID &uid,
+                              uint16_t sub_device,
+                              uint16_t pid,
+                              const uint8_t *data,
+                              unsigned int data_length,
+                              const SendRDMArgs& args) {
+  Add(true, universe, uid, sub_device, pid, data, data_length, args.callback,
+      args.include_raw_frames, NULL);
+}
+
+RDMFuture OlaClient::Batch::RDMSet(unsigned int universe,
+                                   const ola::rdm::UID &uid,
+                                   uint16_t sub_device,
+                                   uint16_t pid,
+                                   const uint8_t *data,
+                                   unsigned int data_length) {
+  RDMFuture future;
+  Add(true, universe, uid, sub_device, pid, data, data_length, NULL, false,
+      &future);
+  return future;
+}
+
+void OlaClient::Batch::Send() {
+  if (m_commands.empty()) {
+    return;
+  }
+  // Swap first, in case a callback adds commands to this batch.
+  vector<BatchedRDMCommand*> commands;
+  commands.swap(m_commands);
+  m_core->SendRDMBatch(commands);
+}
+
+void OlaClient::Batch::Add(bool is_set,
+                           unsigned int universe,
+                           const ola::rdm::UID &uid,
+                           uint16_t sub_device,
+                           uint16_t pid,
+                           const uint8_t *data,
+                           unsigned int data_length,
+                           RDMCallback *callback,
+                           bool include_raw_frames,
+                           RDMFuture *future) {
+  BatchedRDMCommand *command = new BatchedRDMCommand(is_set, universe, uid,
+                                                     sub_device, pid);
+  if (data && data_length) {
+    command->data.assign(reinterpret_cast<const char*>(data), data_length);
+  }
+  command->callback = callback;
+  command->include_raw_frames = include_raw_frames;
+  if (future) {
+    command->future = new RDMFuture(*future);
+  }
+  m_commands.push_back(command);
+}
 }  // namespace client
 }  // namespace ola
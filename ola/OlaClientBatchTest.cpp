@@ -0,0 +1,225 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * OlaClientBatchTest.cpp
+ * Test fixture for OlaClient::Batch and the RpcObjectPool.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <string>
+
+#include "common/protocol/Ola.pb.h"
+#include "common/rpc/RpcController.h"
+#include "ola/Callback.h"
+#include "ola/RpcObjectPool.h"
+#include "ola/client/ClientTypes.h"
+#include "ola/client/OlaClient.h"
+#include "ola/client/Result.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/UID.h"
+#include "ola/testing/TestUtils.h"
+
+using ola::client::OlaClient;
+using ola::client::RDMCommandResult;
+using ola::client::RDMFuture;
+using ola::client::RDMMetadata;
+using ola::client::Result;
+using ola::client::RpcObjectPool;
+using ola::client::SendRDMArgs;
+using ola::rdm::UID;
+using ola::rpc::RpcController;
+using std::string;
+
+class OlaClientBatchTest: public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(OlaClientBatchTest);
+  CPPUNIT_TEST(testObjectPool);
+  CPPUNIT_TEST(testCommandResult);
+  CPPUNIT_TEST(testNotConnected);
+  CPPUNIT_TEST(testUnsentBatch);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    OlaClientBatchTest()
+        : m_uid(0x7a70, 1),
+          m_callbacks(0) {
+    }
+
+    void testObjectPool();
+    void testCommandResult();
+    void testNotConnected();
+    void testUnsentBatch();
+
+ private:
+    UID m_uid;
+    unsigned int m_callbacks;
+    string m_last_error;
+
+    void RDMComplete(const Result &result,
+                     const RDMMetadata &metadata,
+                     const ola::rdm::RDMResponse *response);
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(OlaClientBatchTest);
+
+
+void OlaClientBatchTest::RDMComplete(const Result &result,
+                                     const RDMMetadata &metadata,
+                                     const ola::rdm::RDMResponse *response) {
+  m_callbacks++;
+  m_last_error = result.Error();
+  OLA_ASSERT_EQ(ola::rdm::RDM_FAILED_TO_SEND, metadata.response_code);
+  OLA_ASSERT_NULL(response);
+}
+
+
+/*
+ * Check that the pool reuses objects, and resets them before they're reused.
+ */
+void OlaClientBatchTest::testObjectPool() {
+  RpcObjectPool<RpcController> pool(2);
+  OLA_ASSERT_EQ(0u, pool.Size());
+
+  RpcController *controller = pool.Acquire();
+  controller->SetFailed("foo");
+  pool.Release(controller);
+  OLA_ASSERT_EQ(1u, pool.Size());
+
+  RpcController *reused_controller = pool.Acquire();
+  OLA_ASSERT_EQ(controller, reused_controller);
+  OLA_ASSERT_FALSE(reused_controller->Failed());
+  OLA_ASSERT_EQ(0u, pool.Size());
+
+  // Only max_size objects are kept
+  RpcController *controller2 = pool.Acquire();
+  RpcController *controller3 = pool.Acquire();
+  pool.Release(reused_controller);
+  pool.Release(controller2);
+  pool.Release(controller3);
+  OLA_ASSERT_EQ(2u, pool.Size());
+
+  RpcObjectPool<ola::proto::RDMResponse> reply_pool;
+  ola::proto::RDMResponse *reply = reply_pool.Acquire();
+  reply->set_response_code(ola::proto::RDM_TIMEOUT);
+  reply->set_data("foo");
+  {
+    ola::client::PooledObject<ola::proto::RDMResponse> pooled_reply(
+        &reply_pool, reply);
+    OLA_ASSERT_EQ(string("foo"), pooled_reply->data());
+  }
+  OLA_ASSERT_EQ(1u, reply_pool.Size());
+  reply = reply_pool.Acquire();
+  OLA_ASSERT_FALSE(reply->has_response_code());
+  OLA_ASSERT_EQ(string(""), reply->data());
+  reply_pool.Release(reply);
+}
+
+
+/*
+ * Check that RDMCommandResult copies its response.
+ */
+void OlaClientBatchTest::testCommandResult() {
+  RDMCommandResult empty_result;
+  OLA_ASSERT_TRUE(empty_result.Success());
+  OLA_ASSERT_NULL(empty_result.Response());
+
+  const uint8_t data[] = {1, 2};
+  ola::rdm::RDMResponse response(
+      m_uid, UID(0x7a70, 2), 0, ola::rdm::RDM_ACK, 0, 0,
+      ola::rdm::RDMCommand::GET_COMMAND_RESPONSE,
+      ola::rdm::PID_DMX_START_ADDRESS, data, sizeof(data));
+  RDMCommandResult result("", RDMMetadata(ola::rdm::RDM_COMPLETED_OK),
+                          &response);
+  OLA_ASSERT_NOT_NULL(result.Response());
+  OLA_ASSERT_TRUE(result.Response() != &response);
+  OLA_ASSERT_TRUE(response == *result.Response());
+
+  RDMCommandResult copy(result);
+  OLA_ASSERT_TRUE(copy.Response() != result.Response());
+  OLA_ASSERT_TRUE(response == *copy.Response());
+  OLA_ASSERT_EQ(ola::rdm::RDM_COMPLETED_OK, copy.Metadata().response_code);
+
+  empty_result = copy;
+  OLA_ASSERT_NOT_NULL(empty_result.Response());
+  OLA_ASSERT_TRUE(response == *empty_result.Response());
+
+  RDMCommandResult failed("Timeout", RDMMetadata(), NULL);
+  OLA_ASSERT_FALSE(failed.Success());
+  OLA_ASSERT_EQ(string("Timeout"), failed.Error());
+}
+
+
+/*
+ * Check that a batch sent without a connection completes with an error.
+ */
+void OlaClientBatchTest::testNotConnected() {
+  OlaClient client(NULL);
+  OlaClient::Batch batch(&client);
+  OLA_ASSERT_EQ(0u, batch.Size());
+
+  const uint8_t data[] = {0, 1};
+  RDMFuture get_future = batch.RDMGet(1, m_uid, ola::rdm::ROOT_RDM_DEVICE,
+                                      ola::rdm::PID_DMX_START_ADDRESS);
+  RDMFuture set_future = batch.RDMSet(1, m_uid, ola::rdm::ROOT_RDM_DEVICE,
+                                      ola::rdm::PID_DMX_START_ADDRESS,
+                                      data, sizeof(data));
+  batch.RDMSet(1, m_uid, ola::rdm::ROOT_RDM_DEVICE,
+               ola::rdm::PID_DMX_START_ADDRESS, data, sizeof(data),
+               SendRDMArgs(ola::NewSingleCallback(
+                   this, &OlaClientBatchTest::RDMComplete)));
+  OLA_ASSERT_EQ(3u, batch.Size());
+  OLA_ASSERT_FALSE(get_future.IsComplete());
+
+  batch.Send();
+  OLA_ASSERT_EQ(0u, batch.Size());
+  OLA_ASSERT_EQ(1u, m_callbacks);
+  OLA_ASSERT_EQ(string("Not connected"), m_last_error);
+
+  OLA_ASSERT_TRUE(get_future.IsComplete());
+  OLA_ASSERT_FALSE(get_future.Get().Success());
+  OLA_ASSERT_EQ(string("Not connected"), get_future.Get().Error());
+  OLA_ASSERT_NULL(get_future.Get().Response());
+  OLA_ASSERT_TRUE(set_future.IsComplete());
+  OLA_ASSERT_FALSE(set_future.Get().Success());
+
+  // an empty batch is a no-op
+  batch.Send();
+  OLA_ASSERT_EQ(1u, m_callbacks);
+}
+
+
+/*
+ * Check that commands in a batch that's destroyed before it's sent are
+ * completed.
+ */
+void OlaClientBatchTest::testUnsentBatch() {
+  OlaClient client(NULL);
+  RDMFuture future;
+  {
+    OlaClient::Batch batch(&client);
+    future = batch.RDMGet(1, m_uid, ola::rdm::ROOT_RDM_DEVICE,
+                          ola::rdm::PID_DEVICE_INFO);
+    batch.RDMGet(1, m_uid, ola::rdm::ROOT_RDM_DEVICE,
+                 ola::rdm::PID_DEVICE_INFO, NULL, 0,
+                 SendRDMArgs(ola::NewSingleCallback(
+                     this, &OlaClientBatchTest::RDMComplete)));
+    OLA_ASSERT_FALSE(future.IsComplete());
+  }
+  OLA_ASSERT_TRUE(future.IsComplete());
+  OLA_ASSERT_EQ(string("Batch was not sent"), future.Get().Error());
+  OLA_ASSERT_EQ(1u, m_callbacks);
+  OLA_ASSERT_EQ(string("Batch was not sent"), m_last_error);
+}
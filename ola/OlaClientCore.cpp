@@ -39,6 +39,7 @@
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMEnums.h"
 #include "ola/rdm/RDMFrame.h"
+#include "ola/stl/STLUtils.h"
 
 namespace ola {
 namespace client {
@@ -328,10 +329,36 @@ void OlaClientCore::SetPortPriorityOverride(unsigned int device_alias,
   }
 }
 
-void OlaClientCore::FetchUniverseList(UniverseListCallback *callback) {
+void OlaClientCore::SetPortFrameRate(unsigned int device_alias,
+                                     unsigned int port,
+                                     unsigned int max_frame_rate,
+                                     unsigned int refresh_interval,
+                                     SetCallback *callback) {
+  ola::proto::PortFrameRateRequest request;
   RpcController *controller = new RpcController();
+  ola::proto::Ack *reply = new ola::proto::Ack();
+
+  request.set_device_alias(device_alias);
+  request.set_port_id(port);
+  request.set_max_frame_rate(max_frame_rate);
+  request.set_refresh_interval(refresh_interval);
+
+  if (m_connected) {
+    CompletionCallback *cb = ola::NewSingleCallback(
+        this,
+        &OlaClientCore::HandleAck,
+        controller, reply, callback);
+    m_stub->SetPortFrameRate(controller, &request, reply, cb);
+  } else {
+    controller->SetFailed(NOT_CONNECTED_ERROR);
+    HandleAck(controller, reply, callback);
+  }
+}
+
+void OlaClientCore::FetchUniverseList(UniverseListCallback *callback) {
+  RpcController *controller = m_controller_pool.Acquire();
   ola::proto::OptionalUniverseRequest request;
-  ola::proto::UniverseInfoReply *reply = new ola::proto::UniverseInfoReply();
+  ola::proto::UniverseInfoReply *reply = m_universe_reply_pool.Acquire();
 
   if (m_connected) {
     CompletionCallback *cb = ola::NewSingleCallback(
@@ -347,9 +374,9 @@ void OlaClientCore::FetchUniverseList(UniverseListCallback *callback) {
 
 void OlaClientCore::FetchUniverseInfo(unsigned int universe_id,
                                       UniverseInfoCallback *callback) {
-  RpcController *controller = new RpcController();
+  RpcController *controller = m_controller_pool.Acquire();
   ola::proto::OptionalUniverseRequest request;
-  ola::proto::UniverseInfoReply *reply = new ola::proto::UniverseInfoReply();
+  ola::proto::UniverseInfoReply *reply = m_universe_reply_pool.Acquire();
 
   request.set_universe(universe_id);
 
@@ -445,14 +472,34 @@ void OlaClientCore::RegisterUniverse(unsigned int universe,
                                      RegisterAction register_action,
                                      SetCallback *callback) {
   ola::proto::RegisterDmxRequest request;
-  RpcController *controller = new RpcController();
-  ola::proto::Ack *reply = new ola::proto::Ack();
-
   ola::proto::RegisterAction action = (
       register_action == REGISTER ? ola::proto::REGISTER :
         ola::proto::UNREGISTER);
   request.set_universe(universe);
   request.set_action(action);
+  request.set_streaming(true);
+  SendRegisterRequest(request, callback);
+}
+
+void OlaClientCore::RegisterUniverse(unsigned int universe,
+                                     const RegisterArgs &args,
+                                     SetCallback *callback) {
+  ola::proto::RegisterDmxRequest request;
+  request.set_universe(universe);
+  request.set_action(ola::proto::REGISTER);
+  request.set_streaming(true);
+  request.set_start_slot(args.start_slot);
+  request.set_slot_count(args.slot_count);
+  request.set_max_rate(args.max_rate);
+  request.set_changes_only(args.changes_only);
+  SendRegisterRequest(request, callback);
+}
+
+void OlaClientCore::SendRegisterRequest(
+    const ola::proto::RegisterDmxRequest &request,
+    SetCallback *callback) {
+  RpcController *controller = new RpcController();
+  ola::proto::Ack *reply = new ola::proto::Ack();
 
   if (m_connected) {
     CompletionCallback *cb = ola::NewSingleCallback(
@@ -588,6 +635,78 @@ void OlaClientCore::RDMSet(unsigned int universe,
                  args);
 }
 
+void OlaClientCore::RDMBulkGet(unsigned int universe,
+                               const UIDSet &uids,
+                               uint16_t sub_device,
+                               const vector<uint16_t> &pids,
+                               RDMBulkGetCallback *callback) {
+  BulkGetState *state = new BulkGetState();
+  state->callback = callback;
+  StartRDMBulkGet(universe, uids, sub_device, pids, state);
+}
+
+void OlaClientCore::StreamRDMBulkGet(unsigned int universe,
+                                     const UIDSet &uids,
+                                     uint16_t sub_device,
+                                     const vector<uint16_t> &pids,
+                                     RDMBulkGetResultCallback *on_result,
+                                     SetCallback *on_complete) {
+  BulkGetState *state = new BulkGetState();
+  state->on_result = on_result;
+  state->on_complete = on_complete;
+  StartRDMBulkGet(universe, uids, sub_device, pids, state);
+}
+
+void OlaClientCore::StartRDMBulkGet(unsigned int universe,
+                                    const UIDSet &uids,
+                                    uint16_t sub_device,
+                                    const vector<uint16_t> &pids,
+                                    BulkGetState *state) {
+  if (!m_connected) {
+    CompleteRDMBulkGet(state, NOT_CONNECTED_ERROR);
+    return;
+  }
+
+  ola::proto::RDMBulkGetRequest &request = state->request;
+  request.set_universe(universe);
+  request.set_sub_device(sub_device);
+  UIDSet::Iterator uid_iter = uids.Begin();
+  for (; uid_iter != uids.End(); ++uid_iter) {
+    ola::proto::UID *pb_uid = request.add_uid();
+    pb_uid->set_esta_id(uid_iter->ManufacturerId());
+    pb_uid->set_device_id(uid_iter->DeviceId());
+  }
+  vector<uint16_t>::const_iterator pid_iter = pids.begin();
+  for (; pid_iter != pids.end(); ++pid_iter) {
+    request.add_param_id(*pid_iter);
+  }
+  if (state->on_result) {
+    // Ask the server to stream the results back as they arrive. Otherwise
+    // they're returned in the reply, in UID then PID order.
+    request.set_stream_id(m_bulk_get_sequence.Next());
+    m_bulk_gets[request.stream_id()] = state;
+  }
+  SendRDMBulkGet(state);
+}
+
+void OlaClientCore::SendRDMBulkGet(BulkGetState *state) {
+  if (!m_connected) {
+    CompleteRDMBulkGet(state, NOT_CONNECTED_ERROR);
+    return;
+  }
+
+  RpcController *controller = new RpcController();
+  ola::proto::RDMBulkGetReply *reply = new ola::proto::RDMBulkGetReply();
+  state->request.set_offset(state->received);
+
+  CompletionCallback *cb = NewSingleCallback(
+      this,
+      &OlaClientCore::HandleRDMBulkGet,
+      controller, reply, state);
+
+  m_stub->RDMBulkGet(controller, &state->request, reply, cb);
+}
+
 void OlaClientCore::SendTimeCode(const ola::timecode::TimeCode &timecode,
                                  SetCallback *callback) {
   if (!timecode.IsValid()) {
@@ -625,18 +744,43 @@ void OlaClientCore::UpdateDmxData(ola::rpc::RpcController*,
                                   const ola::proto::DmxData *request,
                                   ola::proto::Ack*,
                                   CompletionCallback *done) {
+  HandleDmxData(*request);
+  done->Run();
+}
+
+void OlaClientCore::StreamDmxData(ola::rpc::RpcController*,
+                                  const ola::proto::DmxData *request,
+                                  ola::proto::STREAMING_NO_RESPONSE*,
+                                  CompletionCallback*) {
+  HandleDmxData(*request);
+}
+
+void OlaClientCore::StreamRDMBulkGetResult(
+    ola::rpc::RpcController*,
+    const ola::proto::RDMBulkGetResult *request,
+    ola::proto::STREAMING_NO_RESPONSE*,
+    CompletionCallback*) {
+  BulkGetState *state = STLFindOrNull(m_bulk_gets, request->stream_id());
+  if (!state) {
+    OLA_INFO << "Got a RDMBulkGet result for unknown stream "
+             << request->stream_id();
+    return;
+  }
+  HandleRDMBulkGetResult(state, *request);
+}
+
+void OlaClientCore::HandleDmxData(const ola::proto::DmxData &request) {
   if (m_dmx_callback.get()) {
     DmxBuffer buffer;
-    buffer.Set(request->data());
+    buffer.Set(request.data());
 
     uint8_t priority = 0;
-    if (request->has_priority()) {
-      priority = request->priority();
+    if (request.has_priority()) {
+      priority = request.priority();
     }
-    DMXMetadata metadata(request->universe(), priority);
+    DMXMetadata metadata(request.universe(), priority, request.start_slot());
     m_dmx_callback->Run(metadata, buffer);
   }
-  done->Run();
 }
 
 void OlaClientCore::ChannelClosed(ClosedCallback *callback,
@@ -809,8 +953,9 @@ void OlaClientCore::HandleGeneralAck(RpcController *controller_ptr,
 void OlaClientCore::HandleUniverseList(RpcController *controller_ptr,
                                        ola::proto::UniverseInfoReply *reply_ptr,
                                        UniverseListCallback *callback) {
-  auto_ptr<RpcController> controller(controller_ptr);
-  auto_ptr<ola::proto::UniverseInfoReply> reply(reply_ptr);
+  PooledObject<RpcController> controller(&m_controller_pool, controller_ptr);
+  PooledObject<ola::proto::UniverseInfoReply> reply(&m_universe_reply_pool,
+                                                    reply_ptr);
 
   if (!callback) {
     return;
@@ -832,8 +977,9 @@ void OlaClientCore::HandleUniverseList(RpcController *controller_ptr,
 void OlaClientCore::HandleUniverseInfo(RpcController *controller_ptr,
                                        ola::proto::UniverseInfoReply *reply_ptr,
                                        UniverseInfoCallback *callback) {
-  auto_ptr<RpcController> controller(controller_ptr);
-  auto_ptr<ola::proto::UniverseInfoReply> reply(reply_ptr);
+  PooledObject<RpcController> controller(&m_controller_pool, controller_ptr);
+  PooledObject<ola::proto::UniverseInfoReply> reply(&m_universe_reply_pool,
+                                                    reply_ptr);
 
   if (!callback) {
     return;
@@ -909,11 +1055,86 @@ void OlaClientCore::HandleUIDList(RpcController *controller_ptr,
   callback->Run(result, uids);
 }
 
+void OlaClientCore::HandleRDMBulkGet(RpcController *controller_ptr,
+                                     ola::proto::RDMBulkGetReply *reply_ptr,
+                                     BulkGetState *state) {
+  auto_ptr<RpcController> controller(controller_ptr);
+  auto_ptr<ola::proto::RDMBulkGetReply> reply(reply_ptr);
+
+  if (controller->Failed()) {
+    CompleteRDMBulkGet(state, controller->ErrorText());
+    return;
+  }
+
+  // The results for this chunk have already been streamed to us, unless the
+  // server doesn't support streaming, in which case they're in the reply.
+  const unsigned int offset = state->request.offset();
+  for (int i = 0; i < reply->result_size(); ++i) {
+    HandleRDMBulkGetResult(state, reply->result(i));
+  }
+
+  if (state->received > offset && state->received < reply->total()) {
+    SendRDMBulkGet(state);
+  } else {
+    CompleteRDMBulkGet(state, "");
+  }
+}
+
+void OlaClientCore::HandleRDMBulkGetResult(
+    BulkGetState *state,
+    const ola::proto::RDMBulkGetResult &proto_result) {
+  RDMBulkGetResult bulk_result(
+      UID(proto_result.uid().esta_id(), proto_result.uid().device_id()),
+      proto_result.param_id());
+  bulk_result.cached = proto_result.cached();
+  bulk_result.response = BuildRDMResponse(
+      &proto_result.response(),
+      &bulk_result.metadata.response_code);
+  state->received++;
+
+  if (state->on_result) {
+    state->on_result->Run(bulk_result);
+    delete bulk_result.response;
+  } else {
+    state->results.push_back(bulk_result);
+  }
+}
+
+void OlaClientCore::CompleteRDMBulkGet(BulkGetState *state,
+                                       const string &error) {
+  if (state->request.has_stream_id()) {
+    m_bulk_gets.erase(state->request.stream_id());
+  }
+
+  // On failure, no results are returned
+  if (!error.empty()) {
+    vector<RDMBulkGetResult>::iterator iter = state->results.begin();
+    for (; iter != state->results.end(); ++iter) {
+      delete iter->response;
+    }
+    state->results.clear();
+  }
+
+  if (state->callback) {
+    state->callback->Run(Result(error), state->results);
+  }
+  if (state->on_complete) {
+    state->on_complete->Run(Result(error));
+  }
+  delete state->on_result;
+
+  vector<RDMBulkGetResult>::iterator iter = state->results.begin();
+  for (; iter != state->results.end(); ++iter) {
+    delete iter->response;
+  }
+  delete state;
+}
+
 void OlaClientCore::HandleRDM(RpcController *controller_ptr,
                    ola::proto::RDMResponse *reply_ptr,
                    RDMCallback *callback) {
-  auto_ptr<RpcController> controller(controller_ptr);
-  auto_ptr<ola::proto::RDMResponse> reply(reply_ptr);
+  PooledObject<RpcController> controller(&m_controller_pool, controller_ptr);
+  PooledObject<ola::proto::RDMResponse> reply(&m_rdm_reply_pool, reply_ptr);
 
   if (!callback) {
     return;
@@ -925,23 +1146,43 @@ void OlaClientCore::HandleRDM(RpcController *controller_ptr,
 
   if (!controller->Failed()) {
     response = BuildRDMResponse(reply.get(), &metadata.response_code);
-    for (int i = 0; i < reply->raw_frame_size(); i++) {
-      const ola::proto::RDMFrame &proto_frame = reply->raw_frame(i);
-
-      ola::rdm::RDMFrame frame(
-          reinterpret_cast<const uint8_t*>(proto_frame.raw_response().data()),
-          proto_frame.raw_response().size());
-      frame.timing.response_time = proto_frame.timing().response_delay();
-      frame.timing.break_time = proto_frame.timing().break_time();
-      frame.timing.mark_time = proto_frame.timing().mark_time();
-      frame.timing.data_time = proto_frame.timing().data_time();
-      metadata.frames.push_back(frame);
-    }
+    AddRDMFrames(*reply.get(), &metadata);
   }
 
   callback->Run(result, metadata, response);
 }
 
+void OlaClientCore::HandleRDMBatch(RpcController *controller_ptr,
+                                   ola::proto::RDMBatchReply *reply_ptr,
+                                   vector<BatchedRDMCommand*> *commands_ptr) {
+  PooledObject<RpcController> controller(&m_controller_pool, controller_ptr);
+  PooledObject<ola::proto::RDMBatchReply> reply(&m_rdm_batch_reply_pool,
+                                                reply_ptr);
+  auto_ptr<vector<BatchedRDMCommand*> > commands(commands_ptr);
+
+  string error;
+  if (controller->Failed()) {
+    error = controller->ErrorText();
+  } else if (reply->response_size() != static_cast<int>(commands->size())) {
+    OLA_WARN << "RDMBatch returned " << reply->response_size()
+             << " responses for " << commands->size() << " commands";
+    error = "Incorrect number of responses";
+  }
+
+  for (unsigned int i = 0; i < commands->size(); i++) {
+    RDMMetadata metadata;
+    ola::rdm::RDMResponse *response = NULL;
+    if (error.empty()) {
+      ola::proto::RDMResponse *proto_response = reply->mutable_response(i);
+      response = BuildRDMResponse(proto_response, &metadata.response_code);
+      AddRDMFrames(*proto_response, &metadata);
+    }
+    CompleteBatchedRDMCommand(*(*commands)[i], error, metadata, response);
+    delete response;
+    delete (*commands)[i];
+  }
+}
+
 void OlaClientCore::GenericFetchCandidatePorts(
     unsigned int universe_id,
     bool include_universe,
@@ -982,8 +1223,8 @@ void OlaClientCore::SendRDMCommand(bool is_set,
     return;
   }
 
-  RpcController *controller = new RpcController();
-  ola::proto::RDMResponse *reply = new ola::proto::RDMResponse();
+  RpcController *controller = m_controller_pool.Acquire();
+  ola::proto::RDMResponse *reply = m_rdm_reply_pool.Acquire();
 
   if (!m_connected) {
     controller->SetFailed(NOT_CONNECTED_ERROR);
@@ -1013,12 +1254,63 @@ void OlaClientCore::SendRDMCommand(bool is_set,
   m_stub->RDMCommand(controller, &request, reply, cb);
 }
 
+/*
+ * Send a batch of rdm commands
+ */
+void OlaClientCore::SendRDMBatch(const vector<BatchedRDMCommand*> &commands) {
+  if (!m_connected) {
+    FailRDMBatch(commands, NOT_CONNECTED_ERROR);
+    return;
+  }
+
+  vector<BatchedRDMCommand*>::const_iterator iter = commands.begin();
+  while (iter != commands.end()) {
+    vector<BatchedRDMCommand*> *rpc_commands = new vector<BatchedRDMCommand*>();
+    ola::proto::RDMBatchRequest request;
+
+    for (; iter != commands.end() && rpc_commands->size() < MAX_RDM_BATCH_SIZE;
+         ++iter) {
+      const BatchedRDMCommand *command = *iter;
+      ola::proto::RDMRequest *rdm_request = request.add_request();
+      rdm_request->set_universe(command->universe);
+      ola::proto::UID *pb_uid = rdm_request->mutable_uid();
+      pb_uid->set_esta_id(command->uid.ManufacturerId());
+      pb_uid->set_device_id(command->uid.DeviceId());
+      rdm_request->set_sub_device(command->sub_device);
+      rdm_request->set_param_id(command->pid);
+      rdm_request->set_is_set(command->is_set);
+      rdm_request->set_data(command->data);
+      if (command->include_raw_frames) {
+        rdm_request->set_include_raw_response(true);
+      }
+      rpc_commands->push_back(*iter);
+    }
+
+    RpcController *controller = m_controller_pool.Acquire();
+    ola::proto::RDMBatchReply *reply = m_rdm_batch_reply_pool.Acquire();
+    CompletionCallback *cb = NewSingleCallback(
+        this,
+        &OlaClientCore::HandleRDMBatch,
+        controller, reply, rpc_commands);
+    m_stub->RDMBatch(controller, &request, reply, cb);
+  }
+}
+
+void OlaClientCore::FailRDMBatch(const vector<BatchedRDMCommand*> &commands,
+                                 const string &error) {
+  vector<BatchedRDMCommand*>::const_iterator iter = commands.begin();
+  for (; iter != commands.end(); ++iter) {
+    CompleteBatchedRDMCommand(**iter, error, RDMMetadata(), NULL);
+    delete *iter;
+  }
+}
+
 /**
  * This constructs a ola::rdm::RDMResponse object from the information in a
  * ola::proto::RDMResponse.
  */
 ola::rdm::RDMResponse *OlaClientCore::BuildRDMResponse(
-    ola::proto::RDMResponse *reply,
+    const ola::proto::RDMResponse *reply,
     ola::rdm::RDMStatusCode *status_code) {
   // Get the response code, if it's not RDM_COMPLETED_OK don't bother with the
   // rest of the response data.
@@ -1075,5 +1367,35 @@ ola::rdm::RDMResponse *OlaClientCore::BuildRDMResponse(
       reinterpret_cast<const uint8_t*>(reply->data().c_str()),
       reply->data().size());
 }
+
+void OlaClientCore::AddRDMFrames(const ola::proto::RDMResponse &reply,
+                                 RDMMetadata *metadata) {
+  for (int i = 0; i < reply.raw_frame_size(); i++) {
+    const ola::proto::RDMFrame &proto_frame = reply.raw_frame(i);
+
+    ola::rdm::RDMFrame frame(
+        reinterpret_cast<const uint8_t*>(proto_frame.raw_response().data()),
+        proto_frame.raw_response().size());
+    frame.timing.response_time = proto_frame.timing().response_delay();
+    frame.timing.break_time = proto_frame.timing().break_time();
+    frame.timing.mark_time = proto_frame.timing().mark_time();
+    frame.timing.data_time = proto_frame.timing().data_time();
+    metadata->frames.push_back(frame);
+  }
+}
+
+void OlaClientCore::CompleteBatchedRDMCommand(
+    const BatchedRDMCommand &command,
+    const string &error,
+    const RDMMetadata &metadata,
+    const ola::rdm::RDMResponse *response) {
+  if (command.callback) {
+    Result result(error);
+    command.callback->Run(result, metadata, response);
+  }
+  if (command.future) {
+    command.future->Set(RDMCommandResult(error, metadata, response));
+  }
+}
 }  // namespace client
 }  // namespace ola
@@ -21,8 +21,10 @@
 #ifndef OLA_OLACLIENTCORE_H_
 #define OLA_OLACLIENTCORE_H_
 
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
@@ -30,6 +32,7 @@
 #include "common/rpc/RpcController.h"
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
+#include "ola/RpcObjectPool.h"
 #include "ola/client/CallbackTypes.h"
 #include "ola/client/ClientArgs.h"
 #include "ola/client/ClientTypes.h"
@@ -40,6 +43,7 @@
 #include "ola/rdm/UID.h"
 #include "ola/rdm/UIDSet.h"
 #include "ola/timecode/TimeCode.h"
+#include "ola/util/SequenceNumber.h"
 
 namespace ola {
 
@@ -49,6 +53,66 @@ class RpcSession;
 
 namespace client {
 
+/**
+ * @brief A RDM command queued by OlaClient::Batch.
+ */
+struct BatchedRDMCommand {
+  bool is_set;
+  unsigned int universe;
+  ola::rdm::UID uid;
+  uint16_t sub_device;
+  uint16_t pid;
+  std::string data;
+  bool include_raw_frames;
+  RDMCallback *callback;  // may be NULL
+  RDMFuture *future;  // may be NULL
+
+  BatchedRDMCommand(bool _is_set,
+                    unsigned int _universe,
+                    const ola::rdm::UID &_uid,
+                    uint16_t _sub_device,
+                    uint16_t _pid)
+      : is_set(_is_set),
+        universe(_universe),
+        uid(_uid),
+        sub_device(_sub_device),
+        pid(_pid),
+        include_raw_frames(false),
+        callback(NULL),
+        future(NULL) {
+  }
+
+  ~BatchedRDMCommand() {
+    delete future;
+  }
+};
+
+/**
+ * @brief The progress of an OlaClient::RDMBulkGet() or
+ * OlaClient::StreamRDMBulkGet().
+ *
+ * The server returns the results in chunks, each RPC asks for the results
+ * following the ones we already have. For StreamRDMBulkGet() the results are
+ * streamed to us as they arrive, and the reply follows the last result of the
+ * chunk.
+ */
+struct BulkGetState {
+  ola::proto::RDMBulkGetRequest request;
+  // Only used if on_result is NULL.
+  std::vector<RDMBulkGetResult> results;
+  RDMBulkGetCallback *callback;
+  RDMBulkGetResultCallback *on_result;
+  SetCallback *on_complete;
+  unsigned int received;  // the number of results received so far
+
+  BulkGetState()
+      : callback(NULL),
+        on_result(NULL),
+        on_complete(NULL),
+        received(0) {
+  }
+};
+
 /**
  * @brief The low level C++ API to olad.
  * Clients shouldn't use this directly. Instead use ola::client::OlaClient.
@@ -175,6 +239,21 @@ class OlaClientCore: public ola::proto::OlaClientService {
                                uint8_t value,
                                SetCallback *callback);
 
+  /**
+   * @brief Set the frame rate limits for an output port.
+   * @param device_alias the device containing the port to change
+   * @param port the port id of the output port to change.
+   * @param max_frame_rate the maximum frames per second, 0 means no limit.
+   * @param refresh_interval resend the last frame if none has been written
+   *   for this many ms, 0 disables this.
+   * @param callback the SetCallback to invoke upon completion.
+   */
+  void SetPortFrameRate(unsigned int device_alias,
+                        unsigned int port,
+                        unsigned int max_frame_rate,
+                        unsigned int refresh_interval,
+                        SetCallback *callback);
+
   /**
    * @brief Request a list of universes.
    * @param callback the UniverseListCallback to invoke upon completion.
@@ -236,6 +315,16 @@ class OlaClientCore: public ola::proto::OlaClientService {
                         RegisterAction register_action,
                         SetCallback *callback);
 
+  /**
+   * @brief Register our interest in part of a universe.
+   * @param universe the id of the universe to register for.
+   * @param args the RegisterArgs that select the updates to receive.
+   * @param callback the SetCallback to invoke upon completion.
+   */
+  void RegisterUniverse(unsigned int universe,
+                        const RegisterArgs &args,
+                        SetCallback *callback);
+
   /**
    * @brief Send DMX data.
    * @param universe the universe to send to.
@@ -306,6 +395,61 @@ class OlaClientCore: public ola::proto::OlaClientService {
               unsigned int data_length,
               const SendRDMArgs& args);
 
+  /**
+   * @brief Send RDM Get Commands for a list of PIDs to a set of responders.
+   * @param universe the universe to send the commands on
+   * @param uids the UIDs to send the commands to, if empty all UIDs in the
+   *   universe are used.
+   * @param sub_device the sub device index
+   * @param pids the PIDs to fetch from each responder
+   * @param callback the RDMBulkGetCallback to invoke upon completion.
+   *
+   * The GETs are sent by the server, so this only needs a single round trip
+   * per 256 results no matter how many responders and PIDs are requested.
+   */
+  void RDMBulkGet(unsigned int universe,
+                  const ola::rdm::UIDSet &uids,
+                  uint16_t sub_device,
+                  const std::vector<uint16_t> &pids,
+                  RDMBulkGetCallback *callback);
+
+  /**
+   * @brief Send RDM Get Commands for a list of PIDs to a set of responders,
+   * and receive each result as soon as it arrives.
+   * @param universe the universe to send the commands on
+   * @param uids the UIDs to send the commands to, if empty all UIDs in the
+   *   universe are used.
+   * @param sub_device the sub device index
+   * @param pids the PIDs to fetch from each responder
+   * @param on_result the RDMBulkGetResultCallback to run for each result.
+   *   Ownership is transferred.
+   * @param on_complete the SetCallback to run once all the results have been
+   *   received.
+   */
+  void StreamRDMBulkGet(unsigned int universe,
+                        const ola::rdm::UIDSet &uids,
+                        uint16_t sub_device,
+                        const std::vector<uint16_t> &pids,
+                        RDMBulkGetResultCallback *on_result,
+                        SetCallback *on_complete);
+
+  /**
+   * @brief Send a batch of RDM commands.
+   * @param commands the commands to send, ownership is transferred.
+   *
+   * The commands are split into RPCs of up to MAX_RDM_BATCH_SIZE commands.
+   */
+  void SendRDMBatch(const std::vector<BatchedRDMCommand*> &commands);
+
+  /**
+   * @brief Complete a batch of RDM commands with an error, without sending
+   * them.
+   * @param commands the commands to complete, ownership is transferred.
+   * @param error the error to report.
+   */
+  void FailRDMBatch(const std::vector<BatchedRDMCommand*> &commands,
+                    const std::string &error);
+
   /**
    * @brief Send TimeCode data.
    * @param timecode The timecode data.
@@ -322,14 +466,43 @@ class OlaClientCore: public ola::proto::OlaClientService {
                      ola::proto::Ack* response,
                      CompletionCallback* done);
 
+  /**
+   * @brief This is called by the channel when new DMX data is streamed to us.
+   */
+  void StreamDmxData(ola::rpc::RpcController* controller,
+                     const ola::proto::DmxData* request,
+                     ola::proto::STREAMING_NO_RESPONSE* response,
+                     CompletionCallback* done);
+
+  /**
+   * @brief This is called by the channel when the server streams us the
+   * result of a RDMBulkGet.
+   */
+  void StreamRDMBulkGetResult(ola::rpc::RpcController* controller,
+                              const ola::proto::RDMBulkGetResult* request,
+                              ola::proto::STREAMING_NO_RESPONSE* response,
+                              CompletionCallback* done);
+
  private:
   ola::io::ConnectedDescriptor *m_descriptor;
   std::auto_ptr<RepeatableDMXCallback> m_dmx_callback;
+  // The pools are declared before the channel, so they outlive any RPCs the
+  // channel fails when it's destroyed.
+  RpcObjectPool<ola::rpc::RpcController> m_controller_pool;
+  RpcObjectPool<ola::proto::RDMResponse> m_rdm_reply_pool;
+  RpcObjectPool<ola::proto::RDMBatchReply> m_rdm_batch_reply_pool;
+  RpcObjectPool<ola::proto::UniverseInfoReply> m_universe_reply_pool;
   std::auto_ptr<ola::rpc::RpcChannel> m_channel;
   std::auto_ptr<ola::proto::OlaServerService_Stub> m_stub;
   int m_connected;
+  // The RDMBulkGets in progress, by stream id.
+  std::map<uint32_t, BulkGetState*> m_bulk_gets;
+  ola::SequenceNumber<uint32_t> m_bulk_get_sequence;
 
   void ChannelClosed(ClosedCallback *callback, ola::rpc::RpcSession *session);
+  void HandleDmxData(const ola::proto::DmxData &request);
+  void SendRegisterRequest(const ola::proto::RegisterDmxRequest &request,
+                           SetCallback *callback);
 
   /**
    * @brief Called when GetPlugins() completes.
@@ -415,6 +588,45 @@ class OlaClientCore: public ola::proto::OlaClientService {
                  ola::proto::RDMResponse *reply,
                  RDMCallback *callback);
 
+  /**
+   * @brief Start a RDMBulkGet.
+   */
+  void StartRDMBulkGet(unsigned int universe,
+                       const ola::rdm::UIDSet &uids,
+                       uint16_t sub_device,
+                       const std::vector<uint16_t> &pids,
+                       BulkGetState *state);
+
+  /**
+   * @brief Send the RPC for the next set of results of a RDMBulkGet.
+   */
+  void SendRDMBulkGet(BulkGetState *state);
+
+  /**
+   * @brief Hand a single result of a RDMBulkGet to the caller.
+   */
+  void HandleRDMBulkGetResult(BulkGetState *state,
+                              const ola::proto::RDMBulkGetResult &result);
+
+  /**
+   * @brief Called when a RDMBulkGet RPC completes.
+   */
+  void HandleRDMBulkGet(ola::rpc::RpcController *controller,
+                        ola::proto::RDMBulkGetReply *reply,
+                        BulkGetState *state);
+
+  /**
+   * @brief Run the callback for a RDMBulkGet and clean up.
+   */
+  void CompleteRDMBulkGet(BulkGetState *state, const std::string &error);
+
+  /**
+   * @brief Called when a RDMBatch request completes.
+   */
+  void HandleRDMBatch(ola::rpc::RpcController *controller,
+                      ola::proto::RDMBatchReply *reply,
+                      std::vector<BatchedRDMCommand*> *commands);
+
   /**
    * @brief Fetch a list of candidate ports, with or without a universe
    */
@@ -438,11 +650,30 @@ class OlaClientCore: public ola::proto::OlaClientService {
    * @brief Builds a RDMResponse from the server's RDM reply message.
    */
   ola::rdm::RDMResponse *BuildRDMResponse(
-      ola::proto::RDMResponse *reply,
+      const ola::proto::RDMResponse *reply,
       ola::rdm::RDMStatusCode *status_code);
 
+  /**
+   * @brief Copies the raw frames from the server's RDM reply message.
+   */
+  static void AddRDMFrames(const ola::proto::RDMResponse &reply,
+                           RDMMetadata *metadata);
+
+  /**
+   * @brief Runs the callback and sets the future for a batched RDM command.
+   */
+  static void CompleteBatchedRDMCommand(
+      const BatchedRDMCommand &command,
+      const std::string &error,
+      const RDMMetadata &metadata,
+      const ola::rdm::RDMResponse *response);
+
   static const char NOT_CONNECTED_ERROR[];
 
+  // The most commands sent in a single RDMBatch RPC, this keeps the request
+  // and reply well under the RPC layer's message size limit.
+  static const unsigned int MAX_RDM_BATCH_SIZE = 256;
+
   DISALLOW_COPY_AND_ASSIGN(OlaClientCore);
 };
 
@@ -0,0 +1,130 @@
+/*
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * RpcObjectPool.h
+ * Reuses the RpcControllers and reply messages of completed RPCs.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLA_RPCOBJECTPOOL_H_
+#define OLA_RPCOBJECTPOOL_H_
+
+#include <google/protobuf/message.h>
+#include <vector>
+
+#include "common/rpc/RpcController.h"
+#include "ola/base/Macro.h"
+#include "ola/stl/STLUtils.h"
+
+namespace ola {
+namespace client {
+
+/**
+ * @brief Put a RpcController back into its initial state.
+ */
+inline void ResetPooledObject(ola::rpc::RpcController *controller) {
+  controller->Reset();
+}
+
+/**
+ * @brief Put a protobuf message back into its initial state.
+ */
+inline void ResetPooledObject(google::protobuf::Message *message) {
+  message->Clear();
+}
+
+/**
+ * @brief A free list of objects used for RPCs.
+ *
+ * Clients that issue many RPCs, like a burst of RDM commands, would otherwise
+ * allocate and free a controller and a reply per call. Objects are reset when
+ * they're released, and at most max_size idle objects are kept.
+ */
+template <typename T>
+class RpcObjectPool {
+ public:
+  explicit RpcObjectPool(unsigned int max_size = DEFAULT_MAX_SIZE)
+      : m_max_size(max_size) {
+  }
+
+  ~RpcObjectPool() {
+    STLDeleteElements(&m_free);
+  }
+
+  /**
+   * @brief Get an object from the pool, or a new one if the pool is empty.
+   */
+  T *Acquire() {
+    if (m_free.empty()) {
+      return new T();
+    }
+    T *object = m_free.back();
+    m_free.pop_back();
+    return object;
+  }
+
+  /**
+   * @brief Return an object to the pool.
+   */
+  void Release(T *object) {
+    if (m_free.size() < m_max_size) {
+      ResetPooledObject(object);
+      m_free.push_back(object);
+    } else {
+      delete object;
+    }
+  }
+
+  /**
+   * @brief The number of idle objects in the pool.
+   */
+  unsigned int Size() const { return m_free.size(); }
+
+  static const unsigned int DEFAULT_MAX_SIZE = 64;
+
+ private:
+  const unsigned int m_max_size;
+  std::vector<T*> m_free;
+
+  DISALLOW_COPY_AND_ASSIGN(RpcObjectPool);
+};
+
+/**
+ * @brief Returns an object to its RpcObjectPool when it goes out of scope.
+ */
+template <typename T>
+class PooledObject {
+ public:
+  PooledObject(RpcObjectPool<T> *pool, T *object)
+      : m_pool(pool),
+        m_object(object) {
+  }
+
+  ~PooledObject() {
+    m_pool->Release(m_object);
+  }
+
+  T *get() const { return m_object; }
+  T *operator->() const { return m_object; }
+
+ private:
+  RpcObjectPool<T> *m_pool;
+  T *m_object;
+
+  DISALLOW_COPY_AND_ASSIGN(PooledObject);
+};
+}  // namespace client
+}  // namespace ola
+#endif  // OLA_RPCOBJECTPOOL_H_
@@ -39,6 +39,10 @@ void ClientBroker::RemoveClient(const Client *client) {
   m_clients.erase(client);
 }
 
+bool ClientBroker::HasClient(const Client *client) const {
+  return STLContains(m_clients, client);
+}
+
 void ClientBroker::SendRDMRequest(const Client *client,
                                   Universe *universe,
                                   ola::rdm::RDMRequest *request,
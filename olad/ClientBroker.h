@@ -66,6 +66,13 @@ class ClientBroker {
    */
   void RemoveClient(const Client *client);
 
+  /**
+   * @brief Check if a client is still connected.
+   * @param client The Client to check.
+   * @returns true if the client is known to the broker, false otherwise.
+   */
+  bool HasClient(const Client *client) const;
+
   /**
    * @brief Make an RDM call.
    * @param client the Client responsible for making the call.
@@ -27,6 +27,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <memory>
+#include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -43,6 +45,8 @@
 #include "ola/rdm/PidStore.h"
 #include "ola/rdm/UID.h"
 #include "ola/stl/STLUtils.h"
+#include "ola/timecode/TimeCode.h"
+#include "ola/timecode/TimeCodeEnums.h"
 #include "olad/ClientBroker.h"
 #include "olad/DiscoveryAgent.h"
 #include "olad/OlaServer.h"
@@ -53,6 +57,7 @@
 #include "olad/Port.h"
 #include "olad/PortBroker.h"
 #include "olad/Preferences.h"
+#include "olad/TimeCodeEngine.h"
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
 #include "olad/plugin_api/DeviceManager.h"
@@ -77,9 +82,13 @@ using ola::rpc::RpcSession;
 using ola::rpc::RpcServer;
 using std::auto_ptr;
 using std::pair;
+using std::set;
+using std::string;
 using std::vector;
 
 const char OlaServer::INSTANCE_NAME_KEY[] = "instance-name";
+const char OlaServer::TIMECODE_MODE_KEY[] = "timecode-mode";
+const char OlaServer::TIMECODE_TYPE_KEY[] = "timecode-type";
 const char OlaServer::K_INSTANCE_NAME_VAR[] = "server-instance-name";
 const char OlaServer::K_UID_VAR[] = "server-uid";
 const char OlaServer::SERVER_PREFERENCES[] = "server";
@@ -123,6 +132,7 @@ OlaServer::~OlaServer() {
   // Order is important during shutdown.
   // Shutdown the RPC server first since it depends on almost everything else.
   m_rpc_server.reset();
+  m_timecode_engine.reset();
 
   if (m_housekeeping_timeout != ola::thread::INVALID_TIMEOUT) {
     m_ss->RemoveTimeout(m_housekeeping_timeout);
@@ -210,7 +220,7 @@ bool OlaServer::Init() {
   universe_preferences->Load();
 
   auto_ptr<UniverseStore> universe_store(
-      new UniverseStore(universe_preferences, m_export_map));
+      new UniverseStore(universe_preferences, m_export_map, m_ss));
 
   auto_ptr<PortBroker> port_broker(new PortBroker());
 
@@ -230,6 +240,11 @@ bool OlaServer::Init() {
   auto_ptr<PluginManager> plugin_manager(
     new PluginManager(m_plugin_loaders, plugin_adaptor.get()));
 
+  auto_ptr<TimeCodeEngine> timecode_engine(new TimeCodeEngine(
+      m_ss, &m_clock,
+      NewCallback(device_manager.get(), &DeviceManager::SendTimeCode),
+      m_export_map));
+
   auto_ptr<OlaServerServiceImpl> service_impl(new OlaServerServiceImpl(
       universe_store.get(),
       device_manager.get(),
@@ -237,7 +252,8 @@ bool OlaServer::Init() {
       port_manager.get(),
       broker.get(),
       m_ss->WakeUpTime(),
-      NewCallback(this, &OlaServer::ReloadPluginsInternal)));
+      NewCallback(this, &OlaServer::ReloadPluginsInternal),
+      timecode_engine.get()));
 
   // Initialize the RPC server.
   RpcServer::Options rpc_options;
@@ -304,8 +320,10 @@ bool OlaServer::Init() {
   m_port_manager.reset(port_manager.release());
   m_rpc_server.reset(rpc_server.release());
   m_service_impl.reset(service_impl.release());
+  m_timecode_engine.reset(timecode_engine.release());
   m_universe_store.reset(universe_store.release());
 
+  SetupTimeCode();
   UpdatePidStore(pid_store.release());
 
   if (m_housekeeping_timeout != ola::thread::INVALID_TIMEOUT) {
@@ -477,6 +495,48 @@ void OlaServer::ReloadPluginsInternal() {
   m_plugin_manager->LoadAll();
 }
 
+void OlaServer::SetupTimeCode() {
+  set<string> modes;
+  modes.insert(TimeCodeEngine::ModeToString(TimeCodeEngine::FORWARD));
+  modes.insert(TimeCodeEngine::ModeToString(TimeCodeEngine::GENERATE));
+  modes.insert(TimeCodeEngine::ModeToString(TimeCodeEngine::CHASE));
+
+  set<string> types;
+  types.insert("film");
+  types.insert("ebu");
+  types.insert("df");
+  types.insert("smpte");
+
+  bool save = m_server_preferences->SetDefaultValue(
+      TIMECODE_MODE_KEY, SetValidator<string>(modes),
+      TimeCodeEngine::ModeToString(TimeCodeEngine::FORWARD));
+  save |= m_server_preferences->SetDefaultValue(
+      TIMECODE_TYPE_KEY, SetValidator<string>(types), "smpte");
+  if (save) {
+    m_server_preferences->Save();
+  }
+
+  TimeCodeEngine::Mode mode = TimeCodeEngine::FORWARD;
+  TimeCodeEngine::ModeFromString(
+      m_server_preferences->GetValue(TIMECODE_MODE_KEY), &mode);
+  if (mode == TimeCodeEngine::CHASE) {
+    m_timecode_engine->Chase();
+  } else if (mode == TimeCodeEngine::GENERATE) {
+    const string type_str = m_server_preferences->GetValue(TIMECODE_TYPE_KEY);
+    ola::timecode::TimeCodeType type = ola::timecode::TIMECODE_SMPTE;
+    if (type_str == "film") {
+      type = ola::timecode::TIMECODE_FILM;
+    } else if (type_str == "ebu") {
+      type = ola::timecode::TIMECODE_EBU;
+    } else if (type_str == "df") {
+      type = ola::timecode::TIMECODE_DF;
+    }
+    m_timecode_engine->Generate(ola::timecode::TimeCode(type, 0, 0, 0, 0));
+  }
+  OLA_INFO << "Timecode mode is "
+           << TimeCodeEngine::ModeToString(m_timecode_engine->CurrentMode());
+}
+
 void OlaServer::UpdatePidStore(const RootPidStore *pid_store) {
   OLA_INFO << "Updated PID definitions.";
 #ifdef HAVE_LIBMICROHTTPD
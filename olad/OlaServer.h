@@ -25,6 +25,7 @@
 #include <config.h>
 #endif  // HAVE_CONFIG_H
 
+#include <ola/Clock.h>
 #include <ola/Constants.h>
 #include <ola/ExportMap.h>
 #include <ola/base/Macro.h>
@@ -193,6 +194,8 @@ class OlaServer : public ola::rpc::RpcSessionHandlerInterface {
   std::auto_ptr<const ola::rdm::RootPidStore> m_pid_store;
   std::auto_ptr<class DiscoveryAgentInterface> m_discovery_agent;
   std::auto_ptr<ola::rpc::RpcServer> m_rpc_server;
+  Clock m_clock;
+  std::auto_ptr<class TimeCodeEngine> m_timecode_engine;
   class Preferences *m_server_preferences;
   class Preferences *m_universe_preferences;
   std::string m_instance_name;
@@ -213,12 +216,18 @@ class OlaServer : public ola::rpc::RpcSessionHandlerInterface {
   bool InternalNewConnection(ola::rpc::RpcServer *server,
                              ola::io::ConnectedDescriptor *descriptor);
   void ReloadPluginsInternal();
+  /**
+   * @brief Configure the TimeCodeEngine from the server preferences.
+   */
+  void SetupTimeCode();
   /**
    * @brief Update the Pid store with the new values.
    */
   void UpdatePidStore(const ola::rdm::RootPidStore *pid_store);
 
   static const char INSTANCE_NAME_KEY[];
+  static const char TIMECODE_MODE_KEY[];
+  static const char TIMECODE_TYPE_KEY[];
   static const char K_INSTANCE_NAME_VAR[];
   static const char K_DISCOVERY_SERVICE_TYPE[];
   static const char K_UID_VAR[];
@@ -20,6 +20,7 @@
  */
 
 #include <algorithm>
+#include <iterator>
 #include <string>
 #include <vector>
 #include "common/protocol/Ola.pb.h"
@@ -29,7 +30,9 @@
 #include "ola/DmxBuffer.h"
 #include "ola/Logging.h"
 #include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMEnums.h"
 #include "ola/rdm/UIDSet.h"
+#include "ola/stl/STLUtils.h"
 #include "ola/strings/Format.h"
 #include "ola/timecode/TimeCode.h"
 #include "ola/timecode/TimeCodeEnums.h"
@@ -40,6 +43,7 @@
 #include "olad/Plugin.h"
 #include "olad/PluginManager.h"
 #include "olad/Port.h"
+#include "olad/TimeCodeEngine.h"
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
 #include "olad/plugin_api/DeviceManager.h"
@@ -78,8 +82,76 @@ using ola::rpc::RpcController;
 using std::string;
 using std::vector;
 
+/*
+ * Sends the RDM requests for a RDMBulkGet or RDMBatch RPC, with at most
+ * max_in_flight outstanding at once, and completes the RPC once they have all
+ * been answered.
+ */
+struct OlaServerServiceImpl::RDMFanOutState {
+  struct Command {
+    unsigned int universe_id;
+    ola::rdm::RDMRequest *request;
+    ola::rdm::RDMCallback *on_complete;
+  };
+
+  RDMFanOutState(Client *_client,
+                 unsigned int _max_in_flight,
+                 ola::rpc::RpcService::CompletionCallback *_done)
+      : client(_client),
+        max_in_flight(_max_in_flight),
+        done(_done),
+        in_flight(0),
+        sending(false) {
+  }
+  virtual ~RDMFanOutState() {}
+
+  void Queue(unsigned int universe_id,
+             ola::rdm::RDMRequest *request,
+             ola::rdm::RDMCallback *on_complete) {
+    Command command = {universe_id, request, on_complete};
+    pending.push(command);
+  }
+
+  Client *client;
+  const unsigned int max_in_flight;
+  ola::rpc::RpcService::CompletionCallback *done;
+  // the commands we still need to send
+  std::queue<Command> pending;
+  unsigned int in_flight;
+  bool sending;  // true if we're in SendFanOutRequests
+};
+
+/*
+ * Tracks the progress of a RDMBulkGet RPC.
+ */
+struct OlaServerServiceImpl::BulkGetState
+    : public OlaServerServiceImpl::RDMFanOutState {
+  BulkGetState(Client *_client,
+               ola::rpc::RpcService::CompletionCallback *_done)
+      : RDMFanOutState(_client, MAX_BULK_GETS_IN_FLIGHT, _done),
+        universe_id(0),
+        sub_device(ola::rdm::ROOT_RDM_DEVICE),
+        include_raw_response(false),
+        stream(false) {
+  }
+
+  unsigned int universe_id;
+  uint16_t sub_device;
+  bool include_raw_response;
+  // If true, each result is pushed to the client as soon as it's complete,
+  // rather than being held in the response. We then own the results.
+  bool stream;
+};
+
 namespace {
 
+void PopulateFrameRate(const InputPort&, PortInfo*) {}
+
+void PopulateFrameRate(const OutputPort &port, PortInfo *port_info) {
+  port_info->set_max_frame_rate(port.MaxFrameRate());
+  port_info->set_refresh_interval(port.RefreshInterval());
+}
+
 template<typename RequestType>
 
 RDMRequest::OverrideOptions RDMRequestOptionsFromProto(
@@ -117,14 +189,16 @@ OlaServerServiceImpl::OlaServerServiceImpl(
     PortManager *port_manager,
     ClientBroker *broker,
     const TimeStamp *wake_up_time,
-    ReloadPluginsCallback *reload_plugins_callback)
+    ReloadPluginsCallback *reload_plugins_callback,
+    TimeCodeEngine *timecode_engine)
     : m_universe_store(universe_store),
       m_device_manager(device_manager),
       m_plugin_manager(plugin_manager),
       m_port_manager(port_manager),
       m_broker(broker),
       m_wake_up_time(wake_up_time),
-      m_reload_plugins_callback(reload_plugins_callback) {
+      m_reload_plugins_callback(reload_plugins_callback),
+      m_timecode_engine(timecode_engine) {
 }
 
 void OlaServerServiceImpl::GetDmx(
@@ -157,7 +231,15 @@ void OlaServerServiceImpl::RegisterForDmx(
 
   Client *client = GetClient(controller);
   if (request->action() == ola::proto::REGISTER) {
-    universe->AddSinkClient(client);
+    if (request->has_streaming()) {
+      client->SetStreaming(request->streaming());
+    }
+    Universe::SinkClientOptions options;
+    options.start_slot = std::max(request->start_slot(), 0);
+    options.slot_count = std::max(request->slot_count(), 0);
+    options.max_rate = std::max(request->max_rate(), 0);
+    options.changes_only = request->changes_only();
+    universe->AddSinkClient(client, options);
   } else {
     universe->RemoveSinkClient(client);
   }
@@ -249,6 +331,24 @@ void OlaServerServiceImpl::SetMergeMode(
   universe->SetMergeMode(mode);
 }
 
+void OlaServerServiceImpl::SetSyncGroup(
+    RpcController* controller,
+    const ola::proto::SyncGroupRequest* request,
+    Ack*,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  Universe *universe = m_universe_store->GetUniverse(request->universe());
+  if (!universe) {
+    return MissingUniverseError(controller);
+  }
+
+  if (request->sync_group() < 0) {
+    controller->SetFailed("Invalid sync group");
+    return;
+  }
+  universe->SetSyncGroup(request->sync_group());
+}
+
 void OlaServerServiceImpl::PatchPort(
     RpcController* controller,
     const PatchPortRequest* request,
@@ -352,6 +452,33 @@ void OlaServerServiceImpl::SetPortPriority(
   }
 }
 
+void OlaServerServiceImpl::SetPortFrameRate(
+    RpcController* controller,
+    const ola::proto::PortFrameRateRequest* request,
+    Ack*,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  ClosureRunner runner(done);
+  AbstractDevice *device =
+      m_device_manager->GetDevice(request->device_alias());
+
+  if (!device) {
+    return MissingDeviceError(controller);
+  }
+
+  OutputPort *port = device->GetOutputPort(request->port_id());
+  if (!port) {
+    return MissingPortError(controller);
+  }
+
+  if (request->max_frame_rate() < 0 || request->refresh_interval() < 0) {
+    controller->SetFailed("Invalid SetPortFrameRate request");
+    return;
+  }
+
+  port->SetFrameRateLimits(request->max_frame_rate(),
+                           request->refresh_interval());
+}
+
 void OlaServerServiceImpl::AddUniverse(
     const Universe * universe,
     ola::proto::UniverseInfoReply *universe_info_reply) const {
@@ -363,6 +490,9 @@ void OlaServerServiceImpl::AddUniverse(
   universe_info->set_input_port_count(universe->InputPortCount());
   universe_info->set_output_port_count(universe->OutputPortCount());
   universe_info->set_rdm_devices(universe->UIDCount());
+  if (universe->SyncGroup()) {
+    universe_info->set_sync_group(universe->SyncGroup());
+  }
 
   std::vector<InputPort*> input_ports;
   std::vector<InputPort*>::const_iterator input_it;
@@ -721,37 +851,8 @@ void OlaServerServiceImpl::RDMCommand(
   }
 
   Client *client = GetClient(controller);
-  UID source_uid = client->GetUID();
-
-  UID destination(request->uid().esta_id(),
-                  request->uid().device_id());
-
-  RDMRequest::OverrideOptions options = RDMRequestOptionsFromProto(*request);
-
-  ola::rdm::RDMRequest *rdm_request = NULL;
-  if (request->is_set()) {
-    rdm_request = new ola::rdm::RDMSetRequest(
-        source_uid,
-        destination,
-        universe->GetRDMTransactionNumber(),
-        1,  // port id
-        request->sub_device(),
-        request->param_id(),
-        reinterpret_cast<const uint8_t*>(request->data().data()),
-        request->data().size(),
-        options);
-  } else {
-    rdm_request = new ola::rdm::RDMGetRequest(
-        source_uid,
-        destination,
-        universe->GetRDMTransactionNumber(),
-        1,  // port id
-        request->sub_device(),
-        request->param_id(),
-        reinterpret_cast<const uint8_t*>(request->data().data()),
-        request->data().size(),
-        options);
-  }
+  ola::rdm::RDMRequest *rdm_request = BuildRDMRequest(client->GetUID(),
+                                                      universe, *request);
 
   ola::rdm::RDMCallback *callback =
     NewSingleCallback(
@@ -806,6 +907,122 @@ void OlaServerServiceImpl::RDMDiscoveryCommand(
   m_broker->SendRDMRequest(client, universe, rdm_request, callback);
 }
 
+void OlaServerServiceImpl::RDMBulkGet(
+    RpcController* controller,
+    const ola::proto::RDMBulkGetRequest* request,
+    ola::proto::RDMBulkGetReply* response,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  Universe *universe = m_universe_store->GetUniverse(request->universe());
+  if (!universe) {
+    MissingUniverseError(controller);
+    done->Run();
+    return;
+  }
+
+  UIDSet uids;
+  if (request->uid_size()) {
+    for (int i = 0; i < request->uid_size(); i++) {
+      uids.AddUID(UID(request->uid(i).esta_id(), request->uid(i).device_id()));
+    }
+  } else {
+    universe->GetUIDs(&uids);
+  }
+
+  Client *client = GetClient(controller);
+  BulkGetState *state = new BulkGetState(client, done);
+  state->universe_id = request->universe();
+  state->sub_device = request->sub_device();
+  state->include_raw_response = request->include_raw_response();
+  state->stream = request->has_stream_id();
+  response->set_universe(request->universe());
+
+  const unsigned int total = uids.Size() * request->param_id_size();
+  const unsigned int start = std::min(request->offset(), total);
+  const unsigned int end = std::min(start + MAX_BULK_GET_RESULTS, total);
+  response->set_total(total);
+
+  StaticPidResponses *cache = NULL;
+  if (state->sub_device == ola::rdm::ROOT_RDM_DEVICE &&
+      !state->include_raw_response) {
+    cache = GetStaticPidResponses(universe);
+  }
+
+  // The results are returned in UID, then PID order.
+  UIDSet::Iterator iter = uids.Begin();
+  if (start < end) {
+    std::advance(iter, start / request->param_id_size());
+  }
+  for (unsigned int index = start; index < end; ++index) {
+    const unsigned int pid_index = index % request->param_id_size();
+    if (index != start && pid_index == 0) {
+      ++iter;
+    }
+    uint16_t pid = request->param_id(pid_index);
+    ola::proto::RDMBulkGetResult *result;
+    if (state->stream) {
+      result = new ola::proto::RDMBulkGetResult();
+      result->set_stream_id(request->stream_id());
+    } else {
+      result = response->add_result();
+    }
+    SetProtoUID(*iter, result->mutable_uid());
+    result->set_param_id(pid);
+
+    const ola::proto::RDMResponse *cached_response = NULL;
+    if (cache) {
+      cached_response = STLFind(cache, StaticPidKey(*iter, pid));
+    }
+
+    if (cached_response) {
+      result->mutable_response()->CopyFrom(*cached_response);
+      result->set_cached(true);
+      CompleteBulkGetResult(state, result);
+    } else {
+      state->Queue(
+          state->universe_id,
+          new ola::rdm::RDMGetRequest(
+              client->GetUID(), *iter, universe->GetRDMTransactionNumber(),
+              1,  // port id
+              state->sub_device, pid, NULL, 0),
+          NewSingleCallback(this, &OlaServerServiceImpl::HandleBulkGetResponse,
+                            state, result));
+    }
+  }
+  SendFanOutRequests(state);
+}
+
+void OlaServerServiceImpl::RDMBatch(
+    RpcController* controller,
+    const ola::proto::RDMBatchRequest* request,
+    ola::proto::RDMBatchReply* response,
+    ola::rpc::RpcService::CompletionCallback* done) {
+  Client *client = GetClient(controller);
+  RDMFanOutState *state = new RDMFanOutState(
+      client, MAX_BATCH_COMMANDS_IN_FLIGHT, done);
+
+  // The request is only valid until this method returns, so the RDM requests
+  // are built now. The responses are added in request order, the RDM replies
+  // fill them in as they arrive.
+  for (int i = 0; i < request->request_size(); i++) {
+    const ola::proto::RDMRequest &rdm_request = request->request(i);
+    ola::proto::RDMResponse *rdm_response = response->add_response();
+
+    Universe *universe = m_universe_store->GetUniverse(
+        rdm_request.universe());
+    if (!universe) {
+      rdm_response->set_response_code(ola::proto::RDM_FAILED_TO_SEND);
+      continue;
+    }
+
+    state->Queue(
+        rdm_request.universe(),
+        BuildRDMRequest(client->GetUID(), universe, rdm_request),
+        NewSingleCallback(this, &OlaServerServiceImpl::PopulateRDMResponse,
+                          rdm_response, rdm_request.include_raw_response()));
+  }
+  SendFanOutRequests(state);
+}
+
 void OlaServerServiceImpl::SetSourceUID(
     RpcController *controller,
     const ola::proto::UID* request,
@@ -830,10 +1047,12 @@ void OlaServerServiceImpl::SendTimeCode(
       request->seconds(),
       request->frames());
 
-  if (time_code.IsValid()) {
-    m_device_manager->SendTimeCode(time_code);
-  } else {
+  if (!time_code.IsValid()) {
     controller->SetFailed("Invalid TimeCode");
+  } else if (m_timecode_engine) {
+    m_timecode_engine->HandleTimeCode(time_code);
+  } else {
+    m_device_manager->SendTimeCode(time_code);
   }
 }
 
@@ -850,6 +1069,17 @@ void OlaServerServiceImpl::HandleRDMResponse(
     bool include_raw_packets,
     ola::rdm::RDMReply *reply) {
   ClosureRunner runner(done);
+  PopulateRDMResponse(response, include_raw_packets, reply);
+}
+
+
+/*
+ * Copy a RDMReply into the protobuf RDMResponse.
+ */
+void OlaServerServiceImpl::PopulateRDMResponse(
+    ola::proto::RDMResponse* response,
+    bool include_raw_packets,
+    ola::rdm::RDMReply *reply) {
   response->set_response_code(
       static_cast<ola::proto::RDMResponseCode>(reply->StatusCode()));
 
@@ -918,6 +1148,210 @@ void OlaServerServiceImpl::HandleRDMResponse(
 }
 
 
+/*
+ * Get the cached static PID responses for a universe. The cache is cleared if
+ * discovery has run on the universe since the responses were cached, since
+ * responders may have been added, removed or replaced.
+ */
+OlaServerServiceImpl::StaticPidResponses*
+    OlaServerServiceImpl::GetStaticPidResponses(Universe *universe) {
+  UniversePidCache &cache = m_static_pid_cache[universe->UniverseId()];
+  if (cache.generation != universe->DiscoveryGeneration()) {
+    cache.responses.clear();
+    cache.generation = universe->DiscoveryGeneration();
+  }
+  return &cache.responses;
+}
+
+
+/*
+ * Add the response for a static PID to the cache.
+ */
+void OlaServerServiceImpl::CacheStaticPidResponse(
+    unsigned int universe_id,
+    const ola::proto::RDMBulkGetResult &result) {
+  const ola::proto::RDMResponse &response = result.response();
+  if (!IsStaticPid(result.param_id()) ||
+      response.response_code() != ola::proto::RDM_COMPLETED_OK ||
+      response.response_type() != ola::proto::RDM_ACK) {
+    return;
+  }
+
+  Universe *universe = m_universe_store->GetUniverse(universe_id);
+  if (!universe) {
+    return;
+  }
+
+  StaticPidResponses *responses = GetStaticPidResponses(universe);
+  if (responses->size() >= MAX_STATIC_PID_RESPONSES) {
+    OLA_INFO << "Static PID cache for universe " << universe_id
+             << " is full, clearing it";
+    responses->clear();
+  }
+
+  ola::proto::RDMResponse &cached_response = (*responses)[
+      StaticPidKey(UID(result.uid().esta_id(), result.uid().device_id()),
+                   result.param_id())];
+  cached_response.CopyFrom(response);
+  cached_response.clear_raw_frame();
+}
+
+
+/*
+ * Send the next requests for a RDMBulkGet or RDMBatch, and complete the RPC
+ * once all the responses have arrived.
+ */
+void OlaServerServiceImpl::SendFanOutRequests(RDMFanOutState *state) {
+  bool client_active = m_broker && m_broker->HasClient(state->client);
+  // The callbacks may run before SendRDMRequest returns.
+  state->sending = true;
+  while (client_active && !state->pending.empty() &&
+         state->in_flight < state->max_in_flight) {
+    RDMFanOutState::Command command = state->pending.front();
+    state->pending.pop();
+
+    Universe *universe = m_universe_store->GetUniverse(command.universe_id);
+    if (!universe) {
+      delete command.request;
+      ola::rdm::RDMReply reply(ola::rdm::RDM_FAILED_TO_SEND);
+      command.on_complete->Run(&reply);
+      continue;
+    }
+
+    state->in_flight++;
+    universe->SendRDMRequest(
+        command.request,
+        NewSingleCallback(this, &OlaServerServiceImpl::HandleFanOutResponse,
+                          state, command.on_complete));
+  }
+  state->sending = false;
+
+  if (state->in_flight) {
+    return;
+  }
+
+  if (client_active) {
+    state->done->Run();
+  } else {
+    OLA_DEBUG << "Client no longer exists, cleaning up from RDM requests";
+    // Fail the unsent commands, so their callbacks can free what they hold.
+    while (!state->pending.empty()) {
+      RDMFanOutState::Command command = state->pending.front();
+      state->pending.pop();
+      delete command.request;
+      ola::rdm::RDMReply reply(ola::rdm::RDM_FAILED_TO_SEND);
+      command.on_complete->Run(&reply);
+    }
+    delete state->done;
+  }
+  delete state;
+}
+
+
+/*
+ * Called when one of the requests for a RDMBulkGet or RDMBatch completes.
+ */
+void OlaServerServiceImpl::HandleFanOutResponse(
+    RDMFanOutState *state,
+    ola::rdm::RDMCallback *on_complete,
+    ola::rdm::RDMReply *reply) {
+  state->in_flight--;
+  on_complete->Run(reply);
+
+  if (!state->sending) {
+    SendFanOutRequests(state);
+  }
+}
+
+
+/*
+ * Called when one of the GETs for a RDMBulkGet completes.
+ */
+void OlaServerServiceImpl::HandleBulkGetResponse(
+    BulkGetState *state,
+    ola::proto::RDMBulkGetResult *result,
+    ola::rdm::RDMReply *reply) {
+  PopulateRDMResponse(result->mutable_response(), state->include_raw_response,
+                      reply);
+
+  if (state->sub_device == ola::rdm::ROOT_RDM_DEVICE) {
+    CacheStaticPidResponse(state->universe_id, *result);
+  }
+  CompleteBulkGetResult(state, result);
+}
+
+
+/*
+ * Called once a result for a RDMBulkGet is complete. If the client asked for
+ * the results to be streamed, this pushes it to the client. Otherwise it
+ * stays in the response.
+ */
+void OlaServerServiceImpl::CompleteBulkGetResult(
+    BulkGetState *state,
+    ola::proto::RDMBulkGetResult *result) {
+  if (!state->stream) {
+    return;
+  }
+  if (m_broker && m_broker->HasClient(state->client)) {
+    state->client->SendRDMBulkGetResult(*result);
+  }
+  delete result;
+}
+
+
+/*
+ * Build the RDMRequest for a RDMCommand RPC.
+ */
+ola::rdm::RDMRequest *OlaServerServiceImpl::BuildRDMRequest(
+    const UID &source_uid,
+    Universe *universe,
+    const ola::proto::RDMRequest &request) {
+  UID destination(request.uid().esta_id(), request.uid().device_id());
+  RDMRequest::OverrideOptions options = RDMRequestOptionsFromProto(request);
+
+  if (request.is_set()) {
+    return new ola::rdm::RDMSetRequest(
+        source_uid,
+        destination,
+        universe->GetRDMTransactionNumber(),
+        1,  // port id
+        request.sub_device(),
+        request.param_id(),
+        reinterpret_cast<const uint8_t*>(request.data().data()),
+        request.data().size(),
+        options);
+  } else {
+    return new ola::rdm::RDMGetRequest(
+        source_uid,
+        destination,
+        universe->GetRDMTransactionNumber(),
+        1,  // port id
+        request.sub_device(),
+        request.param_id(),
+        reinterpret_cast<const uint8_t*>(request.data().data()),
+        request.data().size(),
+        options);
+  }
+}
+
+
+/*
+ * PIDs whose values don't change for the lifetime of a responder.
+ */
+bool OlaServerServiceImpl::IsStaticPid(uint16_t pid) {
+  switch (pid) {
+    case ola::rdm::PID_DEVICE_MODEL_DESCRIPTION:
+    case ola::rdm::PID_MANUFACTURER_LABEL:
+    case ola::rdm::PID_SOFTWARE_VERSION_LABEL:
+    case ola::rdm::PID_BOOT_SOFTWARE_VERSION_ID:
+    case ola::rdm::PID_BOOT_SOFTWARE_VERSION_LABEL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+
 /**
  * Called when RDM discovery completes
  */
@@ -1027,6 +1461,7 @@ void OlaServerServiceImpl::PopulatePort(const PortClass &port,
   }
 
   port_info->set_supports_rdm(port.SupportsRDM());
+  PopulateFrameRate(port, port_info);
 }
 
 void OlaServerServiceImpl::SetProtoUID(const ola::rdm::UID &uid,
@@ -18,8 +18,11 @@
  * Copyright (C) 2005 Simon Newton
  */
 
+#include <map>
 #include <memory>
+#include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 #include "common/protocol/Ola.pb.h"
 #include "common/protocol/OlaService.pb.h"
@@ -56,6 +59,9 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
 
   /**
    * @brief Create a new OlaServerServiceImpl.
+   *
+   * If timecode_engine is NULL, timecode from clients is sent straight to the
+   * devices.
    */
   OlaServerServiceImpl(class UniverseStore *universe_store,
                        class DeviceManager *device_manager,
@@ -63,7 +69,8 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                        class PortManager *port_manager,
                        class ClientBroker *broker,
                        const class TimeStamp *wake_up_time,
-                       ReloadPluginsCallback *reload_plugins_callback);
+                       ReloadPluginsCallback *reload_plugins_callback,
+                       class TimeCodeEngine *timecode_engine = NULL);
 
   ~OlaServerServiceImpl() {}
 
@@ -116,6 +123,14 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                     ola::proto::Ack* response,
                     ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Set the sync group for a universe.
+   */
+  void SetSyncGroup(ola::rpc::RpcController* controller,
+                    const ola::proto::SyncGroupRequest* request,
+                    ola::proto::Ack* response,
+                    ola::rpc::RpcService::CompletionCallback* done);
+
   /**
    * @brief Patch a port to a universe.
    */
@@ -132,6 +147,14 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                        ola::proto::Ack* response,
                        ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Set the frame rate limits for an output port.
+   */
+  void SetPortFrameRate(ola::rpc::RpcController* controller,
+                        const ola::proto::PortFrameRateRequest* request,
+                        ola::proto::Ack* response,
+                        ola::rpc::RpcService::CompletionCallback* done);
+
   /**
    * @brief Returns information on the active universes.
    */
@@ -243,6 +266,40 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                            ola::proto::RDMResponse* response,
                            ola::rpc::RpcService::CompletionCallback* done);
 
+  /**
+   * @brief Fetch a list of PIDs from a set of responders.
+   *
+   * The individual GETs are sent from within olad, with up to
+   * MAX_BULK_GETS_IN_FLIGHT outstanding at once, which saves the client a
+   * round trip per UID per PID. Each reply holds at most
+   * MAX_BULK_GET_RESULTS results, starting from the offset in the request, so
+   * a reply never hits the RPC message size limit.
+   *
+   * If the request has a stream_id, each result is pushed to the client with
+   * StreamRDMBulkGetResult as soon as its GET completes, and the reply, which
+   * holds no results, is sent after the last of them.
+   *
+   * Responses to static PIDs, like the manufacturer label, are cached per
+   * responder and served from the cache on later requests. The cache for a
+   * universe is cleared when RDM discovery runs on it.
+   */
+  void RDMBulkGet(ola::rpc::RpcController* controller,
+                  const ::ola::proto::RDMBulkGetRequest* request,
+                  ola::proto::RDMBulkGetReply* response,
+                  ola::rpc::RpcService::CompletionCallback* done);
+
+  /**
+   * @brief Handle a batch of RDM Commands.
+   *
+   * The commands are sent in the order they appear in the request, with up
+   * to MAX_BATCH_COMMANDS_IN_FLIGHT outstanding at once. The reply contains
+   * one response per command, in the same order.
+   */
+  void RDMBatch(ola::rpc::RpcController* controller,
+                const ::ola::proto::RDMBatchRequest* request,
+                ola::proto::RDMBatchReply* response,
+                ola::rpc::RpcService::CompletionCallback* done);
+
   /**
    * @brief Set this client's source UID.
    */
@@ -260,10 +317,43 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
                     ola::rpc::RpcService::CompletionCallback* done);
 
  private:
+  struct RDMFanOutState;
+  struct BulkGetState;
+  typedef std::pair<ola::rdm::UID, uint16_t> StaticPidKey;
+  typedef std::map<StaticPidKey, ola::proto::RDMResponse> StaticPidResponses;
+
+  // The cached static PID responses for a universe.
+  struct UniversePidCache {
+    // The Universe::DiscoveryGeneration() the responses are valid for.
+    unsigned int generation;
+    StaticPidResponses responses;
+
+    UniversePidCache() : generation(0) {}
+  };
+  typedef std::map<unsigned int, UniversePidCache> StaticPidCache;
+
   void HandleRDMResponse(ola::proto::RDMResponse* response,
                          ola::rpc::RpcService::CompletionCallback* done,
                          bool include_raw_packets,
                          ola::rdm::RDMReply *reply);
+  void PopulateRDMResponse(ola::proto::RDMResponse* response,
+                           bool include_raw_packets,
+                           ola::rdm::RDMReply *reply);
+  ola::rdm::RDMRequest *BuildRDMRequest(const ola::rdm::UID &source_uid,
+                                        Universe *universe,
+                                        const ola::proto::RDMRequest &request);
+  StaticPidResponses *GetStaticPidResponses(Universe *universe);
+  void CacheStaticPidResponse(unsigned int universe_id,
+                              const ola::proto::RDMBulkGetResult &result);
+  void SendFanOutRequests(RDMFanOutState *state);
+  void HandleFanOutResponse(RDMFanOutState *state,
+                            ola::rdm::RDMCallback *on_complete,
+                            ola::rdm::RDMReply *reply);
+  void HandleBulkGetResponse(BulkGetState *state,
+                             ola::proto::RDMBulkGetResult *result,
+                             ola::rdm::RDMReply *reply);
+  void CompleteBulkGetResult(BulkGetState *state,
+                             ola::proto::RDMBulkGetResult *result);
   void RDMDiscoveryComplete(unsigned int universe,
                             ola::rpc::RpcService::CompletionCallback* done,
                             ola::proto::UIDListReply *response,
@@ -297,6 +387,15 @@ class OlaServerServiceImpl : public ola::proto::OlaServerService {
   class ClientBroker *m_broker;
   const class TimeStamp *m_wake_up_time;
   std::auto_ptr<ReloadPluginsCallback> m_reload_plugins_callback;
+  class TimeCodeEngine *m_timecode_engine;
+  StaticPidCache m_static_pid_cache;
+
+  static bool IsStaticPid(uint16_t pid);
+
+  static const unsigned int MAX_BULK_GETS_IN_FLIGHT = 8;
+  static const unsigned int MAX_BULK_GET_RESULTS = 256;
+  static const unsigned int MAX_STATIC_PID_RESPONSES = 4096;
+  static const unsigned int MAX_BATCH_COMMANDS_IN_FLIGHT = 8;
 };
 }  // namespace ola
 #endif  // OLAD_OLASERVERSERVICEIMPL_H_
@@ -24,6 +24,7 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <string>
+#include <vector>
 
 #include "common/rpc/RpcController.h"
 #include "common/rpc/RpcSession.h"
@@ -33,25 +34,57 @@
 #include "ola/DmxBuffer.h"
 #include "ola/ExportMap.h"
 #include "ola/Logging.h"
+#include "ola/rdm/RDMCommand.h"
+#include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/RDMReply.h"
 #include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
+#include "ola/strings/Format.h"
 #include "ola/testing/TestUtils.h"
+#include "olad/ClientBroker.h"
 #include "olad/OlaServerServiceImpl.h"
 #include "olad/PluginLoader.h"
 #include "olad/Universe.h"
 #include "olad/plugin_api/Client.h"
 #include "olad/plugin_api/DeviceManager.h"
+#include "olad/plugin_api/TestCommon.h"
 #include "olad/plugin_api/UniverseStore.h"
 
 using ola::Client;
+using ola::ClientBroker;
+using ola::DeviceManager;
+using ola::NewCallback;
 using ola::NewSingleCallback;
 using ola::SingleUseCallback0;
 using ola::DmxBuffer;
 using ola::OlaServerServiceImpl;
 using ola::Universe;
 using ola::UniverseStore;
+using ola::rdm::RDMReply;
+using ola::rdm::RDMRequest;
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
 using ola::rpc::RpcController;
 using ola::rpc::RpcSession;
 using std::string;
+using std::vector;
+
+/*
+ * A Client that records the RDMBulkGet results streamed to it.
+ */
+class StreamingClient: public Client {
+ public:
+    explicit StreamingClient(const UID &uid)
+        : Client(NULL, uid) {
+    }
+
+    bool SendRDMBulkGetResult(const ola::proto::RDMBulkGetResult &result) {
+      results.push_back(result);
+      return true;
+    }
+
+    vector<ola::proto::RDMBulkGetResult> results;
+};
 
 class OlaServerServiceImplTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(OlaServerServiceImplTest);
@@ -60,11 +93,17 @@ class OlaServerServiceImplTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testUpdateDmxData);
   CPPUNIT_TEST(testSetUniverseName);
   CPPUNIT_TEST(testSetMergeMode);
+  CPPUNIT_TEST(testRDMBulkGet);
+  CPPUNIT_TEST(testRDMBulkGetChunks);
+  CPPUNIT_TEST(testRDMBulkGetStream);
+  CPPUNIT_TEST(testRDMBatch);
+  CPPUNIT_TEST(testSetPortFrameRate);
   CPPUNIT_TEST_SUITE_END();
 
  public:
     OlaServerServiceImplTest():
-      m_uid(ola::OPEN_LIGHTING_ESTA_CODE, 0) {
+      m_uid(ola::OPEN_LIGHTING_ESTA_CODE, 0),
+      m_rdm_requests(0) {
     }
 
     void setUp() {
@@ -76,10 +115,19 @@ class OlaServerServiceImplTest: public CppUnit::TestFixture {
     void testUpdateDmxData();
     void testSetUniverseName();
     void testSetMergeMode();
+    void testRDMBulkGet();
+    void testRDMBulkGetChunks();
+    void testRDMBulkGetStream();
+    void testRDMBatch();
+    void testSetPortFrameRate();
 
  private:
     ola::rdm::UID m_uid;
     ola::Clock m_clock;
+    unsigned int m_rdm_requests;
+
+    void AckRDMRequest(const RDMRequest *request,
+                       ola::rdm::RDMCallback *callback);
 
     void CallGetDmx(OlaServerServiceImpl *service,
                     int universe_id,
@@ -101,12 +149,36 @@ class OlaServerServiceImplTest: public CppUnit::TestFixture {
                           int universe_id,
                           ola::proto::MergeMode merge_mode,
                           class SetMergeModeCheck *check);
+    void CallRDMBulkGet(OlaServerServiceImpl *service,
+                        Client *client,
+                        int universe_id,
+                        ola::proto::RDMBulkGetReply *response,
+                        unsigned int offset = 0,
+                        bool stream = false);
+
+    static const uint32_t STREAM_ID;
+    bool CallSetPortFrameRate(OlaServerServiceImpl *service,
+                              unsigned int device_alias,
+                              unsigned int port_id,
+                              int max_frame_rate,
+                              int refresh_interval);
+    void AddRDMRequest(ola::proto::RDMBatchRequest *batch,
+                       int universe_id,
+                       uint32_t device_id,
+                       uint16_t pid,
+                       bool is_set);
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(OlaServerServiceImplTest);
 
+const uint32_t OlaServerServiceImplTest::STREAM_ID = 42;
+
 static const uint8_t SAMPLE_DMX_DATA[] = {1, 2, 3, 4, 5};
 
+static void SetBool(bool *value) {
+  *value = true;
+}
+
 /*
  * The GetDmx Checks
  */
@@ -535,3 +607,407 @@ void OlaServerServiceImplTest::CallSetMergeMode(
   request.set_merge_mode(merge_mode);
   service->SetMergeMode(&controller, &request, &response, closure);
 }
+
+
+/*
+ * Check the RDMBulkGet method works
+ */
+void OlaServerServiceImplTest::testRDMBulkGet() {
+  UniverseStore store(NULL, NULL);
+  ClientBroker broker;
+  Client client(NULL, m_uid);
+  broker.AddClient(&client);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, &broker, NULL, NULL);
+  unsigned int universe_id = 1;
+
+  ola::proto::RDMBulkGetReply missing_universe_reply;
+  CallRDMBulkGet(&service, &client, universe_id, &missing_universe_reply);
+  OLA_ASSERT_EQ(0, missing_universe_reply.result_size());
+
+  // setup a port with three responders
+  UIDSet uids;
+  uids.AddUID(UID(0x7a70, 1));
+  uids.AddUID(UID(0x7a70, 2));
+  uids.AddUID(UID(0x7a70, 3));
+  Universe *universe = store.GetUniverseOrCreate(universe_id);
+  TestMockRDMOutputPort port(
+      NULL, 1, &uids, true,
+      NewCallback(this, &OlaServerServiceImplTest::AckRDMRequest));
+  universe->AddPort(&port);
+  port.SetUniverse(universe);
+  OLA_ASSERT_EQ(3u, universe->UIDCount());
+
+  ola::proto::RDMBulkGetReply reply;
+  CallRDMBulkGet(&service, &client, universe_id, &reply);
+  OLA_ASSERT_EQ(6u, m_rdm_requests);
+  OLA_ASSERT_EQ(static_cast<int>(universe_id), reply.universe());
+  OLA_ASSERT_EQ(6, reply.result_size());
+  for (int i = 0; i < reply.result_size(); i++) {
+    const ola::proto::RDMBulkGetResult &result = reply.result(i);
+    OLA_ASSERT_EQ(static_cast<int>(i % 2 ? ola::rdm::PID_DMX_START_ADDRESS :
+                                   ola::rdm::PID_MANUFACTURER_LABEL),
+                  result.param_id());
+    OLA_ASSERT_EQ(static_cast<uint32_t>(1 + i / 2), result.uid().device_id());
+    OLA_ASSERT_EQ(ola::proto::RDM_COMPLETED_OK,
+                  result.response().response_code());
+    OLA_ASSERT_EQ(ola::strings::IntToString(result.param_id()),
+                  result.response().data());
+    OLA_ASSERT_FALSE(result.cached());
+  }
+
+  // the manufacturer label is static, so it should now be cached
+  m_rdm_requests = 0;
+  reply.Clear();
+  CallRDMBulkGet(&service, &client, universe_id, &reply);
+  OLA_ASSERT_EQ(3u, m_rdm_requests);
+  OLA_ASSERT_EQ(6, reply.result_size());
+  for (int i = 0; i < reply.result_size(); i++) {
+    const ola::proto::RDMBulkGetResult &result = reply.result(i);
+    OLA_ASSERT_EQ(ola::proto::RDM_COMPLETED_OK,
+                  result.response().response_code());
+    OLA_ASSERT_EQ(ola::strings::IntToString(result.param_id()),
+                  result.response().data());
+    OLA_ASSERT_EQ(i % 2 == 0, result.cached());
+  }
+
+  // Running discovery clears the cache
+  universe->NewUIDList(&port, uids);
+  m_rdm_requests = 0;
+  reply.Clear();
+  CallRDMBulkGet(&service, &client, universe_id, &reply);
+  OLA_ASSERT_EQ(6u, m_rdm_requests);
+  OLA_ASSERT_EQ(6, reply.result_size());
+  for (int i = 0; i < reply.result_size(); i++) {
+    OLA_ASSERT_FALSE(reply.result(i).cached());
+  }
+
+  universe->RemovePort(&port);
+}
+
+
+/*
+ * Check that large RDMBulkGets are returned in chunks.
+ */
+void OlaServerServiceImplTest::testRDMBulkGetChunks() {
+  UniverseStore store(NULL, NULL);
+  ClientBroker broker;
+  Client client(NULL, m_uid);
+  broker.AddClient(&client);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, &broker, NULL, NULL);
+  unsigned int universe_id = 1;
+
+  // 200 responders and 2 PIDs is more results than fit in one reply.
+  UIDSet uids;
+  for (unsigned int i = 1; i <= 200; i++) {
+    uids.AddUID(UID(0x7a70, i));
+  }
+  Universe *universe = store.GetUniverseOrCreate(universe_id);
+  TestMockRDMOutputPort port(
+      NULL, 1, &uids, true,
+      NewCallback(this, &OlaServerServiceImplTest::AckRDMRequest));
+  universe->AddPort(&port);
+  port.SetUniverse(universe);
+  OLA_ASSERT_EQ(200u, universe->UIDCount());
+
+  ola::proto::RDMBulkGetReply reply;
+  CallRDMBulkGet(&service, &client, universe_id, &reply);
+  OLA_ASSERT_EQ(400u, reply.total());
+  OLA_ASSERT_EQ(256, reply.result_size());
+  OLA_ASSERT_EQ(256u, m_rdm_requests);
+  OLA_ASSERT_EQ(1u, reply.result(0).uid().device_id());
+  OLA_ASSERT_EQ(128u, reply.result(255).uid().device_id());
+  OLA_ASSERT_EQ(static_cast<int>(ola::rdm::PID_DMX_START_ADDRESS),
+                reply.result(255).param_id());
+
+  // The rest of the results
+  reply.Clear();
+  CallRDMBulkGet(&service, &client, universe_id, &reply, 256);
+  OLA_ASSERT_EQ(400u, reply.total());
+  OLA_ASSERT_EQ(144, reply.result_size());
+  for (int i = 0; i < reply.result_size(); i++) {
+    const ola::proto::RDMBulkGetResult &result = reply.result(i);
+    OLA_ASSERT_EQ(static_cast<uint32_t>(129 + i / 2),
+                  result.uid().device_id());
+    OLA_ASSERT_EQ(static_cast<int>(i % 2 ? ola::rdm::PID_DMX_START_ADDRESS :
+                                   ola::rdm::PID_MANUFACTURER_LABEL),
+                  result.param_id());
+    OLA_ASSERT_EQ(ola::proto::RDM_COMPLETED_OK,
+                  result.response().response_code());
+  }
+
+  // An offset past the end returns no results
+  reply.Clear();
+  CallRDMBulkGet(&service, &client, universe_id, &reply, 400);
+  OLA_ASSERT_EQ(400u, reply.total());
+  OLA_ASSERT_EQ(0, reply.result_size());
+
+  universe->RemovePort(&port);
+}
+
+
+/*
+ * Check that RDMBulkGet results can be streamed to the client.
+ */
+void OlaServerServiceImplTest::testRDMBulkGetStream() {
+  UniverseStore store(NULL, NULL);
+  ClientBroker broker;
+  StreamingClient client(m_uid);
+  broker.AddClient(&client);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, &broker, NULL, NULL);
+  unsigned int universe_id = 1;
+
+  UIDSet uids;
+  uids.AddUID(UID(0x7a70, 1));
+  uids.AddUID(UID(0x7a70, 2));
+  uids.AddUID(UID(0x7a70, 3));
+  Universe *universe = store.GetUniverseOrCreate(universe_id);
+  TestMockRDMOutputPort port(
+      NULL, 1, &uids, true,
+      NewCallback(this, &OlaServerServiceImplTest::AckRDMRequest));
+  universe->AddPort(&port);
+  port.SetUniverse(universe);
+
+  // The results are streamed, the reply only has the total.
+  ola::proto::RDMBulkGetReply reply;
+  CallRDMBulkGet(&service, &client, universe_id, &reply, 0, true);
+  OLA_ASSERT_EQ(6u, m_rdm_requests);
+  OLA_ASSERT_EQ(6u, reply.total());
+  OLA_ASSERT_EQ(0, reply.result_size());
+  OLA_ASSERT_EQ(static_cast<size_t>(6), client.results.size());
+  for (unsigned int i = 0; i < client.results.size(); i++) {
+    const ola::proto::RDMBulkGetResult &result = client.results[i];
+    OLA_ASSERT_EQ(STREAM_ID, result.stream_id());
+    OLA_ASSERT_EQ(static_cast<int>(i % 2 ? ola::rdm::PID_DMX_START_ADDRESS :
+                                   ola::rdm::PID_MANUFACTURER_LABEL),
+                  result.param_id());
+    OLA_ASSERT_EQ(static_cast<uint32_t>(1 + i / 2), result.uid().device_id());
+    OLA_ASSERT_EQ(ola::proto::RDM_COMPLETED_OK,
+                  result.response().response_code());
+    OLA_ASSERT_FALSE(result.cached());
+  }
+
+  // Cached results are streamed as well
+  m_rdm_requests = 0;
+  client.results.clear();
+  reply.Clear();
+  CallRDMBulkGet(&service, &client, universe_id, &reply, 0, true);
+  OLA_ASSERT_EQ(3u, m_rdm_requests);
+  OLA_ASSERT_EQ(0, reply.result_size());
+  OLA_ASSERT_EQ(static_cast<size_t>(6), client.results.size());
+  unsigned int cached = 0;
+  for (unsigned int i = 0; i < client.results.size(); i++) {
+    OLA_ASSERT_EQ(ola::strings::IntToString(client.results[i].param_id()),
+                  client.results[i].response().data());
+    cached += client.results[i].cached();
+  }
+  OLA_ASSERT_EQ(3u, cached);
+
+  universe->RemovePort(&port);
+}
+
+
+/*
+ * Check the RDMBatch method works
+ */
+void OlaServerServiceImplTest::testRDMBatch() {
+  UniverseStore store(NULL, NULL);
+  ClientBroker broker;
+  Client client(NULL, m_uid);
+  broker.AddClient(&client);
+  OlaServerServiceImpl service(&store, NULL, NULL, NULL, &broker, NULL, NULL);
+  unsigned int universe_id = 1;
+
+  UIDSet uids;
+  uids.AddUID(UID(0x7a70, 1));
+  uids.AddUID(UID(0x7a70, 2));
+  Universe *universe = store.GetUniverseOrCreate(universe_id);
+  TestMockRDMOutputPort port(
+      NULL, 1, &uids, true,
+      NewCallback(this, &OlaServerServiceImplTest::AckRDMRequest));
+  universe->AddPort(&port);
+  port.SetUniverse(universe);
+
+  // More commands than can be in flight at once, and one for a universe that
+  // doesn't exist.
+  ola::proto::RDMBatchRequest request;
+  for (unsigned int i = 0; i < 20; i++) {
+    AddRDMRequest(&request, universe_id, 1 + i % 2,
+                  ola::rdm::PID_DMX_START_ADDRESS + i, i % 3 == 0);
+  }
+  AddRDMRequest(&request, universe_id + 1, 1,
+                ola::rdm::PID_DMX_START_ADDRESS, false);
+
+  RpcSession session(NULL);
+  session.SetData(&client);
+  RpcController controller(&session);
+  ola::proto::RDMBatchReply reply;
+  bool done = false;
+  service.RDMBatch(&controller, &request, &reply,
+                   NewSingleCallback(&SetBool, &done));
+  OLA_ASSERT_TRUE(done);
+  OLA_ASSERT_FALSE(controller.Failed());
+  OLA_ASSERT_EQ(20u, m_rdm_requests);
+  OLA_ASSERT_EQ(21, reply.response_size());
+
+  for (int i = 0; i < 20; i++) {
+    const ola::proto::RDMResponse &response = reply.response(i);
+    OLA_ASSERT_EQ(ola::proto::RDM_COMPLETED_OK, response.response_code());
+    OLA_ASSERT_EQ(static_cast<uint32_t>(1 + i % 2),
+                  response.source_uid().device_id());
+    OLA_ASSERT_EQ(static_cast<uint32_t>(ola::rdm::PID_DMX_START_ADDRESS + i),
+                  response.param_id());
+    OLA_ASSERT_EQ(i % 3 == 0 ? ola::proto::RDM_SET_RESPONSE :
+                               ola::proto::RDM_GET_RESPONSE,
+                  response.command_class());
+    OLA_ASSERT_EQ(ola::strings::IntToString(response.param_id()),
+                  response.data());
+  }
+  OLA_ASSERT_EQ(ola::proto::RDM_FAILED_TO_SEND,
+                reply.response(20).response_code());
+
+  // An empty batch completes straight away
+  request.Clear();
+  reply.Clear();
+  done = false;
+  service.RDMBatch(&controller, &request, &reply,
+                   NewSingleCallback(&SetBool, &done));
+  OLA_ASSERT_TRUE(done);
+  OLA_ASSERT_EQ(0, reply.response_size());
+
+  universe->RemovePort(&port);
+}
+
+
+/*
+ * Ack a RDM request, the param data is the PID as a string.
+ */
+void OlaServerServiceImplTest::AckRDMRequest(
+    const RDMRequest *request,
+    ola::rdm::RDMCallback *callback) {
+  m_rdm_requests++;
+  const string data = ola::strings::IntToString(request->ParamId());
+  ola::rdm::RDMResponse *response = ola::rdm::GetResponseFromData(
+      request, reinterpret_cast<const uint8_t*>(data.data()), data.size());
+  delete request;
+  RDMReply reply(ola::rdm::RDM_COMPLETED_OK, response);
+  callback->Run(&reply);
+}
+
+
+/*
+ * Call the RDMBulkGet method for the manufacturer label and DMX start address
+ * of every responder in a universe.
+ */
+void OlaServerServiceImplTest::CallRDMBulkGet(
+    OlaServerServiceImpl *service,
+    Client *client,
+    int universe_id,
+    ola::proto::RDMBulkGetReply *response,
+    unsigned int offset,
+    bool stream) {
+  RpcSession session(NULL);
+  session.SetData(client);
+  RpcController controller(&session);
+  ola::proto::RDMBulkGetRequest request;
+  bool done = false;
+
+  request.set_universe(universe_id);
+  request.add_param_id(ola::rdm::PID_MANUFACTURER_LABEL);
+  request.add_param_id(ola::rdm::PID_DMX_START_ADDRESS);
+  request.set_offset(offset);
+  if (stream) {
+    request.set_stream_id(STREAM_ID);
+  }
+  service->RDMBulkGet(
+      &controller, &request, response,
+      NewSingleCallback(&SetBool, &done));
+  OLA_ASSERT_TRUE(done);
+}
+
+
+/*
+ * Add a RDM command to a batch.
+ */
+void OlaServerServiceImplTest::AddRDMRequest(
+    ola::proto::RDMBatchRequest *batch,
+    int universe_id,
+    uint32_t device_id,
+    uint16_t pid,
+    bool is_set) {
+  ola::proto::RDMRequest *request = batch->add_request();
+  request->set_universe(universe_id);
+  request->mutable_uid()->set_esta_id(0x7a70);
+  request->mutable_uid()->set_device_id(device_id);
+  request->set_sub_device(ola::rdm::ROOT_RDM_DEVICE);
+  request->set_param_id(pid);
+  request->set_data("");
+  request->set_is_set(is_set);
+}
+
+
+/*
+ * Check the SetPortFrameRate method works
+ */
+void OlaServerServiceImplTest::testSetPortFrameRate() {
+  UniverseStore store(NULL, NULL);
+  DeviceManager device_manager(NULL, NULL);
+  OlaServerServiceImpl service(&store, &device_manager, NULL, NULL, NULL,
+                               NULL, NULL);
+
+  TestMockPlugin plugin(NULL, ola::OLA_PLUGIN_ARTNET);
+  MockDevice device(&plugin, "test device");
+  TestMockOutputPort output_port(&device, 1);
+  TestMockInputPort input_port(&device, 2, NULL);
+  device.AddPort(&output_port);
+  device.AddPort(&input_port);
+  OLA_ASSERT_TRUE(device_manager.RegisterDevice(&device));
+  const unsigned int device_alias = device_manager.GetDevice(
+      device.UniqueId()).alias;
+
+  // missing device & ports
+  OLA_ASSERT_FALSE(CallSetPortFrameRate(&service, device_alias + 1, 1, 10, 0));
+  OLA_ASSERT_FALSE(CallSetPortFrameRate(&service, device_alias, 3, 10, 0));
+  OLA_ASSERT_FALSE(CallSetPortFrameRate(&service, device_alias, 2, 10, 0));
+
+  // invalid values
+  OLA_ASSERT_FALSE(CallSetPortFrameRate(&service, device_alias, 1, -1, 0));
+  OLA_ASSERT_FALSE(CallSetPortFrameRate(&service, device_alias, 1, 10, -1));
+  OLA_ASSERT_EQ(0u, output_port.MaxFrameRate());
+  OLA_ASSERT_EQ(0u, output_port.RefreshInterval());
+
+  OLA_ASSERT_TRUE(CallSetPortFrameRate(&service, device_alias, 1, 25, 1000));
+  OLA_ASSERT_EQ(25u, output_port.MaxFrameRate());
+  OLA_ASSERT_EQ(1000u, output_port.RefreshInterval());
+
+  // clear the limits
+  OLA_ASSERT_TRUE(CallSetPortFrameRate(&service, device_alias, 1, 0, 0));
+  OLA_ASSERT_EQ(0u, output_port.MaxFrameRate());
+  OLA_ASSERT_EQ(0u, output_port.RefreshInterval());
+
+  device_manager.UnregisterAllDevices();
+}
+
+/*
+ * Call SetPortFrameRate and return true if the request succeeded.
+ */
+bool OlaServerServiceImplTest::CallSetPortFrameRate(
+    OlaServerServiceImpl *service,
+    unsigned int device_alias,
+    unsigned int port_id,
+    int max_frame_rate,
+    int refresh_interval) {
+  RpcSession session(NULL);
+  RpcController controller(&session);
+  ola::proto::PortFrameRateRequest request;
+  ola::proto::Ack response;
+  bool done = false;
+
+  request.set_device_alias(device_alias);
+  request.set_port_id(port_id);
+  request.set_max_frame_rate(max_frame_rate);
+  request.set_refresh_interval(refresh_interval);
+  service->SetPortFrameRate(&controller, &request, &response,
+                            NewSingleCallback(&SetBool, &done));
+  OLA_ASSERT_TRUE(done);
+  return !controller.Failed();
+}
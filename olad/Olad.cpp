@@ -94,7 +94,9 @@ int main(int argc, char *argv[]) {
   ola::SetHelpString("[options]", "Start the OLA Daemon.");
   ola::ParseFlags(&argc, argv);
 
-  ola::InitLoggingFromFlags();
+  // The --async-log writer thread is started once we've forked and blocked
+  // the signals, until then messages are buffered.
+  ola::InitLoggingFromFlags(false);
   OLA_INFO << "OLA Daemon version " << ola::base::Version::GetVersion();
 
   #ifndef OLAD_SKIP_ROOT_CHECK
@@ -113,6 +115,7 @@ int main(int argc, char *argv[]) {
 
   ola::ExportMap export_map;
   if (!ola::ServerInit(original_argc, original_argv, &export_map)) {
+    ola::FlushLogging();
     return ola::EXIT_UNAVAILABLE;
   }
 
@@ -128,6 +131,7 @@ int main(int argc, char *argv[]) {
   signal_thread.InstallSignalHandler(
       SIGUSR1, ola::NewCallback(&ola::IncrementLogLevel));
 #endif  // _WIN32
+  ola::StartAsyncLogging();
 
   ola::OlaServer::Options options;
   options.http_enable = FLAGS_http;
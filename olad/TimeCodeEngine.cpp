@@ -0,0 +1,385 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TimeCodeEngine.cpp
+ * Generates, chases and distributes timecode inside olad.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <stdint.h>
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/Logging.h"
+#include "ola/timecode/TimeCode.h"
+#include "ola/timecode/TimeCodeEnums.h"
+#include "olad/TimeCodeEngine.h"
+
+namespace ola {
+
+using ola::thread::INVALID_TIMEOUT;
+using ola::timecode::TimeCode;
+using ola::timecode::TimeCodeType;
+using std::string;
+
+const char TimeCodeEngine::MODE_VAR[] = "timecode-mode";
+const char TimeCodeEngine::FRAMES_SENT_VAR[] = "timecode-frames-sent";
+const char TimeCodeEngine::FRAMES_SLIPPED_VAR[] = "timecode-frames-slipped";
+const char TimeCodeEngine::RESYNCS_VAR[] = "timecode-resyncs";
+const char TimeCodeEngine::DRIFT_VAR[] = "timecode-drift-us";
+const char TimeCodeEngine::LATENCY_VAR[] = "timecode-latency-us";
+const char TimeCodeEngine::MAX_LATENCY_VAR[] = "timecode-max-latency-us";
+const char TimeCodeEngine::OUTPUTS_VAR[] = "timecode-outputs";
+
+TimeCodeEngine::TimeCodeEngine(ola::thread::SchedulerInterface *scheduler,
+                               const Clock *clock,
+                               SendCallback *send_callback,
+                               ExportMap *export_map,
+                               const Options &options)
+    : m_scheduler(scheduler),
+      m_clock(clock),
+      m_send_callback(send_callback),
+      m_options(options),
+      m_mode(FORWARD),
+      m_timeout_id(INVALID_TIMEOUT),
+      m_type(ola::timecode::TIMECODE_SMPTE),
+      m_reference_frame(0),
+      m_next_frame(0),
+      m_running(false),
+      m_last_input_frame(0),
+      m_frames_sent(0),
+      m_frames_slipped(0),
+      m_resyncs(0),
+      m_drift(0),
+      m_window_frames(0),
+      m_window_latency(0),
+      m_window_max_latency(0),
+      m_latency(0),
+      m_max_latency(0),
+      m_mode_var(NULL),
+      m_frames_sent_var(NULL),
+      m_frames_slipped_var(NULL),
+      m_resyncs_var(NULL),
+      m_drift_var(NULL),
+      m_latency_var(NULL),
+      m_max_latency_var(NULL),
+      m_outputs_var(NULL) {
+  if (export_map) {
+    m_mode_var = export_map->GetStringVar(MODE_VAR);
+    m_frames_sent_var = export_map->GetCounterVar(FRAMES_SENT_VAR);
+    m_frames_slipped_var = export_map->GetCounterVar(FRAMES_SLIPPED_VAR);
+    m_resyncs_var = export_map->GetCounterVar(RESYNCS_VAR);
+    m_drift_var = export_map->GetIntegerVar(DRIFT_VAR);
+    m_latency_var = export_map->GetIntegerVar(LATENCY_VAR);
+    m_max_latency_var = export_map->GetIntegerVar(MAX_LATENCY_VAR);
+    m_outputs_var = export_map->GetIntegerVar(OUTPUTS_VAR);
+    m_mode_var->Set(ModeToString(m_mode));
+  }
+}
+
+
+TimeCodeEngine::~TimeCodeEngine() {
+  Stop();
+}
+
+
+void TimeCodeEngine::Forward() {
+  SetMode(FORWARD);
+}
+
+
+bool TimeCodeEngine::Generate(const TimeCode &start) {
+  if (!start.IsValid()) {
+    return false;
+  }
+
+  SetMode(GENERATE);
+  TimeStamp now;
+  m_clock->CurrentMonotonicTime(&now);
+  Start(start.Type(), start.FrameCount(), now);
+  return true;
+}
+
+
+void TimeCodeEngine::Chase() {
+  SetMode(CHASE);
+}
+
+
+bool TimeCodeEngine::HandleTimeCode(const TimeCode &timecode) {
+  if (!timecode.IsValid()) {
+    return false;
+  }
+
+  switch (m_mode) {
+    case FORWARD:
+      SendFrame(timecode);
+      break;
+    case GENERATE:
+      OLA_DEBUG << "Ignoring timecode " << timecode << " while generating";
+      break;
+    case CHASE:
+      ChaseTimeCode(timecode);
+      break;
+  }
+  return true;
+}
+
+
+bool TimeCodeEngine::ModeFromString(const string &input, Mode *mode) {
+  if (input == "forward") {
+    *mode = FORWARD;
+  } else if (input == "generate") {
+    *mode = GENERATE;
+  } else if (input == "chase") {
+    *mode = CHASE;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+
+string TimeCodeEngine::ModeToString(Mode mode) {
+  switch (mode) {
+    case FORWARD:
+      return "forward";
+    case GENERATE:
+      return "generate";
+    case CHASE:
+      return "chase";
+  }
+  return "";
+}
+
+
+void TimeCodeEngine::SetMode(Mode mode) {
+  Stop();
+  m_mode = mode;
+  m_drift = 0;
+  if (m_mode_var) {
+    m_mode_var->Set(ModeToString(m_mode));
+    m_drift_var->Set(0);
+  }
+}
+
+
+/*
+ * Start sending frames, beginning with frame_count which is sent now.
+ */
+void TimeCodeEngine::Start(TimeCodeType type, uint32_t frame_count,
+                           const TimeStamp &now) {
+  Stop();
+  m_type = type;
+  m_reference_time = now;
+  m_reference_frame = frame_count % TimeCode::FramesPerDay(type);
+  m_next_frame = 0;
+  m_last_input_frame = 0;
+  m_running = true;
+  SendFrames();
+}
+
+
+void TimeCodeEngine::Stop() {
+  if (m_timeout_id != INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(m_timeout_id);
+    m_timeout_id = INVALID_TIMEOUT;
+  }
+  m_running = false;
+}
+
+
+/*
+ * Called when the next frame is due.
+ */
+void TimeCodeEngine::SendFrames() {
+  m_timeout_id = INVALID_TIMEOUT;
+  TimeStamp now;
+  m_clock->CurrentMonotonicTime(&now);
+
+  if (now < m_reference_time + FrameOffset(m_next_frame)) {
+    ScheduleNextFrame(now);
+    return;
+  }
+
+  // If we've fallen behind, skip to the latest frame that's due.
+  const uint64_t due_frame = FrameAt(now - m_reference_time);
+  if (m_mode == CHASE &&
+      due_frame > m_last_input_frame + m_options.freewheel_frames) {
+    OLA_INFO << "No timecode received for " << m_options.freewheel_frames
+             << " frames, stopping";
+    Stop();
+    return;
+  }
+
+  if (due_frame > m_next_frame) {
+    const unsigned int slipped = due_frame - m_next_frame;
+    m_frames_slipped += slipped;
+    if (m_frames_slipped_var) {
+      (*m_frames_slipped_var) += slipped;
+    }
+    m_next_frame = due_frame;
+  }
+
+  RecordLatency(now, now - (m_reference_time + FrameOffset(m_next_frame)));
+  const uint32_t frame_count = static_cast<uint32_t>(
+      (m_reference_frame + m_next_frame) % TimeCode::FramesPerDay(m_type));
+  SendFrame(TimeCode::FromFrameCount(m_type, frame_count));
+  m_next_frame++;
+  ScheduleNextFrame(now);
+}
+
+
+void TimeCodeEngine::ScheduleNextFrame(const TimeStamp &now) {
+  const TimeInterval delay = (m_reference_time + FrameOffset(m_next_frame)) -
+                             now;
+  m_timeout_id = m_scheduler->RegisterSingleTimeout(
+      delay,
+      NewSingleCallback(this, &TimeCodeEngine::SendFrames));
+}
+
+
+void TimeCodeEngine::SendFrame(const TimeCode &timecode) {
+  const unsigned int outputs = m_send_callback->Run(timecode);
+  m_frames_sent++;
+  if (m_frames_sent_var) {
+    (*m_frames_sent_var)++;
+    m_outputs_var->Set(outputs);
+  }
+}
+
+
+void TimeCodeEngine::RecordLatency(const TimeStamp &now,
+                                   const TimeInterval &latency) {
+  const unsigned int latency_us = static_cast<unsigned int>(latency.AsInt());
+  m_window_frames++;
+  m_window_latency += latency_us;
+  if (latency_us > m_window_max_latency) {
+    m_window_max_latency = latency_us;
+  }
+
+  if (!m_window_start.IsSet()) {
+    m_window_start = now;
+    return;
+  }
+  if (now - m_window_start < TimeInterval(1, 0)) {
+    return;
+  }
+
+  m_latency = m_window_latency / m_window_frames;
+  m_max_latency = m_window_max_latency;
+  if (m_latency_var) {
+    m_latency_var->Set(m_latency);
+    m_max_latency_var->Set(m_max_latency);
+  }
+
+  m_window_start = now;
+  m_window_frames = 0;
+  m_window_latency = 0;
+  m_window_max_latency = 0;
+}
+
+
+/*
+ * Lock to the timecode from a client, or measure how far it has drifted.
+ */
+void TimeCodeEngine::ChaseTimeCode(const TimeCode &timecode) {
+  TimeStamp now;
+  m_clock->CurrentMonotonicTime(&now);
+
+  if (!m_running || timecode.Type() != m_type) {
+    OLA_INFO << "Chasing timecode from " << timecode;
+    Start(timecode.Type(), timecode.FrameCount(), now);
+    return;
+  }
+
+  // Work out which of our frames this is. The engine may have run past
+  // midnight, so pick the day that puts it closest to our position.
+  const int64_t frames_per_day = TimeCode::FramesPerDay(m_type);
+  int64_t input_frame =
+      (timecode.FrameCount() + frames_per_day - m_reference_frame) %
+      frames_per_day;
+  input_frame += (m_next_frame / frames_per_day) * frames_per_day;
+  const int64_t next_frame = static_cast<int64_t>(m_next_frame);
+  if (input_frame - next_frame > frames_per_day / 2) {
+    input_frame -= frames_per_day;
+  } else if (next_frame - input_frame > frames_per_day / 2) {
+    input_frame += frames_per_day;
+  }
+
+  int64_t drift = 0;
+  if (input_frame >= 0) {
+    drift = ((m_reference_time + FrameOffset(input_frame)) - now).AsInt();
+  }
+  const int64_t max_drift = FrameOffset(m_options.resync_frames).AsInt();
+  if (input_frame < 0 || drift > max_drift || drift < -max_drift) {
+    OLA_INFO << "Timecode source drifted by " << drift << "us, locking to "
+             << timecode;
+    m_resyncs++;
+    if (m_resyncs_var) {
+      (*m_resyncs_var)++;
+    }
+    Start(timecode.Type(), timecode.FrameCount(), now);
+    return;
+  }
+
+  m_drift = static_cast<int>(drift);
+  if (m_drift_var) {
+    m_drift_var->Set(m_drift);
+  }
+  if (static_cast<uint64_t>(input_frame) > m_last_input_frame) {
+    m_last_input_frame = input_frame;
+  }
+}
+
+
+/*
+ * The time from the reference time to the start of a frame.
+ */
+TimeInterval TimeCodeEngine::FrameOffset(uint64_t frame) const {
+  if (m_type == ola::timecode::TIMECODE_DF) {
+    // 29.97 frames per second
+    return TimeInterval(static_cast<int64_t>(frame * 100100 / 3));
+  }
+  return TimeInterval(static_cast<int64_t>(
+      frame * USEC_IN_SECONDS / TimeCode::FramesPerSecond(m_type)));
+}
+
+
+/*
+ * The last frame which starts at or before an offset from the reference time.
+ */
+uint64_t TimeCodeEngine::FrameAt(const TimeInterval &offset) const {
+  const int64_t usec = offset.AsInt();
+  if (usec <= 0) {
+    return 0;
+  }
+
+  uint64_t frame;
+  if (m_type == ola::timecode::TIMECODE_DF) {
+    frame = static_cast<uint64_t>(usec) * 3 / 100100;
+  } else {
+    frame = static_cast<uint64_t>(usec) * TimeCode::FramesPerSecond(m_type) /
+            USEC_IN_SECONDS;
+  }
+  // Correct for the rounding in FrameOffset()
+  while (FrameOffset(frame + 1).AsInt() <= usec) {
+    frame++;
+  }
+  return frame;
+}
+}  // namespace ola
@@ -0,0 +1,248 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TimeCodeEngine.h
+ * Generates, chases and distributes timecode inside olad.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#ifndef OLAD_TIMECODEENGINE_H_
+#define OLAD_TIMECODEENGINE_H_
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/base/Macro.h"
+#include "ola/thread/SchedulerInterface.h"
+#include "ola/timecode/TimeCode.h"
+#include "ola/timecode/TimeCodeEnums.h"
+
+namespace ola {
+
+/**
+ * @brief Sends timecode to the outputs at frame accurate times.
+ *
+ * The engine runs in one of three modes:
+ *  - FORWARD, timecode from clients is sent to the outputs as soon as it
+ *    arrives. This is the default.
+ *  - GENERATE, the engine runs from a start time at the frame rate of the
+ *    timecode type.
+ *  - CHASE, the engine locks to the timecode from clients and generates the
+ *    frames itself. Late or bunched up frames from the source don't cause
+ *    jitter on the outputs. If the source drifts by more than resync_frames,
+ *    the engine locks to it again, and if the source stops for more than
+ *    freewheel_frames, the output stops.
+ *
+ * When generating, the time of each frame is calculated from the time the
+ * engine started or locked, so scheduling delays don't accumulate. If the
+ * engine falls a frame or more behind, it skips to the current frame rather
+ * than sending a burst of old ones. Each frame is passed to the SendCallback
+ * once, which sends it to all outputs.
+ *
+ * The statistics are published to the ExportMap as timecode-* variables.
+ */
+class TimeCodeEngine {
+ public:
+  enum Mode {
+    FORWARD,
+    GENERATE,
+    CHASE,
+  };
+
+  /**
+   * @brief Sends a frame to the outputs, and returns the number of outputs it
+   * was sent to.
+   */
+  typedef Callback1<unsigned int, const ola::timecode::TimeCode&>
+      SendCallback;
+
+  struct Options {
+    /**
+     * @brief When chasing, lock to the source again if it drifts by more than
+     * this many frames.
+     */
+    unsigned int resync_frames;
+
+    /**
+     * @brief When chasing, stop the output if no timecode has arrived for this
+     * many frames.
+     */
+    unsigned int freewheel_frames;
+
+    Options()
+        : resync_frames(DEFAULT_RESYNC_FRAMES),
+          freewheel_frames(DEFAULT_FREEWHEEL_FRAMES) {
+    }
+  };
+
+  /**
+   * @brief Create a new TimeCodeEngine.
+   * @param scheduler the scheduler to register the frame timer with.
+   * @param clock the clock to use, this should be the same as the one used
+   *   by the scheduler.
+   * @param send_callback the callback used to send each frame, ownership is
+   *   transferred.
+   * @param export_map the ExportMap to publish the statistics to, may be NULL.
+   * @param options the engine options.
+   */
+  TimeCodeEngine(ola::thread::SchedulerInterface *scheduler,
+                 const Clock *clock,
+                 SendCallback *send_callback,
+                 ExportMap *export_map = NULL,
+                 const Options &options = Options());
+  ~TimeCodeEngine();
+
+  Mode CurrentMode() const { return m_mode; }
+
+  /**
+   * @brief Stop generating and forward timecode from clients.
+   */
+  void Forward();
+
+  /**
+   * @brief Generate timecode.
+   * @param start the first frame to send, this is sent immediately.
+   * @returns false if the start time isn't valid.
+   */
+  bool Generate(const ola::timecode::TimeCode &start);
+
+  /**
+   * @brief Chase the timecode from clients.
+   */
+  void Chase();
+
+  /**
+   * @brief Called when a client sends timecode.
+   * @returns false if the timecode isn't valid.
+   */
+  bool HandleTimeCode(const ola::timecode::TimeCode &timecode);
+
+  /**
+   * @brief The total number of frames sent.
+   */
+  unsigned int FramesSent() const { return m_frames_sent; }
+
+  /**
+   * @brief The number of frames that were skipped because the engine fell
+   * behind.
+   */
+  unsigned int FramesSlipped() const { return m_frames_slipped; }
+
+  /**
+   * @brief The number of times the engine locked to the source again.
+   */
+  unsigned int Resyncs() const { return m_resyncs; }
+
+  /**
+   * @brief How far the source was ahead of the engine, in microseconds, when
+   * the last timecode arrived. Negative if the source was behind.
+   */
+  int Drift() const { return m_drift; }
+
+  /**
+   * @brief The mean time in microseconds between when frames were due and
+   * when they were sent, over the last complete second.
+   */
+  unsigned int Latency() const { return m_latency; }
+
+  /**
+   * @brief The largest latency in microseconds in the last complete second.
+   */
+  unsigned int MaxLatency() const { return m_max_latency; }
+
+  /**
+   * @brief Parse a mode name, one of forward, generate or chase.
+   */
+  static bool ModeFromString(const std::string &input, Mode *mode);
+
+  /**
+   * @brief Return the name of a mode.
+   */
+  static std::string ModeToString(Mode mode);
+
+  static const unsigned int DEFAULT_RESYNC_FRAMES = 2;
+  static const unsigned int DEFAULT_FREEWHEEL_FRAMES = 30;
+
+ private:
+  ola::thread::SchedulerInterface *m_scheduler;
+  const Clock *m_clock;
+  std::auto_ptr<SendCallback> m_send_callback;
+  const Options m_options;
+  Mode m_mode;
+  ola::thread::timeout_id m_timeout_id;
+
+  // Frame n is due at m_reference_time + FrameOffset(n), and has a frame
+  // count of m_reference_frame + n.
+  ola::timecode::TimeCodeType m_type;
+  TimeStamp m_reference_time;
+  uint32_t m_reference_frame;
+  uint64_t m_next_frame;
+  bool m_running;
+
+  // The frame number of the last timecode received while chasing.
+  uint64_t m_last_input_frame;
+
+  unsigned int m_frames_sent;
+  unsigned int m_frames_slipped;
+  unsigned int m_resyncs;
+  int m_drift;
+
+  // The latency statistics for the current and last complete second.
+  TimeStamp m_window_start;
+  unsigned int m_window_frames;
+  uint64_t m_window_latency;
+  unsigned int m_window_max_latency;
+  unsigned int m_latency;
+  unsigned int m_max_latency;
+
+  StringVariable *m_mode_var;
+  CounterVariable *m_frames_sent_var;
+  CounterVariable *m_frames_slipped_var;
+  CounterVariable *m_resyncs_var;
+  IntegerVariable *m_drift_var;
+  IntegerVariable *m_latency_var;
+  IntegerVariable *m_max_latency_var;
+  IntegerVariable *m_outputs_var;
+
+  void SetMode(Mode mode);
+  void Start(ola::timecode::TimeCodeType type, uint32_t frame_count,
+             const TimeStamp &now);
+  void Stop();
+  void SendFrames();
+  void ScheduleNextFrame(const TimeStamp &now);
+  void SendFrame(const ola::timecode::TimeCode &timecode);
+  void RecordLatency(const TimeStamp &now, const TimeInterval &latency);
+  void ChaseTimeCode(const ola::timecode::TimeCode &timecode);
+
+  TimeInterval FrameOffset(uint64_t frame) const;
+  uint64_t FrameAt(const TimeInterval &offset) const;
+
+  static const char MODE_VAR[];
+  static const char FRAMES_SENT_VAR[];
+  static const char FRAMES_SLIPPED_VAR[];
+  static const char RESYNCS_VAR[];
+  static const char DRIFT_VAR[];
+  static const char LATENCY_VAR[];
+  static const char MAX_LATENCY_VAR[];
+  static const char OUTPUTS_VAR[];
+
+  DISALLOW_COPY_AND_ASSIGN(TimeCodeEngine);
+};
+}  // namespace ola
+#endif  // OLAD_TIMECODEENGINE_H_
@@ -0,0 +1,315 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * TimeCodeEngineTest.cpp
+ * Test fixture for the TimeCodeEngine class.
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "ola/Callback.h"
+#include "ola/Clock.h"
+#include "ola/ExportMap.h"
+#include "ola/io/SelectServer.h"
+#include "ola/strings/Format.h"
+#include "ola/testing/TestUtils.h"
+#include "ola/timecode/TimeCode.h"
+#include "ola/timecode/TimeCodeEnums.h"
+#include "olad/TimeCodeEngine.h"
+
+using ola::ExportMap;
+using ola::MockClock;
+using ola::NewCallback;
+using ola::TimeCodeEngine;
+using ola::TimeInterval;
+using ola::io::SelectServer;
+using ola::timecode::TimeCode;
+using std::vector;
+
+class TimeCodeEngineTest: public CppUnit::TestFixture {
+ public:
+    TimeCodeEngineTest()
+        : CppUnit::TestFixture(),
+          m_ss(NULL, &m_clock) {
+    }
+
+  CPPUNIT_TEST_SUITE(TimeCodeEngineTest);
+  CPPUNIT_TEST(testForward);
+  CPPUNIT_TEST(testGenerate);
+  CPPUNIT_TEST(testGenerateDropFrame);
+  CPPUNIT_TEST(testSlippedFrames);
+  CPPUNIT_TEST(testChase);
+  CPPUNIT_TEST(testModeNames);
+  CPPUNIT_TEST_SUITE_END();
+
+ public:
+    void setUp() { m_sent.clear(); }
+
+    void testForward();
+    void testGenerate();
+    void testGenerateDropFrame();
+    void testSlippedFrames();
+    void testChase();
+    void testModeNames();
+
+ private:
+    MockClock m_clock;
+    SelectServer m_ss;
+    vector<TimeCode> m_sent;
+
+    unsigned int SendTimeCode(const TimeCode &timecode) {
+      m_sent.push_back(timecode);
+      return 2;
+    }
+
+    TimeCodeEngine::SendCallback *NewSendCallback() {
+      return NewCallback(this, &TimeCodeEngineTest::SendTimeCode);
+    }
+
+    // The MockClock moves with the real clock as well, so the tests leave some
+    // slack around each deadline.
+    void Advance(int64_t usec) {
+      m_clock.AdvanceTime(TimeInterval(usec));
+      m_ss.RunOnce(TimeInterval(0, 0));
+    }
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TimeCodeEngineTest);
+
+
+/*
+ * Check timecode from clients is sent immediately by default.
+ */
+void TimeCodeEngineTest::testForward() {
+  ExportMap export_map;
+  TimeCodeEngine engine(&m_ss, &m_clock, NewSendCallback(), &export_map);
+  OLA_ASSERT_EQ(TimeCodeEngine::FORWARD, engine.CurrentMode());
+  OLA_ASSERT_EQ(std::string("forward"),
+                export_map.GetStringVar("timecode-mode")->Value());
+
+  TimeCode timecode(ola::timecode::TIMECODE_EBU, 10, 0, 0, 0);
+  OLA_ASSERT_TRUE(engine.HandleTimeCode(timecode));
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_sent.size());
+  OLA_ASSERT_EQ(timecode, m_sent[0]);
+
+  OLA_ASSERT_FALSE(engine.HandleTimeCode(
+      TimeCode(ola::timecode::TIMECODE_EBU, 10, 0, 0, 25)));
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_sent.size());
+
+  // Nothing is sent until the next timecode arrives.
+  Advance(100000);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_sent.size());
+  OLA_ASSERT_EQ(1u, engine.FramesSent());
+  OLA_ASSERT_EQ(1u, export_map.GetCounterVar("timecode-frames-sent")->Get());
+  OLA_ASSERT_EQ(std::string("2"),
+                export_map.GetIntegerVar("timecode-outputs")->Value());
+}
+
+
+/*
+ * Check generated frames are sent on time.
+ */
+void TimeCodeEngineTest::testGenerate() {
+  ExportMap export_map;
+  TimeCodeEngine engine(&m_ss, &m_clock, NewSendCallback(), &export_map);
+  OLA_ASSERT_FALSE(engine.Generate(
+      TimeCode(ola::timecode::TIMECODE_SMPTE, 24, 0, 0, 0)));
+
+  OLA_ASSERT_TRUE(engine.Generate(
+      TimeCode(ola::timecode::TIMECODE_SMPTE, 1, 0, 0, 0)));
+  OLA_ASSERT_EQ(TimeCodeEngine::GENERATE, engine.CurrentMode());
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_sent.size());
+
+  // Timecode from clients is ignored while generating.
+  OLA_ASSERT_TRUE(engine.HandleTimeCode(
+      TimeCode(ola::timecode::TIMECODE_SMPTE, 2, 0, 0, 0)));
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_sent.size());
+
+  // The second frame is due after 33,333us.
+  Advance(30000);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_sent.size());
+  Advance(5000);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_sent.size());
+  OLA_ASSERT_EQ(TimeCode(ola::timecode::TIMECODE_SMPTE, 1, 0, 0, 1),
+                m_sent[1]);
+
+  // Run for a few seconds with an event loop that wakes late.
+  for (unsigned int i = 0; i < 299; i++) {
+    Advance(10000);
+  }
+  OLA_ASSERT_EQ(static_cast<size_t>(91), m_sent.size());
+  for (unsigned int i = 0; i < m_sent.size(); i++) {
+    OLA_ASSERT_EQ(TimeCode::FromFrameCount(ola::timecode::TIMECODE_SMPTE,
+                                           108000 + i),
+                  m_sent[i]);
+  }
+  OLA_ASSERT_EQ(TimeCode(ola::timecode::TIMECODE_SMPTE, 1, 0, 3, 0),
+                m_sent.back());
+  OLA_ASSERT_EQ(0u, engine.FramesSlipped());
+
+  // Frames are never sent early, and are at most one loop iteration late.
+  OLA_ASSERT_TRUE(engine.MaxLatency() < 10000);
+  OLA_ASSERT_TRUE(engine.Latency() <= engine.MaxLatency());
+  OLA_ASSERT_EQ(
+      ola::strings::IntToString(engine.MaxLatency()),
+      export_map.GetIntegerVar("timecode-max-latency-us")->Value());
+
+  engine.Forward();
+  Advance(100000);
+  OLA_ASSERT_EQ(static_cast<size_t>(91), m_sent.size());
+}
+
+
+/*
+ * Check drop frame timecode is generated at 29.97 frames per second.
+ */
+void TimeCodeEngineTest::testGenerateDropFrame() {
+  TimeCodeEngine engine(&m_ss, &m_clock, NewSendCallback());
+  OLA_ASSERT_TRUE(engine.Generate(
+      TimeCode(ola::timecode::TIMECODE_DF, 0, 0, 59, 29)));
+
+  // Frames 00 and 01 are dropped at the start of the minute.
+  Advance(30000);
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_sent.size());
+  Advance(5000);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_sent.size());
+  OLA_ASSERT_EQ(TimeCode(ola::timecode::TIMECODE_DF, 0, 1, 0, 2), m_sent[1]);
+
+  for (unsigned int i = 2; i < 30; i++) {
+    Advance(33367);
+    OLA_ASSERT_EQ(static_cast<size_t>(i + 1), m_sent.size());
+  }
+
+  // 30 frames take 1.001s, rather than 1s.
+  Advance(1000500 - 35000 - 28 * 33367);
+  OLA_ASSERT_EQ(static_cast<size_t>(30), m_sent.size());
+  Advance(1500);
+  OLA_ASSERT_EQ(static_cast<size_t>(31), m_sent.size());
+  OLA_ASSERT_EQ(TimeCode(ola::timecode::TIMECODE_DF, 0, 1, 1, 1),
+                m_sent.back());
+  OLA_ASSERT_EQ(0u, engine.FramesSlipped());
+}
+
+
+/*
+ * Check that if the engine falls behind, it skips to the current frame.
+ */
+void TimeCodeEngineTest::testSlippedFrames() {
+  ExportMap export_map;
+  TimeCodeEngine engine(&m_ss, &m_clock, NewSendCallback(), &export_map);
+  OLA_ASSERT_TRUE(engine.Generate(
+      TimeCode(ola::timecode::TIMECODE_EBU, 0, 0, 0, 0)));
+
+  // At 25 fps, frame 4 is due at 160ms.
+  Advance(170000);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_sent.size());
+  OLA_ASSERT_EQ(TimeCode(ola::timecode::TIMECODE_EBU, 0, 0, 0, 4),
+                m_sent[1]);
+  OLA_ASSERT_EQ(3u, engine.FramesSlipped());
+  OLA_ASSERT_EQ(3u, export_map.GetCounterVar("timecode-frames-slipped")->Get());
+
+  // And then carries on from there.
+  Advance(35000);
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_sent.size());
+  OLA_ASSERT_EQ(TimeCode(ola::timecode::TIMECODE_EBU, 0, 0, 0, 5),
+                m_sent[2]);
+  OLA_ASSERT_EQ(3u, engine.FramesSlipped());
+}
+
+
+/*
+ * Check chasing timecode from a client.
+ */
+void TimeCodeEngineTest::testChase() {
+  ExportMap export_map;
+  TimeCodeEngine engine(&m_ss, &m_clock, NewSendCallback(), &export_map);
+  engine.Chase();
+  OLA_ASSERT_EQ(TimeCodeEngine::CHASE, engine.CurrentMode());
+
+  // The first timecode locks the engine.
+  OLA_ASSERT_TRUE(engine.HandleTimeCode(
+      TimeCode(ola::timecode::TIMECODE_EBU, 10, 0, 0, 0)));
+  OLA_ASSERT_EQ(static_cast<size_t>(1), m_sent.size());
+
+  // The source sends frames late and bunched up, but the output stays on
+  // time.
+  Advance(30000);
+  OLA_ASSERT_TRUE(engine.HandleTimeCode(
+      TimeCode(ola::timecode::TIMECODE_EBU, 10, 0, 0, 1)));
+  OLA_ASSERT_TRUE(engine.Drift() <= 10000);
+  OLA_ASSERT_TRUE(engine.Drift() > 9000);
+  Advance(20000);
+  OLA_ASSERT_EQ(static_cast<size_t>(2), m_sent.size());
+  Advance(45000);
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_sent.size());
+  OLA_ASSERT_TRUE(engine.HandleTimeCode(
+      TimeCode(ola::timecode::TIMECODE_EBU, 10, 0, 0, 2)));
+  OLA_ASSERT_TRUE(engine.Drift() <= -15000);
+  OLA_ASSERT_TRUE(engine.Drift() > -16000);
+  OLA_ASSERT_EQ(ola::strings::IntToString(engine.Drift()),
+                export_map.GetIntegerVar("timecode-drift-us")->Value());
+  OLA_ASSERT_EQ(static_cast<size_t>(3), m_sent.size());
+  for (unsigned int i = 0; i < m_sent.size(); i++) {
+    OLA_ASSERT_EQ(TimeCode(ola::timecode::TIMECODE_EBU, 10, 0, 0, i),
+                  m_sent[i]);
+  }
+  OLA_ASSERT_EQ(0u, engine.Resyncs());
+
+  // The source jumps forward, the engine locks to it again.
+  OLA_ASSERT_TRUE(engine.HandleTimeCode(
+      TimeCode(ola::timecode::TIMECODE_EBU, 11, 0, 0, 0)));
+  OLA_ASSERT_EQ(static_cast<size_t>(4), m_sent.size());
+  OLA_ASSERT_EQ(TimeCode(ola::timecode::TIMECODE_EBU, 11, 0, 0, 0),
+                m_sent[3]);
+  OLA_ASSERT_EQ(1u, engine.Resyncs());
+  OLA_ASSERT_EQ(1u, export_map.GetCounterVar("timecode-resyncs")->Get());
+
+  // The source stops, the engine freewheels for 30 frames then stops.
+  for (unsigned int i = 0; i < 100; i++) {
+    Advance(20000);
+  }
+  OLA_ASSERT_EQ(static_cast<size_t>(4 + 30), m_sent.size());
+  OLA_ASSERT_EQ(TimeCode(ola::timecode::TIMECODE_EBU, 11, 0, 1, 5),
+                m_sent.back());
+
+  // When the source restarts the engine locks to it again.
+  OLA_ASSERT_TRUE(engine.HandleTimeCode(
+      TimeCode(ola::timecode::TIMECODE_EBU, 11, 0, 5, 0)));
+  OLA_ASSERT_EQ(static_cast<size_t>(4 + 31), m_sent.size());
+  OLA_ASSERT_EQ(1u, engine.Resyncs());
+}
+
+
+/*
+ * Check the conversion of modes to and from strings.
+ */
+void TimeCodeEngineTest::testModeNames() {
+  TimeCodeEngine::Mode mode;
+  OLA_ASSERT_TRUE(TimeCodeEngine::ModeFromString("forward", &mode));
+  OLA_ASSERT_EQ(TimeCodeEngine::FORWARD, mode);
+  OLA_ASSERT_TRUE(TimeCodeEngine::ModeFromString("generate", &mode));
+  OLA_ASSERT_EQ(TimeCodeEngine::GENERATE, mode);
+  OLA_ASSERT_TRUE(TimeCodeEngine::ModeFromString("chase", &mode));
+  OLA_ASSERT_EQ(TimeCodeEngine::CHASE, mode);
+  OLA_ASSERT_FALSE(TimeCodeEngine::ModeFromString("foo", &mode));
+
+  OLA_ASSERT_EQ(std::string("chase"),
+                TimeCodeEngine::ModeToString(TimeCodeEngine::CHASE));
+}
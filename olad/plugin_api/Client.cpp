@@ -37,7 +37,8 @@ using std::map;
 Client::Client(ola::proto::OlaClientService_Stub *client_stub,
                const ola::rdm::UID &uid)
     : m_client_stub(client_stub),
-      m_uid(uid) {
+      m_uid(uid),
+      m_streaming(false) {
 }
 
 Client::~Client() {
@@ -45,19 +46,42 @@ Client::~Client() {
 }
 
 bool Client::SendDMX(unsigned int universe, uint8_t priority,
-                     const DmxBuffer &buffer) {
+                     const DmxBuffer &buffer, unsigned int start_slot) {
   if (!m_client_stub.get()) {
     OLA_FATAL << "client_stub is null";
     return false;
   }
 
+  if (m_streaming) {
+    m_stream_controller.Reset();
+    m_stream_controller.SetCoalesceKey(universe);
+    m_stream_data.set_priority(priority);
+    m_stream_data.set_universe(universe);
+    // assign() reuses the existing capacity of the string.
+    m_stream_data.mutable_data()->assign(
+        reinterpret_cast<const char*>(buffer.GetRaw()), buffer.Size());
+    if (start_slot) {
+      m_stream_data.set_start_slot(start_slot);
+    } else {
+      m_stream_data.clear_start_slot();
+    }
+    m_client_stub->StreamDmxData(&m_stream_controller, &m_stream_data, NULL,
+                                 NULL);
+    return true;
+  }
+
   RpcController *controller = new RpcController();
+  // If the client is behind, only the latest frame for each universe is sent.
+  controller->SetCoalesceKey(universe);
   ola::proto::DmxData dmx_data;
   ola::proto::Ack *ack = new ola::proto::Ack();
 
   dmx_data.set_priority(priority);
   dmx_data.set_universe(universe);
   dmx_data.set_data(buffer.Get());
+  if (start_slot) {
+    dmx_data.set_start_slot(start_slot);
+  }
 
   m_client_stub->UpdateDmxData(
       controller,
@@ -68,6 +92,16 @@ bool Client::SendDMX(unsigned int universe, uint8_t priority,
   return true;
 }
 
+bool Client::SendRDMBulkGetResult(
+    const ola::proto::RDMBulkGetResult &result) {
+  if (!m_client_stub.get()) {
+    OLA_FATAL << "client_stub is null";
+    return false;
+  }
+  m_client_stub->StreamRDMBulkGetResult(NULL, &result, NULL, NULL);
+  return true;
+}
+
 void Client::DMXReceived(unsigned int universe, const DmxSource &source) {
   STLReplace(&m_data_map, universe, source);
 }
@@ -23,6 +23,7 @@
 
 #include <map>
 #include <memory>
+#include "common/protocol/Ola.pb.h"
 #include "common/rpc/RpcController.h"
 #include "ola/base/Macro.h"
 #include "ola/rdm/UID.h"
@@ -62,10 +63,34 @@ class Client {
    * @param universe_id the universe the DMX data belongs to
    * @param priority the priority of the DMX data
    * @param buffer the DMX data.
+   * @param start_slot the slot the data starts at, this is non-0 if the
+   *   client registered for a range of slots.
    * @return true if the update was sent, false otherwise
    */
   virtual bool SendDMX(unsigned int universe_id, uint8_t priority,
-                       const DmxBuffer &buffer);
+                       const DmxBuffer &buffer,
+                       unsigned int start_slot = 0);
+
+  /**
+   * @brief Push the result of a RDMBulkGet to this client.
+   * @param result the result, with the stream_id set.
+   * @return true if the result was sent, false otherwise
+   */
+  virtual bool SendRDMBulkGetResult(
+      const ola::proto::RDMBulkGetResult &result);
+
+  /**
+   * @brief Enable or disable streaming DMX updates.
+   * @param streaming if true, DMX updates are pushed with StreamDmxData,
+   *   which doesn't require a response from the client. Otherwise
+   *   UpdateDmxData is used.
+   */
+  void SetStreaming(bool streaming) { m_streaming = streaming; }
+
+  /**
+   * @brief Check if DMX updates are streamed to this client.
+   */
+  bool Streaming() const { return m_streaming; }
 
   /**
    * @brief Called when this client sends us new data
@@ -102,6 +127,10 @@ class Client {
   std::auto_ptr<class ola::proto::OlaClientService_Stub> m_client_stub;
   std::map<unsigned int, DmxSource> m_data_map;
   ola::rdm::UID m_uid;
+  bool m_streaming;
+  // Reused for each streamed update, to avoid allocating on every frame.
+  ola::rpc::RpcController m_stream_controller;
+  ola::proto::DmxData m_stream_data;
 
   DISALLOW_COPY_AND_ASSIGN(Client);
 };
@@ -46,12 +46,14 @@ using std::string;
 class ClientTest: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(ClientTest);
   CPPUNIT_TEST(testSendDMX);
+  CPPUNIT_TEST(testStreamDMX);
   CPPUNIT_TEST(testGetSetDMX);
   CPPUNIT_TEST_SUITE_END();
 
  public:
   ClientTest() : m_test_uid(ola::OPEN_LIGHTING_ESTA_CODE, 0) {}
   void testSendDMX();
+  void testStreamDMX();
   void testGetSetDMX();
 
  private:
@@ -75,6 +77,49 @@ class MockClientStub: public ola::proto::OlaClientService_Stub {
                      ola::rpc::RpcService::CompletionCallback *done);
 };
 
+
+/*
+ * A ClientStub that records streamed updates.
+ */
+class MockStreamingClientStub: public ola::proto::OlaClientService_Stub {
+ public:
+  MockStreamingClientStub()
+      : ola::proto::OlaClientService_Stub(NULL),
+        updates(0),
+        last_request(NULL) {
+  }
+
+  void UpdateDmxData(ola::rpc::RpcController*,
+                     const ola::proto::DmxData*,
+                     ola::proto::Ack*,
+                     ola::rpc::RpcService::CompletionCallback*) {
+    OLA_FAIL("UpdateDmxData called on a streaming client");
+  }
+
+  void StreamDmxData(ola::rpc::RpcController *controller,
+                     const ola::proto::DmxData *request,
+                     ola::proto::STREAMING_NO_RESPONSE *response,
+                     ola::rpc::RpcService::CompletionCallback *done) {
+    OLA_ASSERT(controller);
+    OLA_ASSERT(controller->HasCoalesceKey());
+    OLA_ASSERT_EQ(static_cast<int>(request->universe()),
+                  controller->CoalesceKey());
+    OLA_ASSERT_NULL(response);
+    OLA_ASSERT_NULL(done);
+    updates++;
+    last_request = request;
+    last_universe = request->universe();
+    last_priority = request->priority();
+    last_data = request->data();
+  }
+
+  unsigned int updates;
+  const ola::proto::DmxData *last_request;
+  unsigned int last_universe;
+  unsigned int last_priority;
+  string last_data;
+};
+
 void MockClientStub::UpdateDmxData(
     ola::rpc::RpcController* controller,
     const ola::proto::DmxData *request,
@@ -102,6 +147,34 @@ void ClientTest::testSendDMX() {
   client2.SendDMX(TEST_UNIVERSE, priority, buffer);
 }
 
+/*
+ * Check that DMX updates are streamed once enabled.
+ */
+void ClientTest::testStreamDMX() {
+  const DmxBuffer buffer(TEST_DATA);
+  const DmxBuffer buffer2(TEST_DATA2);
+  MockStreamingClientStub *stub = new MockStreamingClientStub();
+  Client client(stub, m_test_uid);
+  OLA_ASSERT_FALSE(client.Streaming());
+  client.SetStreaming(true);
+  OLA_ASSERT_TRUE(client.Streaming());
+
+  OLA_ASSERT_TRUE(client.SendDMX(TEST_UNIVERSE, 100, buffer));
+  OLA_ASSERT_EQ(1u, stub->updates);
+  OLA_ASSERT_EQ(TEST_UNIVERSE, stub->last_universe);
+  OLA_ASSERT_EQ(100u, stub->last_priority);
+  OLA_ASSERT_EQ(string(TEST_DATA), stub->last_data);
+  const ola::proto::DmxData *first_request = stub->last_request;
+
+  // the same message is reused for the next update
+  OLA_ASSERT_TRUE(client.SendDMX(TEST_UNIVERSE2, 120, buffer2));
+  OLA_ASSERT_EQ(2u, stub->updates);
+  OLA_ASSERT_EQ(TEST_UNIVERSE2, stub->last_universe);
+  OLA_ASSERT_EQ(120u, stub->last_priority);
+  OLA_ASSERT_EQ(string(TEST_DATA2), stub->last_data);
+  OLA_ASSERT_EQ(first_request, stub->last_request);
+}
+
 /*
  * Check that the DMX get/set works correctly.
  */
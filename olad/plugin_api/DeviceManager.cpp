@@ -24,18 +24,24 @@
 #include <stdio.h>
 #include <errno.h>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
+#include "ola/rdm/UID.h"
+#include "ola/rdm/UIDSet.h"
 #include "ola/stl/STLUtils.h"
 #include "olad/Port.h"
 #include "olad/plugin_api/PortManager.h"
 
 namespace ola {
 
+using ola::rdm::UID;
+using ola::rdm::UIDSet;
+using std::auto_ptr;
 using std::map;
 using std::set;
 using std::string;
@@ -45,6 +51,9 @@ const unsigned int DeviceManager::MISSING_DEVICE_ALIAS = 0;
 const char DeviceManager::PORT_PREFERENCES[] = "port";
 const char DeviceManager::PRIORITY_VALUE_SUFFIX[] = "_priority_value";
 const char DeviceManager::PRIORITY_MODE_SUFFIX[] = "_priority_mode";
+const char DeviceManager::UID_CACHE_SUFFIX[] = "_uids";
+const char DeviceManager::MAX_FRAME_RATE_SUFFIX[] = "_max_frame_rate";
+const char DeviceManager::REFRESH_INTERVAL_SUFFIX[] = "_refresh_interval";
 
 bool operator <(const device_alias_pair& left,
                 const device_alias_pair &right) {
@@ -111,13 +120,23 @@ bool DeviceManager::RegisterDevice(AbstractDevice *device) {
 
   vector<OutputPort*> output_ports;
   device->OutputPorts(&output_ports);
+  // This needs to happen before the ports are patched, since patching may
+  // trigger discovery.
+  vector<OutputPort*>::const_iterator output_iter = output_ports.begin();
+  for (; output_iter != output_ports.end(); ++output_iter) {
+    RestorePortUIDs(*output_iter);
+    RestorePortFrameRate(*output_iter);
+  }
   RestorePortSettings(output_ports);
 
-  // look for timecode ports and add them to the set
-  vector<OutputPort*>::const_iterator output_iter = output_ports.begin();
+  // Timecode isn't tied to a universe, and the ports of a device share the
+  // same output (e.g. an Art-Net node), so only the first port of each device
+  // that supports timecode is used.
+  output_iter = output_ports.begin();
   for (; output_iter != output_ports.end(); ++output_iter) {
     if ((*output_iter)->SupportsTimeCode()) {
       m_timecode_ports.insert(*output_iter);
+      break;
     }
   }
 
@@ -188,11 +207,16 @@ void DeviceManager::UnregisterAllDevices() {
   m_alias_map.clear();
 }
 
-void DeviceManager::SendTimeCode(const ola::timecode::TimeCode &timecode) {
+unsigned int DeviceManager::SendTimeCode(
+    const ola::timecode::TimeCode &timecode) {
+  unsigned int sent = 0;
   set<OutputPort*>::iterator iter = m_timecode_ports.begin();
   for (; iter != m_timecode_ports.end(); iter++) {
-    (*iter)->SendTimeCode(timecode);
+    if ((*iter)->SendTimeCode(timecode)) {
+      sent++;
+    }
   }
+  return sent;
 }
 
 /*
@@ -219,6 +243,8 @@ void DeviceManager::ReleaseDevice(const AbstractDevice *device) {
   vector<OutputPort*>::const_iterator output_iter = output_ports.begin();
   for (; output_iter != output_ports.end(); ++output_iter) {
     SavePortPriority(**output_iter);
+    SavePortUIDs(**output_iter);
+    SavePortFrameRate(**output_iter);
 
     // remove from the timecode port set
     STLRemove(&m_timecode_ports, *output_iter);
@@ -310,6 +336,125 @@ void DeviceManager::RestorePortPriority(Port *port) const {
 }
 
 
+/*
+ * Save the UIDs discovered on an output port, so we can warm-start discovery
+ * next time.
+ */
+void DeviceManager::SavePortUIDs(const OutputPort &port) const {
+  if (!port.SupportsRDM()) {
+    return;
+  }
+
+  string port_id = port.UniqueId();
+  if (port_id.empty()) {
+    return;
+  }
+
+  UIDSet uids;
+  if (port.GetUniverse()) {
+    port.GetUniverse()->GetPortUIDs(&port, &uids);
+  }
+
+  if (uids.Empty()) {
+    m_port_preferences->RemoveValue(port_id + UID_CACHE_SUFFIX);
+    return;
+  }
+
+  vector<string> uid_strings;
+  UIDSet::Iterator iter = uids.Begin();
+  for (; iter != uids.End(); ++iter) {
+    uid_strings.push_back(iter->ToString());
+  }
+  m_port_preferences->SetValue(port_id + UID_CACHE_SUFFIX,
+                               StringJoin(",", uid_strings));
+}
+
+
+/*
+ * Restore the cached UIDs for an output port.
+ */
+void DeviceManager::RestorePortUIDs(OutputPort *port) const {
+  if (!m_port_preferences || !port->SupportsRDM()) {
+    return;
+  }
+
+  string port_id = port->UniqueId();
+  if (port_id.empty()) {
+    return;
+  }
+
+  string uids_str = m_port_preferences->GetValue(port_id + UID_CACHE_SUFFIX);
+  if (uids_str.empty()) {
+    return;
+  }
+
+  vector<string> uid_strings;
+  StringSplit(uids_str, &uid_strings, ",");
+  UIDSet uids;
+  vector<string>::const_iterator iter = uid_strings.begin();
+  for (; iter != uid_strings.end(); ++iter) {
+    auto_ptr<UID> uid(UID::FromString(*iter));
+    if (uid.get()) {
+      uids.AddUID(*uid);
+    } else {
+      OLA_WARN << "Invalid cached UID " << *iter << " for port " << port_id;
+    }
+  }
+
+  OLA_INFO << "Restored " << uids.Size() << " cached UIDs for port "
+           << port_id;
+  port->SetKnownUIDs(uids);
+}
+
+
+/*
+ * Save the frame rate limits for an output port.
+ */
+void DeviceManager::SavePortFrameRate(const OutputPort &port) const {
+  string port_id = port.UniqueId();
+  if (port_id.empty()) {
+    return;
+  }
+
+  if (port.MaxFrameRate() || port.RefreshInterval()) {
+    m_port_preferences->SetValue(port_id + MAX_FRAME_RATE_SUFFIX,
+                                 IntToString(port.MaxFrameRate()));
+    m_port_preferences->SetValue(port_id + REFRESH_INTERVAL_SUFFIX,
+                                 IntToString(port.RefreshInterval()));
+  } else {
+    m_port_preferences->RemoveValue(port_id + MAX_FRAME_RATE_SUFFIX);
+    m_port_preferences->RemoveValue(port_id + REFRESH_INTERVAL_SUFFIX);
+  }
+}
+
+
+/*
+ * Restore the frame rate limits for an output port.
+ */
+void DeviceManager::RestorePortFrameRate(OutputPort *port) const {
+  if (!m_port_preferences) {
+    return;
+  }
+
+  string port_id = port->UniqueId();
+  if (port_id.empty()) {
+    return;
+  }
+
+  unsigned int max_frame_rate = 0;
+  unsigned int refresh_interval = 0;
+  bool found = StringToInt(
+      m_port_preferences->GetValue(port_id + MAX_FRAME_RATE_SUFFIX),
+      &max_frame_rate);
+  found |= StringToInt(
+      m_port_preferences->GetValue(port_id + REFRESH_INTERVAL_SUFFIX),
+      &refresh_interval);
+  if (found) {
+    port->SetFrameRateLimits(max_frame_rate, refresh_interval);
+  }
+}
+
+
 /*
  * Restore the patching information for a port.
  */
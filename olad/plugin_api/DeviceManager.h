@@ -79,7 +79,8 @@ class DeviceManager {
    * @param device The device to register, ownership is not transferred.
    * @returns true on success, false on failure.
    *
-   * During registration, any saved port patchings for this device are restored.
+   * During registration, any saved port patchings for this device are restored,
+   * along with the UIDs that were last discovered on each output port.
    */
   bool RegisterDevice(AbstractDevice *device);
 
@@ -130,10 +131,14 @@ class DeviceManager {
 
 
   /**
-   * @brief Send timecode to all ports which support timecode.
+   * @brief Send timecode to all devices which support timecode.
    * @param timecode the TimeCode information.
+   * @returns the number of devices the timecode was sent to.
+   *
+   * Each device sends the timecode once, from its first port that supports
+   * timecode.
    */
-  void SendTimeCode(const ola::timecode::TimeCode &timecode);
+  unsigned int SendTimeCode(const ola::timecode::TimeCode &timecode);
 
   static const unsigned int MISSING_DEVICE_ALIAS;
 
@@ -159,6 +164,12 @@ class DeviceManager {
   void SavePortPriority(const Port &port) const;
   void RestorePortPriority(Port *port) const;
 
+  void SavePortUIDs(const OutputPort &port) const;
+  void RestorePortUIDs(OutputPort *port) const;
+
+  void SavePortFrameRate(const OutputPort &port) const;
+  void RestorePortFrameRate(OutputPort *port) const;
+
   template <class PortClass>
   void RestorePortSettings(const std::vector<PortClass*> &ports) const;
 
@@ -166,6 +177,9 @@ class DeviceManager {
   static const unsigned int FIRST_DEVICE_ALIAS = 1;
   static const char PRIORITY_VALUE_SUFFIX[];
   static const char PRIORITY_MODE_SUFFIX[];
+  static const char UID_CACHE_SUFFIX[];
+  static const char MAX_FRAME_RATE_SUFFIX[];
+  static const char REFRESH_INTERVAL_SUFFIX[];
 
   DISALLOW_COPY_AND_ASSIGN(DeviceManager);
 };
@@ -28,6 +28,7 @@
 #include "olad/Device.h"
 #include "olad/Port.h"
 #include "olad/PortBroker.h"
+#include "olad/Universe.h"
 
 namespace ola {
 
@@ -128,7 +129,18 @@ BasicOutputPort::BasicOutputPort(AbstractDevice *parent,
     m_port_string(""),
     m_universe(NULL),
     m_device(parent),
-    m_supports_rdm(supports_rdm) {
+    m_supports_rdm(supports_rdm),
+    m_max_frame_rate(0),
+    m_refresh_interval(0) {
+}
+
+void BasicOutputPort::SetFrameRateLimits(unsigned int max_frame_rate,
+                                         unsigned int refresh_interval) {
+  m_max_frame_rate = max_frame_rate;
+  m_refresh_interval = refresh_interval;
+  if (m_universe) {
+    m_universe->OutputPortFrameRateChanged(this);
+  }
 }
 
 bool BasicOutputPort::SetUniverse(Universe *new_universe) {
@@ -96,7 +96,8 @@ class TestMockOutputPort: public ola::BasicOutputPort {
                      bool start_rdm_discovery_on_patch = false,
                      bool supports_rdm = false)
       : ola::BasicOutputPort(parent, port_id, start_rdm_discovery_on_patch,
-                             supports_rdm) {
+                             supports_rdm),
+        m_sync_count(0) {
   }
   ~TestMockOutputPort() {}
 
@@ -108,8 +109,15 @@ class TestMockOutputPort: public ola::BasicOutputPort {
   }
   const ola::DmxBuffer &ReadDMX() const { return m_buffer; }
 
+  bool SendSync(unsigned int) {
+    m_sync_count++;
+    return true;
+  }
+  unsigned int SyncCount() const { return m_sync_count; }
+
  private:
   ola::DmxBuffer m_buffer;
+  unsigned int m_sync_count;
 };
 
 
@@ -79,6 +79,77 @@ const char Universe::K_UNIVERSE_SINK_CLIENTS_VAR[] = "universe-sink-clients";
 const char Universe::K_UNIVERSE_SOURCE_CLIENTS_VAR[] =
     "universe-source-clients";
 
+namespace {
+// Matches the UIDs that map to a port.
+template<class PortClass>
+class UIDOnPort {
+ public:
+  explicit UIDOnPort(const PortClass *port) : m_port(port) {}
+
+  bool operator()(
+      const typename ola::rdm::UIDMap<PortClass*>::Entry &entry) const {
+    return entry.value == m_port;
+  }
+
+ private:
+  const PortClass *m_port;
+};
+
+// Matches the UIDs that map to a port but are no longer in its UID list.
+class UIDMissingFromPort {
+ public:
+  UIDMissingFromPort(const OutputPort *port, const ola::rdm::UIDSet &uids)
+      : m_port(port),
+        m_uids(uids) {
+  }
+
+  bool operator()(const ola::rdm::UIDMap<OutputPort*>::Entry &entry) const {
+    return entry.value == m_port && !m_uids.Contains(entry.Uid());
+  }
+
+ private:
+  const OutputPort *m_port;
+  const ola::rdm::UIDSet &m_uids;
+};
+}  // namespace
+
+/*
+ * The state we keep for each sink client.
+ */
+class Universe::SinkClientState {
+ public:
+  explicit SinkClientState(const SinkClientOptions &options)
+      : options(options),
+        sent(false),
+        timeout(ola::thread::INVALID_TIMEOUT) {
+  }
+
+  SinkClientOptions options;
+  bool sent;  // true once an update has been sent
+  DmxBuffer last_data;  // the slots sent in the last update
+  TimeStamp last_update;  // the time of the last update
+  // set if a rate limited update is waiting to be sent
+  ola::thread::timeout_id timeout;
+};
+
+/*
+ * The state we keep for output ports with frame rate limits.
+ */
+class Universe::OutputPortState {
+ public:
+  OutputPortState()
+      : written(false),
+        pending(ola::thread::INVALID_TIMEOUT),
+        refresh(ola::thread::INVALID_TIMEOUT) {
+  }
+
+  bool written;  // true once a frame has been written
+  TimeStamp last_write;  // the time of the last write
+  // set if a frame is waiting for the rate limit interval to pass
+  ola::thread::timeout_id pending;
+  ola::thread::timeout_id refresh;  // the keep-alive timer
+};
+
 /*
  * Create a new universe
  * @param uid  the universe id of this universe
@@ -87,16 +158,21 @@ const char Universe::K_UNIVERSE_SOURCE_CLIENTS_VAR[] =
  */
 Universe::Universe(unsigned int universe_id, UniverseStore *store,
                    ExportMap *export_map,
-                   Clock *clock)
+                   Clock *clock,
+                   ola::thread::SchedulerInterface *scheduler)
     : m_universe_name(""),
       m_universe_id(universe_id),
       m_active_priority(ola::dmx::SOURCE_PRIORITY_MIN),
       m_merge_mode(Universe::MERGE_LTP),
+      m_sync_group(0),
+      m_sync_frame_pending(false),
       m_universe_store(store),
       m_export_map(export_map),
       m_clock(clock),
+      m_scheduler(scheduler),
       m_rdm_discovery_interval(),
       m_last_discovery_time(),
+      m_discovery_generation(0),
       m_transaction_number_sequence() {
   ostringstream universe_id_str, universe_name_str;
   universe_id_str << universe_id;
@@ -133,6 +209,16 @@ Universe::Universe(unsigned int universe_id, UniverseStore *store,
  * Delete this universe
  */
 Universe::~Universe() {
+  SinkClientMap::iterator sink_iter = m_sink_clients.begin();
+  for (; sink_iter != m_sink_clients.end(); ++sink_iter) {
+    RemoveSinkClientState(sink_iter->second);
+  }
+  m_sink_clients.clear();
+
+  while (!m_output_port_state.empty()) {
+    RemoveOutputPortState(m_output_port_state.begin()->first);
+  }
+
   const char *string_vars[] = {
     K_UNIVERSE_NAME_VAR,
     K_UNIVERSE_MODE_VAR,
@@ -185,6 +271,30 @@ void Universe::SetMergeMode(enum merge_mode merge_mode) {
 }
 
 
+void Universe::SetSyncGroup(unsigned int sync_group) {
+  if (sync_group == m_sync_group) {
+    return;
+  }
+
+  // Don't hold a frame for a group we're leaving.
+  if (m_sync_frame_pending) {
+    WriteSyncedFrame();
+  }
+
+  unsigned int old_sync_group = m_sync_group;
+  m_sync_group = sync_group;
+  if (m_universe_store) {
+    m_universe_store->SyncGroupChanged(this, old_sync_group);
+  }
+}
+
+
+void Universe::WriteSyncedFrame() {
+  m_sync_frame_pending = false;
+  WriteOutputPorts();
+}
+
+
 /*
  * Add an InputPort to this universe.
  * @param port the port to add
@@ -220,10 +330,12 @@ bool Universe::RemovePort(InputPort *port) {
  */
 bool Universe::RemovePort(OutputPort *port) {
   bool ret = GenericRemovePort(port, &m_output_ports, &m_output_uids);
+  RemoveOutputPortState(port);
+  m_discovery_generation++;
 
   if (m_export_map) {
     (*m_export_map->GetUIntMapVar(K_UNIVERSE_UID_COUNT_VAR))[m_universe_id_str]
-        = m_output_uids.size();
+        = m_output_uids.Size();
   }
   return ret;
 }
@@ -331,10 +443,27 @@ bool Universe::ContainsSourceClient(Client *client) const {
  * @return true if client was added, and false if it was already a sink client
  */
 bool Universe::AddSinkClient(Client *client) {
-  if (!STLInsertIfNotPresent(&m_sink_clients, client)) {
+  return AddSinkClient(client, SinkClientOptions());
+}
+
+
+/*
+ * @brief Add a client as a sink for this universe
+ * @param client the client to add
+ * @param options the options that select which updates are sent
+ * @return true if client was added, and false if it was already a sink client
+ */
+bool Universe::AddSinkClient(Client *client,
+                             const SinkClientOptions &options) {
+  SinkClientState *state = STLFindOrNull(m_sink_clients, client);
+  if (state) {
+    state->options = options;
+    state->sent = false;
     return false;
   }
 
+  STLInsertIfNotPresent(&m_sink_clients, client, new SinkClientState(options));
+
   OLA_INFO << "Added sink client, " << client << " to universe "
            << m_universe_id;
 
@@ -351,9 +480,11 @@ bool Universe::AddSinkClient(Client *client) {
  * @return true is this client was removed, false if it didn't exist
  */
 bool Universe::RemoveSinkClient(Client *client) {
-  if (!STLRemove(&m_sink_clients, client)) {
+  SinkClientState *state = STLLookupAndRemovePtr(&m_sink_clients, client);
+  if (!state) {
     return false;
   }
+  RemoveSinkClientState(state);
 
   SafeDecrement(K_UNIVERSE_SINK_CLIENTS_VAR);
 
@@ -501,15 +632,14 @@ void Universe::SendRDMRequest(RDMRequest *request_ptr,
       }
     }
   } else {
-    map<UID, OutputPort*>::iterator iter =
-        m_output_uids.find(request->DestinationUID());
+    OutputPort **port = m_output_uids.Find(request->DestinationUID());
 
-    if (iter == m_output_uids.end()) {
+    if (!port) {
       OLA_WARN << "Can't find UID " << request->DestinationUID()
                << " in the output universe map, dropping request";
       RunRDMCallback(callback, ola::rdm::RDM_UNKNOWN_UID);
     } else {
-      iter->second->SendRDMRequest(request.release(), callback);
+      (*port)->SendRDMRequest(request.release(), callback);
     }
   }
 }
@@ -564,28 +694,21 @@ void Universe::RunRDMDiscovery(RDMDiscoveryCallback *on_complete, bool full) {
  * Update the UID : port mapping with this new data
  */
 void Universe::NewUIDList(OutputPort *port, const ola::rdm::UIDSet &uids) {
-  map<UID, OutputPort*>::iterator iter = m_output_uids.begin();
-  while (iter != m_output_uids.end()) {
-    if (iter->second == port && !uids.Contains(iter->first)) {
-      m_output_uids.erase(iter++);
-    } else {
-      ++iter;
-    }
-  }
+  m_discovery_generation++;
+  m_output_uids.RemoveIf(UIDMissingFromPort(port, uids));
 
   ola::rdm::UIDSet::Iterator set_iter = uids.Begin();
   for (; set_iter != uids.End(); ++set_iter) {
-    iter = m_output_uids.find(*set_iter);
-    if (iter == m_output_uids.end()) {
-      m_output_uids[*set_iter] = port;
-    } else if (iter->second != port) {
+    OutputPort **existing_port = m_output_uids.Find(*set_iter);
+    if (existing_port && *existing_port != port) {
       OLA_WARN << "UID " << *set_iter << " seen on more than one port";
     }
   }
+  m_output_uids.AddUIDs(uids, port);
 
   if (m_export_map) {
     (*m_export_map->GetUIntMapVar(K_UNIVERSE_UID_COUNT_VAR))[m_universe_id_str]
-        = m_output_uids.size();
+        = m_output_uids.Size();
   }
 }
 
@@ -594,9 +717,20 @@ void Universe::NewUIDList(OutputPort *port, const ola::rdm::UIDSet &uids) {
  * Returns the complete UIDSet for this universe
  */
 void Universe::GetUIDs(ola::rdm::UIDSet *uids) const {
-  map<UID, OutputPort*>::const_iterator iter = m_output_uids.begin();
-  for (; iter != m_output_uids.end(); ++iter) {
-    uids->AddUID(iter->first);
+  m_output_uids.GetUIDs(uids);
+}
+
+
+/*
+ * Returns the UIDs that were discovered on a particular output port
+ */
+void Universe::GetPortUIDs(const OutputPort *port,
+                           ola::rdm::UIDSet *uids) const {
+  ola::rdm::UIDMap<OutputPort*>::ConstIterator iter = m_output_uids.Begin();
+  for (; iter != m_output_uids.End(); ++iter) {
+    if (iter->value == port) {
+      uids->AddUID(iter->Uid());
+    }
   }
 }
 
@@ -605,7 +739,7 @@ void Universe::GetUIDs(ola::rdm::UIDSet *uids) const {
  * Return the number of uids in the universe
  */
 unsigned int Universe::UIDCount() const {
-  return m_output_uids.size();
+  return m_output_uids.Size();
 }
 
 /**
@@ -634,19 +768,24 @@ bool Universe::IsActive() const {
  * updates everyone who needs to know (patched ports and network clients)
  */
 bool Universe::UpdateDependants() {
-  vector<OutputPort*>::const_iterator iter;
-  set<Client*>::const_iterator client_iter;
-
-  // write to all ports assigned to this universe
-  for (iter = m_output_ports.begin(); iter != m_output_ports.end(); ++iter) {
-    (*iter)->WriteDMX(m_buffer, m_active_priority);
+  SinkClientMap::const_iterator client_iter;
+
+  // write to all ports assigned to this universe, or wait for the rest of
+  // the sync group.
+  if (m_sync_group && m_universe_store && !m_output_ports.empty()) {
+    if (!m_sync_frame_pending) {
+      m_sync_frame_pending = true;
+      m_universe_store->SyncFrameReady(this);
+    }
+  } else {
+    WriteOutputPorts();
   }
 
   // write to all clients
   for (client_iter = m_sink_clients.begin();
        client_iter != m_sink_clients.end();
        ++client_iter) {
-    (*client_iter)->SendDMX(m_universe_id, m_active_priority, m_buffer);
+    UpdateSinkClient(client_iter->first, client_iter->second);
   }
 
   SafeIncrement(K_FPS_VAR);
@@ -654,6 +793,221 @@ bool Universe::UpdateDependants() {
 }
 
 
+void Universe::WriteOutputPorts() {
+  vector<OutputPort*>::const_iterator iter;
+  for (iter = m_output_ports.begin(); iter != m_output_ports.end(); ++iter) {
+    if ((*iter)->MaxFrameRate() || (*iter)->RefreshInterval()) {
+      WriteRateLimitedPort(*iter);
+    } else {
+      (*iter)->WriteDMX(m_buffer, m_active_priority);
+    }
+  }
+}
+
+
+/*
+ * Send the latest data to a sink client, subject to its options.
+ */
+void Universe::UpdateSinkClient(Client *client, SinkClientState *state) {
+  const SinkClientOptions &options = state->options;
+  if (!(options.start_slot || options.slot_count || options.max_rate ||
+        options.changes_only)) {
+    client->SendDMX(m_universe_id, m_active_priority, m_buffer);
+    return;
+  }
+
+  if (state->timeout != ola::thread::INVALID_TIMEOUT) {
+    // An update is already scheduled, it'll send the latest data.
+    return;
+  }
+
+  if (options.max_rate && state->sent) {
+    TimeStamp now;
+    m_clock->CurrentMonotonicTime(&now);
+    TimeStamp next_update = state->last_update + TimeInterval(
+        static_cast<int64_t>(USEC_IN_SECONDS / options.max_rate));
+    if (now < next_update) {
+      if (m_scheduler) {
+        state->timeout = m_scheduler->RegisterSingleTimeout(
+            next_update - now,
+            NewSingleCallback(this, &Universe::SendPendingSinkClientUpdate,
+                              client));
+      }
+      return;
+    }
+  }
+  SendSinkClientUpdate(client, state);
+}
+
+
+/*
+ * Send the selected slots to a sink client.
+ */
+void Universe::SendSinkClientUpdate(Client *client, SinkClientState *state) {
+  const SinkClientOptions &options = state->options;
+  DmxBuffer data;
+  if (options.start_slot || options.slot_count) {
+    if (options.start_slot < m_buffer.Size()) {
+      unsigned int length = m_buffer.Size() - options.start_slot;
+      if (options.slot_count) {
+        length = std::min(length, options.slot_count);
+      }
+      data.Set(m_buffer.GetRaw() + options.start_slot, length);
+    }
+  } else {
+    data = m_buffer;
+  }
+
+  if (options.changes_only && state->sent && data == state->last_data) {
+    return;
+  }
+
+  state->sent = true;
+  state->last_data = data;
+  m_clock->CurrentMonotonicTime(&state->last_update);
+  client->SendDMX(m_universe_id, m_active_priority, data, options.start_slot);
+}
+
+
+/*
+ * Called when the rate limit interval for a sink client has passed.
+ */
+void Universe::SendPendingSinkClientUpdate(Client *client) {
+  SinkClientState *state = STLFindOrNull(m_sink_clients, client);
+  if (!state) {
+    return;
+  }
+  state->timeout = ola::thread::INVALID_TIMEOUT;
+  SendSinkClientUpdate(client, state);
+}
+
+
+/*
+ * Write the latest data to an output port, subject to its frame rate limits.
+ */
+void Universe::WriteRateLimitedPort(OutputPort *port) {
+  OutputPortState *state = STLFindOrNull(m_output_port_state, port);
+  if (!state) {
+    state = new OutputPortState();
+    m_output_port_state[port] = state;
+    if (port->RefreshInterval() && m_scheduler) {
+      state->refresh = m_scheduler->RegisterRepeatingTimeout(
+          port->RefreshInterval(),
+          NewCallback(this, &Universe::RefreshOutputPort, port));
+    }
+  }
+
+  if (state->pending != ola::thread::INVALID_TIMEOUT) {
+    // A write is already scheduled, it'll use the latest data.
+    return;
+  }
+
+  if (port->MaxFrameRate() && state->written) {
+    TimeStamp now;
+    m_clock->CurrentMonotonicTime(&now);
+    TimeStamp next_write = state->last_write + TimeInterval(
+        static_cast<int64_t>(USEC_IN_SECONDS / port->MaxFrameRate()));
+    if (now < next_write) {
+      if (m_scheduler) {
+        state->pending = m_scheduler->RegisterSingleTimeout(
+            next_write - now,
+            NewSingleCallback(this, &Universe::WritePendingFrame, port));
+      }
+      return;
+    }
+  }
+  WriteOutputPort(port, state);
+}
+
+
+void Universe::WriteOutputPort(OutputPort *port, OutputPortState *state) {
+  state->written = true;
+  m_clock->CurrentMonotonicTime(&state->last_write);
+  port->WriteDMX(m_buffer, m_active_priority);
+}
+
+
+/*
+ * Called when the rate limit interval for an output port has passed.
+ */
+void Universe::WritePendingFrame(OutputPort *port) {
+  OutputPortState *state = STLFindOrNull(m_output_port_state, port);
+  if (!state) {
+    return;
+  }
+  state->pending = ola::thread::INVALID_TIMEOUT;
+  WriteOutputPort(port, state);
+}
+
+
+/*
+ * Write the last frame again if nothing has been written to the port
+ * recently.
+ */
+bool Universe::RefreshOutputPort(OutputPort *port) {
+  OutputPortState *state = STLFindOrNull(m_output_port_state, port);
+  if (!state || !state->written ||
+      state->pending != ola::thread::INVALID_TIMEOUT) {
+    return true;
+  }
+
+  TimeStamp now;
+  m_clock->CurrentMonotonicTime(&now);
+  if (now - state->last_write >=
+      TimeInterval(static_cast<int64_t>(port->RefreshInterval()) * 1000)) {
+    WriteOutputPort(port, state);
+  }
+  return true;
+}
+
+
+void Universe::OutputPortFrameRateChanged(OutputPort *port) {
+  // The state is re-created with the new limits on the next write.
+  OutputPortState *state = STLFindOrNull(m_output_port_state, port);
+  bool frame_pending = state && state->pending != ola::thread::INVALID_TIMEOUT;
+  RemoveOutputPortState(port);
+
+  if (frame_pending) {
+    if (port->MaxFrameRate() || port->RefreshInterval()) {
+      WriteRateLimitedPort(port);
+    } else {
+      port->WriteDMX(m_buffer, m_active_priority);
+    }
+  }
+}
+
+
+/*
+ * Cancel any timers and delete the state for an output port.
+ */
+void Universe::RemoveOutputPortState(OutputPort *port) {
+  OutputPortState *state = STLLookupAndRemovePtr(&m_output_port_state, port);
+  if (!state) {
+    return;
+  }
+  if (m_scheduler) {
+    if (state->pending != ola::thread::INVALID_TIMEOUT) {
+      m_scheduler->RemoveTimeout(state->pending);
+    }
+    if (state->refresh != ola::thread::INVALID_TIMEOUT) {
+      m_scheduler->RemoveTimeout(state->refresh);
+    }
+  }
+  delete state;
+}
+
+
+/*
+ * Cancel any scheduled update and delete the state for a sink client.
+ */
+void Universe::RemoveSinkClientState(SinkClientState *state) {
+  if (state->timeout != ola::thread::INVALID_TIMEOUT && m_scheduler) {
+    m_scheduler->RemoveTimeout(state->timeout);
+  }
+  delete state;
+}
+
+
 /*
  * Update the name in the export map.
  */
@@ -938,7 +1292,7 @@ bool Universe::GenericAddPort(PortClass *port, vector<PortClass*> *ports) {
 template<class PortClass>
 bool Universe::GenericRemovePort(PortClass *port,
                                  vector<PortClass*> *ports,
-                                 map<UID, PortClass*> *uid_map) {
+                                 ola::rdm::UIDMap<PortClass*> *uid_map) {
   typename vector<PortClass*>::iterator iter =
     find(ports->begin(), ports->end(), port);
 
@@ -962,14 +1316,7 @@ bool Universe::GenericRemovePort(PortClass *port,
 
   // Remove any uids that mapped to this port
   if (uid_map) {
-    typename map<UID, PortClass*>::iterator uid_iter = uid_map->begin();
-    while (uid_iter != uid_map->end()) {
-      if (uid_iter->second == port) {
-        uid_map->erase(uid_iter++);
-      } else {
-        ++uid_iter;
-      }
-    }
+    uid_map->RemoveIf(UIDOnPort<PortClass>(port));
   }
   return true;
 }
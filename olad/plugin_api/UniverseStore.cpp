@@ -32,22 +32,41 @@
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
 #include "ola/stl/STLUtils.h"
+#include "ola/strings/Format.h"
+#include "olad/Port.h"
 #include "olad/Preferences.h"
 #include "olad/Universe.h"
 
 namespace ola {
 
+using std::map;
 using std::pair;
 using std::set;
 using std::string;
 using std::vector;
 
 const unsigned int UniverseStore::MINIMUM_RDM_DISCOVERY_INTERVAL = 30;
+// Two frames at 40 fps.
+const unsigned int UniverseStore::SYNC_GROUP_TIMEOUT_MS = 50;
+
+/*
+ * The universes in a sync group.
+ */
+class UniverseStore::SyncGroup {
+ public:
+  SyncGroup() : timeout(ola::thread::INVALID_TIMEOUT) {}
+
+  // ordered by universe id so the frames are written in order
+  map<unsigned int, Universe*> universes;
+  ola::thread::timeout_id timeout;
+};
 
 UniverseStore::UniverseStore(Preferences *preferences,
-                             ExportMap *export_map)
+                             ExportMap *export_map,
+                             ola::thread::SchedulerInterface *scheduler)
     : m_preferences(preferences),
-      m_export_map(export_map) {
+      m_export_map(export_map),
+      m_scheduler(scheduler) {
   if (export_map) {
     export_map->GetStringMapVar(Universe::K_UNIVERSE_NAME_VAR, "universe");
     export_map->GetStringMapVar(Universe::K_UNIVERSE_MODE_VAR, "universe");
@@ -69,6 +88,7 @@ UniverseStore::UniverseStore(Preferences *preferences,
 
 UniverseStore::~UniverseStore() {
   DeleteAll();
+  STLDeleteValues(&m_sync_groups);
 }
 
 Universe *UniverseStore::GetUniverse(unsigned int universe_id) const {
@@ -80,7 +100,8 @@ Universe *UniverseStore::GetUniverseOrCreate(unsigned int universe_id) {
       &m_universe_map, universe_id);
 
   if (!iter->second) {
-    iter->second = new Universe(universe_id, this, m_export_map, &m_clock);
+    iter->second = new Universe(universe_id, this, m_export_map, &m_clock,
+                                m_scheduler);
 
     if (iter->second) {
       if (m_preferences) {
@@ -102,6 +123,7 @@ void UniverseStore::DeleteAll() {
 
   for (iter = m_universe_map.begin(); iter != m_universe_map.end(); iter++) {
     SaveUniverseSettings(iter->second);
+    RemoveFromSyncGroup(iter->second, iter->second->SyncGroup());
     delete iter->second;
   }
   m_deletion_candidates.clear();
@@ -120,6 +142,7 @@ void UniverseStore::GarbageCollectUniverses() {
        iter != m_deletion_candidates.end(); iter++) {
     if (!(*iter)->IsActive()) {
       SaveUniverseSettings(*iter);
+      RemoveFromSyncGroup(*iter, (*iter)->SyncGroup());
       m_universe_map.erase((*iter)->UniverseId());
       delete *iter;
     }
@@ -127,6 +150,137 @@ void UniverseStore::GarbageCollectUniverses() {
   m_deletion_candidates.clear();
 }
 
+void UniverseStore::SyncGroupChanged(Universe *universe,
+                                     unsigned int old_sync_group) {
+  if (old_sync_group) {
+    RemoveFromSyncGroup(universe, old_sync_group);
+    // The remaining universes may have been waiting on this one.
+    SyncGroup *group = STLFindOrNull(m_sync_groups, old_sync_group);
+    if (group && SyncGroupComplete(group)) {
+      ReleaseSyncGroup(old_sync_group);
+    }
+  }
+
+  if (universe->SyncGroup()) {
+    SyncGroup *group = STLFindOrNull(m_sync_groups, universe->SyncGroup());
+    if (!group) {
+      group = new SyncGroup();
+      m_sync_groups[universe->SyncGroup()] = group;
+    }
+    group->universes[universe->UniverseId()] = universe;
+  }
+}
+
+void UniverseStore::SyncFrameReady(Universe *universe) {
+  SyncGroup *group = STLFindOrNull(m_sync_groups, universe->SyncGroup());
+  if (!group) {
+    OLA_WARN << "Universe " << universe->UniverseId()
+             << " isn't in sync group " << universe->SyncGroup();
+    universe->WriteSyncedFrame();
+    return;
+  }
+
+  if (SyncGroupComplete(group)) {
+    ReleaseSyncGroup(universe->SyncGroup());
+  } else if (m_scheduler && group->timeout == ola::thread::INVALID_TIMEOUT) {
+    group->timeout = m_scheduler->RegisterSingleTimeout(
+        SYNC_GROUP_TIMEOUT_MS,
+        NewSingleCallback(this, &UniverseStore::SyncGroupTimeout,
+                          universe->SyncGroup()));
+  }
+}
+
+
+/*
+ * Remove a universe from a sync group, this doesn't release the group.
+ */
+void UniverseStore::RemoveFromSyncGroup(Universe *universe,
+                                        unsigned int sync_group) {
+  SyncGroupMap::iterator iter = m_sync_groups.find(sync_group);
+  if (iter == m_sync_groups.end()) {
+    return;
+  }
+
+  SyncGroup *group = iter->second;
+  group->universes.erase(universe->UniverseId());
+  if (group->universes.empty()) {
+    if (group->timeout != ola::thread::INVALID_TIMEOUT) {
+      m_scheduler->RemoveTimeout(group->timeout);
+    }
+    delete group;
+    m_sync_groups.erase(iter);
+  }
+}
+
+
+/*
+ * Check if every universe with output ports and a source has a frame
+ * pending. Universes without an input port or source client never get a
+ * frame, so they aren't waited for.
+ */
+bool UniverseStore::SyncGroupComplete(const SyncGroup *group) const {
+  bool frame_pending = false;
+  map<unsigned int, Universe*>::const_iterator iter = group->universes.begin();
+  for (; iter != group->universes.end(); ++iter) {
+    const Universe *universe = iter->second;
+    if (universe->SyncFramePending()) {
+      frame_pending = true;
+    } else if (universe->OutputPortCount() &&
+               (universe->InputPortCount() || universe->SourceClientCount())) {
+      return false;
+    }
+  }
+  return frame_pending;
+}
+
+void UniverseStore::SyncGroupTimeout(unsigned int sync_group) {
+  SyncGroup *group = STLFindOrNull(m_sync_groups, sync_group);
+  if (group) {
+    group->timeout = ola::thread::INVALID_TIMEOUT;
+    ReleaseSyncGroup(sync_group);
+  }
+}
+
+
+/*
+ * Write the pending frames for a sync group, then send a sync message using
+ * one output port from each device.
+ */
+void UniverseStore::ReleaseSyncGroup(unsigned int sync_group) {
+  SyncGroup *group = STLFindOrNull(m_sync_groups, sync_group);
+  if (!group) {
+    return;
+  }
+
+  if (group->timeout != ola::thread::INVALID_TIMEOUT) {
+    m_scheduler->RemoveTimeout(group->timeout);
+    group->timeout = ola::thread::INVALID_TIMEOUT;
+  }
+
+  map<AbstractDevice*, OutputPort*> sync_ports;
+  map<unsigned int, Universe*>::const_iterator iter = group->universes.begin();
+  for (; iter != group->universes.end(); ++iter) {
+    Universe *universe = iter->second;
+    if (!universe->SyncFramePending()) {
+      continue;
+    }
+    universe->WriteSyncedFrame();
+
+    vector<OutputPort*> ports;
+    universe->OutputPorts(&ports);
+    vector<OutputPort*>::const_iterator port_iter = ports.begin();
+    for (; port_iter != ports.end(); ++port_iter) {
+      STLInsertIfNotPresent(&sync_ports, (*port_iter)->GetDevice(),
+                            *port_iter);
+    }
+  }
+
+  map<AbstractDevice*, OutputPort*>::iterator port_iter = sync_ports.begin();
+  for (; port_iter != sync_ports.end(); ++port_iter) {
+    port_iter->second->SendSync(sync_group);
+  }
+}
+
 
 /*
  * Restore a universe's settings
@@ -159,6 +313,20 @@ bool UniverseStore::RestoreUniverseSettings(Universe *universe) const {
       universe->SetMergeMode(Universe::MERGE_LTP);
   }
 
+  // load sync group
+  key = "uni_" + oss.str() + "_sync_group";
+  value = m_preferences->GetValue(key);
+
+  if (!value.empty()) {
+    unsigned int sync_group;
+    if (StringToInt(value, &sync_group, true)) {
+      universe->SetSyncGroup(sync_group);
+    } else {
+      OLA_WARN << "Invalid sync group for universe " <<
+        universe->UniverseId() << ", value was " << value;
+    }
+  }
+
   // load RDM discovery interval
   key = "uni_" + oss.str() + "_rdm_discovery_interval";
   value = m_preferences->GetValue(key);
@@ -207,6 +375,15 @@ bool UniverseStore::SaveUniverseSettings(Universe *universe) const {
   mode = (universe->MergeMode() == Universe::MERGE_HTP ? "HTP" : "LTP");
   m_preferences->SetValue(key, mode);
 
+  // save sync group
+  key = "uni_" + oss.str() + "_sync_group";
+  if (universe->SyncGroup()) {
+    m_preferences->SetValue(key,
+                            strings::IntToString(universe->SyncGroup()));
+  } else {
+    m_preferences->RemoveValue(key);
+  }
+
   // We don't save the RDM Discovery interval since it can only be set in the
   // config files for now.
 
@@ -28,6 +28,7 @@
 
 #include "ola/Clock.h"
 #include "ola/base/Macro.h"
+#include "ola/thread/SchedulerInterface.h"
 
 namespace ola {
 
@@ -42,8 +43,10 @@ class UniverseStore {
    * @brief Create a new UniverseStore.
    * @param preferences The Preferences store.
    * @param export_map the ExportMap to use for stats, may be NULL.
+   * @param scheduler the scheduler to pass to new universes, may be NULL.
    */
-  UniverseStore(class Preferences *preferences, class ExportMap *export_map);
+  UniverseStore(class Preferences *preferences, class ExportMap *export_map,
+                ola::thread::SchedulerInterface *scheduler = NULL);
 
   /**
    * @brief Destructor.
@@ -92,20 +95,49 @@ class UniverseStore {
    */
   void GarbageCollectUniverses();
 
+  /**
+   * @brief Called by a Universe when its sync group changes.
+   * @param universe the Universe, SyncGroup() returns the new group.
+   * @param old_sync_group the previous sync group, or 0.
+   */
+  void SyncGroupChanged(Universe *universe, unsigned int old_sync_group);
+
+  /**
+   * @brief Called by a Universe when it has a frame for its sync group.
+   * @param universe the Universe with the pending frame.
+   *
+   * The frames are written once every universe in the group with output
+   * ports has a frame pending. If a scheduler was provided, the frames are
+   * also written if the rest of the group hasn't caught up within
+   * SYNC_GROUP_TIMEOUT_MS.
+   */
+  void SyncFrameReady(Universe *universe);
+
  private:
   typedef std::map<unsigned int, Universe*> UniverseMap;
 
+  class SyncGroup;
+  typedef std::map<unsigned int, SyncGroup*> SyncGroupMap;
+
   Preferences *m_preferences;
   ExportMap *m_export_map;
+  ola::thread::SchedulerInterface *m_scheduler;
   UniverseMap m_universe_map;
   std::set<Universe*> m_deletion_candidates;  // list of universes we may be
                                               // able to delete
+  SyncGroupMap m_sync_groups;
   Clock m_clock;
 
   bool RestoreUniverseSettings(Universe *universe) const;
   bool SaveUniverseSettings(Universe *universe) const;
 
+  void RemoveFromSyncGroup(Universe *universe, unsigned int sync_group);
+  bool SyncGroupComplete(const SyncGroup *group) const;
+  void SyncGroupTimeout(unsigned int sync_group);
+  void ReleaseSyncGroup(unsigned int sync_group);
+
   static const unsigned int MINIMUM_RDM_DISCOVERY_INTERVAL;
+  static const unsigned int SYNC_GROUP_TIMEOUT_MS;
 
   DISALLOW_COPY_AND_ASSIGN(UniverseStore);
 };
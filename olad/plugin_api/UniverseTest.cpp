@@ -27,6 +27,7 @@
 #include "ola/Constants.h"
 #include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
+#include "ola/base/Array.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMReply.h"
 #include "ola/rdm/RDMResponseCodes.h"
@@ -71,9 +72,12 @@ class UniverseTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testLifecycle);
   CPPUNIT_TEST(testSetGetDmx);
   CPPUNIT_TEST(testSendDmx);
+  CPPUNIT_TEST(testFrameRateLimit);
+  CPPUNIT_TEST(testSyncGroup);
   CPPUNIT_TEST(testReceiveDmx);
   CPPUNIT_TEST(testSourceClients);
   CPPUNIT_TEST(testSinkClients);
+  CPPUNIT_TEST(testSinkClientOptions);
   CPPUNIT_TEST(testLtpMerging);
   CPPUNIT_TEST(testHtpMerging);
   CPPUNIT_TEST(testRDMDiscovery);
@@ -86,9 +90,12 @@ class UniverseTest: public CppUnit::TestFixture {
   void testLifecycle();
   void testSetGetDmx();
   void testSendDmx();
+  void testFrameRateLimit();
+  void testSyncGroup();
   void testReceiveDmx();
   void testSourceClients();
   void testSinkClients();
+  void testSinkClientOptions();
   void testLtpMerging();
   void testHtpMerging();
   void testRDMDiscovery();
@@ -124,7 +131,7 @@ class MockClient: public ola::Client {
   }
 
   bool SendDMX(unsigned int universe_id, uint8_t priority,
-               const DmxBuffer &buffer) {
+               const DmxBuffer &buffer, unsigned int) {
     OLA_ASSERT_EQ(TEST_UNIVERSE, universe_id);
     OLA_ASSERT_EQ(ola::dmx::SOURCE_PRIORITY_MIN, priority);
     OLA_ASSERT_EQ(string(TEST_DATA), buffer.Get());
@@ -135,6 +142,31 @@ class MockClient: public ola::Client {
 };
 
 
+/*
+ * A client that records the updates it's sent.
+ */
+class RecordingClient: public ola::Client {
+ public:
+  RecordingClient()
+      : ola::Client(NULL, UID(ola::OPEN_LIGHTING_ESTA_CODE, 0)),
+        updates(0),
+        last_start_slot(0) {
+  }
+
+  bool SendDMX(unsigned int, uint8_t, const DmxBuffer &buffer,
+               unsigned int start_slot) {
+    updates++;
+    last_data = buffer;
+    last_start_slot = start_slot;
+    return true;
+  }
+
+  unsigned int updates;
+  DmxBuffer last_data;
+  unsigned int last_start_slot;
+};
+
+
 CPPUNIT_TEST_SUITE_REGISTRATION(UniverseTest);
 
 
@@ -233,6 +265,100 @@ void UniverseTest::testSendDmx() {
 }
 
 
+/*
+ * Check that the frame rate limits on output ports are respected.
+ */
+void UniverseTest::testFrameRateLimit() {
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+
+  TestMockOutputPort port(NULL, 1);  // output port
+  port.SetFrameRateLimits(1, 0);
+  OLA_ASSERT_EQ(1u, port.MaxFrameRate());
+  OLA_ASSERT_EQ(0u, port.RefreshInterval());
+  universe->AddPort(&port);
+
+  // the first frame is written immediately
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT_DMX_EQUALS(m_buffer, port.ReadDMX());
+
+  // without a scheduler, frames within the interval are dropped
+  DmxBuffer other_buffer("abc");
+  OLA_ASSERT(universe->SetDMX(other_buffer));
+  OLA_ASSERT_DMX_EQUALS(m_buffer, port.ReadDMX());
+
+  // removing the limits means frames are written straight away
+  port.SetFrameRateLimits(0, 0);
+  universe->OutputPortFrameRateChanged(&port);
+  OLA_ASSERT(universe->SetDMX(other_buffer));
+  OLA_ASSERT_DMX_EQUALS(other_buffer, port.ReadDMX());
+
+  universe->RemovePort(&port);
+}
+
+
+/*
+ * Check that the universes in a sync group are written together.
+ */
+void UniverseTest::testSyncGroup() {
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  Universe *universe2 = m_store->GetUniverseOrCreate(TEST_UNIVERSE + 1);
+  Universe *universe3 = m_store->GetUniverseOrCreate(TEST_UNIVERSE + 2);
+  OLA_ASSERT(universe);
+  OLA_ASSERT(universe2);
+  OLA_ASSERT(universe3);
+
+  MockDevice device(NULL, "foo");
+  TestMockOutputPort port(&device, 1);
+  TestMockOutputPort port2(&device, 2);
+  TestMockOutputPort port3(&device, 3);
+  universe->AddPort(&port);
+  universe2->AddPort(&port2);
+  universe3->AddPort(&port3);
+  MockClient client;
+  universe->AddSourceClient(&client);
+  universe2->AddSourceClient(&client);
+
+  universe->SetSyncGroup(5);
+  universe2->SetSyncGroup(5);
+  // universe3 doesn't have a source so it's not waited for
+  universe3->SetSyncGroup(5);
+  OLA_ASSERT_EQ(5u, universe->SyncGroup());
+
+  // the first frame is held until the rest of the group has a frame
+  DmxBuffer empty_buffer;
+  OLA_ASSERT(universe->SetDMX(m_buffer));
+  OLA_ASSERT(universe->SyncFramePending());
+  OLA_ASSERT_DMX_EQUALS(empty_buffer, port.ReadDMX());
+
+  DmxBuffer other_buffer("abc");
+  OLA_ASSERT(universe2->SetDMX(other_buffer));
+  OLA_ASSERT_FALSE(universe->SyncFramePending());
+  OLA_ASSERT_FALSE(universe2->SyncFramePending());
+  OLA_ASSERT_DMX_EQUALS(m_buffer, port.ReadDMX());
+  OLA_ASSERT_DMX_EQUALS(other_buffer, port2.ReadDMX());
+  // one sync per device
+  OLA_ASSERT_EQ(1u, port.SyncCount() + port2.SyncCount());
+
+  // leaving the group releases the rest of the group
+  OLA_ASSERT(universe->SetDMX(other_buffer));
+  OLA_ASSERT_DMX_EQUALS(m_buffer, port.ReadDMX());
+  universe2->SetSyncGroup(0);
+  OLA_ASSERT_DMX_EQUALS(other_buffer, port.ReadDMX());
+  OLA_ASSERT_EQ(2u, port.SyncCount() + port2.SyncCount());
+
+  // universe2 is no longer synchronized
+  OLA_ASSERT(universe2->SetDMX(m_buffer));
+  OLA_ASSERT_DMX_EQUALS(m_buffer, port2.ReadDMX());
+
+  universe->RemoveSourceClient(&client);
+  universe2->RemoveSourceClient(&client);
+  universe->RemovePort(&port);
+  universe2->RemovePort(&port2);
+  universe3->RemovePort(&port3);
+}
+
+
 /*
  * Check that we update when ports have new data
  */
@@ -353,6 +479,80 @@ void UniverseTest::testSinkClients() {
 }
 
 
+/*
+ * Check that sink clients only receive the updates they asked for.
+ */
+void UniverseTest::testSinkClientOptions() {
+  Universe *universe = m_store->GetUniverseOrCreate(TEST_UNIVERSE);
+  OLA_ASSERT(universe);
+
+  RecordingClient range_client, changes_client, rate_client;
+  Universe::SinkClientOptions range_options;
+  range_options.start_slot = 5;
+  range_options.slot_count = 4;
+  OLA_ASSERT_TRUE(universe->AddSinkClient(&range_client, range_options));
+
+  Universe::SinkClientOptions changes_options;
+  changes_options.start_slot = 10;
+  changes_options.changes_only = true;
+  OLA_ASSERT_TRUE(universe->AddSinkClient(&changes_client, changes_options));
+
+  Universe::SinkClientOptions rate_options;
+  rate_options.max_rate = 1;
+  OLA_ASSERT_TRUE(universe->AddSinkClient(&rate_client, rate_options));
+  OLA_ASSERT_EQ(3u, universe->SinkClientCount());
+
+  const uint8_t data[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+  DmxBuffer buffer(data, arraysize(data));
+  universe->SetDMX(buffer);
+
+  OLA_ASSERT_EQ(1u, range_client.updates);
+  OLA_ASSERT_EQ(5u, range_client.last_start_slot);
+  OLA_ASSERT_DATA_EQUALS(data + 5, 4, range_client.last_data.GetRaw(),
+                         range_client.last_data.Size());
+  OLA_ASSERT_EQ(1u, changes_client.updates);
+  OLA_ASSERT_EQ(10u, changes_client.last_start_slot);
+  OLA_ASSERT_DATA_EQUALS(data + 10, 3, changes_client.last_data.GetRaw(),
+                         changes_client.last_data.Size());
+  OLA_ASSERT_EQ(1u, rate_client.updates);
+
+  // change a slot outside the changes_client's range
+  buffer.SetChannel(1, 100);
+  universe->SetDMX(buffer);
+  OLA_ASSERT_EQ(2u, range_client.updates);
+  OLA_ASSERT_EQ(1u, changes_client.updates);
+  // less than a second has passed, and there's no scheduler
+  OLA_ASSERT_EQ(1u, rate_client.updates);
+
+  // now change one inside the range
+  buffer.SetChannel(11, 100);
+  universe->SetDMX(buffer);
+  OLA_ASSERT_EQ(3u, range_client.updates);
+  OLA_ASSERT_EQ(2u, changes_client.updates);
+  OLA_ASSERT_EQ(static_cast<uint8_t>(100), changes_client.last_data.Get(1));
+  OLA_ASSERT_EQ(1u, rate_client.updates);
+
+  // re-registering replaces the options
+  OLA_ASSERT_FALSE(universe->AddSinkClient(&rate_client));
+  universe->SetDMX(buffer);
+  OLA_ASSERT_EQ(2u, rate_client.updates);
+  OLA_ASSERT_DMX_EQUALS(buffer, rate_client.last_data);
+  OLA_ASSERT_EQ(0u, rate_client.last_start_slot);
+
+  // a start slot past the end of the universe results in no data
+  Universe::SinkClientOptions empty_options;
+  empty_options.start_slot = 100;
+  universe->AddSinkClient(&range_client, empty_options);
+  universe->SetDMX(buffer);
+  OLA_ASSERT_EQ(5u, range_client.updates);
+  OLA_ASSERT_EQ(0u, range_client.last_data.Size());
+
+  OLA_ASSERT_TRUE(universe->RemoveSinkClient(&range_client));
+  OLA_ASSERT_TRUE(universe->RemoveSinkClient(&changes_client));
+  OLA_ASSERT_TRUE(universe->RemoveSinkClient(&rate_client));
+}
+
+
 /*
  * Check that LTP merging works correctly
  */
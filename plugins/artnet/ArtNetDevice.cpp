@@ -23,6 +23,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -58,17 +59,22 @@ using std::vector;
 
 const char ArtNetDevice::K_ALWAYS_BROADCAST_KEY[] = "always_broadcast";
 const char ArtNetDevice::K_DEVICE_NAME[] = "Art-Net";
+const char ArtNetDevice::K_INPUT_PORT_KEY[] = "input_ports";
 const char ArtNetDevice::K_IP_KEY[] = "ip";
 const char ArtNetDevice::K_LIMITED_BROADCAST_KEY[] = "use_limited_broadcast";
 const char ArtNetDevice::K_LONG_NAME_KEY[] = "long_name";
 const char ArtNetDevice::K_LOOPBACK_KEY[] = "use_loopback";
 const char ArtNetDevice::K_NET_KEY[] = "net";
 const char ArtNetDevice::K_OUTPUT_PORT_KEY[] = "output_ports";
+const char ArtNetDevice::K_RDM_MAX_IN_FLIGHT_KEY[] = "rdm_max_in_flight";
 const char ArtNetDevice::K_SHORT_NAME_KEY[] = "short_name";
 const char ArtNetDevice::K_SUBNET_KEY[] = "subnet";
+const char ArtNetDevice::K_UNIVERSE_OFFSET_KEY[] = "universe_offset";
 const unsigned int ArtNetDevice::K_ARTNET_NET = 0;
 const unsigned int ArtNetDevice::K_ARTNET_SUBNET = 0;
+const unsigned int ArtNetDevice::K_DEFAULT_INPUT_PORT_COUNT = 4;
 const unsigned int ArtNetDevice::K_DEFAULT_OUTPUT_PORT_COUNT = 4;
+const unsigned int ArtNetDevice::K_DEFAULT_RDM_MAX_IN_FLIGHT = 1;
 
 ArtNetDevice::ArtNetDevice(AbstractPlugin *owner,
                            ola::Preferences *preferences,
@@ -108,6 +114,13 @@ bool ArtNetDevice::StartHook() {
   node_options.input_port_count = StringToIntOrDefault(
       m_preferences->GetValue(K_OUTPUT_PORT_KEY),
       K_DEFAULT_OUTPUT_PORT_COUNT);
+  // OLA Input ports are Art-Net output ports
+  node_options.output_port_count = StringToIntOrDefault(
+      m_preferences->GetValue(K_INPUT_PORT_KEY),
+      K_DEFAULT_INPUT_PORT_COUNT);
+  node_options.rdm_max_in_flight = StringToIntOrDefault(
+      m_preferences->GetValue(K_RDM_MAX_IN_FLIGHT_KEY),
+      K_DEFAULT_RDM_MAX_IN_FLIGHT);
 
   m_node = new ArtNetNode(iface, m_plugin_adaptor, node_options);
   m_node->SetNetAddress(net);
@@ -115,12 +128,17 @@ bool ArtNetDevice::StartHook() {
   m_node->SetShortName(m_preferences->GetValue(K_SHORT_NAME_KEY));
   m_node->SetLongName(m_preferences->GetValue(K_LONG_NAME_KEY));
 
+  bool universe_offset = m_preferences->GetValueAsBool(
+      K_UNIVERSE_OFFSET_KEY);
   for (unsigned int i = 0; i < node_options.input_port_count; i++) {
-    AddPort(new ArtNetOutputPort(this, i, m_node));
+    AddPort(new ArtNetOutputPort(this, i, m_node, universe_offset));
   }
 
-  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
-    AddPort(new ArtNetInputPort(this, i, m_plugin_adaptor, m_node));
+  unsigned int input_port_count = std::min(node_options.output_port_count,
+                                           m_node->OutputPortCount());
+  for (unsigned int i = 0; i < input_port_count; i++) {
+    AddPort(new ArtNetInputPort(this, i, m_plugin_adaptor, m_node,
+                                universe_offset));
   }
 
   if (!m_node->Start()) {
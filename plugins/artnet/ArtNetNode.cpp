@@ -35,6 +35,7 @@
 #include "ola/network/SocketAddress.h"
 #include "ola/rdm/RDMCommandSerializer.h"
 #include "ola/rdm/RDMEnums.h"
+#include "ola/rdm/UIDMap.h"
 #include "ola/stl/STLUtils.h"
 #include "ola/strings/Format.h"
 #include "ola/strings/Utils.h"
@@ -79,7 +80,51 @@ const char ArtNetNodeImpl::ARTNET_ID[] = "Art-Net";
 
 // UID to the IP Address it came from, and the number of times since we last
 // saw it in an ArtTod message.
-typedef map<UID, std::pair<IPV4Address, uint8_t> > uid_map;
+typedef ola::rdm::UIDMap<std::pair<IPV4Address, uint8_t> > uid_map;
+
+namespace {
+// Matches the UIDs from a node that weren't in its latest TOD.
+class MissingFromTod {
+ public:
+  MissingFromTod(const IPV4Address &source, const UIDSet &uids)
+      : m_source(source),
+        m_uids(uids) {
+  }
+
+  bool operator()(const uid_map::Entry &entry) const {
+    return entry.value.first == m_source && !m_uids.Contains(entry.Uid());
+  }
+
+ private:
+  IPV4Address m_source;
+  const UIDSet &m_uids;
+};
+
+// Matches the UIDs that have been missing from too many TODs.
+class MissedTodLimit {
+ public:
+  explicit MissedTodLimit(uint8_t limit) : m_limit(limit) {}
+
+  bool operator()(const uid_map::Entry &entry) const {
+    return entry.value.second == m_limit;
+  }
+
+ private:
+  uint8_t m_limit;
+};
+}  // namespace
+
+// An RDM request we're waiting for a response to.
+struct PendingRDMRequest {
+  const RDMRequest *request;
+  RDMCallback *callback;
+  IPV4Address ip_destination;
+  ola::thread::timeout_id timeout;
+};
+
+// The in-flight RDM requests for a port, keyed by destination UID. There is
+// only ever one request in flight for each UID.
+typedef map<UID, PendingRDMRequest> pending_rdm_map;
 
 // Input ports are ones that send data using Art-Net
 class ArtNetNodeImpl::InputPort {
@@ -89,9 +134,6 @@ class ArtNetNodeImpl::InputPort {
         sequence_number(0),
         discovery_callback(NULL),
         discovery_timeout(ola::thread::INVALID_TIMEOUT),
-        rdm_request_callback(NULL),
-        pending_request(NULL),
-        rdm_send_timeout(ola::thread::INVALID_TIMEOUT),
         m_port_address(0),
         m_tod_callback(NULL) {
   }
@@ -105,25 +147,56 @@ class ArtNetNodeImpl::InputPort {
     }
 
     m_port_address = ((m_port_address & 0xf0) | universe_address);
-    uids.clear();
-    subscribed_nodes.clear();
+    uids.Clear();
+    ClearSubscribedNodes();
     return true;
   }
 
   void ClearSubscribedNodes() {
     subscribed_nodes.clear();
+    subscriber_addresses.clear();
+  }
+
+  // Record that a node is listening to this port's universe.
+  void AddSubscribedNode(const IPV4Address &address, const TimeStamp &now) {
+    if (STLReplace(&subscribed_nodes, address, now)) {
+      return;
+    }
+    subscriber_addresses.push_back(IPV4SocketAddress(address, ARTNET_PORT));
+  }
+
+  // Remove the nodes we haven't heard from since the threshold.
+  void ExpireSubscribedNodes(const TimeStamp &last_heard_threshold) {
+    bool changed = false;
+    map<IPV4Address, TimeStamp>::iterator iter = subscribed_nodes.begin();
+    while (iter != subscribed_nodes.end()) {
+      if (iter->second < last_heard_threshold) {
+        subscribed_nodes.erase(iter++);
+        changed = true;
+      } else {
+        ++iter;
+      }
+    }
+
+    if (changed) {
+      subscriber_addresses.clear();
+      for (iter = subscribed_nodes.begin(); iter != subscribed_nodes.end();
+           ++iter) {
+        subscriber_addresses.push_back(
+            IPV4SocketAddress(iter->first, ARTNET_PORT));
+      }
+    }
   }
 
   // Returns true if the address changed.
-  bool SetSubNetAddress(uint8_t subnet_address) {
-    subnet_address = subnet_address << 4;
-    if (subnet_address == (m_port_address & 0xf0)) {
+  bool SetPortAddress(uint8_t port_address) {
+    if (port_address == m_port_address) {
       return false;
     }
 
-    m_port_address = subnet_address | (m_port_address & 0x0f);
-    uids.clear();
-    subscribed_nodes.clear();
+    m_port_address = port_address;
+    uids.Clear();
+    ClearSubscribedNodes();
     return true;
   }
 
@@ -152,14 +225,17 @@ class ArtNetNodeImpl::InputPort {
   }
 
   void IncrementUIDCounts() {
-    for (uid_map::iterator iter = uids.begin(); iter != uids.end(); ++iter) {
-      iter->second.second++;
+    for (uid_map::Iterator iter = uids.Begin(); iter != uids.End(); ++iter) {
+      iter->value.second++;
     }
   }
 
   bool enabled;
   uint8_t sequence_number;
   map<IPV4Address, TimeStamp> subscribed_nodes;
+  // The addresses of the subscribed nodes, so ArtDmx can be sent to all of
+  // them at once.
+  vector<IPV4SocketAddress> subscriber_addresses;
   uid_map uids;  // used to keep track of the UIDs
   // NULL if discovery isn't running, otherwise the callback to run when it
   // finishes
@@ -168,13 +244,8 @@ class ArtNetNodeImpl::InputPort {
   set<IPV4Address> discovery_node_set;
   // the timeout_id for the discovery timer
   ola::thread::timeout_id discovery_timeout;
-  // the in-flight request and it's callback
-  RDMCallback *rdm_request_callback;
-  const RDMRequest *pending_request;
-  IPV4Address rdm_ip_destination;
-
-  // these control the sending of RDM requests.
-  ola::thread::timeout_id rdm_send_timeout;
+  // the in-flight requests and their callbacks
+  pending_rdm_map pending_requests;
 
  private:
   uint8_t m_port_address;
@@ -185,10 +256,7 @@ class ArtNetNodeImpl::InputPort {
   void RunRDMCallbackWithUIDs(const uid_map &uids,
                               RDMDiscoveryCallback *callback) {
     UIDSet uid_set;
-    uid_map::const_iterator uid_iter = uids.begin();
-    for (; uid_iter != uids.end(); ++uid_iter) {
-      uid_set.AddUID(uid_iter->first);
-    }
+    uids.GetUIDs(&uid_set);
     callback->Run(uid_set);
   }
 };
@@ -199,6 +267,7 @@ ArtNetNodeImpl::ArtNetNodeImpl(const ola::network::Interface &iface,
                                ola::network::UDPSocketInterface *socket)
     : m_running(false),
       m_net_address(0),
+      m_subnet_address(0),
       m_send_reply_on_change(true),
       m_short_name(""),
       m_long_name(""),
@@ -210,6 +279,12 @@ ArtNetNodeImpl::ArtNetNodeImpl(const ola::network::Interface &iface,
       m_in_configuration_mode(false),
       m_artpoll_required(false),
       m_artpollreply_required(false),
+      m_expiry_timeout(ola::thread::INVALID_TIMEOUT),
+      m_output_ports(std::min(
+          std::max(options.output_port_count,
+                   static_cast<unsigned int>(ARTNET_MAX_PORTS)),
+          ARTNET_MAX_OUTPUT_PORTS)),
+      m_sync_timeout(ola::thread::INVALID_TIMEOUT),
       m_interface(iface),
       m_socket(socket) {
 
@@ -222,7 +297,7 @@ ArtNetNodeImpl::ArtNetNodeImpl(const ola::network::Interface &iface,
   }
 
   // reset all the port structures
-  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
+  for (unsigned int i = 0; i < m_output_ports.size(); i++) {
     m_output_ports[i].universe_address = 0;
     m_output_ports[i].sequence_number = 0;
     m_output_ports[i].enabled = false;
@@ -230,6 +305,7 @@ ArtNetNodeImpl::ArtNetNodeImpl(const ola::network::Interface &iface,
     m_output_ports[i].merge_mode = ARTNET_MERGE_HTP;
     m_output_ports[i].buffer = NULL;
     m_output_ports[i].on_data = NULL;
+    m_output_ports[i].sync_pending = false;
     m_output_ports[i].on_discover = NULL;
     m_output_ports[i].on_flush = NULL;
     m_output_ports[i].on_rdm_request = NULL;
@@ -241,7 +317,7 @@ ArtNetNodeImpl::~ArtNetNodeImpl() {
 
   STLDeleteElements(&m_input_ports);
 
-  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
+  for (unsigned int i = 0; i < m_output_ports.size(); i++) {
     if (m_output_ports[i].on_data) {
       delete m_output_ports[i].on_data;
     }
@@ -262,6 +338,9 @@ bool ArtNetNodeImpl::Start() {
     return false;
   }
 
+  m_expiry_timeout = m_ss->RegisterRepeatingTimeout(
+      NODE_EXPIRY_INTERVAL_MS,
+      NewCallback(this, &ArtNetNodeImpl::ExpireSubscribedNodes));
   m_running = true;
   return true;
 }
@@ -285,21 +364,27 @@ bool ArtNetNodeImpl::Stop() {
     port->RunDiscoveryCallback();
 
     // clean up request state
-    if (port->rdm_send_timeout != ola::thread::INVALID_TIMEOUT) {
-      m_ss->RemoveTimeout(port->rdm_send_timeout);
-      port->rdm_send_timeout = ola::thread::INVALID_TIMEOUT;
+    pending_rdm_map pending_requests;
+    pending_requests.swap(port->pending_requests);
+    pending_rdm_map::iterator request_iter = pending_requests.begin();
+    for (; request_iter != pending_requests.end(); ++request_iter) {
+      PendingRDMRequest &pending = request_iter->second;
+      if (pending.timeout != ola::thread::INVALID_TIMEOUT) {
+        m_ss->RemoveTimeout(pending.timeout);
+      }
+      delete pending.request;
+      RunRDMCallback(pending.callback, ola::rdm::RDM_TIMEOUT);
     }
+  }
 
-    if (port->pending_request) {
-      delete port->pending_request;
-      port->pending_request = NULL;
-    }
+  if (m_expiry_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_expiry_timeout);
+    m_expiry_timeout = ola::thread::INVALID_TIMEOUT;
+  }
 
-    if (port->rdm_request_callback) {
-      RDMCallback *callback = port->rdm_request_callback;
-      port->rdm_request_callback = NULL;
-      RunRDMCallback(callback, ola::rdm::RDM_TIMEOUT);
-    }
+  if (m_sync_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_sync_timeout);
+    m_sync_timeout = ola::thread::INVALID_TIMEOUT;
   }
 
   m_ss->RemoveReadDescriptor(m_socket.get());
@@ -377,30 +462,34 @@ bool ArtNetNodeImpl::SetNetAddress(uint8_t net_address) {
 }
 
 bool ArtNetNodeImpl::SetSubnetAddress(uint8_t subnet_address) {
-  // Set for all input ports.
-  bool changed = false;
+  subnet_address = subnet_address & 0x0f;
+  if (m_subnet_address == subnet_address) {
+    return true;
+  }
+
+  // Ports are addressed relative to the subnet, so move them all.
+  uint8_t offset = static_cast<uint8_t>(
+      (subnet_address - m_subnet_address) << 4);
+  m_subnet_address = subnet_address;
+
   bool input_ports_enabled = false;
   vector<InputPort*>::iterator iter = m_input_ports.begin();
   for (; iter != m_input_ports.end(); ++iter) {
     input_ports_enabled |= (*iter)->enabled;
-    changed |= (*iter)->SetSubNetAddress(subnet_address);
+    (*iter)->SetPortAddress(
+        static_cast<uint8_t>((*iter)->PortAddress() + offset));
   }
 
-  if (input_ports_enabled && changed) {
+  if (input_ports_enabled) {
     SendPollIfAllowed();
   }
 
-  // set for all output ports.
-  uint8_t old_address = m_output_ports[0].universe_address >> 4;
-  if (old_address == subnet_address && !changed) {
-    return true;
-  }
-
-  subnet_address = subnet_address << 4;
-  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
-    m_output_ports[i].universe_address = subnet_address |
-        (m_output_ports[i].universe_address & 0x0f);
+  vector<OutputPort>::iterator port_iter = m_output_ports.begin();
+  for (; port_iter != m_output_ports.end(); ++port_iter) {
+    port_iter->universe_address = static_cast<uint8_t>(
+        port_iter->universe_address + offset);
   }
+  UpdateOutputPortMap();
 
   return SendPollReplyIfRequired();
 }
@@ -424,6 +513,21 @@ bool ArtNetNodeImpl::SetInputPortUniverse(uint8_t port_id,
   return true;
 }
 
+bool ArtNetNodeImpl::SetInputPortAddress(uint8_t port_id,
+                                         uint8_t port_address) {
+  InputPort *port = GetInputPort(port_id);
+  if (!port) {
+    return false;
+  }
+
+  port->enabled = true;
+  if (port->SetPortAddress(port_address)) {
+    SendPollIfAllowed();
+    return SendPollReplyIfRequired();
+  }
+  return true;
+}
+
 uint8_t ArtNetNodeImpl::GetInputPortUniverse(uint8_t port_id) const {
   const InputPort *port = GetInputPort(port_id);
   return port ? port->PortAddress() : 0;
@@ -461,6 +565,24 @@ bool ArtNetNodeImpl::SetOutputPortUniverse(uint8_t port_id,
   port->universe_address = (
       (universe_id & 0x0f) | (port->universe_address & 0xf0));
   port->enabled = true;
+  UpdateOutputPortMap();
+  return SendPollReplyIfRequired();
+}
+
+bool ArtNetNodeImpl::SetOutputPortAddress(uint8_t port_id,
+                                          uint8_t port_address) {
+  OutputPort *port = GetOutputPort(port_id);
+  if (!port) {
+    return false;
+  }
+
+  if (port->enabled && port->universe_address == port_address) {
+    return true;
+  }
+
+  port->universe_address = port_address;
+  port->enabled = true;
+  UpdateOutputPortMap();
   return SendPollReplyIfRequired();
 }
 
@@ -478,6 +600,7 @@ void ArtNetNodeImpl::DisableOutputPort(uint8_t port_id) {
   bool was_enabled = port->enabled;
   port->enabled = false;
   if (was_enabled) {
+    UpdateOutputPortMap();
     SendPollReplyIfRequired();
   }
 }
@@ -536,11 +659,12 @@ bool ArtNetNodeImpl::SendDMX(uint8_t port_id, const DmxBuffer &buffer) {
     return true;
   }
 
+  // Only the header and the slots are filled in, the rest of the packet
+  // isn't sent.
   artnet_packet packet;
   PopulatePacketHeader(&packet, ARTNET_DMX);
-  memset(&packet.data.dmx, 0, sizeof(packet.data.dmx));
 
-  packet.data.poll.version = HostToNetwork(ARTNET_VERSION);
+  packet.data.dmx.version = HostToNetwork(ARTNET_VERSION);
   packet.data.dmx.sequence = port->sequence_number;
   packet.data.dmx.physical = port_id;
   packet.data.dmx.universe = port->PortAddress();
@@ -570,20 +694,16 @@ bool ArtNetNodeImpl::SendDMX(uint8_t port_id, const DmxBuffer &buffer) {
         m_interface.bcast_address);
     port->sequence_number++;
   } else {
-    map<IPV4Address, TimeStamp>::iterator iter = port->subscribed_nodes.begin();
-    TimeStamp last_heard_threshold = (
-        *m_ss->WakeUpTime() - TimeInterval(NODE_TIMEOUT, 0));
-    while (iter != port->subscribed_nodes.end()) {
-      // if this node has timed out, remove it from the set
-      if (iter->second < last_heard_threshold) {
-        port->subscribed_nodes.erase(iter++);
-        continue;
-      }
-      sent_ok |= SendPacket(packet, size, iter->first);
-      ++iter;
+    // Nodes that have timed out are removed by ExpireSubscribedNodes().
+    if (!port->subscriber_addresses.empty()) {
+      unsigned int header_size = sizeof(packet) - sizeof(packet.data);
+      sent_ok = m_socket->SendToMany(
+          reinterpret_cast<const uint8_t*>(&packet),
+          header_size + size,
+          port->subscriber_addresses) > 0;
     }
 
-    if (port->subscribed_nodes.empty()) {
+    if (port->subscriber_addresses.empty()) {
       OLA_DEBUG << "Suppressing data transmit due to no active nodes for "
                    "universe "
                 << static_cast<int>(port->PortAddress());
@@ -600,6 +720,23 @@ bool ArtNetNodeImpl::SendDMX(uint8_t port_id, const DmxBuffer &buffer) {
   return sent_ok;
 }
 
+bool ArtNetNodeImpl::SendSync() {
+  artnet_packet packet;
+  PopulatePacketHeader(&packet, ARTNET_SYNC);
+  memset(&packet.data.sync, 0, sizeof(packet.data.sync));
+  packet.data.sync.version = HostToNetwork(ARTNET_VERSION);
+
+  if (!SendPacket(packet,
+                  sizeof(packet.data.sync),
+                  m_use_limited_broadcast_address ?
+                  IPV4Address::Broadcast() :
+                  m_interface.bcast_address)) {
+    OLA_WARN << "Failed to send ArtSync";
+    return false;
+  }
+  return true;
+}
+
 void ArtNetNodeImpl::RunFullDiscovery(uint8_t port_id,
                                       RDMDiscoveryCallback *callback) {
   InputPort *port = GetEnabledInputPort(port_id, "ArtTodControl");
@@ -671,38 +808,38 @@ void ArtNetNodeImpl::SendRDMRequest(uint8_t port_id,
     return;
   }
 
-  if (port->rdm_request_callback) {
-    OLA_FATAL << "Previous request hasn't completed yet, dropping request";
+  const UID uid_destination = request->DestinationUID();
+  if (STLContains(port->pending_requests, uid_destination)) {
+    OLA_FATAL << "Previous request to " << uid_destination
+              << " hasn't completed yet, dropping request";
     RunRDMCallback(on_complete, ola::rdm::RDM_FAILED_TO_SEND);
     return;
   }
 
-  port->rdm_ip_destination = m_interface.bcast_address;
-  const UID &uid_destination = request->DestinationUID();
-  uid_map::const_iterator iter = port->uids.find(uid_destination);
-  if (iter == port->uids.end()) {
+  IPV4Address ip_destination = m_interface.bcast_address;
+  const std::pair<IPV4Address, uint8_t> *uid_entry =
+      port->uids.Find(uid_destination);
+  if (!uid_entry) {
     if (!uid_destination.IsBroadcast()) {
       OLA_WARN << "Couldn't find " << uid_destination
                << " in the uid map, broadcasting packet";
     }
   } else {
-    port->rdm_ip_destination = iter->second.first;
+    ip_destination = uid_entry->first;
   }
 
-  port->rdm_request_callback = on_complete;
-  port->pending_request = request.release();
-  bool r = SendRDMCommand(*port->pending_request,
-                          port->rdm_ip_destination,
-                          port->PortAddress());
+  bool r = SendRDMCommand(*request, ip_destination, port->PortAddress());
 
   if (r && !uid_destination.IsBroadcast()) {
-    port->rdm_send_timeout = m_ss->RegisterSingleTimeout(
+    PendingRDMRequest &pending = port->pending_requests[uid_destination];
+    pending.request = request.release();
+    pending.callback = on_complete;
+    pending.ip_destination = ip_destination;
+    pending.timeout = m_ss->RegisterSingleTimeout(
       RDM_REQUEST_TIMEOUT_MS,
-      ola::NewSingleCallback(this, &ArtNetNodeImpl::TimeoutRDMRequest, port));
+      ola::NewSingleCallback(this, &ArtNetNodeImpl::TimeoutRDMRequest, port,
+                             uid_destination));
   } else {
-    delete port->pending_request;
-    port->pending_request = NULL;
-    port->rdm_request_callback = NULL;
     RunRDMCallback(
         on_complete,
         uid_destination.IsBroadcast() ? ola::rdm::RDM_WAS_BROADCAST :
@@ -748,7 +885,7 @@ bool ArtNetNodeImpl::SetDMXHandler(uint8_t port_id,
   }
 
   if (port->on_data) {
-    delete m_output_ports[port_id].on_data;
+    delete port->on_data;
   }
   port->buffer = buffer;
   port->on_data = on_data;
@@ -767,7 +904,7 @@ bool ArtNetNodeImpl::SendTod(uint8_t port_id, const UIDSet &uid_set) {
   memset(&packet.data.tod_data, 0, sizeof(packet.data.tod_data));
   packet.data.tod_data.version = HostToNetwork(ARTNET_VERSION);
   packet.data.tod_data.rdm_version = RDM_VERSION;
-  packet.data.tod_data.port = 1 + port_id;
+  packet.data.tod_data.port = 1 + port_id % ARTNET_MAX_PORTS;
   packet.data.tod_request.net = m_net_address;
   packet.data.tod_data.address = port->universe_address;
   uint16_t uids = std::min(uid_set.Size(),
@@ -850,6 +987,16 @@ bool ArtNetNodeImpl::SendTimeCode(const ola::timecode::TimeCode &timecode) {
   return true;
 }
 
+bool ArtNetNodeImpl::ExpireSubscribedNodes() {
+  TimeStamp last_heard_threshold = (
+      *m_ss->WakeUpTime() - TimeInterval(NODE_TIMEOUT, 0));
+  InputPorts::iterator iter = m_input_ports.begin();
+  for (; iter != m_input_ports.end(); ++iter) {
+    (*iter)->ExpireSubscribedNodes(last_heard_threshold);
+  }
+  return true;
+}
+
 void ArtNetNodeImpl::SocketReady() {
   artnet_packet packet;
   ssize_t packet_size = sizeof(packet);
@@ -890,6 +1037,31 @@ bool ArtNetNodeImpl::SendPollReplyIfRequired() {
 }
 
 bool ArtNetNodeImpl::SendPollReply(const IPV4Address &destination) {
+  unsigned int port_count = std::max(
+      static_cast<unsigned int>(m_input_ports.size()),
+      static_cast<unsigned int>(m_output_ports.size()));
+  unsigned int pages = (port_count + ARTNET_MAX_PORTS - 1) / ARTNET_MAX_PORTS;
+  if (pages == 1) {
+    return SendPollReplyPage(destination, 0, 0, port_count);
+  }
+
+  // Art-Net 4 nodes with more than ARTNET_MAX_PORTS ports send a reply for
+  // each group of ports, numbered from 1. The last group may be partial.
+  bool ok = true;
+  for (unsigned int page = 0; page < pages; page++) {
+    unsigned int first_port = page * ARTNET_MAX_PORTS;
+    ok &= SendPollReplyPage(
+        destination, page + 1, first_port,
+        std::min(port_count - first_port,
+                 static_cast<unsigned int>(ARTNET_MAX_PORTS)));
+  }
+  return ok;
+}
+
+bool ArtNetNodeImpl::SendPollReplyPage(const IPV4Address &destination,
+                                       uint8_t bind_index,
+                                       unsigned int first_port,
+                                       uint8_t port_count) {
   artnet_packet packet;
   PopulatePacketHeader(&packet, ARTNET_REPLY);
   memset(&packet.data.reply, 0, sizeof(packet.data.reply));
@@ -897,7 +1069,8 @@ bool ArtNetNodeImpl::SendPollReply(const IPV4Address &destination) {
   m_interface.ip_address.Get(packet.data.reply.ip);
   packet.data.reply.port = HostToLittleEndian(ARTNET_PORT);
   packet.data.reply.net_address = m_net_address;
-  packet.data.reply.subnet_address = m_output_ports[0].universe_address >> 4;
+  packet.data.reply.subnet_address =
+      m_output_ports[first_port].universe_address >> 4;
   packet.data.reply.oem = HostToNetwork(OEM_CODE);
   packet.data.reply.status1 = 0xd2;  // normal indicators, rdm enabled
   packet.data.reply.esta_id = HostToLittleEndian(OPEN_LIGHTING_ESTA_CODE);
@@ -910,22 +1083,29 @@ bool ArtNetNodeImpl::SendPollReply(const IPV4Address &destination) {
   str << "#0001 [" << m_unsolicited_replies << "] OLA";
   CopyToFixedLengthBuffer(str.str(), packet.data.reply.node_report,
                           arraysize(packet.data.reply.node_report));
-  packet.data.reply.number_ports[1] = ARTNET_MAX_PORTS;
-  for (unsigned int i = 0; i < ARTNET_MAX_PORTS; i++) {
-    InputPort *iport = GetInputPort(i, false);
+  packet.data.reply.number_ports[1] = port_count;
+  for (unsigned int i = 0; i < port_count; i++) {
+    unsigned int port_id = first_port + i;
+    InputPort *iport = port_id < m_input_ports.size() ?
+        m_input_ports[port_id] : NULL;
     packet.data.reply.port_types[i] = iport ? 0xc0 : 0x80;
     packet.data.reply.good_input[i] = iport && iport->enabled ? 0x0 : 0x8;
     packet.data.reply.sw_in[i] = iport ? iport->PortAddress() : 0;
 
+    if (port_id >= m_output_ports.size()) {
+      continue;
+    }
+    const OutputPort &port = m_output_ports[port_id];
     packet.data.reply.good_output[i] = (
-        (m_output_ports[i].enabled ? 0x80 : 0x00) |
-        (m_output_ports[i].merge_mode == ARTNET_MERGE_LTP ? 0x2 : 0x0) |
-        (m_output_ports[i].is_merging ? 0x8 : 0x0));
-    packet.data.reply.sw_out[i] = m_output_ports[i].universe_address;
+        (port.enabled ? 0x80 : 0x00) |
+        (port.merge_mode == ARTNET_MERGE_LTP ? 0x2 : 0x0) |
+        (port.is_merging ? 0x8 : 0x0));
+    packet.data.reply.sw_out[i] = port.universe_address;
   }
   packet.data.reply.style = NODE_CODE;
   m_interface.hw_address.Get(packet.data.reply.mac);
   m_interface.ip_address.Get(packet.data.reply.bind_ip);
+  packet.data.reply.bind_index = bind_index;
   // maybe set status2 here if the web UI is enabled
   packet.data.reply.status2 = 0x08;  // node supports 15 bit port addresses
   if (!SendPacket(packet, sizeof(packet.data.reply), destination)) {
@@ -1004,8 +1184,9 @@ void ArtNetNodeImpl::HandlePacket(const IPV4Address &source_address,
                       packet_size - header_size);
       break;
     case ARTNET_SYNC:
-      // TODO(Someone): Implement me, not currently implemented.
-      OLA_DEBUG << "ArtSync input not currently supported";
+      HandleSyncPacket(source_address,
+                       packet.data.sync,
+                       packet_size - header_size);
       break;
     case ARTNET_RDM_SUB:
       // TODO(Someone): Implement me, not currently implemented.
@@ -1079,8 +1260,7 @@ void ArtNetNodeImpl::HandleReplyPacket(const IPV4Address &source_address,
       InputPorts::iterator iter = m_input_ports.begin();
       for (; iter != m_input_ports.end(); ++iter) {
         if ((*iter)->enabled && (*iter)->PortAddress() == universe_id) {
-          STLReplace(&(*iter)->subscribed_nodes, source_address,
-                     *m_ss->WakeUpTime());
+          (*iter)->AddSubscribedNode(source_address, *m_ss->WakeUpTime());
         }
       }
     }
@@ -1115,17 +1295,17 @@ void ArtNetNodeImpl::HandleDataPacket(const IPV4Address &source_address,
       (unsigned int) ((packet.length[0] << 8) + packet.length[1]),
       packet_size - header_size);
 
-  for (unsigned int port_id = 0; port_id < ARTNET_MAX_PORTS; port_id++) {
-    if (m_output_ports[port_id].enabled &&
-        m_output_ports[port_id].universe_address == universe_id &&
-        m_output_ports[port_id].on_data &&
-        m_output_ports[port_id].buffer) {
+  const OutputPortIds &port_ids = m_output_port_map[universe_id];
+  OutputPortIds::const_iterator iter = port_ids.begin();
+  for (; iter != port_ids.end(); ++iter) {
+    OutputPort *port = &m_output_ports[*iter];
+    if (port->on_data && port->buffer) {
       // update this port, doing a merge if necessary
       DMXSource source;
       source.address = source_address;
       source.timestamp = *m_ss->WakeUpTime();
       source.buffer.Set(packet.data, data_size);
-      UpdatePortFromSource(&m_output_ports[port_id], source);
+      UpdatePortFromSource(port, source);
     }
   }
 }
@@ -1165,17 +1345,15 @@ void ArtNetNodeImpl::HandleTodRequest(const IPV4Address &source_address,
       static_cast<unsigned int>(ARTNET_MAX_RDM_ADDRESS_COUNT),
       addresses);
 
-  bool handler_called[ARTNET_MAX_PORTS];
-  memset(handler_called, 0, sizeof(handler_called));
+  vector<bool> handler_called(m_output_ports.size(), false);
 
   for (unsigned int i = 0; i < addresses; i++) {
-    for (unsigned int port_id = 0; port_id < ARTNET_MAX_PORTS; port_id++) {
-      if (m_output_ports[port_id].enabled &&
-          m_output_ports[port_id].universe_address == packet.addresses[i] &&
-          m_output_ports[port_id].on_discover &&
-          !handler_called[port_id]) {
-        m_output_ports[port_id].on_discover->Run();
-        handler_called[port_id] = true;
+    const OutputPortIds &port_ids = m_output_port_map[packet.addresses[i]];
+    OutputPortIds::const_iterator iter = port_ids.begin();
+    for (; iter != port_ids.end(); ++iter) {
+      if (m_output_ports[*iter].on_discover && !handler_called[*iter]) {
+        m_output_ports[*iter].on_discover->Run();
+        handler_called[*iter] = true;
       }
     }
   }
@@ -1245,11 +1423,11 @@ void ArtNetNodeImpl::HandleTodControl(const IPV4Address &source_address,
     return;
   }
 
-  for (unsigned int port_id = 0; port_id < ARTNET_MAX_PORTS; port_id++) {
-    if (m_output_ports[port_id].enabled &&
-        m_output_ports[port_id].universe_address == packet.address &&
-        m_output_ports[port_id].on_flush) {
-      m_output_ports[port_id].on_flush->Run();
+  const OutputPortIds &port_ids = m_output_port_map[packet.address];
+  OutputPortIds::const_iterator iter = port_ids.begin();
+  for (; iter != port_ids.end(); ++iter) {
+    if (m_output_ports[*iter].on_flush) {
+      m_output_ports[*iter].on_flush->Run();
     }
   }
 }
@@ -1291,10 +1469,11 @@ void ArtNetNodeImpl::HandleRdm(const IPV4Address &source_address,
 
   // look for the port that this was sent to, once we know the port we can try
   // to parse the message
-  for (uint8_t port_id = 0; port_id < ARTNET_MAX_PORTS; port_id++) {
-    if (m_output_ports[port_id].enabled &&
-        m_output_ports[port_id].universe_address == packet.address &&
-        m_output_ports[port_id].on_rdm_request) {
+  const OutputPortIds &port_ids = m_output_port_map[packet.address];
+  OutputPortIds::const_iterator port_iter = port_ids.begin();
+  for (; port_iter != port_ids.end(); ++port_iter) {
+    uint8_t port_id = *port_iter;
+    if (m_output_ports[port_id].on_rdm_request) {
       RDMRequest *request = RDMRequest::InflateFromData(packet.data,
                                                         rdm_length);
 
@@ -1361,11 +1540,17 @@ void ArtNetNodeImpl::HandleRDMResponse(InputPort *port,
     return;
   }
 
-  if (!port->pending_request) {
+  // Responses are matched to requests using the source UID.
+  pending_rdm_map::iterator pending_iter = port->pending_requests.find(
+      reply->Response()->SourceUID());
+  if (pending_iter == port->pending_requests.end()) {
+    OLA_INFO << "Got response from " << reply->Response()->SourceUID()
+             << " but there is no request in flight for that UID";
     return;
   }
 
-  const RDMRequest *request = port->pending_request;
+  PendingRDMRequest pending = pending_iter->second;
+  const RDMRequest *request = pending.request;
   if (request->SourceUID() != reply->Response()->DestinationUID() ||
       request->DestinationUID() != reply->Response()->SourceUID()) {
     OLA_INFO << "Got response from/to unexpected UID: req "
@@ -1407,25 +1592,22 @@ void ArtNetNodeImpl::HandleRDMResponse(InputPort *port,
     return;
   }
 
-  if (port->rdm_ip_destination != m_interface.bcast_address &&
-      port->rdm_ip_destination != source_address) {
+  if (pending.ip_destination != m_interface.bcast_address &&
+      pending.ip_destination != source_address) {
     OLA_INFO << "IP address of RDM response didn't match";
     return;
   }
 
   // at this point we've decided it's for us
-  port->pending_request = NULL;
+  port->pending_requests.erase(pending_iter);
   delete request;
-  RDMCallback *callback = port->rdm_request_callback;
-  port->rdm_request_callback = NULL;
 
   // remove the timeout
-  if (port->rdm_send_timeout != ola::thread::INVALID_TIMEOUT) {
-    m_ss->RemoveTimeout(port->rdm_send_timeout);
-    port->rdm_send_timeout = ola::thread::INVALID_TIMEOUT;
+  if (pending.timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(pending.timeout);
   }
 
-  callback->Run(reply.get());
+  pending.callback->Run(reply.get());
 }
 
 void ArtNetNodeImpl::HandleIPProgram(const IPV4Address &source_address,
@@ -1444,6 +1626,50 @@ void ArtNetNodeImpl::HandleIPProgram(const IPV4Address &source_address,
            << "configuration";
 }
 
+void ArtNetNodeImpl::HandleSyncPacket(const IPV4Address &source_address,
+                                      const artnet_sync_t &packet,
+                                      unsigned int packet_size) {
+  if (!CheckPacketSize(source_address, "ArtSync", packet_size,
+                       sizeof(packet))) {
+    return;
+  }
+
+  if (!CheckPacketVersion(source_address, "ArtSync", packet.version)) {
+    return;
+  }
+
+  m_last_sync = *m_ss->WakeUpTime();
+  if (m_sync_timeout != ola::thread::INVALID_TIMEOUT) {
+    m_ss->RemoveTimeout(m_sync_timeout);
+    m_sync_timeout = ola::thread::INVALID_TIMEOUT;
+  }
+  ReleaseSyncData();
+}
+
+bool ArtNetNodeImpl::InSyncMode() const {
+  return m_last_sync.IsSet() &&
+      *m_ss->WakeUpTime() - m_last_sync < TimeInterval(SYNC_TIMEOUT, 0);
+}
+
+void ArtNetNodeImpl::ReleaseSyncData() {
+  for (unsigned int port_id = 0; port_id < m_output_ports.size(); port_id++) {
+    OutputPort &port = m_output_ports[port_id];
+    if (port.sync_pending) {
+      port.sync_pending = false;
+      if (port.enabled && port.on_data) {
+        port.on_data->Run();
+      }
+    }
+  }
+}
+
+void ArtNetNodeImpl::SyncTimeout() {
+  m_sync_timeout = ola::thread::INVALID_TIMEOUT;
+  OLA_INFO << "No ArtSync for " << SYNC_TIMEOUT
+           << "s, releasing the held data";
+  ReleaseSyncData();
+}
+
 void ArtNetNodeImpl::PopulatePacketHeader(artnet_packet *packet,
                                           uint16_t op_code) {
   CopyToFixedLengthBuffer(ARTNET_ID, reinterpret_cast<char*>(packet->id),
@@ -1467,13 +1693,15 @@ bool ArtNetNodeImpl::SendPacket(const artnet_packet &packet,
   return true;
 }
 
-void ArtNetNodeImpl::TimeoutRDMRequest(InputPort *port) {
-  OLA_INFO << "RDM Request timed out.";
-  port->rdm_send_timeout = ola::thread::INVALID_TIMEOUT;
-  delete port->pending_request;
-  port->pending_request = NULL;
-  RDMCallback *callback = port->rdm_request_callback;
-  port->rdm_request_callback = NULL;
+void ArtNetNodeImpl::TimeoutRDMRequest(InputPort *port, UID destination) {
+  OLA_INFO << "RDM Request to " << destination << " timed out.";
+  pending_rdm_map::iterator iter = port->pending_requests.find(destination);
+  if (iter == port->pending_requests.end()) {
+    return;
+  }
+  RDMCallback *callback = iter->second.callback;
+  delete iter->second.request;
+  port->pending_requests.erase(iter);
   RunRDMCallback(callback, ola::rdm::RDM_TIMEOUT);
 }
 
@@ -1533,7 +1761,11 @@ void ArtNetNodeImpl::UpdatePortFromSource(OutputPort *port,
     // this is a new source
     if (first_empty_slot == MAX_MERGE_SOURCES) {
       // No room at the inn
-      OLA_WARN << "Max merge sources reached, ignoring";
+      OLA_WARN_LIMITED(m_merge_limiter)
+          << "Max merge sources reached, ignoring"
+          << ola::LogField("universe",
+                           static_cast<int>(port->universe_address))
+          << ola::LogField("source", source.address);
       return;
     }
     if (active_sources == 0) {
@@ -1569,7 +1801,17 @@ void ArtNetNodeImpl::UpdatePortFromSource(OutputPort *port,
       }
     }
   }
-  port->on_data->Run();
+  if (InSyncMode()) {
+    port->sync_pending = true;
+    if (m_sync_timeout == ola::thread::INVALID_TIMEOUT) {
+      m_sync_timeout = m_ss->RegisterSingleTimeout(
+          m_last_sync + TimeInterval(SYNC_TIMEOUT, 0) - *m_ss->WakeUpTime(),
+          NewSingleCallback(this, &ArtNetNodeImpl::SyncTimeout));
+    }
+  } else {
+    port->sync_pending = false;
+    port->on_data->Run();
+  }
 }
 
 bool ArtNetNodeImpl::CheckPacketVersion(const IPV4Address &source_address,
@@ -1634,9 +1876,9 @@ ArtNetNodeImpl::InputPort *ArtNetNodeImpl::GetEnabledInputPort(
 }
 
 ArtNetNodeImpl::OutputPort *ArtNetNodeImpl::GetOutputPort(uint8_t port_id) {
-  if (port_id >= ARTNET_MAX_PORTS) {
+  if (port_id >= m_output_ports.size()) {
     OLA_WARN << "Port index out of bounds: "
-             << static_cast<int>(port_id) << " >= " << ARTNET_MAX_PORTS;
+             << static_cast<int>(port_id) << " >= " << m_output_ports.size();
     return NULL;
   }
   return &m_output_ports[port_id];
@@ -1644,9 +1886,9 @@ ArtNetNodeImpl::OutputPort *ArtNetNodeImpl::GetOutputPort(uint8_t port_id) {
 
 const ArtNetNodeImpl::OutputPort *ArtNetNodeImpl::GetOutputPort(
     uint8_t port_id) const {
-  if (port_id >= ARTNET_MAX_PORTS) {
+  if (port_id >= m_output_ports.size()) {
     OLA_WARN << "Port index out of bounds: "
-             << static_cast<int>(port_id) << " >= " << ARTNET_MAX_PORTS;
+             << static_cast<int>(port_id) << " >= " << m_output_ports.size();
     return NULL;
   }
   return &m_output_ports[port_id];
@@ -1667,6 +1909,19 @@ ArtNetNodeImpl::OutputPort *ArtNetNodeImpl::GetEnabledOutputPort(
   return ok ? port : NULL;
 }
 
+void ArtNetNodeImpl::UpdateOutputPortMap() {
+  for (unsigned int i = 0; i < ARTNET_MAX_OUTPUT_PORTS; i++) {
+    m_output_port_map[i].clear();
+  }
+
+  for (unsigned int port_id = 0; port_id < m_output_ports.size(); port_id++) {
+    const OutputPort &port = m_output_ports[port_id];
+    if (port.enabled) {
+      m_output_port_map[port.universe_address].push_back(port_id);
+    }
+  }
+}
+
 bool ArtNetNodeImpl::InitNetwork() {
   if (!m_socket->Init()) {
     OLA_WARN << "Socket init failed";
@@ -1703,16 +1958,16 @@ void ArtNetNodeImpl::UpdatePortFromTodPacket(InputPort *port,
   for (unsigned int i = 0; i < uid_count; i++) {
     UID uid(packet.tod[i]);
     uid_set.AddUID(uid);
-    uid_map::iterator iter = port_uids.find(uid);
-    if (iter == port_uids.end()) {
-      port_uids[uid] = std::pair<IPV4Address, uint8_t>(source_address, 0);
+    std::pair<IPV4Address, uint8_t> *uid_entry = port_uids.Find(uid);
+    if (!uid_entry) {
+      port_uids.Set(uid, std::pair<IPV4Address, uint8_t>(source_address, 0));
     } else {
-      if (iter->second.first != source_address) {
+      if (uid_entry->first != source_address) {
         OLA_WARN << "UID " << uid << " changed from "
-                 << iter->second.first << " to " << source_address;
-        iter->second.first = source_address;
+                 << uid_entry->first << " to " << source_address;
+        uid_entry->first = source_address;
       }
-      iter->second.second = 0;
+      uid_entry->second = 0;
     }
   }
 
@@ -1720,15 +1975,7 @@ void ArtNetNodeImpl::UpdatePortFromTodPacket(InputPort *port,
   // that don't appear in it.
   // There is a bug in Art-Net nodes where sometimes UidCount > UidTotal.
   if (uid_count >= NetworkToHost(packet.uid_total)) {
-    uid_map::iterator iter = port_uids.begin();
-    while (iter != port_uids.end()) {
-      if (iter->second.first == source_address &&
-          !uid_set.Contains(iter->first)) {
-        port_uids.erase(iter++);
-      } else {
-        ++iter;
-      }
-    }
+    port_uids.RemoveIf(MissingFromTod(source_address, uid_set));
 
     // mark this node as complete
     if (port->discovery_node_set.erase(source_address)) {
@@ -1757,7 +2004,7 @@ bool ArtNetNodeImpl::StartDiscoveryProcess(InputPort *port,
                                            RDMDiscoveryCallback *callback) {
   if (port->discovery_callback) {
     OLA_FATAL << "Art-Net UID discovery already running, something has gone "
-                 "wrong with the DiscoverableQueueingRDMController.";
+                 "wrong with the DiscoverablePipeliningRDMController.";
     port->RunTodCallback();
     return false;
   }
@@ -1788,14 +2035,7 @@ void ArtNetNodeImpl::ReleaseDiscoveryLock(InputPort *port) {
   port->discovery_node_set.clear();
 
   // delete all uids that have reached the max count
-  uid_map::iterator iter = port->uids.begin();
-  while (iter != port->uids.end()) {
-    if (iter->second.second == RDM_MISSED_TODDATA_LIMIT) {
-      port->uids.erase(iter++);
-    } else {
-      ++iter;
-    }
-  }
+  port->uids.RemoveIf(MissedTodLimit(RDM_MISSED_TODDATA_LIMIT));
 
   port->RunDiscoveryCallback();
 }
@@ -1809,8 +2049,8 @@ ArtNetNode::ArtNetNode(const ola::network::Interface &iface,
     ArtNetNodeImplRDMWrapper *wrapper = new ArtNetNodeImplRDMWrapper(&m_impl,
                                                                      i);
     m_wrappers.push_back(wrapper);
-    m_controllers.push_back(new ola::rdm::DiscoverableQueueingRDMController(
-        wrapper, options.rdm_queue_size));
+    m_controllers.push_back(new ola::rdm::DiscoverablePipeliningRDMController(
+        wrapper, options.rdm_queue_size, options.rdm_max_in_flight));
   }
 }
 
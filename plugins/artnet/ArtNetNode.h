@@ -30,14 +30,16 @@
 #include "ola/Callback.h"
 #include "ola/Clock.h"
 #include "ola/DmxBuffer.h"
+#include "ola/Logging.h"
 #include "ola/network/IPV4Address.h"
 #include "ola/network/Interface.h"
 #include "ola/io/SelectServerInterface.h"
 #include "ola/network/Socket.h"
-#include "ola/rdm/QueueingRDMController.h"
+#include "ola/rdm/PipeliningRDMController.h"
 #include "ola/rdm/RDMCommand.h"
 #include "ola/rdm/RDMFrame.h"
 #include "ola/rdm/RDMControllerInterface.h"
+#include "ola/rdm/UIDMap.h"
 #include "ola/rdm/UIDSet.h"
 #include "ola/timecode/TimeCode.h"
 #include "plugins/artnet/ArtNetPackets.h"
@@ -62,21 +64,34 @@ typedef enum {
 // This can be passed to SetPortUniverse to disable ports
 static const uint8_t ARTNET_DISABLE_PORT = 0xf0;
 
+// The number of port addresses (subnet & universe) within a single net. This
+// is the most output ports a node can have.
+static const unsigned int ARTNET_MAX_OUTPUT_PORTS = 256;
+
 class ArtNetNodeOptions {
  public:
   ArtNetNodeOptions()
       : always_broadcast(false),
         use_limited_broadcast_address(false),
         rdm_queue_size(20),
+        rdm_max_in_flight(1),
         broadcast_threshold(30),
-        input_port_count(4) {
+        input_port_count(4),
+        output_port_count(ARTNET_MAX_PORTS) {
   }
 
   bool always_broadcast;
   bool use_limited_broadcast_address;
   unsigned int rdm_queue_size;
+  // The number of RDM requests (to different UIDs) that may be in flight at
+  // once, per port.
+  unsigned int rdm_max_in_flight;
   unsigned int broadcast_threshold;
   uint8_t input_port_count;
+  // Nodes always have at least ARTNET_MAX_PORTS output ports, and at most
+  // ARTNET_MAX_OUTPUT_PORTS. Ports after the first ARTNET_MAX_PORTS are
+  // described in additional ArtPollReplies, one per bind index.
+  unsigned int output_port_count;
 };
 
 
@@ -160,11 +175,13 @@ class ArtNetNodeImpl {
   /**
    * @brief Set the subnet address for this node
    * @param subnet_address the Art-Net 'subnet' address, 4 bits.
+   *
+   * This applies to all the input ports. Output port addresses are offsets
+   * from the subnet, so changing it moves every output port by the same
+   * number of subnets.
    */
   bool SetSubnetAddress(uint8_t subnet_address);
-  uint8_t SubnetAddress() const {
-    return m_output_ports[0].universe_address >> 4;
-  }
+  uint8_t SubnetAddress() const { return m_subnet_address; }
 
   /**
    * Get the number of input ports
@@ -177,6 +194,14 @@ class ArtNetNodeImpl {
    */
   bool SetInputPortUniverse(uint8_t port_id, uint8_t universe_id);
 
+  /**
+   * @brief Set the subnet and universe for an input port.
+   * @param port_id a port id between 0 and InputPortCount() - 1
+   * @param port_address the subnet in the high nibble and the universe in the
+   *   low nibble.
+   */
+  bool SetInputPortAddress(uint8_t port_id, uint8_t port_address);
+
   /**
    * @brief Get an input port universe address
    *
@@ -201,13 +226,26 @@ class ArtNetNodeImpl {
    */
   bool InputPortState(uint8_t port_id) const;
 
+  /**
+   * @brief Get the number of output ports
+   */
+  unsigned int OutputPortCount() const { return m_output_ports.size(); }
+
   /**
    * @brief Set the universe for an output port.
-   * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
-   * @param universe_id the new universe id.
+   * @param port_id a port id between 0 and OutputPortCount() - 1
+   * @param universe_id the new universe id, the subnet is left as is.
    */
   bool SetOutputPortUniverse(uint8_t port_id, uint8_t universe_id);
 
+  /**
+   * @brief Set the subnet and universe for an output port.
+   * @param port_id a port id between 0 and OutputPortCount() - 1
+   * @param port_address the subnet in the high nibble and the universe in the
+   *   low nibble.
+   */
+  bool SetOutputPortAddress(uint8_t port_id, uint8_t port_address);
+
   /**
    * Return the current universe address for an output port
    * @param port_id a port id between 0 and ARTNET_MAX_PORTS - 1
@@ -256,11 +294,20 @@ class ArtNetNodeImpl {
    */
   bool SendDMX(uint8_t port_id, const ola::DmxBuffer &buffer);
 
+  /**
+   * @brief Send an ArtSync packet.
+   *
+   * Nodes that have received an ArtSync in the last 4 seconds hold the
+   * ArtDmx data until the next ArtSync arrives.
+   * @return true if it was sent successfully, false otherwise
+   */
+  bool SendSync();
+
   /**
    * @brief Flush the TOD and force a full discovery.
    *
-   * The DiscoverableQueueingRDMController ensures this is only called one at a
-   * time.
+   * The DiscoverablePipeliningRDMController ensures this is only called one at
+   * a time.
    * @param port_id port to discover on
    * @param callback the RDMDiscoveryCallback to run when discovery completes
    */
@@ -271,7 +318,7 @@ class ArtNetNodeImpl {
    * @brief Run an 'incremental' discovery. This just involves fetching the TOD from
    * all nodes.
    *
-   * The DiscoverableQueueingRDMController ensures only one discovery process
+   * The DiscoverablePipeliningRDMController ensures only one discovery process
    * is running per port at any time.
    * @param port_id port to send on
    * @param callback the RDMDiscoveryCallback to run when discovery completes
@@ -288,8 +335,9 @@ class ArtNetNodeImpl {
    * @param request the RDMRequest object
    * @param on_complete the RDMCallback to run
    *
-   * Because this is wrapped in the QueueingRDMController this will only be
-   * called one-at-a-time (per port)
+   * Because this is wrapped in the PipeliningRDMController there will only
+   * be one request in flight for each UID (per port), and up to
+   * ArtNetNodeOptions::rdm_max_in_flight requests in flight in total.
    */
   void SendRDMRequest(uint8_t port_id,
                       ola::rdm::RDMRequest *request,
@@ -358,8 +406,11 @@ class ArtNetNodeImpl {
 
   // map a uid to a IP address and the number of times we've missed a
   // response.
-  typedef std::map<ola::rdm::UID,
-                   std::pair<ola::network::IPV4Address, uint8_t> > uid_map;
+  typedef ola::rdm::UIDMap<std::pair<ola::network::IPV4Address, uint8_t> >
+      uid_map;
+
+  // The output port ids for each port address.
+  typedef std::vector<uint8_t> OutputPortIds;
 
   enum { MAX_MERGE_SOURCES = 2 };
 
@@ -378,8 +429,9 @@ class ArtNetNodeImpl {
     bool is_merging;
     DMXSource sources[MAX_MERGE_SOURCES];
     DmxBuffer *buffer;
-    std::map<ola::rdm::UID, ola::network::IPV4Address> uid_map;
+    ola::rdm::UIDMap<ola::network::IPV4Address> uid_map;
     Callback0<void> *on_data;
+    bool sync_pending;  // true if on_data is waiting for an ArtSync
     Callback0<void> *on_discover;
     Callback0<void> *on_flush;
     ola::Callback2<void,
@@ -389,6 +441,7 @@ class ArtNetNodeImpl {
 
   bool m_running;
   uint8_t m_net_address;  // this is the 'net' portion of the Art-Net address
+  uint8_t m_subnet_address;
   bool m_send_reply_on_change;
   std::string m_short_name;
   std::string m_long_name;
@@ -402,17 +455,30 @@ class ArtNetNodeImpl {
   bool m_in_configuration_mode;
   bool m_artpoll_required;
   bool m_artpollreply_required;
+  ola::thread::timeout_id m_expiry_timeout;
 
   InputPorts m_input_ports;
-  OutputPort m_output_ports[ARTNET_MAX_PORTS];
+  std::vector<OutputPort> m_output_ports;
+  // Maps the port address of inbound packets to the enabled output ports.
+  OutputPortIds m_output_port_map[ARTNET_MAX_OUTPUT_PORTS];
+  TimeStamp m_last_sync;  // when we last received an ArtSync
+  // Releases the held data if the next ArtSync doesn't arrive in time.
+  ola::thread::timeout_id m_sync_timeout;
   ola::network::Interface m_interface;
   std::auto_ptr<ola::network::UDPSocketInterface> m_socket;
+  // A misbehaving console can trigger this on every packet.
+  ola::LogRateLimiter m_merge_limiter;
 
   /**
    * @brief Called when there is data on this socket
    */
   void SocketReady();
 
+  /**
+   * @brief Remove the subscribed nodes we haven't heard from recently.
+   */
+  bool ExpireSubscribedNodes();
+
   /**
    * @brief Send an ArtPoll if we're both running and not in configuration mode.
    *
@@ -430,10 +496,24 @@ class ArtNetNodeImpl {
   bool SendPollReplyIfRequired();
 
   /**
-   * @brief Send an ArtPollReply message
+   * @brief Send the ArtPollReply messages, one for each group of
+   * ARTNET_MAX_PORTS ports.
    */
   bool SendPollReply(const ola::network::IPV4Address &destination);
 
+  /**
+   * @brief Send the ArtPollReply for one group of ports.
+   * @param destination where to send the reply.
+   * @param bind_index the bind index of the reply, 0 if there is only one.
+   * @param first_port the id of the first port in the group.
+   * @param port_count the number of ports in the group, at most
+   *   ARTNET_MAX_PORTS.
+   */
+  bool SendPollReplyPage(const ola::network::IPV4Address &destination,
+                         uint8_t bind_index,
+                         unsigned int first_port,
+                         uint8_t port_count);
+
   /**
    * @brief Send an IPProgReply
    */
@@ -524,6 +604,28 @@ class ArtNetNodeImpl {
                        const artnet_ip_prog_t &packet,
                        unsigned int packet_size);
 
+  /**
+   * @brief Handle an ArtSync packet.
+   */
+  void HandleSyncPacket(const ola::network::IPV4Address &source_address,
+                        const artnet_sync_t &packet,
+                        unsigned int packet_size);
+
+  /**
+   * @brief Check if we've received an ArtSync recently.
+   */
+  bool InSyncMode() const;
+
+  /**
+   * @brief Pass the data held for an ArtSync to the output ports.
+   */
+  void ReleaseSyncData();
+
+  /**
+   * @brief Called when the ArtSyncs have stopped.
+   */
+  void SyncTimeout();
+
   /**
    * @brief Fill in the header for a packet
    */
@@ -541,9 +643,10 @@ class ArtNetNodeImpl {
 
   /**
    * @brief Timeout a pending RDM request
-   * @param port the id of the port to timeout.
+   * @param port the port the request was sent on.
+   * @param destination the destination UID of the request.
    */
-  void TimeoutRDMRequest(InputPort *port);
+  void TimeoutRDMRequest(InputPort *port, ola::rdm::UID destination);
 
   /**
    * @brief Send a generic ArtRdm message
@@ -603,6 +706,12 @@ class ArtNetNodeImpl {
    */
   OutputPort *GetEnabledOutputPort(uint8_t port_id, const std::string &action);
 
+  /**
+   * @brief Rebuild m_output_port_map, this is called whenever an output port
+   * is enabled, disabled or changes address.
+   */
+  void UpdateOutputPortMap();
+
   /**
    * @brief Update a port with a new TOD list
    */
@@ -643,6 +752,10 @@ class ArtNetNodeImpl {
   static const unsigned int MERGE_TIMEOUT = 10;  // As per the spec
   // seconds after which a node is marked as inactive for the dmx merging
   static const unsigned int NODE_TIMEOUT = 31;
+  // how often we check for nodes that have timed out
+  static const unsigned int NODE_EXPIRY_INTERVAL_MS = 1000;
+  // seconds without an ArtSync before we stop holding ArtDmx data
+  static const unsigned int SYNC_TIMEOUT = 4;
   // mseconds we wait for a TodData packet before declaring a node missing
   static const unsigned int RDM_TOD_TIMEOUT_MS = 4000;
   // Number of missed TODs before we decide a UID has gone
@@ -658,7 +771,7 @@ class ArtNetNodeImpl {
 
 
 /**
- * This glues the ArtNetNodeImpl together with the QueueingRDMController.
+ * This glues the ArtNetNodeImpl together with the PipeliningRDMController.
  * The ArtNetNodeImpl takes a port id so we need this extra layer.
  */
 class ArtNetNodeImplRDMWrapper
@@ -739,9 +852,16 @@ class ArtNetNode {
     return m_impl.InputPortCount();
   }
 
+  unsigned int OutputPortCount() const {
+    return m_impl.OutputPortCount();
+  }
+
   bool SetInputPortUniverse(uint8_t port_id, uint8_t universe_id) {
     return m_impl.SetInputPortUniverse(port_id, universe_id);
   }
+  bool SetInputPortAddress(uint8_t port_id, uint8_t port_address) {
+    return m_impl.SetInputPortAddress(port_id, port_address);
+  }
   uint8_t GetInputPortUniverse(uint8_t port_id) const {
     return m_impl.GetInputPortUniverse(port_id);
   }
@@ -755,6 +875,9 @@ class ArtNetNode {
   bool SetOutputPortUniverse(uint8_t port_id, uint8_t universe_id) {
     return m_impl.SetOutputPortUniverse(port_id, universe_id);
   }
+  bool SetOutputPortAddress(uint8_t port_id, uint8_t port_address) {
+    return m_impl.SetOutputPortAddress(port_id, port_address);
+  }
   uint8_t GetOutputPortUniverse(uint8_t port_id) {
     return m_impl.GetOutputPortUniverse(port_id);
   }
@@ -783,6 +906,10 @@ class ArtNetNode {
     return m_impl.SendDMX(port_id, buffer);
   }
 
+  bool SendSync() {
+    return m_impl.SendSync();
+  }
+
   /**
    * @brief Trigger full discovery for a port
    */
@@ -796,7 +923,7 @@ class ArtNetNode {
                                ola::rdm::RDMDiscoveryCallback *callback);
 
   /**
-   * @brief Send a RDM request by passing it though the Queuing Controller
+   * @brief Send a RDM request by passing it though the Pipelining Controller
    */
   void SendRDMRequest(uint8_t port_id,
                       ola::rdm::RDMRequest *request,
@@ -847,7 +974,7 @@ class ArtNetNode {
  private:
   ArtNetNodeImpl m_impl;
   std::vector<ArtNetNodeImplRDMWrapper*> m_wrappers;
-  std::vector<ola::rdm::DiscoverableQueueingRDMController*> m_controllers;
+  std::vector<ola::rdm::DiscoverablePipeliningRDMController*> m_controllers;
 
   /**
    * @brief Check that the port_id is a valid input port.
@@ -52,6 +52,8 @@ using ola::network::Interface;
 using ola::network::MACAddress;
 using ola::plugin::artnet::ArtNetNode;
 using ola::plugin::artnet::ArtNetNodeOptions;
+using ola::plugin::artnet::ARTNET_MAX_OUTPUT_PORTS;
+using ola::plugin::artnet::ARTNET_MAX_PORTS;
 using ola::rdm::RDMCallback;
 using ola::rdm::RDMCommand;
 using ola::rdm::RDMCommandSerializer;
@@ -73,12 +75,14 @@ class ArtNetNodeTest: public CppUnit::TestFixture {
   CPPUNIT_TEST(testBasicBehaviour);
   CPPUNIT_TEST(testConfigurationMode);
   CPPUNIT_TEST(testExtendedInputPorts);
+  CPPUNIT_TEST(testExtendedOutputPorts);
   CPPUNIT_TEST(testBroadcastSendDMX);
   CPPUNIT_TEST(testBroadcastSendDMXZeroUniverse);
   CPPUNIT_TEST(testLimitedBroadcastDMX);
   CPPUNIT_TEST(testNonBroadcastSendDMX);
   CPPUNIT_TEST(testReceiveDMX);
   CPPUNIT_TEST(testReceiveDMXZeroUniverse);
+  CPPUNIT_TEST(testSync);
   CPPUNIT_TEST(testHTPMerge);
   CPPUNIT_TEST(testLTPMerge);
   CPPUNIT_TEST(testControllerDiscovery);
@@ -114,12 +118,14 @@ class ArtNetNodeTest: public CppUnit::TestFixture {
   void testBasicBehaviour();
   void testConfigurationMode();
   void testExtendedInputPorts();
+  void testExtendedOutputPorts();
   void testBroadcastSendDMX();
   void testBroadcastSendDMXZeroUniverse();
   void testLimitedBroadcastDMX();
   void testNonBroadcastSendDMX();
   void testReceiveDMX();
   void testReceiveDMXZeroUniverse();
+  void testSync();
   void testHTPMerge();
   void testLTPMerge();
   void testControllerDiscovery();
@@ -626,6 +632,142 @@ void ArtNetNodeTest::testExtendedInputPorts() {
   node.EnterConfigurationMode();
   node.ExitConfigurationMode();
   m_socket->Verify();
+
+  // ports can be given a full port address, and changing the subnet moves
+  // every input port by the same amount
+  {
+    SocketVerifier verifer(m_socket);
+    m_socket->SetDiscardMode(true);
+    OLA_ASSERT(node.SetInputPortAddress(5, 0x37));
+    OLA_ASSERT_FALSE(node.SetInputPortAddress(8, 0x37));
+    OLA_ASSERT(node.InputPortState(5));
+    OLA_ASSERT_EQ((uint8_t) 0x37, node.GetInputPortUniverse(5));
+    OLA_ASSERT(node.SetSubnetAddress(1));
+    m_socket->SetDiscardMode(false);
+    OLA_ASSERT_EQ((uint8_t) 0x10, node.GetInputPortUniverse(0));
+    OLA_ASSERT_EQ((uint8_t) 0x47, node.GetInputPortUniverse(5));
+  }
+}
+
+
+/**
+ * Check nodes with more than four output ports.
+ */
+void ArtNetNodeTest::testExtendedOutputPorts() {
+  ArtNetNodeOptions node_options;
+  node_options.output_port_count = 6;
+  ArtNetNode node(iface, &ss, node_options, m_socket);
+
+  node.SetShortName("Short Name");
+  node.SetLongName("This is the very long name");
+  node.SetNetAddress(4);
+  node.SetSubnetAddress(2);
+  node.SetOutputPortUniverse(0, 3);
+  OLA_ASSERT_EQ(6u, node.OutputPortCount());
+  OLA_ASSERT_FALSE(node.SetOutputPortUniverse(6, 3));
+
+  OLA_ASSERT(node.Start());
+  ss.RemoveReadDescriptor(m_socket);
+  m_socket->Verify();
+
+  // the ports are described in two poll replies, one per bind index, and the
+  // second only describes the two remaining ports
+  {
+    SocketVerifier verifer(m_socket);
+    uint8_t first_reply[sizeof(POLL_REPLY_MESSAGE)];
+    memcpy(first_reply, POLL_REPLY_MESSAGE, sizeof(POLL_REPLY_MESSAGE));
+    first_reply[115] = '1';  // node report
+    first_reply[211] = 1;  // bind index
+    ExpectedBroadcast(first_reply, sizeof(first_reply));
+
+    uint8_t second_reply[sizeof(POLL_REPLY_MESSAGE)];
+    memcpy(second_reply, first_reply, sizeof(first_reply));
+    second_reply[19] = 5;  // subnet address
+    second_reply[173] = 2;  // number of ports
+    memset(second_reply + 174, 0, ARTNET_MAX_PORTS);  // port types
+    memset(second_reply + 174, 0x80, 2);
+    memset(second_reply + 178, 0, ARTNET_MAX_PORTS);  // good input
+    memset(second_reply + 178, 8, 2);
+    memset(second_reply + 186, 0, ARTNET_MAX_PORTS);  // swin
+    memset(second_reply + 190, 0, ARTNET_MAX_PORTS);  // swout
+    second_reply[190] = 0x57;
+    second_reply[191] = 0x20;
+    second_reply[211] = 2;  // bind index
+    ExpectedBroadcast(second_reply, sizeof(second_reply));
+
+    OLA_ASSERT(node.SetOutputPortAddress(4, 0x57));
+  }
+
+  OLA_ASSERT_EQ((uint8_t) 0x23, node.GetOutputPortUniverse(0));
+  OLA_ASSERT_EQ((uint8_t) 0x57, node.GetOutputPortUniverse(4));
+  OLA_ASSERT(node.OutputPortState(4));
+  OLA_ASSERT_FALSE(node.OutputPortState(5));
+
+  DmxBuffer input_buffer;
+  node.SetDMXHandler(4,
+                     &input_buffer,
+                     ola::NewCallback(this, &ArtNetNodeTest::NewDmx));
+
+  uint8_t DMX_MESSAGE[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,
+    0x0, 14,
+    0,  // seq #
+    1,  // physical port
+    0x23, 4,  // subnet & net address
+    0, 6,  // dmx length
+    0, 1, 2, 3, 4, 5
+  };
+
+  // data for the first port isn't delivered to the fifth one
+  {
+    SocketVerifier verifer(m_socket);
+    ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+    OLA_ASSERT_FALSE(m_got_dmx);
+  }
+
+  {
+    SocketVerifier verifer(m_socket);
+    DMX_MESSAGE[14] = 0x57;
+    ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+    OLA_ASSERT(m_got_dmx);
+    OLA_ASSERT_EQ(string("0,1,2,3,4,5"), input_buffer.ToString());
+  }
+
+  // once disabled, the port no longer receives data
+  {
+    SocketVerifier verifer(m_socket);
+    m_socket->SetDiscardMode(true);
+    node.DisableOutputPort(4);
+    m_socket->SetDiscardMode(false);
+
+    m_got_dmx = false;
+    DMX_MESSAGE[12] = 1;
+    ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+    OLA_ASSERT_FALSE(m_got_dmx);
+  }
+
+  // changing the subnet moves every output port by the same amount
+  {
+    SocketVerifier verifer(m_socket);
+    m_socket->SetDiscardMode(true);
+    OLA_ASSERT(node.SetSubnetAddress(3));
+    m_socket->SetDiscardMode(false);
+    OLA_ASSERT_EQ((uint8_t) 3, node.SubnetAddress());
+    OLA_ASSERT_EQ((uint8_t) 0x33, node.GetOutputPortUniverse(0));
+    OLA_ASSERT_EQ((uint8_t) 0x67, node.GetOutputPortUniverse(4));
+    OLA_ASSERT_EQ((uint8_t) 0x30, node.GetOutputPortUniverse(5));
+  }
+
+  // the port count is limited to the number of port addresses in a net
+  node_options.output_port_count = 1000;
+  ArtNetNode large_node(iface, &ss, node_options);
+  OLA_ASSERT_EQ(ARTNET_MAX_OUTPUT_PORTS, large_node.OutputPortCount());
+
+  node_options.output_port_count = 1;
+  ArtNetNode small_node(iface, &ss, node_options);
+  OLA_ASSERT_EQ(static_cast<unsigned int>(ARTNET_MAX_PORTS),
+                small_node.OutputPortCount());
 }
 
 
@@ -1017,6 +1159,21 @@ void ArtNetNodeTest::testNonBroadcastSendDMX() {
     ExpectedBroadcast(DMX_MESSAGE3, sizeof(DMX_MESSAGE3));
     OLA_ASSERT(node.SendDMX(m_port_id, dmx));
   }
+
+  // once the nodes time out, the data isn't sent
+  {
+    SocketVerifier verifer(m_socket);
+    node.SetBroadcastThreshold(30);
+    m_clock.AdvanceTime(32, 0);
+    ss.RunOnce();  // update the wake up time
+    m_clock.AdvanceTime(1, 0);
+    ss.RunOnce();  // run the expiry timer
+
+    node_addresses.clear();
+    node.GetSubscribedNodes(m_port_id, &node_addresses);
+    OLA_ASSERT_TRUE(node_addresses.empty());
+    OLA_ASSERT(node.SendDMX(m_port_id, dmx));
+  }
 }
 
 /**
@@ -1093,6 +1250,95 @@ void ArtNetNodeTest::testReceiveDMX() {
   }
 }
 
+/**
+ * Check that ArtSync is sent, and that received data is held until the next
+ * ArtSync.
+ */
+void ArtNetNodeTest::testSync() {
+  m_socket->SetDiscardMode(true);
+  ArtNetNodeOptions node_options;
+  ArtNetNode node(iface, &ss, node_options, m_socket);
+  SetupOutputPort(&node);
+  DmxBuffer input_buffer;
+  node.SetDMXHandler(m_port_id,
+                     &input_buffer,
+                     ola::NewCallback(this, &ArtNetNodeTest::NewDmx));
+
+  OLA_ASSERT(node.Start());
+  ss.RemoveReadDescriptor(m_socket);
+  m_socket->Verify();
+  m_socket->SetDiscardMode(false);
+
+  const uint8_t SYNC_MESSAGE[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x52,
+    0x0, 14,
+    0, 0  // aux
+  };
+
+  {
+    SocketVerifier verifer(m_socket);
+    ExpectedBroadcast(SYNC_MESSAGE, sizeof(SYNC_MESSAGE));
+    OLA_ASSERT(node.SendSync());
+  }
+
+  uint8_t DMX_MESSAGE[] = {
+    'A', 'r', 't', '-', 'N', 'e', 't', 0x00,
+    0x00, 0x50,
+    0x0, 14,
+    0,  // seq #
+    1,  // physical port
+    0x23, 4,  // subnet & net address
+    0, 6,  // dmx length
+    0, 1, 2, 3, 4, 5
+  };
+
+  // without an ArtSync, data is passed through straight away
+  {
+    SocketVerifier verifer(m_socket);
+    ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+    OLA_ASSERT(m_got_dmx);
+  }
+
+  // once we've seen an ArtSync, data is held until the next one
+  {
+    SocketVerifier verifer(m_socket);
+    ReceiveFromPeer(SYNC_MESSAGE, sizeof(SYNC_MESSAGE), peer_ip);
+    m_got_dmx = false;
+    DMX_MESSAGE[12] = 1;
+    ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+    OLA_ASSERT_FALSE(m_got_dmx);
+    ReceiveFromPeer(SYNC_MESSAGE, sizeof(SYNC_MESSAGE), peer_ip);
+    OLA_ASSERT(m_got_dmx);
+    OLA_ASSERT_EQ(string("0,1,2,3,4,5"), input_buffer.ToString());
+  }
+
+  // if the ArtSyncs stop, the held data is released after 4s
+  {
+    SocketVerifier verifer(m_socket);
+    m_got_dmx = false;
+    DMX_MESSAGE[12] = 2;
+    ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+    OLA_ASSERT_FALSE(m_got_dmx);
+    m_clock.AdvanceTime(3, 0);
+    ss.RunOnce();
+    OLA_ASSERT_FALSE(m_got_dmx);
+    m_clock.AdvanceTime(1, 100000);
+    ss.RunOnce();
+    OLA_ASSERT(m_got_dmx);
+  }
+
+  // and from then on data is passed straight through
+  {
+    SocketVerifier verifer(m_socket);
+    m_clock.AdvanceTime(1, 0);
+    m_got_dmx = false;
+    DMX_MESSAGE[12] = 3;
+    ReceiveFromPeer(DMX_MESSAGE, sizeof(DMX_MESSAGE), peer_ip);
+    OLA_ASSERT(m_got_dmx);
+  }
+}
+
 /**
  * Check that receiving DMX for universe 0 works.
  */
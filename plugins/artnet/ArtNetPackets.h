@@ -138,6 +138,15 @@ struct artnet_dmx_s {
 
 typedef struct artnet_dmx_s artnet_dmx_t;
 
+PACK(
+struct artnet_sync_s {
+  uint16_t version;
+  uint8_t  aux1;
+  uint8_t  aux2;
+});
+
+typedef struct artnet_sync_s artnet_sync_t;
+
 PACK(
 struct artnet_todrequest_s {
   uint16_t version;
@@ -257,6 +266,7 @@ typedef struct {
     artnet_reply_t reply;
     artnet_timecode_t timecode;
     artnet_dmx_t dmx;
+    artnet_sync_t sync;
     artnet_todrequest_t tod_request;
     artnet_toddata_t tod_data;
     artnet_todcontrol_t tod_control;
@@ -97,10 +97,18 @@ bool ArtNetPlugin::SetDefaultPreferences() {
   save |= m_preferences->SetDefaultValue(ArtNetDevice::K_SUBNET_KEY,
                                          UIntValidator(0, 15),
                                          ArtNetDevice::K_ARTNET_SUBNET);
+  save |= m_preferences->SetDefaultValue(
+      ArtNetDevice::K_INPUT_PORT_KEY,
+      UIntValidator(0, ARTNET_MAX_OUTPUT_PORTS),
+      ArtNetDevice::K_DEFAULT_INPUT_PORT_COUNT);
   save |= m_preferences->SetDefaultValue(
       ArtNetDevice::K_OUTPUT_PORT_KEY,
       UIntValidator(0, 16),
       ArtNetDevice::K_DEFAULT_OUTPUT_PORT_COUNT);
+  save |= m_preferences->SetDefaultValue(
+      ArtNetDevice::K_RDM_MAX_IN_FLIGHT_KEY,
+      UIntValidator(1, 64),
+      ArtNetDevice::K_DEFAULT_RDM_MAX_IN_FLIGHT);
   save |= m_preferences->SetDefaultValue(ArtNetDevice::K_ALWAYS_BROADCAST_KEY,
                                          BoolValidator(),
                                          false);
@@ -110,6 +118,9 @@ bool ArtNetPlugin::SetDefaultPreferences() {
   save |= m_preferences->SetDefaultValue(ArtNetDevice::K_LOOPBACK_KEY,
                                          BoolValidator(),
                                          false);
+  save |= m_preferences->SetDefaultValue(ArtNetDevice::K_UNIVERSE_OFFSET_KEY,
+                                         BoolValidator(),
+                                         false);
 
   if (save) {
     m_preferences->Save();
@@ -37,11 +37,23 @@ using std::vector;
 
 namespace {
 static const uint8_t ARTNET_UNIVERSE_COUNT = 16;
+
+// With universe_offset the OLA universe is an offset from the node's subnet,
+// so universes past the first sixteen carry on into the following subnets.
+uint8_t OffsetPortAddress(uint8_t subnet_address, unsigned int universe_id) {
+  return static_cast<uint8_t>(((subnet_address << 4) + universe_id) %
+                              ARTNET_MAX_OUTPUT_PORTS);
+}
 };  // namespace
 
 void ArtNetInputPort::PostSetUniverse(Universe *old_universe,
                                       Universe *new_universe) {
-  if (new_universe) {
+  if (new_universe && m_universe_offset) {
+    m_node->SetOutputPortAddress(
+        PortId(),
+        OffsetPortAddress(m_node->SubnetAddress(),
+                          new_universe->UniverseId()));
+  } else if (new_universe) {
     m_node->SetOutputPortUniverse(
         PortId(), new_universe->UniverseId() % ARTNET_UNIVERSE_COUNT);
   } else {
@@ -91,11 +103,12 @@ string ArtNetInputPort::Description() const {
     return "";
   }
 
+  uint8_t port_address = m_node->GetOutputPortUniverse(PortId());
   std::ostringstream str;
   str << "Art-Net Universe "
       << static_cast<int>(m_node->NetAddress()) << ":"
-      << static_cast<int>(m_node->SubnetAddress()) << ":"
-      << static_cast<int>(m_node->GetOutputPortUniverse(PortId()));
+      << static_cast<int>(port_address >> 4) << ":"
+      << static_cast<int>(port_address & 0x0f);
   return str.str();
 }
 
@@ -146,7 +159,12 @@ void ArtNetOutputPort::RunIncrementalDiscovery(
 
 void ArtNetOutputPort::PostSetUniverse(Universe *old_universe,
                                        Universe *new_universe) {
-  if (new_universe) {
+  if (new_universe && m_universe_offset) {
+    m_node->SetInputPortAddress(
+        PortId(),
+        OffsetPortAddress(m_node->SubnetAddress(),
+                          new_universe->UniverseId()));
+  } else if (new_universe) {
     m_node->SetInputPortUniverse(
         PortId(), new_universe->UniverseId() % ARTNET_UNIVERSE_COUNT);
   } else {
@@ -169,11 +187,12 @@ string ArtNetOutputPort::Description() const {
     return "";
   }
 
+  uint8_t port_address = m_node->GetInputPortUniverse(PortId());
   std::ostringstream str;
   str << "Art-Net Universe "
       << static_cast<int>(m_node->NetAddress()) << ":"
-      << static_cast<int>(m_node->SubnetAddress()) << ":"
-      << static_cast<int>(m_node->GetInputPortUniverse(PortId()));
+      << static_cast<int>(port_address >> 4) << ":"
+      << static_cast<int>(port_address & 0x0f);
   return str.str();
 }
 }  // namespace artnet
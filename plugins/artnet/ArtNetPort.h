@@ -36,9 +36,11 @@ class ArtNetInputPort: public BasicInputPort {
   ArtNetInputPort(ArtNetDevice *parent,
                   unsigned int port_id,
                   class PluginAdaptor *plugin_adaptor,
-                  ArtNetNode *node)
+                  ArtNetNode *node,
+                  bool universe_offset)
       : BasicInputPort(parent, port_id, plugin_adaptor, true),
-        m_node(node) {}
+        m_node(node),
+        m_universe_offset(universe_offset) {}
 
   const DmxBuffer &ReadDMX() const { return m_buffer; }
 
@@ -57,6 +59,7 @@ class ArtNetInputPort: public BasicInputPort {
  private:
   DmxBuffer m_buffer;
   ArtNetNode *m_node;
+  const bool m_universe_offset;
 
   /**
    * Send a list of UIDs in a TOD
@@ -73,9 +76,11 @@ class ArtNetOutputPort: public BasicOutputPort {
  public:
   ArtNetOutputPort(ArtNetDevice *device,
                    unsigned int port_id,
-                   ArtNetNode *node)
+                   ArtNetNode *node,
+                   bool universe_offset)
       : BasicOutputPort(device, port_id, true, true),
-        m_node(node) {}
+        m_node(node),
+        m_universe_offset(universe_offset) {}
 
   bool WriteDMX(const DmxBuffer &buffer, uint8_t priority);
 
@@ -112,8 +117,14 @@ class ArtNetOutputPort: public BasicOutputPort {
     return m_node->SendTimeCode(timecode);
   }
 
+  // ArtSync applies to all universes, so the sync group isn't used.
+  bool SendSync(unsigned int) {
+    return m_node->SendSync();
+  }
+
  private:
   ArtNetNode *m_node;
+  const bool m_universe_offset;
 };
 }  // namespace artnet
 }  // namespace plugin
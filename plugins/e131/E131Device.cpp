@@ -99,6 +99,9 @@ bool E131Device::StartHook() {
   }
 
   m_plugin_adaptor->AddReadDescriptor(m_node->GetSocket());
+  if (m_node->GetCaptureDescriptor()) {
+    m_plugin_adaptor->AddReadDescriptor(m_node->GetCaptureDescriptor());
+  }
   return true;
 }
 
@@ -108,6 +111,9 @@ bool E131Device::StartHook() {
  */
 void E131Device::PrePortStop() {
   m_plugin_adaptor->RemoveReadDescriptor(m_node->GetSocket());
+  if (m_node->GetCaptureDescriptor()) {
+    m_plugin_adaptor->RemoveReadDescriptor(m_node->GetCaptureDescriptor());
+  }
 }
 
 
@@ -100,7 +100,25 @@ bool E131OutputPort::WriteDMX(const DmxBuffer &buffer, uint8_t priority) {
   m_last_priority = (GetPriorityMode() == PRIORITY_MODE_STATIC) ?
       GetPriority() : priority;
   return m_node->SendDMX(universe->UniverseId(), buffer, m_last_priority,
-                         m_preview_on);
+                         m_preview_on, SyncAddress(universe->SyncGroup()));
+}
+
+
+/*
+ * Send the synchronization message for a sync group.
+ */
+bool E131OutputPort::SendSync(unsigned int sync_group) {
+  uint16_t sync_address = SyncAddress(sync_group);
+  return sync_address ? m_node->SendSynchronization(sync_address) : false;
+}
+
+
+/*
+ * The sync group is used as the sync address, if it's a valid E1.31 universe.
+ */
+uint16_t E131OutputPort::SyncAddress(unsigned int sync_group) const {
+  return sync_group <= E131PortHelper::MAX_E131_UNIVERSE ?
+      static_cast<uint16_t>(sync_group) : 0;
 }
 }  // namespace e131
 }  // namespace plugin
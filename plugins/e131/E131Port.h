@@ -34,7 +34,7 @@ class E131PortHelper {
  public:
   bool PreSetUniverse(Universe *old_universe, Universe *new_universe);
   std::string Description(Universe *universe) const;
- private:
+
   static const unsigned int MAX_E131_UNIVERSE = 63999;
 };
 
@@ -88,6 +88,7 @@ class E131OutputPort: public BasicOutputPort {
   }
 
   bool WriteDMX(const ola::DmxBuffer &buffer, uint8_t priority);
+  bool SendSync(unsigned int sync_group);
 
   void SetPreviewMode(bool preview_mode) { m_preview_on = preview_mode; }
   bool PreviewMode() const { return m_preview_on; }
@@ -99,6 +100,8 @@ class E131OutputPort: public BasicOutputPort {
   ola::DmxBuffer m_buffer;
   ola::acn::E131Node *m_node;
   E131PortHelper m_helper;
+
+  uint16_t SyncAddress(unsigned int sync_group) const;
 };
 }  // namespace e131
 }  // namespace plugin
@@ -37,10 +37,12 @@ using std::string;
 
 FtdiDmxDevice::FtdiDmxDevice(AbstractPlugin *owner,
                              const FtdiWidgetInfo &widget_info,
-                             unsigned int frequency)
+                             const ola::dmx::FrameTimer::Options &timer_options,
+                             class PluginAdaptor *plugin_adaptor)
     : Device(owner, widget_info.Description()),
       m_widget_info(widget_info),
-      m_frequency(frequency) {
+      m_timer_options(timer_options),
+      m_plugin_adaptor(plugin_adaptor) {
   m_widget = new FtdiWidget(widget_info.Serial(),
                             widget_info.Name(),
                             widget_info.Id(),
@@ -64,7 +66,8 @@ bool FtdiDmxDevice::StartHook() {
     FtdiInterface *port = new FtdiInterface(m_widget,
                                             static_cast<ftdi_interface>(i));
     if (port->SetupOutput()) {
-      AddPort(new FtdiDmxOutputPort(this, port, i, m_frequency));
+      AddPort(new FtdiDmxOutputPort(this, port, i, m_timer_options,
+                                    m_plugin_adaptor));
       successfully_added += 1;
     } else {
       OLA_WARN << "Failed to add interface: " << i;
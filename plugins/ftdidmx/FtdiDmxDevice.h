@@ -29,6 +29,7 @@
 #include <string>
 #include <memory>
 #include "ola/DmxBuffer.h"
+#include "ola/dmx/FrameTimer.h"
 #include "olad/Device.h"
 #include "olad/Preferences.h"
 #include "plugins/ftdidmx/FtdiWidget.h"
@@ -41,7 +42,8 @@ class FtdiDmxDevice : public Device {
  public:
   FtdiDmxDevice(AbstractPlugin *owner,
                 const FtdiWidgetInfo &widget_info,
-                unsigned int frequency);
+                const ola::dmx::FrameTimer::Options &timer_options,
+                class PluginAdaptor *plugin_adaptor);
   ~FtdiDmxDevice();
 
   std::string DeviceId() const { return m_widget->Serial(); }
@@ -58,7 +60,8 @@ class FtdiDmxDevice : public Device {
  private:
   FtdiWidget *m_widget;
   const FtdiWidgetInfo m_widget_info;
-  unsigned int m_frequency;
+  const ola::dmx::FrameTimer::Options m_timer_options;
+  class PluginAdaptor *m_plugin_adaptor;
 };
 }  // namespace ftdidmx
 }  // namespace plugin
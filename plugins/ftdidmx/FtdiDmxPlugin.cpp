@@ -41,7 +41,9 @@ namespace ftdidmx {
 using std::string;
 using std::vector;
 
+const char FtdiDmxPlugin::K_CPU[] = "cpu";
 const char FtdiDmxPlugin::K_FREQUENCY[] = "frequency";
+const char FtdiDmxPlugin::K_REALTIME_PRIORITY[] = "realtime_priority";
 const char FtdiDmxPlugin::PLUGIN_NAME[] = "FTDI USB DMX";
 const char FtdiDmxPlugin::PLUGIN_PREFIX[] = "ftdidmx";
 
@@ -69,13 +71,21 @@ bool FtdiDmxPlugin::StartHook() {
   FtdiWidgetInfoVector widgets;
   FtdiWidget::Widgets(&widgets);
 
-  unsigned int frequency = StringToIntOrDefault(
+  ola::dmx::FrameTimer::Options timer_options;
+  timer_options.frame_rate = StringToIntOrDefault(
       m_preferences->GetValue(K_FREQUENCY),
-      DEFAULT_FREQUENCY);
+      static_cast<unsigned int>(DEFAULT_FREQUENCY));
+  timer_options.realtime_priority = StringToIntOrDefault(
+      m_preferences->GetValue(K_REALTIME_PRIORITY),
+      DEFAULT_REALTIME_PRIORITY);
+  timer_options.cpu = StringToIntOrDefault(
+      m_preferences->GetValue(K_CPU),
+      DEFAULT_CPU);
 
   FtdiWidgetInfoVector::const_iterator iter;
   for (iter = widgets.begin(); iter != widgets.end(); ++iter) {
-    AddDevice(new FtdiDmxDevice(this, *iter, frequency));
+    AddDevice(new FtdiDmxDevice(this, *iter, timer_options,
+                                m_plugin_adaptor));
   }
   return true;
 }
@@ -112,9 +122,17 @@ bool FtdiDmxPlugin::SetDefaultPreferences() {
     return false;
   }
 
-  if (m_preferences->SetDefaultValue(FtdiDmxPlugin::K_FREQUENCY,
-                                     UIntValidator(1, 44),
-                                     DEFAULT_FREQUENCY)) {
+  bool save = false;
+  save |= m_preferences->SetDefaultValue(FtdiDmxPlugin::K_FREQUENCY,
+                                         UIntValidator(1, 44),
+                                         DEFAULT_FREQUENCY);
+  save |= m_preferences->SetDefaultValue(FtdiDmxPlugin::K_REALTIME_PRIORITY,
+                                         UIntValidator(0, 99),
+                                         DEFAULT_REALTIME_PRIORITY);
+  save |= m_preferences->SetDefaultValue(FtdiDmxPlugin::K_CPU,
+                                         IntValidator(-1, 1023),
+                                         DEFAULT_CPU);
+  if (save) {
     m_preferences->Save();
   }
 
@@ -64,8 +64,12 @@ class FtdiDmxPlugin : public Plugin {
   bool SetDefaultPreferences();
 
   static const uint8_t DEFAULT_FREQUENCY = 30;
+  static const unsigned int DEFAULT_REALTIME_PRIORITY = 0;
+  static const int DEFAULT_CPU = -1;
 
+  static const char K_CPU[];
   static const char K_FREQUENCY[];
+  static const char K_REALTIME_PRIORITY[];
   static const char PLUGIN_NAME[];
   static const char PLUGIN_PREFIX[];
 };
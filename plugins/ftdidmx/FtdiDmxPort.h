@@ -29,6 +29,8 @@
 #include <string>
 
 #include "ola/DmxBuffer.h"
+#include "ola/StringUtils.h"
+#include "ola/dmx/FrameTimer.h"
 #include "olad/Port.h"
 #include "olad/Preferences.h"
 #include "plugins/ftdidmx/FtdiDmxDevice.h"
@@ -44,10 +46,12 @@ class FtdiDmxOutputPort : public ola::BasicOutputPort {
     FtdiDmxOutputPort(FtdiDmxDevice *parent,
                       FtdiInterface *interface,
                       unsigned int id,
-                      unsigned int freq)
+                      const ola::dmx::FrameTimer::Options &timer_options,
+                      class PluginAdaptor *plugin_adaptor)
         : BasicOutputPort(parent, id),
           m_interface(interface),
-          m_thread(interface, freq) {
+          m_thread(interface, timer_options, plugin_adaptor,
+                   parent->DeviceId() + "-" + IntToString(id)) {
       m_thread.Start();
     }
     ~FtdiDmxOutputPort() {
@@ -23,12 +23,8 @@
  * by E.S. Rosenberg a.k.a. Keeper of the Keys 5774/2014
  */
 
-#include <math.h>
-#include <unistd.h>
-
 #include <string>
 
-#include "ola/Clock.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
 #include "plugins/ftdidmx/FtdiWidget.h"
@@ -38,11 +34,14 @@ namespace ola {
 namespace plugin {
 namespace ftdidmx {
 
-FtdiDmxThread::FtdiDmxThread(FtdiInterface *interface, unsigned int frequency)
-  : m_granularity(UNKNOWN),
-    m_interface(interface),
+FtdiDmxThread::FtdiDmxThread(FtdiInterface *interface,
+                             const ola::dmx::FrameTimer::Options &timer_options,
+                             PluginAdaptor *plugin_adaptor,
+                             const std::string &name)
+  : m_interface(interface),
     m_term(false),
-    m_frequency(frequency) {
+    m_timer(timer_options, plugin_adaptor->GetExportMap(), name,
+            plugin_adaptor) {
 }
 
 FtdiDmxThread::~FtdiDmxThread() {
@@ -63,14 +62,11 @@ bool FtdiDmxThread::Stop() {
 
 
 /**
- * @brief Copy a DMXBuffer to the output thread
+ * @brief Hand a DMXBuffer to the output thread
  */
 bool FtdiDmxThread::WriteDMX(const DmxBuffer &buffer) {
-  {
-    ola::thread::MutexLocker locker(&m_buffer_mutex);
-    m_buffer.Set(buffer);
-    return true;
-  }
+  m_mailbox.Publish(buffer);
+  return true;
 }
 
 
@@ -78,13 +74,8 @@ bool FtdiDmxThread::WriteDMX(const DmxBuffer &buffer) {
  * @brief The method called by the thread
  */
 void *FtdiDmxThread::Run() {
-  TimeStamp ts1, ts2, ts3;
-  Clock clock;
-  CheckTimeGranularity();
-  DmxBuffer buffer;
-
-  int frameTime = static_cast<int>(floor(
-    (static_cast<double>(1000) / m_frequency) + static_cast<double>(0.5)));
+  m_timer.ConfigureThread();
+  const DmxFrame *frame = DmxFrame::Create(DmxBuffer());
 
   // Setup the interface
   if (!m_interface->IsOpen()) {
@@ -99,82 +90,30 @@ void *FtdiDmxThread::Run() {
       }
     }
 
-    {
-      ola::thread::MutexLocker locker(&m_buffer_mutex);
-      buffer.Set(m_buffer);
-    }
+    // Wait until the next frame is due
+    m_timer.StartFrame();
 
-    clock.CurrentMonotonicTime(&ts1);
+    // Take the latest frame once the wait is over, so it's as fresh as
+    // possible.
+    m_mailbox.Update(&frame);
 
     if (!m_interface->SetBreak(true)) {
-      goto framesleep;
+      continue;
     }
 
-    if (m_granularity == GOOD) {
-      usleep(DMX_BREAK);
-    }
+    m_timer.Delay(DMX_BREAK);
 
     if (!m_interface->SetBreak(false)) {
-      goto framesleep;
-    }
-
-    if (m_granularity == GOOD) {
-      usleep(DMX_MAB);
-    }
-
-    if (!m_interface->Write(buffer)) {
-      goto framesleep;
+      continue;
     }
 
-  framesleep:
-    // Sleep for the remainder of the DMX frame time
-    clock.CurrentMonotonicTime(&ts2);
-    TimeInterval elapsed = ts2 - ts1;
+    m_timer.Delay(DMX_MAB);
 
-    if (m_granularity == GOOD) {
-      while (elapsed.InMilliSeconds() < frameTime) {
-        usleep(1000);
-        clock.CurrentMonotonicTime(&ts2);
-        elapsed = ts2 - ts1;
-      }
-    } else {
-      // See if we can drop out of bad mode.
-      usleep(1000);
-      clock.CurrentMonotonicTime(&ts3);
-      TimeInterval interval = ts3 - ts2;
-      if (interval.InMilliSeconds() < BAD_GRANULARITY_LIMIT) {
-        m_granularity = GOOD;
-        OLA_INFO << "Switching from BAD to GOOD granularity for ftdi thread";
-      }
-
-      elapsed = ts3 - ts1;
-      while (elapsed.InMilliSeconds() < frameTime) {
-        clock.CurrentMonotonicTime(&ts2);
-        elapsed = ts2 - ts1;
-      }
-    }
+    m_interface->Write(*frame);
   }
+  frame->Unref();
   return NULL;
 }
-
-
-/**
- * @brief Check the granularity of usleep.
- */
-void FtdiDmxThread::CheckTimeGranularity() {
-  TimeStamp ts1, ts2;
-  Clock clock;
-
-  clock.CurrentMonotonicTime(&ts1);
-  usleep(1000);
-  clock.CurrentMonotonicTime(&ts2);
-
-  TimeInterval interval = ts2 - ts1;
-  m_granularity = (interval.InMilliSeconds() > BAD_GRANULARITY_LIMIT) ?
-      BAD : GOOD;
-  OLA_INFO << "Granularity for FTDI thread is "
-           << ((m_granularity == GOOD) ? "GOOD" : "BAD");
-}
 }  // namespace ftdidmx
 }  // namespace plugin
 }  // namespace ola
@@ -26,8 +26,12 @@
 #ifndef PLUGINS_FTDIDMX_FTDIDMXTHREAD_H_
 #define PLUGINS_FTDIDMX_FTDIDMXTHREAD_H_
 
+#include <string>
 #include "ola/DmxBuffer.h"
+#include "ola/DmxFrame.h"
+#include "ola/dmx/FrameTimer.h"
 #include "ola/thread/Thread.h"
+#include "olad/PluginAdaptor.h"
 
 namespace ola {
 namespace plugin {
@@ -35,7 +39,10 @@ namespace ftdidmx {
 
 class FtdiDmxThread : public ola::thread::Thread {
  public:
-    FtdiDmxThread(FtdiInterface *interface, unsigned int frequency);
+    FtdiDmxThread(FtdiInterface *interface,
+                  const ola::dmx::FrameTimer::Options &timer_options,
+                  PluginAdaptor *plugin_adaptor,
+                  const std::string &name);
     ~FtdiDmxThread();
 
     bool Stop();
@@ -43,21 +50,14 @@ class FtdiDmxThread : public ola::thread::Thread {
     bool WriteDMX(const DmxBuffer &buffer);
 
  private:
-    enum TimerGranularity { UNKNOWN, GOOD, BAD };
-
-    TimerGranularity m_granularity;
     FtdiInterface *m_interface;
     bool m_term;
-    unsigned int m_frequency;
-    DmxBuffer m_buffer;
+    ola::dmx::FrameTimer m_timer;
+    DmxFrameMailbox m_mailbox;
     ola::thread::Mutex m_term_mutex;
-    ola::thread::Mutex m_buffer_mutex;
-
-    void CheckTimeGranularity();
 
     static const uint32_t DMX_MAB = 16;
     static const uint32_t DMX_BREAK = 110;
-    static const uint32_t BAD_GRANULARITY_LIMIT = 3;
 };
 }  // namespace ftdidmx
 }  // namespace plugin
@@ -349,14 +349,10 @@ bool FtdiInterface::SetBreak(bool on) {
   }
 }
 
-bool FtdiInterface::Write(const ola::DmxBuffer& data) {
-  unsigned char buffer[DMX_UNIVERSE_SIZE + 1];
-  unsigned int length = DMX_UNIVERSE_SIZE;
-  buffer[0] = DMX512_START_CODE;
-
-  data.Get(buffer + 1, &length);
-
-  if (ftdi_write_data(&m_handle, buffer, length + 1) < 0) {
+bool FtdiInterface::Write(const ola::DmxFrame &frame) {
+  // libftdi0 takes a non-const buffer, even though it's never modified.
+  unsigned char *packet = const_cast<unsigned char*>(frame.Packet());
+  if (ftdi_write_data(&m_handle, packet, frame.PacketSize()) < 0) {
     OLA_WARN << m_parent->Description() << " "
              << ftdi_get_error_string(&m_handle);
     return false;
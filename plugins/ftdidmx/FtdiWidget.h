@@ -51,7 +51,7 @@
 #include <string>
 #include <vector>
 
-#include "ola/DmxBuffer.h"
+#include "ola/DmxFrame.h"
 
 namespace ola {
 namespace plugin {
@@ -225,7 +225,7 @@ class FtdiInterface {
   bool SetBreak(bool on);
 
   /** @brief Write data to a previously-opened line */
-  bool Write(const ola::DmxBuffer &data);
+  bool Write(const ola::DmxFrame &frame);
 
   /** @brief Read data from a previously-opened line */
   bool Read(unsigned char* buff, int size);
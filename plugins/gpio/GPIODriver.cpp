@@ -72,10 +72,10 @@ bool GPIODriver::Init() {
 }
 
 bool GPIODriver::SendDmx(const DmxBuffer &dmx) {
+  m_mailbox.Publish(dmx);
   {
+    // The lock only protects the flag used to wake the output thread.
     MutexLocker locker(&m_mutex);
-    // avoid the reference counting
-    m_buffer.Set(dmx);
     m_dmx_changed = true;
   }
   m_cond.Signal();
@@ -84,7 +84,7 @@ bool GPIODriver::SendDmx(const DmxBuffer &dmx) {
 
 void *GPIODriver::Run() {
   Clock clock;
-  DmxBuffer output;
+  const DmxFrame *output = NULL;
 
   while (true) {
     bool update_pins = false;
@@ -104,15 +104,17 @@ void *GPIODriver::Run() {
       m_mutex.Unlock();
       break;
     } else if (m_dmx_changed) {
-      output.Set(m_buffer);
       m_dmx_changed = false;
       update_pins = true;
     }
     m_mutex.Unlock();
-    if (update_pins) {
-      UpdateGPIOPins(output);
+    if (update_pins && m_mailbox.Update(&output)) {
+      UpdateGPIOPins(*output);
     }
   }
+  if (output) {
+    output->Unref();
+  }
   return NULL;
 }
 
@@ -161,7 +163,7 @@ bool GPIODriver::SetupGPIO() {
   return true;
 }
 
-bool GPIODriver::UpdateGPIOPins(const DmxBuffer &dmx) {
+bool GPIODriver::UpdateGPIOPins(const DmxFrame &dmx) {
   enum Action {
     TURN_ON,
     TURN_OFF,
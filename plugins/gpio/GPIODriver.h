@@ -23,6 +23,7 @@
 
 #include <stdint.h>
 #include <ola/DmxBuffer.h>
+#include <ola/DmxFrame.h>
 #include <ola/base/Macro.h>
 #include <ola/thread/Thread.h>
 
@@ -115,14 +116,14 @@ class GPIODriver : private ola::thread::Thread {
   const Options m_options;
   GPIOPins m_gpio_pins;
 
-  DmxBuffer m_buffer;
+  DmxFrameMailbox m_mailbox;
   bool m_term;  // GUARDED_BY(m_mutex);
   bool m_dmx_changed;  // GUARDED_BY(m_mutex);
   ola::thread::Mutex m_mutex;
   ola::thread::ConditionVariable m_cond;
 
   bool SetupGPIO();
-  bool UpdateGPIOPins(const DmxBuffer &dmx);
+  bool UpdateGPIOPins(const DmxFrame &dmx);
   void CloseGPIOFDs();
 
   static const char GPIO_BASE_DIR[];
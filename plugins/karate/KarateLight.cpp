@@ -31,7 +31,7 @@
 #include <string>
 
 #include "ola/Constants.h"
-#include "ola/DmxBuffer.h"
+#include "ola/DmxFrame.h"
 #include "ola/Logging.h"
 #include "ola/io/IOUtils.h"
 #include "ola/strings/Format.h"
@@ -212,15 +212,15 @@ bool KarateLight::Blank() {
 }
 
 /**
- * @brief Copy contents of the DmxBuffer into my local scope
+ * @brief Copy contents of the DmxFrame into my local scope
  * @returns true on success
  */
-bool KarateLight::SetColors(const DmxBuffer &da) {
-  // make sure not to request data beyond the bounds of the universe
-  unsigned int length = std::min(static_cast<int>(da.Size()),
-                                 DMX_UNIVERSE_SIZE - m_dmx_offset);
-
-  da.GetRange(m_dmx_offset, m_color_buffer, &length);
+bool KarateLight::SetColors(const DmxFrame &frame) {
+  // make sure not to request data beyond the bounds of the frame
+  if (m_dmx_offset < frame.Size()) {
+    memcpy(m_color_buffer, frame.GetRaw() + m_dmx_offset,
+           frame.Size() - m_dmx_offset);
+  }
   return KarateLight::UpdateColors();
 }
 
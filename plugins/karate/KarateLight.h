@@ -24,7 +24,7 @@
 #include <string>
 
 #include "ola/Constants.h"
-#include "ola/DmxBuffer.h"
+#include "ola/DmxFrame.h"
 
 namespace ola {
 namespace plugin {
@@ -38,7 +38,7 @@ class KarateLight {
   void Close();
 
   bool Blank();
-  bool SetColors(const DmxBuffer &da);
+  bool SetColors(const DmxFrame &frame);
 
   uint16_t GetnChannels() const { return m_nChannels; }
   uint8_t GetFWVersion() const { return m_fw_version; }
@@ -65,6 +65,7 @@ void *KarateThread::Run() {
 
   KarateLight k(m_path);
   k.Init();
+  const DmxFrame *frame = DmxFrame::Create(DmxBuffer());
 
   while (true) {
     {
@@ -91,10 +92,8 @@ void *KarateThread::Run() {
       k.Init();
 
     } else {
-      {
-        MutexLocker locker(&m_mutex);
-        write_success = k.SetColors(m_buffer);
-      }
+      m_mailbox.Update(&frame);
+      write_success = k.SetColors(*frame);
       if (!write_success) {
         OLA_WARN << "Failed to write color data";
       }  else {
@@ -102,6 +101,7 @@ void *KarateThread::Run() {
       }
     }  // port is okay
   }
+  frame->Unref();
   return NULL;
 }
 
@@ -111,7 +111,7 @@ void *KarateThread::Run() {
  */
 bool KarateThread::Stop() {
   {
-    MutexLocker locker(&m_mutex);
+    MutexLocker locker(&m_term_mutex);
     m_term = true;
   }
   m_term_cond.Signal();
@@ -120,12 +120,10 @@ bool KarateThread::Stop() {
 
 
 /**
- * @brief Store the data in the shared buffer.
+ * @brief Hand the data to the output thread.
  */
 bool KarateThread::WriteDmx(const DmxBuffer &buffer) {
-  MutexLocker locker(&m_mutex);
-  // avoid the reference counting
-  m_buffer.Set(buffer);
+  m_mailbox.Publish(buffer);
   return true;
 }
 }  // namespace karate
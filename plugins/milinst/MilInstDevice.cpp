@@ -22,6 +22,7 @@
 #include <string>
 
 #include "ola/Logging.h"
+#include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
 #include "plugins/milinst/MilInstPort.h"
 #include "plugins/milinst/MilInstWidget1463.h"
@@ -49,10 +50,12 @@ const char MilInstDevice::TYPE_1553[] = "1-553";
  * @param owner  the plugin that owns this device
  * @param name  the device name
  * @param dev_path  path to the pro widget
+ * @param plugin_adaptor the PluginAdaptor the widget's descriptor is added to
  */
 MilInstDevice::MilInstDevice(AbstractPlugin *owner,
                              Preferences *preferences,
-                             const string &dev_path)
+                             const string &dev_path,
+                             PluginAdaptor *plugin_adaptor)
     : Device(owner, MILINST_DEVICE_NAME),
       m_path(dev_path),
       m_preferences(preferences) {
@@ -63,9 +66,10 @@ MilInstDevice::MilInstDevice(AbstractPlugin *owner,
   OLA_DEBUG << "Got type " << type;
 
   if (type.compare(TYPE_1553) == 0) {
-    m_widget.reset(new MilInstWidget1553(m_path, m_preferences));
+    m_widget.reset(new MilInstWidget1553(plugin_adaptor, m_path,
+                                           m_preferences));
   } else {
-    m_widget.reset(new MilInstWidget1463(m_path));
+    m_widget.reset(new MilInstWidget1463(plugin_adaptor, m_path));
   }
 }
 
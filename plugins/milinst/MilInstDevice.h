@@ -37,7 +37,8 @@ class MilInstDevice: public ola::Device {
  public:
   MilInstDevice(AbstractPlugin *owner,
                 class Preferences *preferences,
-                const std::string &dev_path);
+                const std::string &dev_path,
+                class PluginAdaptor *plugin_adaptor);
   ~MilInstDevice();
 
   std::string DeviceId() const { return m_path; }
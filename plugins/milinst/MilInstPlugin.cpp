@@ -60,7 +60,7 @@ bool MilInstPlugin::StartHook() {
       continue;
     }
 
-    device = new MilInstDevice(this, m_preferences, *it);
+    device = new MilInstDevice(this, m_preferences, *it, m_plugin_adaptor);
     OLA_DEBUG << "Adding device " << *it;
 
     if (!device->Start()) {
@@ -34,6 +34,7 @@ using std::string;
  * New widget
  */
 MilInstWidget::~MilInstWidget() {
+  delete m_serial;
   if (m_socket) {
     m_socket->Close();
     delete m_socket;
@@ -74,6 +75,9 @@ int MilInstWidget::ConnectToWidget(const string &path, speed_t speed) {
  * Disconnect from the widget
  */
 int MilInstWidget::Disconnect() {
+  // Drop any pending write before the descriptor is closed.
+  delete m_serial;
+  m_serial = NULL;
   m_socket->Close();
   return 0;
 }
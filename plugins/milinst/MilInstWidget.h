@@ -26,6 +26,7 @@
 #include <string>
 
 #include "ola/io/SelectServer.h"
+#include "ola/io/SerialBuffer.h"
 #include "ola/DmxBuffer.h"
 
 namespace ola {
@@ -36,10 +37,12 @@ class MilInstWidget {
  public:
   static int ConnectToWidget(const std::string &path, speed_t speed = B9600);
 
-  explicit MilInstWidget(const std::string &path)
-      : m_enabled(false),
+  MilInstWidget(ola::io::SelectServerInterface *ss, const std::string &path)
+      : m_ss(ss),
+        m_enabled(false),
         m_path(path),
-        m_socket(NULL) {}
+        m_socket(NULL),
+        m_serial(NULL) {}
 
   virtual ~MilInstWidget();
 
@@ -63,9 +66,12 @@ class MilInstWidget {
   virtual int SetChannel(unsigned int chan, uint8_t val) const = 0;
 
   // instance variables
+  ola::io::SelectServerInterface *m_ss;
   bool m_enabled;
   const std::string m_path;
   ola::io::ConnectedDescriptor *m_socket;
+  // Buffers reads and writes on m_socket, created in Connect().
+  ola::io::SerialBuffer *m_serial;
 };
 }  // namespace milinst
 }  // namespace plugin
@@ -39,6 +39,7 @@ bool MilInstWidget1463::Connect() {
     return false;
 
   m_socket = new ola::io::DeviceDescriptor(fd);
+  m_serial = new ola::io::SerialBuffer(m_socket, m_ss);
 
   OLA_DEBUG << "Connected to " << m_path;
   return true;
@@ -79,7 +80,7 @@ int MilInstWidget1463::SetChannel(unsigned int chan, uint8_t val) const {
   msg[0] = chan;
   msg[1] = val;
   OLA_DEBUG << "Setting " << chan << " to " << static_cast<int>(val);
-  return m_socket->Send(msg, sizeof(msg));
+  return m_serial->Send(msg, sizeof(msg)) ? sizeof(msg) : 0;
 }
 
 
@@ -92,13 +93,13 @@ int MilInstWidget1463::Send112(const DmxBuffer &buffer) const {
                                    buffer.Size());
   uint8_t msg[channels * 2];
 
-  for (unsigned int i = 0; i <= channels; i++) {
+  for (unsigned int i = 0; i < channels; i++) {
     msg[i * 2] = i + 1;
     msg[(i * 2) + 1] = buffer.Get(i);
     OLA_DEBUG << "Setting " << (i + 1) << " to " <<
         static_cast<int>(buffer.Get(i));
   }
-  return m_socket->Send(msg, (channels * 2));
+  return m_serial->Send(msg, channels * 2) ? channels * 2 : 0;
 }
 }  // namespace milinst
 }  // namespace plugin
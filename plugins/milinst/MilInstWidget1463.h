@@ -31,7 +31,9 @@ namespace milinst {
 
 class MilInstWidget1463: public MilInstWidget {
  public:
-  explicit MilInstWidget1463(const std::string &path): MilInstWidget(path) {}
+  MilInstWidget1463(ola::io::SelectServerInterface *ss,
+                    const std::string &path)
+      : MilInstWidget(ss, path) {}
   ~MilInstWidget1463() {}
 
   bool Connect();
@@ -44,9 +44,10 @@ const uint16_t MilInstWidget1553::CHANNELS_512 = 512;
 const uint16_t MilInstWidget1553::DEFAULT_CHANNELS = CHANNELS_128;
 
 
-MilInstWidget1553::MilInstWidget1553(const string &path,
+MilInstWidget1553::MilInstWidget1553(ola::io::SelectServerInterface *ss,
+                                     const string &path,
                                      Preferences *preferences)
-    : MilInstWidget(path),
+    : MilInstWidget(ss, path),
       m_preferences(preferences) {
   SetWidgetDefaults();
 
@@ -78,6 +79,7 @@ bool MilInstWidget1553::Connect() {
   }
 
   m_socket = new ola::io::DeviceDescriptor(fd);
+  m_serial = new ola::io::SerialBuffer(m_socket, m_ss);
   m_socket->SetOnData(
       NewCallback<MilInstWidget1553>(this, &MilInstWidget1553::SocketReady));
 
@@ -90,16 +92,11 @@ bool MilInstWidget1553::Connect() {
  * Called when there is data to read
  */
 void MilInstWidget1553::SocketReady() {
-  while (m_socket->DataRemaining() > 0) {
-    uint8_t byte = 0x00;
-    unsigned int data_read;
-
-    int ret = m_socket->Receive(&byte, 1, data_read);
-
-    if (ret == -1 || data_read != 1) {
-    } else {
-      OLA_DEBUG << "Received byte " << static_cast<int>(byte);
+  while (m_serial->Read()) {
+    for (unsigned int i = 0; i < m_serial->Size(); i++) {
+      OLA_DEBUG << "Received byte " << static_cast<int>(m_serial->Data()[i]);
     }
+    m_serial->Clear();
   }
 }
 
@@ -139,7 +136,7 @@ int MilInstWidget1553::SetChannel(unsigned int chan, uint8_t val) const {
   ola::utils::SplitUInt16(chan, &msg[1], &msg[2]);
   msg[3] = val;
   OLA_DEBUG << "Setting " << chan << " to " << static_cast<int>(val);
-  return m_socket->Send(msg, sizeof(msg));
+  return m_serial->Send(msg, sizeof(msg)) ? sizeof(msg) : 0;
 }
 
 
@@ -157,7 +154,7 @@ int MilInstWidget1553::Send(const DmxBuffer &buffer) const {
 
   buffer.Get(msg + 3, &channels);
 
-  return m_socket->Send(msg, sizeof(msg));
+  return m_serial->Send(msg, sizeof(msg)) ? sizeof(msg) : 0;
 }
 
 
@@ -31,7 +31,9 @@ namespace milinst {
 
 class MilInstWidget1553: public MilInstWidget {
  public:
-  explicit MilInstWidget1553(const std::string &path, Preferences *preferences);
+  MilInstWidget1553(ola::io::SelectServerInterface *ss,
+                    const std::string &path,
+                    Preferences *preferences);
   ~MilInstWidget1553() {}
 
   bool Connect();
@@ -60,14 +60,11 @@ OpenDmxThread::OpenDmxThread(const string &path)
  * Run this thread
  */
 void *OpenDmxThread::Run() {
-  uint8_t buffer[DMX_UNIVERSE_SIZE+1];
-  unsigned int length = DMX_UNIVERSE_SIZE;
+  const DmxFrame *frame = DmxFrame::Create(DmxBuffer());
   Clock clock;
 
   // should close other fd here
 
-  // start code
-  buffer[0] = 0x00;
   ola::io::Open(m_path, O_WRONLY, &m_fd);
 
   while (true) {
@@ -93,13 +90,9 @@ void *OpenDmxThread::Run() {
       ola::io::Open(m_path, O_WRONLY, &m_fd);
 
     } else {
-      length = DMX_UNIVERSE_SIZE;
-      {
-        MutexLocker locker(&m_mutex);
-        m_buffer.Get(buffer + 1, &length);
-      }
+      m_mailbox.Update(&frame);
 
-      if (write(m_fd, buffer, length + 1) < 0) {
+      if (write(m_fd, frame->Packet(), frame->PacketSize()) < 0) {
         // if you unplug the dongle
         OLA_WARN << "Error writing to device: " << strerror(errno);
 
@@ -109,6 +102,7 @@ void *OpenDmxThread::Run() {
       }
     }
   }
+  frame->Unref();
   return NULL;
 }
 
@@ -118,7 +112,7 @@ void *OpenDmxThread::Run() {
  */
 bool OpenDmxThread::Stop() {
   {
-    MutexLocker locker(&m_mutex);
+    MutexLocker locker(&m_term_mutex);
     m_term = true;
   }
   m_term_cond.Signal();
@@ -127,13 +121,10 @@ bool OpenDmxThread::Stop() {
 
 
 /*
- * Store the data in the shared buffer
- *
+ * Hand the data to the output thread
  */
 bool OpenDmxThread::WriteDmx(const DmxBuffer &buffer) {
-  MutexLocker locker(&m_mutex);
-  // avoid the reference counting
-  m_buffer.Set(buffer);
+  m_mailbox.Publish(buffer);
   return true;
 }
 }  // namespace opendmx
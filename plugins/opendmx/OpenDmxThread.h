@@ -23,6 +23,7 @@
 
 #include <string>
 #include "ola/DmxBuffer.h"
+#include "ola/DmxFrame.h"
 #include "ola/thread/Thread.h"
 
 namespace ola {
@@ -41,9 +42,8 @@ class OpenDmxThread: public ola::thread::Thread {
  private:
     int m_fd;
     std::string m_path;
-    DmxBuffer m_buffer;
+    DmxFrameMailbox m_mailbox;
     bool m_term;
-    ola::thread::Mutex m_mutex;
     ola::thread::Mutex m_term_mutex;
     ola::thread::ConditionVariable m_term_cond;
 
@@ -24,6 +24,7 @@
 #include "ola/Constants.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
+#include "olad/PluginAdaptor.h"
 #include "olad/Preferences.h"
 #include "plugins/renard/RenardPort.h"
 #include "plugins/renard/RenardWidget.h"
@@ -54,10 +55,12 @@ const uint32_t RenardDevice::DEFAULT_BAUDRATE = ola::io::BAUD_RATE_57600;
  * @param owner the plugin that owns this device
  * @param preferences config settings
  * @param dev_path path to the pro widget
+ * @param plugin_adaptor the PluginAdaptor the widget's descriptor is added to
  */
 RenardDevice::RenardDevice(AbstractPlugin *owner,
                            class Preferences *preferences,
-                           const string &dev_path)
+                           const string &dev_path,
+                           PluginAdaptor *plugin_adaptor)
     : Device(owner, RENARD_DEVICE_NAME),
       m_dev_path(dev_path),
       m_preferences(preferences) {
@@ -82,8 +85,8 @@ RenardDevice::RenardDevice(AbstractPlugin *owner,
     baudrate = DEFAULT_BAUDRATE;
   }
 
-  m_widget.reset(new RenardWidget(m_dev_path, dmxOffset, channels, baudrate,
-                                  RENARD_START_ADDRESS));
+  m_widget.reset(new RenardWidget(plugin_adaptor, m_dev_path, dmxOffset,
+                                  channels, baudrate, RENARD_START_ADDRESS));
 
   OLA_DEBUG << "DMX offset set to " << static_cast<int>(dmxOffset);
   OLA_DEBUG << "Channels set to " << static_cast<int>(channels);
@@ -37,7 +37,8 @@ class RenardDevice: public ola::Device {
  public:
     RenardDevice(AbstractPlugin *owner,
                  class Preferences *preferences,
-                 const std::string &dev_path);
+                 const std::string &dev_path,
+                 class PluginAdaptor *plugin_adaptor);
     ~RenardDevice();
 
     std::string DeviceId() const { return m_dev_path; }
@@ -48,6 +48,7 @@ const uint32_t RenardWidget::RENARD_BYTES_BETWEEN_PADDING = 100;
  * New widget
  */
 RenardWidget::~RenardWidget() {
+  delete m_serial;
   if (m_socket) {
     m_socket->Close();
     delete m_socket;
@@ -73,6 +74,7 @@ bool RenardWidget::Connect() {
     return false;
 
   m_socket = new ola::io::DeviceDescriptor(fd);
+  m_serial = new ola::io::SerialBuffer(m_socket, m_ss);
 
   OLA_DEBUG << "Connected to " << m_path;
   return true;
@@ -112,6 +114,9 @@ int RenardWidget::ConnectToWidget(const string &path, speed_t speed) {
  * Disconnect from the widget
  */
 int RenardWidget::Disconnect() {
+  // Drop any pending write before the descriptor is closed.
+  delete m_serial;
+  m_serial = NULL;
   m_socket->Close();
   return 0;
 }
@@ -193,9 +198,10 @@ bool RenardWidget::SendDmx(const DmxBuffer &buffer) {
       static_cast<int>(b);
   }
 
-  int bytes_sent = m_socket->Send(msg, dataToSend);
+  // A partially written frame is completed before the next one is sent.
+  bool ok = m_serial->Send(msg, dataToSend);
 
-  OLA_DEBUG << "Sending DMX, sent " << bytes_sent << " bytes";
+  OLA_DEBUG << "Sending DMX, sent " << dataToSend << " bytes: " << ok;
 
   return true;
 }
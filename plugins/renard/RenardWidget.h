@@ -27,6 +27,7 @@
 
 #include "ola/io/SelectServer.h"
 #include "ola/io/Serial.h"
+#include "ola/io/SerialBuffer.h"
 #include "ola/DmxBuffer.h"
 
 namespace ola {
@@ -50,13 +51,16 @@ class RenardWidget {
     // default in the standard firmware is 0x80, and it may be a reasonable
     // future feature request to have this configurable for more advanced
     // Renard configurations (using wireless transmitters, etc).
-    explicit RenardWidget(const std::string &path,
-                          int dmxOffset,
-                          int channels,
-                          uint32_t baudrate,
-                          uint8_t startAddress)
-      : m_path(path),
+    RenardWidget(ola::io::SelectServerInterface *ss,
+                 const std::string &path,
+                 int dmxOffset,
+                 int channels,
+                 uint32_t baudrate,
+                 uint8_t startAddress)
+      : m_ss(ss),
+        m_path(path),
         m_socket(NULL),
+        m_serial(NULL),
         m_byteCounter(0),
         m_dmxOffset(dmxOffset),
         m_channels(channels),
@@ -78,8 +82,10 @@ class RenardWidget {
     int ConnectToWidget(const std::string &path, speed_t speed);
 
     // instance variables
+    ola::io::SelectServerInterface *m_ss;
     const std::string m_path;
     ola::io::ConnectedDescriptor *m_socket;
+    ola::io::SerialBuffer *m_serial;
     uint32_t m_byteCounter;
     uint32_t m_dmxOffset;
     uint32_t m_channels;
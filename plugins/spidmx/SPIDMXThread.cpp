@@ -75,11 +75,10 @@ bool SPIDMXThread::Stop() {
 
 
 /**
- * Copy a DmxBuffer to the output thread
+ * Hand a DmxBuffer to the output thread
  */
 bool SPIDMXThread::WriteDMX(const DmxBuffer &buffer) {
-  ola::thread::MutexLocker locker(&m_buffer_mutex);
-  m_dmx_tx_buffer.Set(buffer);
+  m_dmx_tx_mailbox.Publish(buffer);
   return true;
 }
 
@@ -119,8 +118,6 @@ bool SPIDMXThread::SetReceiveCallback(Callback0<void> *callback) {
  * The method called by the thread
  */
 void *SPIDMXThread::Run() {
-  DmxBuffer dmx_buffer;
-
   uint8_t *spi_rx_ptr;
   uint8_t *spi_tx_ptr;
 
@@ -135,6 +132,7 @@ void *SPIDMXThread::Run() {
   // Setup the parser
   SPIDMXParser *parser = new SPIDMXParser(&m_dmx_rx_buffer,
                                           m_receive_callback.get());
+  const DmxFrame *dmx_frame = DmxFrame::Create(DmxBuffer());
 
   while (1) {
     {
@@ -145,12 +143,9 @@ void *SPIDMXThread::Run() {
       }
     }
 
-    {
-      ola::thread::MutexLocker locker(&m_buffer_mutex);
-      dmx_buffer.Set(m_dmx_tx_buffer);
-    }
+    m_dmx_tx_mailbox.Update(&dmx_frame);
 
-    // TODO(FloEdelmann) fill m_spi_tx_buffer with the values from dmx_buffer
+    // TODO(FloEdelmann) fill m_spi_tx_buffer with the values from dmx_frame
     //                   (each bit repeated 8 times)
 
     // vectors store their contents contiguously,
@@ -166,6 +161,7 @@ void *SPIDMXThread::Run() {
     parser->ParseDmx(spi_rx_ptr, (uint64_t) m_blocklength);
   }
 
+  dmx_frame->Unref();
   delete parser;
 
   return NULL;
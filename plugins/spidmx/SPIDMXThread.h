@@ -26,6 +26,7 @@
 #include <vector>
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
+#include "ola/DmxFrame.h"
 #include "ola/base/Macro.h"
 #include "ola/thread/Thread.h"
 
@@ -58,8 +59,8 @@ class SPIDMXThread : public ola::thread::Thread {
 
   /** receive DMX buffer to give to InputPort's callback */
   DmxBuffer m_dmx_rx_buffer;
-  /** transmit DMX buffer that is set from WriteDMX */
-  DmxBuffer m_dmx_tx_buffer;
+  /** transmit DMX frames published from WriteDMX */
+  DmxFrameMailbox m_dmx_tx_mailbox;
 
   /** receive buffer with raw SPI bytes */
   std::vector<uint8_t> m_spi_rx_buffer;
@@ -70,7 +71,6 @@ class SPIDMXThread : public ola::thread::Thread {
   std::auto_ptr<Callback0<void> > m_receive_callback;
 
   ola::thread::Mutex m_term_mutex;
-  ola::thread::Mutex m_buffer_mutex;
 
   DISALLOW_COPY_AND_ASSIGN(SPIDMXThread);
 };
@@ -56,6 +56,7 @@ StageProfiWidget::StageProfiWidget(io::SelectServerInterface *ss,
                                    DisconnectCallback *disconnect_cb)
     : m_ss(ss),
       m_descriptor(descriptor),
+      m_serial(descriptor, ss, READ_BUFFER_SIZE),
       m_widget_path(widget_path),
       m_disconnect_cb(disconnect_cb),
       m_timeout_id(INVALID_TIMEOUT),
@@ -106,17 +107,12 @@ bool StageProfiWidget::SendDmx(const DmxBuffer &buffer) {
  * Called when there is data to read.
  */
 void StageProfiWidget::SocketReady() {
-  while (m_descriptor->DataRemaining() > 0) {
-    uint8_t byte = 0x00;
-    unsigned int data_read;
-    while (byte != 'G') {
-      int ret = m_descriptor->Receive(&byte, 1, data_read);
-
-      if (ret == -1 || data_read != 1) {
-        return;
-      }
+  while (m_serial.Read()) {
+    // The only thing the widget sends us is the 'G' in response to the query.
+    if (m_serial.SkipTo('G')) {
+      m_got_response = true;
+      m_serial.Clear();
     }
-    m_got_response = true;
   }
 }
 
@@ -144,15 +140,13 @@ bool StageProfiWidget::Send255(uint16_t start,
   msg[3] = len;
   memcpy(msg + DMX_HEADER_SIZE, buf, len);
 
-  // This needs to be an int, as m_descriptor->Send() below returns an int
-  const int bytes_to_send = len + DMX_HEADER_SIZE;
-  return m_descriptor->Send(msg, bytes_to_send) == bytes_to_send;
+  return m_serial.Send(msg, len + DMX_HEADER_SIZE);
 }
 
 void StageProfiWidget::SendQueryPacket() {
   uint8_t query[] = {'C', '?'};
-  ssize_t bytes_sent = m_descriptor->Send(query, arraysize(query));
-  OLA_DEBUG << "Sending StageprofiWidget query: C? returned " << bytes_sent;
+  bool ok = m_serial.Send(query, arraysize(query));
+  OLA_DEBUG << "Sending StageprofiWidget query: C? returned " << ok;
 }
 
 void StageProfiWidget::RunDisconnectHandler() {
@@ -27,6 +27,7 @@
 #include "ola/Callback.h"
 #include "ola/io/Descriptor.h"
 #include "ola/io/SelectServerInterface.h"
+#include "ola/io/SerialBuffer.h"
 
 namespace ola {
 namespace plugin {
@@ -66,9 +67,12 @@ class StageProfiWidget {
  private:
   enum { DMX_MSG_LEN = 255 };
   enum { DMX_HEADER_SIZE = 4};
+  enum { READ_BUFFER_SIZE = 64 };
 
   ola::io::SelectServerInterface *m_ss;
   std::auto_ptr<ola::io::ConnectedDescriptor> m_descriptor;
+  // Declared after m_descriptor so it's destroyed first.
+  mutable ola::io::SerialBuffer m_serial;
   const std::string m_widget_path;
   DisconnectCallback *m_disconnect_cb;
   ola::thread::timeout_id m_timeout_id;
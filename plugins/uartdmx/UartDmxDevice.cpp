@@ -34,18 +34,26 @@ using std::string;
 
 const char UartDmxDevice::K_MALF[] = "-malf";
 const char UartDmxDevice::K_BREAK[] = "-break";
+const char UartDmxDevice::K_FREQUENCY[] = "-frequency";
+const char UartDmxDevice::K_REALTIME_PRIORITY[] = "-realtime-priority";
+const char UartDmxDevice::K_CPU[] = "-cpu";
 const unsigned int UartDmxDevice::DEFAULT_BREAK = 100;
 const unsigned int UartDmxDevice::DEFAULT_MALF = 100;
+const unsigned int UartDmxDevice::DEFAULT_FREQUENCY = 0;
+const unsigned int UartDmxDevice::DEFAULT_REALTIME_PRIORITY = 0;
+const int UartDmxDevice::DEFAULT_CPU = -1;
 
 
 UartDmxDevice::UartDmxDevice(AbstractPlugin *owner,
                              class Preferences *preferences,
                              const string &name,
-                             const string &path)
+                             const string &path,
+                             class PluginAdaptor *plugin_adaptor)
     : Device(owner, name),
       m_preferences(preferences),
       m_name(name),
-      m_path(path) {
+      m_path(path),
+      m_plugin_adaptor(plugin_adaptor) {
   // set up some per-device default configuration if not already set
   SetDefaults();
   // now read per-device configuration
@@ -57,6 +65,14 @@ UartDmxDevice::UartDmxDevice(AbstractPlugin *owner,
   if (!StringToInt(m_preferences->GetValue(DeviceMalfKey()), &m_malft)) {
     m_malft = DEFAULT_MALF;
   }
+  // Output timing
+  m_timer_options.frame_rate = StringToIntOrDefault(
+      m_preferences->GetValue(DeviceFrequencyKey()), DEFAULT_FREQUENCY);
+  m_timer_options.realtime_priority = StringToIntOrDefault(
+      m_preferences->GetValue(DeviceRealtimePriorityKey()),
+      DEFAULT_REALTIME_PRIORITY);
+  m_timer_options.cpu = StringToIntOrDefault(
+      m_preferences->GetValue(DeviceCPUKey()), DEFAULT_CPU);
   m_widget.reset(new UartWidget(path));
 }
 
@@ -67,7 +83,8 @@ UartDmxDevice::~UartDmxDevice() {
 }
 
 bool UartDmxDevice::StartHook() {
-  AddPort(new UartDmxOutputPort(this, 0, m_widget.get(), m_breakt, m_malft));
+  AddPort(new UartDmxOutputPort(this, 0, m_widget.get(), m_breakt, m_malft,
+                                m_timer_options, m_plugin_adaptor));
   return true;
 }
 
@@ -77,6 +94,15 @@ string UartDmxDevice::DeviceMalfKey() const {
 string UartDmxDevice::DeviceBreakKey() const {
   return m_path + K_BREAK;
 }
+string UartDmxDevice::DeviceFrequencyKey() const {
+  return m_path + K_FREQUENCY;
+}
+string UartDmxDevice::DeviceRealtimePriorityKey() const {
+  return m_path + K_REALTIME_PRIORITY;
+}
+string UartDmxDevice::DeviceCPUKey() const {
+  return m_path + K_CPU;
+}
 
 /**
  * Set the default preferences for this one Device
@@ -94,6 +120,15 @@ void UartDmxDevice::SetDefaults() {
   save |= m_preferences->SetDefaultValue(DeviceMalfKey(),
                                          UIntValidator(8, 1000000),
                                          DEFAULT_MALF);
+  save |= m_preferences->SetDefaultValue(DeviceFrequencyKey(),
+                                         UIntValidator(0, 1000),
+                                         DEFAULT_FREQUENCY);
+  save |= m_preferences->SetDefaultValue(DeviceRealtimePriorityKey(),
+                                         UIntValidator(0, 99),
+                                         DEFAULT_REALTIME_PRIORITY);
+  save |= m_preferences->SetDefaultValue(DeviceCPUKey(),
+                                         IntValidator(-1, 1023),
+                                         DEFAULT_CPU);
   if (save) {
     m_preferences->Save();
   }
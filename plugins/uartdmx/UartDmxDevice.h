@@ -26,6 +26,7 @@
 #include <sstream>
 #include <memory>
 #include "ola/DmxBuffer.h"
+#include "ola/dmx/FrameTimer.h"
 #include "olad/Device.h"
 #include "olad/Preferences.h"
 #include "plugins/uartdmx/UartWidget.h"
@@ -39,7 +40,8 @@ class UartDmxDevice : public Device {
   UartDmxDevice(AbstractPlugin *owner,
                 class Preferences *preferences,
                 const std::string &name,
-                const std::string &path);
+                const std::string &path,
+                class PluginAdaptor *plugin_adaptor);
   ~UartDmxDevice();
 
   std::string DeviceId() const { return m_path; }
@@ -52,6 +54,9 @@ class UartDmxDevice : public Device {
   // Per device options
   std::string DeviceBreakKey() const;
   std::string DeviceMalfKey() const;
+  std::string DeviceFrequencyKey() const;
+  std::string DeviceRealtimePriorityKey() const;
+  std::string DeviceCPUKey() const;
   void SetDefaults();
 
   std::auto_ptr<UartWidget> m_widget;
@@ -60,11 +65,19 @@ class UartDmxDevice : public Device {
   const std::string m_path;
   unsigned int m_breakt;
   unsigned int m_malft;
+  ola::dmx::FrameTimer::Options m_timer_options;
+  class PluginAdaptor *m_plugin_adaptor;
 
   static const unsigned int DEFAULT_MALF;
   static const char K_MALF[];
   static const unsigned int DEFAULT_BREAK;
   static const char K_BREAK[];
+  static const unsigned int DEFAULT_FREQUENCY;
+  static const char K_FREQUENCY[];
+  static const unsigned int DEFAULT_REALTIME_PRIORITY;
+  static const char K_REALTIME_PRIORITY[];
+  static const int DEFAULT_CPU;
+  static const char K_CPU[];
 
   DISALLOW_COPY_AND_ASSIGN(UartDmxDevice);
 };
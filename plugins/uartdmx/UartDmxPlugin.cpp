@@ -75,7 +75,8 @@ bool UartDmxPlugin::StartHook() {
     // can open device, so shut the temporary file descriptor
     close(fd);
     std::auto_ptr<UartDmxDevice> device(new UartDmxDevice(
-        this, m_preferences, PLUGIN_NAME, *iter));
+        this, m_preferences, PLUGIN_NAME, *iter,
+        m_plugin_adaptor));
 
     // got a device, now lets see if we can configure it before we announce
     // it to the world
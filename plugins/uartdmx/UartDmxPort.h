@@ -25,6 +25,7 @@
 #include <string>
 
 #include "ola/DmxBuffer.h"
+#include "ola/dmx/FrameTimer.h"
 #include "olad/Port.h"
 #include "olad/Preferences.h"
 #include "plugins/uartdmx/UartDmxDevice.h"
@@ -41,10 +42,12 @@ class UartDmxOutputPort : public ola::BasicOutputPort {
                     unsigned int id,
                     UartWidget *widget,
                     unsigned int breakt,
-                    unsigned int malft)
+                    unsigned int malft,
+                    const ola::dmx::FrameTimer::Options &timer_options,
+                    class PluginAdaptor *plugin_adaptor)
       : BasicOutputPort(parent, id),
         m_widget(widget),
-        m_thread(widget, breakt, malft) {
+        m_thread(widget, breakt, malft, timer_options, plugin_adaptor) {
     m_thread.Start();
   }
   ~UartDmxOutputPort() { m_thread.Stop(); }
@@ -19,10 +19,7 @@
  * Copyright (C) 2014 Richard Ash
  */
 
-#include <math.h>
-#include <unistd.h>
 #include <string>
-#include "ola/Clock.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
 #include "plugins/uartdmx/UartWidget.h"
@@ -33,12 +30,15 @@ namespace plugin {
 namespace uartdmx {
 
 UartDmxThread::UartDmxThread(UartWidget *widget, unsigned int breakt,
-                             unsigned int malft)
-  : m_granularity(UNKNOWN),
-    m_widget(widget),
+                             unsigned int malft,
+                             const ola::dmx::FrameTimer::Options &timer_options,
+                             PluginAdaptor *plugin_adaptor)
+  : m_widget(widget),
     m_term(false),
     m_breakt(breakt),
-    m_malft(malft) {
+    m_malft(malft),
+    m_timer(timer_options, plugin_adaptor->GetExportMap(), widget->Name(),
+            plugin_adaptor) {
 }
 
 UartDmxThread::~UartDmxThread() {
@@ -59,11 +59,10 @@ bool UartDmxThread::Stop() {
 
 
 /**
- * Copy a DMXBuffer to the output thread
+ * Hand a DMXBuffer to the output thread
  */
 bool UartDmxThread::WriteDMX(const DmxBuffer &buffer) {
-  ola::thread::MutexLocker locker(&m_buffer_mutex);
-  m_buffer.Set(buffer);
+  m_mailbox.Publish(buffer);
   return true;
 }
 
@@ -72,10 +71,8 @@ bool UartDmxThread::WriteDMX(const DmxBuffer &buffer) {
  * The method called by the thread
  */
 void *UartDmxThread::Run() {
-  TimeStamp ts1, ts2;
-  Clock clock;
-  CheckTimeGranularity();
-  DmxBuffer buffer;
+  m_timer.ConfigureThread();
+  const DmxFrame *frame = DmxFrame::Create(DmxBuffer());
 
   // Setup the widget
   if (!m_widget->IsOpen())
@@ -88,54 +85,33 @@ void *UartDmxThread::Run() {
         break;
     }
 
-    {
-      ola::thread::MutexLocker locker(&m_buffer_mutex);
-      buffer.Set(m_buffer);
-    }
+    // If a frame rate is set, this waits until the next frame is due.
+    m_timer.StartFrame();
+
+    // Take the latest frame once the wait is over, so it's as fresh as
+    // possible.
+    m_mailbox.Update(&frame);
 
     if (!m_widget->SetBreak(true))
       goto framesleep;
 
-    if (m_granularity == GOOD)
-      usleep(m_breakt);
+    m_timer.Delay(m_breakt);
 
     if (!m_widget->SetBreak(false))
       goto framesleep;
 
-    if (m_granularity == GOOD)
-      usleep(DMX_MAB);
+    m_timer.Delay(DMX_MAB);
 
-    if (!m_widget->Write(buffer))
+    if (!m_widget->Write(*frame))
       goto framesleep;
 
   framesleep:
     // Sleep for the remainder of the DMX frame time
-    usleep(m_malft);
+    m_timer.Delay(m_malft);
   }
+  frame->Unref();
   return NULL;
 }
-
-
-/**
- * Check the granularity of usleep.
- */
-void UartDmxThread::CheckTimeGranularity() {
-  TimeStamp ts1, ts2;
-  Clock clock;
-  /** If sleeping for 1ms takes longer than this, don't trust
-   * usleep for this session
-   */
-  const int threshold = 3;
-
-  clock.CurrentMonotonicTime(&ts1);
-  usleep(1000);
-  clock.CurrentMonotonicTime(&ts2);
-
-  TimeInterval interval = ts2 - ts1;
-  m_granularity = interval.InMilliSeconds() > threshold ? BAD : GOOD;
-  OLA_INFO << "Granularity for UART thread is "
-           << (m_granularity == GOOD ? "GOOD" : "BAD");
-}
 }  // namespace uartdmx
 }  // namespace plugin
 }  // namespace ola
@@ -23,7 +23,10 @@
 #define PLUGINS_UARTDMX_UARTDMXTHREAD_H_
 
 #include "ola/DmxBuffer.h"
+#include "ola/DmxFrame.h"
+#include "ola/dmx/FrameTimer.h"
 #include "ola/thread/Thread.h"
+#include "olad/PluginAdaptor.h"
 
 namespace ola {
 namespace plugin {
@@ -31,7 +34,9 @@ namespace uartdmx {
 
 class UartDmxThread : public ola::thread::Thread {
  public:
-  UartDmxThread(UartWidget *widget, unsigned int breakt, unsigned int malft);
+  UartDmxThread(UartWidget *widget, unsigned int breakt, unsigned int malft,
+                const ola::dmx::FrameTimer::Options &timer_options,
+                PluginAdaptor *plugin_adaptor);
   ~UartDmxThread();
 
   bool Stop();
@@ -39,18 +44,13 @@ class UartDmxThread : public ola::thread::Thread {
   bool WriteDMX(const DmxBuffer &buffer);
 
  private:
-  enum TimerGranularity { UNKNOWN, GOOD, BAD };
-
-  TimerGranularity m_granularity;
   UartWidget *m_widget;
   bool m_term;
   unsigned int m_breakt;
   unsigned int m_malft;
-  DmxBuffer m_buffer;
+  ola::dmx::FrameTimer m_timer;
+  DmxFrameMailbox m_mailbox;
   ola::thread::Mutex m_term_mutex;
-  ola::thread::Mutex m_buffer_mutex;
-
-  void CheckTimeGranularity();
 
   static const uint32_t DMX_MAB = 16;
 
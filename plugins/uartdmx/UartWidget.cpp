@@ -116,14 +116,8 @@ bool UartWidget::SetBreak(bool on) {
   }
 }
 
-bool UartWidget::Write(const ola::DmxBuffer& data) {
-  unsigned char buffer[DMX_UNIVERSE_SIZE + 1];
-  unsigned int length = DMX_UNIVERSE_SIZE;
-  buffer[0] = DMX512_START_CODE;
-
-  data.Get(buffer + 1, &length);
-
-  if (write(m_fd, buffer, length + 1) <= 0) {
+bool UartWidget::Write(const ola::DmxFrame &frame) {
+  if (write(m_fd, frame.Packet(), frame.PacketSize()) <= 0) {
     // TODO(richardash1981): handle errors better as per the test code,
     // especially if we alter the scheduling!
     OLA_WARN << Name() << " Short or failed write!";
@@ -34,7 +34,7 @@
 #include <string>
 #include <vector>
 #include "ola/base/Macro.h"
-#include "ola/DmxBuffer.h"
+#include "ola/DmxFrame.h"
 
 namespace ola {
 namespace plugin {
@@ -71,7 +71,7 @@ class UartWidget {
     bool SetBreak(bool on);
 
     /** Write data to a previously-opened line */
-    bool Write(const ola::DmxBuffer &data);
+    bool Write(const ola::DmxFrame &frame);
 
     /** Read data from a previously-opened line */
     bool Read(unsigned char* buff, int size);
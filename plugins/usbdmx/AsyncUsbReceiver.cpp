@@ -62,9 +62,8 @@ bool AsyncUsbReceiver::Start() {
 }
 
 void AsyncUsbReceiver::TransferComplete(struct libusb_transfer *transfer) {
-  if (transfer != m_transfer) {
-    OLA_WARN << "Mismatched libusb transfer: " << transfer << " != "
-             << m_transfer;
+  if (!OwnsTransfer(transfer)) {
+    OLA_WARN << "Mismatched libusb transfer: " << transfer;
     return;
   }
 
@@ -74,8 +73,7 @@ void AsyncUsbReceiver::TransferComplete(struct libusb_transfer *transfer) {
   }
 
   ola::thread::MutexLocker locker(&m_mutex);
-  m_transfer_state = (transfer->status == LIBUSB_TRANSFER_NO_DEVICE ?
-      DISCONNECTED : IDLE);
+  ReleaseTransfer(transfer);
 
   if (m_suppress_continuation) {
     return;
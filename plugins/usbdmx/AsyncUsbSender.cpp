@@ -30,8 +30,9 @@ namespace usbdmx {
 using ola::usb::LibUsbAdaptor;
 
 AsyncUsbSender::AsyncUsbSender(LibUsbAdaptor *adaptor,
-                               libusb_device *usb_device)
-    : AsyncUsbTransceiverBase(adaptor, usb_device),
+                               libusb_device *usb_device,
+                               unsigned int max_transfers)
+    : AsyncUsbTransceiverBase(adaptor, usb_device, max_transfers),
       m_pending_tx(false) {
 }
 
@@ -45,7 +46,7 @@ bool AsyncUsbSender::SendDMX(const DmxBuffer &buffer) {
     return false;
   }
   ola::thread::MutexLocker locker(&m_mutex);
-  if (m_transfer_state == IDLE) {
+  if (m_transfer_state != DISCONNECTED && TransferAvailable()) {
     PerformTransfer(buffer);
   } else {
     // Buffer incoming data so we can send it when the outstanding transfers
@@ -57,9 +58,8 @@ bool AsyncUsbSender::SendDMX(const DmxBuffer &buffer) {
 }
 
 void AsyncUsbSender::TransferComplete(struct libusb_transfer *transfer) {
-  if (transfer != m_transfer) {
-    OLA_WARN << "Mismatched libusb transfer: " << transfer << " != "
-             << m_transfer;
+  if (!OwnsTransfer(transfer)) {
+    OLA_WARN << "Mismatched libusb transfer: " << transfer;
     return;
   }
 
@@ -69,8 +69,7 @@ void AsyncUsbSender::TransferComplete(struct libusb_transfer *transfer) {
   }
 
   ola::thread::MutexLocker locker(&m_mutex);
-  m_transfer_state = (transfer->status == LIBUSB_TRANSFER_NO_DEVICE ?
-      DISCONNECTED : IDLE);
+  ReleaseTransfer(transfer);
 
   if (m_suppress_continuation) {
     return;
@@ -78,7 +77,8 @@ void AsyncUsbSender::TransferComplete(struct libusb_transfer *transfer) {
 
   PostTransferHook();
 
-  if ((m_transfer_state == IDLE) && m_pending_tx) {
+  if (m_transfer_state != DISCONNECTED && TransferAvailable() &&
+      m_pending_tx) {
     m_pending_tx = false;
     PerformTransfer(m_tx_buffer);
   }
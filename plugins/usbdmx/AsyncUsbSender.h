@@ -38,6 +38,12 @@ namespace usbdmx {
  *
  * This encapsulates much of the asynchronous libusb logic. Subclasses should
  * implement the SetupHandle() and PerformTransfer() methods.
+ *
+ * Devices that send a whole frame in a single transfer can keep more than one
+ * transfer in flight, so the next frame is already queued on the host
+ * controller when the current one completes. Devices that use
+ * PostTransferHook() to split a frame across transfers must use a single
+ * transfer.
  */
 class AsyncUsbSender: public AsyncUsbTransceiverBase {
  public:
@@ -45,9 +51,11 @@ class AsyncUsbSender: public AsyncUsbTransceiverBase {
    * @brief Create a new AsyncUsbSender.
    * @param adaptor the LibUsbAdaptor to use.
    * @param usb_device the libusb_device to use for the widget.
+   * @param max_transfers the maximum number of transfers to have in flight.
    */
   AsyncUsbSender(ola::usb::LibUsbAdaptor* const adaptor,
-                 libusb_device *usb_device);
+                 libusb_device *usb_device,
+                 unsigned int max_transfers = 1);
 
   /**
    * @brief Destructor
@@ -20,6 +20,8 @@
 
 #include "plugins/usbdmx/AsyncUsbTransceiverBase.h"
 
+#include <vector>
+
 #include "libs/usb/LibUsbAdaptor.h"
 #include "ola/Logging.h"
 
@@ -45,20 +47,31 @@ void AsyncCallback(struct libusb_transfer *transfer) {
 }  // namespace
 
 AsyncUsbTransceiverBase::AsyncUsbTransceiverBase(LibUsbAdaptor *adaptor,
-                                                 libusb_device *usb_device)
+                                                 libusb_device *usb_device,
+                                                 unsigned int max_transfers)
     : m_adaptor(adaptor),
       m_usb_device(usb_device),
       m_usb_handle(NULL),
       m_suppress_continuation(false),
-      m_transfer_state(IDLE) {
-  m_transfer = m_adaptor->AllocTransfer(0);
+      m_transfer(NULL),
+      m_transfer_state(IDLE),
+      m_pool(max_transfers ? max_transfers : 1),
+      m_transfers_in_flight(0) {
+  // Allocate all the transfers up front, so nothing is allocated per frame.
+  for (unsigned int i = 0; i < m_pool.size(); i++) {
+    m_pool[i].transfer = m_adaptor->AllocTransfer(0);
+    m_pool[i].in_flight = false;
+  }
+  m_transfer = m_pool[0].transfer;
   m_adaptor->RefDevice(usb_device);
 }
 
 AsyncUsbTransceiverBase::~AsyncUsbTransceiverBase() {
   CancelTransfer();
   m_adaptor->UnrefDevice(m_usb_device);
-  m_adaptor->FreeTransfer(m_transfer);
+  for (unsigned int i = 0; i < m_pool.size(); i++) {
+    m_adaptor->FreeTransfer(m_pool[i].transfer);
+  }
 }
 
 bool AsyncUsbTransceiverBase::Init() {
@@ -74,14 +87,18 @@ void AsyncUsbTransceiverBase::CancelTransfer() {
   bool canceled = false;
   while (1) {
     ola::thread::MutexLocker locker(&m_mutex);
-    if (m_transfer_state == IDLE || m_transfer_state == DISCONNECTED) {
+    if (m_transfers_in_flight == 0 || m_transfer_state == DISCONNECTED) {
       break;
     }
     if (!canceled) {
       m_suppress_continuation = true;
-      if (m_adaptor->CancelTransfer(m_transfer) == 0) {
-        canceled = true;
-      } else {
+      for (unsigned int i = 0; i < m_pool.size(); i++) {
+        if (m_pool[i].in_flight &&
+            m_adaptor->CancelTransfer(m_pool[i].transfer) == 0) {
+          canceled = true;
+        }
+      }
+      if (!canceled) {
         break;
       }
     }
@@ -92,7 +109,12 @@ void AsyncUsbTransceiverBase::CancelTransfer() {
 
 void AsyncUsbTransceiverBase::FillControlTransfer(unsigned char *buffer,
                                                   unsigned int timeout) {
-  m_adaptor->FillControlTransfer(m_transfer, m_usb_handle, buffer,
+  const struct libusb_control_setup *setup =
+      reinterpret_cast<struct libusb_control_setup*>(buffer);
+  unsigned int length = LIBUSB_CONTROL_SETUP_SIZE +
+                        libusb_le16_to_cpu(setup->wLength);
+  m_adaptor->FillControlTransfer(m_transfer, m_usb_handle,
+                                 TransferBuffer(buffer, length),
                                  &AsyncCallback, this, timeout);
 }
 
@@ -100,7 +122,8 @@ void AsyncUsbTransceiverBase::FillBulkTransfer(unsigned char endpoint,
                                                unsigned char *buffer,
                                                int length,
                                                unsigned int timeout) {
-  m_adaptor->FillBulkTransfer(m_transfer, m_usb_handle, endpoint, buffer,
+  m_adaptor->FillBulkTransfer(m_transfer, m_usb_handle, endpoint,
+                              TransferBuffer(buffer, length),
                               length, &AsyncCallback, this, timeout);
 }
 
@@ -108,11 +131,18 @@ void AsyncUsbTransceiverBase::FillInterruptTransfer(unsigned char endpoint,
                                                     unsigned char *buffer,
                                                     int length,
                                                     unsigned int timeout) {
-  m_adaptor->FillInterruptTransfer(m_transfer, m_usb_handle, endpoint, buffer,
+  m_adaptor->FillInterruptTransfer(m_transfer, m_usb_handle, endpoint,
+                                   TransferBuffer(buffer, length),
                                    length, &AsyncCallback, this, timeout);
 }
 
 int AsyncUsbTransceiverBase::SubmitTransfer() {
+  PooledTransfer *pooled = FindTransfer(m_transfer);
+  if (!pooled || pooled->in_flight) {
+    OLA_WARN << "No idle libusb transfer available";
+    return LIBUSB_ERROR_BUSY;
+  }
+
   int ret = m_adaptor->SubmitTransfer(m_transfer);
   if (ret) {
     OLA_WARN << "libusb_submit_transfer returned "
@@ -120,11 +150,77 @@ int AsyncUsbTransceiverBase::SubmitTransfer() {
     if (ret == LIBUSB_ERROR_NO_DEVICE) {
       m_transfer_state = DISCONNECTED;
     }
-    return false;
+    return ret;
   }
+
+  pooled->in_flight = true;
+  m_transfers_in_flight++;
   m_transfer_state = IN_PROGRESS;
+
+  for (unsigned int i = 0; i < m_pool.size(); i++) {
+    if (!m_pool[i].in_flight) {
+      m_transfer = m_pool[i].transfer;
+      break;
+    }
+  }
   return ret;
 }
+
+bool AsyncUsbTransceiverBase::OwnsTransfer(
+    const struct libusb_transfer *transfer) const {
+  for (unsigned int i = 0; i < m_pool.size(); i++) {
+    if (m_pool[i].transfer == transfer) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void AsyncUsbTransceiverBase::ReleaseTransfer(
+    struct libusb_transfer *transfer) {
+  PooledTransfer *pooled = FindTransfer(transfer);
+  if (pooled && pooled->in_flight) {
+    pooled->in_flight = false;
+    m_transfers_in_flight--;
+  }
+
+  if (transfer->status == LIBUSB_TRANSFER_NO_DEVICE) {
+    m_transfer_state = DISCONNECTED;
+  } else {
+    m_transfer_state = m_transfers_in_flight ? IN_PROGRESS : IDLE;
+  }
+
+  // If every transfer was in flight, m_transfer is still pointing at one of
+  // them.
+  if (FindTransfer(m_transfer)->in_flight) {
+    m_transfer = transfer;
+  }
+}
+
+AsyncUsbTransceiverBase::PooledTransfer *AsyncUsbTransceiverBase::FindTransfer(
+    const struct libusb_transfer *transfer) {
+  for (unsigned int i = 0; i < m_pool.size(); i++) {
+    if (m_pool[i].transfer == transfer) {
+      return &m_pool[i];
+    }
+  }
+  return NULL;
+}
+
+/*
+ * With a single transfer the subclass's buffer is used directly, as it always
+ * has been. Otherwise copy it into the buffer owned by m_transfer; the vector
+ * keeps its capacity so this only allocates the first time round.
+ */
+unsigned char *AsyncUsbTransceiverBase::TransferBuffer(unsigned char *buffer,
+                                                       unsigned int length) {
+  if (m_pool.size() == 1) {
+    return buffer;
+  }
+  PooledTransfer *pooled = FindTransfer(m_transfer);
+  pooled->data.assign(buffer, buffer + length);
+  return &pooled->data[0];
+}
 }  // namespace usbdmx
 }  // namespace plugin
 }  // namespace ola
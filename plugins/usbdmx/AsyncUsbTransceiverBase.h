@@ -23,6 +23,8 @@
 
 #include <libusb.h>
 
+#include <vector>
+
 #include "libs/usb/LibUsbAdaptor.h"
 #include "ola/DmxBuffer.h"
 #include "ola/base/Macro.h"
@@ -42,9 +44,12 @@ class AsyncUsbTransceiverBase {
    * @brief Create a new AsyncUsbTransceiverBase.
    * @param adaptor the LibUsbAdaptor to use.
    * @param usb_device the libusb_device to use for the widget.
+   * @param max_transfers the number of transfers to allocate. Each one can be
+   *   in flight at the same time, see SubmitTransfer().
    */
   AsyncUsbTransceiverBase(ola::usb::LibUsbAdaptor* const adaptor,
-                          libusb_device *usb_device);
+                          libusb_device *usb_device,
+                          unsigned int max_transfers = 1);
 
   /**
    * @brief Destructor
@@ -97,7 +102,7 @@ class AsyncUsbTransceiverBase {
   virtual void PostTransferHook() {}
 
   /**
-   * @brief Cancel any pending transfers.
+   * @brief Cancel all pending transfers.
    */
   void CancelTransfer();
 
@@ -123,9 +128,32 @@ class AsyncUsbTransceiverBase {
   /**
    * @brief Submit the transfer for tx.
    * @returns the result of libusb_submit_transfer().
+   *
+   * On success m_transfer moves on to the next idle transfer in the pool, if
+   * there is one.
    */
   int SubmitTransfer();
 
+  /**
+   * @brief Check if another transfer can be submitted.
+   * @returns true if fewer than max_transfers are in flight.
+   */
+  bool TransferAvailable() const {  // LOCK_REQUIRED(m_mutex)
+    return m_transfers_in_flight < m_pool.size();
+  }
+
+  /**
+   * @brief Check if a transfer belongs to this transceiver.
+   */
+  bool OwnsTransfer(const struct libusb_transfer *transfer) const;
+
+  /**
+   * @brief Return a completed transfer to the pool and update
+   *   m_transfer_state.
+   * @param transfer the completed transfer.
+   */
+  void ReleaseTransfer(struct libusb_transfer *transfer);  // LOCK_REQUIRED
+
   enum TransferState {
     IDLE,
     IN_PROGRESS,
@@ -134,12 +162,28 @@ class AsyncUsbTransceiverBase {
 
   libusb_device_handle *m_usb_handle;
   bool m_suppress_continuation;
-  struct libusb_transfer *m_transfer;
+  // The transfer that the Fill*Transfer() methods operate on.
+  struct libusb_transfer *m_transfer;  // GUARDED_BY(m_mutex);
 
   TransferState m_transfer_state;  // GUARDED_BY(m_mutex);
   ola::thread::Mutex m_mutex;
 
  private:
+  struct PooledTransfer {
+    struct libusb_transfer *transfer;
+    bool in_flight;
+    // When there is more than one transfer, each one gets a copy of the data
+    // so the subclass can reuse its frame buffer while transfers are in
+    // flight.
+    std::vector<unsigned char> data;
+  };
+
+  std::vector<PooledTransfer> m_pool;  // GUARDED_BY(m_mutex);
+  unsigned int m_transfers_in_flight;  // GUARDED_BY(m_mutex);
+
+  PooledTransfer *FindTransfer(const struct libusb_transfer *transfer);
+  unsigned char *TransferBuffer(unsigned char *buffer, unsigned int length);
+
   DISALLOW_COPY_AND_ASSIGN(AsyncUsbTransceiverBase);
 };
 }  // namespace usbdmx
@@ -27,10 +27,13 @@
 #include "ola/Constants.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
+#include "ola/base/Flags.h"
 #include "ola/util/Utils.h"
 #include "plugins/usbdmx/AsyncUsbSender.h"
 #include "plugins/usbdmx/ThreadedUsbSender.h"
 
+DECLARE_uint8(libusb_transfers_per_device);
+
 namespace ola {
 namespace plugin {
 namespace usbdmx {
@@ -219,7 +222,8 @@ class EuroliteProAsyncUsbSender : public AsyncUsbSender {
   EuroliteProAsyncUsbSender(LibUsbAdaptor *adaptor,
                             libusb_device *usb_device,
                             bool is_mk2)
-      : AsyncUsbSender(adaptor, usb_device),
+      : AsyncUsbSender(adaptor, usb_device,
+                       FLAGS_libusb_transfers_per_device),
         m_is_mk2(is_mk2) {
   }
 
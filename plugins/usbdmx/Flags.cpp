@@ -23,3 +23,6 @@
 DEFINE_default_bool(use_async_libusb, true,
     "Disable the use of the asynchronous libusb calls, revert to synchronous");
 
+DEFINE_uint8(libusb_transfers_per_device, 1,
+    "The number of asynchronous libusb transfers to keep in flight for each "
+    "device that sends a DMX frame in a single transfer");
@@ -80,6 +80,10 @@ void JaRuleOutputPort::RunIncrementalDiscovery(
   m_port_handle->RunIncrementalDiscovery(callback);
 }
 
+void JaRuleOutputPort::SetKnownUIDs(const ola::rdm::UIDSet &uids) {
+  m_port_handle->SetKnownUIDs(uids);
+}
+
 bool JaRuleOutputPort::PreSetUniverse(Universe *old_universe,
                                       Universe *new_universe) {
   if (old_universe == NULL && new_universe != NULL) {
@@ -70,6 +70,7 @@ class JaRuleOutputPort: public BasicOutputPort {
                       ola::rdm::RDMCallback *callback);
   void RunFullDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
   void RunIncrementalDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
+  void SetKnownUIDs(const ola::rdm::UIDSet &uids);
 
   bool PreSetUniverse(Universe *old_universe, Universe *new_universe);
   void PostSetUniverse(Universe *old_universe, Universe *new_universe);
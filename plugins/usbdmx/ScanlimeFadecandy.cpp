@@ -28,6 +28,7 @@
 
 #include "libs/usb/LibUsbAdaptor.h"
 #include "ola/base/Array.h"
+#include "ola/base/Flags.h"
 #include "ola/Constants.h"
 #include "ola/Logging.h"
 #include "ola/StringUtils.h"
@@ -36,6 +37,8 @@
 #include "plugins/usbdmx/AsyncUsbSender.h"
 #include "plugins/usbdmx/ThreadedUsbSender.h"
 
+DECLARE_uint8(libusb_transfers_per_device);
+
 namespace ola {
 namespace plugin {
 namespace usbdmx {
@@ -285,7 +288,8 @@ class FadecandyAsyncUsbSender : public AsyncUsbSender {
  public:
   FadecandyAsyncUsbSender(LibUsbAdaptor *adaptor,
                           libusb_device *usb_device)
-      : AsyncUsbSender(adaptor, usb_device) {
+      : AsyncUsbSender(adaptor, usb_device,
+                       FLAGS_libusb_transfers_per_device) {
   }
 
   libusb_device_handle* SetupHandle();
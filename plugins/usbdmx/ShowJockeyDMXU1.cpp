@@ -34,11 +34,14 @@
 #include "libs/usb/LibUsbAdaptor.h"
 #include "ola/Constants.h"
 #include "ola/Logging.h"
+#include "ola/base/Flags.h"
 #include "ola/util/Utils.h"
 #include "ola/strings/Format.h"
 #include "plugins/usbdmx/AsyncUsbSender.h"
 #include "plugins/usbdmx/ThreadedUsbSender.h"
 
+DECLARE_uint8(libusb_transfers_per_device);
+
 namespace ola {
 namespace plugin {
 namespace usbdmx {
@@ -265,7 +268,9 @@ class ShowJockeyDMXU1AsyncUsbSender : public AsyncUsbSender {
                                 int endpoint,
                                 int max_packet_size_out,
                                 libusb_device_handle *handle)
-                                : AsyncUsbSender(adaptor, usb_device),
+                                : AsyncUsbSender(
+                                      adaptor, usb_device,
+                                      FLAGS_libusb_transfers_per_device),
                                   m_endpoint(endpoint),
                                   m_max_packet_size_out(max_packet_size_out) {
     m_usb_handle = handle;
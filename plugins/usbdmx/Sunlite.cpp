@@ -25,9 +25,12 @@
 #include "libs/usb/LibUsbAdaptor.h"
 #include "ola/Constants.h"
 #include "ola/Logging.h"
+#include "ola/base/Flags.h"
 #include "plugins/usbdmx/AsyncUsbSender.h"
 #include "plugins/usbdmx/ThreadedUsbSender.h"
 
+DECLARE_uint8(libusb_transfers_per_device);
+
 namespace ola {
 namespace plugin {
 namespace usbdmx {
@@ -168,7 +171,8 @@ class SunliteAsyncUsbSender : public AsyncUsbSender {
  public:
   SunliteAsyncUsbSender(LibUsbAdaptor *adaptor,
                         libusb_device *usb_device)
-      : AsyncUsbSender(adaptor, usb_device) {
+      : AsyncUsbSender(adaptor, usb_device,
+                       FLAGS_libusb_transfers_per_device) {
     InitPacket(m_packet);
   }
 
@@ -23,6 +23,7 @@
 
 #include <memory>
 #include "ola/DmxBuffer.h"
+#include "ola/io/SelectServerInterface.h"
 #include "ola/rdm/UID.h"
 #include "ola/rdm/UIDSet.h"
 #include "ola/rdm/RDMControllerInterface.h"
@@ -41,7 +42,8 @@ namespace usbpro {
 class ArduinoWidgetImpl: public BaseUsbProWidget,
                          public ola::rdm::DiscoverableRDMControllerInterface {
  public:
-    ArduinoWidgetImpl(ola::io::ConnectedDescriptor *descriptor,
+    ArduinoWidgetImpl(ola::io::SelectServerInterface *ss,
+                      ola::io::ConnectedDescriptor *descriptor,
                       uint16_t esta_id,
                       uint32_t serial);
     ~ArduinoWidgetImpl();
@@ -89,7 +91,8 @@ class ArduinoWidgetImpl: public BaseUsbProWidget,
 class ArduinoWidget: public SerialWidgetInterface,
                      public ola::rdm::DiscoverableRDMControllerInterface {
  public:
-    ArduinoWidget(ola::io::ConnectedDescriptor *descriptor,
+    ArduinoWidget(ola::io::SelectServerInterface *ss,
+                  ola::io::ConnectedDescriptor *descriptor,
                   uint16_t esta_id,
                   uint32_t serial,
                   unsigned int queue_size = 20);
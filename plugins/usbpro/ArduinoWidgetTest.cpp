@@ -112,6 +112,7 @@ void ArduinoWidgetTest::setUp() {
   m_transaction_number = 0;
 
   m_arduino.reset(new ola::plugin::usbpro::ArduinoWidget(
+      &m_ss,
       &m_descriptor,
       ESTA_ID,
       SERIAL_NUMBER));
@@ -33,6 +33,7 @@
 #include "ola/Logging.h"
 #include "ola/io/IOUtils.h"
 #include "ola/io/Serial.h"
+#include "ola/io/SerialBuffer.h"
 #include "ola/base/Macro.h"
 #include "plugins/usbpro/BaseUsbProWidget.h"
 
@@ -48,11 +49,10 @@ const unsigned int BaseUsbProWidget::HEADER_SIZE =
 
 
 BaseUsbProWidget::BaseUsbProWidget(
+    ola::io::SelectServerInterface *ss,
     ola::io::ConnectedDescriptor *descriptor)
     : m_descriptor(descriptor),
-      m_state(PRE_SOM),
-      m_bytes_received(0) {
-  memset(&m_header, 0, sizeof(m_header));
+      m_serial(descriptor, ss) {
   m_descriptor->SetOnData(
       NewCallback(this, &BaseUsbProWidget::DescriptorReady));
 }
@@ -67,8 +67,8 @@ BaseUsbProWidget::~BaseUsbProWidget() {
  * Read data from the widget
  */
 void BaseUsbProWidget::DescriptorReady() {
-  while (m_descriptor->DataRemaining() > 0) {
-    ReceiveMessage();
+  while (m_serial.Read()) {
+    while (ReceiveMessage()) {}
   }
 }
 
@@ -102,8 +102,12 @@ bool BaseUsbProWidget::SendMessage(uint8_t label,
   if (length && !data)
     return false;
 
-  ssize_t frame_size = HEADER_SIZE + length + 1;
-  uint8_t frame[frame_size];
+  if (length > MAX_DATA_SIZE) {
+    OLA_WARN << "Message of " << length << " bytes is too large";
+    return false;
+  }
+
+  uint8_t frame[HEADER_SIZE + MAX_DATA_SIZE + 1];
   message_header *header = reinterpret_cast<message_header*>(frame);
   header->som = SOM;
   header->label = label;
@@ -111,14 +115,11 @@ bool BaseUsbProWidget::SendMessage(uint8_t label,
   header->len_hi = (length & 0xFF00) >> 8;
 
   memcpy(frame + sizeof(message_header), data, length);
-  frame[frame_size - 1] = EOM;
-
-  ssize_t bytes_sent = m_descriptor->Send(frame, frame_size);
-  if (bytes_sent != frame_size)
-    // we've probably screwed framing at this point
-    return false;
+  frame[HEADER_SIZE + length] = EOM;
 
-  return true;
+  // If only part of the frame is written, the rest is queued and sent before
+  // the next frame, so the framing is preserved.
+  return m_serial.Send(frame, HEADER_SIZE + length + 1);
 }
 
 
@@ -145,86 +146,36 @@ ola::io::ConnectedDescriptor *BaseUsbProWidget::OpenDevice(
 }
 
 /*
- * Read the data and handle the messages.
+ * Handle the next message in the receive buffer.
+ * @returns true if a message was handled or data was discarded, false if we
+ *   need to wait for more data.
  */
-void BaseUsbProWidget::ReceiveMessage() {
-  unsigned int count, packet_length;
-
-  switch (m_state) {
-    case PRE_SOM:
-      do {
-        m_descriptor->Receive(&m_header.som, 1, count);
-        if (count != 1)
-          return;
-      } while (m_header.som != SOM);
-      m_state = RECV_LABEL;
-      // fall through
-      OLA_FALLTHROUGH
-    case RECV_LABEL:
-      m_descriptor->Receive(&m_header.label, 1, count);
-      if (count != 1)
-        return;
-      m_state = RECV_SIZE_LO;
-      // fall through
-      OLA_FALLTHROUGH
-    case RECV_SIZE_LO:
-      m_descriptor->Receive(&m_header.len, 1, count);
-      if (count != 1)
-        return;
-      m_state = RECV_SIZE_HI;
-      // fall through
-      OLA_FALLTHROUGH
-    case RECV_SIZE_HI:
-      m_descriptor->Receive(&m_header.len_hi, 1, count);
-      if (count != 1)
-        return;
-
-      packet_length = (m_header.len_hi << 8) + m_header.len;
-      if (packet_length == 0) {
-        m_state = RECV_EOM;
-        return;
-      } else if (packet_length > MAX_DATA_SIZE) {
-        m_state = PRE_SOM;
-        return;
-      }
-
-      m_bytes_received = 0;
-      m_state = RECV_BODY;
-      // fall through
-      OLA_FALLTHROUGH
-    case RECV_BODY:
-      packet_length = (m_header.len_hi << 8) + m_header.len;
-      m_descriptor->Receive(
-          reinterpret_cast<uint8_t*>(&m_recv_buffer) + m_bytes_received,
-          packet_length - m_bytes_received,
-          count);
-
-      if (!count)
-        return;
-
-      m_bytes_received += count;
-      if (m_bytes_received != packet_length)
-        return;
-
-      m_state = RECV_EOM;
-      // fall through
-      OLA_FALLTHROUGH
-    case RECV_EOM:
-      // check this is a valid frame with an end byte
-      uint8_t eom;
-      m_descriptor->Receive(&eom, 1, count);
-      if (count != 1)
-        return;
-
-      packet_length = (m_header.len_hi << 8) + m_header.len;
-
-      if (eom == EOM)
-        HandleMessage(m_header.label,
-                      packet_length ? m_recv_buffer : NULL,
-                      packet_length);
-      m_state = PRE_SOM;
+bool BaseUsbProWidget::ReceiveMessage() {
+  if (!m_serial.SkipTo(SOM) || m_serial.Size() < HEADER_SIZE) {
+    return false;
   }
-  return;
+
+  const message_header *header =
+      reinterpret_cast<const message_header*>(m_serial.Data());
+  unsigned int packet_length = (header->len_hi << 8) + header->len;
+  if (packet_length > MAX_DATA_SIZE) {
+    // Not a valid frame, look for the next SOM.
+    m_serial.Consume(1);
+    return true;
+  }
+
+  unsigned int frame_size = HEADER_SIZE + packet_length + 1;
+  if (m_serial.Size() < frame_size) {
+    return false;
+  }
+
+  // check this is a valid frame with an end byte
+  const uint8_t *data = m_serial.Data() + HEADER_SIZE;
+  if (data[packet_length] == EOM) {
+    HandleMessage(header->label, packet_length ? data : NULL, packet_length);
+  }
+  m_serial.Consume(frame_size);
+  return true;
 }
 }  // namespace usbpro
 }  // namespace plugin
@@ -27,6 +27,8 @@
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
 #include "ola/io/Descriptor.h"
+#include "ola/io/SelectServerInterface.h"
+#include "ola/io/SerialBuffer.h"
 #include "plugins/usbpro/SerialWidgetInterface.h"
 
 namespace ola {
@@ -39,7 +41,15 @@ namespace usbpro {
  */
 class BaseUsbProWidget: public SerialWidgetInterface {
  public:
-  explicit BaseUsbProWidget(ola::io::ConnectedDescriptor *descriptor);
+  /**
+   * @brief Create a new BaseUsbProWidget.
+   * @param ss the SelectServer the descriptor is registered with, used to
+   *   finish partial writes once the descriptor is writable. If NULL, the rest
+   *   of a partial write is only sent with the next message.
+   * @param descriptor the descriptor to use, ownership is not transferred.
+   */
+  BaseUsbProWidget(ola::io::SelectServerInterface *ss,
+                   ola::io::ConnectedDescriptor *descriptor);
   virtual ~BaseUsbProWidget();
 
   ola::io::ConnectedDescriptor *GetDescriptor() const {
@@ -64,15 +74,6 @@ class BaseUsbProWidget: public SerialWidgetInterface {
   static const uint8_t SERIAL_LABEL = 10;
 
  private:
-  typedef enum {
-    PRE_SOM,
-    RECV_LABEL,
-    RECV_SIZE_LO,
-    RECV_SIZE_HI,
-    RECV_BODY,
-    RECV_EOM,
-  } receive_state;
-
   enum {MAX_DATA_SIZE = 600};
 
   typedef struct {
@@ -83,12 +84,9 @@ class BaseUsbProWidget: public SerialWidgetInterface {
   } message_header;
 
   ola::io::ConnectedDescriptor *m_descriptor;
-  receive_state m_state;
-  unsigned int m_bytes_received;
-  message_header m_header;
-  uint8_t m_recv_buffer[MAX_DATA_SIZE];
+  mutable ola::io::SerialBuffer m_serial;
 
-  void ReceiveMessage();
+  bool ReceiveMessage();
   virtual void HandleMessage(uint8_t label,
                              const uint8_t *data,
                              unsigned int length) = 0;
@@ -110,8 +108,9 @@ class DispatchingUsbProWidget: public BaseUsbProWidget {
                          const uint8_t*,
                          unsigned int> MessageCallback;
   DispatchingUsbProWidget(ola::io::ConnectedDescriptor *descriptor,
-                          MessageCallback *callback)
-      : BaseUsbProWidget(descriptor),
+                          MessageCallback *callback,
+                          ola::io::SelectServerInterface *ss = NULL)
+      : BaseUsbProWidget(ss, descriptor),
         m_callback(callback) {
   }
 
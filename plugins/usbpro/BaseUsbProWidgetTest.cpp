@@ -90,7 +90,8 @@ void BaseUsbProWidgetTest::setUp() {
   m_widget.reset(
       new ola::plugin::usbpro::DispatchingUsbProWidget(
         &m_descriptor,
-        ola::NewCallback(this, &BaseUsbProWidgetTest::ReceiveMessage)));
+        ola::NewCallback(this, &BaseUsbProWidgetTest::ReceiveMessage),
+        &m_ss));
 
   m_removed = false;
 
@@ -19,7 +19,6 @@
  */
 
 #include <string.h>
-#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -33,7 +32,6 @@
 #include "ola/rdm/RDMEnums.h"
 #include "ola/rdm/UID.h"
 #include "ola/rdm/UIDSet.h"
-#include "ola/stl/STLUtils.h"
 #include "ola/strings/Format.h"
 #include "plugins/usbpro/BaseUsbProWidget.h"
 #include "plugins/usbpro/DmxTriWidget.h"
@@ -55,7 +53,6 @@ using ola::rdm::UID;
 using ola::rdm::UIDSet;
 using ola::strings::ToHex;
 using std::auto_ptr;
-using std::map;
 using std::string;
 using std::vector;
 
@@ -63,11 +60,11 @@ using std::vector;
  * New DMX TRI Widget
  */
 DmxTriWidgetImpl::DmxTriWidgetImpl(
-    ola::thread::SchedulerInterface *scheduler,
+    ola::io::SelectServerInterface *ss,
     ola::io::ConnectedDescriptor *descriptor,
     bool use_raw_rdm)
-    : BaseUsbProWidget(descriptor),
-      m_scheduler(scheduler),
+    : BaseUsbProWidget(ss, descriptor),
+      m_scheduler(ss),
       m_uid_count(0),
       m_last_esta_id(UID::ALL_MANUFACTURERS),
       m_use_raw_rdm(use_raw_rdm),
@@ -207,7 +204,7 @@ void DmxTriWidgetImpl::SendDMXBuffer() {
 void DmxTriWidgetImpl::SendQueuedRDMCommand() {
   // If we can't find this UID, fail now.
   const UID &dest_uid = m_pending_rdm_request->DestinationUID();
-  if (!dest_uid.IsBroadcast() && !STLContains(m_uid_index_map, dest_uid)) {
+  if (!dest_uid.IsBroadcast() && !m_uid_index_map.Contains(dest_uid)) {
     HandleRDMError(ola::rdm::RDM_UNKNOWN_UID);
     return;
   }
@@ -245,10 +242,7 @@ void DmxTriWidgetImpl::RunDiscoveryCallback(RDMDiscoveryCallback *callback) {
     return;
 
   UIDSet uid_set;
-  UIDToIndexMap::iterator iter = m_uid_index_map.begin();
-  for (; iter != m_uid_index_map.end(); ++iter) {
-    uid_set.AddUID(iter->first);
-  }
+  m_uid_index_map.GetUIDs(&uid_set);
   callback->Run(uid_set);
 }
 
@@ -447,14 +441,13 @@ void DmxTriWidgetImpl::DispatchRequest() {
   if (request->DestinationUID().IsBroadcast()) {
     message.index = 0;
   } else {
-    UIDToIndexMap::const_iterator iter =
-      m_uid_index_map.find(request->DestinationUID());
-    if (iter == m_uid_index_map.end()) {
+    const uint8_t *index = m_uid_index_map.Find(request->DestinationUID());
+    if (!index) {
       OLA_WARN << request->DestinationUID() << " not found in uid map";
       HandleRDMError(ola::rdm::RDM_UNKNOWN_UID);
       return;
     }
-    message.index = iter->second;
+    message.index = *index;
   }
   message.sub_device = HostToNetwork(request->SubDevice());
   message.param_id = HostToNetwork(request->ParamId());
@@ -481,16 +474,16 @@ void DmxTriWidgetImpl::DispatchRequest() {
  * Send a queued get message
  */
 void DmxTriWidgetImpl::DispatchQueuedGet() {
-  UIDToIndexMap::const_iterator iter =
-    m_uid_index_map.find(m_pending_rdm_request->DestinationUID());
-  if (iter == m_uid_index_map.end()) {
+  const uint8_t *index =
+    m_uid_index_map.Find(m_pending_rdm_request->DestinationUID());
+  if (!index) {
     OLA_WARN << m_pending_rdm_request->DestinationUID()
              << " not found in uid map";
     HandleRDMError(ola::rdm::RDM_FAILED_TO_SEND);
     return;
   }
   uint8_t data[3] = {QUEUED_GET_COMMAND_ID,
-                     iter->second,
+                     *index,
                      m_pending_rdm_request->ParamData()[0]};
 
   if (!SendCommandToTRI(EXTENDED_COMMAND_LABEL,
@@ -564,7 +557,7 @@ void DmxTriWidgetImpl::HandleDiscoverStatResponse(uint8_t return_code,
                 << static_cast<int>(data[0]) << " devices found";
       StopDiscovery();
       m_uid_count = data[0];
-      m_uid_index_map.clear();
+      m_uid_index_map.Clear();
       if (m_uid_count) {
         m_discovery_state = FETCH_UID_REQUIRED;
         MaybeSendNextRequest();
@@ -590,7 +583,7 @@ void DmxTriWidgetImpl::HandleDiscoverStatResponse(uint8_t return_code,
         break;
     }
     // clear out the old map
-    m_uid_index_map.clear();
+    m_uid_index_map.Clear();
     StopDiscovery();
     RDMDiscoveryCallback *callback = m_discovery_callback;
     m_discovery_callback = NULL;
@@ -616,7 +609,7 @@ void DmxTriWidgetImpl::HandleRemoteUIDResponse(uint8_t return_code,
       OLA_INFO << "Short RemoteUID response, was " << length;
     } else {
       const UID uid(data);
-      m_uid_index_map[uid] = m_uid_count;
+      m_uid_index_map.Set(uid, m_uid_count);
     }
   } else if (return_code == EC_CONSTRAINT) {
     // this is returned if the index is wrong
@@ -1025,11 +1018,11 @@ bool DmxTriWidgetImpl::ReturnCodeToNackReason(
 /**
  * DmxTriWidget Constructor
  */
-DmxTriWidget::DmxTriWidget(ola::thread::SchedulerInterface *scheduler,
+DmxTriWidget::DmxTriWidget(ola::io::SelectServerInterface *ss,
                            ola::io::ConnectedDescriptor *descriptor,
                            unsigned int queue_size,
                            bool use_raw_rdm) {
-  m_impl = new DmxTriWidgetImpl(scheduler, descriptor, use_raw_rdm);
+  m_impl = new DmxTriWidgetImpl(ss, descriptor, use_raw_rdm);
   m_controller = new ola::rdm::DiscoverableQueueingRDMController(m_impl,
                                                                  queue_size);
 }
@@ -21,13 +21,14 @@
 #ifndef PLUGINS_USBPRO_DMXTRIWIDGET_H_
 #define PLUGINS_USBPRO_DMXTRIWIDGET_H_
 
-#include <map>
 #include <string>
 #include <queue>
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
+#include "ola/io/SelectServerInterface.h"
 #include "ola/rdm/QueueingRDMController.h"
 #include "ola/rdm/RDMControllerInterface.h"
+#include "ola/rdm/UIDMap.h"
 #include "ola/rdm/UIDSet.h"
 #include "ola/thread/SchedulerInterface.h"
 #include "plugins/usbpro/BaseUsbProWidget.h"
@@ -43,7 +44,7 @@ namespace usbpro {
 class DmxTriWidgetImpl: public BaseUsbProWidget,
                         public ola::rdm::DiscoverableRDMControllerInterface {
  public:
-    DmxTriWidgetImpl(ola::thread::SchedulerInterface *executor,
+    DmxTriWidgetImpl(ola::io::SelectServerInterface *ss,
                      ola::io::ConnectedDescriptor *descriptor,
                      bool use_raw_rdm);
     ~DmxTriWidgetImpl();
@@ -80,7 +81,7 @@ class DmxTriWidgetImpl: public BaseUsbProWidget,
       FETCH_UID_REQUIRED,
     } TriDiscoveryState;
 
-    typedef std::map<ola::rdm::UID, uint8_t> UIDToIndexMap;
+    typedef ola::rdm::UIDMap<uint8_t> UIDToIndexMap;
 
     ola::thread::SchedulerInterface *m_scheduler;
     UIDToIndexMap m_uid_index_map;
@@ -217,7 +218,7 @@ class DmxTriWidgetImpl: public BaseUsbProWidget,
 class DmxTriWidget: public SerialWidgetInterface,
                     public ola::rdm::DiscoverableRDMControllerInterface {
  public:
-    DmxTriWidget(ola::thread::SchedulerInterface *ss,
+    DmxTriWidget(ola::io::SelectServerInterface *ss,
                  ola::io::ConnectedDescriptor *descriptor,
                  unsigned int queue_size = 20,
                  bool use_raw_rdm = false);
@@ -41,7 +41,8 @@ namespace usbpro {
 class DmxterWidgetImpl: public BaseUsbProWidget,
                         public ola::rdm::DiscoverableRDMControllerInterface {
  public:
-    DmxterWidgetImpl(ola::io::ConnectedDescriptor *descriptor,
+    DmxterWidgetImpl(ola::io::SelectServerInterface *ss,
+                     ola::io::ConnectedDescriptor *descriptor,
                      uint16_t esta_id,
                      uint32_t serial);
     ~DmxterWidgetImpl();
@@ -130,7 +131,8 @@ class DmxterWidgetImpl: public BaseUsbProWidget,
 class DmxterWidget: public SerialWidgetInterface,
                     public ola::rdm::DiscoverableRDMControllerInterface {
  public:
-    DmxterWidget(ola::io::ConnectedDescriptor *descriptor,
+    DmxterWidget(ola::io::SelectServerInterface *ss,
+                 ola::io::ConnectedDescriptor *descriptor,
                  uint16_t esta_id,
                  uint32_t serial,
                  unsigned int queue_size = 20);
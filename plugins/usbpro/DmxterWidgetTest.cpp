@@ -106,7 +106,8 @@ CPPUNIT_TEST_SUITE_REGISTRATION(DmxterWidgetTest);
 void DmxterWidgetTest::setUp() {
   CommonWidgetTest::setUp();
   m_widget.reset(
-      new ola::plugin::usbpro::DmxterWidget(&m_descriptor,
+      new ola::plugin::usbpro::DmxterWidget(&m_ss,
+                                            &m_descriptor,
                                             0x4744,
                                             0x12345678));
   m_tod_counter = 0;
@@ -715,6 +715,12 @@ void EnttecPort::RunIncrementalDiscovery(
   }
 }
 
+void EnttecPort::SetKnownUIDs(const UIDSet &uids) {
+  if (m_enable_rdm) {
+    m_impl->SetKnownUIDs(uids);
+  }
+}
+
 
 // EnttecUsbProWidgetImpl
 // ----------------------------------------------------------------------------
@@ -726,7 +732,7 @@ void EnttecPort::RunIncrementalDiscovery(
 class EnttecUsbProWidgetImpl : public BaseUsbProWidget {
  public:
     EnttecUsbProWidgetImpl(
-        ola::thread::SchedulerInterface *scheduler,
+        ola::io::SelectServerInterface *ss,
         ola::io::ConnectedDescriptor *descriptor,
         const EnttecUsbProWidget::EnttecUsbProWidgetOptions &options);
     ~EnttecUsbProWidgetImpl();
@@ -775,11 +781,11 @@ class EnttecUsbProWidgetImpl : public BaseUsbProWidget {
  * This also works for the RDM Pro with the standard firmware loaded.
  */
 EnttecUsbProWidgetImpl::EnttecUsbProWidgetImpl(
-  ola::thread::SchedulerInterface *scheduler,
+  ola::io::SelectServerInterface *ss,
   ola::io::ConnectedDescriptor *descriptor,
   const EnttecUsbProWidget::EnttecUsbProWidgetOptions &options)
-    : BaseUsbProWidget(descriptor),
-      m_scheduler(scheduler),
+    : BaseUsbProWidget(ss, descriptor),
+      m_scheduler(ss),
       m_watchdog_timer_id(ola::thread::INVALID_TIMEOUT),
       m_send_cb(NewCallback(this, &EnttecUsbProWidgetImpl::SendCommand)),
       m_uid(options.esta_id ? options.esta_id :
@@ -964,10 +970,10 @@ bool EnttecUsbProWidgetImpl::Watchdog() {
  * EnttecUsbProWidget Constructor
  */
 EnttecUsbProWidget::EnttecUsbProWidget(
-    ola::thread::SchedulerInterface *scheduler,
+    ola::io::SelectServerInterface *ss,
     ola::io::ConnectedDescriptor *descriptor,
     const EnttecUsbProWidgetOptions &options) {
-  m_impl = new EnttecUsbProWidgetImpl(scheduler, descriptor, options);
+  m_impl = new EnttecUsbProWidgetImpl(ss, descriptor, options);
 }
 
 
@@ -26,6 +26,7 @@
 #include <string>
 #include "ola/Callback.h"
 #include "ola/DmxBuffer.h"
+#include "ola/io/SelectServerInterface.h"
 #include "ola/thread/SchedulerInterface.h"
 #include "ola/rdm/DiscoveryAgent.h"
 #include "ola/rdm/QueueingRDMController.h"
@@ -67,6 +68,9 @@ class EnttecPort
     void RunFullDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
     void RunIncrementalDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
 
+    // Seed discovery with UIDs from a previous run.
+    void SetKnownUIDs(const ola::rdm::UIDSet &uids);
+
     // the tests access the implementation directly.
     friend class ::EnttecUsbProWidgetTest;
 
@@ -118,7 +122,7 @@ class EnttecUsbProWidget: public SerialWidgetInterface {
       }
     };
 
-    EnttecUsbProWidget(ola::thread::SchedulerInterface *ss,
+    EnttecUsbProWidget(ola::io::SelectServerInterface *ss,
                        ola::io::ConnectedDescriptor *descriptor,
                        const EnttecUsbProWidgetOptions &options);
     ~EnttecUsbProWidget();
@@ -106,6 +106,10 @@ class RobeOutputPort: public BasicOutputPort {
       m_widget->RunIncrementalDiscovery(callback);
     }
 
+    void SetKnownUIDs(const ola::rdm::UIDSet &uids) {
+      m_widget->SetKnownUIDs(uids);
+    }
+
  private:
     RobeWidget *m_widget;
 };
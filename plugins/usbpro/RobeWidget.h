@@ -61,6 +61,9 @@ class RobeWidgetImpl: public BaseRobeWidget,
                         ola::rdm::RDMCallback *on_complete);
     void RunFullDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
     void RunIncrementalDiscovery(ola::rdm::RDMDiscoveryCallback *callback);
+    void SetKnownUIDs(const ola::rdm::UIDSet &uids) {
+      m_discovery_agent.SetKnownUIDs(uids);
+    }
 
     // incoming DMX methods
     bool ChangeToReceiveMode();
@@ -143,6 +146,10 @@ class RobeWidget: public SerialWidgetInterface,
       m_impl->RunIncrementalDiscovery(callback);
     }
 
+    void SetKnownUIDs(const ola::rdm::UIDSet &uids) {
+      m_impl->SetKnownUIDs(uids);
+    }
+
     bool ChangeToReceiveMode() {
       return m_impl->ChangeToReceiveMode();
     }
@@ -29,8 +29,9 @@ namespace usbpro {
  * UltraDMXProWidget Constructor
  */
 UltraDMXProWidget::UltraDMXProWidget(
+  ola::io::SelectServerInterface *ss,
   ola::io::ConnectedDescriptor *descriptor)
-    : GenericUsbProWidget(descriptor) {
+    : GenericUsbProWidget(ss, descriptor) {
 }
 
 
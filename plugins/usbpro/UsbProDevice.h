@@ -183,6 +183,10 @@ class UsbProOutputPort: public BasicOutputPort {
     m_port->RunIncrementalDiscovery(callback);
   }
 
+  void SetKnownUIDs(const ola::rdm::UIDSet &uids) {
+    m_port->SetKnownUIDs(uids);
+  }
+
   std::string Description() const { return m_description; }
 
  private:
@@ -0,0 +1,427 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DeviceConnectionEngine.cpp
+ * Copyright (C) 2026 Simon Newton
+ */
+
+#include <ola/Callback.h>
+#include <ola/Clock.h>
+#include <ola/Logging.h>
+#include <ola/acn/ACNPort.h>
+#include <ola/base/Macro.h>
+#include <ola/e133/E133Enums.h>
+#include <ola/io/IOStack.h>
+#include <ola/io/NonBlockingSender.h>
+#include <ola/network/AdvancedTCPConnector.h>
+#include <ola/network/BatchedHealthChecker.h>
+#include <ola/network/IPV4Address.h>
+#include <ola/network/Socket.h>
+#include <ola/stl/STLUtils.h>
+
+#include <memory>
+#include <string>
+
+#include "libs/acn/E133Inflator.h"
+#include "libs/acn/TCPTransport.h"
+
+#include "tools/e133/DeviceConnectionEngine.h"
+
+namespace ola {
+namespace e133 {
+
+using ola::NewCallback;
+using ola::NewSingleCallback;
+using ola::STLContains;
+using ola::STLFindOrNull;
+using ola::TimeInterval;
+using ola::acn::IncomingTCPTransport;
+using ola::io::IOStack;
+using ola::io::NonBlockingSender;
+using ola::network::BatchedHealthChecker;
+using ola::network::GenericSocketAddress;
+using ola::network::IPV4Address;
+using ola::network::IPV4SocketAddress;
+using ola::network::TCPSocket;
+using std::auto_ptr;
+using std::string;
+
+
+/**
+ * Holds everything we need to manage a TCP connection to a E1.33 device.
+ */
+class DeviceConnectionEngine::DeviceState
+    : public BatchedHealthChecker::Connection {
+ public:
+    DeviceState(DeviceConnectionEngine *engine, const IPV4Address &ip_address)
+      : ip_address(ip_address),
+        socket(NULL),
+        message_queue(NULL),
+        in_transport(NULL),
+        am_designated_controller(false),
+        m_engine(engine) {
+    }
+
+    void SendHeartbeat() {
+      IOStack packet(m_engine->m_message_builder->pool());
+      m_engine->m_message_builder->BuildNullTCPPacket(&packet);
+      message_queue->SendMessage(&packet);
+    }
+
+    void HeartbeatTimeout() {
+      // The health checker has already dropped this connection, so it's safe
+      // to close it from here.
+      m_engine->SocketUnhealthy(ip_address);
+    }
+
+    const IPV4Address ip_address;
+    // The following may be NULL.
+    // The socket connected to the E1.33 device
+    auto_ptr<TCPSocket> socket;
+    auto_ptr<NonBlockingSender> message_queue;
+    auto_ptr<IncomingTCPTransport> in_transport;
+
+    // True if we're the designated controller.
+    bool am_designated_controller;
+
+ private:
+    DeviceConnectionEngine *m_engine;
+
+    DISALLOW_COPY_AND_ASSIGN(DeviceState);
+};
+
+
+// 5 second connect() timeout
+const TimeInterval DeviceConnectionEngine::TCP_CONNECT_TIMEOUT(5, 0);
+// retry TCP connects after 5 seconds
+const TimeInterval DeviceConnectionEngine::INITIAL_TCP_RETRY_DELAY(5, 0);
+// we grow the retry interval to a max of 30 seconds
+const TimeInterval DeviceConnectionEngine::MAX_TCP_RETRY_DELAY(30, 0);
+
+const unsigned int DeviceConnectionEngine::DEFAULT_HEARTBEAT_INTERVAL;
+const unsigned int DeviceConnectionEngine::DEFAULT_HEARTBEAT_SLOTS;
+const unsigned int DeviceConnectionEngine::DEFAULT_RECEIVE_BUFFER_SIZE;
+
+
+/**
+ * Construct a new DeviceConnectionEngine
+ * @param ss a pointer to a SelectServerInterface to use
+ * @param message_builder the MessageBuilder to use, this must only be used
+ *   from the same thread as ss.
+ * @param options the Options for the engine.
+ */
+DeviceConnectionEngine::DeviceConnectionEngine(
+    ola::io::SelectServerInterface *ss,
+    ola::e133::MessageBuilder *message_builder,
+    const Options &options)
+    : m_ss(ss),
+      m_tcp_socket_factory(
+          NewCallback(this, &DeviceConnectionEngine::OnTCPConnect)),
+      m_connector(m_ss, &m_tcp_socket_factory, TCP_CONNECT_TIMEOUT),
+      m_backoff_policy(INITIAL_TCP_RETRY_DELAY, MAX_TCP_RETRY_DELAY),
+      m_health_checker(m_ss, &m_clock, options.heartbeat_interval,
+                       options.heartbeat_slots),
+      m_message_builder(message_builder),
+      m_receive_buffer(options.receive_buffer_size ?
+                       options.receive_buffer_size :
+                       DEFAULT_RECEIVE_BUFFER_SIZE),
+      m_root_inflator(
+          NewCallback(this, &DeviceConnectionEngine::RLPDataReceived)) {
+  m_root_inflator.AddInflator(&m_e133_inflator);
+  m_e133_inflator.AddInflator(&m_rdm_inflator);
+  m_rdm_inflator.SetRDMHandler(
+      NewCallback(this, &DeviceConnectionEngine::EndpointRequest));
+}
+
+
+/**
+ * Clean up
+ */
+DeviceConnectionEngine::~DeviceConnectionEngine() {
+  DeviceMap::iterator iter = m_device_map.begin();
+  for (; iter != m_device_map.end(); ++iter) {
+    m_health_checker.RemoveConnection(iter->second);
+    if (iter->second->socket.get())
+      m_ss->RemoveReadDescriptor(iter->second->socket.get());
+  }
+  // close out all tcp sockets and free state
+  ola::STLDeleteValues(&m_device_map);
+}
+
+
+void DeviceConnectionEngine::SetRDMMessageCallback(
+    RDMMessageCallback *callback) {
+  m_rdm_callback.reset(callback);
+}
+
+
+void DeviceConnectionEngine::SetAcquireDeviceCallback(
+    DeviceCallback *callback) {
+  m_acquire_device_cb.reset(callback);
+}
+
+
+void DeviceConnectionEngine::SetReleaseDeviceCallback(
+    DeviceCallback *callback) {
+  m_release_device_cb.reset(callback);
+}
+
+
+/**
+ * Start maintaining a connection to this device.
+ */
+void DeviceConnectionEngine::AddDevice(const IPV4Address &ip_address) {
+  if (STLContains(m_device_map, ip_address.AsInt())) {
+    return;
+  }
+
+  m_device_map[ip_address.AsInt()] = new DeviceState(this, ip_address);
+
+  OLA_INFO << "Adding " << ip_address << ":" << ola::acn::E133_PORT;
+  // start the non-blocking connect
+  m_connector.AddEndpoint(
+      IPV4SocketAddress(ip_address, ola::acn::E133_PORT),
+      &m_backoff_policy);
+}
+
+
+/**
+ * Remove a device, closing the connection if we have one.
+ */
+void DeviceConnectionEngine::RemoveDevice(const IPV4Address &ip_address) {
+  DeviceState *device_state = STLFindOrNull(m_device_map, ip_address.AsInt());
+  if (!device_state)
+    return;
+
+  CloseConnection(device_state);
+  m_connector.RemoveEndpoint(
+      IPV4SocketAddress(ip_address, ola::acn::E133_PORT));
+  m_device_map.erase(ip_address.AsInt());
+  delete device_state;
+}
+
+
+/**
+ * Remove a device if there is no open connection.
+ */
+void DeviceConnectionEngine::RemoveDeviceIfNotConnected(
+    const IPV4Address &ip_address) {
+  DeviceState *device_state = STLFindOrNull(m_device_map, ip_address.AsInt());
+  if (device_state && !device_state->socket.get())
+    RemoveDevice(ip_address);
+}
+
+
+void DeviceConnectionEngine::AcknowledgeMessage(const IPV4Address &ip_address,
+                                                uint32_t sequence_number,
+                                                uint16_t endpoint) {
+  DeviceState *device_state = STLFindOrNull(m_device_map, ip_address.AsInt());
+  if (!device_state || !device_state->message_queue.get()) {
+    OLA_WARN << "No connection to " << ip_address << ", can't send ack";
+    return;
+  }
+
+  IOStack packet(m_message_builder->pool());
+  m_message_builder->BuildTCPE133StatusPDU(
+      &packet, sequence_number, endpoint, ola::e133::SC_E133_ACK, "OK");
+  device_state->message_queue->SendMessage(&packet);
+  m_health_checker.HeartbeatSent(device_state);
+}
+
+
+/**
+ * Called when a TCP socket is connected. Note that we're not the designated
+ * controller at this point. That only happens if we receive data on the
+ * connection.
+ */
+void DeviceConnectionEngine::OnTCPConnect(TCPSocket *socket_ptr) {
+  auto_ptr<TCPSocket> socket(socket_ptr);
+  GenericSocketAddress address = socket->GetPeerAddress();
+  if (address.Family() != AF_INET) {
+    OLA_WARN << "Non IPv4 socket " << address;
+    return;
+  }
+  IPV4SocketAddress v4_address = address.V4Addr();
+  DeviceState *device_state = STLFindOrNull(
+      m_device_map, v4_address.Host().AsInt());
+  if (!device_state) {
+    OLA_FATAL << "Unable to locate socket for " << v4_address;
+    return;
+  }
+
+  // setup the incoming transport, we don't need to setup the outgoing one
+  // until we've got confirmation that we're the designated controller.
+  device_state->socket.reset(socket.release());
+  device_state->in_transport.reset(
+      new IncomingTCPTransport(&m_root_inflator, socket_ptr,
+                               &m_receive_buffer[0],
+                               m_receive_buffer.size()));
+
+  device_state->socket->SetOnData(
+      NewCallback(this, &DeviceConnectionEngine::ReceiveTCPData,
+                  v4_address.Host(), device_state->in_transport.get()));
+  device_state->socket->SetOnClose(
+      NewSingleCallback(this, &DeviceConnectionEngine::SocketClosed,
+                        v4_address.Host()));
+  m_ss->AddReadDescriptor(socket_ptr);
+}
+
+
+/**
+ * Receive data on a TCP connection
+ */
+void DeviceConnectionEngine::ReceiveTCPData(IPV4Address ip_address,
+                                            IncomingTCPTransport *transport) {
+  if (!transport->Receive()) {
+    OLA_WARN << "Bad TCP stream from " << ip_address;
+    SocketClosed(ip_address);
+  }
+}
+
+
+/**
+ * Called when a connection is deemed unhealthy.
+ */
+void DeviceConnectionEngine::SocketUnhealthy(IPV4Address ip_address) {
+  OLA_INFO << "connection to " << ip_address << " went unhealthy";
+  SocketClosed(ip_address);
+}
+
+
+/**
+ * Called when a socket is closed.
+ * This can mean one of two things:
+ *  if we weren't the designated controller, then we lost the race.
+ *  if we were the designated controller, the TCP connection was closed, or
+ *  went unhealthy.
+ */
+void DeviceConnectionEngine::SocketClosed(IPV4Address ip_address) {
+  OLA_INFO << "connection to " << ip_address << " was closed";
+
+  DeviceState *device_state = STLFindOrNull(m_device_map, ip_address.AsInt());
+  if (!device_state) {
+    OLA_FATAL << "Unable to locate socket for " << ip_address;
+    return;
+  }
+
+  if (!device_state->socket.get()) {
+    // Already closed, this happens if the heartbeat timeout races with the
+    // close.
+    return;
+  }
+
+  bool was_designated_controller = device_state->am_designated_controller;
+  CloseConnection(device_state);
+
+  if (was_designated_controller) {
+    m_connector.Disconnect(
+        IPV4SocketAddress(ip_address, ola::acn::E133_PORT));
+  } else {
+    // we lost the race, so don't try to reconnect
+    m_connector.Disconnect(
+        IPV4SocketAddress(ip_address, ola::acn::E133_PORT), true);
+  }
+}
+
+
+/**
+ * Tear down the connection state, running the release callback if we were
+ * the designated controller.
+ */
+void DeviceConnectionEngine::CloseConnection(DeviceState *device_state) {
+  m_health_checker.RemoveConnection(device_state);
+
+  if (device_state->am_designated_controller) {
+    device_state->am_designated_controller = false;
+    if (m_release_device_cb.get())
+      m_release_device_cb->Run(device_state->ip_address);
+  }
+
+  device_state->message_queue.reset();
+  device_state->in_transport.reset();
+  if (device_state->socket.get()) {
+    m_ss->RemoveReadDescriptor(device_state->socket.get());
+    device_state->socket.reset();
+  }
+}
+
+
+/**
+ * Called when we receive E1.33 data. If this arrived over TCP we notify the
+ * health checker.
+ */
+void DeviceConnectionEngine::RLPDataReceived(
+    const ola::acn::TransportHeader &header) {
+  if (header.Transport() != ola::acn::TransportHeader::TCP)
+    return;
+  IPV4Address src_ip = header.Source().Host();
+
+  DeviceState *device_state = STLFindOrNull(m_device_map, src_ip.AsInt());
+  if (!device_state) {
+    OLA_FATAL << "Received data but unable to lookup socket for " <<
+      src_ip;
+    return;
+  }
+
+  // If we're already the designated controller, we just need to notify the
+  // health checker.
+  if (device_state->am_designated_controller) {
+    m_health_checker.HeartbeatReceived(device_state);
+    return;
+  }
+
+  // This is the first packet received on this connection, which is a sign
+  // we're now the designated controller. Setup the outgoing transport and
+  // start health checking.
+  device_state->am_designated_controller = true;
+  OLA_INFO << "Now the designated controller for " << header.Source();
+  if (m_acquire_device_cb.get())
+    m_acquire_device_cb->Run(src_ip);
+
+  device_state->message_queue.reset(
+      new NonBlockingSender(device_state->socket.get(), m_ss,
+                            m_message_builder->pool()));
+  m_health_checker.AddConnection(device_state);
+}
+
+
+/**
+ * Handle a message on the TCP connection.
+ */
+void DeviceConnectionEngine::EndpointRequest(
+    const ola::acn::TransportHeader *transport_header,
+    const ola::acn::E133Header *e133_header,
+    const string &raw_request) {
+  if (!m_rdm_callback.get())
+    return;
+
+  if (e133_header->Endpoint()) {
+    OLA_WARN << "TCP message for non-0 endpoint. Endpoint = "
+             << e133_header->Endpoint();
+    return;
+  }
+
+  if (!m_rdm_callback->Run(transport_header->Source().Host(),
+                           e133_header->Endpoint(), e133_header->Sequence(),
+                           raw_request)) {
+    // Don't send an ack
+    return;
+  }
+
+  AcknowledgeMessage(transport_header->Source().Host(),
+                     e133_header->Sequence(), e133_header->Endpoint());
+}
+}  // namespace e133
+}  // namespace ola
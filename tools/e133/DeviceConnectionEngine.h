@@ -0,0 +1,176 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * DeviceConnectionEngine.h
+ * Copyright (C) 2026 Simon Newton
+ * Maintains the TCP connections to a set of E1.33 devices.
+ */
+
+#ifndef TOOLS_E133_DEVICECONNECTIONENGINE_H_
+#define TOOLS_E133_DEVICECONNECTIONENGINE_H_
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <ola/Callback.h>
+#include <ola/Clock.h>
+#include <ola/base/Macro.h>
+#include <ola/e133/MessageBuilder.h>
+#include <ola/io/SelectServerInterface.h>
+#include <ola/network/AdvancedTCPConnector.h>
+#include <ola/network/BatchedHealthChecker.h>
+#include <ola/network/IPV4Address.h>
+#include <ola/network/Socket.h>
+#include <ola/network/TCPSocketFactory.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include HASH_MAP_H
+
+#include "libs/acn/RDMInflator.h"
+#include "libs/acn/E133Inflator.h"
+#include "libs/acn/RootInflator.h"
+#include "libs/acn/TCPTransport.h"
+
+namespace ola {
+namespace e133 {
+
+/**
+ * The DeviceConnectionEngine holds the TCP connections to a set of E1.33
+ * devices, all serviced by a single SelectServer. It's built to hold
+ * thousands of connections:
+ *  - The heartbeats for every connection are driven by one
+ *    BatchedHealthChecker rather than a pair of timers per connection.
+ *  - All connections share one receive buffer and one inflator chain.
+ *
+ * All methods must be called, and all callbacks are run, on the
+ * SelectServer's thread. See DeviceManagerImpl for spreading devices across
+ * several engines.
+ */
+class DeviceConnectionEngine {
+ public:
+    /*
+     * The callback used to receive RDMNet layer messages from the devices.
+     * The arguments are the device, the endpoint, the E1.33 sequence number
+     * and the raw RDM data.
+     * @returns true if the data should be acknowledged now, false otherwise.
+     */
+    typedef ola::Callback4<bool, const ola::network::IPV4Address&, uint16_t,
+                           uint32_t, const std::string&> RDMMessageCallback;
+
+    // Run when we acquire or lose designated controller status for a device.
+    typedef ola::Callback1<void, const ola::network::IPV4Address&>
+        DeviceCallback;
+
+    struct Options {
+      ola::TimeInterval heartbeat_interval;
+      // The number of slots the heartbeats are spread across.
+      unsigned int heartbeat_slots;
+      unsigned int receive_buffer_size;
+
+      Options()
+          : heartbeat_interval(DEFAULT_HEARTBEAT_INTERVAL, 0),
+            heartbeat_slots(DEFAULT_HEARTBEAT_SLOTS),
+            receive_buffer_size(DEFAULT_RECEIVE_BUFFER_SIZE) {
+      }
+    };
+
+    DeviceConnectionEngine(ola::io::SelectServerInterface *ss,
+                           ola::e133::MessageBuilder *message_builder,
+                           const Options &options = Options());
+    ~DeviceConnectionEngine();
+
+    // Ownership of the callbacks is transferred.
+    void SetRDMMessageCallback(RDMMessageCallback *callback);
+    void SetAcquireDeviceCallback(DeviceCallback *callback);
+    void SetReleaseDeviceCallback(DeviceCallback *callback);
+
+    void AddDevice(const ola::network::IPV4Address &ip_address);
+    void RemoveDevice(const ola::network::IPV4Address &ip_address);
+    void RemoveDeviceIfNotConnected(
+        const ola::network::IPV4Address &ip_address);
+
+    /**
+     * @brief Acknowledge a message that the RDMMessageCallback didn't.
+     */
+    void AcknowledgeMessage(const ola::network::IPV4Address &ip_address,
+                            uint32_t sequence_number,
+                            uint16_t endpoint);
+
+    unsigned int DeviceCount() const { return m_device_map.size(); }
+    unsigned int ManagedDeviceCount() const {
+      return m_health_checker.ConnectionCount();
+    }
+
+    // The interval used by E1.33 devices.
+    static const unsigned int DEFAULT_HEARTBEAT_INTERVAL = 5;
+    static const unsigned int DEFAULT_HEARTBEAT_SLOTS = 50;
+    static const unsigned int DEFAULT_RECEIVE_BUFFER_SIZE = 16384;
+
+ private:
+    class DeviceState;
+
+    // hash_map of IPs to DeviceState
+    typedef HASH_NAMESPACE::HASH_MAP_CLASS<uint32_t, DeviceState*>
+      DeviceMap;
+
+    DeviceMap m_device_map;
+    std::auto_ptr<RDMMessageCallback> m_rdm_callback;
+    std::auto_ptr<DeviceCallback> m_acquire_device_cb;
+    std::auto_ptr<DeviceCallback> m_release_device_cb;
+
+    ola::io::SelectServerInterface *m_ss;
+    ola::Clock m_clock;
+
+    ola::network::TCPSocketFactory m_tcp_socket_factory;
+    ola::network::AdvancedTCPConnector m_connector;
+    ola::LinearBackoffPolicy m_backoff_policy;
+    ola::network::BatchedHealthChecker m_health_checker;
+
+    ola::e133::MessageBuilder *m_message_builder;
+
+    // Shared by all connections, it's only used during a call to Receive().
+    std::vector<uint8_t> m_receive_buffer;
+
+    // inflators
+    ola::acn::RootInflator m_root_inflator;
+    ola::acn::E133Inflator m_e133_inflator;
+    ola::acn::RDMInflator m_rdm_inflator;
+
+    void OnTCPConnect(ola::network::TCPSocket *socket);
+    void ReceiveTCPData(ola::network::IPV4Address ip_address,
+                        ola::acn::IncomingTCPTransport *transport);
+    void SocketUnhealthy(ola::network::IPV4Address address);
+    void SocketClosed(ola::network::IPV4Address address);
+    void CloseConnection(DeviceState *device_state);
+    void RLPDataReceived(const ola::acn::TransportHeader &header);
+
+    void EndpointRequest(
+        const ola::acn::TransportHeader *transport_header,
+        const ola::acn::E133Header *e133_header,
+        const std::string &raw_request);
+
+    static const TimeInterval TCP_CONNECT_TIMEOUT;
+    static const TimeInterval INITIAL_TCP_RETRY_DELAY;
+    static const TimeInterval MAX_TCP_RETRY_DELAY;
+
+    DISALLOW_COPY_AND_ASSIGN(DeviceConnectionEngine);
+};
+}  // namespace e133
+}  // namespace ola
+#endif  // TOOLS_E133_DEVICECONNECTIONENGINE_H_
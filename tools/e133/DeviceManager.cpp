@@ -46,10 +46,25 @@ DeviceManager::DeviceManager(ola::io::SelectServerInterface *ss,
 }
 
 
+/**
+ * Construct a new DeviceManager which uses I/O threads.
+ * @param ss a pointer to the SelectServer to run callbacks on.
+ * @param message_builder the MessageBuilder to use.
+ * @param io_threads the number of I/O threads.
+ */
+DeviceManager::DeviceManager(ola::io::SelectServer *ss,
+                             ola::e133::MessageBuilder *message_builder,
+                             unsigned int io_threads)
+    : m_impl(new DeviceManagerImpl(ss, message_builder, io_threads)) {
+}
+
+
 /**
  * Clean up
  */
-DeviceManager::~DeviceManager() {}
+DeviceManager::~DeviceManager() {
+  delete m_impl;
+}
 
 
 /**
@@ -18,106 +18,206 @@
  */
 
 #include <ola/Callback.h>
-#include <ola/Clock.h>
 #include <ola/Logging.h>
-#include <ola/acn/ACNPort.h>
-#include <ola/acn/CID.h>
-#include <ola/base/Macro.h>
-#include <ola/e133/E133Enums.h>
-#include <ola/io/NonBlockingSender.h>
+#include <ola/e133/MessageBuilder.h>
 #include <ola/io/SelectServer.h>
-#include <ola/network/AdvancedTCPConnector.h>
 #include <ola/network/IPV4Address.h>
-#include <ola/network/Socket.h>
-#include <ola/network/TCPSocketFactory.h>
+#include <ola/network/NetworkUtils.h>
 #include <ola/stl/STLUtils.h>
+#include <ola/strings/Format.h>
+#include <ola/thread/Thread.h>
 
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
-#include "libs/acn/E133Inflator.h"
-#include "libs/acn/E133StatusPDU.h"
-#include "libs/acn/TCPTransport.h"
-
+#include "tools/e133/DeviceConnectionEngine.h"
 #include "tools/e133/DeviceManagerImpl.h"
-#include "tools/e133/E133Endpoint.h"
-#include "tools/e133/E133HealthCheckedConnection.h"
 
 namespace ola {
 namespace e133 {
 
 using ola::NewCallback;
 using ola::NewSingleCallback;
-using ola::STLContains;
-using ola::STLFindOrNull;
-using ola::TimeInterval;
-using ola::acn::CID;
-using ola::io::NonBlockingSender;
-using ola::network::GenericSocketAddress;
+using ola::io::SelectServer;
 using ola::network::IPV4Address;
-using ola::network::IPV4SocketAddress;
-using ola::network::TCPSocket;
-using ola::acn::IncomingTCPTransport;
+using ola::network::NetworkToHost;
 
-using std::auto_ptr;
 using std::string;
 
 
 /**
- * Holds everything we need to manage a TCP connection to a E1.33 device.
+ * An I/O thread, with a SelectServer and a DeviceConnectionEngine.
+ *
+ * The engine's callbacks run on this thread. They're passed to the manager's
+ * SelectServer, which calls back into this object if an RDM message needs to
+ * be acknowledged.
  */
-class DeviceState {
+class DeviceManagerImpl::IOThread : public ola::thread::Thread {
  public:
-    DeviceState()
-      : socket(NULL),
-        message_queue(NULL),
-        health_checked_connection(NULL),
-        in_transport(NULL),
-        am_designated_controller(false) {
+    IOThread(DeviceManagerImpl *manager,
+             const ola::e133::MessageBuilder &message_builder,
+             unsigned int index)
+        : Thread(Thread::Options(
+              "e133-io-" + ola::strings::IntToString(index))),
+          m_manager(manager),
+          // The MessageBuilder's memory pool isn't thread safe, so each thread
+          // needs its own.
+          m_message_builder(message_builder.cid(),
+                            message_builder.source_name()),
+          m_engine(&m_ss, &m_message_builder) {
+      m_engine.SetRDMMessageCallback(
+          NewCallback(this, &IOThread::RDMMessage));
+      m_engine.SetAcquireDeviceCallback(
+          NewCallback(this, &IOThread::DeviceAcquired));
+      m_engine.SetReleaseDeviceCallback(
+          NewCallback(this, &IOThread::DeviceReleased));
+    }
+
+    ~IOThread() {
+      // Run anything that was queued after the thread stopped while the
+      // engine still exists.
+      m_ss.DrainCallbacks();
+    }
+
+    void *Run() {
+      m_ss.Run();
+      return NULL;
+    }
+
+    void Stop() {
+      m_ss.Execute(NewSingleCallback(&m_ss, &SelectServer::Terminate));
+      Join();
     }
 
-    // The following may be NULL.
-    // The socket connected to the E1.33 device
-    auto_ptr<TCPSocket> socket;
-    auto_ptr<NonBlockingSender> message_queue;
-    // The Health Checked connection
-    auto_ptr<E133HealthCheckedConnection> health_checked_connection;
-    auto_ptr<IncomingTCPTransport> in_transport;
+    // These may be called from any thread.
+    void AddDevice(const IPV4Address &ip_address) {
+      m_ss.Execute(NewSingleCallback(this, &IOThread::EngineAddDevice,
+                                     ip_address));
+    }
 
-    // True if we're the designated controller.
-    bool am_designated_controller;
+    void RemoveDevice(const IPV4Address &ip_address) {
+      m_ss.Execute(NewSingleCallback(this, &IOThread::EngineRemoveDevice,
+                                     ip_address));
+    }
+
+    void RemoveDeviceIfNotConnected(const IPV4Address &ip_address) {
+      m_ss.Execute(NewSingleCallback(
+          this, &IOThread::EngineRemoveDeviceIfNotConnected, ip_address));
+    }
 
  private:
-    DISALLOW_COPY_AND_ASSIGN(DeviceState);
-};
+    DeviceManagerImpl *m_manager;
+    SelectServer m_ss;
+    ola::e133::MessageBuilder m_message_builder;
+    DeviceConnectionEngine m_engine;
+
+    // Run on the I/O thread
+    void EngineAddDevice(IPV4Address ip_address) {
+      m_engine.AddDevice(ip_address);
+    }
 
+    void EngineRemoveDevice(IPV4Address ip_address) {
+      m_engine.RemoveDevice(ip_address);
+    }
+
+    void EngineRemoveDeviceIfNotConnected(IPV4Address ip_address) {
+      m_engine.RemoveDeviceIfNotConnected(ip_address);
+    }
 
-// 5 second connect() timeout
-const TimeInterval DeviceManagerImpl::TCP_CONNECT_TIMEOUT(5, 0);
-// retry TCP connects after 5 seconds
-const TimeInterval DeviceManagerImpl::INITIAL_TCP_RETRY_DELAY(5, 0);
-// we grow the retry interval to a max of 30 seconds
-const TimeInterval DeviceManagerImpl::MAX_TCP_RETRY_DELAY(30, 0);
+    void EngineAcknowledge(IPV4Address ip_address, uint32_t sequence_number,
+                           uint16_t endpoint) {
+      m_engine.AcknowledgeMessage(ip_address, sequence_number, endpoint);
+    }
+
+    bool RDMMessage(const IPV4Address &ip_address, uint16_t endpoint,
+                    uint32_t sequence_number, const string &raw_request) {
+      m_manager->m_executor->Execute(NewSingleCallback(
+          this, &IOThread::DeliverRDMMessage, ip_address, endpoint,
+          sequence_number, raw_request));
+      // The ack is sent once the manager's callback has run.
+      return false;
+    }
+
+    void DeviceAcquired(const IPV4Address &ip_address) {
+      m_manager->m_executor->Execute(NewSingleCallback(
+          this, &IOThread::DeliverDeviceAcquired, ip_address));
+    }
+
+    void DeviceReleased(const IPV4Address &ip_address) {
+      m_manager->m_executor->Execute(NewSingleCallback(
+          this, &IOThread::DeliverDeviceReleased, ip_address));
+    }
+
+    // Run on the manager's thread
+    void DeliverRDMMessage(IPV4Address ip_address, uint16_t endpoint,
+                           uint32_t sequence_number, string raw_request) {
+      if (m_manager->RunRDMCallback(ip_address, endpoint, raw_request)) {
+        m_ss.Execute(NewSingleCallback(this, &IOThread::EngineAcknowledge,
+                                       ip_address, sequence_number,
+                                       endpoint));
+      }
+    }
+
+    void DeliverDeviceAcquired(IPV4Address ip_address) {
+      m_manager->DeviceAcquired(ip_address);
+    }
+
+    void DeliverDeviceReleased(IPV4Address ip_address) {
+      m_manager->DeviceReleased(ip_address);
+    }
+
+    DISALLOW_COPY_AND_ASSIGN(IOThread);
+};
 
 
 /**
- * Construct a new DeviceManagerImpl
+ * Construct a new DeviceManagerImpl which uses a single engine.
  * @param ss a pointer to a SelectServerInterface to use
- * @param cid the CID of this controller.
+ * @param message_builder the MessageBuilder to use.
  */
 DeviceManagerImpl::DeviceManagerImpl(ola::io::SelectServerInterface *ss,
-                             ola::e133::MessageBuilder *message_builder)
+                                     ola::e133::MessageBuilder *message_builder)
     : m_ss(ss),
-      m_tcp_socket_factory(NewCallback(this, &DeviceManagerImpl::OnTCPConnect)),
-      m_connector(m_ss, &m_tcp_socket_factory, TCP_CONNECT_TIMEOUT),
-      m_backoff_policy(INITIAL_TCP_RETRY_DELAY, MAX_TCP_RETRY_DELAY),
-      m_message_builder(message_builder),
-      m_root_inflator(NewCallback(this, &DeviceManagerImpl::RLPDataReceived)) {
-  m_root_inflator.AddInflator(&m_e133_inflator);
-  m_e133_inflator.AddInflator(&m_rdm_inflator);
-  m_rdm_inflator.SetRDMHandler(
-      NewCallback(this, &DeviceManagerImpl::EndpointRequest));
+      m_executor(NULL) {
+  CreateEngine(ss, message_builder);
+}
+
+
+/**
+ * Construct a new DeviceManagerImpl which spreads the devices across I/O
+ * threads.
+ * @param ss a pointer to a SelectServer to run the callbacks on.
+ * @param message_builder the MessageBuilder to copy the CID and source name
+ *   from.
+ * @param io_threads the number of I/O threads to use, if 0 the connections
+ *   are handled on ss.
+ */
+DeviceManagerImpl::DeviceManagerImpl(ola::io::SelectServer *ss,
+                                     ola::e133::MessageBuilder *message_builder,
+                                     unsigned int io_threads)
+    : m_ss(ss),
+      m_executor(ss) {
+  if (!io_threads) {
+    CreateEngine(ss, message_builder);
+    return;
+  }
+
+  for (unsigned int i = 0; i < io_threads; i++) {
+    IOThread *thread = new IOThread(this, *message_builder, i);
+    if (!thread->Start()) {
+      OLA_WARN << "Failed to start E1.33 I/O thread " << i;
+      delete thread;
+      continue;
+    }
+    m_io_threads.push_back(thread);
+  }
+
+  if (m_io_threads.empty()) {
+    OLA_WARN << "No I/O threads, falling back to the SelectServer";
+    CreateEngine(ss, message_builder);
+  }
 }
 
 
@@ -125,8 +225,16 @@ DeviceManagerImpl::DeviceManagerImpl(ola::io::SelectServerInterface *ss,
  * Clean up
  */
 DeviceManagerImpl::~DeviceManagerImpl() {
-  // close out all tcp sockets and free state
-  ola::STLDeleteValues(&m_device_map);
+  vector<IOThread*>::iterator iter = m_io_threads.begin();
+  for (; iter != m_io_threads.end(); ++iter) {
+    (*iter)->Stop();
+  }
+  if (!m_io_threads.empty()) {
+    // Run anything the threads passed back before they stopped, since it
+    // refers to the threads.
+    m_executor->DrainCallbacks();
+  }
+  ola::STLDeleteElements(&m_io_threads);
 }
 
 
@@ -163,18 +271,11 @@ void DeviceManagerImpl::SetReleaseDeviceCallback(
  * Start maintaining a connection to this device.
  */
 void DeviceManagerImpl::AddDevice(const IPV4Address &ip_address) {
-  if (STLContains(m_device_map, ip_address.AsInt())) {
-    return;
+  if (m_engine.get()) {
+    m_engine->AddDevice(ip_address);
+  } else {
+    ThreadForDevice(ip_address)->AddDevice(ip_address);
   }
-
-  DeviceState *device_state = new DeviceState();
-  m_device_map[ip_address.AsInt()] = device_state;
-
-  OLA_INFO << "Adding " << ip_address << ":" << ola::acn::E133_PORT;
-  // start the non-blocking connect
-  m_connector.AddEndpoint(
-      IPV4SocketAddress(ip_address, ola::acn::E133_PORT),
-      &m_backoff_policy);
 }
 
 
@@ -182,12 +283,11 @@ void DeviceManagerImpl::AddDevice(const IPV4Address &ip_address) {
  * Remove a device, closing the connection if we have one.
  */
 void DeviceManagerImpl::RemoveDevice(const IPV4Address &ip_address) {
-  DeviceMap::iterator iter = m_device_map.find(ip_address.AsInt());
-  if (iter == m_device_map.end())
-    return;
-
-  // TODO(simon): implement this
-  OLA_WARN << "RemoveDevice not implemented";
+  if (m_engine.get()) {
+    m_engine->RemoveDevice(ip_address);
+  } else {
+    ThreadForDevice(ip_address)->RemoveDevice(ip_address);
+  }
 }
 
 
@@ -196,12 +296,11 @@ void DeviceManagerImpl::RemoveDevice(const IPV4Address &ip_address) {
  */
 void DeviceManagerImpl::RemoveDeviceIfNotConnected(
     const IPV4Address &ip_address) {
-  DeviceMap::iterator iter = m_device_map.find(ip_address.AsInt());
-  if (iter == m_device_map.end())
-    return;
-
-  // TODO(simon): implement this
-  OLA_WARN << "RemoveDevice not implemented";
+  if (m_engine.get()) {
+    m_engine->RemoveDeviceIfNotConnected(ip_address);
+  } else {
+    ThreadForDevice(ip_address)->RemoveDeviceIfNotConnected(ip_address);
+  }
 }
 
 
@@ -210,200 +309,64 @@ void DeviceManagerImpl::RemoveDeviceIfNotConnected(
  * for.
  */
 void DeviceManagerImpl::ListManagedDevices(vector<IPV4Address> *devices) const {
-  DeviceMap::const_iterator iter = m_device_map.begin();
-  for (; iter != m_device_map.end(); ++iter) {
-    if (iter->second->am_designated_controller)
-      devices->push_back(IPV4Address(iter->first));
-  }
+  devices->insert(devices->end(), m_managed_devices.begin(),
+                  m_managed_devices.end());
 }
 
 
 /**
- * Called when a TCP socket is connected. Note that we're not the designated
- * controller at this point. That only happens if we receive data on the
- * connection.
+ * Create the engine used when we're not using I/O threads.
  */
-void DeviceManagerImpl::OnTCPConnect(TCPSocket *socket_ptr) {
-  auto_ptr<TCPSocket> socket(socket_ptr);
-  GenericSocketAddress address = socket->GetPeerAddress();
-  if (address.Family() != AF_INET) {
-    OLA_WARN << "Non IPv4 socket " << address;
-    return;
-  }
-  IPV4SocketAddress v4_address = address.V4Addr();
-  DeviceState *device_state = STLFindOrNull(
-      m_device_map, v4_address.Host().AsInt());
-  if (!device_state) {
-    OLA_FATAL << "Unable to locate socket for " << v4_address;
-    return;
-  }
-
-  // setup the incoming transport, we don't need to setup the outgoing one
-  // until we've got confirmation that we're the designated controller.
-  device_state->socket.reset(socket.release());
-  device_state->in_transport.reset(new IncomingTCPTransport(&m_root_inflator,
-                                                            socket_ptr));
-
-  device_state->socket->SetOnData(
-      NewCallback(this, &DeviceManagerImpl::ReceiveTCPData, v4_address.Host(),
-                  device_state->in_transport.get()));
-  device_state->socket->SetOnClose(
-      NewSingleCallback(this, &DeviceManagerImpl::SocketClosed,
-                        v4_address.Host()));
-  m_ss->AddReadDescriptor(socket_ptr);
-
-  // TODO(simon): Setup a timeout that closes this connect if we don't receive
-  // anything.
+void DeviceManagerImpl::CreateEngine(
+    ola::io::SelectServerInterface *ss,
+    ola::e133::MessageBuilder *message_builder) {
+  m_engine.reset(new DeviceConnectionEngine(ss, message_builder));
+  m_engine->SetRDMMessageCallback(
+      NewCallback(this, &DeviceManagerImpl::EngineRDMMessage));
+  m_engine->SetAcquireDeviceCallback(
+      NewCallback(this, &DeviceManagerImpl::DeviceAcquired));
+  m_engine->SetReleaseDeviceCallback(
+      NewCallback(this, &DeviceManagerImpl::DeviceReleased));
 }
 
 
 /**
- * Receive data on a TCP connection
+ * Return the I/O thread that handles a device. Addresses are usually
+ * sequential so the host order address spreads them evenly.
  */
-void DeviceManagerImpl::ReceiveTCPData(IPV4Address ip_address,
-                                   IncomingTCPTransport *transport) {
-  if (!transport->Receive()) {
-    OLA_WARN << "TCP STREAM IS BAD!!!";
-    SocketClosed(ip_address);
-  }
+DeviceManagerImpl::IOThread *DeviceManagerImpl::ThreadForDevice(
+    const IPV4Address &ip_address) {
+  return m_io_threads[NetworkToHost(ip_address.AsInt()) % m_io_threads.size()];
 }
 
 
-/**
- * Called when a connection is deemed unhealthy.
- */
-void DeviceManagerImpl::SocketUnhealthy(IPV4Address ip_address) {
-  OLA_INFO << "connection to " << ip_address << " went unhealthy";
-  SocketClosed(ip_address);
+bool DeviceManagerImpl::EngineRDMMessage(const IPV4Address &ip_address,
+                                         uint16_t endpoint,
+                                         uint32_t,
+                                         const string &raw_request) {
+  return RunRDMCallback(ip_address, endpoint, raw_request);
 }
 
 
-/**
- * Called when a socket is closed.
- * This can mean one of two things:
- *  if we weren't the designated controller, then we lost the race.
- *  if we were the designated controller, the TCP connection was closed, or
- *  went unhealthy.
- */
-void DeviceManagerImpl::SocketClosed(IPV4Address ip_address) {
-  OLA_INFO << "connection to " << ip_address << " was closed";
-
-  DeviceState *device_state = STLFindOrNull(m_device_map, ip_address.AsInt());
-  if (!device_state) {
-    OLA_FATAL << "Unable to locate socket for " << ip_address;
-    return;
-  }
-
-  if (device_state->am_designated_controller) {
-    device_state->am_designated_controller = false;
-    if (m_release_device_cb_.get())
-      m_release_device_cb_->Run(ip_address);
-
-    m_connector.Disconnect(
-        IPV4SocketAddress(ip_address, ola::acn::E133_PORT));
-  } else {
-    // we lost the race, so don't try to reconnect
-    m_connector.Disconnect(
-        IPV4SocketAddress(ip_address, ola::acn::E133_PORT), true);
-  }
-
-  device_state->health_checked_connection.reset();
-  device_state->message_queue.reset();
-  device_state->in_transport.reset();
-  m_ss->RemoveReadDescriptor(device_state->socket.get());
-  device_state->socket.reset();
+bool DeviceManagerImpl::RunRDMCallback(const IPV4Address &ip_address,
+                                       uint16_t endpoint,
+                                       const string &raw_request) {
+  return (m_rdm_callback.get() &&
+          m_rdm_callback->Run(ip_address, endpoint, raw_request));
 }
 
 
-/**
- * Called when we receive E1.33 data. If this arrived over TCP we notify the
- * health checked connection.
- */
-void DeviceManagerImpl::RLPDataReceived(
-    const ola::acn::TransportHeader &header) {
-  if (header.Transport() != ola::acn::TransportHeader::TCP)
-    return;
-  IPV4Address src_ip = header.Source().Host();
-
-  DeviceState *device_state = STLFindOrNull(m_device_map, src_ip.AsInt());
-  if (!device_state) {
-    OLA_FATAL << "Received data but unable to lookup socket for " <<
-      src_ip;
-    return;
-  }
-
-  // If we're already the designated controller, we just need to notify the
-  // HealthChecker.
-  if (device_state->am_designated_controller) {
-    device_state->health_checked_connection->HeartbeatReceived();
-    return;
-  }
-
-  // This is the first packet received on this connection, which is a sign
-  // we're now the designated controller. Setup the HealthChecker & outgoing
-  // transports.
-  device_state->am_designated_controller = true;
-  OLA_INFO << "Now the designated controller for " << header.Source();
+void DeviceManagerImpl::DeviceAcquired(const IPV4Address &ip_address) {
+  m_managed_devices.insert(ip_address);
   if (m_acquire_device_cb_.get())
-    m_acquire_device_cb_->Run(src_ip);
-
-  device_state->message_queue.reset(
-      new NonBlockingSender(device_state->socket.get(), m_ss,
-                            m_message_builder->pool()));
-
-  E133HealthCheckedConnection *health_checked_connection =
-      new E133HealthCheckedConnection(
-          m_message_builder,
-          device_state->message_queue.get(),
-          NewSingleCallback(this, &DeviceManagerImpl::SocketUnhealthy, src_ip),
-          m_ss);
-
-  if (!health_checked_connection->Setup()) {
-    OLA_WARN << "Failed to setup heartbeat controller for " << src_ip;
-    SocketClosed(src_ip);
-    return;
-  }
-
-  if (device_state->health_checked_connection.get())
-    OLA_WARN << "pre-existing health_checked_connection for " << src_ip;
-  device_state->health_checked_connection.reset(health_checked_connection);
+    m_acquire_device_cb_->Run(ip_address);
 }
 
 
-/**
- * Handle a message on the TCP connection.
- */
-void DeviceManagerImpl::EndpointRequest(
-    const ola::acn::TransportHeader *transport_header,
-    const ola::acn::E133Header *e133_header,
-    const string &raw_request) {
-  if (!m_rdm_callback.get())
-    return;
-
-  if (e133_header->Endpoint()) {
-    OLA_WARN << "TCP message for non-0 endpoint. Endpoint = "
-             << e133_header->Endpoint();
-    return;
-  }
-
-  if (!m_rdm_callback->Run(transport_header->Source().Host(),
-                           e133_header->Endpoint(), raw_request)) {
-    // Don't send an ack
-    return;
-  }
-
-  DeviceState *device_state = STLFindOrNull(
-      m_device_map, transport_header->Source().Host().AsInt());
-  if (!device_state) {
-    OLA_WARN << "Unable to find DeviceState for " << transport_header->Source();
-    return;
-  }
-
-  ola::io::IOStack packet(m_message_builder->pool());
-  m_message_builder->BuildTCPE133StatusPDU(
-      &packet, e133_header->Sequence(), e133_header->Endpoint(),
-      ola::e133::SC_E133_ACK, "OK");
-  device_state->message_queue->SendMessage(&packet);
+void DeviceManagerImpl::DeviceReleased(const IPV4Address &ip_address) {
+  m_managed_devices.erase(ip_address);
+  if (m_release_device_cb_.get())
+    m_release_device_cb_->Run(ip_address);
 }
 }  // namespace e133
 }  // namespace ola
@@ -26,33 +26,22 @@
 #endif  // HAVE_CONFIG_H
 
 #include <ola/Callback.h>
-#include <ola/Clock.h>
-#include <ola/Constants.h>
 #include <ola/e133/MessageBuilder.h>
+#include <ola/io/SelectServer.h>
 #include <ola/io/SelectServerInterface.h>
-#include <ola/network/AdvancedTCPConnector.h>
 #include <ola/network/IPV4Address.h>
-#include <ola/network/Socket.h>
-#include <ola/network/TCPSocketFactory.h>
 
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
-#include HASH_MAP_H
-
-#include "libs/acn/RDMInflator.h"
-#include "libs/acn/E133Inflator.h"
-#include "libs/acn/RootInflator.h"
-#include "libs/acn/TCPTransport.h"
+#include "tools/e133/DeviceConnectionEngine.h"
 
 namespace ola {
 namespace e133 {
 
-using ola::TimeInterval;
-using ola::network::TCPSocket;
 using ola::network::IPV4Address;
-using ola::network::IPV4SocketAddress;
 
 using std::auto_ptr;
 using std::string;
@@ -60,8 +49,12 @@ using std::vector;
 
 /**
  * This class is responsible for maintaining connections to E1.33 devices.
- * TODO(simon): Some of this code can be re-used for the controller side. See
- * if we can factor it out.
+ *
+ * The connections are held by DeviceConnectionEngines. By default there is a
+ * single engine which runs on the caller's SelectServer. Alternatively the
+ * devices can be sharded, by IP address, across a number of I/O threads,
+ * each with its own SelectServer and engine. In that case all callbacks are
+ * still run on the caller's SelectServer.
  */
 class DeviceManagerImpl {
  public:
@@ -79,7 +72,10 @@ class DeviceManagerImpl {
     typedef ola::Callback1<void, const IPV4Address&> ReleaseDeviceCallback;
 
     DeviceManagerImpl(ola::io::SelectServerInterface *ss,
-                  ola::e133::MessageBuilder *message_builder);
+                      ola::e133::MessageBuilder *message_builder);
+    DeviceManagerImpl(ola::io::SelectServer *ss,
+                      ola::e133::MessageBuilder *message_builder,
+                      unsigned int io_threads);
     ~DeviceManagerImpl();
 
     // Ownership of the callbacks is transferred.
@@ -93,49 +89,32 @@ class DeviceManagerImpl {
     void ListManagedDevices(vector<IPV4Address> *devices) const;
 
  private:
-    // hash_map of IPs to DeviceState
-    typedef HASH_NAMESPACE::HASH_MAP_CLASS<uint32_t, class DeviceState*>
-      DeviceMap;
+    class IOThread;
 
-    DeviceMap m_device_map;
     auto_ptr<RDMMesssageCallback> m_rdm_callback;
     auto_ptr<AcquireDeviceCallback> m_acquire_device_cb_;
     auto_ptr<ReleaseDeviceCallback> m_release_device_cb_;
 
     ola::io::SelectServerInterface *m_ss;
-
-    ola::network::TCPSocketFactory m_tcp_socket_factory;
-    ola::network::AdvancedTCPConnector m_connector;
-    ola::LinearBackoffPolicy m_backoff_policy;
-
-    ola::e133::MessageBuilder *m_message_builder;
-
-    // inflators
-    ola::acn::RootInflator m_root_inflator;
-    ola::acn::E133Inflator m_e133_inflator;
-    ola::acn::RDMInflator m_rdm_inflator;
-
-    /*
-     * Avoid passing pointers to the DeviceState objects in callbacks.
-     * When we start removing stale entries this is going to break!
-     * Maybe this won't be a problem since we'll never delete the entry for a
-     * a device we have a connection to. Think about this.
-     */
-    void OnTCPConnect(TCPSocket *socket);
-    void ReceiveTCPData(IPV4Address ip_address,
-                        ola::acn::IncomingTCPTransport *transport);
-    void SocketUnhealthy(IPV4Address address);
-    void SocketClosed(IPV4Address address);
-    void RLPDataReceived(const ola::acn::TransportHeader &header);
-
-    void EndpointRequest(
-        const ola::acn::TransportHeader *transport_header,
-        const ola::acn::E133Header *e133_header,
-        const string &raw_request);
-
-    static const TimeInterval TCP_CONNECT_TIMEOUT;
-    static const TimeInterval INITIAL_TCP_RETRY_DELAY;
-    static const TimeInterval MAX_TCP_RETRY_DELAY;
+    // The devices we're the designated controller for.
+    std::set<IPV4Address> m_managed_devices;
+
+    // Used when we don't have any I/O threads.
+    auto_ptr<DeviceConnectionEngine> m_engine;
+    // The SelectServer that the I/O threads return results to.
+    ola::io::SelectServer *m_executor;
+    vector<IOThread*> m_io_threads;
+
+    void CreateEngine(ola::io::SelectServerInterface *ss,
+                      ola::e133::MessageBuilder *message_builder);
+    IOThread *ThreadForDevice(const IPV4Address &ip_address);
+
+    bool EngineRDMMessage(const IPV4Address &ip_address, uint16_t endpoint,
+                          uint32_t sequence_number, const string &raw_request);
+    bool RunRDMCallback(const IPV4Address &ip_address, uint16_t endpoint,
+                        const string &raw_request);
+    void DeviceAcquired(const IPV4Address &ip_address);
+    void DeviceReleased(const IPV4Address &ip_address);
 };
 }  // namespace e133
 }  // namespace ola
@@ -32,6 +32,8 @@ tools_e133_libolae133common_la_LIBADD = libs/acn/libolae131core.la
 # libolae133controller
 # Controller side.
 tools_e133_libolae133controller_la_SOURCES = \
+    tools/e133/DeviceConnectionEngine.cpp \
+    tools/e133/DeviceConnectionEngine.h \
     tools/e133/DeviceManager.cpp \
     tools/e133/DeviceManagerImpl.cpp \
     tools/e133/DeviceManagerImpl.h
@@ -69,6 +71,7 @@ noinst_PROGRAMS += \
     tools/e133/basic_controller \
     tools/e133/basic_device \
     tools/e133/e133_controller \
+    tools/e133/e133_device_simulator \
     tools/e133/e133_monitor \
     tools/e133/e133_receiver
 
@@ -82,6 +85,12 @@ if USE_SPI
 tools_e133_e133_receiver_LDADD += plugins/spi/libolaspicore.la
 endif
 
+tools_e133_e133_device_simulator_SOURCES = \
+    tools/e133/e133-device-simulator.cpp
+tools_e133_e133_device_simulator_LDADD = common/libolacommon.la \
+                                         libs/acn/libolaacn.la \
+                                         tools/e133/libolae133device.la
+
 tools_e133_e133_monitor_SOURCES = tools/e133/e133-monitor.cpp
 tools_e133_e133_monitor_LDADD = common/libolacommon.la \
                                 libs/acn/libolaacn.la \
@@ -52,8 +52,9 @@ using std::string;
  * Constructor
  */
 SimpleE133Node::SimpleE133Node(const Options &options)
-    : m_stdin_handler(&m_ss, ola::NewCallback(this, &SimpleE133Node::Input)),
-      m_e133_device(&m_ss, options.cid, options.ip_address,
+    : m_owned_ss(options.ss ? NULL : new ola::io::SelectServer()),
+      m_ss(options.ss ? options.ss : m_owned_ss.get()),
+      m_e133_device(m_ss, options.cid, options.ip_address,
                     &m_endpoint_manager),
       m_management_endpoint(NULL, E133Endpoint::EndpointProperties(),
                             options.uid, &m_endpoint_manager,
@@ -61,6 +62,10 @@ SimpleE133Node::SimpleE133Node(const Options &options)
       m_lifetime(options.lifetime),
       m_uid(options.uid),
       m_ip_address(options.ip_address) {
+  if (options.interactive) {
+    m_stdin_handler.reset(new ola::io::StdinHandler(
+        m_ss, ola::NewCallback(this, &SimpleE133Node::Input)));
+  }
 }
 
 
@@ -79,6 +84,9 @@ bool SimpleE133Node::Init() {
   // register the root endpoint
   m_e133_device.SetRootEndpoint(&m_management_endpoint);
 
+  if (!m_stdin_handler.get())
+    return true;
+
   cout << "---------------  Controls  ----------------\n";
   cout << " c - Close the TCP connection\n";
   cout << " q - Quit\n";
@@ -90,7 +98,7 @@ bool SimpleE133Node::Init() {
 
 
 void SimpleE133Node::Run() {
-  m_ss.Run();
+  m_ss->Run();
   OLA_INFO << "Starting shutdown process";
 }
 
@@ -112,7 +120,7 @@ void SimpleE133Node::Input(int c) {
       m_e133_device.CloseTCPConnection();
       break;
     case 'q':
-      m_ss.Terminate();
+      m_ss->Terminate();
       break;
     case 's':
       SendUnsolicited();
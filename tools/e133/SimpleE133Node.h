@@ -55,6 +55,11 @@ class SimpleE133Node {
       IPV4Address ip_address;
       UID uid;
       uint16_t lifetime;
+      // If not NULL, the node uses this SelectServer rather than its own.
+      // This allows many nodes to share a single thread.
+      ola::io::SelectServer *ss;
+      // Read commands from stdin.
+      bool interactive;
 
       Options(const CID &cid,
               const IPV4Address &ip,
@@ -63,26 +68,29 @@ class SimpleE133Node {
         : cid(cid),
           ip_address(ip),
           uid(uid),
-          lifetime(lifetime) {
+          lifetime(lifetime),
+          ss(NULL),
+          interactive(true) {
       }
     };
 
     explicit SimpleE133Node(const Options &options);
     ~SimpleE133Node();
 
-    ola::io::SelectServer *SelectServer() { return &m_ss; }
+    ola::io::SelectServer *SelectServer() { return m_ss; }
 
     bool Init();
     void Run();
-    void Stop() { m_ss.Terminate(); }
+    void Stop() { m_ss->Terminate(); }
 
     // Ownership not passed.
     void AddEndpoint(uint16_t endpoint_id, E133Endpoint *endpoint);
     void RemoveEndpoint(uint16_t endpoint_id);
 
  private:
-    ola::io::SelectServer m_ss;
-    ola::io::StdinHandler m_stdin_handler;
+    auto_ptr<ola::io::SelectServer> m_owned_ss;
+    ola::io::SelectServer *m_ss;
+    auto_ptr<ola::io::StdinHandler> m_stdin_handler;
     EndpointManager m_endpoint_manager;
     E133Device m_e133_device;
     ManagementEndpoint m_management_endpoint;
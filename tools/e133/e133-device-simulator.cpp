@@ -0,0 +1,136 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * e133-device-simulator.cpp
+ * Copyright (C) 2026 Simon Newton
+ *
+ * Runs many simple E1.33 devices in a single process, so a controller can be
+ * tested with large numbers of connections. Each device listens on its own
+ * address, starting from --base-ip. On Linux all of 127.0.0.0/8 is routed to
+ * the loopback interface so no setup is required.
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif  // HAVE_CONFIG_H
+
+#include <errno.h>
+#include <signal.h>
+
+#include <ola/Constants.h>
+#include <ola/Logging.h>
+#include <ola/acn/CID.h>
+#include <ola/base/Flags.h>
+#include <ola/base/Init.h>
+#include <ola/base/SysExits.h>
+#include <ola/io/SelectServer.h>
+#include <ola/network/IPV4Address.h>
+#include <ola/network/NetworkUtils.h>
+#include <ola/rdm/UID.h>
+#include <ola/stl/STLUtils.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tools/e133/SimpleE133Node.h"
+
+using ola::acn::CID;
+using ola::network::HostToNetwork;
+using ola::network::IPV4Address;
+using ola::network::NetworkToHost;
+using ola::rdm::UID;
+using std::auto_ptr;
+using std::string;
+using std::vector;
+
+DEFINE_s_uint16(devices, d, 10, "The number of devices to simulate.");
+DEFINE_string(base_ip, "127.0.1.1",
+              "The IP address of the first device, each device uses the "
+              "next address.");
+DEFINE_string(uid, "7a70:00000001", "The UID of the first device.");
+DEFINE_s_uint16(lifetime, t, 300, "The value to use for the service lifetime");
+
+ola::io::SelectServer *ss = NULL;
+
+/*
+ * Terminate cleanly on interrupt.
+ */
+static void InteruptSignal(OLA_UNUSED int signo) {
+  int old_errno = errno;
+  if (ss) {
+    ss->Terminate();
+  }
+  errno = old_errno;
+}
+
+
+/*
+ * Startup the devices
+ */
+int main(int argc, char *argv[]) {
+  ola::AppInit(&argc, argv, "[options]",
+               "Simulate many E1.33 devices in a single process.");
+
+  IPV4Address base_ip;
+  if (!IPV4Address::FromString(FLAGS_base_ip, &base_ip)) {
+    OLA_WARN << "Invalid IP address: " << FLAGS_base_ip;
+    ola::DisplayUsage();
+    exit(ola::EXIT_USAGE);
+  }
+
+  auto_ptr<UID> base_uid(UID::FromString(FLAGS_uid));
+  if (!base_uid.get()) {
+    OLA_WARN << "Invalid UID: " << FLAGS_uid;
+    ola::DisplayUsage();
+    exit(ola::EXIT_USAGE);
+  }
+
+  ola::io::SelectServer select_server;
+  vector<SimpleE133Node*> nodes;
+
+  const uint32_t first_ip = NetworkToHost(base_ip.AsInt());
+  for (unsigned int i = 0; i < FLAGS_devices; i++) {
+    IPV4Address ip_address(HostToNetwork(first_ip + i));
+    UID uid(base_uid->ManufacturerId(), base_uid->DeviceId() + i);
+
+    SimpleE133Node::Options opts(CID::Generate(), ip_address, uid,
+                                 FLAGS_lifetime);
+    opts.ss = &select_server;
+    opts.interactive = false;
+    SimpleE133Node *node = new SimpleE133Node(opts);
+    if (!node->Init()) {
+      OLA_WARN << "Failed to start device at " << ip_address;
+      delete node;
+      ola::STLDeleteElements(&nodes);
+      exit(ola::EXIT_UNAVAILABLE);
+    }
+    nodes.push_back(node);
+  }
+
+  OLA_INFO << "Started " << nodes.size() << " devices from " << base_ip;
+
+  ss = &select_server;
+  // signal handler
+  if (!ola::InstallSignal(SIGINT, &InteruptSignal)) {
+    ola::STLDeleteElements(&nodes);
+    exit(ola::EXIT_OSERR);
+  }
+
+  select_server.Run();
+  ss = NULL;
+
+  ola::STLDeleteElements(&nodes);
+}
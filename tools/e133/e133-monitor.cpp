@@ -34,6 +34,7 @@
 #include <ola/io/SelectServer.h>
 #include <ola/io/StdinHandler.h>
 #include <ola/network/IPV4Address.h>
+#include <ola/network/NetworkUtils.h>
 #include <ola/rdm/CommandPrinter.h>
 #include <ola/rdm/PidStoreHelper.h>
 #include <ola/rdm/RDMCommand.h>
@@ -46,8 +47,10 @@
 #include <vector>
 
 using ola::NewCallback;
+using ola::network::HostToNetwork;
 using ola::network::IPV4Address;
 using ola::network::IPV4SocketAddress;
+using ola::network::NetworkToHost;
 using ola::rdm::PidStoreHelper;
 using ola::rdm::RDMCommand;
 using ola::rdm::UID;
@@ -61,6 +64,12 @@ DEFINE_s_string(pid_location, p, "",
                 "The directory to read PID definitions from");
 DEFINE_s_string(target_addresses, t, "",
                 "List of IPs to connect to");
+DEFINE_uint16(target_count, 1,
+              "Connect to this many sequential IPs, starting from each "
+              "target address.");
+DEFINE_uint16(io_threads, 0,
+              "The number of threads used to handle the TCP connections, 0 "
+              "handles them on the main thread.");
 
 
 /**
@@ -68,7 +77,7 @@ DEFINE_s_string(target_addresses, t, "",
  */
 class SimpleE133Monitor {
  public:
-    explicit SimpleE133Monitor(PidStoreHelper *pid_helper);
+    SimpleE133Monitor(PidStoreHelper *pid_helper, unsigned int io_threads);
     ~SimpleE133Monitor();
 
     bool Init();
@@ -96,12 +105,13 @@ class SimpleE133Monitor {
 /**
  * Setup a new Monitor
  */
-SimpleE133Monitor::SimpleE133Monitor(PidStoreHelper *pid_helper)
+SimpleE133Monitor::SimpleE133Monitor(PidStoreHelper *pid_helper,
+                                     unsigned int io_threads)
     : m_command_printer(&cout, pid_helper),
       m_stdin_handler(&m_ss,
                       ola::NewCallback(this, &SimpleE133Monitor::Input)),
       m_message_builder(ola::acn::CID::Generate(), "OLA Monitor"),
-      m_device_manager(&m_ss, &m_message_builder) {
+      m_device_manager(&m_ss, &m_message_builder, io_threads) {
   m_device_manager.SetRDMMessageCallback(
       NewCallback(this, &SimpleE133Monitor::EndpointRequest));
 }
@@ -178,7 +188,11 @@ int main(int argc, char *argv[]) {
         OLA_WARN << "Invalid address " << *iter;
         ola::DisplayUsage();
       }
-      targets.push_back(ip_address);
+      // Expand the range, this is used with e133_device_simulator.
+      const uint32_t first_ip = NetworkToHost(ip_address.AsInt());
+      for (unsigned int i = 0; i < FLAGS_target_count; i++) {
+        targets.push_back(IPV4Address(HostToNetwork(first_ip + i)));
+      }
     }
   }
 
@@ -186,7 +200,7 @@ int main(int argc, char *argv[]) {
     exit(ola::EXIT_OSFILE);
   }
 
-  SimpleE133Monitor monitor(&pid_helper);
+  SimpleE133Monitor monitor(&pid_helper, FLAGS_io_threads);
   if (!monitor.Init()) {
     exit(ola::EXIT_UNAVAILABLE);
   }
@@ -511,7 +511,8 @@ int main(int argc, char *argv[]) {
   RDMSniffer sniffer(sniffer_options);
   DispatchingUsbProWidget widget(
       descriptor,
-      ola::NewCallback(&sniffer, &RDMSniffer::HandleMessage));
+      ola::NewCallback(&sniffer, &RDMSniffer::HandleMessage),
+      &ss);
 
   ss.Run();
 
@@ -267,7 +267,7 @@ int main(int argc, char *argv[]) {
 
   descriptor->SetOnClose(ola::NewSingleCallback(&Stop, &ss));
   ss.AddReadDescriptor(descriptor);
-  DispatchingUsbProWidget widget(descriptor, NULL);
+  DispatchingUsbProWidget widget(descriptor, NULL, &ss);
   FirmwareTransferer transferer(&firmware_file, &widget, &ss);
   widget.SetHandler(
       ola::NewCallback(&transferer, &FirmwareTransferer::HandleMessage));